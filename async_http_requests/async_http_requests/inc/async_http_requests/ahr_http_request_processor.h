@@ -56,9 +56,121 @@ typedef enum
     AHR_PROC_OBJECT_BUSY = 1,
     AHR_PROC_UNKNOWN_OBJECT = 2,
     AHR_PROC_NOT_ENOUGH_MEMORY = 3,
-    AHR_PROC_UNKNOWN_ERROR = 4
+    AHR_PROC_UNKNOWN_ERROR = 4,
+    ///
+    /// \brief  The File of AHR_RequestData_t::file_source could not be opened.
+    ///
+    AHR_PROC_IO_ERROR = 5,
+    ///
+    /// \brief  The Base URL can not be parsed, or a Path was given for an Object without Base URL.
+    ///
+    AHR_PROC_INVALID_URL = 6
 } AHR_ProcessorStatus_t;
 
+typedef enum
+{
+    ///
+    /// \brief  Back the Processors Arena with explicit Huge Pages (MAP_HUGETLB), 
+    ///         falls back to regular Pages if none are reserved.
+    ///
+    AHR_PROCESSOR_HUGE_PAGES = 1 << 0,
+    ///
+    /// \brief  Ask for transparent Huge Pages (madvise(MADV_HUGEPAGE)).
+    ///
+    AHR_PROCESSOR_TRANSPARENT_HUGE_PAGES = 1 << 1,
+    ///
+    /// \brief  Fault in the whole Arena at Creation, the RSS does not grow while Requests are made.
+    ///
+    AHR_PROCESSOR_PREFAULT = 1 << 2
+} AHR_ProcessorMemoryFlags_t;
+
+typedef struct
+{
+    size_t max_objects;
+    ///
+    /// \brief  Combination of AHR_ProcessorMemoryFlags_t.
+    ///
+    unsigned int memory_flags;
+    ///
+    /// \brief  Content Encodings (AHR_ContentEncoding_t) offered for all Requests, AHR_ENCODING_DEFAULT
+    ///         and AHR_ENCODING_IDENTITY offer none. A compressed Body is decoded Chunk by Chunk while it arrives.
+    ///
+    unsigned int accept_encodings;
+    ///
+    /// \brief  Abort a Transfer once its decoded Body exceeds this many Bytes, 0 for no Limit.
+    ///         Guards against small compressed Bodies which expand to huge ones.
+    ///
+    size_t max_decoded_bytes;
+    ///
+    /// \brief  Encoding for the Bodies of POST and PUT Requests (AHR_ENCODING_GZIP, _DEFLATE or _ZSTD), 
+    ///         AHR_ENCODING_DEFAULT and AHR_ENCODING_IDENTITY send them as is. 
+    ///         A Body in Memory is compressed at once on the Thread which configures the Request, before it is
+    ///         submitted. A Body from a Provider or File, and a Body in Memory whose compressed Size may exceed
+    ///         the largest pooled Buffer, is compressed Block by Block while it is sent. That happens in curls
+    ///         Read Callback on the Processors Thread and delays its other Transfers for the Time it takes.
+    ///
+    unsigned int content_encoding;
+    ///
+    /// \brief  Compression Level, 0 for the Default of the Encoding.
+    ///
+    int compression_level;
+    ///
+    /// \brief  Bodies in Memory below this Size are sent as is. Bodies which do not get smaller are always sent as is.
+    ///
+    size_t min_compress_bytes;
+    ///
+    /// \brief  Optional zstd Dictionary, f.e. from AHR_TrainZstdDictionary(). It is digested once at Creation 
+    ///         and used for all zstd Bodies. The Receiver needs the same Dictionary. The Bytes are copied.
+    ///
+    const void *zstd_dictionary;
+    size_t zstd_dictionary_bytes;
+    ///
+    /// \brief  AHR_JSON_INDEX_ON validates every buffered Response Body as JSON and builds a structural Index 
+    ///         of it while it arrives, see AHR_ProcessorResponseJson(). AHR_JSON_INDEX_DEFAULT means off.
+    ///
+    unsigned int json_index;
+    ///
+    /// \brief  Events each Thread buffers for AHR_ProcessorDumpTrace(), 0 turns Tracing off.
+    ///         An Event takes 32 Bytes, the Buffer of a Thread is allocated when it records its first Event.
+    ///
+    size_t trace_events;
+    ///
+    /// \brief  Append a Record of every finished Transfer to this File, see ahr_record.h. The File is truncated
+    ///         at Creation and written in Blocks by the Processors Thread, AHR_ProcessorStop() writes the Rest.
+    ///         NULL turns Recording off.
+    ///
+    const char *record_path;
+    ///
+    /// \brief  Abort a buffered Transfer once it took this many Milliseconds, 0 for 
+    ///         AHR_PROCESSOR_DEFAULT_TIMEOUT_MS, AHR_TIMEOUT_NONE for no Limit. See AHR_RequestData_t::timeout_ms.
+    ///
+    size_t timeout_ms;
+    ///
+    /// \brief  Abort a streamed Transfer without its own Timeout once it moved less than 1 Byte per Second
+    ///         for this many Seconds, 0 for AHR_PROCESSOR_DEFAULT_STALL_SECONDS. A paused Transfer never stalls.
+    ///
+    size_t stall_seconds;
+} AHR_ProcessorOptions_t;
+
+typedef struct
+{
+    ///
+    /// \brief  Size of the Arena which holds all fixed size Storage of the Processor.
+    ///
+    size_t arena_bytes;
+    size_t arena_used;
+    ///
+    /// \brief  Heap Bytes held by the Processor outside of the Arena, f.e. growable Header Blocks.
+    ///         Memory allocated by libcurl is not included.
+    ///
+    size_t heap_bytes;
+    ///
+    /// \brief  true if the Arena is backed by explicit / transparent Huge Pages.
+    ///
+    bool huge_pages;
+    bool transparent_huge_pages;
+} AHR_ProcessorFootprint_t;
+
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
@@ -67,6 +179,97 @@ typedef enum
 ///
 AHR_Processor_t AHR_CreateProcessor(size_t max_objects, AHR_Logger_t logger);
 ///
+/// \brief  Create a new AHR_Processor_t Object.
+///         All fixed size Storage of all Objects (Requests, Responses, Url and Body Buffers) is laid out 
+///         in one Arena which is allocated once and released with one Call in AHR_DestroyProcessor().
+///
+AHR_Processor_t AHR_CreateProcessorWithOptions(const AHR_ProcessorOptions_t *options, AHR_Logger_t logger);
+///
+/// \brief  Report the Memory held by the Processor.
+///
+void AHR_ProcessorFootprint(const AHR_Processor_t processor, AHR_ProcessorFootprint_t *footprint);
+///
+/// \brief  Report Hit Rates and High-Water Marks of the Buffer Pool.
+///         Request and Response Bodies are borrowed from a Pool of size-classed Buffers while a Transfer
+///         runs, Response Buffers are presized from the learned Response Size of their Endpoint.
+///
+void AHR_ProcessorBufferPoolStats(const AHR_Processor_t processor, AHR_BufferPoolStats_t *stats);
+///
+/// \brief  Report the Body Bytes received from the Network and after decoding, summed over all finished 
+///         Transfers. Their Ratio is the Bandwidth saved by Content Encoding.
+///
+void AHR_ProcessorDecodingStats(const AHR_Processor_t processor, AHR_DecodingStats_t *stats);
+///
+/// \brief  Copy the Compression Statistics of up to "nstats" Endpoints into "stats".
+///         Endpoints beyond AHR_COMPRESSION_MAX_ENDPOINTS - 1 are summed up under the Endpoint "*".
+/// \returns    Number of Endpoints with compressed Bodies, may be larger than "nstats".
+///
+size_t AHR_ProcessorCompressionStats(const AHR_Processor_t processor, AHR_CompressionStats_t *stats, size_t nstats);
+///
+/// \brief  Copy the Request Counters and the Latency Quantiles per Origin, see AHR_MetricsSnapshot_t.
+///         Never blocks the Processor, may be called from any Thread at any Time.
+///
+void AHR_ProcessorMetricsSnapshot(const AHR_Processor_t processor, AHR_MetricsSnapshot_t *snapshot);
+///
+/// \brief  Write the Metrics in the Prometheus Text Format into "buffer", e.g. to serve them on /metrics.
+///         Never blocks the Processor, may be called from any Thread at any Time.
+/// \returns    Length of the Text without the Terminator, -1 if it does not fit into "nbytes" Bytes.
+///
+int64_t AHR_ProcessorMetricsPrometheus(const AHR_Processor_t processor, char *buffer, size_t nbytes);
+///
+/// \brief  Write the Trace Events recorded since the last Dump to "fd" as Chrome Trace JSON, 
+///         open it in ui.perfetto.dev or chrome://tracing. Needs AHR_ProcessorOptions_t::trace_events.
+///
+///         Each Request is a Track with the Slices "queued", "transfer" (and curls "dns", "connect", "tls", 
+///         "wait", "receive" within it) and "callback". Each Thread is a Track with the Iterations of the 
+///         I/O Loop, AHR_ProcessorMakeRequest() and the User Callbacks.
+///
+/// \example    const int fd = open("ahr.trace.json", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+///             AHR_ProcessorDumpTrace(processor, fd);
+///             close(fd);
+///
+/// \returns    false if Tracing is off or writing failed.
+///
+bool AHR_ProcessorDumpTrace(AHR_Processor_t processor, int fd);
+///
+/// \brief  Train a zstd Dictionary from typical Request Bodies for AHR_ProcessorOptions_t::zstd_dictionary.
+///         A few hundred Samples and a Capacity of about 100 KB are a good Start.
+/// \returns    Size of the Dictionary, 0 if the Samples are not suitable or libahr was built without zstd.
+///
+size_t AHR_TrainZstdDictionary(
+    const char *const *samples,
+    const size_t *sizes,
+    size_t nsamples,
+    void *dictionary,
+    size_t capacity
+);
+///
+/// \brief  Bind all Objects to "base_url". The URL is parsed once, afterwards Requests only pass 
+///         "AHR_RequestData_t::path" and Scheme, Host and Port are not parsed again.
+///         The Path of "base_url" is kept, "path" is appended to it.
+///         NULL unbinds all Objects.
+///
+/// \example    AHR_ProcessorSetBaseUrl(processor, "http://example.com/api");
+///             AHR_RequestData_t data = {.path = "/items?id=1"};
+///             AHR_ProcessorGet(processor, 0, &data, user);  // http://example.com/api/items?id=1
+///
+/// \returns    AHR_PROC_OK on success.
+///             AHR_PROC_OBJECT_BUSY if any Object is in use, no Object was changed then.
+///             AHR_PROC_INVALID_URL if "base_url" can not be parsed.
+///             AHR_PROC_NOT_ENOUGH_MEMORY if an Object could not copy the URL.
+///
+AHR_ProcessorStatus_t AHR_ProcessorSetBaseUrl(AHR_Processor_t processor, const char *base_url);
+///
+/// \brief  Bind one Object to "base_url", e.g. to route Objects to different Origins.
+///         See AHR_ProcessorSetBaseUrl().
+///
+AHR_ProcessorStatus_t AHR_ProcessorSetObjectBaseUrl(AHR_Processor_t processor, size_t object, const char *base_url);
+///
+/// \brief  Pass curls verbose Output (Info Text and Headers) of all following Requests to the Logger
+///         at Info Level. Off by default. May be called from any Thread, Requests in Flight are not affected.
+///
+void AHR_ProcessorSetCurlVerbose(AHR_Processor_t processor, bool verbose);
+///
 /// \brief  Destroy the given Processor-Object.
 ///
 void AHR_DestroyProcessor(AHR_Processor_t *processor);
@@ -106,7 +309,7 @@ size_t AHR_ProcessorNumberOfRequestObjects(const AHR_Processor_t processor);
 ///             AHR_PROC_UNKNOWN_OBJECT if the given "object" is not managed by this instance.
 ///             AHR_PROC_OBJECT_BUSY if the object for which this change is requested is currently in use.
 /// \pre    NULL != request_data
-///         NULL != request_data->url
+///         NULL != request_data->url || NULL != request_data->path
 ///
 /*
 AHR_ProcessorStatus_t AHR_ProcessorPrepareRequest(
@@ -119,10 +322,17 @@ AHR_ProcessorStatus_t AHR_ProcessorPrepareRequest(
 ///
 /// \brief  Set the HTTP Method for the given Object.
 ///         If the Object is currently in use you can not change it.
+///         If "request_data->file_sink" is set, the Response Body is written into its File Descriptor 
+///         while it arrives, on_success then reports an empty Body.
+///         If "request_data->path" is set, the Request goes to the Base URL of the Object.
 ///
 /// \param[in] processor - The managing Instance.
 /// \param[in] object - The Object for which the HTTP Method should be set.
 ///
+/// \returns    AHR_PROC_NOT_ENOUGH_MEMORY if the Request Headers could not be built or exceed AHR_HEADER_NMAX
+///             Entries or AHR_HEADERBLOCK_MAX_BYTES. Configure the Object again before making a Request with it.
+///             This holds for AHR_ProcessorPost/Put/Delete() too.
+///
 AHR_ProcessorStatus_t AHR_ProcessorGet(
     AHR_Processor_t processor, 
     size_t object,
@@ -130,12 +340,25 @@ AHR_ProcessorStatus_t AHR_ProcessorGet(
     AHR_UserData_t data
 );
 
+///
+/// \brief  Configure a POST Request for the given Object.
+///         If "data->borrowed_body" is set, the Body is sent from the Callers Memory without any Copy.
+///         A Body borrowed by a previous Configuration of this Object is released first.
+///         If "data->body_provider" is set, the Body is pulled from the Provider while it is sent, 
+///         with a Content-Length or chunked, so its Size is not limited by any Buffer.
+///         If "data->file_source" is set, the Body is sent from the File without loading it into the Heap.
+///
+/// \returns    AHR_PROC_IO_ERROR if the File of "data->file_source" can not be opened.
+///
 AHR_ProcessorStatus_t AHR_ProcessorPost(
     AHR_Processor_t processor, 
     size_t object,
     const AHR_RequestData_t *data, 
     AHR_UserData_t user_data
 );
+///
+/// \brief  Configure a PUT Request for the given Object, see AHR_ProcessorPost() for the Body Handling.
+///
 AHR_ProcessorStatus_t AHR_ProcessorPut(
     AHR_Processor_t processor, 
     size_t object,
@@ -154,6 +377,9 @@ AHR_ProcessorStatus_t AHR_ProcessorDelete(
 ///         Requestparameter where previously configured for the given Object through
 ///         calls to AHR_ProcessorPrepareRequest() and AHR_ProcessorGet/Post/Put/Delete().
 ///         You can not make a request with an Object which is busy.
+///         The Object is busy from this Call until its Transfer ended, it is no longer busy once its
+///         Callback runs. The Callback may configure the Object and make the next Request with it.
+///         A borrowed Body (AHR_RequestData_t::borrowed_body) is released before the Callback.
 ///
 /// \param[in] processor - The managing Instance.
 /// \param[in] object - The Requestobject.
@@ -164,6 +390,106 @@ AHR_ProcessorStatus_t AHR_ProcessorDelete(
 ///
 ///
 AHR_ProcessorStatus_t AHR_ProcessorMakeRequest(AHR_Processor_t processor, size_t object);
+///
+/// \brief  Continue a streamed Response which was paused by returning AHR_STREAM_PAUSE from on_data.
+///         May be called from any Thread, including from within on_data. The Chunk which 
+///         paused the Transfer is delivered again once the Transfer continues.
+///         A paused Transfer does not stall, but an explicit AHR_RequestData_t::timeout_ms keeps running.
+///
+/// \param[in] processor - The managing Instance.
+/// \param[in] object - The Requestobject.
+///
+/// \returns    AHR_PROC_OK on success.
+///             AHR_PROC_UNKNOWN_OBJECT if the given Object is not known to this Instance. 
+///
+AHR_ProcessorStatus_t AHR_ProcessorResumeResponse(AHR_Processor_t processor, size_t object);
+///
+/// \brief  Get the Number of Response Headers received for the given Object.
+///         Call this from within the Callbacks of the Object or while the Object is not busy. The Headers
+///         of the last Transfer are kept until the I/O Thread starts the next Request of the Object.
+///
+/// \param[in] processor - The managing Instance.
+/// \param[in] object - The Requestobject.
+///
+/// \returns    Number of Headers, 0 if "object" is unknown.
+///
+size_t AHR_ProcessorResponseHeaderCount(AHR_Processor_t processor, size_t object);
+///
+/// \brief  Get a View onto one Response Header of the given Object.
+///         The View points into the Objects Header Block, nothing is copied. It stays valid until
+///         the next Request of this Object is started, which is not before its Callback returned.
+///
+/// \param[in] processor - The managing Instance.
+/// \param[in] object - The Requestobject.
+/// \param[in] index - 0 <= index < AHR_ProcessorResponseHeaderCount().
+/// \param[out] header - The View.
+///
+/// \returns    true on success, false if "object" is unknown or "index" is out of Range.
+///
+bool AHR_ProcessorResponseHeaderAt(
+    AHR_Processor_t processor,
+    size_t object,
+    size_t index,
+    AHR_HeaderView_t *header
+);
+///
+/// \brief  Find a Response Header of the given Object by its Name, ignoring Case.
+///         The Lookup goes through a Hash Index, the Headers are not scanned. If a Name was received more
+///         than once the first Header is returned. The View is valid like one of AHR_ProcessorResponseHeaderAt().
+///
+/// \example    AHR_HeaderView_t etag;
+///             if(AHR_ProcessorResponseHeaderFind(processor, object, "etag", &etag)) { ... }
+///
+/// \returns    true if the Header was received and stored, see AHR_RequestData_t::response_headers.
+///             false if "object" is unknown.
+///
+bool AHR_ProcessorResponseHeaderFind(
+    AHR_Processor_t processor,
+    size_t object,
+    const char *name,
+    AHR_HeaderView_t *header
+);
+
+///
+/// \brief  Get the structural Index of the JSON Response Body of the given Object, see ahr_json.h.
+///         Requires AHR_JSON_INDEX_ON, see AHR_RequestData_t::json_index.
+///         The Index is only valid within on_success of the Object: it and every Value taken from it point
+///         into the Body passed to on_success, which goes back to the Buffer Pool once on_success returned.
+///         Copy what is needed before on_success returns. Do not call this from any other Thread or Callback,
+///         afterwards the Body is gone and false is returned with an empty Index.
+///
+/// \example    static void OnSuccess(void *user, size_t object, size_t status, const char *body, size_t nbytes)
+///             {
+///                 AHR_JsonIndex_t index;
+///                 if(AHR_ProcessorResponseJson(processor, object, &index))
+///                 {
+///                     const size_t id = AHR_JsonObjectFind(&index, 0, "id");
+///                     ...
+///                 }
+///             }
+///
+/// \returns    true if the Body was indexed and is valid JSON. Otherwise "index->error_offset" 
+///             tells where the Body stopped being valid.
+///             false and an empty Index if "object" is unknown.
+///
+bool AHR_ProcessorResponseJson(AHR_Processor_t processor, size_t object, AHR_JsonIndex_t *index);
+///
+/// \brief  Phase Timings of the last Request of "object", see AHR_RequestTimings_t.
+///         Complete from within on_success, on_complete and on_error (up to "callback_ns") and afterwards
+///         until the Object is passed to AHR_ProcessorMakeRequest() again.
+///
+/// \example    static void OnSuccess(void *user, size_t object, size_t status, const char *body, size_t nbytes)
+///             {
+///                 AHR_RequestTimings_t t;
+///                 AHR_ProcessorRequestTimings(processor, object, &t);
+///                 const uint64_t queued_ns = t.multi_add_ns - t.submit_ns;
+///                 const uint64_t server_us = t.first_byte_us - t.pretransfer_us;
+///                 ...
+///             }
+///
+/// \returns    false if "object" is unknown.
+///
+bool AHR_ProcessorRequestTimings(AHR_Processor_t processor, size_t object, AHR_RequestTimings_t *timings);
 
 //
 // --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,85 @@
+///
+/// \brief  Navigate a JSON Body through its structural Index (AHR_JsonIndex_t) without parsing it again.
+///         The Index of a Response is built while the Body arrives, see AHR_ProcessorResponseJson().
+///         Tokens are addressed by their Position on the Tape, Token 0 is the Root Value.
+///         Lookups only compare the Keys of one Object, Values in between are skipped through
+///         AHR_JsonToken_t::next.
+///
+/// \example    AHR_JsonIndex_t index;
+///             if(AHR_ProcessorResponseJson(processor, object, &index))
+///             {
+///                 const size_t items = AHR_JsonObjectFind(&index, 0, "items");
+///                 const size_t first = AHR_JsonArrayAt(&index, items, 0);
+///                 int64_t id;
+///                 if(AHR_JsonInt64(&index, AHR_JsonObjectFind(&index, first, "id"), &id)) { ... }
+///             }
+///
+#ifndef __AHR_JSON_H__
+#define __AHR_JSON_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/ahr_types.h>
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Returned by Lookups which find nothing. Every Function accepts it as Token and fails.
+///
+#define AHR_JSON_NPOS ((size_t)-1)
+
+typedef enum
+{
+    AHR_JSON_INVALID = 0,
+    AHR_JSON_OBJECT = '{',
+    AHR_JSON_ARRAY = '[',
+    AHR_JSON_STRING = '"',
+    AHR_JSON_NUMBER = '0',
+    AHR_JSON_TRUE = 't',
+    AHR_JSON_FALSE = 'f',
+    AHR_JSON_NULL = 'n'
+} AHR_JsonType_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \brief  Type of "token", AHR_JSON_INVALID if it is out of Range.
+///
+AHR_JsonType_t AHR_JsonTokenType(const AHR_JsonIndex_t *index, size_t token);
+///
+/// \brief  Value of the Member "key" of the Object "object".
+///         The Key is compared with the raw Key in the Body, Escapes in it are not resolved.
+/// \returns    The Token of the Value, AHR_JSON_NPOS if "object" is no Object or has no such Member.
+///
+size_t AHR_JsonObjectFind(const AHR_JsonIndex_t *index, size_t object, const char *key);
+///
+/// \brief  Element "position" of the Array "array".
+/// \returns    The Token of the Element, AHR_JSON_NPOS if "array" is no Array or too short.
+///
+size_t AHR_JsonArrayAt(const AHR_JsonIndex_t *index, size_t array, size_t position);
+///
+/// \brief  View onto the Contents of a String without its Quotes. Escapes are not resolved.
+/// \returns    false if "token" is no String.
+///
+bool AHR_JsonString(const AHR_JsonIndex_t *index, size_t token, const char **data, size_t *nbytes);
+///
+/// \brief  Value of an integral Number.
+/// \returns    false if "token" is no Number, has a Fraction or Exponent or does not fit.
+///
+bool AHR_JsonInt64(const AHR_JsonIndex_t *index, size_t token, int64_t *value);
+bool AHR_JsonDouble(const AHR_JsonIndex_t *index, size_t token, double *value);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
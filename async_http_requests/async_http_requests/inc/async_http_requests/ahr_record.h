@@ -0,0 +1,161 @@
+///
+/// \brief  Traffic Records of a Processor, see AHR_ProcessorOptions_t::record_path.
+///         A Record describes the Shape of one finished Transfer, not its Content: when it was made, its Method and
+///         URL Template, the Size of its Request Headers and Body, the Status and the Size of its Response.
+///         Records are written by the Processors Thread in Completion Order and read back with AHR_RecordReaderOpen(),
+///         f.e. to replay captured Traffic against a Stub Server (bench/src/ahr_replay.c).
+///
+///         File Format, all Integers are unsigned LEB128 unless noted:
+///
+///             Header      "AHRR", Version (1 Byte), 3 Bytes 0, Start of the Recording (8 Bytes little Endian,
+///                         CLOCK_REALTIME in Nanoseconds)
+///             Record      Template Reference, 0 defines a new Template, followed by its Length and its Bytes,
+///                             otherwise n refers to the n-th defined Template
+///                         Method (1 Byte, AHR_RecordMethod_t)
+///                         Submit Time, ZigZag encoded Difference to the Submit Time of the previous Record in us
+///                         Latency in us, Server Time in us
+///                         Number of Request Headers, Request Header Bytes, Request Body Bytes
+///                         Status, curl Error, Response Header Bytes, Response Body Bytes, decoded Response Body Bytes
+///
+///         A Record of a typical Request takes 15 to 25 Bytes once its Template is defined.
+///
+/// \example    AHR_RecordReader_t reader = AHR_RecordReaderOpen("ahr.rec");
+///             AHR_Record_t record;
+///             while(reader && AHR_RECORD_OK == AHR_RecordReaderNext(reader, &record))
+///             {
+///                 printf("%s %s %u\n", AHR_RecordMethodName(record.method), record.url_template, record.status);
+///             }
+///             AHR_RecordReaderClose(&reader);
+///
+#ifndef __AHR_RECORD_H__
+#define __AHR_RECORD_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_RECORD_VERSION 1U
+///
+/// \brief  Longest URL Template, longer ones are truncated.
+///
+#define AHR_RECORD_TEMPLATE_LEN 256U
+
+typedef enum
+{
+    AHR_RECORD_GET = 0,
+    AHR_RECORD_POST = 1,
+    AHR_RECORD_PUT = 2,
+    AHR_RECORD_DELETE = 3,
+    AHR_RECORD_OTHER = 4
+} AHR_RecordMethod_t;
+
+typedef enum
+{
+    AHR_RECORD_OK = 0,
+    AHR_RECORD_END = 1,
+    ///
+    /// \brief  The File is not a Recording or ends within a Record.
+    ///
+    AHR_RECORD_CORRUPT = 2
+} AHR_RecordStatus_t;
+
+///
+/// \brief  One finished Transfer.
+///
+typedef struct
+{
+    ///
+    /// \brief  AHR_ProcessorMakeRequest() was called this long after the Recording started.
+    ///
+    uint64_t submit_us;
+    ///
+    /// \brief  From AHR_ProcessorMakeRequest() until the Processors Thread saw the Transfer done.
+    ///
+    uint64_t latency_us;
+    ///
+    /// \brief  From the Request sent until the first Response Byte, 0 if there was no Response.
+    ///
+    uint64_t server_us;
+    AHR_RecordMethod_t method;
+    ///
+    /// \brief  Path and Query of the URL, see AHR_RecordUrlTemplate(). Valid until the Reader is closed.
+    ///
+    const char *url_template;
+    ///
+    /// \brief  Headers set through AHR_RequestData_t::header and their Bytes ("Name: Value\r\n").
+    ///
+    uint32_t nheaders;
+    uint64_t header_bytes;
+    ///
+    /// \brief  Request Body Bytes as sent.
+    ///
+    uint64_t body_bytes;
+    ///
+    /// \brief  HTTP Status, 0 if there was no Response.
+    ///
+    uint32_t status;
+    ///
+    /// \brief  CURLcode of a failed Transfer, 0 otherwise.
+    ///
+    uint32_t error;
+    uint64_t response_header_bytes;
+    ///
+    /// \brief  Response Body Bytes as received / after decoding.
+    ///
+    uint64_t response_bytes;
+    uint64_t decoded_bytes;
+} AHR_Record_t;
+
+struct AHR_RecordReader;
+typedef struct AHR_RecordReader* AHR_RecordReader_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \brief  Reduce "url" to the Template it is recorded with: Scheme, Host and Fragment are dropped,
+///         Path Segments which are Numbers or long Hex Ids (f.e. UUIDs) become "{id}" and only the Names of
+///         Query Parameters are kept.
+///
+/// \example    "https://api.example.com/users/42/orders/9f1c0b7e-55aa-4d1e-9c3b-12f0e1d2c3b4?page=2&sort=asc"
+///             becomes "/users/{id}/orders/{id}?page=&sort="
+///
+/// \returns    Length of the Template, which is truncated to "nbytes" - 1 Bytes and always NULL-terminated.
+///
+size_t AHR_RecordUrlTemplate(const char *url, char *buffer, size_t nbytes);
+///
+/// \brief  "GET", "POST", "PUT", "DELETE" or "OTHER".
+///
+const char* AHR_RecordMethodName(AHR_RecordMethod_t method);
+///
+/// \brief  Open a Recording and check its Header.
+/// \returns    NULL if the File can not be opened or is not a Recording.
+///
+AHR_RecordReader_t AHR_RecordReaderOpen(const char *path);
+///
+/// \brief  Start of the Recording, CLOCK_REALTIME in Nanoseconds.
+///
+uint64_t AHR_RecordReaderStartNs(const AHR_RecordReader_t reader);
+///
+/// \brief  Read the next Record into "record".
+/// \returns    AHR_RECORD_END after the last Record.
+///
+AHR_RecordStatus_t AHR_RecordReaderNext(AHR_RecordReader_t reader, AHR_Record_t *record);
+///
+/// \post   *reader == NULL
+///
+void AHR_RecordReaderClose(AHR_RecordReader_t *reader);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
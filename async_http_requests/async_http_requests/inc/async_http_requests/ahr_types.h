@@ -7,6 +7,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 //
 // --------------------------------------------------------------------------------------------------------------------
@@ -17,8 +18,29 @@
 
 #define AHR_HEADER_NMAX 256
 
+#define AHR_HEADERBLOCK_MAX_BYTES (4096 * 16)
+
 #define AHR_PROCESSOR_MAX_URL_LEN (4096-1)
 #define AHR_PROCESSOR_MAX_BODY_SIZE ((4096 * 16)-1)
+///
+/// \brief  Defaults of AHR_ProcessorOptions_t::timeout_ms and ::stall_seconds.
+///
+#define AHR_PROCESSOR_DEFAULT_TIMEOUT_MS 5000U
+#define AHR_PROCESSOR_DEFAULT_STALL_SECONDS 30U
+///
+/// \brief  No total Timeout, see AHR_RequestData_t::timeout_ms.
+///
+#define AHR_TIMEOUT_NONE ((size_t)-1)
+
+#define AHR_COMPRESSION_MAX_ENDPOINTS 32
+#define AHR_COMPRESSION_ENDPOINT_LEN 128
+
+#define AHR_METRICS_MAX_ORIGINS 16
+#define AHR_METRICS_ORIGIN_LEN 128
+///
+/// \brief  Responses by Status Class, index 1 to 5 for 1xx to 5xx, index 0 for anything else.
+///
+#define AHR_METRICS_STATUS_CLASSES 6
 
 //
 // --------------------------------------------------------------------------------------------------------------------
@@ -36,6 +58,134 @@ typedef struct AHR_HttpResponse* AHR_HttpResponse_t;
 struct AHR_Curl;
 typedef struct AHR_Curl* AHR_Curl_t;
 
+///
+/// \brief  A non owning View onto one HTTP Header.
+///         Name and Value are not NULL-terminated, use the given Lengths.
+///
+typedef struct
+{
+    const char *name;
+    size_t name_len;
+    const char *value;
+    size_t value_len;
+} AHR_HeaderView_t;
+
+///
+/// \brief  One Value of an indexed JSON Body, see AHR_JsonIndex_t.
+///         Its Type follows from its first Byte, see AHR_JsonTokenType().
+///
+typedef struct
+{
+    ///
+    /// \brief  Offset and Length of the Value in the Body. Strings include their Quotes,
+    ///         Objects and Arrays their Brackets.
+    ///
+    uint32_t offset;
+    uint32_t length;
+    ///
+    /// \brief  Index of the Token behind this Value and all of its Children.
+    ///
+    uint32_t next;
+    ///
+    /// \brief  Number of Members of an Object / Elements of an Array, 0 for all other Values.
+    ///
+    uint32_t count;
+} AHR_JsonToken_t;
+
+///
+/// \brief  Structural Index (Tape) of a validated JSON Body, see ahr_json.h.
+///         The Tokens are in Document Order, Token 0 is the Root Value. The Children of an Object or Array
+///         follow it directly, the Children of an Object alternate between Key and Value.
+///
+typedef struct
+{
+    const char *body;
+    size_t nbytes;
+    const AHR_JsonToken_t *tokens;
+    size_t ntokens;
+    ///
+    /// \brief  Offset of the first offending Byte if the Body is not valid JSON.
+    ///
+    size_t error_offset;
+} AHR_JsonIndex_t;
+
+typedef enum
+{
+    ///
+    /// \brief  Use the Setting of the Processor.
+    ///
+    AHR_JSON_INDEX_DEFAULT = 0,
+    ///
+    /// \brief  Validate and index the buffered Response Body while it arrives.
+    ///
+    AHR_JSON_INDEX_ON = 1,
+    AHR_JSON_INDEX_OFF = 2
+} AHR_JsonIndexMode_t;
+
+///
+/// \brief  Content Encodings a Response may be sent with, combine them with "|".
+///         A compressed Body is decoded while it arrives, Callbacks, Sinks and Files see the decoded Body.
+///
+typedef enum
+{
+    ///
+    /// \brief  Use the Setting of the Processor.
+    ///
+    AHR_ENCODING_DEFAULT = 0,
+    ///
+    /// \brief  Do not negotiate, the Body is sent as is.
+    ///
+    AHR_ENCODING_IDENTITY = 1 << 0,
+    AHR_ENCODING_GZIP = 1 << 1,
+    AHR_ENCODING_DEFLATE = 1 << 2,
+    AHR_ENCODING_BROTLI = 1 << 3,
+    AHR_ENCODING_ZSTD = 1 << 4,
+    AHR_ENCODING_ALL = AHR_ENCODING_GZIP | AHR_ENCODING_DEFLATE | AHR_ENCODING_BROTLI | AHR_ENCODING_ZSTD
+} AHR_ContentEncoding_t;
+
+///
+/// \brief  Bytes received by all finished Transfers of a Processor.
+///
+typedef struct
+{
+    uint64_t responses;
+    ///
+    /// \brief  Responses which carried a Content-Encoding.
+    ///
+    uint64_t encoded_responses;
+    ///
+    /// \brief  Body Bytes as received from the Network / after decoding.
+    ///
+    uint64_t wire_bytes;
+    uint64_t decoded_bytes;
+    ///
+    /// \brief  Transfers aborted because the decoded Body exceeded its Limit.
+    ///
+    uint64_t limit_exceeded;
+} AHR_DecodingStats_t;
+
+///
+/// \brief  Request Bodies compressed for one Endpoint.
+///
+typedef struct
+{
+    ///
+    /// \brief  Scheme, Host and Path of the Endpoint, truncated to fit.
+    ///
+    char endpoint[AHR_COMPRESSION_ENDPOINT_LEN]; // flawfinder: ignore
+    uint64_t requests;
+    ///
+    /// \brief  Body Bytes before / after Compression, their Ratio is the Compression Ratio of the Endpoint.
+    ///
+    uint64_t uncompressed_bytes;
+    uint64_t compressed_bytes;
+} AHR_CompressionStats_t;
+
+///
+/// \brief  Fixed size Header Representation.
+///         Only used to copy out Response Headers through AHR_ResponseHeader(), 
+///         prefer AHR_HeaderView_t.
+///
 typedef struct
 {
     char name[AHR_HEADERENTRY_NAME_LEN]; // flawfinder: ignore
@@ -50,29 +200,394 @@ typedef struct
 
 typedef struct
 {
-    char *data;
-    int32_t current_pos;
-    int32_t size;    
+    const char *data;
+    size_t current_pos;
+    size_t size;    
 } AHR_FileTransfer_t;
 
+///
+/// \brief  Called once libahr no longer needs a borrowed Body.
+///
+typedef void (*AHR_BodyRelease_t)(void *user, const char *data, size_t nbytes);
+///
+/// \brief  Describes a Request Body which stays owned by the Caller.
+///         libahr borrows "data" until the Transfer ended and calls "release", if set, afterwards,
+///         before the Callback of the Request runs.
+///         The Memory must not change while it is borrowed.
+///
+typedef struct
+{
+    const char *data;
+    size_t nbytes;
+    AHR_BodyRelease_t release;
+    void *user;
+} AHR_BodyDescriptor_t;
+
+///
+/// \brief  Return Value of AHR_BodyProviderRead_t which aborts the Transfer.
+///
+#define AHR_BODY_PROVIDER_ABORT ((size_t)-1)
+///
+/// \brief  Unknown Content-Length, the Body is sent with chunked Transfer-Encoding.
+///
+#define AHR_BODY_PROVIDER_CHUNKED ((int64_t)-1)
+
+///
+/// \brief  Fill "buffer" with up to "nbytes" Bytes of the Request Body.
+/// \returns    Number of Bytes written, 0 at the End of the Body or AHR_BODY_PROVIDER_ABORT.
+///
+typedef size_t (*AHR_BodyProviderRead_t)(void *user, char *buffer, size_t nbytes);
+///
+/// \brief  Start the Body from the Beginning again, f.e. if curl has to resend it after a Redirect.
+/// \returns    false if the Body can not be produced again.
+///
+typedef bool (*AHR_BodyProviderRewind_t)(void *user);
+///
+/// \brief  Pull-style Request Body. curl asks for the next Bytes whenever its Upload Buffer has Space,
+///         so the Body never has to be held in Memory at once.
+///         "user" must stay valid until the Callback of the Request was called.
+///
+typedef struct
+{
+    AHR_BodyProviderRead_t read;
+    ///
+    /// \brief  Optional, NULL if the Body can not be rewound.
+    ///
+    AHR_BodyProviderRewind_t rewind;
+    void *user;
+    ///
+    /// \brief  Exact Length of the Body in Bytes or AHR_BODY_PROVIDER_CHUNKED.
+    ///
+    int64_t content_length;
+} AHR_BodyProvider_t;
+
+///
+/// \brief  Hints for a Download into a File, see AHR_FileSink_t. All Hints are best effort.
+///
+typedef enum
+{
+    ///
+    /// \brief  Reserve the Content-Length with fallocate() before the first Chunk is written.
+    ///
+    AHR_FILE_SINK_PREALLOCATE = 1 << 0,
+    ///
+    /// \brief  posix_fadvise(POSIX_FADV_SEQUENTIAL) for the written Range.
+    ///
+    AHR_FILE_SINK_SEQUENTIAL = 1 << 1,
+    ///
+    /// \brief  Write back and drop the written Pages from the Page Cache while the Download proceeds.
+    ///
+    AHR_FILE_SINK_DONTNEED = 1 << 2
+} AHR_FileSinkFlags_t;
+
+///
+/// \brief  Download the Response Body into a File Descriptor owned by the Caller.
+///         The Body is written with pwrite() starting at "offset", the File Position of "fd" is not used.
+///
+typedef struct
+{
+    int fd;
+    int64_t offset;
+    ///
+    /// \brief  Combination of AHR_FileSinkFlags_t.
+    ///
+    unsigned int flags;
+} AHR_FileSink_t;
+
+typedef enum
+{
+    ///
+    /// \brief  Memory map the Range instead of reading it piecewise. The Pages are read by the Kernel
+    ///         on Demand and can be dropped again at any Time, they do not count as Heap Memory.
+    ///
+    AHR_FILE_SOURCE_MMAP = 1 << 0
+} AHR_FileSourceFlags_t;
+
+///
+/// \brief  Request Body read from a File. Either "path" or "fd" identifies the File.
+///         By Default the Range is read with pread() straight into curls Upload Buffer.
+///
+typedef struct
+{
+    ///
+    /// \brief  If set, the File is opened by the Processor and closed once the Transfer ended. "fd" is ignored.
+    ///
+    const char *path;
+    ///
+    /// \brief  Used if "path" is NULL. The Descriptor stays owned by the Caller and must stay open
+    ///         until the Callback of the Request was called.
+    ///
+    int fd;
+    int64_t offset;
+    ///
+    /// \brief  Number of Bytes to send, negative to send everything from "offset" to the End of the File.
+    ///
+    int64_t length;
+    ///
+    /// \brief  Combination of AHR_FileSourceFlags_t.
+    ///
+    unsigned int flags;
+} AHR_FileSource_t;
+
 typedef struct
 { 
-    AHR_Header_t header;
+    ///
+    /// \brief  Array of "nheaders" Header Views. The Views are copied by the Processor.
+    ///
+    const AHR_HeaderView_t *header;
+    size_t nheaders;
     char *url;
+    ///
+    /// \brief  NULL-terminated Body, copied by the Processor. Ignored if "borrowed_body" is set.
+    ///
     char *body;
     size_t loglevel;
+    ///
+    /// \brief  Optional Body which is used without copying it, see AHR_BodyDescriptor_t.
+    ///
+    const AHR_BodyDescriptor_t *borrowed_body;
+    ///
+    /// \brief  Optional Body which is pulled piecewise while it is sent, see AHR_BodyProvider_t.
+    ///         Takes Precedence over "borrowed_body" and "body". Only used for POST and PUT.
+    ///
+    const AHR_BodyProvider_t *body_provider;
+    ///
+    /// \brief  Optional, write the Response Body into a File instead of buffering it.
+    ///         Ignored if the Response is streamed through AHR_UserData_t::on_data.
+    ///
+    const AHR_FileSink_t *file_sink;
+    ///
+    /// \brief  Optional Request Body read from a File, see AHR_FileSource_t. Only used for POST and PUT.
+    ///         Takes Precedence over "borrowed_body" and "body", "body_provider" takes Precedence over it.
+    ///
+    const AHR_FileSource_t *file_source;
+    ///
+    /// \brief  Optional Path and Query relative to the Base URL of the Object ("/items?id=1"), 
+    ///         see AHR_ProcessorSetBaseUrl(). If set, "url" is ignored.
+    ///
+    const char *path;
+    ///
+    /// \brief  Optional Whitelist of "nresponse_headers" Response Header Names (NULL-terminated, 
+    ///         case-insensitive). Only these Headers are stored, all others are dropped while they arrive.
+    ///         NULL stores all Headers. The Names are copied.
+    ///
+    const char *const *response_headers;
+    size_t nresponse_headers;
+    ///
+    /// \brief  Content Encodings to offer (AHR_ContentEncoding_t), AHR_ENCODING_DEFAULT for the 
+    ///         Processors Setting.
+    ///
+    unsigned int accept_encodings;
+    ///
+    /// \brief  Abort the Transfer once the decoded Body exceeds this many Bytes, 0 for the Processors Limit.
+    ///
+    size_t max_decoded_bytes;
+    ///
+    /// \brief  Compress the Body of a POST / PUT with this Encoding (AHR_ENCODING_GZIP, _DEFLATE or _ZSTD),
+    ///         AHR_ENCODING_DEFAULT for the Processors Setting, AHR_ENCODING_IDENTITY to send it as is.
+    ///
+    unsigned int content_encoding;
+    ///
+    /// \brief  Index the JSON Response Body (AHR_JsonIndexMode_t), AHR_JSON_INDEX_DEFAULT for the Processors
+    ///         Setting. Streamed Responses and Downloads into a File are never indexed.
+    ///
+    unsigned int json_index;
+    ///
+    /// \brief  Abort the Transfer once it took this many Milliseconds, AHR_TIMEOUT_NONE for no Limit.
+    ///         0 for the Processors Setting: buffered Transfers get AHR_ProcessorOptions_t::timeout_ms, streamed 
+    ///         Transfers (on_data, Body Provider, File Sink or File Source) get no total Timeout and are aborted 
+    ///         once they stall, see AHR_ProcessorOptions_t::stall_seconds.
+    ///         The Time a Transfer is paused through AHR_STREAM_PAUSE counts against an explicit Timeout.
+    ///
+    size_t timeout_ms;
 } AHR_RequestData_t;
 
+///
+/// \brief  Tells the Processor how to go on after a Chunk of a streamed Response was delivered.
+///
+typedef enum
+{
+    AHR_STREAM_CONTINUE = 0,
+    ///
+    /// \brief  Pause the Transfer. The same Chunk is delivered again after AHR_ProcessorResumeResponse().
+    ///
+    AHR_STREAM_PAUSE = 1,
+    ///
+    /// \brief  Abort the Transfer, on_error is called afterwards.
+    ///
+    AHR_STREAM_ABORT = 2
+} AHR_StreamAction_t;
+
 typedef void* AHR_Id_t;
 typedef void (*AHR_ResponseSuccessCallback)(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes);
+///
+/// \brief  "error_code" is the CURLcode the Transfer failed with, 0 if it could not be started.
+///
 typedef void (*AHR_ResponseErrorCallback)(void *user_data, size_t object, size_t error_code);
+typedef AHR_StreamAction_t (*AHR_ResponseDataCallback)(void *user_data, size_t object, const char *data, size_t nbytes);
+typedef void (*AHR_ResponseCompleteCallback)(void *user_data, size_t object, size_t status_code);
 typedef struct
 {
     void *data;
     AHR_ResponseSuccessCallback on_success;
     AHR_ResponseErrorCallback on_error;
+    ///
+    /// \brief  Optional. If set, the Response is streamed: each received Chunk is passed to on_data 
+    ///         as soon as it arrives and nothing is buffered. on_complete is called instead of on_success
+    ///         once the Transfer ended. Both run on the Processors Thread.
+    ///
+    AHR_ResponseDataCallback on_data;
+    AHR_ResponseCompleteCallback on_complete;
 } AHR_UserData_t;
 
+///
+/// \brief  Number of Size Classes of the Buffer Pool, 4 KB, 16 KB, 64 KB and 256 KB.
+///
+#define AHR_BUFFER_POOL_CLASSES 4
+
+typedef struct
+{
+    size_t buffer_size;
+    ///
+    /// \brief  Number of Buffers borrowed from this Class.
+    ///
+    uint64_t acquired;
+    ///
+    /// \brief  Borrowed Buffers which came from a per-Thread Cache / from the shared Depot.
+    ///         Everything else was allocated, the Hit Rate is (cache_hits + depot_hits) / acquired.
+    ///
+    uint64_t cache_hits;
+    uint64_t depot_hits;
+    uint64_t allocated;
+    size_t in_use;
+    ///
+    /// \brief  Highest Number of Buffers borrowed at the same Time.
+    ///
+    size_t high_water;
+    ///
+    /// \brief  Idle Buffers kept for Reuse.
+    ///
+    size_t idle;
+} AHR_BufferClassStats_t;
+
+typedef struct
+{
+    AHR_BufferClassStats_t classes[AHR_BUFFER_POOL_CLASSES];
+    size_t bytes_in_use;
+    size_t bytes_high_water;
+    ///
+    /// \brief  Response Buffers which held the whole Body from the Start / which had to be grown /
+    ///         which were too small even in the largest Class.
+    ///
+    uint64_t presized;
+    uint64_t regrown;
+    uint64_t oversized;
+} AHR_BufferPoolStats_t;
+
+///
+/// \brief  Where the Time of one Request went, see AHR_ProcessorRequestTimings().
+///
+///         The "*_ns" Fields are CLOCK_MONOTONIC Timestamps in Nanoseconds taken by libahr, 0 if the Request did 
+///         not get there. The "*_us" Fields are curls Phase Times (CURLINFO_*_TIME_T) in Microseconds, each 
+///         counted from the Start of the Transfer up to the End of the Phase, 0 for Phases a reused Connection skips.
+///
+typedef struct
+{
+    ///
+    /// \brief  AHR_ProcessorMakeRequest() queued the Request.
+    ///
+    uint64_t submit_ns;
+    ///
+    /// \brief  The Processors Thread took it from the Queue / added it to the curl multi Handle.
+    ///
+    uint64_t dequeue_ns;
+    uint64_t multi_add_ns;
+    ///
+    /// \brief  DNS, TCP Connect, TLS Handshake, Request sent, first Response Byte, Transfer done.
+    ///
+    uint64_t name_lookup_us;
+    uint64_t connect_us;
+    uint64_t app_connect_us;
+    uint64_t pretransfer_us;
+    uint64_t first_byte_us;
+    uint64_t total_us;
+    ///
+    /// \brief  The Processors Thread saw the Transfer done / called on_success, on_complete or on_error.
+    ///
+    uint64_t complete_ns;
+    uint64_t callback_ns;
+} AHR_RequestTimings_t;
+
+///
+/// \brief  Why a Transfer failed without a Response.
+///
+typedef enum
+{
+    AHR_FAILURE_TIMEOUT = 0,
+    ///
+    /// \brief  Name Resolution or Connect failed.
+    ///
+    AHR_FAILURE_CONNECT = 1,
+    ///
+    /// \brief  Aborted by libahr or the User, f.e. a Body Limit or on_data.
+    ///
+    AHR_FAILURE_ABORTED = 2,
+    AHR_FAILURE_OTHER = 3,
+    AHR_FAILURE_CLASSES = 4
+} AHR_FailureClass_t;
+
+///
+/// \brief  Latency from AHR_ProcessorMakeRequest() until the Transfer completed, for Responses of one Origin.
+///         Quantiles are read from an HDR Histogram and are accurate to about 3%.
+///
+typedef struct
+{
+    ///
+    /// \brief  "scheme://host:port", "*" for all Origins beyond AHR_METRICS_MAX_ORIGINS - 1.
+    ///
+    char origin[AHR_METRICS_ORIGIN_LEN]; // flawfinder: ignore
+    uint64_t count;
+    uint64_t sum_us;
+    uint64_t max_us;
+    uint64_t p50_us;
+    uint64_t p90_us;
+    uint64_t p99_us;
+    uint64_t p999_us;
+} AHR_OriginLatency_t;
+
+///
+/// \brief  Counters of a Processor, see AHR_ProcessorMetricsSnapshot().
+///
+typedef struct
+{
+    uint64_t submitted;
+    ///
+    /// \brief  Transfers which ended with a Response, by Status Class.
+    ///
+    uint64_t completed[AHR_METRICS_STATUS_CLASSES];
+    ///
+    /// \brief  Transfers which ended without a Response, by AHR_FailureClass_t.
+    ///
+    uint64_t failed[AHR_FAILURE_CLASSES];
+    ///
+    /// \brief  Header and Body Bytes received / sent, as counted by curl.
+    ///
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+    ///
+    /// \brief  Connections opened / Transfers with a Response which reused a Connection.
+    ///
+    uint64_t connections_opened;
+    uint64_t connections_reused;
+    ///
+    /// \brief  Requests waiting for the Processors Thread / handed to curl and not finished yet.
+    ///
+    uint64_t queue_depth;
+    uint64_t in_flight;
+    size_t norigins;
+    AHR_OriginLatency_t origins[AHR_METRICS_MAX_ORIGINS];
+} AHR_MetricsSnapshot_t;
+
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
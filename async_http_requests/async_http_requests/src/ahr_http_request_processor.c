@@ -2,7 +2,14 @@
 /// \brief  Http Processor.
 /// \architectural decisions    Here are some Decisions listed.
 ///     1. No public Access to internal Structures.
-///     2. The Http Processor does not use dynamic Memory Allocation after Initialization. 
+///     2. Memory follows the Bytes in Flight, not the Number of Objects:
+///         - Fixed Storage of all Objects (Results, Requests, Responses, curl Handles) is carved out of one
+///           Arena at Initialization and released at once, see ahr_arena.h.
+///         - Request and Response Bodies are borrowed from a size-classed Buffer Pool shared by all Objects
+///           and given back when the Transfer ended, see ahr_buffer_pool.h.
+///         - Header Blocks, interned curl Header Lists and JSON Indexes grow on the Heap to the largest Set
+///           they have seen and keep their Capacity, a warmed up Processor rarely allocates.
+///         - Log Rings and Trace Buffers are allocated per Thread on first Use.
 ///     3. No Infologs for Debugging, Log all Errors
 ///         
 
@@ -16,7 +23,14 @@
 #include <async_http_requests/private/ahr_result.h>
 #include <external/async_http_requests/ahr_mutex.h>
 #include <external/async_http_requests/ahr_thread.h>
+#include <external/async_http_requests/ahr_arena.h>
+#include <async_http_requests/private/ahr_buffer_pool.h>
+#include <external/async_http_requests/ahr_compression.h>
 #include <async_http_requests/private/ahr_logging.h>
+#include <async_http_requests/private/ahr_metrics.h>
+#include <async_http_requests/private/ahr_trace.h>
+#include <async_http_requests/private/ahr_recorder.h>
+#include <async_http_requests/private/ahr_probes.h>
 
 #include <assert.h>
 #include <unistd.h>
@@ -24,12 +38,18 @@
 #include <stdatomic.h>
 #include <errno.h>
 #include <string.h>
+#include <time.h>
 
 #include <curl/curl.h>
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
 
+///
+/// \brief  Most Requestobjects one Processor manages.
+///
+#define AHR_PROCESSOR_MAX_OBJECTS 25U
+
 ///
 /// \brief  This Structure holds the state of a Transaktion with the Server.
 ///
@@ -49,6 +69,29 @@ typedef struct
 {
     struct AHR_RequestListNode *head;
 } AHR_RequestList;
+///
+/// \brief  Counters behind AHR_DecodingStats_t. Only the Processors Thread writes them.
+///
+typedef struct
+{
+    atomic_ullong responses;
+    atomic_ullong encoded_responses;
+    atomic_ullong wire_bytes;
+    atomic_ullong decoded_bytes;
+    atomic_ullong limit_exceeded;
+} AHR_DecodingCounters_t;
+///
+/// \brief  Counters behind AHR_CompressionStats_t for one Endpoint. Only the Processors Thread writes them,
+///         "key" is published last, once "endpoint" is complete.
+///
+typedef struct
+{
+    atomic_ullong key;
+    char endpoint[AHR_COMPRESSION_ENDPOINT_LEN]; // flawfinder: ignore
+    atomic_ullong requests;
+    atomic_ullong uncompressed_bytes;
+    atomic_ullong compressed_bytes;
+} AHR_CompressionCounters_t;
 
 ///
 /// \brief  Key Structure. This holds the state of the modules.
@@ -84,6 +127,64 @@ struct AHR_Processor
     AHR_RequestList result_list;
     
     AHR_ResultStore_t result_store;
+    ///
+    /// \brief  Holds the Result Store and the fixed size Storage of all Objects.
+    ///
+    AHR_Arena_t arena;
+    ///
+    /// \brief  Body Buffers, borrowed for the Duration of a Transfer.
+    ///
+    AHR_BufferPool_t pool;
+    ///
+    /// \brief  Buffer Cache of the Processors Thread, which borrows all Response Buffers.
+    ///
+    AHR_BufferCache_t io_cache;
+    ///
+    /// \brief  curl Header Lists shared by all Objects.
+    ///
+    AHR_HeaderListCache_t header_cache;
+    ///
+    /// \brief  Content Encodings offered and Limit of the decoded Body, unless a Request overrides them.
+    ///
+    unsigned int accept_encodings;
+    size_t max_decoded_bytes;
+    AHR_DecodingCounters_t decoding;
+    ///
+    /// \brief  Total Timeout of buffered Transfers and Stall Limit of streamed ones, unless a Request sets its own.
+    ///
+    size_t timeout_ms;
+    size_t stall_seconds;
+    ///
+    /// \brief  Request Body Compression, unless a Request overrides the Encoding.
+    ///
+    unsigned int content_encoding;
+    int compression_level;
+    size_t min_compress_bytes;
+    AHR_CompressionDictionary_t dictionary;
+    ///
+    /// \brief  Open addressed by Endpoint Key, the last Slot collects all Endpoints which do not fit.
+    ///
+    AHR_CompressionCounters_t compression[AHR_COMPRESSION_MAX_ENDPOINTS];
+    ///
+    /// \brief  Index buffered JSON Responses, unless a Request overrides it.
+    ///
+    unsigned int json_index;
+    ///
+    /// \brief  Pass curls verbose Output to the Logger, applied when a Request is prepared.
+    ///
+    atomic_bool curl_verbose;
+    ///
+    /// \brief  Counters and Latency Histograms, see ahr_metrics.h.
+    ///
+    AHR_Metrics_t *metrics;
+    ///
+    /// \brief  Records Trace Events, NULL while Tracing is off.
+    ///
+    AHR_Tracer_t *tracer;
+    ///
+    /// \brief  Writes a Record of every finished Transfer, NULL while Recording is off.
+    ///
+    AHR_Recorder_t *recorder;
 };
 
 //
@@ -111,6 +212,14 @@ static AHR_Result_t* AHR_RequestListFind(AHR_RequestList *list, void *handle); /
 ///
 static void AHR_HandleNewRequests(AHR_Processor_t processor);
 ///
+/// \brief  Continue all paused Transfers for which AHR_ProcessorResumeResponse() was called.
+///
+static void AHR_HandleResumedResponses(AHR_Processor_t processor);
+///
+/// \brief  Response Data Sink which forwards each Chunk to the Users on_data Callback.
+///
+static AHR_StreamAction_t AHR_ProcessorStreamData(void *user, const char *data, size_t nbytes);
+///
 /// \brief  Process the Eventloop and wait for other incoming events.
 ///
 static void AHR_ExecuteAndPoll(AHR_Processor_t processor);
@@ -119,22 +228,132 @@ static void AHR_ExecuteAndPoll(AHR_Processor_t processor);
 ///
 static void* AHR_ProcessorThreadFunc(void *arg);
 
+///
+/// \brief  Arena Bytes needed for "max_objects" Objects.
+///
+static size_t AHR_ProcessorArenaBytes(size_t max_objects);
+///
+/// \brief  AHR_BodyRelease_t which gives a copied Request Body back to the Pool.
+///
+static void AHR_ProcessorReleasePooledBody(void *user, const char *data, size_t nbytes);
+///
+/// \brief  Target passed to AHR_Get() and the others, NULL if the Object was addressed by a Path.
+///
+static const char* AHR_ProcessorRequestUrl(const AHR_Result_t *result);
+///
+/// \brief  Bind the Objects [first, last) to "base_url", the Caller holds the Mutex.
+///
+static AHR_ProcessorStatus_t AHR_ProcessorBindBaseUrl(
+    AHR_Processor_t processor, 
+    size_t first, 
+    size_t last, 
+    const char *base_url
+);
 static AHR_ProcessorStatus_t AHR_ProcessorPrepareRequest(
     AHR_Processor_t processor,
     size_t object, 
     const AHR_RequestData_t *request_data,
     AHR_UserData_t data
 );
+///
+/// \brief  Add the Body Bytes of a finished Transfer to the Decoding Counters.
+///
+static void AHR_ProcessorCountTransfer(AHR_Processor_t processor, const AHR_Result_t *result);
+///
+/// \brief  Add the compressed Body of a finished Transfer to the Statistics of its Endpoint.
+///
+static void AHR_ProcessorCountCompression(AHR_Processor_t processor, const AHR_Result_t *result);
+///
+/// \brief  CLOCK_MONOTONIC in Nanoseconds, the Clock of AHR_RequestTimings_t.
+///
+static uint64_t AHR_ProcessorNowNs(void);
+///
+/// \brief  Stamp the End of the Transfer of "result" and take curls Phase Times from "handle".
+///
+static void AHR_ProcessorFinishTimings(AHR_Result_t *result, AHR_Curl_t handle);
+///
+/// \brief  Collect what the Metrics need about the finished Transfer of "result".
+///
+static void AHR_ProcessorMetricsTransfer(const AHR_Result_t *result, AHR_Curl_t handle, AHR_MetricsTransfer_t *transfer);
+///
+/// \brief  Trace the Request Slices of "result". "transfer" ends at "ticks" and holds curls Phases, 
+///         which are placed from AHR_RequestTimings_t.
+///
+static void AHR_ProcessorTraceTransfer(const AHR_Result_t *result, uint64_t ticks);
+///
+/// \brief  Append a Record of the finished Transfer of "result", see ahr_record.h.
+///         "error_code" is the CURLcode of a failed Transfer, 0 otherwise.
+///
+static void AHR_ProcessorRecordTransfer(AHR_Processor_t processor, const AHR_Result_t *result, AHR_Curl_t handle, size_t error_code);
+///
+/// \brief  The one Encoding Bodies of "request_data" are compressed with, 0 for none.
+///
+static unsigned int AHR_ProcessorBodyEncoding(const AHR_Processor_t processor, const AHR_RequestData_t *request_data);
+///
+/// \brief  Replace "body" by its compressed Copy in a Buffer of the Pool. The original Body is released
+///         right away. A Body which does not get smaller is kept. If no Buffer of the Pool can hold the
+///         compressed Body, it is compressed as a Stream while curl pulls it, see AHR_ProcessorStreamBody().
+///
+static void AHR_ProcessorCompressBody(
+    AHR_Processor_t processor, 
+    AHR_Result_t *result, 
+    unsigned int encoding, 
+    AHR_BodyDescriptor_t *body
+);
+///
+/// \brief  Compress the Body of "result" while curl pulls it, the Body has to be set before the Transfer.
+///         It is sent as is if no Stream can be begun.
+///
+static void AHR_ProcessorStreamBody(AHR_Processor_t processor, AHR_Result_t *result, unsigned int encoding, size_t nbytes);
+///
+/// \brief  AHR_BodyProviderRead_t / AHR_BodyProviderRewind_t over the Body of the Result "user".
+///
+static size_t AHR_ProcessorBodyRead(void *user, char *buffer, size_t nbytes);
+static bool AHR_ProcessorBodyRewind(void *user);
+///
+/// \brief  Map the Outcome of AHR_Get() and the others to a Status. If the Request Headers could not be
+///         built, the Body of "result" is released and AHR_PROC_NOT_ENOUGH_MEMORY is returned.
+///
+static AHR_ProcessorStatus_t AHR_ProcessorConfigured(AHR_Processor_t processor, AHR_Result_t *result, bool configured);
+///
+/// \brief  Take the finished Transfer of "result" off the Multi Handle, release its Request Body and unlock the Object.
+///         Called before the Callback, so the Callback may configure and submit the Object again.
+///         The Response stays untouched until the next Transfer of the Object is dequeued.
+///
+static void AHR_ProcessorEndTransfer(AHR_Processor_t processor, AHR_Result_t *result, AHR_Curl_t handle);
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
 
 AHR_Processor_t AHR_CreateProcessor(size_t max_objects, AHR_Logger_t logger)
 {
+    const AHR_ProcessorOptions_t options = {
+        .max_objects = max_objects,
+        .memory_flags = 0,
+        .accept_encodings = AHR_ENCODING_DEFAULT,
+        .max_decoded_bytes = 0,
+        .content_encoding = AHR_ENCODING_DEFAULT,
+        .compression_level = 0,
+        .min_compress_bytes = 0,
+        .zstd_dictionary = NULL,
+        .zstd_dictionary_bytes = 0,
+        .json_index = AHR_JSON_INDEX_DEFAULT,
+        .trace_events = 0,
+        .record_path = NULL,
+        .timeout_ms = 0,
+        .stall_seconds = 0
+    };
+    return AHR_CreateProcessorWithOptions(&options, logger);
+}
+
+AHR_Processor_t AHR_CreateProcessorWithOptions(const AHR_ProcessorOptions_t *options, AHR_Logger_t logger)
+{
+    assert(NULL != options);
     //
     // Create a AHR_Processor_t handle.
     //
-    if(max_objects > 25)
+    const size_t max_objects = options->max_objects;
+    if(max_objects > AHR_PROCESSOR_MAX_OBJECTS)
     {
         return NULL;
     }
@@ -147,46 +366,129 @@ AHR_Processor_t AHR_CreateProcessor(size_t max_objects, AHR_Logger_t logger)
     //
     if(!processor)
     {
-        AHR_LogError(logger, "Unable to allocate Memory for this HTTP Reqeust Processor.\n");
+        AHR_LOG_ERROR(logger, "Unable to allocate Memory for this HTTP Reqeust Processor.\n");
         return NULL;
     }
+    //
+    // Everything AHR_DestroyProcessor() looks at must be valid before the first Error can occur.
+    //
+    processor->logger = logger;
+    processor->thread = (AHR_Thread_t)NULL;
+    processor->handle = NULL;
+    processor->mutex = NULL;
+    processor->requests = (AHR_Stack_t){.data = NULL, .max_size = 0, .top = 0};
+    processor->result_list.head = NULL;
+    processor->result_store = (AHR_ResultStore_t){.results = NULL, .nresults = 0, .owns_results = false};
+    processor->arena = (AHR_Arena_t){.base = NULL, .capacity = 0, .used = 0, .flags = 0};
+    processor->pool = AHR_CreateBufferPool();
+    processor->io_cache = AHR_CreateBufferCache(&processor->pool);
+    processor->header_cache = AHR_CreateHeaderListCache();
+    processor->accept_encodings = options->accept_encodings;
+    processor->max_decoded_bytes = options->max_decoded_bytes;
+    processor->timeout_ms = options->timeout_ms > 0 ? options->timeout_ms : AHR_PROCESSOR_DEFAULT_TIMEOUT_MS;
+    processor->stall_seconds = options->stall_seconds > 0 
+        ? options->stall_seconds 
+        : AHR_PROCESSOR_DEFAULT_STALL_SECONDS;
+    atomic_init(&processor->decoding.responses, 0);
+    atomic_init(&processor->decoding.encoded_responses, 0);
+    atomic_init(&processor->decoding.wire_bytes, 0);
+    atomic_init(&processor->decoding.decoded_bytes, 0);
+    atomic_init(&processor->decoding.limit_exceeded, 0);
+    processor->content_encoding = options->content_encoding;
+    processor->compression_level = options->compression_level;
+    processor->min_compress_bytes = options->min_compress_bytes;
+    processor->json_index = options->json_index;
+    atomic_init(&processor->curl_verbose, false);
+    processor->metrics = AHR_CreateMetrics();
+    processor->tracer = AHR_CreateTracer(options->trace_events);
+    processor->recorder = AHR_CreateRecorder(options->record_path);
+    processor->dictionary = AHR_CreateCompressionDictionary(
+        options->zstd_dictionary, 
+        options->zstd_dictionary_bytes, 
+        options->compression_level
+    );
+    for(size_t i=0;i<AHR_COMPRESSION_MAX_ENDPOINTS;++i)
+    {
+        atomic_init(&processor->compression[i].key, 0);
+        processor->compression[i].endpoint[0] = '\0';
+        atomic_init(&processor->compression[i].requests, 0);
+        atomic_init(&processor->compression[i].uncompressed_bytes, 0);
+        atomic_init(&processor->compression[i].compressed_bytes, 0);
+    }
+    atomic_store(&(processor->terminate), 0);
+    if(
+        !AHR_BufferPoolIsValid(&processor->pool) 
+        || !AHR_HeaderListCacheIsValid(&processor->header_cache)
+        || !processor->metrics
+        || (options->trace_events > 0 && !processor->tracer)
+    )
+    {
+        AHR_LOG_ERROR(logger, "Unable to create the Buffer Pool, the Header List Cache, the Metrics or the Tracer.\n");
+        goto on_error;
+    }
+    if(options->record_path && !processor->recorder)
+    {
+        AHR_LOG_ERROR(logger, "Unable to create the Recording %s.\n", options->record_path);
+        goto on_error;
+    }
+    if(options->zstd_dictionary && !AHR_CompressionDictionaryIsValid(&processor->dictionary))
+    {
+        AHR_LOG_ERROR(logger, "Unable to load the zstd Dictionary, is libahr built with zstd?\n");
+        goto on_error;
+    }
+
     processor->handle = AHR_CurlMultiInit(); 
     //
     // If the Curl Handle was not allocated, there is no point in going on...
     //
     if(!processor->handle)
     {
-        AHR_LogError(logger, "Unable to create CURL Multi Handle.\n");
+        AHR_LOG_ERROR(logger, "Unable to create CURL Multi Handle.\n");
         goto on_error;
     }
-    
-    // TODO: 
-    //  - Malloc only on init -> pre-create all Resultobjects
-    //  - Make url reconfigurable in request objects
-    //  - Make Callback reconfigurable in response objects
-    processor->result_store = AHR_CreateResultStore(max_objects);
-    // 
-    // TODO: Check if the Result Store is valid...
     //
+    // One Mapping for all fixed size Storage, it is carved up below and never grows.
+    //
+    processor->arena = AHR_CreateArena(AHR_ProcessorArenaBytes(max_objects), options->memory_flags);
+    if(!AHR_ArenaIsValid(&processor->arena))
+    {
+        AHR_LOG_ERROR(logger, "Unable to map the Arena of this HTTP Request Processor.\n");
+        goto on_error;
+    }
+    processor->result_store = AHR_CreateResultStoreInArena(&processor->arena, max_objects);
+    if(!processor->result_store.results)
+    {
+        goto on_error;
+    }
     for(size_t i = 0;i<AHR_ResultStoreSize(&processor->result_store); ++i)
     {
         AHR_Result_t *result = AHR_ResultStoreGetResult(&processor->result_store, i);
-        result->request_data.body = malloc(AHR_PROCESSOR_MAX_BODY_SIZE);
-        result->request_data.url = malloc(AHR_PROCESSOR_MAX_URL_LEN);
-        memset(&result->request_data.header, '\0', sizeof(AHR_Header_t));
-        result->request = AHR_CreateRequest();
-        result->response = AHR_CreateResponse();
+        //
+        // Bodies are borrowed from the Pool while a Transfer needs them, only the Url stays with the Object.
+        //
+        result->request_data.body = NULL;
+        result->request_data.url = AHR_ArenaAlloc(&processor->arena, AHR_PROCESSOR_MAX_URL_LEN + 1);
+        result->request_data.header = NULL;
+        result->request_data.nheaders = 0;
+        result->request = AHR_CreateRequestInArena(&processor->arena);
+        result->response = AHR_CreateResponseForPool(&processor->arena, &processor->pool, &processor->io_cache);
+        if(!result->request_data.url || !result->request || !result->response)
+        {
+            AHR_LOG_ERROR(logger, "Unable to create the Objects of this HTTP Request Processor.\n");
+            goto on_error;
+        }
+        AHR_RequestSetLogger(result->request, logger);
+        AHR_ResponseSetLogger(result->response, logger);
+        AHR_RequestSetHeaderListCache(result->request, &processor->header_cache);
+        result->tracer = processor->tracer;
     }
     //
     processor->requests = AHR_CraeteStack(max_objects);
-    processor->result_list.head = NULL;
-    
     processor->mutex = AHR_CreateMutex();
-    atomic_store(&(processor->terminate), 0);
-
-    processor->logger = logger;
-    processor->thread = (AHR_Thread_t)NULL;
-
+    if(!processor->requests.data || !processor->mutex)
+    {
+        goto on_error;
+    }
     return processor;
 
     //
@@ -202,19 +504,149 @@ void AHR_DestroyProcessor(AHR_Processor_t *processor)
     if(!*processor) return;
 
     AHR_ProcessorStop(*processor);
-    AHR_DestroyResultStore(&(*processor)->result_store);
-    AHR_CurlMultiCleanUp((*processor)->handle);
+    for(size_t i = 0;i<AHR_ResultStoreSize(&(*processor)->result_store); ++i)
+    {
+        AHR_Result_t *result = AHR_ResultStoreGetResult(&(*processor)->result_store, i);
+        AHR_ResultReleaseBody(result);
+        AHR_DestroyCompressor(&result->compressor);
+        if(result->request)
+        {
+            AHR_DestroyRequest(&result->request);
+        }
+        if(result->response)
+        {
+            AHR_DestroyResponse(&result->response);
+        }
+    }
+    if((*processor)->result_store.results)
+    {
+        AHR_DestroyResultStore(&(*processor)->result_store);
+    }
+    if((*processor)->requests.data)
+    {
+        AHR_DestroyStack(&(*processor)->requests);
+    }
+    if((*processor)->mutex)
+    {
+        AHR_DestroyMutex(&(*processor)->mutex);
+    }
+    if((*processor)->handle)
+    {
+        AHR_CurlMultiCleanUp((*processor)->handle);
+    }
+    //
+    // All Objects are gone, this releases their Storage at once.
+    //
+    AHR_DestroyArena(&(*processor)->arena);
+    AHR_DestroyBufferCache(&(*processor)->io_cache);
+    AHR_DestroyBufferPool(&(*processor)->pool);
+    AHR_DestroyHeaderListCache(&(*processor)->header_cache);
+    AHR_DestroyCompressionDictionary(&(*processor)->dictionary);
+    AHR_DestroyMetrics(&(*processor)->metrics);
+    AHR_DestroyTracer(&(*processor)->tracer);
+    AHR_DestroyRecorder(&(*processor)->recorder);
     
     free(*processor);
     *processor = NULL;
 }
 
+void AHR_ProcessorBufferPoolStats(const AHR_Processor_t processor, AHR_BufferPoolStats_t *stats)
+{
+    assert(NULL != processor);
+    AHR_BufferPoolStats(&processor->pool, stats);
+}
+
+void AHR_ProcessorDecodingStats(const AHR_Processor_t processor, AHR_DecodingStats_t *stats)
+{
+    assert(NULL != processor);
+    assert(NULL != stats);
+    stats->responses = atomic_load_explicit(&processor->decoding.responses, memory_order_relaxed);
+    stats->encoded_responses = atomic_load_explicit(&processor->decoding.encoded_responses, memory_order_relaxed);
+    stats->wire_bytes = atomic_load_explicit(&processor->decoding.wire_bytes, memory_order_relaxed);
+    stats->decoded_bytes = atomic_load_explicit(&processor->decoding.decoded_bytes, memory_order_relaxed);
+    stats->limit_exceeded = atomic_load_explicit(&processor->decoding.limit_exceeded, memory_order_relaxed);
+}
+
+size_t AHR_ProcessorCompressionStats(const AHR_Processor_t processor, AHR_CompressionStats_t *stats, size_t nstats)
+{
+    assert(NULL != processor);
+    size_t count = 0;
+    for(size_t i=0;i<AHR_COMPRESSION_MAX_ENDPOINTS;++i)
+    {
+        const AHR_CompressionCounters_t *counters = &processor->compression[i];
+        if(0 == atomic_load_explicit(&counters->key, memory_order_acquire))
+        {
+            continue;
+        }
+        if(count < nstats)
+        {
+            AHR_CompressionStats_t *current = &stats[count];
+            memcpy(current->endpoint, counters->endpoint, sizeof(current->endpoint)); // flawfinder: ignore
+            current->requests = atomic_load_explicit(&counters->requests, memory_order_relaxed);
+            current->uncompressed_bytes = atomic_load_explicit(&counters->uncompressed_bytes, memory_order_relaxed);
+            current->compressed_bytes = atomic_load_explicit(&counters->compressed_bytes, memory_order_relaxed);
+        }
+        ++count;
+    }
+    return count;
+}
+
+void AHR_ProcessorMetricsSnapshot(const AHR_Processor_t processor, AHR_MetricsSnapshot_t *snapshot)
+{
+    assert(NULL != processor);
+    AHR_MetricsTakeSnapshot(processor->metrics, snapshot);
+}
+
+int64_t AHR_ProcessorMetricsPrometheus(const AHR_Processor_t processor, char *buffer, size_t nbytes)
+{
+    assert(NULL != processor);
+    return AHR_MetricsPrometheus(processor->metrics, buffer, nbytes);
+}
+
+bool AHR_ProcessorDumpTrace(AHR_Processor_t processor, int fd)
+{
+    assert(NULL != processor);
+    return AHR_TraceDump(processor->tracer, fd);
+}
+
+size_t AHR_TrainZstdDictionary(
+    const char *const *samples,
+    const size_t *sizes,
+    size_t nsamples,
+    void *dictionary,
+    size_t capacity
+)
+{
+    return AHR_CompressionTrainDictionary(samples, sizes, nsamples, dictionary, capacity);
+}
+
+void AHR_ProcessorFootprint(const AHR_Processor_t processor, AHR_ProcessorFootprint_t *footprint)
+{
+    assert(NULL != processor);
+    assert(NULL != footprint);
+
+    const unsigned int flags = AHR_ArenaFlags(&processor->arena);
+    footprint->arena_bytes = AHR_ArenaCapacity(&processor->arena);
+    footprint->arena_used = AHR_ArenaUsed(&processor->arena);
+    footprint->huge_pages = 0U != (flags & AHR_ARENA_HUGE_PAGES);
+    footprint->transparent_huge_pages = 0U != (flags & AHR_ARENA_TRANSPARENT_HUGE_PAGES);
+    footprint->heap_bytes = sizeof(struct AHR_Processor) 
+        + processor->requests.max_size * sizeof(void*) 
+        + AHR_BufferPoolBytes(&processor->pool)
+        + sizeof(AHR_Metrics_t);
+    for(size_t i = 0;i<processor->result_store.nresults; ++i)
+    {
+        const AHR_Result_t *result = &processor->result_store.results[i];
+        footprint->heap_bytes += AHR_RequestHeapBytes(result->request) + AHR_ResponseHeapBytes(result->response);
+    }
+}
+
 bool AHR_ProcessorStart(AHR_Processor_t processor)
 {
     // ----
     if((AHR_Thread_t)NULL != processor->thread)
     {
-        AHR_LogWarning(
+        AHR_LOG_WARNING(
             processor->logger, 
             "Uable to start Processors Thread because it was alreay started...\n"
         );
@@ -228,7 +660,7 @@ bool AHR_ProcessorStart(AHR_Processor_t processor)
         return true;
     }
     // ----
-    AHR_LogError(processor->logger, "Unable to create Thread.\n");
+    AHR_LOG_ERROR(processor->logger, "Unable to create Thread.\n");
     return false;
 }
 
@@ -241,6 +673,13 @@ void AHR_ProcessorStop(AHR_Processor_t processor)
         AHR_JoinThread(processor->thread, &result);
         AHR_DestroyThread(&processor->thread);
     }
+    //
+    // The Records of a Capture are complete once the Processor stopped, not only once it is destroyed.
+    //
+    if(processor->recorder && !AHR_RecorderFlush(processor->recorder))
+    {
+        AHR_LOG_ERROR(processor->logger, "Unable to write the Recording.\n");
+    }
 }
 
 size_t AHR_ProcessorNumberOfRequestObjects(const AHR_Processor_t processor)
@@ -269,38 +708,319 @@ AHR_ProcessorStatus_t AHR_ProcessorPrepareRequest(
     // Assertions...
     //
     assert(NULL != request_data);
-    assert(NULL != request_data->url);
+    assert(NULL != request_data->url || NULL != request_data->path);
 
     AHR_Result_t *result = AHR_ResultStoreGetResult(
         &processor->result_store,
         object
     );
+    //
+    // A Path only replaces Path and Query of the parsed Base URL, the Origin is not parsed again.
+    //
+    uint64_t endpoint = 0;
+    if(request_data->path)
+    {
+        if(!AHR_RequestSetPath(result->request, request_data->path))
+        {
+            AHR_LOG_WARNING(processor->logger, "The Object has no Base URL or the Path is too long.");
+            return AHR_PROC_INVALID_URL;
+        }
+        result->request_data.url[0] = '\0';
+        endpoint = AHR_BufferPoolEndpointKeyFrom(AHR_RequestBaseKey(result->request), request_data->path);
+    }
+    else if('\0' == request_data->url[0])
+    {
+        return AHR_PROC_INVALID_URL;
+    }
+    else
+    {
+        const size_t len = strnlen(request_data->url, AHR_PROCESSOR_MAX_URL_LEN);
+        memcpy(result->request_data.url, request_data->url, len); // flawfinder: ignore
+        result->request_data.url[len] = '\0';
+        endpoint = AHR_BufferPoolEndpointKey(request_data->url);
+    }
     // ---- 
     // ---- 
     //
     // Processing...
     //
-    AHR_RequestSetHeader(
+    if(
+        !AHR_RequestSetHeader(
+            result->request,
+            request_data->header,
+            request_data->nheaders
+        )
+    )
+    {
+        //
+        // A Request without some of its Headers must not be sent. The new Body was not borrowed yet,
+        // the Body of the previous Configuration is let go like on every Reconfiguration.
+        //
+        AHR_LOG_WARNING(processor->logger, "Not all Request Headers could be stored, Limit exceeded.");
+        AHR_ResultReleaseBody(result);
+        return AHR_PROC_NOT_ENOUGH_MEMORY;
+    }
+    if(
+        !AHR_ResponseSetHeaderFilter(
+            result->response,
+            request_data->response_headers,
+            request_data->response_headers ? request_data->nresponse_headers : 0
+        )
+    )
+    {
+        AHR_LOG_WARNING(processor->logger, "Response Header Whitelist exceeds the Limits, all Headers are stored.");
+    }
+    AHR_RequestSetVerbose(result->request, atomic_load_explicit(&processor->curl_verbose, memory_order_relaxed));
+    AHR_RequestSetAcceptEncoding(
         result->request,
-        &request_data->header
+        AHR_ENCODING_DEFAULT != request_data->accept_encodings 
+            ? request_data->accept_encodings 
+            : processor->accept_encodings
     );
-    if(request_data->body)
+    AHR_ResponseSetDecodedLimit(
+        result->response,
+        request_data->max_decoded_bytes > 0 ? request_data->max_decoded_bytes : processor->max_decoded_bytes
+    );
+    //
+    // A streamed Transfer may run for as long as Data keeps moving, a total Timeout would cut off large
+    // Uploads and Downloads and count the Time the Consumer kept it paused.
+    //
+    const bool streamed = data.on_data 
+        || request_data->body_provider 
+        || request_data->file_sink 
+        || request_data->file_source;
+    size_t timeout_ms = request_data->timeout_ms;
+    size_t stall_seconds = 0;
+    if(0 == timeout_ms)
+    {
+        timeout_ms = streamed ? AHR_TIMEOUT_NONE : processor->timeout_ms;
+        stall_seconds = streamed ? processor->stall_seconds : 0;
+    }
+    AHR_RequestSetTimeout(result->request, AHR_TIMEOUT_NONE == timeout_ms ? 0 : timeout_ms, stall_seconds);
+    //
+    // A borrowed Body is used as is. Only the NULL-terminated Body is copied, and only its actual Length.
+    // A File is either mapped and then sent like a borrowed Body, or it is read piecewise through a Provider.
+    //
+    AHR_ProcessorStatus_t status = AHR_PROC_OK;
+    AHR_BodyDescriptor_t body = {.data=NULL, .nbytes=0, .release=NULL, .user=NULL};
+    AHR_ResultReleaseBody(result);
+    result->provider = (AHR_BodyProvider_t){.read=NULL, .rewind=NULL, .user=NULL, .content_length=0};
+    if(request_data->body_provider)
+    {
+        result->provider = *request_data->body_provider;
+    }
+    else if(request_data->file_source)
     {
-        memset(result->request_data.body, '\0', AHR_PROCESSOR_MAX_BODY_SIZE+1);
-        memcpy( // flawfinder: ignore
-            result->request_data.body, 
-            request_data->body, 
-            strnlen(
-                request_data->body, 
-                AHR_PROCESSOR_MAX_BODY_SIZE
+        if(!AHR_FileReaderOpen(&result->file_source, request_data->file_source))
+        {
+            AHR_LOG_WARNING(processor->logger, "Unable to open the File for the Request Body.");
+            status = AHR_PROC_IO_ERROR;
+        }
+        else if(AHR_FileReaderData(&result->file_source))
+        {
+            body.data = AHR_FileReaderData(&result->file_source);
+            body.nbytes = (size_t)AHR_FileReaderLength(&result->file_source);
+        }
+        else
+        {
+            result->provider = (AHR_BodyProvider_t){
+                .read = AHR_FileReaderRead,
+                .rewind = AHR_FileReaderRewind,
+                .user = &result->file_source,
+                .content_length = AHR_FileReaderLength(&result->file_source)
+            };
+        }
+    }
+    else if(request_data->borrowed_body)
+    {
+        body = *request_data->borrowed_body;
+    }
+    else if(request_data->body)
+    {
+        const size_t nbytes = strnlen(request_data->body, AHR_PROCESSOR_MAX_BODY_SIZE);
+        char *copy = AHR_BufferPoolAcquire(&processor->pool, NULL, nbytes + 1);
+        if(copy)
+        {
+            memcpy(copy, request_data->body, nbytes); // flawfinder: ignore
+            copy[nbytes] = '\0';
+            body.data = copy;
+            body.nbytes = nbytes;
+            body.release = AHR_ProcessorReleasePooledBody;
+            body.user = processor;
+        }
+        else
+        {
+            AHR_LOG_WARNING(processor->logger, "Unable to borrow a Buffer for the Request Body.");
+            status = AHR_PROC_NOT_ENOUGH_MEMORY;
+        }
+    }
+    //
+    // A Body in Memory is compressed here on the Callers Thread, the Processor Mutex is not held. A Body from
+    // a Provider or a File is compressed Block by Block while curl pulls it on the Processors Thread.
+    //
+    result->body_encoding = 0;
+    result->body_uncompressed = 0;
+    result->body_compressed = 0;
+    const unsigned int encoding = AHR_ProcessorBodyEncoding(processor, request_data);
+    if(AHR_PROC_OK == status && 0 != encoding)
+    {
+        if(result->provider.read)
+        {
+            if(
+                AHR_CompressorBeginStream(
+                    &result->compressor, 
+                    encoding, 
+                    processor->compression_level, 
+                    &processor->dictionary, 
+                    &result->provider
+                )
             )
-        );
+            {
+                result->provider = AHR_CompressorProvider(&result->compressor);
+                result->body_encoding = encoding;
+            }
+            else
+            {
+                AHR_LOG_WARNING(processor->logger, "Unable to compress the Request Body, it is sent as is.");
+            }
+        }
+        else if(body.data && body.nbytes > 0 && body.nbytes >= processor->min_compress_bytes)
+        {
+            AHR_ProcessorCompressBody(processor, result, encoding, &body);
+        }
     }
-    memset(result->request_data.url, '\0', AHR_PROCESSOR_MAX_URL_LEN+1);
-    memcpy(result->request_data.url, request_data->url, AHR_PROCESSOR_MAX_URL_LEN); // flawfinder: ignore
+    AHR_RequestSetContentEncoding(result->request, result->body_encoding);
+    AHR_ResultSetBody(result, &body);
 
     result->user_data = data;
-    return AHR_PROC_OK; 
+    AHR_ResponseSetEndpoint(result->response, endpoint);
+    AHR_RequestSetFileSink(result->request, request_data->file_sink);
+    AHR_ResponseSetDataSink(
+        result->response,
+        data.on_data ? AHR_ProcessorStreamData : NULL,
+        result
+    );
+    const unsigned int json_index = AHR_JSON_INDEX_DEFAULT != request_data->json_index 
+        ? request_data->json_index 
+        : processor->json_index;
+    AHR_ResponseSetJsonIndex(
+        result->response,
+        AHR_JSON_INDEX_ON == json_index && !data.on_data && !request_data->file_sink
+    );
+    return status; 
+}
+
+void AHR_ProcessorSetCurlVerbose(AHR_Processor_t processor, bool verbose)
+{
+    assert(NULL != processor);
+    atomic_store_explicit(&processor->curl_verbose, verbose, memory_order_relaxed);
+}
+
+AHR_ProcessorStatus_t AHR_ProcessorSetBaseUrl(AHR_Processor_t processor, const char *base_url)
+{
+    assert(NULL != processor);
+    AHR_MutexLock(processor->mutex);
+    const AHR_ProcessorStatus_t status = AHR_ProcessorBindBaseUrl(
+        processor, 
+        0, 
+        AHR_ResultStoreSize(&processor->result_store), 
+        base_url
+    );
+    AHR_MutexUnlock(processor->mutex);
+    return status;
+}
+
+AHR_ProcessorStatus_t AHR_ProcessorSetObjectBaseUrl(AHR_Processor_t processor, size_t object, const char *base_url)
+{
+    assert(NULL != processor);
+    if(object >= AHR_ResultStoreSize(&processor->result_store))
+    {
+        return AHR_PROC_UNKNOWN_OBJECT;
+    }
+    AHR_MutexLock(processor->mutex);
+    const AHR_ProcessorStatus_t status = AHR_ProcessorBindBaseUrl(processor, object, object + 1, base_url);
+    AHR_MutexUnlock(processor->mutex);
+    return status;
+}
+
+size_t AHR_ProcessorResponseHeaderCount(AHR_Processor_t processor, size_t object)
+{
+    assert(NULL != processor);
+    if(object >= AHR_ResultStoreSize(&processor->result_store))
+    {
+        return 0;
+    }
+    return AHR_ResponseHeaderCount(
+        AHR_ResultStoreGetResult(&processor->result_store, object)->response
+    );
+}
+
+bool AHR_ProcessorResponseHeaderAt(
+    AHR_Processor_t processor,
+    size_t object,
+    size_t index,
+    AHR_HeaderView_t *header
+)
+{
+    assert(NULL != processor);
+    assert(NULL != header);
+    if(object >= AHR_ResultStoreSize(&processor->result_store))
+    {
+        return false;
+    }
+    return AHR_ResponseHeaderAt(
+        AHR_ResultStoreGetResult(&processor->result_store, object)->response,
+        index,
+        header
+    );
+}
+
+bool AHR_ProcessorResponseHeaderFind(
+    AHR_Processor_t processor,
+    size_t object,
+    const char *name,
+    AHR_HeaderView_t *header
+)
+{
+    assert(NULL != processor);
+    assert(NULL != name);
+    assert(NULL != header);
+    if(object >= AHR_ResultStoreSize(&processor->result_store))
+    {
+        return false;
+    }
+    return AHR_ResponseHeaderFind(
+        AHR_ResultStoreGetResult(&processor->result_store, object)->response,
+        name,
+        header
+    );
+}
+
+bool AHR_ProcessorResponseJson(AHR_Processor_t processor, size_t object, AHR_JsonIndex_t *index)
+{
+    assert(NULL != processor);
+    assert(NULL != index);
+    if(object >= AHR_ResultStoreSize(&processor->result_store))
+    {
+        *index = (AHR_JsonIndex_t){.body=NULL, .nbytes=0, .tokens=NULL, .ntokens=0, .error_offset=0};
+        return false;
+    }
+    return AHR_ResponseJsonIndex(
+        AHR_ResultStoreGetResult(&processor->result_store, object)->response,
+        index
+    );
+}
+
+bool AHR_ProcessorRequestTimings(AHR_Processor_t processor, size_t object, AHR_RequestTimings_t *timings)
+{
+    assert(NULL != processor);
+    assert(NULL != timings);
+    if(object >= AHR_ResultStoreSize(&processor->result_store))
+    {
+        return false;
+    }
+    *timings = AHR_ResultStoreGetResult(&processor->result_store, object)->timings;
+    return true;
 }
 
 AHR_ProcessorStatus_t AHR_ProcessorMakeRequest(AHR_Processor_t processor, size_t object)
@@ -308,6 +1028,7 @@ AHR_ProcessorStatus_t AHR_ProcessorMakeRequest(AHR_Processor_t processor, size_t
     assert(NULL != processor);
 
     AHR_ProcessorStatus_t retval = AHR_PROC_OK;
+    AHR_TraceBegin(processor->tracer, "AHR_ProcessorMakeRequest", (uint32_t)object);
     AHR_MutexLock(processor->mutex);
     AHR_Result_t *result = AHR_ResultStoreGetResult(
         &processor->result_store,
@@ -319,27 +1040,70 @@ AHR_ProcessorStatus_t AHR_ProcessorMakeRequest(AHR_Processor_t processor, size_t
     // ---- 
     if(!result)
     {
-        AHR_LogWarning(processor->logger, "Warning: Unable to retrieve unused element.");
+        AHR_LOG_WARNING(processor->logger, "Warning: Unable to retrieve unused element.");
         retval = AHR_PROC_UNKNOWN_OBJECT;
         goto end;
     }
     // ---- 
-    if(AHR_ProcessorIsResultBusy(result))
+    //
+    // The Object stays locked until the Transfer ended, so it can not be reconfigured 
+    // while curl still uses its Body.
+    //
+    if(!AHR_ProcessorTryLockResult(result))
     {
         retval = AHR_PROC_OBJECT_BUSY;
         goto end;
     }
     // ---- 
     //
-    // Process...
+    // Process...
+    // The Response is reset by the I/O Thread once it dequeued the Request, the Callback of the previous
+    // Transfer may still read it.
+    //
+    atomic_store(&result->resume, 0);
+    result->paused = false;
+    result->timings = (AHR_RequestTimings_t){0};
+    result->timings.submit_ns = AHR_ProcessorNowNs();
+    if(processor->tracer)
+    {
+        const uint64_t now = AHR_TraceNow();
+        result->trace_id = AHR_TraceNextId(processor->tracer);
+        AHR_TraceAsyncBegin(processor->tracer, "request", result->trace_id, (uint32_t)object, now);
+        AHR_TraceAsyncBegin(processor->tracer, "queued", result->trace_id, (uint32_t)object, now);
+    }
+    AHR_StackPush(&processor->requests, result);
+    AHR_MetricsSubmitted(processor->metrics);
+    AHR_PROBE3(request__submit, object, result->response, result->timings.submit_ns);
+
+end:
+    AHR_MutexUnlock(processor->mutex);
+    AHR_TraceEnd(processor->tracer, "AHR_ProcessorMakeRequest", (uint32_t)object);
+    //
+    // Wake the Thread only after the Mutex was released, otherwise it can not pick up the new Request
+    // and sleeps in the next Poll.
+    //
+    if(AHR_PROC_OK == retval)
+    {
+        AHR_CurlMultiWeakUp(processor->handle);
+    }
+    return retval;
+}
+
+AHR_ProcessorStatus_t AHR_ProcessorResumeResponse(AHR_Processor_t processor, size_t object)
+{
+    assert(NULL != processor);
+    if(object >= AHR_ResultStoreSize(&processor->result_store))
+    {
+        return AHR_PROC_UNKNOWN_OBJECT;
+    }
+    //
+    // curl_easy_pause() must be called from the Thread which drives the Multi Handle,
+    // only flag the Object here and wake the Thread up.
     //
-    AHR_ResponseReset(result->response);
-    AHR_StackPush(&processor->requests, result);
+    AHR_Result_t *result = AHR_ResultStoreGetResult(&processor->result_store, object);
+    atomic_store(&result->resume, 1);
     AHR_CurlMultiWeakUp(processor->handle);
-
-end:
-    AHR_MutexUnlock(processor->mutex);
-    return retval;
+    return AHR_PROC_OK;
 }
 
 AHR_ProcessorStatus_t AHR_ProcessorGet(
@@ -361,9 +1125,10 @@ AHR_ProcessorStatus_t AHR_ProcessorGet(
     // ---- 
     if(!result)
     {
-        AHR_LogWarning(
+        AHR_LOG_WARNING(
             processor->logger,
-            "Warning: Unable to retrieve unused element."
+            "Warning: Unable to retrieve unused element %zu.",
+            object
         );
         status = AHR_PROC_UNKNOWN_OBJECT;
         goto end;
@@ -371,25 +1136,41 @@ AHR_ProcessorStatus_t AHR_ProcessorGet(
     // ---- 
     if(!AHR_ProcessorTryLockResult(result))
     {
-        AHR_LogInfo(
+        AHR_LOG_INFO(
             processor->logger,
-            "Sorry the Object you are requesting is busy."
+            "Sorry the Object %zu you are requesting is busy.",
+            object
         );
         status = AHR_PROC_OBJECT_BUSY;
         goto end;
     }
     // ---- 
     //
+    // The busy Object keeps AHR_ProcessorMakeRequest(), AHR_ProcessorSetBaseUrl() and the Processors Thread
+    // away, so it is configured without the Mutex. Other Threads do not wait while its Body is compressed.
+    //
+    AHR_MutexUnlock(processor->mutex);
+    //
     // Process...
     //
-    AHR_ProcessorPrepareRequest(
+    status = AHR_ProcessorPrepareRequest(
         processor,
         object,
         request_data,
         data
     );
-    AHR_Get(result->request, result->request_data.url, result->response);
+    if(AHR_PROC_OK != status)
+    {
+        AHR_ProcessorUnlockResult(result);
+        return status;
+    }
+    status = AHR_ProcessorConfigured(
+        processor,
+        result,
+        AHR_Get(result->request, AHR_ProcessorRequestUrl(result), result->response)
+    );
     AHR_ProcessorUnlockResult(result);
+    return status;
 end:
     AHR_MutexUnlock(processor->mutex);
     return status;
@@ -414,9 +1195,10 @@ AHR_ProcessorStatus_t AHR_ProcessorPost(
     // ---- 
     if(!result)
     {
-        AHR_LogWarning(
+        AHR_LOG_WARNING(
             processor->logger,
-            "Warning: Unable to retrieve unused element."
+            "Warning: Unable to retrieve unused element %zu.",
+            object
         );
         status = AHR_PROC_UNKNOWN_OBJECT;
         goto end;
@@ -424,25 +1206,56 @@ AHR_ProcessorStatus_t AHR_ProcessorPost(
     // ---- 
     if(!AHR_ProcessorTryLockResult(result))
     {
-        AHR_LogInfo(
+        AHR_LOG_INFO(
             processor->logger,
-            "Sorry the Object you are requesting is busy."
+            "Sorry the Object %zu you are requesting is busy.",
+            object
         );
         status = AHR_PROC_OBJECT_BUSY;
         goto end;
     }
     // ---- 
     //
+    // Configured without the Mutex, see AHR_ProcessorGet().
+    //
+    AHR_MutexUnlock(processor->mutex);
+    //
     // Process...
     //
-    AHR_ProcessorPrepareRequest(
+    status = AHR_ProcessorPrepareRequest(
         processor,
         object,
         data,
         user_data
     );
-    AHR_Post(result->request, result->request_data.url, result->request_data.body, result->response);
+    if(AHR_PROC_OK != status)
+    {
+        AHR_ProcessorUnlockResult(result);
+        return status;
+    }
+    bool configured = false;
+    if(result->provider.read)
+    {
+        configured = AHR_PostFromProvider(
+            result->request, 
+            AHR_ProcessorRequestUrl(result), 
+            &result->provider, 
+            result->response
+        );
+    }
+    else
+    {
+        configured = AHR_Post(
+            result->request, 
+            AHR_ProcessorRequestUrl(result), 
+            result->body.data, 
+            result->body.nbytes, 
+            result->response
+        );
+    }
+    status = AHR_ProcessorConfigured(processor, result, configured);
     AHR_ProcessorUnlockResult(result);
+    return status;
 end:
     AHR_MutexUnlock(processor->mutex);
     return status;
@@ -467,9 +1280,10 @@ AHR_ProcessorStatus_t AHR_ProcessorPut(
     // ---- 
     if(!result)
     {
-        AHR_LogWarning(
+        AHR_LOG_WARNING(
             processor->logger,
-            "Warning: Unable to retrieve unused element."
+            "Warning: Unable to retrieve unused element %zu.",
+            object
         );
         status = AHR_PROC_UNKNOWN_OBJECT;
         goto end;
@@ -477,25 +1291,56 @@ AHR_ProcessorStatus_t AHR_ProcessorPut(
     // ---- 
     if(!AHR_ProcessorTryLockResult(result))
     {
-        AHR_LogInfo(
+        AHR_LOG_INFO(
             processor->logger,
-            "Sorry the Object you are requesting is busy."
+            "Sorry the Object %zu you are requesting is busy.",
+            object
         );
         status = AHR_PROC_OBJECT_BUSY;
         goto end;
     }
     // ---- 
     //
+    // Configured without the Mutex, see AHR_ProcessorGet().
+    //
+    AHR_MutexUnlock(processor->mutex);
+    //
     // Process...
     //
-    AHR_ProcessorPrepareRequest(
+    status = AHR_ProcessorPrepareRequest(
         processor,
         object,
         data,
         user_data
     );
-    AHR_Put(result->request, result->request_data.url, result->request_data.body, result->response);
+    if(AHR_PROC_OK != status)
+    {
+        AHR_ProcessorUnlockResult(result);
+        return status;
+    }
+    bool configured = false;
+    if(result->provider.read)
+    {
+        configured = AHR_PutFromProvider(
+            result->request, 
+            AHR_ProcessorRequestUrl(result), 
+            &result->provider, 
+            result->response
+        );
+    }
+    else
+    {
+        configured = AHR_Put(
+            result->request, 
+            AHR_ProcessorRequestUrl(result), 
+            result->body.data, 
+            result->body.nbytes, 
+            result->response
+        );
+    }
+    status = AHR_ProcessorConfigured(processor, result, configured);
     AHR_ProcessorUnlockResult(result);
+    return status;
 end:
     AHR_MutexUnlock(processor->mutex);
     return status;
@@ -520,9 +1365,10 @@ AHR_ProcessorStatus_t AHR_ProcessorDelete(
     // ---- 
     if(!result)
     {
-        AHR_LogWarning(
+        AHR_LOG_WARNING(
             processor->logger,
-            "Warning: Unable to retrieve unused element."
+            "Warning: Unable to retrieve unused element %zu.",
+            object
         );
         status = AHR_PROC_UNKNOWN_OBJECT;
         goto end;
@@ -530,25 +1376,40 @@ AHR_ProcessorStatus_t AHR_ProcessorDelete(
     // ---- 
     if(!AHR_ProcessorTryLockResult(result))
     {
-        AHR_LogInfo(
+        AHR_LOG_INFO(
             processor->logger,
-            "Sorry the Object you are requesting is busy."
+            "Sorry the Object %zu you are requesting is busy.",
+            object
         );
         status = AHR_PROC_OBJECT_BUSY;
         goto end;
     }
     // ---- 
     //
+    // Configured without the Mutex, see AHR_ProcessorGet().
+    //
+    AHR_MutexUnlock(processor->mutex);
+    //
     // Process...
     //
-    AHR_ProcessorPrepareRequest(
+    status = AHR_ProcessorPrepareRequest(
         processor,
         object,
         data,
         user_data
     );
-    AHR_Delete(result->request, result->request_data.url, result->response);
+    if(AHR_PROC_OK != status)
+    {
+        AHR_ProcessorUnlockResult(result);
+        return status;
+    }
+    status = AHR_ProcessorConfigured(
+        processor,
+        result,
+        AHR_Delete(result->request, AHR_ProcessorRequestUrl(result), result->response)
+    );
     AHR_ProcessorUnlockResult(result);
+    return status;
 end:
     AHR_MutexUnlock(processor->mutex);
     return status;
@@ -558,16 +1419,413 @@ end:
 // --------------------------------------------------------------------------------------------------------------------
 //
 
+static size_t AHR_ProcessorArenaBytes(size_t max_objects)
+{
+    const size_t per_object = AHR_RequestArenaBytes()
+        + AHR_ResponsePoolArenaBytes()
+        + AHR_ArenaAlignedSize(AHR_PROCESSOR_MAX_URL_LEN + 1);
+    return AHR_ResultStoreArenaBytes(max_objects) + max_objects * per_object;
+}
+
+static void AHR_ProcessorCountTransfer(AHR_Processor_t processor, const AHR_Result_t *result)
+{
+    AHR_DecodingCounters_t *counters = &processor->decoding;
+    atomic_fetch_add_explicit(&counters->responses, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(
+        &counters->wire_bytes, 
+        AHR_CurlEasyWireBytes(AHR_RequestHandle(result->request)), 
+        memory_order_relaxed
+    );
+    atomic_fetch_add_explicit(
+        &counters->decoded_bytes, 
+        AHR_ResponseDecodedBytes(result->response), 
+        memory_order_relaxed
+    );
+    if(AHR_ResponseIsEncoded(result->response))
+    {
+        atomic_fetch_add_explicit(&counters->encoded_responses, 1, memory_order_relaxed);
+    }
+    if(AHR_ResponseLimitExceeded(result->response))
+    {
+        atomic_fetch_add_explicit(&counters->limit_exceeded, 1, memory_order_relaxed);
+    }
+    AHR_ProcessorCountCompression(processor, result);
+}
+
+static uint64_t AHR_ProcessorNowNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+static void AHR_ProcessorFinishTimings(AHR_Result_t *result, AHR_Curl_t handle)
+{
+    const uint64_t ticks = AHR_TraceNow();
+    result->timings.complete_ns = AHR_ProcessorNowNs();
+    AHR_CurlEasyTimings(handle, &result->timings);
+    if(result->tracer)
+    {
+        AHR_ProcessorTraceTransfer(result, ticks);
+    }
+}
+
+static void AHR_ProcessorTraceTransfer(const AHR_Result_t *result, uint64_t ticks)
+{
+    const AHR_RequestTimings_t *t = &result->timings;
+    const uint32_t object = (uint32_t)result->object;
+    //
+    // curl measures from the Start of the Transfer, which is "total_us" before it completed.
+    //
+    const uint64_t total = AHR_TraceTicksFromUs(result->tracer, t->total_us);
+    const uint64_t start = ticks > total ? ticks - total : 0U;
+    const struct
+    {
+        const char *name;
+        uint64_t begin_us;
+        uint64_t end_us;
+    } phases[] = {
+        {"dns", 0, t->name_lookup_us},
+        {"connect", t->name_lookup_us, t->connect_us},
+        {"tls", t->connect_us, t->app_connect_us},
+        {"wait", t->pretransfer_us, t->first_byte_us},
+        {"receive", t->first_byte_us, t->total_us}
+    };
+    for(size_t i=0;i<sizeof(phases) / sizeof(phases[0]);++i)
+    {
+        if(phases[i].end_us <= phases[i].begin_us)
+        {
+            continue;
+        }
+        AHR_TraceAsyncBegin(
+            result->tracer,
+            phases[i].name,
+            result->trace_id,
+            object,
+            start + AHR_TraceTicksFromUs(result->tracer, phases[i].begin_us)
+        );
+        AHR_TraceAsyncEnd(
+            result->tracer,
+            phases[i].name,
+            result->trace_id,
+            object,
+            start + AHR_TraceTicksFromUs(result->tracer, phases[i].end_us)
+        );
+    }
+    AHR_TraceAsyncEnd(result->tracer, "transfer", result->trace_id, object, ticks);
+}
+
+static void AHR_ProcessorMetricsTransfer(const AHR_Result_t *result, AHR_Curl_t handle, AHR_MetricsTransfer_t *transfer)
+{
+    transfer->url = AHR_CurlEasyEffectiveUrl(handle);
+    transfer->latency_us = (result->timings.complete_ns - result->timings.submit_ns) / 1000U;
+    AHR_CurlEasyTransferInfo(handle, &transfer->bytes_in, &transfer->bytes_out, &transfer->new_connections);
+}
+
+static void AHR_ProcessorRecordTransfer(AHR_Processor_t processor, const AHR_Result_t *result, AHR_Curl_t handle, size_t error_code)
+{
+    if(!processor->recorder)
+    {
+        return;
+    }
+    const AHR_RequestTimings_t *t = &result->timings;
+    const uint64_t start_ns = AHR_RecorderStartNs(processor->recorder);
+    char template[AHR_RECORD_TEMPLATE_LEN]; // flawfinder: ignore
+    const char *url = AHR_CurlEasyEffectiveUrl(handle);
+    AHR_RecordUrlTemplate(url ? url : "/", template, sizeof(template));
+    const char *method = AHR_CurlEasyEffectiveMethod(handle);
+    const long status = AHR_ResponseStatusCode(result->response);
+    AHR_Record_t record = {
+        .submit_us = t->submit_ns > start_ns ? (t->submit_ns - start_ns) / 1000U : 0U,
+        .latency_us = (t->complete_ns - t->submit_ns) / 1000U,
+        .server_us = t->first_byte_us > t->pretransfer_us ? t->first_byte_us - t->pretransfer_us : 0U,
+        .method = !method ? AHR_RECORD_OTHER
+            : 0 == strcmp(method, "GET") ? AHR_RECORD_GET
+            : 0 == strcmp(method, "POST") ? AHR_RECORD_POST
+            : 0 == strcmp(method, "PUT") ? AHR_RECORD_PUT
+            : 0 == strcmp(method, "DELETE") ? AHR_RECORD_DELETE
+            : AHR_RECORD_OTHER,
+        .url_template = template,
+        .nheaders = (uint32_t)AHR_RequestHeaderCount(result->request),
+        .header_bytes = 0,
+        .status = status > 0 && 0 == error_code ? (uint32_t)status : 0U,
+        .error = (uint32_t)error_code,
+        .decoded_bytes = AHR_ResponseDecodedBytes(result->response)
+    };
+    for(uint32_t i=0;i<record.nheaders;++i)
+    {
+        AHR_HeaderView_t header;
+        if(AHR_RequestHeaderAt(result->request, i, &header))
+        {
+            record.header_bytes += header.name_len + header.value_len + 4U;
+        }
+    }
+    AHR_CurlEasyMessageSizes(handle, &record.body_bytes, &record.response_header_bytes, &record.response_bytes);
+    if(!AHR_RecorderAdd(processor->recorder, &record))
+    {
+        AHR_LOG_ERROR(processor->logger, "Unable to write the Recording, Recording stopped.\n");
+    }
+}
+
+static void AHR_ProcessorCountCompression(AHR_Processor_t processor, const AHR_Result_t *result)
+{
+    if(0 == result->body_encoding)
+    {
+        return;
+    }
+    const bool streamed = 0 == result->body_compressed;
+    const uint64_t uncompressed = streamed ? result->compressor.consumed : result->body_uncompressed;
+    const uint64_t compressed = streamed ? result->compressor.produced : result->body_compressed;
+    //
+    // 0 marks a free Slot, the Key of an Endpoint never is.
+    //
+    const uint64_t endpoint = AHR_ResponseEndpoint(result->response);
+    const uint64_t key = 0 != endpoint ? endpoint : 1U;
+    const size_t nslots = AHR_COMPRESSION_MAX_ENDPOINTS - 1U;
+    AHR_CompressionCounters_t *counters = &processor->compression[nslots];
+    for(size_t i=0;i<nslots;++i)
+    {
+        AHR_CompressionCounters_t *slot = &processor->compression[(key + i) % nslots];
+        const uint64_t current = atomic_load_explicit(&slot->key, memory_order_relaxed);
+        if(key == current)
+        {
+            counters = slot;
+            break;
+        }
+        if(0 == current)
+        {
+            //
+            // The Label is the URL of the Transfer without Query and Fragment.
+            //
+            const char *url = AHR_CurlEasyEffectiveUrl(AHR_RequestHandle(result->request));
+            size_t len = 0;
+            while(url && len < sizeof(slot->endpoint) - 1U && '\0' != url[len] && '?' != url[len] && '#' != url[len])
+            {
+                ++len;
+            }
+            if(len > 0)
+            {
+                memcpy(slot->endpoint, url, len); // flawfinder: ignore
+            }
+            slot->endpoint[len] = '\0';
+            atomic_store_explicit(&slot->key, key, memory_order_release);
+            counters = slot;
+            break;
+        }
+    }
+    if(counters == &processor->compression[nslots] && 0 == atomic_load_explicit(&counters->key, memory_order_relaxed))
+    {
+        counters->endpoint[0] = '*';
+        counters->endpoint[1] = '\0';
+        atomic_store_explicit(&counters->key, 1, memory_order_release);
+    }
+    atomic_fetch_add_explicit(&counters->requests, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counters->uncompressed_bytes, uncompressed, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counters->compressed_bytes, compressed, memory_order_relaxed);
+}
+
+static unsigned int AHR_ProcessorBodyEncoding(const AHR_Processor_t processor, const AHR_RequestData_t *request_data)
+{
+    const unsigned int wanted = AHR_CompressionSupported(
+        AHR_ENCODING_DEFAULT != request_data->content_encoding 
+            ? request_data->content_encoding 
+            : processor->content_encoding
+    );
+    //
+    // A Body has exactly one Encoding. If several are given, the one which compresses best wins.
+    //
+    static const unsigned int preference[] = {AHR_ENCODING_ZSTD, AHR_ENCODING_GZIP, AHR_ENCODING_DEFLATE};
+    for(size_t i=0;i<sizeof(preference)/sizeof(preference[0]);++i)
+    {
+        if(wanted & preference[i])
+        {
+            return preference[i];
+        }
+    }
+    return 0;
+}
+
+static void AHR_ProcessorCompressBody(
+    AHR_Processor_t processor, 
+    AHR_Result_t *result, 
+    unsigned int encoding, 
+    AHR_BodyDescriptor_t *body
+)
+{
+    const size_t bound = AHR_CompressBound(encoding, body->nbytes);
+    char *compressed = bound <= AHR_BufferPoolMaxSize() 
+        ? AHR_BufferPoolAcquire(&processor->pool, NULL, bound) 
+        : NULL;
+    if(!compressed)
+    {
+        AHR_ProcessorStreamBody(processor, result, encoding, body->nbytes);
+        return;
+    }
+    const int64_t nbytes = AHR_Compress(
+        &result->compressor,
+        encoding,
+        processor->compression_level,
+        &processor->dictionary,
+        body->data,
+        body->nbytes,
+        compressed,
+        AHR_BufferCapacity(compressed)
+    );
+    if(nbytes < 0 || (uint64_t)nbytes >= body->nbytes)
+    {
+        AHR_BufferPoolRelease(&processor->pool, NULL, compressed);
+        return;
+    }
+    result->body_encoding = encoding;
+    result->body_uncompressed = body->nbytes;
+    result->body_compressed = (uint64_t)nbytes;
+    if(body->release)
+    {
+        body->release(body->user, body->data, body->nbytes);
+    }
+    *body = (AHR_BodyDescriptor_t){
+        .data = compressed,
+        .nbytes = (size_t)nbytes,
+        .release = AHR_ProcessorReleasePooledBody,
+        .user = processor
+    };
+}
+
+static void AHR_ProcessorStreamBody(AHR_Processor_t processor, AHR_Result_t *result, unsigned int encoding, size_t nbytes)
+{
+    //
+    // The Source reads result->body, which is set once the Body was chosen and stays until the Transfer ended.
+    //
+    const AHR_BodyProvider_t source = {
+        .read = AHR_ProcessorBodyRead,
+        .rewind = AHR_ProcessorBodyRewind,
+        .user = result,
+        .content_length = (int64_t)nbytes
+    };
+    result->body_offset = 0;
+    if(
+        !AHR_CompressorBeginStream(
+            &result->compressor, 
+            encoding, 
+            processor->compression_level, 
+            &processor->dictionary, 
+            &source
+        )
+    )
+    {
+        AHR_LOG_WARNING(processor->logger, "Unable to compress the Request Body, it is sent as is.");
+        return;
+    }
+    result->provider = AHR_CompressorProvider(&result->compressor);
+    result->body_encoding = encoding;
+}
+
+static size_t AHR_ProcessorBodyRead(void *user, char *buffer, size_t nbytes)
+{
+    AHR_Result_t *result = user;
+    const size_t left = result->body.nbytes - result->body_offset;
+    const size_t n = nbytes < left ? nbytes : left;
+    memcpy(buffer, result->body.data + result->body_offset, n); // flawfinder: ignore
+    result->body_offset += n;
+    return n;
+}
+
+static bool AHR_ProcessorBodyRewind(void *user)
+{
+    AHR_Result_t *result = user;
+    result->body_offset = 0;
+    return true;
+}
+
+static const char* AHR_ProcessorRequestUrl(const AHR_Result_t *result)
+{
+    return '\0' == result->request_data.url[0] ? NULL : result->request_data.url;
+}
+
+static AHR_ProcessorStatus_t AHR_ProcessorBindBaseUrl(
+    AHR_Processor_t processor, 
+    size_t first, 
+    size_t last, 
+    const char *base_url
+)
+{
+    //
+    // Lock all Objects first, so a busy Object leaves all others unchanged.
+    //
+    size_t locked = first;
+    AHR_ProcessorStatus_t status = AHR_PROC_OK;
+    AHR_CurlUrl_t parsed = NULL;
+    for(;locked<last;++locked)
+    {
+        if(!AHR_ProcessorTryLockResult(AHR_ResultStoreGetResult(&processor->result_store, locked)))
+        {
+            status = AHR_PROC_OBJECT_BUSY;
+            goto end;
+        }
+    }
+    if(base_url)
+    {
+        parsed = AHR_CurlUrlParse(base_url);
+        if(!parsed)
+        {
+            AHR_LOG_WARNING(processor->logger, "Unable to parse the Base URL.");
+            status = AHR_PROC_INVALID_URL;
+            goto end;
+        }
+    }
+    for(size_t i=first;i<last;++i)
+    {
+        if(!AHR_RequestSetBaseUrl(AHR_ResultStoreGetResult(&processor->result_store, i)->request, parsed))
+        {
+            status = AHR_PROC_NOT_ENOUGH_MEMORY;
+        }
+    }
+    if(parsed)
+    {
+        AHR_CurlUrlCleanUp(parsed);
+    }
+end:
+    for(size_t i=first;i<locked;++i)
+    {
+        AHR_ProcessorUnlockResult(AHR_ResultStoreGetResult(&processor->result_store, i));
+    }
+    return status;
+}
+
+static AHR_ProcessorStatus_t AHR_ProcessorConfigured(AHR_Processor_t processor, AHR_Result_t *result, bool configured)
+{
+    if(configured)
+    {
+        return AHR_PROC_OK;
+    }
+    AHR_LOG_WARNING(processor->logger, "Unable to build the Request Headers, not enough Memory.");
+    AHR_ResultReleaseBody(result);
+    return AHR_PROC_NOT_ENOUGH_MEMORY;
+}
+
+static void AHR_ProcessorReleasePooledBody(void *user, const char *data, size_t nbytes)
+{
+    (void)nbytes;
+    AHR_Processor_t processor = (AHR_Processor_t)user;
+    AHR_BufferPoolRelease(&processor->pool, NULL, (char*)(uintptr_t)data);
+}
+
 static void* AHR_ProcessorThreadFunc(void *arg)
 {
     if(!arg) return NULL;
     AHR_Processor_t processor = (AHR_Processor_t)arg;
+    AHR_TraceNameThread(processor->tracer, "ahr io");
     do
     {
         AHR_HandleNewRequests(processor);
+        AHR_TraceBegin(processor->tracer, "AHR_HandleResumedResponses", AHR_TRACE_NO_OBJECT);
+        AHR_HandleResumedResponses(processor);
+        AHR_TraceEnd(processor->tracer, "AHR_HandleResumedResponses", AHR_TRACE_NO_OBJECT);
+        //
+        // AHR_ExecuteAndPoll() already waits for Activity. A second Poll here would swallow the Wake-Up 
+        // of a Request made from within a Callback and delay it by a whole Poll Timeout.
+        //
         AHR_ExecuteAndPoll(processor);
-        
-        AHR_CurlMultiPoll(processor->handle);
     }
     while(0 == atomic_load(&(processor->terminate)));
     return NULL;
@@ -660,6 +1918,12 @@ static AHR_Result_t* AHR_RequestListFind(AHR_RequestList *list, void *handle) //
 
 static void AHR_HandleNewRequests(AHR_Processor_t processor)
 {
+    AHR_TraceBegin(processor->tracer, "AHR_HandleNewRequests", AHR_TRACE_NO_OBJECT);
+    //
+    // Every Object is queued at most once, so no more Requests than Objects can fail here.
+    //
+    AHR_Result_t *failed[AHR_PROCESSOR_MAX_OBJECTS];
+    size_t nfailed = 0;
     if(AHR_MutexTryLock(processor->mutex))
     {
         while(1)
@@ -667,6 +1931,12 @@ static void AHR_HandleNewRequests(AHR_Processor_t processor)
             AHR_Result_t *new = AHR_StackPop(&processor->requests);
             if(new)
             {
+                new->timings.dequeue_ns = AHR_ProcessorNowNs();
+                AHR_MetricsDequeued(processor->metrics);
+                const uint32_t object = (uint32_t)new->object;
+                AHR_TraceAsyncEnd(processor->tracer, "queued", new->trace_id, object, AHR_TraceNow());
+                AHR_PROBE3(request__dequeue, object, new->response, new->timings.dequeue_ns - new->timings.submit_ns);
+                AHR_ResponseReset(new->response);
                 if(
                     AHR_CurlMultiAddHandle(
                         processor->handle,
@@ -674,11 +1944,23 @@ static void AHR_HandleNewRequests(AHR_Processor_t processor)
                     )
                 )
                 {
+                    new->timings.multi_add_ns = AHR_ProcessorNowNs();
+                    AHR_TraceAsyncBegin(processor->tracer, "transfer", new->trace_id, object, AHR_TraceNow());
+                    AHR_PROBE3(request__start, object, new->response, new->request_data.url);
                     AHR_RequestListAdd(&processor->result_list, new);
                 }
                 else
                 {
-                    AHR_LogWarning(processor->logger, "Unable to give previously used Element back.");
+                    AHR_LOG_WARNING(processor->logger, "Unable to give previously used Element back.");
+                    AHR_MetricsFailed(processor->metrics, AHR_FAILURE_OTHER, NULL);
+                    AHR_PROBE4(
+                        request__error, 
+                        object, 
+                        new->response, 
+                        0, 
+                        new->timings.dequeue_ns - new->timings.submit_ns
+                    );
+                    failed[nfailed++] = new;
                 }
             }
             else
@@ -688,6 +1970,65 @@ static void AHR_HandleNewRequests(AHR_Processor_t processor)
         }
         AHR_MutexUnlock(processor->mutex);
     }
+    //
+    // The Callback may submit the next Request, which takes the Mutex. The Object is unlocked before,
+    // everything the Callback gets is copied.
+    //
+    for(size_t i=0;i<nfailed;++i)
+    {
+        AHR_Result_t *result = failed[i];
+        const uint32_t object = (uint32_t)result->object;
+        const AHR_UserData_t user_data = result->user_data;
+        const uint64_t trace_id = result->trace_id;
+        result->timings.callback_ns = AHR_ProcessorNowNs();
+        AHR_ResultReleaseBody(result);
+        AHR_ResponseReleaseBody(result->response);
+        AHR_ProcessorUnlockResult(result);
+        AHR_TraceBegin(processor->tracer, "on_error", object);
+        AHR_PROBE2(callback__entry, object, "on_error");
+        user_data.on_error(user_data.data, object, 0);
+        AHR_PROBE2(callback__return, object, "on_error");
+        AHR_TraceEnd(processor->tracer, "on_error", object);
+        AHR_TraceAsyncEnd(processor->tracer, "request", trace_id, object, AHR_TraceNow());
+    }
+    AHR_TraceEnd(processor->tracer, "AHR_HandleNewRequests", AHR_TRACE_NO_OBJECT);
+}
+
+static void AHR_HandleResumedResponses(AHR_Processor_t processor)
+{
+    //
+    // The Request List is only modified by this Thread, no Lock required.
+    // A Resume which arrives before the Transfer paused stays pending until it did.
+    //
+    struct AHR_RequestListNode *current = processor->result_list.head;
+    while(current)
+    {
+        AHR_Result_t *result = current->result;
+        if(result->paused && atomic_exchange(&result->resume, 0))
+        {
+            result->paused = false;
+            AHR_CurlEasyResume(AHR_RequestHandle(result->request));
+        }
+        current = current->next;
+    }
+}
+
+static AHR_StreamAction_t AHR_ProcessorStreamData(void *user, const char *data, size_t nbytes)
+{
+    AHR_Result_t *result = (AHR_Result_t*)user;
+    assert(NULL != result->user_data.on_data);
+    AHR_TraceBegin(result->tracer, "on_data", (uint32_t)result->object);
+    AHR_PROBE2(callback__entry, result->object, "on_data");
+    const AHR_StreamAction_t action = result->user_data.on_data(
+        result->user_data.data,
+        result->object,
+        data,
+        nbytes
+    );
+    AHR_PROBE2(callback__return, result->object, "on_data");
+    AHR_TraceEnd(result->tracer, "on_data", (uint32_t)result->object);
+    result->paused = (AHR_STREAM_PAUSE == action);
+    return action;
 }
 
 static void AHR_CurlMultiInfoReadErrorCallback(
@@ -707,34 +2048,40 @@ static void AHR_CurlMultiInfoReadErrorCallback(
 
     if(!result)
     {
-        AHR_LogError(processor->logger, "Error expecting to find Result Object, but do not found it.");
+        AHR_LOG_ERROR(processor->logger, "Error expecting to find Result Object, but do not found it.");
         return;
     }
     assert(NULL != result->user_data.on_error);
-    result->user_data.on_error(
-        result->user_data.data,
-        AHR_ResultStoreObjectIndex(&processor->result_store, result),
-        error_code
-    );
-    const bool r = AHR_RequestListRemove(
-        &processor->result_list,
-        AHR_CurlGetHandle(AHR_RequestHandle(result->request))
+    AHR_ProcessorFinishTimings(result, handle);
+    AHR_RequestEndFileSink(result->request);
+    AHR_ProcessorCountTransfer(processor, result);
+    AHR_MetricsTransfer_t transfer;
+    AHR_ProcessorMetricsTransfer(result, handle, &transfer);
+    AHR_MetricsFailed(processor->metrics, AHR_CurlFailureClass(error_code), &transfer);
+    AHR_ProcessorRecordTransfer(processor, result, handle, error_code);
+    AHR_PROBE4(
+        request__error, 
+        result->object, 
+        result->response, 
+        error_code, 
+        result->timings.complete_ns - result->timings.submit_ns
     );
-    
-    AHR_LogInfo(processor->logger, "Remove Handle fom CURLM on Error...");
-    AHR_CurlMultiRemoveHandle(
-        processor->handle,
-        handle
-    );
-    if(r)
-    {
-        //AHR_DestroyResult(&result);
-        AHR_ProcessorUnlockResult(result);
-    }
-    else
-    {
-        AHR_LogError(processor->logger, "Unable to remove Element from Request List.");
-    }
+    result->timings.callback_ns = AHR_ProcessorNowNs();
+    const uint32_t object = (uint32_t)result->object;
+    const AHR_UserData_t user_data = result->user_data;
+    const uint64_t trace_id = result->trace_id;
+    AHR_TraceAsyncBegin(processor->tracer, "callback", trace_id, object, AHR_TraceNow());
+    AHR_LOG_INFO(processor->logger, "Remove Handle fom CURLM on Error %zu...", error_code);
+    AHR_ResponseReleaseBody(result->response);
+    AHR_ProcessorEndTransfer(processor, result, handle);
+    AHR_TraceBegin(processor->tracer, "on_error", object);
+    AHR_PROBE2(callback__entry, object, "on_error");
+    user_data.on_error(user_data.data, object, error_code);
+    AHR_PROBE2(callback__return, object, "on_error");
+    AHR_TraceEnd(processor->tracer, "on_error", object);
+    const uint64_t ticks = AHR_TraceNow();
+    AHR_TraceAsyncEnd(processor->tracer, "callback", trace_id, object, ticks);
+    AHR_TraceAsyncEnd(processor->tracer, "request", trace_id, object, ticks);
 }
 
 static void AHR_CurlMultiInfoReadSuccessCallback(
@@ -752,18 +2099,84 @@ static void AHR_CurlMultiInfoReadSuccessCallback(
     );
     if(!result)
     {
-        AHR_LogError(processor->logger, "Error expecting to find Result Object, but do not found it.");
+        AHR_LOG_ERROR(processor->logger, "Error expecting to find Result Object, but do not found it.");
         return;
     }
     
-    assert(NULL != result->user_data.on_success); 
-    result->user_data.on_success(
-        result->user_data.data,
-        AHR_ResultStoreObjectIndex(&processor->result_store, result),
-        AHR_ResponseStatusCode(result->response),
-        AHR_ResponseBody(result->response),
-        AHR_ResponseBodyLength(result->response)
+    AHR_ProcessorFinishTimings(result, handle);
+    AHR_RequestEndFileSink(result->request);
+    AHR_ProcessorCountTransfer(processor, result);
+    AHR_MetricsTransfer_t transfer;
+    AHR_ProcessorMetricsTransfer(result, handle, &transfer);
+    AHR_MetricsCompleted(processor->metrics, (size_t)AHR_ResponseStatusCode(result->response), &transfer);
+    AHR_ProcessorRecordTransfer(processor, result, handle, 0);
+    AHR_PROBE4(
+        request__done, 
+        result->object, 
+        result->response, 
+        AHR_ResponseStatusCode(result->response), 
+        result->timings.complete_ns - result->timings.submit_ns
     );
+    const uint32_t object = (uint32_t)result->object;
+    const AHR_UserData_t user_data = result->user_data;
+    const uint64_t trace_id = result->trace_id;
+    const long status = AHR_ResponseStatusCode(result->response);
+    if(!user_data.on_data)
+    {
+        //
+        // Stage 1 ran while the Body arrived, only the Tail and Stage 2 are left.
+        // The Size is learned now, a Callback which configures the Object again may change its Endpoint.
+        //
+        AHR_ResponseFinishJsonIndex(result->response);
+        AHR_ResponseLearnBodySize(result->response);
+    }
+    result->timings.callback_ns = AHR_ProcessorNowNs();
+    AHR_TraceAsyncBegin(processor->tracer, "callback", trace_id, object, AHR_TraceNow());
+    AHR_ProcessorEndTransfer(processor, result, handle);
+    if(user_data.on_data)
+    {
+        //
+        // Streamed Response, the Body was already delivered through on_data.
+        //
+        if(user_data.on_complete)
+        {
+            AHR_TraceBegin(processor->tracer, "on_complete", object);
+            AHR_PROBE2(callback__entry, object, "on_complete");
+            user_data.on_complete(user_data.data, object, status);
+            AHR_PROBE2(callback__return, object, "on_complete");
+            AHR_TraceEnd(processor->tracer, "on_complete", object);
+        }
+    }
+    else
+    {
+        assert(NULL != user_data.on_success); 
+        AHR_TraceBegin(processor->tracer, "on_success", object);
+        AHR_PROBE2(callback__entry, object, "on_success");
+        user_data.on_success(
+            user_data.data,
+            object,
+            status,
+            AHR_ResponseBody(result->response),
+            AHR_ResponseBodyLength(result->response)
+        );
+        AHR_PROBE2(callback__return, object, "on_success");
+        AHR_TraceEnd(processor->tracer, "on_success", object);
+    }
+    if(processor->tracer)
+    {
+        const uint64_t ticks = AHR_TraceNow();
+        AHR_TraceAsyncEnd(processor->tracer, "callback", trace_id, object, ticks);
+        AHR_TraceAsyncEnd(processor->tracer, "request", trace_id, object, ticks);
+    }
+    //
+    // on_success has consumed the Body, the Buffer goes back to the Pool for the next Transfer.
+    // Only this Thread dequeues, the next Transfer of the Object can not have started yet.
+    //
+    AHR_ResponseReleaseBody(result->response);
+}
+
+static void AHR_ProcessorEndTransfer(AHR_Processor_t processor, AHR_Result_t *result, AHR_Curl_t handle)
+{
     const bool r = AHR_RequestListRemove(
         &processor->result_list,
         AHR_CurlGetHandle(AHR_RequestHandle(result->request))
@@ -772,14 +2185,14 @@ static void AHR_CurlMultiInfoReadSuccessCallback(
         processor->handle,
         handle
     );
+    AHR_ResultReleaseBody(result);
     if(r)
     {
-        //AHR_DestroyResult(&result);
         AHR_ProcessorUnlockResult(result);
     }
     else
     {
-        AHR_LogError(processor->logger, "Unable to remove Element from Request List.");
+        AHR_LOG_ERROR(processor->logger, "Unable to remove Element from Request List.");
     }
 }
 
@@ -790,28 +2203,34 @@ static void AHR_ExecuteAndPoll(AHR_Processor_t processor)
     int running_handles;
     //do
     //{
+        AHR_TraceBegin(processor->tracer, "curl_multi_perform", AHR_TRACE_NO_OBJECT);
         const bool curl_perform = AHR_CurlMultiPerform(processor->handle, &running_handles);
-        if(curl_perform && running_handles)
-        {
-            //AHR_CurlMultiPoll(processor->handle);
-        }
-        else if(!curl_perform)
+        AHR_TraceEnd(processor->tracer, "curl_multi_perform", AHR_TRACE_NO_OBJECT);
+        if(!curl_perform)
         {
-            AHR_LogError(processor->logger, "Unable to Poll...\n");
+            AHR_LOG_ERROR(processor->logger, "Unable to Poll...\n");
         }
         else
         {
+            //
+            // Read finished Transfers even while others are still running, a paused Stream 
+            // must not delay the Completion of other Objects.
+            //
             AHR_CurlMultiInfoReadData_t data = {
                 .data = processor,
                 .on_success=AHR_CurlMultiInfoReadSuccessCallback,
                 .on_error=AHR_CurlMultiInfoReadErrorCallback
             };
+            AHR_TraceBegin(processor->tracer, "curl_multi_info_read", AHR_TRACE_NO_OBJECT);
             AHR_CurlMultiInfoRead(
                 processor->handle,
                 data
             ); 
+            AHR_TraceEnd(processor->tracer, "curl_multi_info_read", AHR_TRACE_NO_OBJECT);
         }
+        AHR_TraceBegin(processor->tracer, "curl_multi_poll", AHR_TRACE_NO_OBJECT);
         AHR_CurlMultiPoll(processor->handle);
+        AHR_TraceEnd(processor->tracer, "curl_multi_poll", AHR_TRACE_NO_OBJECT);
     //}
     //while(running_handles);
 }
@@ -0,0 +1,181 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/ahr_json.h>
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Longest Number AHR_JsonDouble() converts.
+///
+#define AHR_JSON_MAX_NUMBER_LEN 128U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  The Token, NULL if "token" is out of Range.
+///
+static const AHR_JsonToken_t* AHR_JsonToken(const AHR_JsonIndex_t *index, size_t token);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_JsonType_t AHR_JsonTokenType(const AHR_JsonIndex_t *index, size_t token)
+{
+    const AHR_JsonToken_t *value = AHR_JsonToken(index, token);
+    if(!value)
+    {
+        return AHR_JSON_INVALID;
+    }
+    switch(index->body[value->offset])
+    {
+        case '{':
+            return AHR_JSON_OBJECT;
+        case '[':
+            return AHR_JSON_ARRAY;
+        case '"':
+            return AHR_JSON_STRING;
+        case 't':
+            return AHR_JSON_TRUE;
+        case 'f':
+            return AHR_JSON_FALSE;
+        case 'n':
+            return AHR_JSON_NULL;
+        default:
+            return AHR_JSON_NUMBER;
+    }
+}
+
+size_t AHR_JsonObjectFind(const AHR_JsonIndex_t *index, size_t object, const char *key)
+{
+    assert(NULL != key);
+    if(AHR_JSON_OBJECT != AHR_JsonTokenType(index, object))
+    {
+        return AHR_JSON_NPOS;
+    }
+    const size_t key_len = strlen(key); // flawfinder: ignore
+    const uint32_t members = index->tokens[object].count;
+    size_t member = object + 1U;
+    for(uint32_t i=0;i<members;++i)
+    {
+        const AHR_JsonToken_t *name = &index->tokens[member];
+        if(name->length == key_len + 2U && 0 == memcmp(&index->body[name->offset + 1U], key, key_len))
+        {
+            return member + 1U;
+        }
+        member = index->tokens[member + 1U].next;
+    }
+    return AHR_JSON_NPOS;
+}
+
+size_t AHR_JsonArrayAt(const AHR_JsonIndex_t *index, size_t array, size_t position)
+{
+    if(AHR_JSON_ARRAY != AHR_JsonTokenType(index, array) || position >= index->tokens[array].count)
+    {
+        return AHR_JSON_NPOS;
+    }
+    size_t element = array + 1U;
+    for(size_t i=0;i<position;++i)
+    {
+        element = index->tokens[element].next;
+    }
+    return element;
+}
+
+bool AHR_JsonString(const AHR_JsonIndex_t *index, size_t token, const char **data, size_t *nbytes)
+{
+    assert(NULL != data);
+    assert(NULL != nbytes);
+    if(AHR_JSON_STRING != AHR_JsonTokenType(index, token))
+    {
+        return false;
+    }
+    *data = &index->body[index->tokens[token].offset + 1U];
+    *nbytes = index->tokens[token].length - 2U;
+    return true;
+}
+
+bool AHR_JsonInt64(const AHR_JsonIndex_t *index, size_t token, int64_t *value)
+{
+    assert(NULL != value);
+    if(AHR_JSON_NUMBER != AHR_JsonTokenType(index, token))
+    {
+        return false;
+    }
+    const char *number = &index->body[index->tokens[token].offset];
+    const size_t length = index->tokens[token].length;
+    const bool negative = '-' == number[0];
+    //
+    // Accumulate negative, the Range of int64_t reaches one further below Zero.
+    //
+    int64_t result = 0;
+    for(size_t i=negative ? 1U : 0U;i<length;++i)
+    {
+        if(number[i] < '0' || number[i] > '9')
+        {
+            return false;
+        }
+        const int64_t digit = number[i] - '0';
+        if(result < (INT64_MIN + digit) / 10)
+        {
+            return false;
+        }
+        result = result * 10 - digit;
+    }
+    if(!negative)
+    {
+        if(INT64_MIN == result)
+        {
+            return false;
+        }
+        result = -result;
+    }
+    *value = result;
+    return true;
+}
+
+bool AHR_JsonDouble(const AHR_JsonIndex_t *index, size_t token, double *value)
+{
+    assert(NULL != value);
+    if(AHR_JSON_NUMBER != AHR_JsonTokenType(index, token) || index->tokens[token].length >= AHR_JSON_MAX_NUMBER_LEN)
+    {
+        return false;
+    }
+    //
+    // The Number is not terminated, it may end the Body.
+    //
+    char number[AHR_JSON_MAX_NUMBER_LEN]; // flawfinder: ignore
+    memcpy(number, &index->body[index->tokens[token].offset], index->tokens[token].length); // flawfinder: ignore
+    number[index->tokens[token].length] = '\0';
+    *value = strtod(number, NULL);
+    return true;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static const AHR_JsonToken_t* AHR_JsonToken(const AHR_JsonIndex_t *index, size_t token)
+{
+    assert(NULL != index);
+    if(token >= index->ntokens)
+    {
+        return NULL;
+    }
+    return &index->tokens[token];
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,369 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/ahr_record.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_RECORD_HEADER_BYTES 16U
+///
+/// \brief  Hex Ids shorter than this stay in the Template, f.e. "/v1" or "/cafe".
+///
+#define AHR_RECORD_MIN_HEX_ID 16U
+
+struct AHR_RecordReader
+{
+    FILE *file;
+    uint64_t start_ns;
+    uint64_t submit_us;
+    char **templates;
+    size_t ntemplates;
+    size_t capacity;
+};
+
+///
+/// \brief  Bounded Output of AHR_RecordUrlTemplate().
+///
+typedef struct
+{
+    char *buffer;
+    size_t nbytes;
+    size_t len;
+} AHR_RecordText_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  true if the Path Segment identifies a single Resource: a Number or a long Hex Id.
+///
+static bool AHR_RecordIsId(const char *segment, size_t len);
+static void AHR_RecordAppend(AHR_RecordText_t *text, const char *data, size_t len);
+///
+/// \brief  Read an unsigned LEB128 Integer.
+/// \returns    false at the End of the File or if the Integer is longer than 64 Bits.
+///
+static bool AHR_RecordReadVarint(FILE *file, uint64_t *value);
+static bool AHR_RecordReadTemplate(AHR_RecordReader_t reader);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+size_t AHR_RecordUrlTemplate(const char *url, char *buffer, size_t nbytes)
+{
+    assert(NULL != url);
+    assert(NULL != buffer);
+    assert(nbytes > 0);
+
+    AHR_RecordText_t text = {.buffer = buffer, .nbytes = nbytes, .len = 0};
+    //
+    // Skip Scheme and Authority, the Path starts at the first '/', '?' or '#' behind them.
+    //
+    const char *path = url;
+    const char *scheme = strstr(url, "://");
+    if(scheme)
+    {
+        path = scheme + 3;
+        path += strcspn(path, "/?#");
+    }
+    if('/' != *path)
+    {
+        AHR_RecordAppend(&text, "/", 1U);
+    }
+    const char *current = path;
+    while('\0' != *current && '?' != *current && '#' != *current)
+    {
+        if('/' == *current)
+        {
+            AHR_RecordAppend(&text, "/", 1U);
+            ++current;
+            continue;
+        }
+        const size_t len = strcspn(current, "/?#");
+        if(AHR_RecordIsId(current, len))
+        {
+            AHR_RecordAppend(&text, "{id}", 4U);
+        }
+        else
+        {
+            AHR_RecordAppend(&text, current, len);
+        }
+        current += len;
+    }
+    //
+    // Values of Query Parameters may carry anything, only their Names are kept.
+    //
+    if('?' == *current)
+    {
+        AHR_RecordAppend(&text, "?", 1U);
+        ++current;
+        bool first = true;
+        while('\0' != *current && '#' != *current)
+        {
+            const size_t len = strcspn(current, "&#");
+            const size_t name_len = strcspn(current, "=&#");
+            if(name_len > 0)
+            {
+                if(!first)
+                {
+                    AHR_RecordAppend(&text, "&", 1U);
+                }
+                AHR_RecordAppend(&text, current, name_len);
+                if(name_len < len)
+                {
+                    AHR_RecordAppend(&text, "=", 1U);
+                }
+                first = false;
+            }
+            current += len;
+            if('&' == *current)
+            {
+                ++current;
+            }
+        }
+    }
+    buffer[text.len] = '\0';
+    return text.len;
+}
+
+const char* AHR_RecordMethodName(AHR_RecordMethod_t method)
+{
+    switch(method)
+    {
+        case AHR_RECORD_GET:
+            return "GET";
+        case AHR_RECORD_POST:
+            return "POST";
+        case AHR_RECORD_PUT:
+            return "PUT";
+        case AHR_RECORD_DELETE:
+            return "DELETE";
+        default:
+            return "OTHER";
+    }
+}
+
+AHR_RecordReader_t AHR_RecordReaderOpen(const char *path)
+{
+    assert(NULL != path);
+
+    FILE *file = fopen(path, "rb");
+    if(!file)
+    {
+        return NULL;
+    }
+    unsigned char header[AHR_RECORD_HEADER_BYTES]; // flawfinder: ignore
+    if(
+        sizeof(header) != fread(header, 1, sizeof(header), file)
+        || 0 != memcmp(header, "AHRR", 4)
+        || AHR_RECORD_VERSION != header[4]
+    )
+    {
+        fclose(file);
+        return NULL;
+    }
+    AHR_RecordReader_t reader = malloc(sizeof(struct AHR_RecordReader));
+    if(!reader)
+    {
+        fclose(file);
+        return NULL;
+    }
+    reader->file = file;
+    reader->start_ns = 0;
+    for(size_t i=0;i<8U;++i)
+    {
+        reader->start_ns |= (uint64_t)header[8U + i] << (8U * i);
+    }
+    reader->submit_us = 0;
+    reader->templates = NULL;
+    reader->ntemplates = 0;
+    reader->capacity = 0;
+    return reader;
+}
+
+uint64_t AHR_RecordReaderStartNs(const AHR_RecordReader_t reader)
+{
+    assert(NULL != reader);
+    return reader->start_ns;
+}
+
+AHR_RecordStatus_t AHR_RecordReaderNext(AHR_RecordReader_t reader, AHR_Record_t *record)
+{
+    assert(NULL != reader);
+    assert(NULL != record);
+
+    const int first = getc(reader->file);
+    if(EOF == first)
+    {
+        return AHR_RECORD_END;
+    }
+    ungetc(first, reader->file);
+
+    uint64_t reference = 0;
+    if(!AHR_RecordReadVarint(reader->file, &reference))
+    {
+        return AHR_RECORD_CORRUPT;
+    }
+    if(0 == reference)
+    {
+        if(!AHR_RecordReadTemplate(reader))
+        {
+            return AHR_RECORD_CORRUPT;
+        }
+        reference = reader->ntemplates;
+    }
+    if(reference > reader->ntemplates)
+    {
+        return AHR_RECORD_CORRUPT;
+    }
+    record->url_template = reader->templates[reference - 1U];
+    const int method = getc(reader->file);
+    if(EOF == method || method > (int)AHR_RECORD_OTHER)
+    {
+        return AHR_RECORD_CORRUPT;
+    }
+    record->method = (AHR_RecordMethod_t)method;
+
+    uint64_t fields[11];
+    for(size_t i=0;i<sizeof(fields) / sizeof(fields[0]);++i)
+    {
+        if(!AHR_RecordReadVarint(reader->file, &fields[i]))
+        {
+            return AHR_RECORD_CORRUPT;
+        }
+    }
+    //
+    // ZigZag: even Values are Steps forward, odd Values Steps back.
+    //
+    const uint64_t delta = fields[0] >> 1U;
+    reader->submit_us = 0U == (fields[0] & 1U) ? reader->submit_us + delta : reader->submit_us - delta - 1U;
+    record->submit_us = reader->submit_us;
+    record->latency_us = fields[1];
+    record->server_us = fields[2];
+    record->nheaders = (uint32_t)fields[3];
+    record->header_bytes = fields[4];
+    record->body_bytes = fields[5];
+    record->status = (uint32_t)fields[6];
+    record->error = (uint32_t)fields[7];
+    record->response_header_bytes = fields[8];
+    record->response_bytes = fields[9];
+    record->decoded_bytes = fields[10];
+    return AHR_RECORD_OK;
+}
+
+void AHR_RecordReaderClose(AHR_RecordReader_t *reader)
+{
+    if(!reader || !*reader)
+    {
+        return;
+    }
+    for(size_t i=0;i<(*reader)->ntemplates;++i)
+    {
+        free((*reader)->templates[i]);
+    }
+    free((*reader)->templates);
+    fclose((*reader)->file);
+    free(*reader);
+    *reader = NULL;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_RecordIsId(const char *segment, size_t len)
+{
+    if(0 == len)
+    {
+        return false;
+    }
+    bool digits = true;
+    bool hex = true;
+    bool any_digit = false;
+    for(size_t i=0;i<len;++i)
+    {
+        const char c = segment[i];
+        const bool digit = c >= '0' && c <= '9';
+        any_digit = any_digit || digit;
+        digits = digits && digit;
+        hex = hex && (digit || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F') || '-' == c);
+    }
+    return digits || (hex && any_digit && len >= AHR_RECORD_MIN_HEX_ID);
+}
+
+static void AHR_RecordAppend(AHR_RecordText_t *text, const char *data, size_t len)
+{
+    const size_t space = text->nbytes - 1U - text->len;
+    const size_t n = len < space ? len : space;
+    if(n > 0)
+    {
+        memcpy(&text->buffer[text->len], data, n); // flawfinder: ignore
+        text->len += n;
+    }
+}
+
+static bool AHR_RecordReadVarint(FILE *file, uint64_t *value)
+{
+    *value = 0;
+    for(unsigned int shift=0;shift<64U;shift+=7U)
+    {
+        const int byte = getc(file);
+        if(EOF == byte)
+        {
+            return false;
+        }
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+        if(0 == (byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool AHR_RecordReadTemplate(AHR_RecordReader_t reader)
+{
+    uint64_t len = 0;
+    if(!AHR_RecordReadVarint(reader->file, &len) || len >= AHR_RECORD_TEMPLATE_LEN)
+    {
+        return false;
+    }
+    if(reader->ntemplates == reader->capacity)
+    {
+        const size_t capacity = 0 == reader->capacity ? 64U : 2U * reader->capacity;
+        char **grown = realloc(reader->templates, capacity * sizeof(char*));
+        if(!grown)
+        {
+            return false;
+        }
+        reader->templates = grown;
+        reader->capacity = capacity;
+    }
+    char *template = malloc((size_t)len + 1U);
+    if(!template)
+    {
+        return false;
+    }
+    if((size_t)len != fread(template, 1, (size_t)len, reader->file))
+    {
+        free(template);
+        return false;
+    }
+    template[len] = '\0';
+    reader->templates[reader->ntemplates++] = template;
+    return true;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,95 @@
+///
+/// \brief  This Module implements a Bump Arena on top of one anonymous Mapping.
+///         All fixed size Storage of a Processor is carved out of one Arena at Initialization,
+///         so it is contiguous in Memory and released with one Call.
+///         The Arena never frees single Allocations.
+///
+/// \example    AHR_Arena_t arena = AHR_CreateArena(4096 * 16, AHR_ARENA_TRANSPARENT_HUGE_PAGES);
+///             if(AHR_ArenaIsValid(&arena))
+///             {
+///                 char *buffer = AHR_ArenaAlloc(&arena, 4096);
+///                 ...
+///             }
+///             AHR_DestroyArena(&arena);
+///
+#ifndef __AHR_ARENA_H__
+#define __AHR_ARENA_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Alignment of each Allocation, one Cache Line.
+///
+#define AHR_ARENA_ALIGNMENT ((size_t)64)
+
+typedef enum
+{
+    ///
+    /// \brief  Back the Arena with explicit Huge Pages (MAP_HUGETLB).
+    ///         Falls back to regular Pages if no Huge Pages are reserved.
+    ///
+    AHR_ARENA_HUGE_PAGES = 1 << 0,
+    ///
+    /// \brief  Ask for transparent Huge Pages with madvise(MADV_HUGEPAGE).
+    ///
+    AHR_ARENA_TRANSPARENT_HUGE_PAGES = 1 << 1,
+    ///
+    /// \brief  Fault in all Pages at Creation (MAP_POPULATE), so the RSS does not grow afterwards.
+    ///
+    AHR_ARENA_PREFAULT = 1 << 2
+} AHR_ArenaFlags_t;
+
+typedef struct
+{
+    char *base;
+    size_t capacity;
+    size_t used;
+    ///
+    /// \brief  Flags which actually took Effect.
+    ///
+    unsigned int flags;
+} AHR_Arena_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \brief  Map an Arena of at least "capacity" Bytes.
+///         Use AHR_ArenaIsValid() to check if the Mapping succeeded.
+///
+AHR_Arena_t AHR_CreateArena(size_t capacity, unsigned int flags);
+///
+/// \brief  Unmap the Arena, all Allocations become invalid.
+///
+void AHR_DestroyArena(AHR_Arena_t *arena);
+bool AHR_ArenaIsValid(const AHR_Arena_t *arena);
+///
+/// \brief  Allocate "nbytes" Bytes aligned to AHR_ARENA_ALIGNMENT. The Memory is zeroed.
+/// \returns    NULL if the Arena is exhausted.
+///
+void* AHR_ArenaAlloc(AHR_Arena_t *arena, size_t nbytes);
+///
+/// \brief  Number of Bytes AHR_ArenaAlloc() consumes for "nbytes", use it to size an Arena.
+///
+size_t AHR_ArenaAlignedSize(size_t nbytes);
+size_t AHR_ArenaCapacity(const AHR_Arena_t *arena);
+size_t AHR_ArenaUsed(const AHR_Arena_t *arena);
+///
+/// \brief  Flags which actually took Effect, f.e. AHR_ARENA_HUGE_PAGES is missing after a Fallback.
+///
+unsigned int AHR_ArenaFlags(const AHR_Arena_t *arena);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
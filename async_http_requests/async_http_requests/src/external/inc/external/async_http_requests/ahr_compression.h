@@ -0,0 +1,151 @@
+///
+/// \brief  Compression of Request Bodies with zlib (gzip, deflate) and zstd.
+///         A Body in Memory is compressed at once into a Buffer of the Caller. A Body from a Provider is
+///         compressed while curl pulls it, the Compressor then is a Provider itself and fills curls Upload
+///         Buffer straight from the Source, only one Input Block is buffered in between.
+///         zstd is only available if libahr was built with it (AHR_WITH_ZSTD).
+///
+/// \example    AHR_Compressor_t compressor = AHR_CreateCompressor();
+///             const int64_t n = AHR_Compress(&compressor, AHR_ENCODING_GZIP, 0, NULL, body, nbytes, out, capacity);
+///             ...
+///             AHR_DestroyCompressor(&compressor);
+///
+#ifndef __AHR_COMPRESSION_H__
+#define __AHR_COMPRESSION_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/ahr_types.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  A zstd Dictionary, digested once for a fixed Compression Level and shared by all Compressors.
+///
+typedef struct
+{
+    ///
+    /// \brief  The digested Dictionary (ZSTD_CDict), NULL if none is loaded.
+    ///
+    void *cdict;
+    ///
+    /// \brief  Dictionary Id, the Receiver needs the Dictionary with this Id to decode the Body.
+    ///
+    unsigned int id;
+} AHR_CompressionDictionary_t;
+
+typedef struct
+{
+    ///
+    /// \brief  Contexts, created on first Use and kept for the next Body.
+    ///
+    void *zlib;
+    void *zstd;
+    ///
+    /// \brief  Encoding and Level "zlib" was initialized for.
+    ///
+    unsigned int zlib_encoding;
+    int zlib_level;
+
+    ///
+    /// \brief  State of a streamed Body, see AHR_CompressorBeginStream().
+    ///
+    unsigned int encoding;
+    int level;
+    const AHR_CompressionDictionary_t *dictionary;
+    AHR_BodyProvider_t source;
+    char *input;
+    size_t input_pos;
+    size_t input_len;
+    bool source_done;
+    bool finished;
+    ///
+    /// \brief  Bytes taken from the Source / handed out compressed since the Stream began.
+    ///
+    uint64_t consumed;
+    uint64_t produced;
+} AHR_Compressor_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Subset of "encodings" (AHR_ContentEncoding_t) Request Bodies can be compressed with.
+///
+unsigned int AHR_CompressionSupported(unsigned int encodings);
+///
+/// \brief  Value of the Content-Encoding Header for "encoding", NULL if it is not a single known Encoding.
+///
+const char* AHR_CompressionToken(unsigned int encoding);
+
+///
+/// \brief  Digest "nbytes" Bytes of a zstd Dictionary for "level" (0 for the Default Level).
+///         The Bytes are copied. Without zstd Support the Dictionary is never valid.
+///
+AHR_CompressionDictionary_t AHR_CreateCompressionDictionary(const void *data, size_t nbytes, int level);
+bool AHR_CompressionDictionaryIsValid(const AHR_CompressionDictionary_t *dictionary);
+void AHR_DestroyCompressionDictionary(AHR_CompressionDictionary_t *dictionary);
+///
+/// \brief  Train a zstd Dictionary from "nsamples" Samples into "dictionary".
+/// \returns    Size of the Dictionary, 0 if training failed or zstd is not available.
+///
+size_t AHR_CompressionTrainDictionary(
+    const char *const *samples,
+    const size_t *sizes,
+    size_t nsamples,
+    void *dictionary,
+    size_t capacity
+);
+
+AHR_Compressor_t AHR_CreateCompressor(void);
+void AHR_DestroyCompressor(AHR_Compressor_t *compressor);
+///
+/// \brief  Largest compressed Size of "nbytes" Bytes.
+///
+size_t AHR_CompressBound(unsigned int encoding, size_t nbytes);
+///
+/// \brief  Compress "nbytes" Bytes of "data" into "out".
+///         "dictionary" is only used by zstd, its Level takes Precedence over "level".
+/// \returns    Compressed Size, -1 if the Body does not fit into "capacity" Bytes or can not be compressed.
+///
+int64_t AHR_Compress(
+    AHR_Compressor_t *compressor,
+    unsigned int encoding,
+    int level,
+    const AHR_CompressionDictionary_t *dictionary,
+    const char *data,
+    size_t nbytes,
+    char *out,
+    size_t capacity
+);
+///
+/// \brief  Start compressing the Body of "source" while it is read through AHR_CompressorProvider().
+///         "source" is copied, its User Data has to stay valid until the Stream ended.
+/// \returns    false if the Encoding is not supported or out of Memory.
+///
+bool AHR_CompressorBeginStream(
+    AHR_Compressor_t *compressor,
+    unsigned int encoding,
+    int level,
+    const AHR_CompressionDictionary_t *dictionary,
+    const AHR_BodyProvider_t *source
+);
+///
+/// \brief  Provider which hands out the compressed Body of the current Stream. The compressed Size is
+///         not known in Advance, so the Body is sent chunked. It can be rewound if the Source can.
+///
+AHR_BodyProvider_t AHR_CompressorProvider(AHR_Compressor_t *compressor);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
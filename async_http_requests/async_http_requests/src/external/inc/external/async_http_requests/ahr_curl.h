@@ -6,7 +6,10 @@
 //
 
 #include <async_http_requests/private/ahr_async_http_requests.h>
+#include <async_http_requests/private/ahr_header_block.h>
+#include <external/async_http_requests/ahr_header_list.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 //
 // --------------------------------------------------------------------------------------------------------------------
@@ -17,6 +20,10 @@ typedef size_t (*AHR_HeaderCallback_t)(char *buffer, size_t size, size_t nitems,
 
 struct AHR_CurlM;
 typedef struct AHR_CurlM* AHR_CurlM_t;
+///
+/// \brief  AHR_CurlUrl_t is a parsed URL (curls URL API), declared with the Request Module. 
+///         Scheme, Host and Port are parsed once, only Path and Query change per Request.
+///
 
 //
 // --------------------------------------------------------------------------------------------------------------------
@@ -30,11 +37,105 @@ AHR_Curl_t AHR_CurlEasyInit(
 );
 void AHR_CurlEasyCleanUp(AHR_Curl_t handle);
 
-void AHR_CurlSetHeader(AHR_Curl_t handle, const AHR_Header_t *header);
+///
+/// \brief  Share Header Lists with all Handles using "cache". Call this before the Handle is configured.
+///         Without a Cache each Handle builds its own List whenever its Headers change.
+///
+void AHR_CurlSetHeaderListCache(AHR_Curl_t handle, AHR_HeaderListCache_t *cache);
+///
+/// \brief  Send "header" in Front of the Headers of the Http Method. The Block is referenced, not copied,
+///         and takes Effect with the next AHR_CurlSetHttpMethod*() Call. NULL keeps the current Block.
+///
+void AHR_CurlSetHeader(AHR_Curl_t handle, const AHR_HeaderBlock_t *header);
 void AHR_CurlEasySetUrl(AHR_Curl_t handle, const char *url);
+///
+/// \brief  Use a parsed URL for the next Transfer, it takes Precedence over AHR_CurlEasySetUrl().
+///         "url" is referenced and must stay valid until the Transfer ended. NULL goes back to the plain URL.
+///
+void AHR_CurlEasySetCurlUrl(AHR_Curl_t handle, AHR_CurlUrl_t url);
+
+///
+/// \brief  Parse an absolute URL.
+/// \returns    NULL if the URL is invalid.
+///
+AHR_CurlUrl_t AHR_CurlUrlParse(const char *url);
+AHR_CurlUrl_t AHR_CurlUrlDup(AHR_CurlUrl_t url);
+void AHR_CurlUrlCleanUp(AHR_CurlUrl_t url);
+///
+/// \brief  Replace Path and Query, "query" may be NULL to remove it. The Fragment is removed.
+///
+bool AHR_CurlUrlSetPath(AHR_CurlUrl_t url, const char *path, const char *query);
+///
+/// \brief  Copy the Path of "url" into "buffer".
+/// \returns    Length of the Path, or -1 if it does not fit into "nbytes" Bytes including the Terminator.
+///
+int64_t AHR_CurlUrlGetPath(AHR_CurlUrl_t url, char *buffer, size_t nbytes);
+///
+/// \brief  Copy the URL without Path, Query and Fragment ("scheme://host:port") into "buffer".
+/// \returns    Length of the Origin, or -1 if it does not fit into "nbytes" Bytes including the Terminator.
+///
+int64_t AHR_CurlUrlGetOrigin(AHR_CurlUrl_t url, char *buffer, size_t nbytes);
 
 bool AHR_CurlEasyPerform(AHR_Curl_t handle);
 long AHR_CurlEasyStatusCode(AHR_Curl_t handle);
+///
+/// \brief  Content-Length of the current Response, -1 if it is not known (yet).
+///
+int64_t AHR_CurlEasyContentLength(AHR_Curl_t handle);
+///
+/// \brief  Body Bytes received from the Network for the current Transfer, before they are decoded.
+///
+uint64_t AHR_CurlEasyWireBytes(AHR_Curl_t handle);
+///
+/// \brief  URL of the last Transfer, NULL if there was none. Valid until the next Transfer.
+///
+const char* AHR_CurlEasyEffectiveUrl(AHR_Curl_t handle);
+///
+/// \brief  Fill the "*_us" Phase Times of "timings" from the last Transfer.
+///
+void AHR_CurlEasyTimings(AHR_Curl_t handle, AHR_RequestTimings_t *timings);
+///
+/// \brief  Header and Body Bytes of the last Transfer, and the Number of Connections it opened (0 if it reused one).
+///
+void AHR_CurlEasyTransferInfo(AHR_Curl_t handle, uint64_t *bytes_in, uint64_t *bytes_out, uint64_t *new_connections);
+///
+/// \brief  Request Body Bytes sent, Response Header and Body Bytes received by the last Transfer.
+///
+void AHR_CurlEasyMessageSizes(AHR_Curl_t handle, uint64_t *request_body, uint64_t *response_header, uint64_t *response_body);
+///
+/// \brief  HTTP Method of the last Transfer ("GET", ...), NULL if there was none or curl is older than 7.72.
+///
+const char* AHR_CurlEasyEffectiveMethod(AHR_Curl_t handle);
+///
+/// \brief  Classify a CURLcode passed to the on_error Callback.
+///
+AHR_FailureClass_t AHR_CurlFailureClass(size_t error_code);
+///
+/// \brief  Offer the Content Encodings in "encodings" (AHR_ContentEncoding_t) through Accept-Encoding,
+///         curl decodes the Body before it reaches the Write Callback. Encodings the linked curl can not 
+///         decode are left out, without any the Body is neither offered compressed nor decoded.
+///
+void AHR_CurlSetAcceptEncoding(AHR_Curl_t handle, unsigned int encodings);
+///
+/// \brief  Announce the Request Body as compressed with "encoding" (a single AHR_ContentEncoding_t), 
+///         0 sends it without Content-Encoding. Takes Effect with the next AHR_CurlSetHttpMethodPost/Put*() Call.
+///
+void AHR_CurlSetContentEncoding(AHR_Curl_t handle, unsigned int encoding);
+///
+/// \brief  Pass curls verbose Output (Info Text and Headers) to "logger" at Info Level, NULL turns it off.
+///         Handles are quiet after AHR_CurlEasyInit().
+///
+void AHR_CurlSetVerbose(AHR_Curl_t handle, AHR_Logger_t logger);
+///
+/// \brief  Abort the next Transfer after "timeout_ms" Milliseconds, 0 for no Limit. "stall_seconds" > 0 also
+///         aborts it once it moved less than 1 Byte per Second for that long. curl skips the Stall Check
+///         while the Transfer is paused.
+///
+void AHR_CurlSetTimeout(AHR_Curl_t handle, size_t timeout_ms, size_t stall_seconds);
+///
+/// \brief  Subset of "encodings" the linked curl can decode.
+///
+unsigned int AHR_CurlSupportedEncodings(unsigned int encodings);
 
 void AHR_CurlSetCallbackUserData(
     AHR_Curl_t handle, 
@@ -42,13 +143,41 @@ void AHR_CurlSetCallbackUserData(
     void *header_callback_user_data
 );
 
-void AHR_CurlSetHttpMethodGet(AHR_Curl_t handle);
-void AHR_CurlSetHttpMethodPost(AHR_Curl_t handle, const char *body);
-void AHR_CurlSetHttpMethodPut(AHR_Curl_t handle, const char *body);
-void AHR_CurlSetHttpMethodDelete(AHR_Curl_t handle);
+///
+/// \brief  AHR_CurlSetHttpMethod*() configure the next Request of the Handle together with its Headers.
+/// \returns    false if no Memory is left for the Header List, the Handle is not usable for a Request then.
+///
+bool AHR_CurlSetHttpMethodGet(AHR_Curl_t handle);
+///
+/// \brief  Configure a POST Request. "body" is borrowed and must stay valid until the Transfer ended.
+///
+bool AHR_CurlSetHttpMethodPost(AHR_Curl_t handle, const char *body, size_t nbytes);
+///
+/// \brief  Configure a PUT Request. "body" is borrowed and must stay valid until the Transfer ended.
+///
+bool AHR_CurlSetHttpMethodPut(AHR_Curl_t handle, const char *body, size_t nbytes);
+///
+/// \brief  Configure a POST Request whose Body is pulled from "provider" while it is sent.
+///         A negative Content-Length selects chunked Transfer-Encoding.
+///
+bool AHR_CurlSetHttpMethodPostProvider(AHR_Curl_t handle, const AHR_BodyProvider_t *provider);
+///
+/// \brief  Configure a PUT Request whose Body is pulled from "provider" while it is sent.
+///         A negative Content-Length selects chunked Transfer-Encoding.
+///
+bool AHR_CurlSetHttpMethodPutProvider(AHR_Curl_t handle, const AHR_BodyProvider_t *provider);
+bool AHR_CurlSetHttpMethodDelete(AHR_Curl_t handle);
 
 int AHR_CurlWriteError(void);
 int AHR_CurlReadError(void);
+///
+/// \brief  Return Value for a Write Callback which pauses the Transfer.
+///
+size_t AHR_CurlWritePause(void);
+///
+/// \brief  Continue a paused Transfer. Call this only from the Thread which drives the Multi Handle.
+///
+void AHR_CurlEasyResume(AHR_Curl_t handle);
 
 //
 // --------------------------------------------------------------------------------------------------------------------
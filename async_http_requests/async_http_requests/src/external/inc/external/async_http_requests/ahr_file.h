@@ -0,0 +1,116 @@
+///
+/// \brief  File Access for Request and Response Bodies.
+///         The Writer puts a Response Body straight into a File Descriptor. Each Chunk goes from curls 
+///         Receive Buffer to the Kernel with pwrite(), there is no intermediate Buffer in between.
+///         The Reader provides a Request Body from a File, either memory mapped or read piecewise
+///         with pread() into curls Upload Buffer. The File is never loaded into the Heap.
+///
+#ifndef __AHR_FILE_H__
+#define __AHR_FILE_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/ahr_types.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+typedef struct
+{
+    int64_t offset;
+    unsigned int flags;
+    ///
+    /// \brief  Bytes written since the last Call to AHR_FileWriterBegin().
+    ///
+    uint64_t written;
+    ///
+    /// \brief  Bytes for which Writeback was started / which were dropped from the Page Cache.
+    ///
+    uint64_t synced;
+    uint64_t dropped;
+    bool started;
+} AHR_FileWriter_t;
+
+typedef struct
+{
+    int fd;
+    ///
+    /// \brief  true if the Reader opened "fd" itself and has to close it.
+    ///
+    bool owns_fd;
+    int64_t offset;
+    int64_t length;
+    int64_t position;
+    ///
+    /// \brief  Mapping of the Body Range if AHR_FILE_SOURCE_MMAP was requested, NULL otherwise.
+    ///
+    void *mapping;
+    size_t mapping_len;
+    size_t mapping_delta;
+} AHR_FileReader_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_FileWriter_t AHR_CreateFileWriter(void);
+///
+/// \brief  Prepare the Writer for a new Download into "sink".
+///
+void AHR_FileWriterReset(AHR_FileWriter_t *writer, const AHR_FileSink_t *sink);
+///
+/// \brief  Write one Chunk at the current Position. Applies the Hints of the Sink before the first Chunk.
+/// \param[in] content_length - Expected Size of the whole Body, negative if unknown.
+/// \returns    false if the Chunk could not be written completely.
+///
+bool AHR_FileWriterWrite(
+    AHR_FileWriter_t *writer,
+    int fd,
+    const char *data,
+    size_t nbytes,
+    int64_t content_length
+);
+///
+/// \brief  Finish the Download, drops the remaining Pages from the Page Cache if requested.
+///         The File Descriptor stays open, it is owned by the Caller.
+///
+void AHR_FileWriterEnd(AHR_FileWriter_t *writer, int fd);
+
+AHR_FileReader_t AHR_CreateFileReader(void);
+///
+/// \brief  Open the Range of "source" for reading. A Reader which is still open is closed first.
+/// \returns    false if the File can not be opened, or the Range does not lie within the File.
+///
+bool AHR_FileReaderOpen(AHR_FileReader_t *reader, const AHR_FileSource_t *source);
+///
+/// \brief  Close the Reader, the File Descriptor is only closed if the Reader opened it.
+///
+void AHR_FileReaderClose(AHR_FileReader_t *reader);
+///
+/// \brief  Length of the opened Range in Bytes.
+///
+int64_t AHR_FileReaderLength(const AHR_FileReader_t *reader);
+///
+/// \brief  The mapped Range, NULL if the Reader is not memory mapped.
+///
+const char* AHR_FileReaderData(const AHR_FileReader_t *reader);
+///
+/// \brief  AHR_BodyProviderRead_t which reads the next Bytes of the Range with pread().
+///
+size_t AHR_FileReaderRead(void *reader, char *buffer, size_t nbytes);
+///
+/// \brief  AHR_BodyProviderRewind_t, start the Range from the Beginning again.
+///
+bool AHR_FileReaderRewind(void *reader);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
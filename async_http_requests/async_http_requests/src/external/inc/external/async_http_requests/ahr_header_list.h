@@ -0,0 +1,88 @@
+///
+/// \brief  Interned curl Header Lists.
+///         A Header List is built once for each distinct Set of Header Lines and shared by all Handles
+///         which send that Set. Lists are reference counted, a Handle which is reconfigured with the
+///         same Headers finds its List in the Cache and allocates nothing.
+///
+///         A Key is the Sequence of all Header Lines ("Name: Value"), each terminated by '\0'.
+///
+/// \example    AHR_HeaderListCache_t cache = AHR_CreateHeaderListCache();
+///             static const char key[] = "Accept: application/json\0X-Id: 1\0";
+///             AHR_HeaderList_t *list = AHR_HeaderListAcquire(&cache, key, sizeof(key) - 1);
+///             curl_easy_setopt(handle, CURLOPT_HTTPHEADER, AHR_HeaderListCurl(list));
+///             ...
+///             AHR_HeaderListRelease(&cache, list);
+///             AHR_DestroyHeaderListCache(&cache);
+///
+#ifndef __AHR_HEADER_LIST_H__
+#define __AHR_HEADER_LIST_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <external/async_http_requests/ahr_mutex.h>
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_HEADER_LIST_BUCKETS ((size_t)64)
+
+struct AHR_HeaderList;
+typedef struct AHR_HeaderList AHR_HeaderList_t;
+
+typedef struct
+{
+    AHR_Mutex_t mutex;
+    AHR_HeaderList_t *buckets[AHR_HEADER_LIST_BUCKETS];
+    ///
+    /// \brief  Number of Lists in the Cache / of Lists no Handle refers to.
+    ///
+    size_t nlists;
+    size_t nidle;
+    ///
+    /// \brief  Acquisitions served from the Cache / which had to build a new List.
+    ///
+    uint64_t hits;
+    uint64_t misses;
+} AHR_HeaderListCache_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_HeaderListCache_t AHR_CreateHeaderListCache(void);
+///
+/// \brief  Free all Lists. No Handle may refer to one of them anymore.
+///
+void AHR_DestroyHeaderListCache(AHR_HeaderListCache_t *cache);
+bool AHR_HeaderListCacheIsValid(const AHR_HeaderListCache_t *cache);
+///
+/// \brief  Get a Reference to the List for "key".
+/// \param[in] cache - NULL builds a List which is not shared, it is freed on Release.
+/// \returns    NULL if no Memory is left.
+///
+AHR_HeaderList_t* AHR_HeaderListAcquire(AHR_HeaderListCache_t *cache, const char *key, size_t nbytes);
+///
+/// \brief  Drop a Reference. An unreferenced List is kept for Reuse until too many are idle.
+///
+void AHR_HeaderListRelease(AHR_HeaderListCache_t *cache, AHR_HeaderList_t *list);
+///
+/// \brief  true if "list" was built for "key".
+///
+bool AHR_HeaderListMatches(const AHR_HeaderList_t *list, const char *key, size_t nbytes);
+///
+/// \brief  The struct curl_slist* to pass as CURLOPT_HTTPHEADER.
+///
+void* AHR_HeaderListCurl(const AHR_HeaderList_t *list);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
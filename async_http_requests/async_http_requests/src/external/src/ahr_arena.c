@@ -0,0 +1,201 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define _GNU_SOURCE
+
+#include <external/async_http_requests/ahr_arena.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_ARENA_PAGE_SIZE ((size_t)4096)
+#define AHR_ARENA_HUGE_PAGE_SIZE ((size_t)(2 * 1024 * 1024))
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static size_t AHR_ArenaRoundUp(size_t nbytes, size_t granularity);
+///
+/// \brief  Map "capacity" Bytes starting at a Multiple of "alignment".
+///
+static void* AHR_ArenaMap(size_t capacity, int extra_flags, size_t alignment);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_Arena_t AHR_CreateArena(size_t capacity, unsigned int flags)
+{
+    AHR_Arena_t arena = {
+        .base = NULL,
+        .capacity = 0,
+        .used = 0,
+        .flags = 0
+    };
+    const int populate = (flags & AHR_ARENA_PREFAULT) ? MAP_POPULATE : 0;
+    void *base = NULL;
+#if defined(MAP_HUGETLB)
+    if(flags & AHR_ARENA_HUGE_PAGES)
+    {
+        //
+        // MAP_HUGETLB fails if the Pool of reserved Huge Pages is too small.
+        //
+        arena.capacity = AHR_ArenaRoundUp(capacity, AHR_ARENA_HUGE_PAGE_SIZE);
+        base = AHR_ArenaMap(arena.capacity, MAP_HUGETLB | populate, AHR_ARENA_PAGE_SIZE);
+        if(base)
+        {
+            arena.flags |= AHR_ARENA_HUGE_PAGES;
+        }
+    }
+#endif
+    if(!base)
+    {
+        //
+        // Transparent Huge Pages need an aligned Range of 2 MB, round the Size up to make them possible.
+        //
+        const size_t granularity = (flags & AHR_ARENA_TRANSPARENT_HUGE_PAGES) 
+            ? AHR_ARENA_HUGE_PAGE_SIZE 
+            : AHR_ARENA_PAGE_SIZE;
+        arena.capacity = AHR_ArenaRoundUp(capacity, granularity);
+        base = AHR_ArenaMap(arena.capacity, 0, granularity);
+#if defined(MADV_HUGEPAGE)
+        if(base && (flags & AHR_ARENA_TRANSPARENT_HUGE_PAGES) && 0 == madvise(base, arena.capacity, MADV_HUGEPAGE))
+        {
+            arena.flags |= AHR_ARENA_TRANSPARENT_HUGE_PAGES;
+        }
+#endif
+        //
+        // Populate after madvise(), so the Range is faulted in with Huge Pages if possible.
+        //
+        if(base && populate)
+        {
+            for(size_t i=0;i<arena.capacity;i+=AHR_ARENA_PAGE_SIZE)
+            {
+                ((volatile char*)base)[i] = 0;
+            }
+        }
+    }
+    if(!base)
+    {
+        arena.capacity = 0;
+        arena.flags = 0;
+        return arena;
+    }
+    if(populate)
+    {
+        arena.flags |= AHR_ARENA_PREFAULT;
+    }
+    arena.base = base;
+    return arena;
+}
+
+void AHR_DestroyArena(AHR_Arena_t *arena)
+{
+    assert(NULL != arena);
+    if(arena->base)
+    {
+        munmap(arena->base, arena->capacity);
+    }
+    arena->base = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+    arena->flags = 0;
+}
+
+bool AHR_ArenaIsValid(const AHR_Arena_t *arena)
+{
+    return NULL != arena->base;
+}
+
+void* AHR_ArenaAlloc(AHR_Arena_t *arena, size_t nbytes)
+{
+    assert(NULL != arena);
+    const size_t aligned = AHR_ArenaAlignedSize(nbytes);
+    if(!arena->base || aligned > (arena->capacity - arena->used))
+    {
+        return NULL;
+    }
+    //
+    // Anonymous Mappings are zero filled, the Memory does not need to be cleared.
+    //
+    void *memory = arena->base + arena->used;
+    arena->used += aligned;
+    return memory;
+}
+
+size_t AHR_ArenaAlignedSize(size_t nbytes)
+{
+    return AHR_ArenaRoundUp(nbytes ? nbytes : 1U, AHR_ARENA_ALIGNMENT);
+}
+
+size_t AHR_ArenaCapacity(const AHR_Arena_t *arena)
+{
+    return arena->capacity;
+}
+
+size_t AHR_ArenaUsed(const AHR_Arena_t *arena)
+{
+    return arena->used;
+}
+
+unsigned int AHR_ArenaFlags(const AHR_Arena_t *arena)
+{
+    return arena->flags;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static size_t AHR_ArenaRoundUp(size_t nbytes, size_t granularity)
+{
+    return ((nbytes + granularity - 1U) / granularity) * granularity;
+}
+
+static void* AHR_ArenaMap(size_t capacity, int extra_flags, size_t alignment)
+{
+    //
+    // mmap() only guarantees Page Alignment. Map one additional Alignment Unit and
+    // give back the unaligned Head and the Rest of the Tail.
+    //
+    const size_t extra = alignment > AHR_ARENA_PAGE_SIZE ? alignment : 0U;
+    char *base = mmap(
+        NULL, 
+        capacity + extra, 
+        PROT_READ | PROT_WRITE, 
+        MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, 
+        -1, 
+        0
+    );
+    if(MAP_FAILED == (void*)base)
+    {
+        return NULL;
+    }
+    if(extra)
+    {
+        char *aligned = (char*)(uintptr_t)AHR_ArenaRoundUp((size_t)(uintptr_t)base, alignment);
+        const size_t head = (size_t)(aligned - base);
+        if(head)
+        {
+            munmap(base, head);
+        }
+        if(extra - head)
+        {
+            munmap(aligned + capacity, extra - head);
+        }
+        base = aligned;
+    }
+    return base;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,464 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <external/async_http_requests/ahr_compression.h>
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+#if defined(AHR_WITH_ZSTD)
+#include <zstd.h>
+#include <zdict.h>
+#endif
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Bytes pulled from the Source at once while a Stream is compressed.
+///
+#define AHR_COMPRESSION_BLOCK_BYTES ((size_t)(64 * 1024))
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Make "zlib" ready for a new Body, it is only initialized again if Encoding or Level changed.
+///
+static bool AHR_CompressorResetZlib(AHR_Compressor_t *compressor, unsigned int encoding, int level);
+#if defined(AHR_WITH_ZSTD)
+///
+/// \brief  Make "zstd" ready for a new Body with either the Dictionary or the Level.
+///
+static bool AHR_CompressorResetZstd(
+    AHR_Compressor_t *compressor,
+    int level,
+    const AHR_CompressionDictionary_t *dictionary
+);
+#endif
+///
+/// \brief  Pull the next Block from the Source once the current one is used up.
+/// \returns    false if the Source aborted.
+///
+static bool AHR_CompressorFill(AHR_Compressor_t *compressor);
+static size_t AHR_CompressorRead(void *compressor, char *buffer, size_t nbytes);
+static bool AHR_CompressorRewind(void *compressor);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+unsigned int AHR_CompressionSupported(unsigned int encodings)
+{
+    unsigned int supported = AHR_ENCODING_GZIP | AHR_ENCODING_DEFLATE;
+#if defined(AHR_WITH_ZSTD)
+    supported |= AHR_ENCODING_ZSTD;
+#endif
+    return encodings & supported;
+}
+
+const char* AHR_CompressionToken(unsigned int encoding)
+{
+    switch(encoding)
+    {
+        case AHR_ENCODING_GZIP:
+            return "gzip";
+        case AHR_ENCODING_DEFLATE:
+            return "deflate";
+        case AHR_ENCODING_ZSTD:
+            return "zstd";
+        default:
+            return NULL;
+    }
+}
+
+AHR_CompressionDictionary_t AHR_CreateCompressionDictionary(const void *data, size_t nbytes, int level)
+{
+    AHR_CompressionDictionary_t dictionary = {.cdict = NULL, .id = 0};
+#if defined(AHR_WITH_ZSTD)
+    if(data && nbytes > 0)
+    {
+        dictionary.cdict = ZSTD_createCDict(data, nbytes, 0 != level ? level : ZSTD_CLEVEL_DEFAULT);
+        dictionary.id = dictionary.cdict ? ZSTD_getDictID_fromCDict(dictionary.cdict) : 0U;
+    }
+#else
+    (void)data;
+    (void)nbytes;
+    (void)level;
+#endif
+    return dictionary;
+}
+
+bool AHR_CompressionDictionaryIsValid(const AHR_CompressionDictionary_t *dictionary)
+{
+    return NULL != dictionary && NULL != dictionary->cdict;
+}
+
+void AHR_DestroyCompressionDictionary(AHR_CompressionDictionary_t *dictionary)
+{
+#if defined(AHR_WITH_ZSTD)
+    ZSTD_freeCDict((ZSTD_CDict*)dictionary->cdict);
+#endif
+    dictionary->cdict = NULL;
+    dictionary->id = 0;
+}
+
+size_t AHR_CompressionTrainDictionary(
+    const char *const *samples,
+    const size_t *sizes,
+    size_t nsamples,
+    void *dictionary,
+    size_t capacity
+)
+{
+#if defined(AHR_WITH_ZSTD)
+    //
+    // The Trainer wants all Samples back to back.
+    //
+    size_t total = 0;
+    for(size_t i=0;i<nsamples;++i)
+    {
+        total += sizes[i];
+    }
+    char *concatenated = malloc(total > 0 ? total : 1U);
+    if(!concatenated || nsamples > UINT_MAX)
+    {
+        free(concatenated);
+        return 0;
+    }
+    size_t offset = 0;
+    for(size_t i=0;i<nsamples;++i)
+    {
+        memcpy(&concatenated[offset], samples[i], sizes[i]); // flawfinder: ignore
+        offset += sizes[i];
+    }
+    const size_t result = ZDICT_trainFromBuffer(dictionary, capacity, concatenated, sizes, (unsigned int)nsamples);
+    free(concatenated);
+    return ZDICT_isError(result) ? 0U : result;
+#else
+    (void)samples;
+    (void)sizes;
+    (void)nsamples;
+    (void)dictionary;
+    (void)capacity;
+    return 0;
+#endif
+}
+
+AHR_Compressor_t AHR_CreateCompressor(void)
+{
+    return (AHR_Compressor_t){
+        .zlib = NULL,
+        .zstd = NULL,
+        .zlib_encoding = 0,
+        .zlib_level = 0,
+        .encoding = 0,
+        .level = 0,
+        .dictionary = NULL,
+        .source = {.read = NULL, .rewind = NULL, .user = NULL, .content_length = 0},
+        .input = NULL,
+        .input_pos = 0,
+        .input_len = 0,
+        .source_done = false,
+        .finished = false,
+        .consumed = 0,
+        .produced = 0
+    };
+}
+
+void AHR_DestroyCompressor(AHR_Compressor_t *compressor)
+{
+    if(compressor->zlib)
+    {
+        deflateEnd((z_stream*)compressor->zlib);
+        free(compressor->zlib);
+    }
+#if defined(AHR_WITH_ZSTD)
+    ZSTD_freeCCtx((ZSTD_CCtx*)compressor->zstd);
+#endif
+    free(compressor->input);
+    *compressor = AHR_CreateCompressor();
+}
+
+size_t AHR_CompressBound(unsigned int encoding, size_t nbytes)
+{
+#if defined(AHR_WITH_ZSTD)
+    if(AHR_ENCODING_ZSTD == encoding)
+    {
+        return ZSTD_compressBound(nbytes);
+    }
+#else
+    (void)encoding;
+#endif
+    //
+    // compressBound() covers the zlib Wrapper, the gzip Wrapper is a few Bytes larger.
+    //
+    return (size_t)compressBound((uLong)nbytes) + 32U;
+}
+
+int64_t AHR_Compress(
+    AHR_Compressor_t *compressor,
+    unsigned int encoding,
+    int level,
+    const AHR_CompressionDictionary_t *dictionary,
+    const char *data,
+    size_t nbytes,
+    char *out,
+    size_t capacity
+)
+{
+    assert(NULL != compressor);
+    if(AHR_ENCODING_GZIP == encoding || AHR_ENCODING_DEFLATE == encoding)
+    {
+        if(nbytes > UINT_MAX || !AHR_CompressorResetZlib(compressor, encoding, level))
+        {
+            return -1;
+        }
+        z_stream *stream = (z_stream*)compressor->zlib;
+        stream->next_in = (Bytef*)(uintptr_t)data;
+        stream->avail_in = (uInt)nbytes;
+        stream->next_out = (Bytef*)out;
+        stream->avail_out = (uInt)(capacity > UINT_MAX ? UINT_MAX : capacity);
+        if(Z_STREAM_END != deflate(stream, Z_FINISH))
+        {
+            return -1;
+        }
+        return (int64_t)(stream->next_out - (Bytef*)out);
+    }
+#if defined(AHR_WITH_ZSTD)
+    if(AHR_ENCODING_ZSTD == encoding)
+    {
+        if(!AHR_CompressorResetZstd(compressor, level, dictionary))
+        {
+            return -1;
+        }
+        const size_t written = ZSTD_compress2((ZSTD_CCtx*)compressor->zstd, out, capacity, data, nbytes);
+        return ZSTD_isError(written) ? -1 : (int64_t)written;
+    }
+#else
+    (void)dictionary;
+#endif
+    return -1;
+}
+
+bool AHR_CompressorBeginStream(
+    AHR_Compressor_t *compressor,
+    unsigned int encoding,
+    int level,
+    const AHR_CompressionDictionary_t *dictionary,
+    const AHR_BodyProvider_t *source
+)
+{
+    assert(NULL != compressor);
+    assert(NULL != source && NULL != source->read);
+    if(!compressor->input)
+    {
+        compressor->input = malloc(AHR_COMPRESSION_BLOCK_BYTES);
+        if(!compressor->input)
+        {
+            return false;
+        }
+    }
+    bool ready = false;
+    if(AHR_ENCODING_GZIP == encoding || AHR_ENCODING_DEFLATE == encoding)
+    {
+        ready = AHR_CompressorResetZlib(compressor, encoding, level);
+    }
+#if defined(AHR_WITH_ZSTD)
+    else if(AHR_ENCODING_ZSTD == encoding)
+    {
+        ready = AHR_CompressorResetZstd(compressor, level, dictionary);
+    }
+#endif
+    compressor->encoding = encoding;
+    compressor->level = level;
+    compressor->dictionary = dictionary;
+    compressor->source = *source;
+    compressor->input_pos = 0;
+    compressor->input_len = 0;
+    compressor->source_done = false;
+    compressor->finished = false;
+    compressor->consumed = 0;
+    compressor->produced = 0;
+    return ready;
+}
+
+AHR_BodyProvider_t AHR_CompressorProvider(AHR_Compressor_t *compressor)
+{
+    return (AHR_BodyProvider_t){
+        .read = AHR_CompressorRead,
+        .rewind = compressor->source.rewind ? AHR_CompressorRewind : NULL,
+        .user = compressor,
+        .content_length = AHR_BODY_PROVIDER_CHUNKED
+    };
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_CompressorResetZlib(AHR_Compressor_t *compressor, unsigned int encoding, int level)
+{
+    z_stream *stream = (z_stream*)compressor->zlib;
+    if(stream && compressor->zlib_encoding == encoding && compressor->zlib_level == level)
+    {
+        return Z_OK == deflateReset(stream);
+    }
+    if(stream)
+    {
+        deflateEnd(stream);
+    }
+    else
+    {
+        stream = malloc(sizeof(z_stream));
+        if(!stream)
+        {
+            return false;
+        }
+        compressor->zlib = stream;
+    }
+    memset(stream, 0, sizeof(z_stream));
+    //
+    // 16 on top of the Window Bits selects the gzip Wrapper, "deflate" in HTTP means the zlib Wrapper.
+    //
+    const int window_bits = AHR_ENCODING_GZIP == encoding ? 15 + 16 : 15;
+    if(Z_OK != deflateInit2(stream, 0 != level ? level : Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY))
+    {
+        free(stream);
+        compressor->zlib = NULL;
+        return false;
+    }
+    compressor->zlib_encoding = encoding;
+    compressor->zlib_level = level;
+    return true;
+}
+
+#if defined(AHR_WITH_ZSTD)
+static bool AHR_CompressorResetZstd(
+    AHR_Compressor_t *compressor,
+    int level,
+    const AHR_CompressionDictionary_t *dictionary
+)
+{
+    if(!compressor->zstd)
+    {
+        compressor->zstd = ZSTD_createCCtx();
+        if(!compressor->zstd)
+        {
+            return false;
+        }
+    }
+    ZSTD_CCtx *context = (ZSTD_CCtx*)compressor->zstd;
+    ZSTD_CCtx_reset(context, ZSTD_reset_session_and_parameters);
+    const size_t status = AHR_CompressionDictionaryIsValid(dictionary)
+        ? ZSTD_CCtx_refCDict(context, (const ZSTD_CDict*)dictionary->cdict)
+        : ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, 0 != level ? level : ZSTD_CLEVEL_DEFAULT);
+    return !ZSTD_isError(status);
+}
+#endif
+
+static bool AHR_CompressorFill(AHR_Compressor_t *compressor)
+{
+    if(compressor->input_pos < compressor->input_len || compressor->source_done)
+    {
+        return true;
+    }
+    const size_t nbytes = compressor->source.read(
+        compressor->source.user,
+        compressor->input,
+        AHR_COMPRESSION_BLOCK_BYTES
+    );
+    if(AHR_BODY_PROVIDER_ABORT == nbytes)
+    {
+        return false;
+    }
+    compressor->input_pos = 0;
+    compressor->input_len = nbytes;
+    compressor->source_done = 0 == nbytes;
+    compressor->consumed += nbytes;
+    return true;
+}
+
+static size_t AHR_CompressorRead(void *user, char *buffer, size_t nbytes)
+{
+    //
+    // Compress until curls Buffer is full or the Body ended, 0 tells curl the Body is complete.
+    //
+    AHR_Compressor_t *compressor = (AHR_Compressor_t*)user;
+    size_t written = 0;
+    while(written < nbytes && !compressor->finished)
+    {
+        if(!AHR_CompressorFill(compressor))
+        {
+            return AHR_BODY_PROVIDER_ABORT;
+        }
+        const size_t available = compressor->input_len - compressor->input_pos;
+        if(AHR_ENCODING_ZSTD != compressor->encoding)
+        {
+            z_stream *stream = (z_stream*)compressor->zlib;
+            const size_t room = nbytes - written;
+            stream->next_in = (Bytef*)&compressor->input[compressor->input_pos];
+            stream->avail_in = (uInt)available;
+            stream->next_out = (Bytef*)&buffer[written];
+            stream->avail_out = (uInt)(room > UINT_MAX ? UINT_MAX : room);
+            const int status = deflate(stream, compressor->source_done ? Z_FINISH : Z_NO_FLUSH);
+            if(Z_STREAM_ERROR == status)
+            {
+                return AHR_BODY_PROVIDER_ABORT;
+            }
+            compressor->input_pos += available - stream->avail_in;
+            written = (size_t)((char*)stream->next_out - buffer);
+            compressor->finished = Z_STREAM_END == status;
+        }
+#if defined(AHR_WITH_ZSTD)
+        else
+        {
+            ZSTD_inBuffer in = {.src = &compressor->input[compressor->input_pos], .size = available, .pos = 0};
+            ZSTD_outBuffer out = {.dst = buffer, .size = nbytes, .pos = written};
+            const size_t remaining = ZSTD_compressStream2(
+                (ZSTD_CCtx*)compressor->zstd,
+                &out,
+                &in,
+                compressor->source_done ? ZSTD_e_end : ZSTD_e_continue
+            );
+            if(ZSTD_isError(remaining))
+            {
+                return AHR_BODY_PROVIDER_ABORT;
+            }
+            compressor->input_pos += in.pos;
+            written = out.pos;
+            compressor->finished = compressor->source_done && 0 == remaining;
+        }
+#endif
+    }
+    compressor->produced += written;
+    return written;
+}
+
+static bool AHR_CompressorRewind(void *user)
+{
+    AHR_Compressor_t *compressor = (AHR_Compressor_t*)user;
+    if(!compressor->source.rewind || !compressor->source.rewind(compressor->source.user))
+    {
+        return false;
+    }
+    const AHR_BodyProvider_t source = compressor->source;
+    return AHR_CompressorBeginStream(
+        compressor,
+        compressor->encoding,
+        compressor->level,
+        compressor->dictionary,
+        &source
+    );
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
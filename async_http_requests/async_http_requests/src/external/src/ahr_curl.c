@@ -5,6 +5,8 @@
 
 #include "async_http_requests/ahr_types.h"
 #include <string.h>
+#include <stdio.h>
+#include <limits.h>
 #include <assert.h>
 
 #include <external/async_http_requests/ahr_curl.h>
@@ -17,12 +19,48 @@
 
 typedef size_t (*AHR_CurlReadFunction_t)(char *ptr, size_t size, size_t nmemb, void *stream);
 
+///
+/// \brief  Headers of POST and PUT Requests whose Body comes from a Provider.
+///
+static const char * const AHR_CURL_PROVIDER_HEADERS[] = {
+    "Accept: application/json",
+    "Content-Type: application/json",
+    "Expect:"
+};
+
 struct AHR_Curl
 {
     void* handle;
-    struct curl_slist *http_header;
+    ///
+    /// \brief  Header List currently set as CURLOPT_HTTPHEADER, shared through "header_cache" if set.
+    ///
+    AHR_HeaderListCache_t *header_cache;
+    AHR_HeaderList_t *header_list;
+    ///
+    /// \brief  User Headers, sent in Front of the Headers of the Http Method.
+    ///
+    const AHR_HeaderBlock_t *user_header;
+    ///
+    /// \brief  Scratch Buffer for the Key of the Header List. It only grows, so reconfiguring 
+    ///         with Headers of the same Size does not allocate.
+    ///
+    char *header_key;
+    size_t header_key_capacity;
 
     AHR_FileTransfer_t file_transfer;
+    AHR_BodyProvider_t body_provider;
+    ///
+    /// \brief  Encodings currently set as CURLOPT_ACCEPT_ENCODING, 0 if none.
+    ///
+    unsigned int accept_encodings;
+    ///
+    /// \brief  Content-Encoding Header Line of the Request Body, NULL if the Body is sent as is.
+    ///
+    const char *content_encoding;
+    ///
+    /// \brief  Logger which receives the verbose Output, NULL if the Handle is quiet.
+    ///
+    AHR_Logger_t verbose_logger;
 };
 
 
@@ -43,12 +81,6 @@ struct AHR_CurlM
 // --------------------------------------------------------------------------------------------------------------------
 //
 
-#define MAX_UPLOAD_SIZE 4096
-
-//
-// --------------------------------------------------------------------------------------------------------------------
-//
-
 static struct AHR_CurlEasyHandleList* AHR_CurlEasyHandleListAppendEasyHandle(
     struct AHR_CurlEasyHandleList *list,
     AHR_Curl_t easy_handle
@@ -67,6 +99,20 @@ static AHR_Curl_t AHR_CurlEasyHandleListFindEasyHandle(
 static struct AHR_CurlEasyHandleList* AHR_CurlEasyHandleListRemoveAll(
     struct AHR_CurlEasyHandleList *list
 );
+///
+/// \brief  Undo Method specific Options of a previous Configuration, the Handle is a GET Request afterwards.
+///
+static void AHR_CurlResetHttpMethod(AHR_Curl_t handle);
+///
+/// \brief  Set the User Headers followed by "lines" and "body_line", if not NULL, as CURLOPT_HTTPHEADER. 
+///         The List is only replaced if the Lines changed.
+/// \returns    false if no Memory is left, the Handle has no Headers then.
+///
+static bool AHR_CurlApplyHeaders(AHR_Curl_t handle, const char * const *lines, size_t nlines, const char *body_line);
+///
+/// \brief  CURLOPT_DEBUGFUNCTION, logs Info Text and Headers, Bodies are left out.
+///
+static int AHR_CurlDebugCallback(CURL *handle, curl_infotype type, char *data, size_t size, void *clientp);
 
 //
 // --------------------------------------------------------------------------------------------------------------------
@@ -86,17 +132,29 @@ AHR_Curl_t AHR_CurlEasyInit(
 
     curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_callback);
     curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, header_callback);
-    curl_easy_setopt(handle, CURLOPT_VERBOSE, 1);
-    curl_easy_setopt(handle, CURLOPT_TIMEOUT, 5);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, (long)AHR_PROCESSOR_DEFAULT_TIMEOUT_MS);
 
     const struct AHR_Curl content = {
         .handle = handle,
-        .http_header = NULL,
+        .header_cache = NULL,
+        .header_list = NULL,
+        .user_header = NULL,
+        .header_key = NULL,
+        .header_key_capacity = 0,
         .file_transfer = {
-            .data = malloc(MAX_UPLOAD_SIZE),
+            .data = NULL,
             .current_pos = 0,
             .size = 0
-        }
+        },
+        .body_provider = {
+            .read = NULL,
+            .rewind = NULL,
+            .user = NULL,
+            .content_length = 0
+        },
+        .accept_encodings = 0,
+        .content_encoding = NULL,
+        .verbose_logger = NULL
     };
 
     AHR_Curl_t result = (AHR_Curl_t)malloc(sizeof(struct AHR_Curl));
@@ -121,44 +179,127 @@ void AHR_CurlSetCallbackUserData(
 
 void AHR_CurlEasyCleanUp(AHR_Curl_t handle)
 {
-    if(handle->file_transfer.data)
-    {
-        free(handle->file_transfer.data);
-    }
-    if(handle->http_header)
-    {
-        curl_slist_free_all(handle->http_header);
-        handle->http_header = NULL;
-    }
+    //
+    // The Handle may still point to the List, clean it up before the List is released.
+    //
     curl_easy_cleanup(handle->handle);
+    AHR_HeaderListRelease(handle->header_cache, handle->header_list);
+    handle->header_list = NULL;
+    free(handle->header_key);
+    handle->header_key = NULL;
+    handle->header_key_capacity = 0;
+    free(handle);
+}
+
+void AHR_CurlSetHeaderListCache(AHR_Curl_t handle, AHR_HeaderListCache_t *cache)
+{
+    assert(NULL == handle->header_list);
+    handle->header_cache = cache;
 }
 
-void AHR_CurlSetHeader(AHR_Curl_t handle, const AHR_Header_t *header)
+void AHR_CurlSetHeader(AHR_Curl_t handle, const AHR_HeaderBlock_t *header)
 {
-    // TODO: Transfer Code here...
     if(!header)
     {
         return;
     }
+    handle->user_header = header;
+}
+
+void AHR_CurlEasySetUrl(AHR_Curl_t handle, const char *url)
+{
+    curl_easy_setopt(handle->handle, CURLOPT_URL, url);
+}
+
+void AHR_CurlEasySetCurlUrl(AHR_Curl_t handle, AHR_CurlUrl_t url)
+{
+    curl_easy_setopt(handle->handle, CURLOPT_CURLU, (CURLU*)url);
+}
 
-    if(handle->http_header)
+AHR_CurlUrl_t AHR_CurlUrlParse(const char *url)
+{
+    CURLU *parsed = curl_url();
+    if(!parsed)
     {
-        curl_slist_free_all(handle->http_header);
+        return NULL;
     }
-    
-    char buffer[AHR_HEADERENTRY_NAME_LEN + AHR_HEADERENTRY_VALUE_LEN + 2]; // flawfinder: ignore
-    handle->http_header = NULL;
-    for(size_t i=0;i<header->nheaders;++i)
+    if(CURLUE_OK != curl_url_set(parsed, CURLUPART_URL, url, 0))
     {
-        snprintf(buffer, sizeof(buffer), "%s:%s", header->header[i].name, header->header[i].value);
-        handle->http_header = curl_slist_append(handle->http_header, buffer);
+        curl_url_cleanup(parsed);
+        return NULL;
     }
-    curl_easy_setopt(handle->handle, CURLOPT_HTTPHEADER, handle->http_header);
+    return (AHR_CurlUrl_t)parsed;
 }
 
-void AHR_CurlEasySetUrl(AHR_Curl_t handle, const char *url)
+AHR_CurlUrl_t AHR_CurlUrlDup(AHR_CurlUrl_t url)
 {
-    curl_easy_setopt(handle->handle, CURLOPT_URL, url);
+    return (AHR_CurlUrl_t)curl_url_dup((CURLU*)url);
+}
+
+void AHR_CurlUrlCleanUp(AHR_CurlUrl_t url)
+{
+    curl_url_cleanup((CURLU*)url);
+}
+
+bool AHR_CurlUrlSetPath(AHR_CurlUrl_t url, const char *path, const char *query)
+{
+    CURLU *parsed = (CURLU*)url;
+    return CURLUE_OK == curl_url_set(parsed, CURLUPART_PATH, path, 0)
+        && CURLUE_OK == curl_url_set(parsed, CURLUPART_QUERY, query, 0)
+        && CURLUE_OK == curl_url_set(parsed, CURLUPART_FRAGMENT, NULL, 0);
+}
+
+int64_t AHR_CurlUrlGetPath(AHR_CurlUrl_t url, char *buffer, size_t nbytes)
+{
+    char *path = NULL;
+    if(CURLUE_OK != curl_url_get((CURLU*)url, CURLUPART_PATH, &path, 0))
+    {
+        return -1;
+    }
+    const size_t len = strlen(path);
+    const int64_t result = len < nbytes ? (int64_t)len : -1;
+    if(result >= 0)
+    {
+        memcpy(buffer, path, len + 1U); // flawfinder: ignore
+    }
+    curl_free(path);
+    return result;
+}
+
+int64_t AHR_CurlUrlGetOrigin(AHR_CurlUrl_t url, char *buffer, size_t nbytes)
+{
+    CURLU *origin = curl_url_dup((CURLU*)url);
+    if(!origin)
+    {
+        return -1;
+    }
+    char *text = NULL;
+    int64_t result = -1;
+    if(
+        CURLUE_OK == curl_url_set(origin, CURLUPART_PATH, NULL, 0)
+        && CURLUE_OK == curl_url_set(origin, CURLUPART_QUERY, NULL, 0)
+        && CURLUE_OK == curl_url_set(origin, CURLUPART_FRAGMENT, NULL, 0)
+        && CURLUE_OK == curl_url_get(origin, CURLUPART_URL, &text, 0)
+    )
+    {
+        size_t len = strlen(text);
+        //
+        // Without a Path curl renders the Root "/", the Origin ends before it.
+        //
+        while(len > 0 && '/' == text[len - 1])
+        {
+            --len;
+        }
+        if(len < nbytes)
+        {
+            memcpy(buffer, text, len); // flawfinder: ignore
+            buffer[len] = '\0';
+            result = (int64_t)len;
+        }
+    }
+    curl_free(text);
+    curl_url_cleanup(origin);
+    return result;
 }
 
 bool AHR_CurlEasyPerform(AHR_Curl_t handle)
@@ -173,25 +314,273 @@ long AHR_CurlEasyStatusCode(AHR_Curl_t handle)
     return status_code;
 }
 
-void AHR_CurlSetHttpMethodGet(AHR_Curl_t handle)
+int64_t AHR_CurlEasyContentLength(AHR_Curl_t handle)
 {
-    handle->http_header = curl_slist_append(handle->http_header, "Accept: application/json");
-    curl_easy_setopt(handle->handle, CURLOPT_HTTPGET, 1L);
+    curl_off_t content_length = -1;
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length))
+    {
+        return -1;
+    }
+    return (int64_t)content_length;
 }
 
-void AHR_CurlSetHttpMethodPost(AHR_Curl_t handle, const char *body)
+uint64_t AHR_CurlEasyWireBytes(AHR_Curl_t handle)
 {
-    assert(NULL != handle->handle);
-    handle->http_header = curl_slist_append(handle->http_header, "Accept: application/json");
-    handle->http_header = curl_slist_append(handle->http_header, "Content-Type: application/json");
-    curl_easy_setopt(handle->handle, CURLOPT_HTTPHEADER, handle->http_header);
-    if(body)
+    curl_off_t nbytes = 0;
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_SIZE_DOWNLOAD_T, &nbytes) || nbytes < 0)
+    {
+        return 0;
+    }
+    return (uint64_t)nbytes;
+}
+
+void AHR_CurlEasyTimings(AHR_Curl_t handle, AHR_RequestTimings_t *timings)
+{
+    static const struct
+    {
+        CURLINFO info;
+        size_t offset;
+    } phases[] = {
+        {CURLINFO_NAMELOOKUP_TIME_T, offsetof(AHR_RequestTimings_t, name_lookup_us)},
+        {CURLINFO_CONNECT_TIME_T, offsetof(AHR_RequestTimings_t, connect_us)},
+        {CURLINFO_APPCONNECT_TIME_T, offsetof(AHR_RequestTimings_t, app_connect_us)},
+        {CURLINFO_PRETRANSFER_TIME_T, offsetof(AHR_RequestTimings_t, pretransfer_us)},
+        {CURLINFO_STARTTRANSFER_TIME_T, offsetof(AHR_RequestTimings_t, first_byte_us)},
+        {CURLINFO_TOTAL_TIME_T, offsetof(AHR_RequestTimings_t, total_us)}
+    };
+    for(size_t i=0;i<sizeof(phases) / sizeof(phases[0]);++i)
+    {
+        curl_off_t us = 0;
+        if(CURLE_OK != curl_easy_getinfo(handle->handle, phases[i].info, &us) || us < 0)
+        {
+            us = 0;
+        }
+        *(uint64_t*)((char*)timings + phases[i].offset) = (uint64_t)us;
+    }
+}
+
+void AHR_CurlEasyTransferInfo(AHR_Curl_t handle, uint64_t *bytes_in, uint64_t *bytes_out, uint64_t *new_connections)
+{
+    curl_off_t download = 0;
+    curl_off_t upload = 0;
+    long header = 0;
+    long request = 0;
+    long connects = 0;
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_SIZE_DOWNLOAD_T, &download) || download < 0)
+    {
+        download = 0;
+    }
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_SIZE_UPLOAD_T, &upload) || upload < 0)
+    {
+        upload = 0;
+    }
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_HEADER_SIZE, &header) || header < 0)
+    {
+        header = 0;
+    }
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_REQUEST_SIZE, &request) || request < 0)
+    {
+        request = 0;
+    }
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_NUM_CONNECTS, &connects) || connects < 0)
+    {
+        connects = 0;
+    }
+    *bytes_in = (uint64_t)download + (uint64_t)header;
+    *bytes_out = (uint64_t)upload + (uint64_t)request;
+    *new_connections = (uint64_t)connects;
+}
+
+void AHR_CurlEasyMessageSizes(AHR_Curl_t handle, uint64_t *request_body, uint64_t *response_header, uint64_t *response_body)
+{
+    curl_off_t upload = 0;
+    curl_off_t download = 0;
+    long header = 0;
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_SIZE_UPLOAD_T, &upload) || upload < 0)
+    {
+        upload = 0;
+    }
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_SIZE_DOWNLOAD_T, &download) || download < 0)
+    {
+        download = 0;
+    }
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_HEADER_SIZE, &header) || header < 0)
+    {
+        header = 0;
+    }
+    *request_body = (uint64_t)upload;
+    *response_header = (uint64_t)header;
+    *response_body = (uint64_t)download;
+}
+
+const char* AHR_CurlEasyEffectiveMethod(AHR_Curl_t handle)
+{
+#if LIBCURL_VERSION_NUM >= 0x074800
+    char *method = NULL;
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_EFFECTIVE_METHOD, &method))
+    {
+        return NULL;
+    }
+    return method;
+#else
+    (void)handle;
+    return NULL;
+#endif
+}
+
+AHR_FailureClass_t AHR_CurlFailureClass(size_t error_code)
+{
+    switch(error_code)
+    {
+        case CURLE_OPERATION_TIMEDOUT:
+            return AHR_FAILURE_TIMEOUT;
+        case CURLE_COULDNT_RESOLVE_PROXY:
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_SSL_CONNECT_ERROR:
+            return AHR_FAILURE_CONNECT;
+        case CURLE_WRITE_ERROR:
+        case CURLE_ABORTED_BY_CALLBACK:
+        case CURLE_FILESIZE_EXCEEDED:
+            return AHR_FAILURE_ABORTED;
+        default:
+            return AHR_FAILURE_OTHER;
+    }
+}
+
+const char* AHR_CurlEasyEffectiveUrl(AHR_Curl_t handle)
+{
+    char *url = NULL;
+    if(CURLE_OK != curl_easy_getinfo(handle->handle, CURLINFO_EFFECTIVE_URL, &url))
+    {
+        return NULL;
+    }
+    return url;
+}
+
+unsigned int AHR_CurlSupportedEncodings(unsigned int encodings)
+{
+    const curl_version_info_data *info = curl_version_info(CURLVERSION_NOW);
+    unsigned int supported = 0;
+    if(info->features & CURL_VERSION_LIBZ)
+    {
+        supported |= AHR_ENCODING_GZIP | AHR_ENCODING_DEFLATE;
+    }
+    if(info->features & CURL_VERSION_BROTLI)
+    {
+        supported |= AHR_ENCODING_BROTLI;
+    }
+#if defined(CURL_VERSION_ZSTD)
+    if(info->features & CURL_VERSION_ZSTD)
+    {
+        supported |= AHR_ENCODING_ZSTD;
+    }
+#endif
+    return encodings & supported;
+}
+
+void AHR_CurlSetVerbose(AHR_Curl_t handle, AHR_Logger_t logger)
+{
+    if(logger == handle->verbose_logger)
+    {
+        return;
+    }
+    handle->verbose_logger = logger;
+    curl_easy_setopt(handle->handle, CURLOPT_DEBUGFUNCTION, logger ? AHR_CurlDebugCallback : NULL);
+    curl_easy_setopt(handle->handle, CURLOPT_DEBUGDATA, logger);
+    curl_easy_setopt(handle->handle, CURLOPT_VERBOSE, logger ? 1L : 0L);
+}
+
+void AHR_CurlSetTimeout(AHR_Curl_t handle, size_t timeout_ms, size_t stall_seconds)
+{
+    curl_easy_setopt(handle->handle, CURLOPT_TIMEOUT_MS, timeout_ms > LONG_MAX ? 0L : (long)timeout_ms);
+    curl_easy_setopt(handle->handle, CURLOPT_LOW_SPEED_LIMIT, stall_seconds > 0 ? 1L : 0L);
+    curl_easy_setopt(handle->handle, CURLOPT_LOW_SPEED_TIME, stall_seconds > LONG_MAX ? LONG_MAX : (long)stall_seconds);
+}
+
+void AHR_CurlSetAcceptEncoding(AHR_Curl_t handle, unsigned int encodings)
+{
+    static const struct
+    {
+        unsigned int encoding;
+        const char *token;
+    } tokens[] = {
+        {AHR_ENCODING_ZSTD, "zstd"},
+        {AHR_ENCODING_BROTLI, "br"},
+        {AHR_ENCODING_GZIP, "gzip"},
+        {AHR_ENCODING_DEFLATE, "deflate"}
+    };
+    const unsigned int offered = AHR_CurlSupportedEncodings(encodings);
+    if(offered == handle->accept_encodings)
+    {
+        return;
+    }
+    handle->accept_encodings = offered;
+    if(0 == offered)
+    {
+        curl_easy_setopt(handle->handle, CURLOPT_ACCEPT_ENCODING, NULL);
+        return;
+    }
+    //
+    // curl copies the Value, the preferred Encoding goes first.
+    //
+    char value[64]; // flawfinder: ignore
+    size_t used = 0;
+    for(size_t i=0;i<sizeof(tokens)/sizeof(tokens[0]);++i)
+    {
+        if(offered & tokens[i].encoding)
+        {
+            const int n = snprintf(&value[used], sizeof(value) - used, "%s%s", used ? ", " : "", tokens[i].token);
+            used += n > 0 ? (size_t)n : 0U;
+        }
+    }
+    curl_easy_setopt(handle->handle, CURLOPT_ACCEPT_ENCODING, value);
+}
+
+void AHR_CurlSetContentEncoding(AHR_Curl_t handle, unsigned int encoding)
+{
+    switch(encoding)
     {
-        curl_easy_setopt(handle->handle, CURLOPT_POSTFIELDSIZE, (long)strnlen(body, MAX_UPLOAD_SIZE-1));
-        curl_easy_setopt(handle->handle, CURLOPT_COPYPOSTFIELDS, body);
+        case AHR_ENCODING_GZIP:
+            handle->content_encoding = "Content-Encoding: gzip";
+            break;
+        case AHR_ENCODING_DEFLATE:
+            handle->content_encoding = "Content-Encoding: deflate";
+            break;
+        case AHR_ENCODING_ZSTD:
+            handle->content_encoding = "Content-Encoding: zstd";
+            break;
+        default:
+            handle->content_encoding = NULL;
+            break;
     }
 }
 
+bool AHR_CurlSetHttpMethodGet(AHR_Curl_t handle)
+{
+    static const char * const lines[] = {"Accept: application/json"};
+    AHR_CurlResetHttpMethod(handle);
+    return AHR_CurlApplyHeaders(handle, lines, sizeof(lines) / sizeof(lines[0]), NULL);
+}
+
+bool AHR_CurlSetHttpMethodPost(AHR_Curl_t handle, const char *body, size_t nbytes)
+{
+    //
+    // The Body is borrowed, curl sends it straight from the Callers Memory.
+    //
+    static const char *empty_body = "";
+    static const char * const lines[] = {
+        "Accept: application/json",
+        "Content-Type: application/json"
+    };
+
+    assert(NULL != handle->handle);
+    AHR_CurlResetHttpMethod(handle);
+    curl_easy_setopt(handle->handle, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)(body ? nbytes : 0U));
+    curl_easy_setopt(handle->handle, CURLOPT_POSTFIELDS, body ? body : empty_body);
+    return AHR_CurlApplyHeaders(handle, lines, sizeof(lines) / sizeof(lines[0]), handle->content_encoding);
+}
+
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
@@ -199,12 +588,11 @@ void AHR_CurlSetHttpMethodPost(AHR_Curl_t handle, const char *body)
 static size_t AHR_PutReadCallback(char *ptr, size_t size, size_t nmemb, void *stream)
 {
     //
-    // malloc is used only on Initialization.
-    // No Bufferchecks required if the initial Size is respected.
+    // file_transfer points into the borrowed Body, it is read directly into curls Upload Buffer.
     //
     
     AHR_Curl_t handle = (AHR_Curl_t)stream;
-    if(handle->file_transfer.data && handle->file_transfer.size)
+    if(handle->file_transfer.data && handle->file_transfer.current_pos < handle->file_transfer.size)
     {
         const size_t output_buffer_size = size * nmemb;
         const size_t bytes_left_to_transfer = handle->file_transfer.size - handle->file_transfer.current_pos;
@@ -219,54 +607,148 @@ static size_t AHR_PutReadCallback(char *ptr, size_t size, size_t nmemb, void *st
             bytes_to_transfer
         );
 
-        handle->file_transfer.size -= bytes_to_transfer;
         handle->file_transfer.current_pos += bytes_to_transfer;
         return bytes_to_transfer;
     }
     return 0;
 }
 
-void AHR_CurlSetHttpMethodPut(AHR_Curl_t handle, const char *body)
+static int AHR_PutSeekCallback(void *stream, curl_off_t offset, int origin)
 {
     //
-    // malloc is used only on Initialization.
-    // No Bufferchecks required if the initial Size is respected.
+    // curl rewinds the Upload on Redirects and Connection reuse failures.
     //
+    AHR_Curl_t handle = (AHR_Curl_t)stream;
+    if(SEEK_SET != origin || offset < 0 || (size_t)offset > handle->file_transfer.size)
+    {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    handle->file_transfer.current_pos = (size_t)offset;
+    return CURL_SEEKFUNC_OK;
+}
 
-    assert(NULL != body);
+bool AHR_CurlSetHttpMethodPut(AHR_Curl_t handle, const char *body, size_t nbytes)
+{
+    //
+    // The Body is borrowed, it has to stay valid until the Transfer ended.
+    //
+    static const char * const lines[] = {
+        "Accept: application/json",
+        "Content-Type: application/json",
+        "Expect:",
+        "Transfer-Encoding:"
+    };
 
-    const size_t body_size = strnlen(body, MAX_UPLOAD_SIZE-1);
-    if(body_size >= (MAX_UPLOAD_SIZE - 1))
+    AHR_CurlResetHttpMethod(handle);
+    curl_easy_setopt(handle->handle, CURLOPT_UPLOAD, 1L);
+    handle->file_transfer.data = body;
+    handle->file_transfer.current_pos = 0;
+    handle->file_transfer.size = body ? nbytes : 0U;
+    curl_easy_setopt(handle->handle, CURLOPT_INFILESIZE_LARGE, (curl_off_t)handle->file_transfer.size);
+    curl_easy_setopt(handle->handle, CURLOPT_READFUNCTION, AHR_PutReadCallback);
+    curl_easy_setopt(handle->handle, CURLOPT_READDATA, handle);
+    curl_easy_setopt(handle->handle, CURLOPT_SEEKFUNCTION, AHR_PutSeekCallback);
+    curl_easy_setopt(handle->handle, CURLOPT_SEEKDATA, handle);
+    return AHR_CurlApplyHeaders(handle, lines, sizeof(lines) / sizeof(lines[0]), handle->content_encoding);
+}
+
+static size_t AHR_ProviderReadCallback(char *ptr, size_t size, size_t nmemb, void *stream)
+{
+    //
+    // The Provider writes directly into curls Upload Buffer.
+    //
+    AHR_Curl_t handle = (AHR_Curl_t)stream;
+    const size_t nbytes = size * nmemb;
+    if(!handle->body_provider.read)
     {
-        return;
+        return 0;
     }
+    const size_t written = handle->body_provider.read(handle->body_provider.user, ptr, nbytes);
+    if(AHR_BODY_PROVIDER_ABORT == written || written > nbytes)
+    {
+        return CURL_READFUNC_ABORT;
+    }
+    return written;
+}
+
+static int AHR_ProviderSeekCallback(void *stream, curl_off_t offset, int origin)
+{
+    //
+    // A Provider can only start over, curl never seeks anywhere else for plain Uploads.
+    //
+    AHR_Curl_t handle = (AHR_Curl_t)stream;
+    if(SEEK_SET != origin || 0 != offset || !handle->body_provider.rewind)
+    {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    return handle->body_provider.rewind(handle->body_provider.user) ? CURL_SEEKFUNC_OK : CURL_SEEKFUNC_FAIL;
+}
 
-    handle->http_header = curl_slist_append(handle->http_header, "Accept: application/json");
-    handle->http_header = curl_slist_append(handle->http_header, "Content-Type: application/json");
-    handle->http_header = curl_slist_append(handle->http_header, "Expect:");
-    handle->http_header = curl_slist_append(handle->http_header, "Transfer-Encoding:");
+static void AHR_CurlSetBodyProvider(AHR_Curl_t handle, const AHR_BodyProvider_t *provider)
+{
+    assert(NULL != provider);
+    assert(NULL != provider->read);
 
+    handle->body_provider = *provider;
+    curl_easy_setopt(handle->handle, CURLOPT_READFUNCTION, AHR_ProviderReadCallback);
+    curl_easy_setopt(handle->handle, CURLOPT_READDATA, handle);
+    curl_easy_setopt(handle->handle, CURLOPT_SEEKFUNCTION, AHR_ProviderSeekCallback);
+    curl_easy_setopt(handle->handle, CURLOPT_SEEKDATA, handle);
+}
 
-    curl_easy_setopt(handle->handle, CURLOPT_HTTPHEADER, handle->http_header);
-    curl_easy_setopt(handle->handle, CURLOPT_PUT, 1L);
+bool AHR_CurlSetHttpMethodPostProvider(AHR_Curl_t handle, const AHR_BodyProvider_t *provider)
+{
+    //
+    // Without POSTFIELDS curl reads the Body through the Read Callback. An unknown Size (-1) 
+    // makes curl use chunked Transfer-Encoding on its own.
+    //
+    AHR_CurlResetHttpMethod(handle);
+
+    AHR_CurlSetBodyProvider(handle, provider);
+    curl_easy_setopt(handle->handle, CURLOPT_POSTFIELDS, NULL);
+    curl_easy_setopt(handle->handle, CURLOPT_POST, 1L);
+    curl_easy_setopt(
+        handle->handle, 
+        CURLOPT_POSTFIELDSIZE_LARGE, 
+        (curl_off_t)(provider->content_length < 0 ? -1 : provider->content_length)
+    );
+    return AHR_CurlApplyHeaders(
+        handle, 
+        AHR_CURL_PROVIDER_HEADERS, 
+        sizeof(AHR_CURL_PROVIDER_HEADERS) / sizeof(AHR_CURL_PROVIDER_HEADERS[0]),
+        handle->content_encoding
+    );
+}
+
+bool AHR_CurlSetHttpMethodPutProvider(AHR_Curl_t handle, const AHR_BodyProvider_t *provider)
+{
+    //
+    // Unlike AHR_CurlSetHttpMethodPut(), Transfer-Encoding is not suppressed, so curl can send 
+    // a Body of unknown Size chunked.
+    //
+    AHR_CurlResetHttpMethod(handle);
+
+    AHR_CurlSetBodyProvider(handle, provider);
     curl_easy_setopt(handle->handle, CURLOPT_UPLOAD, 1L);
-    memset(handle->file_transfer.data, '\0', MAX_UPLOAD_SIZE);
-    memcpy( // flawfinder: ignore
-        handle->file_transfer.data, 
-        body, 
-        strnlen(body, body_size)
+    curl_easy_setopt(
+        handle->handle, 
+        CURLOPT_INFILESIZE_LARGE, 
+        (curl_off_t)(provider->content_length < 0 ? -1 : provider->content_length)
+    );
+    return AHR_CurlApplyHeaders(
+        handle, 
+        AHR_CURL_PROVIDER_HEADERS, 
+        sizeof(AHR_CURL_PROVIDER_HEADERS) / sizeof(AHR_CURL_PROVIDER_HEADERS[0]),
+        handle->content_encoding
     );
-    handle->file_transfer.current_pos = 0;
-    handle->file_transfer.size = body_size;
-    curl_easy_setopt(handle->handle, CURLOPT_INFILESIZE, (long)body_size);
-    curl_easy_setopt(handle->handle, CURLOPT_READFUNCTION, AHR_PutReadCallback);
-    curl_easy_setopt(handle->handle, CURLOPT_READDATA, handle);
 }
 
-void AHR_CurlSetHttpMethodDelete(AHR_Curl_t handle)
+bool AHR_CurlSetHttpMethodDelete(AHR_Curl_t handle)
 {
-    handle->http_header = curl_slist_append(handle->http_header, "Accept: application/json");
+    static const char * const lines[] = {"Accept: application/json"};
+    AHR_CurlResetHttpMethod(handle);
     curl_easy_setopt(handle->handle, CURLOPT_CUSTOMREQUEST, "DELETE");
+    return AHR_CurlApplyHeaders(handle, lines, sizeof(lines) / sizeof(lines[0]), NULL);
 }
 
 int AHR_CurlWriteError(void)
@@ -279,6 +761,16 @@ int AHR_CurlReadError(void)
     return CURLE_READ_ERROR;
 }
 
+size_t AHR_CurlWritePause(void)
+{
+    return CURL_WRITEFUNC_PAUSE;
+}
+
+void AHR_CurlEasyResume(AHR_Curl_t handle)
+{
+    curl_easy_pause(handle->handle, CURLPAUSE_CONT);
+}
+
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
@@ -343,9 +835,9 @@ AHR_CurlM_t AHR_CurlMultiInit(void)
 
 void AHR_CurlMultiCleanUp(AHR_CurlM_t handle)
 {
-    // TODO: clean up structs internals!
     handle->easy_handles = AHR_CurlEasyHandleListRemoveAll(handle->easy_handles);
     curl_multi_cleanup(handle->handle);
+    free(handle);
 }
 
 bool AHR_CurlMultiInfoRead(
@@ -375,7 +867,7 @@ bool AHR_CurlMultiInfoRead(
             }
             else
             {
-                callback.on_error(callback.data, easy_handle, 0);
+                callback.on_error(callback.data, easy_handle, (size_t)m->data.result);
             }
         }
     } while(m);
@@ -505,6 +997,103 @@ static AHR_Curl_t AHR_CurlEasyHandleListFindEasyHandle(
     return NULL;
 }
 
+static void AHR_CurlResetHttpMethod(AHR_Curl_t handle)
+{
+    //
+    // CURLOPT_HTTPGET also resets CURLOPT_UPLOAD and CURLOPT_NOBODY.
+    //
+    curl_easy_setopt(handle->handle, CURLOPT_HTTPGET, 1L);
+    curl_easy_setopt(handle->handle, CURLOPT_CUSTOMREQUEST, NULL);
+    handle->file_transfer.data = NULL;
+    handle->file_transfer.current_pos = 0;
+    handle->file_transfer.size = 0;
+    handle->body_provider.read = NULL;
+    handle->body_provider.rewind = NULL;
+    handle->body_provider.user = NULL;
+    handle->body_provider.content_length = 0;
+}
+
+static bool AHR_CurlApplyHeaders(AHR_Curl_t handle, const char * const *lines, size_t nlines, const char *body_line)
+{
+    const AHR_HeaderBlock_t *header = handle->user_header;
+    const size_t nheaders = header ? AHR_HeaderBlockSize(header) : 0U;
+    //
+    // Size the Key first, the Scratch Buffer only grows when a larger Set of Headers shows up.
+    //
+    size_t nbytes = 0;
+    for(size_t i=0;i<nheaders;++i)
+    {
+        AHR_HeaderView_t view;
+        AHR_HeaderBlockAt(header, i, &view);
+        nbytes += view.name_len + 2U + view.value_len + 1U;
+    }
+    for(size_t i=0;i<nlines;++i)
+    {
+        nbytes += strlen(lines[i]) + 1U;
+    }
+    if(body_line)
+    {
+        nbytes += strlen(body_line) + 1U;
+    }
+    if(nbytes > handle->header_key_capacity)
+    {
+        char *key = realloc(handle->header_key, nbytes);
+        if(!key)
+        {
+            goto on_error;
+        }
+        handle->header_key = key;
+        handle->header_key_capacity = nbytes;
+    }
+
+    char *current = handle->header_key;
+    for(size_t i=0;i<nheaders;++i)
+    {
+        AHR_HeaderView_t view;
+        AHR_HeaderBlockAt(header, i, &view);
+        memcpy(current, view.name, view.name_len); // flawfinder: ignore
+        current += view.name_len;
+        *current++ = ':';
+        *current++ = ' ';
+        memcpy(current, view.value, view.value_len); // flawfinder: ignore
+        current += view.value_len;
+        *current++ = '\0';
+    }
+    for(size_t i=0;i<nlines;++i)
+    {
+        const size_t len = strlen(lines[i]) + 1U;
+        memcpy(current, lines[i], len); // flawfinder: ignore
+        current += len;
+    }
+    if(body_line)
+    {
+        memcpy(current, body_line, strlen(body_line) + 1U); // flawfinder: ignore
+    }
+
+    if(handle->header_list && AHR_HeaderListMatches(handle->header_list, handle->header_key, nbytes))
+    {
+        return true;
+    }
+    AHR_HeaderList_t *list = AHR_HeaderListAcquire(handle->header_cache, handle->header_key, nbytes);
+    if(!list)
+    {
+        goto on_error;
+    }
+    curl_easy_setopt(handle->handle, CURLOPT_HTTPHEADER, (struct curl_slist*)AHR_HeaderListCurl(list));
+    AHR_HeaderListRelease(handle->header_cache, handle->header_list);
+    handle->header_list = list;
+    return true;
+
+    on_error:
+    //
+    // The Headers of the previous Request must not be sent with this one.
+    //
+    curl_easy_setopt(handle->handle, CURLOPT_HTTPHEADER, NULL);
+    AHR_HeaderListRelease(handle->header_cache, handle->header_list);
+    handle->header_list = NULL;
+    return false;
+}
+
 static struct AHR_CurlEasyHandleList* AHR_CurlEasyHandleListRemoveAll(
     struct AHR_CurlEasyHandleList *list
 )
@@ -518,6 +1107,35 @@ static struct AHR_CurlEasyHandleList* AHR_CurlEasyHandleListRemoveAll(
     }
     return NULL; 
 }
+
+static int AHR_CurlDebugCallback(CURL *handle, curl_infotype type, char *data, size_t size, void *clientp)
+{
+    (void)handle;
+    char direction = '*';
+    switch(type)
+    {
+        case CURLINFO_TEXT:
+            direction = '*';
+            break;
+        case CURLINFO_HEADER_IN:
+            direction = '<';
+            break;
+        case CURLINFO_HEADER_OUT:
+            direction = '>';
+            break;
+        default:
+            return 0;
+    }
+    //
+    // Outgoing Headers arrive as one Block, Lines are kept together in one Message.
+    //
+    while(size > 0 && ('\n' == data[size - 1U] || '\r' == data[size - 1U]))
+    {
+        --size;
+    }
+    AHR_LOG_INFO((AHR_Logger_t)clientp, "curl %c %.*s", direction, (int)size, data);
+    return 0;
+}
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
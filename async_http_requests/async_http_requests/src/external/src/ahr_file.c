@@ -0,0 +1,349 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define _GNU_SOURCE
+
+#include <external/async_http_requests/ahr_file.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Granularity in which written Pages are handed to Writeback and dropped afterwards.
+///
+#define AHR_FILE_WRITEBACK_WINDOW ((uint64_t)(8 * 1024 * 1024))
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_FileWriterBeginDownload(AHR_FileWriter_t *writer, int fd, int64_t content_length);
+///
+/// \brief  Start Writeback for each full Window and drop the Window before it from the Page Cache.
+///         Lagging one Window behind means the Writeback waited for was started a Window ago
+///         and is usually done, so the Processors Thread rarely blocks here.
+///
+static void AHR_FileWriterDropWritten(AHR_FileWriter_t *writer, int fd);
+static void AHR_FileWriterDropRange(const AHR_FileWriter_t *writer, int fd, uint64_t begin, uint64_t end);
+///
+/// \brief  Map the Range of the Reader. mmap() needs a page aligned Offset, so the Mapping starts 
+///         at the Page which contains the Offset.
+///
+static bool AHR_FileReaderMap(AHR_FileReader_t *reader);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_FileWriter_t AHR_CreateFileWriter(void)
+{
+    AHR_FileWriter_t writer = {
+        .offset = 0,
+        .flags = 0,
+        .written = 0,
+        .synced = 0,
+        .dropped = 0,
+        .started = false
+    };
+    return writer;
+}
+
+void AHR_FileWriterReset(AHR_FileWriter_t *writer, const AHR_FileSink_t *sink)
+{
+    assert(NULL != writer);
+    assert(NULL != sink);
+
+    *writer = AHR_CreateFileWriter();
+    writer->offset = sink->offset;
+    writer->flags = sink->flags;
+}
+
+bool AHR_FileWriterWrite(
+    AHR_FileWriter_t *writer,
+    int fd,
+    const char *data,
+    size_t nbytes,
+    int64_t content_length
+)
+{
+    assert(NULL != writer);
+    assert(NULL != data || 0 == nbytes);
+
+    if(!writer->started)
+    {
+        AHR_FileWriterBeginDownload(writer, fd, content_length);
+    }
+
+    size_t done = 0;
+    while(done < nbytes)
+    {
+        const ssize_t n = pwrite(
+            fd,
+            data + done,
+            nbytes - done,
+            (off_t)(writer->offset + (int64_t)(writer->written + done))
+        );
+        if(n < 0)
+        {
+            if(EINTR == errno)
+            {
+                continue;
+            }
+            return false;
+        }
+        done += (size_t)n;
+    }
+    writer->written += nbytes;
+
+    if(writer->flags & AHR_FILE_SINK_DONTNEED)
+    {
+        AHR_FileWriterDropWritten(writer, fd);
+    }
+    return true;
+}
+
+void AHR_FileWriterEnd(AHR_FileWriter_t *writer, int fd)
+{
+    assert(NULL != writer);
+
+    if(writer->started && (writer->flags & AHR_FILE_SINK_DONTNEED))
+    {
+        AHR_FileWriterDropRange(writer, fd, writer->dropped, writer->written);
+        writer->synced = writer->written;
+        writer->dropped = writer->written;
+    }
+    writer->started = false;
+}
+
+AHR_FileReader_t AHR_CreateFileReader(void)
+{
+    AHR_FileReader_t reader = {
+        .fd = -1,
+        .owns_fd = false,
+        .offset = 0,
+        .length = 0,
+        .position = 0,
+        .mapping = NULL,
+        .mapping_len = 0,
+        .mapping_delta = 0
+    };
+    return reader;
+}
+
+bool AHR_FileReaderOpen(AHR_FileReader_t *reader, const AHR_FileSource_t *source)
+{
+    assert(NULL != reader);
+    assert(NULL != source);
+
+    AHR_FileReaderClose(reader);
+    if(source->path)
+    {
+        reader->fd = open(source->path, O_RDONLY | O_CLOEXEC); // flawfinder: ignore
+        reader->owns_fd = true;
+    }
+    else
+    {
+        reader->fd = source->fd;
+        reader->owns_fd = false;
+    }
+    if(reader->fd < 0 || source->offset < 0)
+    {
+        goto on_error;
+    }
+
+    struct stat info;
+    if(0 != fstat(reader->fd, &info) || source->offset > (int64_t)info.st_size)
+    {
+        goto on_error;
+    }
+    const int64_t available = (int64_t)info.st_size - source->offset;
+    if(source->length > available)
+    {
+        goto on_error;
+    }
+    reader->offset = source->offset;
+    reader->length = source->length < 0 ? available : source->length;
+    reader->position = 0;
+
+    if((source->flags & AHR_FILE_SOURCE_MMAP) && reader->length > 0 && !AHR_FileReaderMap(reader))
+    {
+        goto on_error;
+    }
+    if(!reader->mapping)
+    {
+        (void)posix_fadvise(reader->fd, (off_t)reader->offset, (off_t)reader->length, POSIX_FADV_SEQUENTIAL);
+    }
+    return true;
+
+    on_error:
+    AHR_FileReaderClose(reader);
+    return false;
+}
+
+void AHR_FileReaderClose(AHR_FileReader_t *reader)
+{
+    assert(NULL != reader);
+
+    if(reader->mapping)
+    {
+        munmap(reader->mapping, reader->mapping_len);
+    }
+    if(reader->owns_fd && reader->fd >= 0)
+    {
+        close(reader->fd);
+    }
+    *reader = AHR_CreateFileReader();
+}
+
+int64_t AHR_FileReaderLength(const AHR_FileReader_t *reader)
+{
+    return reader->length;
+}
+
+const char* AHR_FileReaderData(const AHR_FileReader_t *reader)
+{
+    return reader->mapping ? ((const char*)reader->mapping) + reader->mapping_delta : NULL;
+}
+
+size_t AHR_FileReaderRead(void *reader, char *buffer, size_t nbytes)
+{
+    AHR_FileReader_t *r = (AHR_FileReader_t*)reader;
+    const int64_t left = r->length - r->position;
+    if(left <= 0)
+    {
+        return 0;
+    }
+    const size_t wanted = (int64_t)nbytes < left ? nbytes : (size_t)left;
+    while(1)
+    {
+        const ssize_t n = pread(r->fd, buffer, wanted, (off_t)(r->offset + r->position)); // flawfinder: ignore
+        if(n < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if(n <= 0)
+        {
+            //
+            // An Error or a File which shrank below the announced Length.
+            //
+            return AHR_BODY_PROVIDER_ABORT;
+        }
+        r->position += n;
+        return (size_t)n;
+    }
+}
+
+bool AHR_FileReaderRewind(void *reader)
+{
+    AHR_FileReader_t *r = (AHR_FileReader_t*)reader;
+    r->position = 0;
+    return true;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_FileReaderMap(AHR_FileReader_t *reader)
+{
+    const long page_size = sysconf(_SC_PAGESIZE);
+    const int64_t aligned_offset = reader->offset - (reader->offset % (int64_t)page_size);
+    reader->mapping_delta = (size_t)(reader->offset - aligned_offset);
+    reader->mapping_len = reader->mapping_delta + (size_t)reader->length;
+    void *mapping = mmap(NULL, reader->mapping_len, PROT_READ, MAP_SHARED, reader->fd, (off_t)aligned_offset);
+    if(MAP_FAILED == mapping)
+    {
+        reader->mapping_len = 0;
+        reader->mapping_delta = 0;
+        return false;
+    }
+    (void)madvise(mapping, reader->mapping_len, MADV_SEQUENTIAL);
+    reader->mapping = mapping;
+    return true;
+}
+
+static void AHR_FileWriterBeginDownload(AHR_FileWriter_t *writer, int fd, int64_t content_length)
+{
+    //
+    // All Hints are best effort, a File System which does not support them still receives the Body.
+    //
+    writer->started = true;
+    if(content_length > 0 && (writer->flags & AHR_FILE_SINK_PREALLOCATE))
+    {
+#if defined(__linux__)
+        //
+        // Reserve the Blocks without changing the File Size, an aborted Download leaves no Zeros behind.
+        //
+        (void)fallocate(fd, FALLOC_FL_KEEP_SIZE, (off_t)writer->offset, (off_t)content_length);
+#endif
+    }
+    if(writer->flags & AHR_FILE_SINK_SEQUENTIAL)
+    {
+        (void)posix_fadvise(
+            fd,
+            (off_t)writer->offset,
+            content_length > 0 ? (off_t)content_length : 0,
+            POSIX_FADV_SEQUENTIAL
+        );
+    }
+}
+
+static void AHR_FileWriterDropWritten(AHR_FileWriter_t *writer, int fd)
+{
+    while((writer->written - writer->synced) >= AHR_FILE_WRITEBACK_WINDOW)
+    {
+#if defined(__linux__)
+        (void)sync_file_range(
+            fd,
+            (off_t)(writer->offset + (int64_t)writer->synced),
+            (off_t)AHR_FILE_WRITEBACK_WINDOW,
+            SYNC_FILE_RANGE_WRITE
+        );
+#endif
+        writer->synced += AHR_FILE_WRITEBACK_WINDOW;
+        if(writer->synced >= (2 * AHR_FILE_WRITEBACK_WINDOW))
+        {
+            const uint64_t end = writer->synced - AHR_FILE_WRITEBACK_WINDOW;
+            AHR_FileWriterDropRange(writer, fd, writer->dropped, end);
+            writer->dropped = end;
+        }
+    }
+}
+
+static void AHR_FileWriterDropRange(const AHR_FileWriter_t *writer, int fd, uint64_t begin, uint64_t end)
+{
+    if(end <= begin)
+    {
+        return;
+    }
+    const off_t offset = (off_t)(writer->offset + (int64_t)begin);
+    const off_t nbytes = (off_t)(end - begin);
+#if defined(__linux__)
+    //
+    // Dirty Pages are not dropped by POSIX_FADV_DONTNEED, they have to be written back first.
+    //
+    (void)sync_file_range(
+        fd,
+        offset,
+        nbytes,
+        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER
+    );
+#else
+    (void)fdatasync(fd);
+#endif
+    (void)posix_fadvise(fd, offset, nbytes, POSIX_FADV_DONTNEED);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,253 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <external/async_http_requests/ahr_header_list.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include <curl/curl.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Unreferenced Lists the Cache keeps, beyond this an unreferenced List is freed right away.
+///
+#define AHR_HEADER_LIST_MAX_IDLE ((size_t)32)
+
+struct AHR_HeaderList
+{
+    struct AHR_HeaderList *next;
+    uint64_t hash;
+    size_t refcount;
+    struct curl_slist *list;
+    size_t nbytes;
+    ///
+    /// \brief  Copy of the Key, used to tell Lists with the same Hash apart.
+    ///
+    char key[];
+};
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static uint64_t AHR_HeaderListHash(const char *key, size_t nbytes);
+///
+/// \brief  Allocate a List and build the curl List from the Lines of "key".
+///
+static AHR_HeaderList_t* AHR_HeaderListBuild(const char *key, size_t nbytes, uint64_t hash);
+static void AHR_HeaderListFree(AHR_HeaderList_t *list);
+///
+/// \brief  Unlink "list" from its Bucket.
+///
+static void AHR_HeaderListCacheRemove(AHR_HeaderListCache_t *cache, const AHR_HeaderList_t *list);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_HeaderListCache_t AHR_CreateHeaderListCache(void)
+{
+    AHR_HeaderListCache_t cache = {
+        .mutex = AHR_CreateMutex(),
+        .nlists = 0,
+        .nidle = 0,
+        .hits = 0,
+        .misses = 0
+    };
+    for(size_t i=0;i<AHR_HEADER_LIST_BUCKETS;++i)
+    {
+        cache.buckets[i] = NULL;
+    }
+    return cache;
+}
+
+void AHR_DestroyHeaderListCache(AHR_HeaderListCache_t *cache)
+{
+    assert(NULL != cache);
+
+    for(size_t i=0;i<AHR_HEADER_LIST_BUCKETS;++i)
+    {
+        AHR_HeaderList_t *current = cache->buckets[i];
+        while(current)
+        {
+            AHR_HeaderList_t *next = current->next;
+            assert(0 == current->refcount);
+            AHR_HeaderListFree(current);
+            current = next;
+        }
+        cache->buckets[i] = NULL;
+    }
+    cache->nlists = 0;
+    cache->nidle = 0;
+    if(cache->mutex)
+    {
+        AHR_DestroyMutex(&cache->mutex);
+    }
+}
+
+bool AHR_HeaderListCacheIsValid(const AHR_HeaderListCache_t *cache)
+{
+    return NULL != cache->mutex;
+}
+
+AHR_HeaderList_t* AHR_HeaderListAcquire(AHR_HeaderListCache_t *cache, const char *key, size_t nbytes)
+{
+    const uint64_t hash = AHR_HeaderListHash(key, nbytes);
+    if(!cache)
+    {
+        return AHR_HeaderListBuild(key, nbytes, hash);
+    }
+
+    AHR_MutexLock(cache->mutex);
+    AHR_HeaderList_t **bucket = &cache->buckets[hash % AHR_HEADER_LIST_BUCKETS];
+    AHR_HeaderList_t *list = *bucket;
+    while(list && (list->hash != hash || !AHR_HeaderListMatches(list, key, nbytes)))
+    {
+        list = list->next;
+    }
+    if(list)
+    {
+        ++cache->hits;
+    }
+    else
+    {
+        ++cache->misses;
+        list = AHR_HeaderListBuild(key, nbytes, hash);
+        if(list)
+        {
+            list->next = *bucket;
+            *bucket = list;
+            ++cache->nlists;
+            ++cache->nidle;
+        }
+    }
+    if(list)
+    {
+        if(0 == list->refcount++)
+        {
+            --cache->nidle;
+        }
+    }
+    AHR_MutexUnlock(cache->mutex);
+    return list;
+}
+
+void AHR_HeaderListRelease(AHR_HeaderListCache_t *cache, AHR_HeaderList_t *list)
+{
+    if(!list)
+    {
+        return;
+    }
+    if(!cache)
+    {
+        AHR_HeaderListFree(list);
+        return;
+    }
+
+    AHR_MutexLock(cache->mutex);
+    assert(list->refcount > 0);
+    if(0 == --list->refcount)
+    {
+        if(cache->nidle >= AHR_HEADER_LIST_MAX_IDLE)
+        {
+            AHR_HeaderListCacheRemove(cache, list);
+            --cache->nlists;
+            AHR_HeaderListFree(list);
+        }
+        else
+        {
+            ++cache->nidle;
+        }
+    }
+    AHR_MutexUnlock(cache->mutex);
+}
+
+bool AHR_HeaderListMatches(const AHR_HeaderList_t *list, const char *key, size_t nbytes)
+{
+    return list->nbytes == nbytes && 0 == memcmp(list->key, key, nbytes);
+}
+
+void* AHR_HeaderListCurl(const AHR_HeaderList_t *list)
+{
+    return list->list;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static uint64_t AHR_HeaderListHash(const char *key, size_t nbytes)
+{
+    //
+    // FNV-1a
+    //
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i=0;i<nbytes;++i)
+    {
+        hash ^= (uint64_t)(unsigned char)key[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static AHR_HeaderList_t* AHR_HeaderListBuild(const char *key, size_t nbytes, uint64_t hash)
+{
+    AHR_HeaderList_t *list = malloc(sizeof(AHR_HeaderList_t) + nbytes);
+    if(!list)
+    {
+        return NULL;
+    }
+    list->next = NULL;
+    list->hash = hash;
+    list->refcount = 0;
+    list->list = NULL;
+    list->nbytes = nbytes;
+    memcpy(list->key, key, nbytes); // flawfinder: ignore
+
+    size_t offset = 0;
+    while(offset < nbytes)
+    {
+        const char *line = &list->key[offset];
+        struct curl_slist *appended = curl_slist_append(list->list, line);
+        if(!appended)
+        {
+            AHR_HeaderListFree(list);
+            return NULL;
+        }
+        list->list = appended;
+        offset += strnlen(line, nbytes - offset) + 1U;
+    }
+    return list;
+}
+
+static void AHR_HeaderListFree(AHR_HeaderList_t *list)
+{
+    if(list->list)
+    {
+        curl_slist_free_all(list->list);
+    }
+    free(list);
+}
+
+static void AHR_HeaderListCacheRemove(AHR_HeaderListCache_t *cache, const AHR_HeaderList_t *list)
+{
+    AHR_HeaderList_t **current = &cache->buckets[list->hash % AHR_HEADER_LIST_BUCKETS];
+    while(*current && *current != list)
+    {
+        current = &(*current)->next;
+    }
+    if(*current)
+    {
+        *current = list->next;
+    }
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
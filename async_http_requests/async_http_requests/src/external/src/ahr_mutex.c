@@ -4,6 +4,7 @@
 //
 
 #include <external/async_http_requests/ahr_mutex.h>
+#include <async_http_requests/private/ahr_probes.h>
 
 #include <stdlib.h>
 #include <assert.h>
@@ -49,10 +50,28 @@ bool AHR_MutexTryLock(AHR_Mutex_t mutex)
 
 void AHR_MutexLock(AHR_Mutex_t mutex)
 {
-    int desired = AHR_MUTEX_UNLOCKED;
+    //
+    // A failed Exchange stores the current Value in "expected", it has to be reset for the next Try.
+    //
+    int expected = AHR_MUTEX_UNLOCKED;
+    if(atomic_compare_exchange_strong(&mutex->lock, &expected, AHR_MUTEX_LOCKED))
+    {
+        return;
+    }
+    //
+    // Contended, only this Path is probed so the uncontended Lock stays a single Exchange.
+    //
+    AHR_PROBE1(mutex__contended, mutex);
+    size_t spins = 1;
+    expected = AHR_MUTEX_UNLOCKED;
     while(
-        !atomic_compare_exchange_strong(&mutex->lock, &desired, AHR_MUTEX_LOCKED)
-    );
+        !atomic_compare_exchange_strong(&mutex->lock, &expected, AHR_MUTEX_LOCKED)
+    )
+    {
+        expected = AHR_MUTEX_UNLOCKED;
+        ++spins;
+    }
+    AHR_PROBE2(mutex__acquired, mutex, spins);
 }
 
 void AHR_MutexUnlock(AHR_Mutex_t mutex)
@@ -28,6 +28,9 @@
 
 #include <async_http_requests/private/ahr_logging.h>
 #include <async_http_requests/ahr_types.h>
+#include <external/async_http_requests/ahr_arena.h>
+#include <async_http_requests/private/ahr_buffer_pool.h>
+#include <external/async_http_requests/ahr_header_list.h>
 
 //
 // --------------------------------------------------------------------------------------------------------------------
@@ -44,6 +47,17 @@ typedef enum
     AHR_UNKNOWN_ERROR
 } AHR_Status_t;
 
+///
+/// \brief  Parsed URL, see external/async_http_requests/ahr_curl.h.
+///
+struct AHR_CurlUrl;
+typedef struct AHR_CurlUrl* AHR_CurlUrl_t;
+
+///
+/// \brief  Receives the Chunks of a streamed Response Body.
+///
+typedef AHR_StreamAction_t (*AHR_ResponseDataSink_t)(void *user, const char *data, size_t nbytes);
+
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
@@ -72,6 +86,53 @@ AHR_HttpResponse_t AHR_CreateResponse(void);
 ///
 AHR_HttpRequest_t AHR_CreateRequest(void);
 ///
+/// \brief  Create a Response Object whose fixed size Storage is taken from "arena".
+///         AHR_ResponseArenaBytes() Bytes are taken, AHR_DestroyResponse() does not give them back.
+///
+AHR_HttpResponse_t AHR_CreateResponseInArena(AHR_Arena_t *arena);
+///
+/// \brief  Create a Request Object whose fixed size Storage is taken from "arena".
+///         AHR_RequestArenaBytes() Bytes are taken, AHR_DestroyRequest() does not give them back.
+///
+AHR_HttpRequest_t AHR_CreateRequestInArena(AHR_Arena_t *arena);
+///
+/// \brief  Arena Bytes needed by AHR_CreateRequestInArena() / AHR_CreateResponseInArena().
+///
+size_t AHR_RequestArenaBytes(void);
+size_t AHR_ResponseArenaBytes(void);
+///
+/// \brief  Heap Bytes held by the Object outside of an Arena, i.e. its growable Header Block.
+///
+size_t AHR_RequestHeapBytes(const AHR_HttpRequest_t request);
+size_t AHR_ResponseHeapBytes(const AHR_HttpResponse_t response);
+///
+/// \brief  Create a Response Object in "arena" which borrows its Body Buffer from a Pool,
+///         see AHR_ResponseSetBufferPool(). Only the Object itself is taken from the Arena.
+///
+AHR_HttpResponse_t AHR_CreateResponseForPool(AHR_Arena_t *arena, AHR_BufferPool_t *pool, AHR_BufferCache_t *cache);
+size_t AHR_ResponsePoolArenaBytes(void);
+///
+/// \brief  Borrow the Body Buffer from "pool" instead of owning a fixed one.
+///         "cache" belongs to the Thread which drives the Transfers, it may be NULL.
+///
+void AHR_ResponseSetBufferPool(AHR_HttpResponse_t response, AHR_BufferPool_t *pool, AHR_BufferCache_t *cache);
+///
+/// \brief  Set the Endpoint Key of the next Transfer, used to presize the Body Buffer.
+///
+void AHR_ResponseSetEndpoint(AHR_HttpResponse_t response, uint64_t endpoint);
+uint64_t AHR_ResponseEndpoint(const AHR_HttpResponse_t response);
+///
+/// \brief  Remember the Body Size of the Endpoint set through AHR_ResponseSetEndpoint(), once per borrowed Buffer.
+///         Call it when the Transfer is complete, before the Endpoint may change.
+///
+void AHR_ResponseLearnBodySize(AHR_HttpResponse_t response);
+///
+/// \brief  Give a borrowed Body Buffer back to the Pool and remember the Body Size of the Endpoint, unless
+///         AHR_ResponseLearnBodySize() did already. AHR_ResponseBody() is empty afterwards.
+///         Must be called from the Thread which owns the Cache.
+///
+void AHR_ResponseReleaseBody(AHR_HttpResponse_t response);
+///
 /// \brief  Destroys a Response Object.
 ///
 void AHR_DestroyResponse(AHR_HttpResponse_t *response);
@@ -82,44 +143,112 @@ void AHR_DestroyRequest(AHR_HttpRequest_t *request);
 
 void AHR_RequestSetLogger(AHR_HttpRequest_t request, AHR_Logger_t logger);
 void AHR_ResponseSetLogger(AHR_HttpResponse_t response, AHR_Logger_t logger);
+///
+/// \brief  Stream the Response Body into "sink" instead of buffering it.
+///         Pass NULL to buffer the Body again.
+///
+void AHR_ResponseSetDataSink(AHR_HttpResponse_t response, AHR_ResponseDataSink_t sink, void *user);
 
+///
+/// \brief  Write the Response Body into "sink->fd" instead of the Response Buffer.
+///         Pass NULL to buffer the Body again.
+///
+void AHR_RequestSetFileSink(AHR_HttpRequest_t request, const AHR_FileSink_t *sink);
+///
+/// \brief  Finish a Download started through AHR_RequestSetFileSink(), call it once the Transfer ended.
+///
+void AHR_RequestEndFileSink(AHR_HttpRequest_t request);
 ///
 /// \brief  Set the given HTTP Header for the Request Object.
+///         The Headers are copied into the packed Header Block of the Request.
 /// \param[in, out] request - Request Object.
-/// \param[in] headers - A 2d char* Array that holds NULL-terminated c-strings.
-///                      The first dimension must be terminated with a NULL pointer.
-///                      Each Element by itselve must be a NULL-terminated c-string.
-///                      Each Header is constructed by "name:value" which the user has to do.
-///
-/// \example    const char* const headers[] = {
-///                 "Content-Type: application/json",
-///                 "Authorization: Bearer ...",
-///                 NULL
+/// \param[in] header - Array of "nheaders" Header Views.
+/// \param[in] nheaders - Number of Elements in "header".
+/// \returns    true if all Headers were stored, false if a Limit was exceeded.
+///
+/// \example    const AHR_HeaderView_t header[] = {
+///                 {.name="Authorization", .name_len=13, .value="Bearer ...", .value_len=10},
 ///             };
-///             AHR_RequestSetHeader(request, headers);
+///             AHR_RequestSetHeader(request, header, 1);
 ///             ...
 ///
-void AHR_RequestSetHeader(AHR_HttpRequest_t request, const AHR_Header_t *header);
-void AHR_RequestGetHeader(AHR_HttpRequest_t request, AHR_Header_t *header);
+bool AHR_RequestSetHeader(AHR_HttpRequest_t request, const AHR_HeaderView_t *header, size_t nheaders);
+///
+/// \brief  Share prebuilt curl Header Lists through "cache". Requests which send the same Headers use 
+///         the same List, reconfiguring a Request with unchanged Headers allocates nothing.
+///
+void AHR_RequestSetHeaderListCache(AHR_HttpRequest_t request, AHR_HeaderListCache_t *cache);
+///
+/// \brief  Bind the Request to a parsed Base URL. The Request keeps its own Copy, Scheme and Host are not 
+///         parsed again. NULL unbinds it.
+/// \returns    false if no Memory is left or the Base Path is too long, the Request is unbound then.
+///
+bool AHR_RequestSetBaseUrl(AHR_HttpRequest_t request, AHR_CurlUrl_t base);
+///
+/// \brief  Address the next Transfer relative to the Base URL. "path" may carry a Query ("/items?id=1"),
+///         it is appended to the Path of the Base URL. Pass url = NULL to AHR_Get() and the others afterwards.
+/// \returns    false if the Request has no Base URL or the Path is too long.
+///
+bool AHR_RequestSetPath(AHR_HttpRequest_t request, const char *path);
+///
+/// \brief  Key of the Base URL, continue it with the Path through AHR_BufferPoolEndpointKeyFrom() to 
+///         get the same Key AHR_BufferPoolEndpointKey() returns for the full URL.
+///
+uint64_t AHR_RequestBaseKey(const AHR_HttpRequest_t request);
+///
+/// \brief  Get the Number of Headers set for this Request.
+///
+size_t AHR_RequestHeaderCount(const AHR_HttpRequest_t request);
+///
+/// \brief  Get a View onto the Request Header at "index".
+///         The View is valid until the Headers of the Request change.
+///
+bool AHR_RequestHeaderAt(const AHR_HttpRequest_t request, size_t index, AHR_HeaderView_t *header);
+///
+/// \brief  The Methods below copy "url" into the Request. A NULL "url" keeps the Target set through 
+///         AHR_RequestSetPath().
+///         They return false if no Memory is left for the Request Headers, the Request is not made then.
+///
 ///
 /// \brief  Set the HTTP POST Method for this Object.
-///         This Function appends 1 additional Header.
-///         If there is no space for an additional Header, the last header if overridden.
-///         See AHR_HEADER_NMAX for the maximum number of possible Entries.
+///         Sends the Headers set through AHR_RequestSetHeader(), which stay unchanged, followed by "Accept",
+///         "Content-Type: application/json" and "Content-Encoding", if one was set. With a Header List Cache
+///         the curl Header List is shared with every Request which sends the same Lines, see
+///         AHR_RequestSetHeaderListCache().
+///         "body" is not copied, it must stay valid until the Transfer ended.
 ///
-void AHR_Post(AHR_HttpRequest_t request, const char *url, const char *body, AHR_HttpResponse_t response);
+bool AHR_Post(AHR_HttpRequest_t request, const char *url, const char *body, size_t nbytes, AHR_HttpResponse_t response);
 ///
 /// \brief  Set the HTTP PUT Method for this Object.
+///         "body" is not copied, it must stay valid until the Transfer ended.
 ///
-void AHR_Put(AHR_HttpRequest_t request, const char *url, const char *body, AHR_HttpResponse_t response);
+bool AHR_Put(AHR_HttpRequest_t request, const char *url, const char *body, size_t nbytes, AHR_HttpResponse_t response);
+///
+/// \brief  Set the HTTP POST Method for this Object, the Body is pulled from "provider" while it is sent.
+///
+bool AHR_PostFromProvider(
+    AHR_HttpRequest_t request, 
+    const char *url, 
+    const AHR_BodyProvider_t *provider, 
+    AHR_HttpResponse_t response
+);
+///
+/// \brief  Set the HTTP PUT Method for this Object, the Body is pulled from "provider" while it is sent.
+///
+bool AHR_PutFromProvider(
+    AHR_HttpRequest_t request, 
+    const char *url, 
+    const AHR_BodyProvider_t *provider, 
+    AHR_HttpResponse_t response
+);
 ///
 /// \brief  Set the HTTP GET Method for this Object.
 ///
-void AHR_Get(AHR_HttpRequest_t request, const char *url, AHR_HttpResponse_t response);
+bool AHR_Get(AHR_HttpRequest_t request, const char *url, AHR_HttpResponse_t response);
 ///
 /// \brief  Set the HTTP DELETE Method for this Object.
 ///
-void AHR_Delete(AHR_HttpRequest_t request, const char *url, AHR_HttpResponse_t response);
+bool AHR_Delete(AHR_HttpRequest_t request, const char *url, AHR_HttpResponse_t response);
 ///
 /// \brief  Get the HTTP Reponse Body of this Object.
 ///         The Pointer is valid until the Object is destroyed with a call to AHR_DestroyResponse(),
@@ -129,10 +258,82 @@ void AHR_Delete(AHR_HttpRequest_t request, const char *url, AHR_HttpResponse_t r
 const char* AHR_ResponseBody(const AHR_HttpResponse_t response);
 size_t AHR_ResponseBodyLength(const AHR_HttpResponse_t response);
 ///
-/// \brief  Get the Response Headers for the given Object.
+/// \brief  Copy the Response Headers for the given Object into a fixed size Structure.
+///         Only the received Headers are copied, prefer AHR_ResponseHeaderAt() which does not copy at all.
 ///
 void AHR_ResponseHeader(const AHR_HttpResponse_t response, AHR_Header_t *info);
 ///
+/// \brief  Get the Number of received Response Headers.
+///
+size_t AHR_ResponseHeaderCount(const AHR_HttpResponse_t response);
+///
+/// \brief  Get a View onto the Response Header at "index".
+///         The View is valid until the Response is reset.
+/// \returns    false if "index" is out of Range.
+///
+bool AHR_ResponseHeaderAt(const AHR_HttpResponse_t response, size_t index, AHR_HeaderView_t *header);
+///
+/// \brief  Find a received Header by its Name, ignoring Case, through the Hash Index of the Header Block.
+///         The View is valid until the Response is reset.
+/// \returns    false if no such Header was received or stored.
+///
+bool AHR_ResponseHeaderFind(const AHR_HttpResponse_t response, const char *name, AHR_HeaderView_t *header);
+///
+/// \brief  Store only the Headers named in "names" (case-insensitive), all others are dropped while they
+///         arrive. "nnames" = 0 stores all Headers again. The Names are copied.
+/// \returns    false if not all Names could be stored, all Headers are stored then.
+///
+bool AHR_ResponseSetHeaderFilter(AHR_HttpResponse_t response, const char *const *names, size_t nnames);
+///
+/// \brief  Offer the Content Encodings in "encodings" (AHR_ContentEncoding_t) for the next Transfer.
+///
+void AHR_RequestSetAcceptEncoding(AHR_HttpRequest_t request, unsigned int encodings);
+///
+/// \brief  Total Timeout of the next Transfer in Milliseconds and its Stall Limit in Seconds, 0 for none.
+///
+void AHR_RequestSetTimeout(AHR_HttpRequest_t request, size_t timeout_ms, size_t stall_seconds);
+///
+/// \brief  Send the Body of the next POST / PUT with Content-Encoding "encoding", 0 for none.
+///         Call this before the Http Method is configured.
+///
+void AHR_RequestSetContentEncoding(AHR_HttpRequest_t request, unsigned int encoding);
+///
+/// \brief  Pass curls verbose Output of the next Transfer to the Logger of the Request.
+///
+void AHR_RequestSetVerbose(AHR_HttpRequest_t request, bool verbose);
+///
+/// \brief  Abort the Transfer once more than "nbytes" decoded Body Bytes arrived, 0 for no Limit.
+///         This guards against small compressed Bodies which expand to huge ones.
+///
+void AHR_ResponseSetDecodedLimit(AHR_HttpResponse_t response, size_t nbytes);
+///
+/// \brief  Decoded Body Bytes of the current Transfer, whether it was buffered, streamed or written to a File.
+///
+uint64_t AHR_ResponseDecodedBytes(const AHR_HttpResponse_t response);
+///
+/// \brief  true if the current Response carries a Content-Encoding.
+///
+bool AHR_ResponseIsEncoded(const AHR_HttpResponse_t response);
+///
+/// \brief  true if the current Transfer was aborted by AHR_ResponseSetDecodedLimit().
+///
+bool AHR_ResponseLimitExceeded(const AHR_HttpResponse_t response);
+///
+/// \brief  Validate and index the buffered Body as JSON while it arrives, see ahr_json_index.h.
+///         Streamed Bodies and Downloads into a File are not indexed.
+///
+void AHR_ResponseSetJsonIndex(AHR_HttpResponse_t response, bool enabled);
+///
+/// \brief  Index the Rest of the Body once the Transfer is complete.
+/// \returns    true if indexing is enabled and the Body is valid JSON.
+///
+bool AHR_ResponseFinishJsonIndex(AHR_HttpResponse_t response);
+///
+/// \brief  View onto the Index of the finished Body. It is valid as long as the Body, false once it was released.
+/// \returns    false if the Body was not indexed or is not valid JSON.
+///
+bool AHR_ResponseJsonIndex(const AHR_HttpResponse_t response, AHR_JsonIndex_t *index);
+///
 /// \brief  Get the HTTP Status Code for the given Object.
 /// \returns long - On Success the value will be positive and contains a valid HTTP Status Code.
 ///                 If the Response is empty or on internal failure on the Client side this value is negative.
@@ -0,0 +1,162 @@
+///
+/// \brief  This Module implements a Pool of size-classed Buffers shared by all Objects of a Processor.
+///         Objects borrow a Buffer when a Transfer needs one and give it back when the Transfer ended,
+///         so the Memory in use follows the Bytes in Flight and not the Number of Objects.
+///
+///         Idle Buffers are kept in a shared Depot guarded by a Mutex. A Thread which borrows frequently
+///         owns an AHR_BufferCache_t, it is served without taking the Lock and exchanges Buffers with
+///         the Depot in Batches.
+///
+///         The Pool also learns the typical Response Size per Endpoint, so a Response Buffer can be
+///         presized and does not have to grow while the Body arrives.
+///
+/// \example    AHR_BufferPool_t pool = AHR_CreateBufferPool();
+///             AHR_BufferCache_t cache = AHR_CreateBufferCache(&pool);
+///             char *buffer = AHR_BufferPoolAcquire(&pool, &cache, 1000);
+///             ...
+///             AHR_BufferPoolRelease(&pool, &cache, buffer);
+///             AHR_DestroyBufferCache(&cache);
+///             AHR_DestroyBufferPool(&pool);
+///
+#ifndef __AHR_BUFFER_POOL_H__
+#define __AHR_BUFFER_POOL_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/ahr_types.h>
+#include <external/async_http_requests/ahr_mutex.h>
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Number of idle Buffers per Class a Cache holds before it gives half of them back to the Depot.
+///
+#define AHR_BUFFER_CACHE_SIZE ((size_t)8)
+///
+/// \brief  Number of Endpoints whose Response Size is remembered.
+///
+#define AHR_BUFFER_POOL_ENDPOINTS ((size_t)64)
+///
+/// \brief  Key of the empty URL, the Start of every Endpoint Key.
+///
+#define AHR_BUFFER_POOL_KEY_INIT (14695981039346656037ULL)
+
+typedef struct
+{
+    AHR_Mutex_t mutex;
+    ///
+    /// \brief  Idle Buffers per Class, linked through their Headers. Guarded by "mutex".
+    ///
+    void *depot[AHR_BUFFER_POOL_CLASSES];
+    size_t ndepot[AHR_BUFFER_POOL_CLASSES];
+
+    atomic_ullong acquired[AHR_BUFFER_POOL_CLASSES];
+    atomic_ullong cache_hits[AHR_BUFFER_POOL_CLASSES];
+    atomic_ullong depot_hits[AHR_BUFFER_POOL_CLASSES];
+    atomic_ullong allocated[AHR_BUFFER_POOL_CLASSES];
+    atomic_size_t in_use[AHR_BUFFER_POOL_CLASSES];
+    atomic_size_t high_water[AHR_BUFFER_POOL_CLASSES];
+    atomic_size_t idle[AHR_BUFFER_POOL_CLASSES];
+    atomic_size_t bytes_in_use;
+    atomic_size_t bytes_high_water;
+    atomic_ullong presized;
+    atomic_ullong regrown;
+    atomic_ullong oversized;
+    ///
+    /// \brief  Learned Response Sizes, direct mapped by the Endpoint Key.
+    ///         Only the Processors Thread reads and writes them.
+    ///
+    struct
+    {
+        uint64_t key;
+        size_t expected;
+    } endpoints[AHR_BUFFER_POOL_ENDPOINTS];
+} AHR_BufferPool_t;
+
+typedef struct
+{
+    AHR_BufferPool_t *pool;
+    void *buffers[AHR_BUFFER_POOL_CLASSES][AHR_BUFFER_CACHE_SIZE];
+    size_t nbuffers[AHR_BUFFER_POOL_CLASSES];
+} AHR_BufferCache_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_BufferPool_t AHR_CreateBufferPool(void);
+///
+/// \brief  Free all idle Buffers. All borrowed Buffers and all Caches must have been given back before.
+///
+void AHR_DestroyBufferPool(AHR_BufferPool_t *pool);
+bool AHR_BufferPoolIsValid(const AHR_BufferPool_t *pool);
+///
+/// \brief  Create a Cache for the calling Thread. A Cache must only be used by one Thread at a Time.
+///
+AHR_BufferCache_t AHR_CreateBufferCache(AHR_BufferPool_t *pool);
+///
+/// \brief  Give all Buffers of the Cache back to the Depot.
+///
+void AHR_DestroyBufferCache(AHR_BufferCache_t *cache);
+///
+/// \brief  Borrow a Buffer of at least "nbytes" Bytes.
+/// \param[in] cache - Cache of the calling Thread, NULL to go to the Depot directly.
+/// \returns    NULL if "nbytes" exceeds the largest Class or no Memory is left.
+///
+char* AHR_BufferPoolAcquire(AHR_BufferPool_t *pool, AHR_BufferCache_t *cache, size_t nbytes);
+///
+/// \brief  Give a Buffer back. The Buffer does not have to come from the same Cache.
+///
+void AHR_BufferPoolRelease(AHR_BufferPool_t *pool, AHR_BufferCache_t *cache, char *buffer);
+///
+/// \brief  Usable Size of a Buffer returned by AHR_BufferPoolAcquire().
+///
+size_t AHR_BufferCapacity(const char *buffer);
+///
+/// \brief  Size of the largest Class.
+///
+size_t AHR_BufferPoolMaxSize(void);
+///
+/// \brief  Bytes held by the Pool, borrowed and idle.
+///
+size_t AHR_BufferPoolBytes(const AHR_BufferPool_t *pool);
+void AHR_BufferPoolStats(const AHR_BufferPool_t *pool, AHR_BufferPoolStats_t *stats);
+///
+/// \brief  Count a Response Buffer which was large enough from the Start / which had to grow /
+///         which could not hold the Body.
+///
+void AHR_BufferPoolCountPresized(AHR_BufferPool_t *pool);
+void AHR_BufferPoolCountRegrown(AHR_BufferPool_t *pool);
+void AHR_BufferPoolCountOversized(AHR_BufferPool_t *pool);
+///
+/// \brief  Key of the Endpoint "url" belongs to, Query and Fragment are ignored.
+///
+uint64_t AHR_BufferPoolEndpointKey(const char *url);
+///
+/// \brief  Continue "key" with the next Part of the URL, e.g. the Path after the Origin.
+///         AHR_BufferPoolEndpointKeyFrom(AHR_BufferPoolEndpointKey(a), b) equals the Key of a and b joined.
+///
+uint64_t AHR_BufferPoolEndpointKeyFrom(uint64_t key, const char *url);
+///
+/// \brief  Remember the Size of a Response received from "key".
+///
+void AHR_BufferPoolLearn(AHR_BufferPool_t *pool, uint64_t key, size_t nbytes);
+///
+/// \brief  Expected Response Size for "key", 0 if nothing was learned yet.
+///
+size_t AHR_BufferPoolExpected(const AHR_BufferPool_t *pool, uint64_t key);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
@@ -0,0 +1,120 @@
+///
+/// \brief  This Module implements a packed Header Block.
+///         All Names and Values are stored in one Arena, an Offset Table addresses the single Headers.
+///         The Block grows to the Size of the actual Headers and keeps its Capacity on Reset,
+///         so a reused Block does not allocate Memory once it has seen its largest Header Set.
+///         An open addressing Index over the case-insensitive Name Hashes finds a Header without scanning
+///         the whole Block.
+///
+/// \example    AHR_HeaderBlock_t block = AHR_CreateHeaderBlock();
+///             AHR_HeaderBlockAppend(&block, "ETag", 4, "\"abc\"", 5);
+///             ...
+///             AHR_HeaderView_t view;
+///             AHR_HeaderBlockAt(&block, 0, &view);
+///             ...
+///             AHR_DestroyHeaderBlock(&block);
+///
+#ifndef __AHR_HEADER_BLOCK_H__
+#define __AHR_HEADER_BLOCK_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/ahr_types.h>
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+typedef struct
+{
+    uint32_t name_offset;
+    uint32_t name_len;
+    uint32_t value_offset;
+    uint32_t value_len;
+} AHR_HeaderField_t;
+
+typedef struct
+{
+    char *arena;
+    size_t arena_used;
+    size_t arena_capacity;
+
+    AHR_HeaderField_t *fields;
+    size_t nfields;
+    size_t fields_capacity;
+    ///
+    /// \brief  Slots of the Name Index, 0 if empty. Otherwise the upper 16 Bit hold the upper 16 Bit of the
+    ///         Name Hash and the lower 16 Bit the Field Index + 1. Twice as many Slots as Fields.
+    ///
+    uint32_t *index;
+    size_t index_capacity;
+} AHR_HeaderBlock_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \brief  Create an empty Header Block with a small initial Capacity.
+///
+AHR_HeaderBlock_t AHR_CreateHeaderBlock(void);
+///
+/// \brief  Create a Header Block which reserves no Memory until the first Append.
+///
+AHR_HeaderBlock_t AHR_CreateEmptyHeaderBlock(void);
+///
+/// \brief  Free all Memory owned by the Block.
+///
+void AHR_DestroyHeaderBlock(AHR_HeaderBlock_t *block);
+///
+/// \brief  Remove all Headers. The Capacity is kept.
+///
+void AHR_HeaderBlockReset(AHR_HeaderBlock_t *block);
+///
+/// \brief  Append one Header to the Block.
+/// \returns    true on success.
+///             false if a Limit (AHR_HEADER_NMAX, AHR_HEADERBLOCK_MAX_BYTES, Entry Lengths) would be exceeded
+///             or if no Memory is available. The Block is unchanged in this case.
+///
+bool AHR_HeaderBlockAppend(
+    AHR_HeaderBlock_t *block,
+    const char *name,
+    size_t name_len,
+    const char *value,
+    size_t value_len
+);
+///
+/// \brief  Replace the Contents of the Block with the given Views.
+/// \returns    true if all Headers were stored.
+///
+bool AHR_HeaderBlockAssign(AHR_HeaderBlock_t *block, const AHR_HeaderView_t *header, size_t nheaders);
+///
+/// \brief  Number of Headers in this Block.
+///
+size_t AHR_HeaderBlockSize(const AHR_HeaderBlock_t *block);
+///
+/// \brief  Get a View onto the Header at "index".
+///         The View is valid until the Block is modified or destroyed.
+/// \returns    false if index is out of Range.
+///
+bool AHR_HeaderBlockAt(const AHR_HeaderBlock_t *block, size_t index, AHR_HeaderView_t *header);
+///
+/// \brief  Find a Header by its Name, ignoring Case. If a Name occurs more than once the first Header is 
+///         returned, use AHR_HeaderBlockAt() to visit all of them.
+/// \returns    false if there is no such Header.
+///
+bool AHR_HeaderBlockFind(const AHR_HeaderBlock_t *block, const char *name, size_t name_len, AHR_HeaderView_t *header);
+///
+/// \brief  Number of Bytes currently reserved by the Block.
+///
+size_t AHR_HeaderBlockCapacityBytes(const AHR_HeaderBlock_t *block);
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
@@ -0,0 +1,78 @@
+///
+/// \brief  This Module splits raw HTTP Header Lines into Name and Value.
+///         The Delimiters (':' and the Line End) are searched with SSE2 or AVX2, 16 or 32 Bytes at a Time,
+///         the Scalar Loop only handles the Tail of a Line and Platforms without these Extensions.
+///         AVX2 is selected at Runtime if the CPU supports it.
+///
+/// \example    AHR_HeaderLine_t line;
+///             if(AHR_HEADER_LINE_FIELD == AHR_HeaderParseLine(buffer, nbytes, &line))
+///             {
+///                 AHR_HeaderBlockAppend(&block, buffer, line.name_len, &buffer[line.value_offset], line.value_len);
+///             }
+///
+#ifndef __AHR_HEADER_PARSER_H__
+#define __AHR_HEADER_PARSER_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+typedef enum
+{
+    ///
+    /// \brief  "Name: Value", the Offsets are set.
+    ///
+    AHR_HEADER_LINE_FIELD,
+    ///
+    /// \brief  A Status Line ("HTTP/1.1 200 OK"), it starts a new Header Set.
+    ///
+    AHR_HEADER_LINE_STATUS,
+    ///
+    /// \brief  The empty Line which terminates the Header Section.
+    ///
+    AHR_HEADER_LINE_END,
+    ///
+    /// \brief  A Line without ':' or with an empty Name.
+    ///
+    AHR_HEADER_LINE_INVALID
+} AHR_HeaderLineKind_t;
+
+typedef struct
+{
+    ///
+    /// \brief  The Name starts at Offset 0.
+    ///
+    size_t name_len;
+    ///
+    /// \brief  The Value without leading and trailing Whitespace and without the Line End.
+    ///
+    size_t value_offset;
+    size_t value_len;
+} AHR_HeaderLine_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \brief  Parse one Header Line as delivered by curl, the Line does not have to be NULL-terminated.
+///
+AHR_HeaderLineKind_t AHR_HeaderParseLine(const char *line, size_t nbytes, AHR_HeaderLine_t *field);
+///
+/// \brief  Offset of the first ':' in "data", "nbytes" if there is none. 
+///         "eol" receives the Offset of the first '\r' or '\n', "nbytes" if there is none.
+///         The Search stops at the Line End, a ':' behind it is not reported.
+///
+size_t AHR_HeaderScan(const char *data, size_t nbytes, size_t *eol);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
@@ -0,0 +1,125 @@
+///
+/// \brief  This Module validates a JSON Body and builds a structural Index of it while it arrives.
+///
+///         Stage 1 runs on every Chunk as soon as it was appended to the Response Buffer, while it is
+///         still in the Cache. It classifies 64 Bytes at a Time with SSE2 or AVX2 (selected at Runtime like
+///         in ahr_header_parser.c), masks out everything inside Strings with Bit Arithmetic over the
+///         Quote and Backslash Masks and records the Offset of every structural Character and every
+///         Start of a Scalar.
+///         Stage 2 runs once the Body is complete. It walks the recorded Offsets only, checks the Grammar,
+///         Literals, Numbers, Escapes and UTF-8 of Strings, and writes a Tape of AHR_JsonToken_t.
+///         Containers know the Token behind their Last Child, so a Consumer skips a Value without
+///         looking at its Bytes.
+///
+///         Like a Header Block, the Indexer grows to the largest Body it has seen and keeps its Capacity on Reset.
+///
+/// \example    AHR_JsonIndexer_t indexer = AHR_CreateJsonIndexer();
+///             AHR_JsonIndexerFeed(&indexer, body, nbytes_so_far);
+///             ...
+///             if(AHR_JsonIndexerFinish(&indexer, body, nbytes))
+///             {
+///                 AHR_JsonIndex_t index;
+///                 AHR_JsonIndexerView(&indexer, body, nbytes, &index);
+///             }
+///             AHR_DestroyJsonIndexer(&indexer);
+///
+#ifndef __AHR_JSON_INDEX_H__
+#define __AHR_JSON_INDEX_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/ahr_types.h>
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+typedef struct
+{
+    ///
+    /// \brief  Offsets of structural Characters and Scalar Starts found by Stage 1.
+    ///
+    uint32_t *positions;
+    size_t npositions;
+    size_t positions_capacity;
+    ///
+    /// \brief  The Tape written by Stage 2.
+    ///
+    AHR_JsonToken_t *tokens;
+    size_t ntokens;
+    size_t tokens_capacity;
+    ///
+    /// \brief  Tokens of the open Containers while Stage 2 runs.
+    ///
+    uint32_t *stack;
+    size_t stack_capacity;
+
+    ///
+    /// \brief  Body Bytes Stage 1 has consumed, always a Multiple of 64 until the Body is finished.
+    ///
+    size_t scanned;
+    ///
+    /// \brief  State carried from one 64 Byte Block into the next.
+    ///
+    uint64_t escaped;
+    uint64_t in_string;
+    uint64_t scalar;
+    ///
+    /// \brief  Set once a Block had an unescaped Control Character inside a String.
+    ///
+    bool control;
+    ///
+    /// \brief  The Body is too large to be indexed or Memory ran out, the Index is given up.
+    ///
+    bool failed;
+    bool finished;
+    bool valid;
+    size_t error_offset;
+} AHR_JsonIndexer_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \brief  Create an Indexer which reserves no Memory until the first Body.
+///
+AHR_JsonIndexer_t AHR_CreateJsonIndexer(void);
+///
+/// \brief  Free all Memory owned by the Indexer.
+///
+void AHR_DestroyJsonIndexer(AHR_JsonIndexer_t *indexer);
+///
+/// \brief  Start a new Body. The Capacity is kept.
+///
+void AHR_JsonIndexerReset(AHR_JsonIndexer_t *indexer);
+///
+/// \brief  Heap Bytes held by the Indexer.
+///
+size_t AHR_JsonIndexerCapacityBytes(const AHR_JsonIndexer_t *indexer);
+///
+/// \brief  Run Stage 1 over all whole 64 Byte Blocks of the first "nbytes" Bytes of "body" which were
+///         not seen yet. "body" may move between Calls (f.e. when the Buffer grows), only Offsets are kept.
+///
+void AHR_JsonIndexerFeed(AHR_JsonIndexer_t *indexer, const char *body, size_t nbytes);
+///
+/// \brief  Run Stage 1 over the Rest of the Body and Stage 2 over the whole Body.
+/// \returns    true if "body" is valid JSON, see AHR_JsonIndexerView().
+///
+bool AHR_JsonIndexerFinish(AHR_JsonIndexer_t *indexer, const char *body, size_t nbytes);
+///
+/// \brief  View onto the Tape of a finished Body.
+/// \returns    false if the Body was not finished or is not valid JSON, "index->error_offset" tells where.
+///
+bool AHR_JsonIndexerView(const AHR_JsonIndexer_t *indexer, const char *body, size_t nbytes, AHR_JsonIndex_t *index);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
@@ -1,9 +1,19 @@
 ///
 /// \brief  This Module implements logging.
 ///
+///         Logging is asynchronous. Each Thread which logs owns a Ring of Records, a Record holds the Format
+///         String and the captured Arguments only. Formatting and the Callbacks run when the Rings are drained,
+///         either by the Drain Thread of the Logger or by AHR_LoggerFlush(). The Thread which logs never blocks
+///         and never calls back into the User, if its Ring is full the Message is dropped and counted.
+///         When a Thread exits, its Ring is handed to the next Thread which logs for the first Time, so the
+///         Rings follow the most Threads logging at once and not every Thread that ever logged.
+///
+///         Format Strings must outlive the Logger (String Literals), "%s" Arguments are copied.
+///         The AHR_LOG_* Macros remove Messages above AHR_LOG_COMPILE_LEVEL at Compile Time.
+///
 /// \example    AHR_Logger_t logger = AHR_CreateLogger(...);
 ///             ...
-///             AHR_LogInfo(logger, "Success!");
+///             AHR_LOG_INFO(logger, "Object %zu done, Status %ld.", object, status_code);
 ///             ...
 ///             AHR_DestroyLogger(&logger);
 ///             assert(NULL == logger);
@@ -18,6 +28,7 @@
 #include <async_http_requests/ahr_types.h>
 
 #include <stddef.h>
+#include <stdbool.h>
 
 //
 // --------------------------------------------------------------------------------------------------------------------
@@ -27,6 +38,37 @@
 #define AHR_LOGLEVEL_WARNING 1U
 #define AHR_LOGLEVEL_ERROR 0U
 
+///
+/// \brief  Highest Level compiled into libahr, set through the CMake Cache Variable AHR_LOG_LEVEL.
+///
+#ifndef AHR_LOG_COMPILE_LEVEL
+#define AHR_LOG_COMPILE_LEVEL AHR_LOGLEVEL_INFO
+#endif
+
+///
+/// \brief  AHR_LOG_*(logger, format, ...) log a printf-style Message, see AHR_LogFormat().
+///         Removed Messages are still type checked, but no Code is generated for them.
+///
+#if AHR_LOG_COMPILE_LEVEL >= AHR_LOGLEVEL_INFO
+#define AHR_LOG_INFO(...) AHR_LogFormat(AHR_LOGLEVEL_INFO, __VA_ARGS__)
+#else
+#define AHR_LOG_INFO(...) do { if(0) { AHR_LogFormat(AHR_LOGLEVEL_INFO, __VA_ARGS__); } } while(0)
+#endif
+
+#if AHR_LOG_COMPILE_LEVEL >= AHR_LOGLEVEL_WARNING
+#define AHR_LOG_WARNING(...) AHR_LogFormat(AHR_LOGLEVEL_WARNING, __VA_ARGS__)
+#else
+#define AHR_LOG_WARNING(...) do { if(0) { AHR_LogFormat(AHR_LOGLEVEL_WARNING, __VA_ARGS__); } } while(0)
+#endif
+
+#define AHR_LOG_ERROR(...) AHR_LogFormat(AHR_LOGLEVEL_ERROR, __VA_ARGS__)
+
+///
+/// \brief  Records a Thread can queue before Messages are dropped.
+///
+#define AHR_LOG_DEFAULT_RING_CAPACITY 256U
+#define AHR_LOG_DEFAULT_DRAIN_INTERVAL_MS 10U
+
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
@@ -35,12 +77,36 @@ typedef void (*AHR_LogInfo_t)(void *arg, const char *str);
 typedef void (*AHR_LogWarning_t)(void *arg, const char *str);
 typedef void (*AHR_LogError_t)(void *arg, const char *str);
 
+typedef struct
+{
+    ///
+    /// \brief  User data, passed to each call of "info", "warning" and "error".
+    ///
+    void *arg;
+    AHR_LogInfo_t info;
+    AHR_LogWarning_t warning;
+    AHR_LogError_t error;
+    ///
+    /// \brief  Records per Thread, rounded up to a Power of Two. 0 for AHR_LOG_DEFAULT_RING_CAPACITY.
+    ///
+    size_t ring_capacity;
+    ///
+    /// \brief  Period of the Drain Thread, 0 for AHR_LOG_DEFAULT_DRAIN_INTERVAL_MS.
+    ///
+    size_t drain_interval_ms;
+    ///
+    /// \brief  Do not start a Drain Thread, the Owner calls AHR_LoggerFlush() (f.e. from an Event Loop).
+    ///
+    bool manual_flush;
+} AHR_LoggerOptions_t;
+
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
 ///
-/// \brief  Create a Logger object. Each Logger object created with this function must be destroyed 
+/// \brief  Create a Logger object. Each Logger object created with this function must be destroyed
 ///         with a call to AHR_DestroyLogger() in case it is no longer needed.
+///         The Callbacks are called from the Drain Thread of the Logger.
 /// \param[in] arg      - User data, passed to each call of "info", "warning" and "error".
 /// \param[in] info     - Info Callback.
 /// \param[in] warning  - Warning Callback.
@@ -53,11 +119,31 @@ AHR_Logger_t AHR_CreateLogger(
     AHR_LogError_t error
 );
 ///
-/// \brief  Destroy Logger object.
+/// \brief  Create a Logger object, see AHR_LoggerOptions_t.
+///
+AHR_Logger_t AHR_CreateLoggerWithOptions(const AHR_LoggerOptions_t *options);
+///
+/// \brief  Destroy Logger object. Stops the Drain Thread and delivers all queued Messages.
+///         No other Thread may log through this Logger anymore.
 /// \post   After a call to this function *logger == NULL.
 ///
 void AHR_DestroyLogger(AHR_Logger_t *logger);
 ///
+/// \brief  Format all queued Messages and pass them to the Callbacks on the calling Thread.
+///         Messages of one Thread keep their Order, Messages of different Threads are not ordered.
+///
+void AHR_LoggerFlush(AHR_Logger_t logger);
+///
+/// \brief  Messages dropped since the Logger was created because a Ring was full.
+///
+size_t AHR_LoggerDropped(AHR_Logger_t logger);
+///
+/// \brief  Queue a printf-style Message. Supports the Conversions of C99 except "%n",
+///         at most 12 Arguments are captured, the Rest of the Format is passed on verbatim.
+///
+void AHR_LogFormat(size_t loglevel, AHR_Logger_t logger, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+///
 /// \brief  Infolog.
 ///
 void AHR_LogInfo(AHR_Logger_t logger, const char *msg);
@@ -0,0 +1,143 @@
+///
+/// \brief  This Module counts what a Processor does, without Locks on the Path of a Request.
+///
+///         Every Counter has exactly one Writer. Submissions are counted by the Thread which holds the Mutex of
+///         the Processor, everything else by the Processors Thread. Both sets of Counters live on their own
+///         Cache Lines, so neither Writer invalidates the Lines of the other one, and a Writer only loads and
+///         stores (no locked Read-Modify-Write). Readers take Snapshots with relaxed Loads at any Time.
+///
+///         Latencies are kept in one HDR Histogram per Origin: 32 linear Sub-Buckets for Values below 32 us,
+///         above that 16 Sub-Buckets per Power of Two, which bounds the relative Error to 1/16.
+///
+/// \example    AHR_Metrics_t *metrics = AHR_CreateMetrics();
+///             AHR_MetricsSubmitted(metrics);
+///             ...
+///             AHR_MetricsSnapshot_t snapshot;
+///             AHR_MetricsTakeSnapshot(metrics, &snapshot);
+///             AHR_DestroyMetrics(&metrics);
+///
+#ifndef __AHR_METRICS_H__
+#define __AHR_METRICS_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/ahr_types.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_METRICS_SUB_BUCKETS 32U
+#define AHR_METRICS_HALF_BUCKETS (AHR_METRICS_SUB_BUCKETS / 2U)
+///
+/// \brief  Largest recorded Latency, larger ones are clamped (about 19 Hours).
+///
+#define AHR_METRICS_MAX_VALUE_US ((UINT64_C(1) << 36U) - 1U)
+///
+/// \brief  32 linear Buckets, then 16 for each of the Powers of Two 2^5 to 2^35.
+///
+#define AHR_METRICS_HISTOGRAM_BUCKETS (AHR_METRICS_SUB_BUCKETS + 31U * AHR_METRICS_HALF_BUCKETS)
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+typedef struct
+{
+    ///
+    /// \brief  0 while the Slot is free, published after "origin" was written.
+    ///
+    atomic_ullong key;
+    char origin[AHR_METRICS_ORIGIN_LEN]; // flawfinder: ignore
+    atomic_ullong sum_us;
+    atomic_ullong max_us;
+    atomic_ullong buckets[AHR_METRICS_HISTOGRAM_BUCKETS];
+} AHR_MetricsOrigin_t;
+
+typedef struct
+{
+    ///
+    /// \brief  Written while holding the Mutex of the Processor.
+    ///
+    _Alignas(64) atomic_ullong submitted;
+    ///
+    /// \brief  Written by the Processors Thread only.
+    ///
+    _Alignas(64) atomic_ullong dequeued;
+    atomic_ullong completed[AHR_METRICS_STATUS_CLASSES];
+    atomic_ullong failed[AHR_FAILURE_CLASSES];
+    atomic_ullong bytes_in;
+    atomic_ullong bytes_out;
+    atomic_ullong connections_opened;
+    atomic_ullong connections_reused;
+    ///
+    /// \brief  The last Slot collects all Origins which do not fit.
+    ///
+    _Alignas(64) AHR_MetricsOrigin_t origins[AHR_METRICS_MAX_ORIGINS];
+} AHR_Metrics_t;
+
+///
+/// \brief  What the Processors Thread knows about a finished Transfer.
+///
+typedef struct
+{
+    ///
+    /// \brief  URL of the Transfer, only its Origin is used.
+    ///
+    const char *url;
+    uint64_t latency_us;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+    ///
+    /// \brief  Connections the Transfer opened, 0 if it reused one.
+    ///
+    uint64_t new_connections;
+} AHR_MetricsTransfer_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \returns    Zeroed Metrics, NULL if no Memory is available.
+///
+AHR_Metrics_t* AHR_CreateMetrics(void);
+void AHR_DestroyMetrics(AHR_Metrics_t **metrics);
+///
+/// \brief  A Request was queued. Only call this while holding the Mutex of the Processor.
+///
+void AHR_MetricsSubmitted(AHR_Metrics_t *metrics);
+///
+/// \brief  The Processors Thread took a Request from the Queue.
+///
+void AHR_MetricsDequeued(AHR_Metrics_t *metrics);
+///
+/// \brief  A Transfer ended with a Response, called from the Processors Thread.
+///
+void AHR_MetricsCompleted(AHR_Metrics_t *metrics, size_t status_code, const AHR_MetricsTransfer_t *transfer);
+///
+/// \brief  A Transfer ended without a Response, called from the Processors Thread.
+///
+void AHR_MetricsFailed(AHR_Metrics_t *metrics, AHR_FailureClass_t failure, const AHR_MetricsTransfer_t *transfer);
+///
+/// \brief  Copy all Counters and compute the Quantiles of each Origin. May run concurrently to the Writers,
+///         each Counter is consistent, the Snapshot as a whole is not.
+///
+void AHR_MetricsTakeSnapshot(const AHR_Metrics_t *metrics, AHR_MetricsSnapshot_t *snapshot);
+///
+/// \brief  Render the Metrics in the Prometheus Text Format (Version 0.0.4), Latencies as Histograms in Seconds.
+///         Bucket Bounds are resolved to the Precision of the HDR Histogram.
+/// \returns    Length of the Text without Terminator, -1 if it does not fit into "nbytes" Bytes including the Terminator.
+///
+int64_t AHR_MetricsPrometheus(const AHR_Metrics_t *metrics, char *buffer, size_t nbytes);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
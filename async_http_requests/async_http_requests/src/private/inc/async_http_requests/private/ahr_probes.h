@@ -0,0 +1,54 @@
+///
+/// \brief  Static Tracepoints (USDT) of libahr, for bpftrace, perf and SystemTap.
+///
+///         Built with -DAHR_WITH_USDT=ON each Probe is a single nop in the Code and a Note in the ELF, it costs
+///         nothing until a Tracer attaches. Without the Option the Macros expand to nothing.
+///         All Probes belong to the Provider "ahr", see probes/ for Scripts which use them.
+///
+///         The "response" Argument identifies a Transfer across Probes, it is the Address of the Response
+///         Object and stays the same for an Object over all its Transfers.
+///
+///         request__submit       (object, response, submit_ns)   AHR_ProcessorMakeRequest() queued the Request.
+///         request__dequeue      (object, response, queued_ns)   The Processors Thread took it from the Queue.
+///         request__start        (object, response, url)         It was added to the curl multi Handle.
+///         request__first__byte  (response)                      The first Header Line of the Response arrived.
+///         request__done         (object, response, status, latency_ns)
+///         request__error        (object, response, curl_code, latency_ns)
+///         callback__entry       (object, callback)              "callback" is the Name of the User Callback.
+///         callback__return      (object, callback)
+///         mutex__contended      (mutex)                         AHR_MutexLock() found the Mutex taken.
+///         mutex__acquired       (mutex, spins)                  ... and got it after "spins" failed Tries.
+///
+#ifndef __AHR_PROBES_H__
+#define __AHR_PROBES_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#if defined(AHR_WITH_USDT)
+
+#include <sys/sdt.h>
+
+#define AHR_PROBE1(name, a) DTRACE_PROBE1(ahr, name, a)
+#define AHR_PROBE2(name, a, b) DTRACE_PROBE2(ahr, name, a, b)
+#define AHR_PROBE3(name, a, b, c) DTRACE_PROBE3(ahr, name, a, b, c)
+#define AHR_PROBE4(name, a, b, c, d) DTRACE_PROBE4(ahr, name, a, b, c, d)
+
+#else
+
+//
+// The Arguments are not evaluated, sizeof only keeps them from being reported as unused.
+//
+#define AHR_PROBE1(name, a) do { (void)sizeof(a); } while(0)
+#define AHR_PROBE2(name, a, b) do { (void)sizeof(a); (void)sizeof(b); } while(0)
+#define AHR_PROBE3(name, a, b, c) do { (void)sizeof(a); (void)sizeof(b); (void)sizeof(c); } while(0)
+#define AHR_PROBE4(name, a, b, c, d) do { (void)sizeof(a); (void)sizeof(b); (void)sizeof(c); (void)sizeof(d); } while(0)
+
+#endif
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
@@ -0,0 +1,69 @@
+///
+/// \brief  This Module writes the Traffic Records of a Processor, see ahr_record.h for the Format.
+///
+///         Records are encoded into a Buffer and written in Blocks, once the Buffer is nearly full or the
+///         last Write is a Second ago, so Recording costs no System Call per Request. Templates are defined once
+///         and referenced by their Number afterwards, they are looked up by a 64 bit Hash.
+///
+///         Only one Thread may add Records at a Time, the Processors Thread.
+///         AHR_RecorderFlush() and AHR_DestroyRecorder() are called once it stopped.
+///
+/// \example    AHR_Recorder_t *recorder = AHR_CreateRecorder("ahr.rec");
+///             record.submit_us = (submit_ns - AHR_RecorderStartNs(recorder)) / 1000U;
+///             AHR_RecorderAdd(recorder, &record);
+///             ...
+///             AHR_DestroyRecorder(&recorder);
+///
+#ifndef __AHR_RECORDER_H__
+#define __AHR_RECORDER_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/ahr_record.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+struct AHR_Recorder;
+typedef struct AHR_Recorder AHR_Recorder_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \brief  Create or truncate the File at "path" and write the Header.
+/// \returns    NULL if "path" is NULL or the File can not be written.
+///
+AHR_Recorder_t* AHR_CreateRecorder(const char *path);
+///
+/// \brief  Write what is buffered and close the File.
+/// \post   *recorder == NULL
+///
+void AHR_DestroyRecorder(AHR_Recorder_t **recorder);
+///
+/// \brief  CLOCK_MONOTONIC in Nanoseconds at Creation, Submit Times are counted from here.
+///
+uint64_t AHR_RecorderStartNs(const AHR_Recorder_t *recorder);
+///
+/// \brief  Append "record". "record->url_template" must already be a Template, see AHR_RecordUrlTemplate().
+/// \returns    false if writing failed now, the Recorder drops all further Records then.
+///
+bool AHR_RecorderAdd(AHR_Recorder_t *recorder, const AHR_Record_t *record);
+///
+/// \brief  Write what is buffered.
+/// \returns    false if writing failed, now or before.
+///
+bool AHR_RecorderFlush(AHR_Recorder_t *recorder);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
@@ -6,7 +6,11 @@
 //
 
 #include <async_http_requests/private/ahr_async_http_requests.h>
+#include <async_http_requests/private/ahr_trace.h>
 #include <async_http_requests/ahr_types.h>
+#include <external/async_http_requests/ahr_file.h>
+#include <external/async_http_requests/ahr_compression.h>
+#include <external/async_http_requests/ahr_arena.h>
 
 #include <stdatomic.h>
 
@@ -21,8 +25,56 @@ typedef struct
 
     AHR_RequestData_t request_data;
     AHR_UserData_t user_data;
+    ///
+    /// \brief  Body of the current Transfer, either borrowed from the Caller or pointing to request_data.body.
+    ///
+    AHR_BodyDescriptor_t body;
+    ///
+    /// \brief  Pull-style Body of the current Transfer, used if "provider.read" is set.
+    ///
+    AHR_BodyProvider_t provider;
+    ///
+    /// \brief  File the Body of the current Transfer is read from, if any.
+    ///
+    AHR_FileReader_t file_source;
+    ///
+    /// \brief  Compresses the Body, its Contexts are kept from Transfer to Transfer.
+    ///
+    AHR_Compressor_t compressor;
+    ///
+    /// \brief  Content-Encoding of the current Body, 0 if it is sent as is.
+    ///         For a Body in Memory its Size before and after Compression, a streamed Body is counted by the Compressor.
+    ///
+    unsigned int body_encoding;
+    uint64_t body_uncompressed;
+    uint64_t body_compressed;
+    ///
+    /// \brief  Read Position in "body" while a Body in Memory is compressed as a Stream.
+    ///
+    size_t body_offset;
+    ///
+    /// \brief  Index of this Result in its Store.
+    ///
+    size_t object;
 
     atomic_int busy;
+    ///
+    /// \brief  Set by AHR_ProcessorResumeResponse(), consumed by the Processors Thread.
+    ///
+    atomic_int resume;
+    ///
+    /// \brief  true while the Transfer is paused by on_data. Only used by the Processors Thread.
+    ///
+    bool paused;
+    ///
+    /// \brief  Phase Timestamps of the current Transfer, reset by AHR_ProcessorMakeRequest().
+    ///
+    AHR_RequestTimings_t timings;
+    ///
+    /// \brief  Tracer of the Processor, NULL while Tracing is off. "trace_id" identifies the current Transfer.
+    ///
+    AHR_Tracer_t *tracer;
+    uint64_t trace_id;
 } AHR_Result_t;
 
 typedef struct
@@ -30,14 +82,36 @@ typedef struct
     atomic_int *current_state_of_result;
     AHR_Result_t *results;
     size_t nresults;
+    ///
+    /// \brief  false if "results" lives in an Arena.
+    ///
+    bool owns_results;
 } AHR_ResultStore_t;
 
 
 AHR_ResultStore_t AHR_CreateResultStore(size_t max_size);
+///
+/// \brief  Create a Result Store whose Results are taken from "arena".
+///         "results" is NULL if the Arena is exhausted.
+///
+AHR_ResultStore_t AHR_CreateResultStoreInArena(AHR_Arena_t *arena, size_t max_size);
+///
+/// \brief  Arena Bytes needed by AHR_CreateResultStoreInArena().
+///
+size_t AHR_ResultStoreArenaBytes(size_t max_size);
 void AHR_DestroyResultStore(AHR_ResultStore_t *store);
 AHR_Result_t* AHR_ResultStoreGetResult(AHR_ResultStore_t *store, size_t index);
 size_t AHR_ResultStoreSize(const AHR_ResultStore_t *store);
 size_t AHR_ResultStoreObjectIndex(const AHR_ResultStore_t *store, const AHR_Result_t *result);
+///
+/// \brief  Set the Body for the next Transfer. A previously set Body Descriptor is released first.
+///
+void AHR_ResultSetBody(AHR_Result_t *result, const AHR_BodyDescriptor_t *body);
+///
+/// \brief  Give the Body back to its Owner by calling its Release Callback, if any, 
+///         and close the File the Body was read from.
+///
+void AHR_ResultReleaseBody(AHR_Result_t *result);
 
 //
 // --------------------------------------------------------------------------------------------------------------------
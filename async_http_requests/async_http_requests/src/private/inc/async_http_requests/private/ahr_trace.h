@@ -0,0 +1,103 @@
+///
+/// \brief  This Module records Trace Events of a Processor and writes them as Chrome Trace JSON.
+///
+///         Each Thread which records owns a Ring of Events, an Event is a raw Timestamp, a Name and an Id.
+///         Timestamps are read from the TSC (rdtsc) on x86, elsewhere from CLOCK_MONOTONIC, and converted to
+///         Microseconds only when the Trace is written. The TSC is assumed to be invariant and synchronized
+///         between Cores, as it is on all current x86 CPUs.
+///
+///         Recording never blocks and never allocates, except for the first Event of a Thread. If a Ring is
+///         full the Event is dropped and counted. AHR_TraceDump() consumes the Events it writes.
+///
+///         Every Function accepts a NULL Tracer and does nothing, so Tracing costs one Branch while it is off.
+///
+/// \example    AHR_Tracer_t *tracer = AHR_CreateTracer(65536);
+///             AHR_TraceNameThread(tracer, "ahr io");
+///             AHR_TraceBegin(tracer, "poll", AHR_TRACE_NO_OBJECT);
+///             ...
+///             AHR_TraceEnd(tracer, "poll", AHR_TRACE_NO_OBJECT);
+///             AHR_TraceDump(tracer, fd);
+///             AHR_DestroyTracer(&tracer);
+///
+#ifndef __AHR_TRACE_H__
+#define __AHR_TRACE_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_TRACE_NO_OBJECT UINT32_MAX
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+struct AHR_Tracer;
+typedef struct AHR_Tracer AHR_Tracer_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \brief  Create a Tracer, "capacity" Events per Thread are rounded up to a Power of Two.
+///         Calibrates the TSC against CLOCK_MONOTONIC, which takes about 2 ms.
+/// \returns    NULL if "capacity" is 0 or no Memory is available.
+///
+AHR_Tracer_t* AHR_CreateTracer(size_t capacity);
+///
+/// \brief  No Thread may record through the Tracer anymore.
+/// \post   *tracer == NULL
+///
+void AHR_DestroyTracer(AHR_Tracer_t **tracer);
+///
+/// \brief  Current Timestamp in Ticks.
+///
+uint64_t AHR_TraceNow(void);
+///
+/// \brief  Convert a Duration from Microseconds to Ticks, f.e. to place the Phases curl reports.
+///
+uint64_t AHR_TraceTicksFromUs(const AHR_Tracer_t *tracer, uint64_t us);
+///
+/// \brief  Name the calling Thread in the Trace. "name" must outlive the Tracer (String Literal).
+///
+void AHR_TraceNameThread(AHR_Tracer_t *tracer, const char *name);
+///
+/// \brief  Begin / end a Slice on the calling Thread. Slices of one Thread must nest.
+///         "name" must outlive the Tracer (String Literal).
+///
+void AHR_TraceBegin(AHR_Tracer_t *tracer, const char *name, uint32_t object);
+void AHR_TraceEnd(AHR_Tracer_t *tracer, const char *name, uint32_t object);
+///
+/// \brief  Begin / end an asynchronous Slice at "ticks", it may end on another Thread than it began.
+///         Slices with the same "id" form one Track, see AHR_TraceNextId().
+///
+void AHR_TraceAsyncBegin(AHR_Tracer_t *tracer, const char *name, uint64_t id, uint32_t object, uint64_t ticks);
+void AHR_TraceAsyncEnd(AHR_Tracer_t *tracer, const char *name, uint64_t id, uint32_t object, uint64_t ticks);
+///
+/// \brief  A new Id for asynchronous Slices, 0 if "tracer" is NULL.
+///
+uint64_t AHR_TraceNextId(AHR_Tracer_t *tracer);
+///
+/// \brief  Events dropped since the Tracer was created because a Ring was full.
+///
+size_t AHR_TraceDropped(const AHR_Tracer_t *tracer);
+///
+/// \brief  Write all recorded Events to "fd" as Chrome Trace JSON (chrome://tracing, ui.perfetto.dev)
+///         and remove them from the Rings. May run concurrently to Threads which record.
+/// \returns    false if "tracer" is NULL or writing to "fd" failed.
+///
+bool AHR_TraceDump(AHR_Tracer_t *tracer, int fd);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
@@ -5,11 +5,18 @@
 
 #include <async_http_requests/ahr_types.h>
 #include <async_http_requests/private/ahr_async_http_requests.h>
+#include <async_http_requests/private/ahr_header_block.h>
+#include <async_http_requests/private/ahr_header_parser.h>
+#include <async_http_requests/private/ahr_json_index.h>
 #include <external/async_http_requests/ahr_curl.h>
+#include <external/async_http_requests/ahr_file.h>
+#include <external/async_http_requests/ahr_arena.h>
+#include <async_http_requests/private/ahr_buffer_pool.h>
+#include <async_http_requests/private/ahr_probes.h>
 
 #include <stdio.h>
 #include <string.h>
-#include <ctype.h>
+#include <strings.h>
 #include <assert.h>
 
 #include <curl/curl.h>
@@ -18,6 +25,13 @@
 // --------------------------------------------------------------------------------------------------------------------
 //
 
+#define AHR_REQUEST_URL_SIZE ((size_t)4096)
+#define AHR_RESPONSE_BODY_SIZE ((size_t)(4096 * 64))
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
 typedef struct
 {
     char *data;
@@ -29,15 +43,33 @@ struct AHR_HttpRequest
 {
     void *uuid;
 
+    ///
+    /// \brief  Download Target of the Response Body, -1 if the Body is buffered.
+    ///
     int file_descriptor;
+    AHR_FileWriter_t file_writer;
     char *url;
     AHR_Curl_t handle;
 
     AHR_Logger_t logger;
 
-    AHR_Body_t body;
-
-    struct curl_slist *http_header;
+    AHR_HeaderBlock_t header;
+    ///
+    /// \brief  Parsed Base URL and its Path without trailing '/', NULL if the Request is not bound.
+    ///         "base_key" hashes Origin and Base Path like AHR_BufferPoolEndpointKey().
+    ///
+    AHR_CurlUrl_t base_url;
+    char *base_path;
+    size_t base_path_len;
+    uint64_t base_key;
+    ///
+    /// \brief  true if the next Transfer goes to "base_url", its Path was set through AHR_RequestSetPath().
+    ///
+    bool use_base;
+    ///
+    /// \brief  true if the Object and its Buffers live in an Arena and must not be freed.
+    ///
+    bool in_arena;
 };
 
 struct AHR_HttpResponse
@@ -45,7 +77,43 @@ struct AHR_HttpResponse
     AHR_Body_t body;
     AHR_HttpRequest_t request;
     AHR_Logger_t logger;
-    AHR_Header_t header;
+    AHR_HeaderBlock_t header;
+    ///
+    /// \brief  Names of the Headers to store, empty to store all. Only Names, the Values are empty.
+    ///
+    AHR_HeaderBlock_t header_filter;
+
+    AHR_ResponseDataSink_t sink;
+    void *sink_user;
+    bool in_arena;
+    ///
+    /// \brief  If set, the Body Buffer is borrowed from "pool" when the first Chunk arrives and grows 
+    ///         by Size Class. Otherwise the Response owns a fixed Buffer of AHR_RESPONSE_BODY_SIZE Bytes.
+    ///
+    AHR_BufferPool_t *pool;
+    AHR_BufferCache_t *cache;
+    uint64_t endpoint;
+    bool grown;
+    ///
+    /// \brief  The Body Size of the borrowed Buffer was already learned, see AHR_ResponseLearnBodySize().
+    ///
+    bool learned;
+    ///
+    /// \brief  Decoded Body Bytes so far and their Limit, 0 for none.
+    ///
+    uint64_t decoded_bytes;
+    size_t max_decoded_bytes;
+    bool encoded;
+    bool limit_exceeded;
+    ///
+    /// \brief  Set by the first Header Line of a Transfer, for the Probe request__first__byte.
+    ///
+    bool first_byte;
+    ///
+    /// \brief  Structural JSON Index, fed with every Chunk appended to "body".
+    ///
+    AHR_JsonIndexer_t json;
+    bool index_json;
 };
 
 //
@@ -54,6 +122,21 @@ struct AHR_HttpResponse
 
 static size_t AHR_WriteCallback(char *data, size_t size, size_t nmemb, void *clientp);
 static size_t AHR_HeaderCallback(char *buffer, size_t size, size_t nitems, void *userdata);
+///
+/// \brief  Allocate zeroed Memory from "arena", or from the Heap if "arena" is NULL.
+///
+static void* AHR_Allocate(AHR_Arena_t *arena, size_t nbytes);
+static AHR_HttpResponse_t AHR_CreateResponseWithPool(AHR_Arena_t *arena, AHR_BufferPool_t *pool, AHR_BufferCache_t *cache);
+///
+/// \brief  Copy "url" as Target of the next Transfer, NULL keeps the Path set through AHR_RequestSetPath().
+///
+static void AHR_RequestCopyUrl(AHR_HttpRequest_t request, const char *url);
+///
+/// \brief  Make room for "nbytes" more Bytes of Body by borrowing a larger Buffer from the Pool.
+///         The first Buffer is presized from the Content-Length or the learned Size of the Endpoint.
+/// \returns    false if the Response has no Pool or the Body exceeds the largest Buffer.
+///
+static bool AHR_ResponseGrowBody(AHR_HttpResponse_t response, size_t nbytes);
 
 //
 // --------------------------------------------------------------------------------------------------------------------
@@ -66,24 +149,63 @@ AHR_Curl_t AHR_RequestHandle(AHR_HttpRequest_t request)
 
 AHR_HttpResponse_t AHR_CreateResponse(void)
 {
-    struct AHR_HttpResponse* response = malloc(sizeof(struct AHR_HttpResponse));
+    return AHR_CreateResponseInArena(NULL);
+}
+
+AHR_HttpResponse_t AHR_CreateResponseInArena(AHR_Arena_t *arena)
+{
+    return AHR_CreateResponseWithPool(arena, NULL, NULL);
+}
+
+AHR_HttpResponse_t AHR_CreateResponseForPool(AHR_Arena_t *arena, AHR_BufferPool_t *pool, AHR_BufferCache_t *cache)
+{
+    assert(NULL != pool);
+    return AHR_CreateResponseWithPool(arena, pool, cache);
+}
+
+size_t AHR_ResponsePoolArenaBytes(void)
+{
+    return AHR_ArenaAlignedSize(sizeof(struct AHR_HttpResponse));
+}
+
+static AHR_HttpResponse_t AHR_CreateResponseWithPool(AHR_Arena_t *arena, AHR_BufferPool_t *pool, AHR_BufferCache_t *cache)
+{
+    struct AHR_HttpResponse* response = AHR_Allocate(arena, sizeof(struct AHR_HttpResponse));
     if(!response)
     {
         return NULL;
     }
-
-    static const size_t nbytes = 4096 * 64;
-    response->body.data = malloc(nbytes);
+    response->in_arena = NULL != arena;
+    response->request = NULL;
+    response->logger = NULL;
+    response->header = AHR_CreateHeaderBlock();
+    response->header_filter = AHR_CreateEmptyHeaderBlock();
+    response->sink = NULL;
+    response->sink_user = NULL;
+    response->pool = pool;
+    response->cache = cache;
+    response->endpoint = 0;
+    response->grown = false;
+    response->learned = false;
+    response->decoded_bytes = 0;
+    response->max_decoded_bytes = 0;
+    response->encoded = false;
+    response->limit_exceeded = false;
+    response->json = AHR_CreateJsonIndexer();
+    response->index_json = false;
+    response->body.nbytes = 0;
+    response->body.maxbytes = 0;
+    response->body.data = NULL;
+    if(pool)
+    {
+        return response;
+    }
+    response->body.maxbytes = AHR_RESPONSE_BODY_SIZE;
+    response->body.data = AHR_Allocate(arena, AHR_RESPONSE_BODY_SIZE);
     if(!response->body.data)
     {
         goto on_error;
     }
-    response->body.maxbytes = nbytes;
-    memset(response->body.data, '\0', nbytes);
-    response->request = NULL;
-    response->logger = NULL;
-    memset(&response->header, '\0', sizeof(response->header));
-
     return response;
 
     on_error:
@@ -93,34 +215,43 @@ AHR_HttpResponse_t AHR_CreateResponse(void)
 
 AHR_HttpRequest_t AHR_CreateRequest(void)
 {
-    struct AHR_HttpRequest* request = malloc(sizeof(struct AHR_HttpRequest));
+    return AHR_CreateRequestInArena(NULL);
+}
+
+AHR_HttpRequest_t AHR_CreateRequestInArena(AHR_Arena_t *arena)
+{
+    struct AHR_HttpRequest* request = AHR_Allocate(arena, sizeof(struct AHR_HttpRequest));
     if(!request)
     {
         return NULL;
     }
-    request->url = malloc(4096);
+    request->in_arena = NULL != arena;
+    request->logger = NULL;
+    request->file_descriptor = -1;
+    request->file_writer = AHR_CreateFileWriter();
+    request->header = AHR_CreateHeaderBlock();
+    request->uuid = request;
+    request->handle = NULL;
+    request->base_url = NULL;
+    request->base_path = NULL;
+    request->base_path_len = 0;
+    request->base_key = 0;
+    request->use_base = false;
+    request->url = AHR_Allocate(arena, AHR_REQUEST_URL_SIZE);
     if(!request->url)
     {
         goto on_error;
     }
-    memset(request->url, '\0', 4096);
-
-    const size_t nbytes = 4096 * 4;
-    request->body.data = malloc(nbytes);
-    if(!request->body.data)
-    {
-        goto on_error;
-    }
-    request->body.maxbytes = nbytes;
-    request->body.nbytes = nbytes;
-    memset(request->body.data, '\0', nbytes);
     
     // curl stuff...
     request->handle = AHR_CurlEasyInit(
         AHR_WriteCallback,
         AHR_HeaderCallback
     );
-    request->uuid = request;
+    if(!request->handle)
+    {
+        goto on_error;
+    }
     return request;
 
     on_error:
@@ -128,6 +259,36 @@ AHR_HttpRequest_t AHR_CreateRequest(void)
     return NULL;
 }
 
+size_t AHR_RequestArenaBytes(void)
+{
+    return AHR_ArenaAlignedSize(sizeof(struct AHR_HttpRequest)) + AHR_ArenaAlignedSize(AHR_REQUEST_URL_SIZE);
+}
+
+size_t AHR_ResponseArenaBytes(void)
+{
+    return AHR_ArenaAlignedSize(sizeof(struct AHR_HttpResponse)) + AHR_ArenaAlignedSize(AHR_RESPONSE_BODY_SIZE);
+}
+
+size_t AHR_RequestHeapBytes(const AHR_HttpRequest_t request)
+{
+    const size_t own = request->in_arena ? 0U : (sizeof(struct AHR_HttpRequest) + AHR_REQUEST_URL_SIZE);
+    const size_t base = request->base_path ? request->base_path_len + 1U : 0U;
+    return own + base + AHR_HeaderBlockCapacityBytes(&request->header);
+}
+
+size_t AHR_ResponseHeapBytes(const AHR_HttpResponse_t response)
+{
+    //
+    // A borrowed Body Buffer is accounted for by its Pool.
+    //
+    const size_t body = response->pool ? 0U : AHR_RESPONSE_BODY_SIZE;
+    const size_t own = response->in_arena ? 0U : (sizeof(struct AHR_HttpResponse) + body);
+    return own 
+        + AHR_HeaderBlockCapacityBytes(&response->header) 
+        + AHR_HeaderBlockCapacityBytes(&response->header_filter)
+        + AHR_JsonIndexerCapacityBytes(&response->json);
+}
+
 void AHR_RequestSetLogger(AHR_HttpRequest_t request, AHR_Logger_t logger)
 {
     request->logger = logger;
@@ -138,27 +299,104 @@ void AHR_ResponseSetLogger(AHR_HttpResponse_t response, AHR_Logger_t logger)
     response->logger = logger;
 }
 
+void AHR_ResponseSetDataSink(AHR_HttpResponse_t response, AHR_ResponseDataSink_t sink, void *user)
+{
+    response->sink = sink;
+    response->sink_user = user;
+}
+
 void AHR_DestroyResponse(AHR_HttpResponse_t *response)
 {
-    free((*response)->body.data);
-    (*response)->body.data = NULL;
-    (*response)->body.maxbytes = 0;
-    (*response)->body.nbytes = 0;
+    AHR_DestroyHeaderBlock(&(*response)->header);
+    AHR_DestroyHeaderBlock(&(*response)->header_filter);
+    AHR_DestroyJsonIndexer(&(*response)->json);
+    if((*response)->pool)
+    {
+        AHR_ResponseReleaseBody(*response);
+    }
+    else if(!(*response)->in_arena)
+    {
+        free((*response)->body.data);
+    }
+    if(!(*response)->in_arena)
+    {
+        free(*response);
+    }
     *response = NULL;
 }
 
-void AHR_DestroyRequest(AHR_HttpRequest_t *request)
+void AHR_ResponseSetBufferPool(AHR_HttpResponse_t response, AHR_BufferPool_t *pool, AHR_BufferCache_t *cache)
+{
+    assert(NULL != response);
+    assert(NULL != pool);
+    assert(NULL == response->pool);
+    //
+    // The fixed Buffer is not needed anymore. Arena Memory can not be given back, 
+    // use AHR_CreateResponseForPool() for Responses in an Arena.
+    //
+    if(!response->in_arena)
+    {
+        free(response->body.data);
+    }
+    response->body.data = NULL;
+    response->body.nbytes = 0;
+    response->body.maxbytes = 0;
+    response->pool = pool;
+    response->cache = cache;
+}
+
+void AHR_ResponseSetEndpoint(AHR_HttpResponse_t response, uint64_t endpoint)
+{
+    response->endpoint = endpoint;
+}
+
+uint64_t AHR_ResponseEndpoint(const AHR_HttpResponse_t response)
 {
-    if((*request)->http_header)
+    return response->endpoint;
+}
+
+void AHR_ResponseLearnBodySize(AHR_HttpResponse_t response)
+{
+    if(!response->pool || !response->body.data || response->learned)
+    {
+        return;
+    }
+    AHR_BufferPoolLearn(response->pool, response->endpoint, response->body.nbytes);
+    if(!response->grown)
     {
-        curl_slist_free_all((*request)->http_header);
+        AHR_BufferPoolCountPresized(response->pool);
     }
-    free((*request)->url);
-    free((*request)->body.data);
+    response->learned = true;
+}
 
-    AHR_CurlEasyCleanUp((*request)->handle);
-    (*request)->url = NULL;
-    (*request)->handle = NULL;
+void AHR_ResponseReleaseBody(AHR_HttpResponse_t response)
+{
+    if(!response->pool || !response->body.data)
+    {
+        return;
+    }
+    AHR_ResponseLearnBodySize(response);
+    AHR_BufferPoolRelease(response->pool, response->cache, response->body.data);
+    response->body.data = NULL;
+    response->body.nbytes = 0;
+    response->body.maxbytes = 0;
+    response->grown = false;
+    response->learned = false;
+}
+
+void AHR_DestroyRequest(AHR_HttpRequest_t *request)
+{
+    if((*request)->handle)
+    {
+        AHR_CurlEasyCleanUp((*request)->handle);
+    }
+    AHR_DestroyHeaderBlock(&(*request)->header);
+    AHR_RequestSetBaseUrl(*request, NULL);
+    if(!(*request)->in_arena)
+    {
+        free((*request)->url);
+        free(*request);
+    }
     *request = NULL;
 }
 
@@ -167,7 +405,15 @@ AHR_Status_t AHR_MakeRequest(AHR_HttpRequest_t request, AHR_HttpResponse_t respo
     assert(NULL != request);
     assert(NULL != response);
     assert(NULL != request->url);
-    AHR_CurlEasySetUrl(request->handle, request->url);
+    if(request->use_base)
+    {
+        AHR_CurlEasySetCurlUrl(request->handle, request->base_url);
+    }
+    else
+    {
+        AHR_CurlEasySetCurlUrl(request->handle, NULL);
+        AHR_CurlEasySetUrl(request->handle, request->url);
+    }
     response->request = request;
 
     return AHR_OK;
@@ -175,17 +421,159 @@ AHR_Status_t AHR_MakeRequest(AHR_HttpRequest_t request, AHR_HttpResponse_t respo
 
 void AHR_ResponseReset(AHR_HttpResponse_t response)
 {
-    memset(response->body.data, '\0', response->body.maxbytes);
+    //
+    // AHR_WriteCallback keeps the Body terminated, there is no need to clear the whole Buffer.
+    //
+    if(response->body.data)
+    {
+        response->body.data[0] = '\0';
+    }
     response->body.nbytes = 0;
-    response->header.nheaders = 0;
+    response->decoded_bytes = 0;
+    response->encoded = false;
+    response->limit_exceeded = false;
+    response->first_byte = false;
+    AHR_JsonIndexerReset(&response->json);
+    AHR_HeaderBlockReset(&response->header);
+}
+
+void AHR_RequestSetFileSink(AHR_HttpRequest_t request, const AHR_FileSink_t *sink)
+{
+    if(!sink || sink->fd < 0)
+    {
+        request->file_descriptor = -1;
+        return;
+    }
+    request->file_descriptor = sink->fd;
+    AHR_FileWriterReset(&request->file_writer, sink);
+}
+
+void AHR_RequestEndFileSink(AHR_HttpRequest_t request)
+{
+    if(request->file_descriptor >= 0)
+    {
+        AHR_FileWriterEnd(&request->file_writer, request->file_descriptor);
+    }
+}
+
+void AHR_RequestSetHeaderListCache(AHR_HttpRequest_t request, AHR_HeaderListCache_t *cache)
+{
+    AHR_CurlSetHeaderListCache(request->handle, cache);
+}
+
+bool AHR_RequestSetBaseUrl(AHR_HttpRequest_t request, AHR_CurlUrl_t base)
+{
+    if(request->base_url)
+    {
+        AHR_CurlUrlCleanUp(request->base_url);
+    }
+    free(request->base_path);
+    request->base_url = NULL;
+    request->base_path = NULL;
+    request->base_path_len = 0;
+    request->base_key = 0;
+    request->use_base = false;
+    if(!base)
+    {
+        return true;
+    }
+
+    //
+    // The URL Buffer is free while the Request is reconfigured, use it as Scratch for Origin and Path.
+    //
+    const int64_t origin_len = AHR_CurlUrlGetOrigin(base, request->url, AHR_REQUEST_URL_SIZE);
+    if(origin_len < 0)
+    {
+        return false;
+    }
+    const uint64_t origin_key = AHR_BufferPoolEndpointKey(request->url);
+    int64_t path_len = AHR_CurlUrlGetPath(base, request->url, AHR_REQUEST_URL_SIZE);
+    if(path_len < 0)
+    {
+        return false;
+    }
+    while(path_len > 0 && '/' == request->url[path_len - 1])
+    {
+        --path_len;
+    }
+    request->base_path = malloc((size_t)path_len + 1U);
+    request->base_url = AHR_CurlUrlDup(base);
+    if(!request->base_path || !request->base_url)
+    {
+        AHR_RequestSetBaseUrl(request, NULL);
+        return false;
+    }
+    memcpy(request->base_path, request->url, (size_t)path_len); // flawfinder: ignore
+    request->base_path[path_len] = '\0';
+    request->base_path_len = (size_t)path_len;
+    request->base_key = AHR_BufferPoolEndpointKeyFrom(origin_key, request->base_path);
+    request->url[0] = '\0';
+    return true;
+}
+
+bool AHR_RequestSetPath(AHR_HttpRequest_t request, const char *path)
+{
+    assert(NULL != path);
+    if(!request->base_url)
+    {
+        return false;
+    }
+    //
+    // Compose "<Base Path><Path>\0<Query>\0" in the URL Buffer, curl copies both Parts.
+    //
+    const size_t query_at = strcspn(path, "?#");
+    const char *query = '?' == path[query_at] ? &path[query_at + 1] : NULL;
+    const size_t query_len = query ? strcspn(query, "#") : 0;
+    const bool slash = '/' != path[0];
+    const size_t nbytes = request->base_path_len + (slash ? 1U : 0U) + query_at + 1U + query_len + 1U;
+    if(nbytes > AHR_REQUEST_URL_SIZE)
+    {
+        return false;
+    }
+    char *target = request->url;
+    memcpy(target, request->base_path, request->base_path_len); // flawfinder: ignore
+    target += request->base_path_len;
+    if(slash)
+    {
+        *target++ = '/';
+    }
+    memcpy(target, path, query_at); // flawfinder: ignore
+    target += query_at;
+    *target++ = '\0';
+    char *query_copy = NULL;
+    if(query)
+    {
+        query_copy = target;
+        memcpy(query_copy, query, query_len); // flawfinder: ignore
+        query_copy[query_len] = '\0';
+    }
+    request->use_base = AHR_CurlUrlSetPath(request->base_url, request->url, query_copy);
+    return request->use_base;
+}
+
+uint64_t AHR_RequestBaseKey(const AHR_HttpRequest_t request)
+{
+    return request->base_key;
+}
+
+bool AHR_RequestSetHeader(AHR_HttpRequest_t request, const AHR_HeaderView_t *header, size_t nheaders)
+{
+    const bool stored = AHR_HeaderBlockAssign(&request->header, header, nheaders);
+    AHR_CurlSetHeader(request->handle, &request->header);
+    return stored;
 }
 
-void AHR_RequestSetHeader(AHR_HttpRequest_t request, const AHR_Header_t *header)
+size_t AHR_RequestHeaderCount(const AHR_HttpRequest_t request)
 {
-    AHR_CurlSetHeader(request->handle, header);
+    return AHR_HeaderBlockSize(&request->header);
 }
 
-void AHR_Post(AHR_HttpRequest_t request, const char *url, const char *body, AHR_HttpResponse_t response)
+bool AHR_RequestHeaderAt(const AHR_HttpRequest_t request, size_t index, AHR_HeaderView_t *header)
+{
+    return AHR_HeaderBlockAt(&request->header, index, header);
+}
+
+bool AHR_Post(AHR_HttpRequest_t request, const char *url, const char *body, size_t nbytes, AHR_HttpResponse_t response)
 {
     //
     // Buffers are allocated only during Initialization, the Size can not Change.
@@ -194,30 +582,22 @@ void AHR_Post(AHR_HttpRequest_t request, const char *url, const char *body, AHR_
     
     assert(NULL != request);
     assert(NULL != response);
-    assert(NULL != url);
-    //
-    // append content-type Header
-    //
-    // TODO: Check  if additional Headers are possible...
-    request->http_header = curl_slist_append(request->http_header, "Content-Type: application/json"); 
-    request->http_header = curl_slist_append(request->http_header, "Accept: application/json"); 
-    request->http_header = curl_slist_append(request->http_header, "charset: utf-8"); 
-
-    const size_t len = strnlen(url, AHR_PROCESSOR_MAX_URL_LEN);
-    memset(request->url, '\0', 4096);
-    memcpy(request->url, url, len); // flawfinder: ignore
+    AHR_RequestCopyUrl(request, url);
     
-    AHR_CurlSetHeader(request->handle, NULL);
-    AHR_CurlSetHttpMethodPost(request->handle, body);
+    if(!AHR_CurlSetHttpMethodPost(request->handle, body, nbytes))
+    {
+        return false;
+    }
     AHR_CurlSetCallbackUserData(
         request->handle,
         response,
         response
     );
     AHR_MakeRequest(request, response);
+    return true;
 }
 
-void AHR_Get(AHR_HttpRequest_t request, const char *url, AHR_HttpResponse_t response)
+bool AHR_Get(AHR_HttpRequest_t request, const char *url, AHR_HttpResponse_t response)
 {
     //
     // Buffers are allocated only during Initialization, the Size can not Change.
@@ -226,22 +606,22 @@ void AHR_Get(AHR_HttpRequest_t request, const char *url, AHR_HttpResponse_t resp
     
     assert(request != NULL);
     assert(response != NULL);
-    assert(url != NULL);
 
-    memset(request->url, '\0', 4096);
-    const size_t len = strnlen(url, AHR_PROCESSOR_MAX_URL_LEN);
-    const size_t nbytes = len >= 4095 ? 4095 : len;
-    memcpy(request->url, url, nbytes); // flawfinder: ignore
-    AHR_CurlSetHttpMethodGet(request->handle);
+    AHR_RequestCopyUrl(request, url);
+    if(!AHR_CurlSetHttpMethodGet(request->handle))
+    {
+        return false;
+    }
     AHR_CurlSetCallbackUserData(
         request->handle,
         response,
         response
     );
     AHR_MakeRequest(request, response);
+    return true;
 }
 
-void AHR_Put(AHR_HttpRequest_t request, const char *url, const char *body, AHR_HttpResponse_t response)
+bool AHR_Put(AHR_HttpRequest_t request, const char *url, const char *body, size_t nbytes, AHR_HttpResponse_t response)
 {
     //
     // Buffers are allocated only during Initialization, the Size can not Change.
@@ -250,39 +630,90 @@ void AHR_Put(AHR_HttpRequest_t request, const char *url, const char *body, AHR_H
     
     assert(request != NULL);
     assert(response != NULL);
-    assert(url != NULL);
     
-    memset(request->url, '\0', 4096);
-    const size_t len = strnlen(url, AHR_PROCESSOR_MAX_URL_LEN);
-    const size_t nbytes = len >= 4095 ? 4095 : len;
-    memcpy(request->url, url, nbytes); // flawfinder: ignore
-    AHR_CurlSetHttpMethodPut(request->handle, body);
-    AHR_CurlSetHeader(request->handle, NULL);
+    AHR_RequestCopyUrl(request, url);
+    if(!AHR_CurlSetHttpMethodPut(request->handle, body, nbytes))
+    {
+        return false;
+    }
+    AHR_CurlSetCallbackUserData(
+        request->handle,
+        response,
+        response
+    );
+    AHR_MakeRequest(request, response);
+    return true;
+}
+
+bool AHR_PostFromProvider(
+    AHR_HttpRequest_t request, 
+    const char *url, 
+    const AHR_BodyProvider_t *provider, 
+    AHR_HttpResponse_t response
+)
+{
+    assert(NULL != request);
+    assert(NULL != response);
+    assert(NULL != provider);
+
+    AHR_RequestCopyUrl(request, url);
+    if(!AHR_CurlSetHttpMethodPostProvider(request->handle, provider))
+    {
+        return false;
+    }
+    AHR_CurlSetCallbackUserData(
+        request->handle,
+        response,
+        response
+    );
+    AHR_MakeRequest(request, response);
+    return true;
+}
+
+bool AHR_PutFromProvider(
+    AHR_HttpRequest_t request, 
+    const char *url, 
+    const AHR_BodyProvider_t *provider, 
+    AHR_HttpResponse_t response
+)
+{
+    assert(NULL != request);
+    assert(NULL != response);
+    assert(NULL != provider);
+
+    AHR_RequestCopyUrl(request, url);
+    if(!AHR_CurlSetHttpMethodPutProvider(request->handle, provider))
+    {
+        return false;
+    }
     AHR_CurlSetCallbackUserData(
         request->handle,
         response,
         response
     );
     AHR_MakeRequest(request, response);
+    return true;
 }
 
-void AHR_Delete(AHR_HttpRequest_t request, const char *url, AHR_HttpResponse_t response)
+bool AHR_Delete(AHR_HttpRequest_t request, const char *url, AHR_HttpResponse_t response)
 {
     //
     // Buffers are allocated only during Initialization, the Size can not Change.
     // No Boundschecks required if the sizes are respected.
     //
     
-    memset(request->url, '\0', 4096);
-    memcpy(request->url, url, strnlen(url, AHR_PROCESSOR_MAX_URL_LEN)); // flawfinder: ignore
-    AHR_CurlSetHttpMethodDelete(request->handle);
-    AHR_CurlSetHeader(request->handle, NULL);
+    AHR_RequestCopyUrl(request, url);
+    if(!AHR_CurlSetHttpMethodDelete(request->handle))
+    {
+        return false;
+    }
     AHR_CurlSetCallbackUserData(
         request->handle,
         response,
         response
     );
     AHR_MakeRequest(request, response);
+    return true;
 }
 
 size_t AHR_ResponseBodyLength(const AHR_HttpResponse_t response)
@@ -299,8 +730,117 @@ const char* AHR_ResponseBody(const AHR_HttpResponse_t response)
 void AHR_ResponseHeader(const AHR_HttpResponse_t response, AHR_Header_t *info)
 {
     assert(NULL != response);
+    assert(NULL != info);
+    //
+    // The Header Block enforces the Entry Limits of AHR_Header_t, each Entry fits including its '\0'.
+    //
+    info->nheaders = AHR_HeaderBlockSize(&response->header);
+    for(size_t i=0;i<info->nheaders;++i)
+    {
+        AHR_HeaderView_t view;
+        AHR_HeaderBlockAt(&response->header, i, &view);
+        memcpy(info->header[i].name, view.name, view.name_len); // flawfinder: ignore
+        info->header[i].name[view.name_len] = '\0';
+        memcpy(info->header[i].value, view.value, view.value_len); // flawfinder: ignore
+        info->header[i].value[view.value_len] = '\0';
+    }
+}
+
+size_t AHR_ResponseHeaderCount(const AHR_HttpResponse_t response)
+{
+    return AHR_HeaderBlockSize(&response->header);
+}
+
+bool AHR_ResponseHeaderAt(const AHR_HttpResponse_t response, size_t index, AHR_HeaderView_t *header)
+{
+    return AHR_HeaderBlockAt(&response->header, index, header);
+}
+
+bool AHR_ResponseHeaderFind(const AHR_HttpResponse_t response, const char *name, AHR_HeaderView_t *header)
+{
+    assert(NULL != name);
+    return AHR_HeaderBlockFind(&response->header, name, strnlen(name, AHR_HEADERENTRY_NAME_LEN), header);
+}
+
+void AHR_RequestSetAcceptEncoding(AHR_HttpRequest_t request, unsigned int encodings)
+{
+    AHR_CurlSetAcceptEncoding(request->handle, encodings);
+}
+
+void AHR_RequestSetTimeout(AHR_HttpRequest_t request, size_t timeout_ms, size_t stall_seconds)
+{
+    AHR_CurlSetTimeout(request->handle, timeout_ms, stall_seconds);
+}
+
+void AHR_RequestSetContentEncoding(AHR_HttpRequest_t request, unsigned int encoding)
+{
+    AHR_CurlSetContentEncoding(request->handle, encoding);
+}
+
+void AHR_RequestSetVerbose(AHR_HttpRequest_t request, bool verbose)
+{
+    AHR_CurlSetVerbose(request->handle, verbose ? request->logger : NULL);
+}
+
+void AHR_ResponseSetDecodedLimit(AHR_HttpResponse_t response, size_t nbytes)
+{
+    response->max_decoded_bytes = nbytes;
+}
 
-    memcpy(info, &response->header, sizeof(AHR_Header_t)); // flawfinder: ignore
+uint64_t AHR_ResponseDecodedBytes(const AHR_HttpResponse_t response)
+{
+    return response->decoded_bytes;
+}
+
+bool AHR_ResponseIsEncoded(const AHR_HttpResponse_t response)
+{
+    return response->encoded;
+}
+
+bool AHR_ResponseLimitExceeded(const AHR_HttpResponse_t response)
+{
+    return response->limit_exceeded;
+}
+
+void AHR_ResponseSetJsonIndex(AHR_HttpResponse_t response, bool enabled)
+{
+    response->index_json = enabled;
+}
+
+bool AHR_ResponseFinishJsonIndex(AHR_HttpResponse_t response)
+{
+    if(!response->index_json || response->sink || (response->request && response->request->file_descriptor >= 0))
+    {
+        return false;
+    }
+    return AHR_JsonIndexerFinish(&response->json, response->body.data, response->body.nbytes);
+}
+
+bool AHR_ResponseJsonIndex(const AHR_HttpResponse_t response, AHR_JsonIndex_t *index)
+{
+    if(!response->body.data)
+    {
+        //
+        // The Body went back to the Pool, the Tokens of the last Index would point into nothing.
+        //
+        *index = (AHR_JsonIndex_t){.body=NULL, .nbytes=0, .tokens=NULL, .ntokens=0, .error_offset=0};
+        return false;
+    }
+    return AHR_JsonIndexerView(&response->json, response->body.data, response->body.nbytes, index);
+}
+
+bool AHR_ResponseSetHeaderFilter(AHR_HttpResponse_t response, const char *const *names, size_t nnames)
+{
+    AHR_HeaderBlockReset(&response->header_filter);
+    for(size_t i=0;i<nnames;++i)
+    {
+        if(!AHR_HeaderBlockAppend(&response->header_filter, names[i], strnlen(names[i], AHR_HEADERENTRY_NAME_LEN), NULL, 0))
+        {
+            AHR_HeaderBlockReset(&response->header_filter);
+            return false;
+        }
+    }
+    return true;
 }
 
 long AHR_ResponseStatusCode(const AHR_HttpResponse_t response)
@@ -324,6 +864,72 @@ void* AHR_RequestUUID(const AHR_HttpRequest_t request)
 // --------------------------------------------------------------------------------------------------------------------
 //
 
+static void* AHR_Allocate(AHR_Arena_t *arena, size_t nbytes)
+{
+    return arena ? AHR_ArenaAlloc(arena, nbytes) : calloc(1, nbytes);
+}
+
+static void AHR_RequestCopyUrl(AHR_HttpRequest_t request, const char *url)
+{
+    if(!url)
+    {
+        assert(request->use_base);
+        return;
+    }
+    //
+    // Only the URL and its Terminator are written, the Rest of the Buffer is never read.
+    //
+    const size_t len = strnlen(url, AHR_PROCESSOR_MAX_URL_LEN);
+    memcpy(request->url, url, len); // flawfinder: ignore
+    request->url[len] = '\0';
+    request->use_base = false;
+}
+
+static bool AHR_ResponseGrowBody(AHR_HttpResponse_t response, size_t nbytes)
+{
+    if(!response->pool)
+    {
+        return false;
+    }
+    size_t wanted = response->body.nbytes + nbytes + 1U;
+    if(!response->body.data)
+    {
+        const int64_t content_length = response->request 
+            ? AHR_CurlEasyContentLength(response->request->handle) 
+            : -1;
+        const size_t expected = content_length >= 0
+            ? (size_t)content_length + 1U
+            : AHR_BufferPoolExpected(response->pool, response->endpoint) + 1U;
+        wanted = expected > wanted ? expected : wanted;
+        if(wanted > AHR_BufferPoolMaxSize() && (response->body.nbytes + nbytes + 1U) <= AHR_BufferPoolMaxSize())
+        {
+            //
+            // The Body will not fit, but let the largest Buffer take as much as possible.
+            //
+            wanted = AHR_BufferPoolMaxSize();
+        }
+    }
+    char *buffer = AHR_BufferPoolAcquire(response->pool, response->cache, wanted);
+    if(!buffer)
+    {
+        AHR_BufferPoolCountOversized(response->pool);
+        return false;
+    }
+    if(response->body.data)
+    {
+        memcpy(buffer, response->body.data, response->body.nbytes); // flawfinder: ignore
+        AHR_BufferPoolRelease(response->pool, response->cache, response->body.data);
+        if(!response->grown)
+        {
+            AHR_BufferPoolCountRegrown(response->pool);
+        }
+        response->grown = true;
+    }
+    response->body.data = buffer;
+    response->body.maxbytes = AHR_BufferCapacity(buffer);
+    return true;
+}
+
 static size_t AHR_WriteCallback(char *data, size_t size, size_t nmemb, void *clientp) // cppcheck-suppress constParameterCallback
 {
     //
@@ -337,10 +943,67 @@ static size_t AHR_WriteCallback(char *data, size_t size, size_t nmemb, void *cli
     {
         return AHR_CurlWriteError();
     }
+    const size_t nbytes = size * nmemb; 
+    response->decoded_bytes += nbytes;
+    if(response->max_decoded_bytes > 0 && response->decoded_bytes > response->max_decoded_bytes)
+    {
+        response->limit_exceeded = true;
+        if(response->logger)
+        {
+            AHR_LOG_WARNING(response->logger, "Decoded Response Body exceeds its Limit, abort...");
+        }
+        return 0;
+    }
+    if(response->sink)
+    {
+        //
+        // Streaming: hand the Chunk straight to the Consumer, nothing is buffered.
+        //
+        switch(response->sink(response->sink_user, data, nbytes))
+        {
+            case AHR_STREAM_CONTINUE:
+                return nbytes;
+            case AHR_STREAM_PAUSE:
+                //
+                // curl delivers the same Chunk again once the Transfer is resumed.
+                //
+                response->decoded_bytes -= nbytes;
+                return AHR_CurlWritePause();
+            case AHR_STREAM_ABORT:
+            default:
+                //
+                // Any Value other than nbytes aborts the Transfer.
+                //
+                return 0;
+        }
+    }
+    AHR_HttpRequest_t request = response->request;
+    if(request && request->file_descriptor >= 0)
+    {
+        //
+        // Download: the Chunk goes straight from curls Buffer into the File.
+        //
+        if(
+            !AHR_FileWriterWrite(
+                &request->file_writer,
+                request->file_descriptor,
+                data,
+                nbytes,
+                AHR_CurlEasyContentLength(request->handle)
+            )
+        )
+        {
+            if(response->logger)
+            {
+                AHR_LOG_WARNING(response->logger, "Unable to write Response Body into the File, abort...");
+            }
+            return 0;
+        }
+        return nbytes;
+    }
     // check if the given buffer can hold more bytes
     // this should be a \0 terminated string.
-    const size_t nbytes = size * nmemb; 
-    if((nbytes + response->body.nbytes - 1) >= response->body.maxbytes)
+    if((nbytes + response->body.nbytes) >= response->body.maxbytes && !AHR_ResponseGrowBody(response, nbytes))
     {
         printf("Write ERROR in AHR_WriteCallback!\n");
         return AHR_CurlWriteError();
@@ -352,57 +1015,89 @@ static size_t AHR_WriteCallback(char *data, size_t size, size_t nmemb, void *cli
         nbytes
     );
     response->body.nbytes = response->body.nbytes + nbytes;
+    response->body.data[response->body.nbytes] = '\0';
+    if(response->index_json)
+    {
+        //
+        // Stage 1 runs while the Chunk is still in the Cache.
+        //
+        AHR_JsonIndexerFeed(&response->json, response->body.data, response->body.nbytes);
+    }
     return nbytes;
 }
 
 static size_t AHR_HeaderCallback(char *buffer, size_t size, size_t nitems, void *userdata)
 {
     //
-    // Buffers are allocated only during Initialization, the Size can not Change.
-    // No Boundschecks required if the sizes are respected.
+    // curl delivers exactly one Header Line per Call, the Line is not NULL-terminated.
     //
 
     AHR_HttpResponse_t response = (AHR_HttpResponse_t)userdata; 
     if(!response) return AHR_CurlReadError();
 
-    if(strnlen(buffer, AHR_HEADERENTRY_NAME_LEN + AHR_HEADERENTRY_VALUE_LEN - 2) < 3)
+    const size_t nbytes = size * nitems;
+    if(!response->first_byte)
     {
-        AHR_LogWarning(response->logger, "Unable to parse HTTP header...");
-        return size * nitems;
+        response->first_byte = true;
+        AHR_PROBE1(request__first__byte, response);
     }
-
-    char *token = strchr(buffer, ':');
-    if(!token)
+    AHR_HeaderLine_t line;
+    switch(AHR_HeaderParseLine(buffer, nbytes, &line))
     {
-        return size * nitems;
+        case AHR_HEADER_LINE_STATUS:
+            //
+            // A new Status Line, f.e. after a Redirect or "100 Continue", starts a new Header Set.
+            //
+            AHR_HeaderBlockReset(&response->header);
+            response->encoded = false;
+            return nbytes;
+        case AHR_HEADER_LINE_FIELD:
+            break;
+        default:
+            //
+            // The empty Line terminates the Header Section, malformed Lines are skipped.
+            //
+            return nbytes;
     }
-    
-    //
-    // remove ':' and  ltrim
-    //
-    token += 1;
-    while(!isalnum(*token) && '\0' != *token)
+    static const char content_encoding[] = "content-encoding";
+    static const char identity[] = "identity";
+    if(
+        (sizeof(content_encoding) - 1U) == line.name_len
+        && 0 == strncasecmp(buffer, content_encoding, line.name_len)
+        && !(
+            (sizeof(identity) - 1U) == line.value_len 
+            && 0 == strncasecmp(&buffer[line.value_offset], identity, line.value_len)
+        )
+    )
     {
-        ++token;
+        response->encoded = true;
+    }
+    AHR_HeaderView_t wanted;
+    if(
+        AHR_HeaderBlockSize(&response->header_filter) > 0
+        && !AHR_HeaderBlockFind(&response->header_filter, buffer, line.name_len, &wanted)
+    )
+    {
+        //
+        // Not whitelisted, the Header is never stored.
+        //
+        return nbytes;
     }
 
-    memset(
-        &response->header.header[response->header.nheaders],
-        '\0',
-        sizeof(response->header.header[response->header.nheaders])
-    );
-    memcpy( // flawfinder: ignore
-        response->header.header[response->header.nheaders].name,
-        buffer,
-        token - buffer
-    );
-    memcpy( // flawfinder: ignore
-        response->header.header[response->header.nheaders].value,
-        token,
-        strnlen(token, AHR_HEADERENTRY_VALUE_LEN-1)
-    );
-    response->header.nheaders++;
-    return size * nitems;
+    if(
+        !AHR_HeaderBlockAppend(
+            &response->header,
+            buffer,
+            line.name_len,
+            &buffer[line.value_offset],
+            line.value_len
+        )
+        && response->logger
+    )
+    {
+        AHR_LOG_WARNING(response->logger, "Unable to store HTTP header, Limit exceeded...");
+    }
+    return nbytes;
 }
 //
 // --------------------------------------------------------------------------------------------------------------------
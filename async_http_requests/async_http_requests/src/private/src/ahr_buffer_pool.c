@@ -0,0 +1,433 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/private/ahr_buffer_pool.h>
+
+#include <assert.h>
+#include <string.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Each Buffer is preceded by a Header of one Cache Line, the Data stays cache line aligned.
+///
+#define AHR_BUFFER_HEADER_SIZE ((size_t)64)
+///
+/// \brief  Idle Buffers per Class the Depot keeps, more are freed.
+///
+#define AHR_BUFFER_DEPOT_LIMIT ((size_t)32)
+
+typedef struct AHR_BufferHeader
+{
+    struct AHR_BufferHeader *next;
+    size_t size_class;
+} AHR_BufferHeader_t;
+
+static const size_t AHR_BUFFER_CLASS_SIZE[AHR_BUFFER_POOL_CLASSES] = {
+    4096,
+    4096 * 4,
+    4096 * 16,
+    4096 * 64
+};
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_BufferPoolSizeClass(size_t nbytes, size_t *size_class);
+static AHR_BufferHeader_t* AHR_BufferHeader(const char *buffer);
+static char* AHR_BufferData(AHR_BufferHeader_t *header);
+///
+/// \brief  Take up to "max" Buffers of a Class from the Depot.
+/// \returns    Number of Buffers taken.
+///
+static size_t AHR_BufferPoolTakeFromDepot(AHR_BufferPool_t *pool, size_t size_class, void **buffers, size_t max);
+///
+/// \brief  Put Buffers of a Class into the Depot, Buffers beyond AHR_BUFFER_DEPOT_LIMIT are freed.
+///
+static void AHR_BufferPoolPutToDepot(AHR_BufferPool_t *pool, size_t size_class, void * const *buffers, size_t n);
+static void AHR_BufferPoolCountAcquired(AHR_BufferPool_t *pool, size_t size_class);
+static void AHR_AtomicMax(atomic_size_t *value, size_t candidate);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_BufferPool_t AHR_CreateBufferPool(void)
+{
+    AHR_BufferPool_t pool;
+    memset(&pool, 0, sizeof(pool));
+    pool.mutex = AHR_CreateMutex();
+    for(size_t i=0;i<AHR_BUFFER_POOL_CLASSES;++i)
+    {
+        pool.depot[i] = NULL;
+        pool.ndepot[i] = 0;
+        atomic_init(&pool.acquired[i], 0);
+        atomic_init(&pool.cache_hits[i], 0);
+        atomic_init(&pool.depot_hits[i], 0);
+        atomic_init(&pool.allocated[i], 0);
+        atomic_init(&pool.in_use[i], 0);
+        atomic_init(&pool.high_water[i], 0);
+        atomic_init(&pool.idle[i], 0);
+    }
+    atomic_init(&pool.bytes_in_use, 0);
+    atomic_init(&pool.bytes_high_water, 0);
+    atomic_init(&pool.presized, 0);
+    atomic_init(&pool.regrown, 0);
+    atomic_init(&pool.oversized, 0);
+    return pool;
+}
+
+void AHR_DestroyBufferPool(AHR_BufferPool_t *pool)
+{
+    assert(NULL != pool);
+
+    for(size_t i=0;i<AHR_BUFFER_POOL_CLASSES;++i)
+    {
+        AHR_BufferHeader_t *current = pool->depot[i];
+        while(current)
+        {
+            AHR_BufferHeader_t *next = current->next;
+            free(current);
+            current = next;
+        }
+        pool->depot[i] = NULL;
+        pool->ndepot[i] = 0;
+        atomic_store(&pool->idle[i], 0);
+    }
+    if(pool->mutex)
+    {
+        AHR_DestroyMutex(&pool->mutex);
+    }
+}
+
+bool AHR_BufferPoolIsValid(const AHR_BufferPool_t *pool)
+{
+    return NULL != pool->mutex;
+}
+
+AHR_BufferCache_t AHR_CreateBufferCache(AHR_BufferPool_t *pool)
+{
+    AHR_BufferCache_t cache;
+    memset(&cache, 0, sizeof(cache));
+    cache.pool = pool;
+    return cache;
+}
+
+void AHR_DestroyBufferCache(AHR_BufferCache_t *cache)
+{
+    assert(NULL != cache);
+
+    for(size_t i=0;i<AHR_BUFFER_POOL_CLASSES && cache->pool;++i)
+    {
+        AHR_BufferPoolPutToDepot(cache->pool, i, cache->buffers[i], cache->nbuffers[i]);
+        cache->nbuffers[i] = 0;
+    }
+    cache->pool = NULL;
+}
+
+char* AHR_BufferPoolAcquire(AHR_BufferPool_t *pool, AHR_BufferCache_t *cache, size_t nbytes)
+{
+    assert(NULL != pool);
+    assert(NULL == cache || pool == cache->pool);
+
+    size_t size_class;
+    if(!AHR_BufferPoolSizeClass(nbytes, &size_class))
+    {
+        return NULL;
+    }
+    AHR_BufferHeader_t *header = NULL;
+    if(cache)
+    {
+        if(0 == cache->nbuffers[size_class])
+        {
+            //
+            // Refill half of the Cache with one Lock, the next Requests are served without it.
+            //
+            cache->nbuffers[size_class] = AHR_BufferPoolTakeFromDepot(
+                pool,
+                size_class,
+                cache->buffers[size_class],
+                AHR_BUFFER_CACHE_SIZE / 2
+            );
+            if(cache->nbuffers[size_class] > 0)
+            {
+                atomic_fetch_add_explicit(&pool->depot_hits[size_class], 1, memory_order_relaxed);
+            }
+        }
+        else
+        {
+            atomic_fetch_add_explicit(&pool->cache_hits[size_class], 1, memory_order_relaxed);
+        }
+        if(cache->nbuffers[size_class] > 0)
+        {
+            header = cache->buffers[size_class][--cache->nbuffers[size_class]];
+            atomic_fetch_sub_explicit(&pool->idle[size_class], 1, memory_order_relaxed);
+        }
+    }
+    else
+    {
+        void *taken = NULL;
+        if(1 == AHR_BufferPoolTakeFromDepot(pool, size_class, &taken, 1))
+        {
+            header = taken;
+            atomic_fetch_sub_explicit(&pool->idle[size_class], 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&pool->depot_hits[size_class], 1, memory_order_relaxed);
+        }
+    }
+    if(!header)
+    {
+        header = aligned_alloc(AHR_BUFFER_HEADER_SIZE, AHR_BUFFER_HEADER_SIZE + AHR_BUFFER_CLASS_SIZE[size_class]);
+        if(!header)
+        {
+            return NULL;
+        }
+        header->size_class = size_class;
+        atomic_fetch_add_explicit(&pool->allocated[size_class], 1, memory_order_relaxed);
+    }
+    header->next = NULL;
+    AHR_BufferPoolCountAcquired(pool, size_class);
+    return AHR_BufferData(header);
+}
+
+void AHR_BufferPoolRelease(AHR_BufferPool_t *pool, AHR_BufferCache_t *cache, char *buffer)
+{
+    assert(NULL != pool);
+    assert(NULL == cache || pool == cache->pool);
+    if(!buffer)
+    {
+        return;
+    }
+    AHR_BufferHeader_t *header = AHR_BufferHeader(buffer);
+    const size_t size_class = header->size_class;
+    assert(size_class < AHR_BUFFER_POOL_CLASSES);
+
+    atomic_fetch_sub_explicit(&pool->in_use[size_class], 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&pool->bytes_in_use, AHR_BUFFER_CLASS_SIZE[size_class], memory_order_relaxed);
+    atomic_fetch_add_explicit(&pool->idle[size_class], 1, memory_order_relaxed);
+    if(!cache)
+    {
+        void *released = header;
+        AHR_BufferPoolPutToDepot(pool, size_class, &released, 1);
+        return;
+    }
+    if(AHR_BUFFER_CACHE_SIZE == cache->nbuffers[size_class])
+    {
+        //
+        // Cache is full, hand the older Half to the Depot with one Lock.
+        //
+        const size_t half = AHR_BUFFER_CACHE_SIZE / 2;
+        AHR_BufferPoolPutToDepot(pool, size_class, cache->buffers[size_class], half);
+        memmove( // flawfinder: ignore
+            &cache->buffers[size_class][0],
+            &cache->buffers[size_class][half],
+            (AHR_BUFFER_CACHE_SIZE - half) * sizeof(void*)
+        );
+        cache->nbuffers[size_class] -= half;
+    }
+    cache->buffers[size_class][cache->nbuffers[size_class]++] = header;
+}
+
+size_t AHR_BufferCapacity(const char *buffer)
+{
+    return AHR_BUFFER_CLASS_SIZE[AHR_BufferHeader(buffer)->size_class];
+}
+
+size_t AHR_BufferPoolMaxSize(void)
+{
+    return AHR_BUFFER_CLASS_SIZE[AHR_BUFFER_POOL_CLASSES - 1];
+}
+
+size_t AHR_BufferPoolBytes(const AHR_BufferPool_t *pool)
+{
+    size_t nbytes = 0;
+    for(size_t i=0;i<AHR_BUFFER_POOL_CLASSES;++i)
+    {
+        const size_t n = atomic_load_explicit(&pool->in_use[i], memory_order_relaxed)
+            + atomic_load_explicit(&pool->idle[i], memory_order_relaxed);
+        nbytes += n * (AHR_BUFFER_HEADER_SIZE + AHR_BUFFER_CLASS_SIZE[i]);
+    }
+    return nbytes;
+}
+
+void AHR_BufferPoolStats(const AHR_BufferPool_t *pool, AHR_BufferPoolStats_t *stats)
+{
+    assert(NULL != pool);
+    assert(NULL != stats);
+
+    for(size_t i=0;i<AHR_BUFFER_POOL_CLASSES;++i)
+    {
+        AHR_BufferClassStats_t *c = &stats->classes[i];
+        c->buffer_size = AHR_BUFFER_CLASS_SIZE[i];
+        c->acquired = atomic_load_explicit(&pool->acquired[i], memory_order_relaxed);
+        c->cache_hits = atomic_load_explicit(&pool->cache_hits[i], memory_order_relaxed);
+        c->depot_hits = atomic_load_explicit(&pool->depot_hits[i], memory_order_relaxed);
+        c->allocated = atomic_load_explicit(&pool->allocated[i], memory_order_relaxed);
+        c->in_use = atomic_load_explicit(&pool->in_use[i], memory_order_relaxed);
+        c->high_water = atomic_load_explicit(&pool->high_water[i], memory_order_relaxed);
+        c->idle = atomic_load_explicit(&pool->idle[i], memory_order_relaxed);
+    }
+    stats->bytes_in_use = atomic_load_explicit(&pool->bytes_in_use, memory_order_relaxed);
+    stats->bytes_high_water = atomic_load_explicit(&pool->bytes_high_water, memory_order_relaxed);
+    stats->presized = atomic_load_explicit(&pool->presized, memory_order_relaxed);
+    stats->regrown = atomic_load_explicit(&pool->regrown, memory_order_relaxed);
+    stats->oversized = atomic_load_explicit(&pool->oversized, memory_order_relaxed);
+}
+
+void AHR_BufferPoolCountPresized(AHR_BufferPool_t *pool)
+{
+    atomic_fetch_add_explicit(&pool->presized, 1, memory_order_relaxed);
+}
+
+void AHR_BufferPoolCountRegrown(AHR_BufferPool_t *pool)
+{
+    atomic_fetch_add_explicit(&pool->regrown, 1, memory_order_relaxed);
+}
+
+void AHR_BufferPoolCountOversized(AHR_BufferPool_t *pool)
+{
+    atomic_fetch_add_explicit(&pool->oversized, 1, memory_order_relaxed);
+}
+
+uint64_t AHR_BufferPoolEndpointKey(const char *url)
+{
+    return AHR_BufferPoolEndpointKeyFrom(AHR_BUFFER_POOL_KEY_INIT, url);
+}
+
+uint64_t AHR_BufferPoolEndpointKeyFrom(uint64_t key, const char *url)
+{
+    //
+    // FNV-1a over Scheme, Host and Path, it can be continued where a previous Part ended.
+    //
+    uint64_t hash = key;
+    for(const char *c = url; c && *c && '?' != *c && '#' != *c; ++c)
+    {
+        hash ^= (uint64_t)(unsigned char)*c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void AHR_BufferPoolLearn(AHR_BufferPool_t *pool, uint64_t key, size_t nbytes)
+{
+    assert(NULL != pool);
+    const size_t index = (size_t)(key % AHR_BUFFER_POOL_ENDPOINTS);
+    if(pool->endpoints[index].key != key)
+    {
+        //
+        // New Endpoint or Collision, the last one wins.
+        //
+        pool->endpoints[index].key = key;
+        pool->endpoints[index].expected = nbytes;
+        return;
+    }
+    //
+    // Follow larger Responses immediately, so the next Buffer does not have to grow,
+    // and decay slowly towards smaller ones.
+    //
+    const size_t expected = pool->endpoints[index].expected;
+    pool->endpoints[index].expected = nbytes >= expected ? nbytes : expected - (expected - nbytes) / 4;
+}
+
+size_t AHR_BufferPoolExpected(const AHR_BufferPool_t *pool, uint64_t key)
+{
+    assert(NULL != pool);
+    const size_t index = (size_t)(key % AHR_BUFFER_POOL_ENDPOINTS);
+    return pool->endpoints[index].key == key ? pool->endpoints[index].expected : 0U;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_BufferPoolSizeClass(size_t nbytes, size_t *size_class)
+{
+    for(size_t i=0;i<AHR_BUFFER_POOL_CLASSES;++i)
+    {
+        if(nbytes <= AHR_BUFFER_CLASS_SIZE[i])
+        {
+            *size_class = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static AHR_BufferHeader_t* AHR_BufferHeader(const char *buffer)
+{
+    return (AHR_BufferHeader_t*)(uintptr_t)(buffer - AHR_BUFFER_HEADER_SIZE);
+}
+
+static char* AHR_BufferData(AHR_BufferHeader_t *header)
+{
+    return ((char*)header) + AHR_BUFFER_HEADER_SIZE;
+}
+
+static size_t AHR_BufferPoolTakeFromDepot(AHR_BufferPool_t *pool, size_t size_class, void **buffers, size_t max)
+{
+    size_t n = 0;
+    AHR_MutexLock(pool->mutex);
+    while(n < max && pool->depot[size_class])
+    {
+        AHR_BufferHeader_t *header = pool->depot[size_class];
+        pool->depot[size_class] = header->next;
+        --pool->ndepot[size_class];
+        buffers[n++] = header;
+    }
+    AHR_MutexUnlock(pool->mutex);
+    return n;
+}
+
+static void AHR_BufferPoolPutToDepot(AHR_BufferPool_t *pool, size_t size_class, void * const *buffers, size_t n)
+{
+    size_t freed = 0;
+    AHR_MutexLock(pool->mutex);
+    for(size_t i=0;i<n;++i)
+    {
+        AHR_BufferHeader_t *header = buffers[i];
+        if(pool->ndepot[size_class] >= AHR_BUFFER_DEPOT_LIMIT)
+        {
+            free(header);
+            ++freed;
+            continue;
+        }
+        header->next = pool->depot[size_class];
+        pool->depot[size_class] = header;
+        ++pool->ndepot[size_class];
+    }
+    AHR_MutexUnlock(pool->mutex);
+    if(freed)
+    {
+        atomic_fetch_sub_explicit(&pool->idle[size_class], freed, memory_order_relaxed);
+    }
+}
+
+static void AHR_BufferPoolCountAcquired(AHR_BufferPool_t *pool, size_t size_class)
+{
+    atomic_fetch_add_explicit(&pool->acquired[size_class], 1, memory_order_relaxed);
+    const size_t in_use = atomic_fetch_add_explicit(&pool->in_use[size_class], 1, memory_order_relaxed) + 1;
+    AHR_AtomicMax(&pool->high_water[size_class], in_use);
+    const size_t nbytes = atomic_fetch_add_explicit(
+        &pool->bytes_in_use,
+        AHR_BUFFER_CLASS_SIZE[size_class],
+        memory_order_relaxed
+    ) + AHR_BUFFER_CLASS_SIZE[size_class];
+    AHR_AtomicMax(&pool->bytes_high_water, nbytes);
+}
+
+static void AHR_AtomicMax(atomic_size_t *value, size_t candidate)
+{
+    size_t current = atomic_load_explicit(value, memory_order_relaxed);
+    while(
+        current < candidate
+        && !atomic_compare_exchange_weak_explicit(value, &current, candidate, memory_order_relaxed, memory_order_relaxed)
+    );
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,359 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/private/ahr_header_block.h>
+
+#include <string.h>
+#include <assert.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_HEADERBLOCK_INITIAL_BYTES 1024U
+#define AHR_HEADERBLOCK_INITIAL_FIELDS 16U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_HeaderBlockReserveBytes(AHR_HeaderBlock_t *block, size_t nbytes);
+static bool AHR_HeaderBlockReserveFields(AHR_HeaderBlock_t *block, size_t nfields);
+///
+/// \brief  Make the Index large enough for "nfields" Fields, a grown Index is rebuilt from the Fields.
+///
+static bool AHR_HeaderBlockReserveIndex(AHR_HeaderBlock_t *block, size_t nfields);
+///
+/// \brief  Add the Field at "field" to the Index unless a Field with the same Name is indexed already.
+///
+static void AHR_HeaderBlockIndexField(AHR_HeaderBlock_t *block, size_t field);
+///
+/// \brief  Slot which holds "name", or the empty Slot where it would be inserted.
+///
+static size_t AHR_HeaderBlockProbe(const AHR_HeaderBlock_t *block, const char *name, size_t name_len, uint32_t hash);
+///
+/// \brief  FNV-1a over the lower-cased Name.
+///
+static uint32_t AHR_HeaderNameHash(const char *name, size_t name_len);
+static bool AHR_HeaderNameEquals(const char *a, const char *b, size_t len);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_HeaderBlock_t AHR_CreateHeaderBlock(void)
+{
+    AHR_HeaderBlock_t block = {
+        .arena = NULL,
+        .arena_used = 0,
+        .arena_capacity = 0,
+        .fields = NULL,
+        .nfields = 0,
+        .fields_capacity = 0,
+        .index = NULL,
+        .index_capacity = 0
+    };
+    //
+    // A failed initial Reservation is not fatal, the Block tries again on the first Append.
+    //
+    AHR_HeaderBlockReserveBytes(&block, AHR_HEADERBLOCK_INITIAL_BYTES);
+    AHR_HeaderBlockReserveFields(&block, AHR_HEADERBLOCK_INITIAL_FIELDS);
+    AHR_HeaderBlockReserveIndex(&block, AHR_HEADERBLOCK_INITIAL_FIELDS);
+    return block;
+}
+
+AHR_HeaderBlock_t AHR_CreateEmptyHeaderBlock(void)
+{
+    AHR_HeaderBlock_t block = {
+        .arena = NULL,
+        .arena_used = 0,
+        .arena_capacity = 0,
+        .fields = NULL,
+        .nfields = 0,
+        .fields_capacity = 0,
+        .index = NULL,
+        .index_capacity = 0
+    };
+    return block;
+}
+
+void AHR_DestroyHeaderBlock(AHR_HeaderBlock_t *block)
+{
+    assert(NULL != block);
+
+    free(block->arena);
+    free(block->fields);
+    free(block->index);
+    block->index = NULL;
+    block->index_capacity = 0;
+    block->arena = NULL;
+    block->arena_used = 0;
+    block->arena_capacity = 0;
+    block->fields = NULL;
+    block->nfields = 0;
+    block->fields_capacity = 0;
+}
+
+void AHR_HeaderBlockReset(AHR_HeaderBlock_t *block)
+{
+    if(block->nfields > 0 && block->index)
+    {
+        memset(block->index, 0, block->index_capacity * sizeof(uint32_t));
+    }
+    block->arena_used = 0;
+    block->nfields = 0;
+}
+
+bool AHR_HeaderBlockAppend(
+    AHR_HeaderBlock_t *block,
+    const char *name,
+    size_t name_len,
+    const char *value,
+    size_t value_len
+)
+{
+    assert(NULL != block);
+    assert(NULL != name || 0 == name_len);
+    assert(NULL != value || 0 == value_len);
+    //
+    // Enforce the same Limits as the fixed size AHR_Header_t, so each Block can still be copied out.
+    //
+    if(
+        block->nfields >= AHR_HEADER_NMAX
+        || name_len >= AHR_HEADERENTRY_NAME_LEN
+        || value_len >= AHR_HEADERENTRY_VALUE_LEN
+        || (block->arena_used + name_len + value_len) > AHR_HEADERBLOCK_MAX_BYTES
+    )
+    {
+        return false;
+    }
+    if(
+        !AHR_HeaderBlockReserveBytes(block, block->arena_used + name_len + value_len)
+        || !AHR_HeaderBlockReserveFields(block, block->nfields + 1)
+        || !AHR_HeaderBlockReserveIndex(block, block->nfields + 1)
+    )
+    {
+        return false;
+    }
+
+    AHR_HeaderField_t *field = &block->fields[block->nfields];
+    field->name_offset = (uint32_t)block->arena_used;
+    field->name_len = (uint32_t)name_len;
+    memcpy(&block->arena[block->arena_used], name, name_len); // flawfinder: ignore
+    block->arena_used += name_len;
+
+    field->value_offset = (uint32_t)block->arena_used;
+    field->value_len = (uint32_t)value_len;
+    memcpy(&block->arena[block->arena_used], value, value_len); // flawfinder: ignore
+    block->arena_used += value_len;
+
+    AHR_HeaderBlockIndexField(block, block->nfields);
+    block->nfields++;
+    return true;
+}
+
+bool AHR_HeaderBlockAssign(AHR_HeaderBlock_t *block, const AHR_HeaderView_t *header, size_t nheaders)
+{
+    AHR_HeaderBlockReset(block);
+    for(size_t i=0;i<nheaders;++i)
+    {
+        if(
+            !AHR_HeaderBlockAppend(
+                block,
+                header[i].name,
+                header[i].name_len,
+                header[i].value,
+                header[i].value_len
+            )
+        )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t AHR_HeaderBlockSize(const AHR_HeaderBlock_t *block)
+{
+    return block->nfields;
+}
+
+bool AHR_HeaderBlockAt(const AHR_HeaderBlock_t *block, size_t index, AHR_HeaderView_t *header)
+{
+    assert(NULL != header);
+    if(index >= block->nfields)
+    {
+        return false;
+    }
+    const AHR_HeaderField_t *field = &block->fields[index];
+    header->name = &block->arena[field->name_offset];
+    header->name_len = field->name_len;
+    header->value = &block->arena[field->value_offset];
+    header->value_len = field->value_len;
+    return true;
+}
+
+bool AHR_HeaderBlockFind(const AHR_HeaderBlock_t *block, const char *name, size_t name_len, AHR_HeaderView_t *header)
+{
+    assert(NULL != name || 0 == name_len);
+    if(0 == block->nfields || !block->index)
+    {
+        return false;
+    }
+    const size_t slot = AHR_HeaderBlockProbe(block, name, name_len, AHR_HeaderNameHash(name, name_len));
+    const uint32_t entry = block->index[slot];
+    if(0 == entry)
+    {
+        return false;
+    }
+    return AHR_HeaderBlockAt(block, (entry & 0xFFFFU) - 1U, header);
+}
+
+size_t AHR_HeaderBlockCapacityBytes(const AHR_HeaderBlock_t *block)
+{
+    return block->arena_capacity 
+        + (block->fields_capacity * sizeof(AHR_HeaderField_t)) 
+        + (block->index_capacity * sizeof(uint32_t));
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_HeaderBlockReserveBytes(AHR_HeaderBlock_t *block, size_t nbytes)
+{
+    if(nbytes <= block->arena_capacity && NULL != block->arena)
+    {
+        return true;
+    }
+    size_t capacity = block->arena_capacity ? block->arena_capacity : AHR_HEADERBLOCK_INITIAL_BYTES;
+    while(capacity < nbytes)
+    {
+        capacity *= 2U;
+    }
+    char *arena = realloc(block->arena, capacity);
+    if(!arena)
+    {
+        return false;
+    }
+    block->arena = arena;
+    block->arena_capacity = capacity;
+    return true;
+}
+
+static bool AHR_HeaderBlockReserveFields(AHR_HeaderBlock_t *block, size_t nfields)
+{
+    if(nfields <= block->fields_capacity && NULL != block->fields)
+    {
+        return true;
+    }
+    size_t capacity = block->fields_capacity ? block->fields_capacity : AHR_HEADERBLOCK_INITIAL_FIELDS;
+    while(capacity < nfields)
+    {
+        capacity *= 2U;
+    }
+    AHR_HeaderField_t *fields = realloc(block->fields, capacity * sizeof(AHR_HeaderField_t));
+    if(!fields)
+    {
+        return false;
+    }
+    block->fields = fields;
+    block->fields_capacity = capacity;
+    return true;
+}
+
+static bool AHR_HeaderBlockReserveIndex(AHR_HeaderBlock_t *block, size_t nfields)
+{
+    //
+    // At most half of the Slots are used, so a Probe ends after a few Slots.
+    //
+    if((2U * nfields) <= block->index_capacity && NULL != block->index)
+    {
+        return true;
+    }
+    size_t capacity = block->index_capacity ? block->index_capacity : (2U * AHR_HEADERBLOCK_INITIAL_FIELDS);
+    while(capacity < (2U * nfields))
+    {
+        capacity *= 2U;
+    }
+    uint32_t *index = calloc(capacity, sizeof(uint32_t));
+    if(!index)
+    {
+        return false;
+    }
+    free(block->index);
+    block->index = index;
+    block->index_capacity = capacity;
+    for(size_t i=0;i<block->nfields;++i)
+    {
+        AHR_HeaderBlockIndexField(block, i);
+    }
+    return true;
+}
+
+static void AHR_HeaderBlockIndexField(AHR_HeaderBlock_t *block, size_t field)
+{
+    const char *name = &block->arena[block->fields[field].name_offset];
+    const size_t name_len = block->fields[field].name_len;
+    const uint32_t hash = AHR_HeaderNameHash(name, name_len);
+    const size_t slot = AHR_HeaderBlockProbe(block, name, name_len, hash);
+    if(0 == block->index[slot])
+    {
+        block->index[slot] = (hash & 0xFFFF0000U) | (uint32_t)(field + 1U);
+    }
+}
+
+static size_t AHR_HeaderBlockProbe(const AHR_HeaderBlock_t *block, const char *name, size_t name_len, uint32_t hash)
+{
+    const size_t mask = block->index_capacity - 1U;
+    size_t slot = (size_t)hash & mask;
+    while(0 != block->index[slot])
+    {
+        const uint32_t entry = block->index[slot];
+        const AHR_HeaderField_t *field = &block->fields[(entry & 0xFFFFU) - 1U];
+        if(
+            (entry & 0xFFFF0000U) == (hash & 0xFFFF0000U)
+            && field->name_len == name_len
+            && AHR_HeaderNameEquals(&block->arena[field->name_offset], name, name_len)
+        )
+        {
+            break;
+        }
+        slot = (slot + 1U) & mask;
+    }
+    return slot;
+}
+
+static uint32_t AHR_HeaderNameHash(const char *name, size_t name_len)
+{
+    uint32_t hash = 2166136261U;
+    for(size_t i=0;i<name_len;++i)
+    {
+        const unsigned char c = (unsigned char)name[i];
+        hash ^= (uint32_t)(('A' <= c && c <= 'Z') ? (c | 0x20U) : c);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+static bool AHR_HeaderNameEquals(const char *a, const char *b, size_t len)
+{
+    for(size_t i=0;i<len;++i)
+    {
+        unsigned char x = (unsigned char)a[i];
+        unsigned char y = (unsigned char)b[i];
+        x = ('A' <= x && x <= 'Z') ? (unsigned char)(x | 0x20U) : x;
+        y = ('A' <= y && y <= 'Z') ? (unsigned char)(y | 0x20U) : y;
+        if(x != y)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
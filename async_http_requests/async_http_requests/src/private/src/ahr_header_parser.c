@@ -0,0 +1,217 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/private/ahr_header_parser.h>
+
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#if defined(__x86_64__) || defined(__SSE2__)
+#define AHR_HEADER_PARSER_SSE2 1
+#include <immintrin.h>
+#endif
+
+#if defined(AHR_HEADER_PARSER_SSE2) && defined(__GNUC__)
+#define AHR_HEADER_PARSER_AVX2 1
+#endif
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Scan "data" from "offset" on, one Byte at a Time.
+///
+static size_t AHR_HeaderScanScalar(const char *data, size_t offset, size_t nbytes, size_t *colon, size_t *eol);
+#if defined(AHR_HEADER_PARSER_SSE2)
+///
+/// \brief  Scan whole 16 Byte Blocks, returns the Offset where the Scalar Loop continues.
+///
+static size_t AHR_HeaderScanSse2(const char *data, size_t nbytes, size_t *colon, size_t *eol);
+#endif
+#if defined(AHR_HEADER_PARSER_AVX2)
+///
+/// \brief  Scan whole 32 Byte Blocks, returns the Offset where the Scalar Loop continues.
+///
+static size_t AHR_HeaderScanAvx2(const char *data, size_t nbytes, size_t *colon, size_t *eol) 
+    __attribute__((target("avx2")));
+#endif
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_HeaderLineKind_t AHR_HeaderParseLine(const char *line, size_t nbytes, AHR_HeaderLine_t *field)
+{
+    assert(NULL != field);
+    size_t eol = nbytes;
+    const size_t colon = AHR_HeaderScan(line, nbytes, &eol);
+    if(0 == eol)
+    {
+        return AHR_HEADER_LINE_END;
+    }
+    if(eol >= 5 && 0 == memcmp(line, "HTTP/", 5))
+    {
+        return AHR_HEADER_LINE_STATUS;
+    }
+    if(colon >= eol || 0 == colon)
+    {
+        return AHR_HEADER_LINE_INVALID;
+    }
+
+    size_t value = colon + 1;
+    while(value < eol && (' ' == line[value] || '\t' == line[value]))
+    {
+        ++value;
+    }
+    size_t end = eol;
+    while(end > value && (' ' == line[end - 1] || '\t' == line[end - 1]))
+    {
+        --end;
+    }
+    field->name_len = colon;
+    field->value_offset = value;
+    field->value_len = end - value;
+    return AHR_HEADER_LINE_FIELD;
+}
+
+size_t AHR_HeaderScan(const char *data, size_t nbytes, size_t *eol)
+{
+    assert(NULL != eol);
+    size_t colon = nbytes;
+    *eol = nbytes;
+    size_t offset = 0;
+#if defined(AHR_HEADER_PARSER_AVX2)
+    if(__builtin_cpu_supports("avx2"))
+    {
+        offset = AHR_HeaderScanAvx2(data, nbytes, &colon, eol);
+    }
+    else
+    {
+        offset = AHR_HeaderScanSse2(data, nbytes, &colon, eol);
+    }
+#elif defined(AHR_HEADER_PARSER_SSE2)
+    offset = AHR_HeaderScanSse2(data, nbytes, &colon, eol);
+#endif
+    if(*eol < nbytes)
+    {
+        return colon;
+    }
+    return AHR_HeaderScanScalar(data, offset, nbytes, &colon, eol);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static size_t AHR_HeaderScanScalar(const char *data, size_t offset, size_t nbytes, size_t *colon, size_t *eol)
+{
+    for(size_t i=offset;i<nbytes;++i)
+    {
+        const char c = data[i];
+        if('\r' == c || '\n' == c)
+        {
+            *eol = i;
+            break;
+        }
+        if(':' == c && *colon == nbytes)
+        {
+            *colon = i;
+        }
+    }
+    return *colon;
+}
+
+#if defined(AHR_HEADER_PARSER_SSE2)
+static size_t AHR_HeaderScanSse2(const char *data, size_t nbytes, size_t *colon, size_t *eol)
+{
+    const __m128i colons = _mm_set1_epi8(':');
+    const __m128i crs = _mm_set1_epi8('\r');
+    const __m128i lfs = _mm_set1_epi8('\n');
+    size_t offset = 0;
+    for(;offset + 16U <= nbytes;offset+=16U)
+    {
+        const __m128i block = _mm_loadu_si128((const __m128i*)&data[offset]);
+        const uint32_t line_end = (uint32_t)_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(block, crs), _mm_cmpeq_epi8(block, lfs))
+        );
+        uint32_t delimiter = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, colons));
+        if(line_end)
+        {
+            //
+            // Only a ':' in front of the Line End counts.
+            //
+            const uint32_t first = (uint32_t)__builtin_ctz(line_end);
+            delimiter &= (1U << first) - 1U;
+            *eol = offset + first;
+        }
+        if(delimiter && *colon == nbytes)
+        {
+            *colon = offset + (size_t)__builtin_ctz(delimiter);
+        }
+        if(line_end)
+        {
+            break;
+        }
+    }
+    return offset;
+}
+#endif
+
+#if defined(AHR_HEADER_PARSER_AVX2)
+static size_t AHR_HeaderScanAvx2(const char *data, size_t nbytes, size_t *colon, size_t *eol)
+{
+    const __m256i colons = _mm256_set1_epi8(':');
+    const __m256i crs = _mm256_set1_epi8('\r');
+    const __m256i lfs = _mm256_set1_epi8('\n');
+    size_t offset = 0;
+    for(;offset + 32U <= nbytes;offset+=32U)
+    {
+        const __m256i block = _mm256_loadu_si256((const __m256i*)&data[offset]);
+        const uint32_t line_end = (uint32_t)_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, crs), _mm256_cmpeq_epi8(block, lfs))
+        );
+        uint32_t delimiter = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, colons));
+        if(line_end)
+        {
+            const uint32_t first = (uint32_t)__builtin_ctz(line_end);
+            delimiter &= (1U << first) - 1U;
+            *eol = offset + first;
+        }
+        if(delimiter && *colon == nbytes)
+        {
+            *colon = offset + (size_t)__builtin_ctz(delimiter);
+        }
+        if(line_end)
+        {
+            break;
+        }
+    }
+    //
+    // A short Line or the Tail may still fill a 16 Byte Block.
+    //
+    if(*eol == nbytes && offset + 16U <= nbytes)
+    {
+        size_t tail_colon = nbytes - offset;
+        size_t tail_eol = nbytes - offset;
+        const size_t scanned = AHR_HeaderScanSse2(&data[offset], nbytes - offset, &tail_colon, &tail_eol);
+        if(tail_eol < nbytes - offset)
+        {
+            *eol = offset + tail_eol;
+        }
+        if(*colon == nbytes && tail_colon < nbytes - offset)
+        {
+            *colon = offset + tail_colon;
+        }
+        offset += scanned;
+    }
+    return offset;
+}
+#endif
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,867 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/private/ahr_json_index.h>
+
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#if defined(__x86_64__) || defined(__SSE2__)
+#define AHR_JSON_INDEX_SSE2 1
+#include <immintrin.h>
+#endif
+
+#if defined(AHR_JSON_INDEX_SSE2) && defined(__GNUC__)
+#define AHR_JSON_INDEX_AVX2 1
+#endif
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_JSON_BLOCK_BYTES 64U
+///
+/// \brief  Offsets and Token Indices are stored with 32 Bit.
+///
+#define AHR_JSON_MAX_BYTES ((size_t)UINT32_MAX - AHR_JSON_BLOCK_BYTES)
+#define AHR_JSON_MIN_CAPACITY 256U
+
+///
+/// \brief  One Bit per Byte of a 64 Byte Block.
+///
+typedef struct
+{
+    uint64_t backslash;
+    uint64_t quote;
+    uint64_t whitespace;
+    uint64_t op;
+    uint64_t control;
+} AHR_JsonMasks_t;
+
+///
+/// \brief  What Stage 2 accepts next.
+///
+typedef enum
+{
+    AHR_JSON_EXPECT_VALUE,
+    ///
+    /// \brief  Behind '[', a Value or ']'.
+    ///
+    AHR_JSON_EXPECT_FIRST_VALUE,
+    AHR_JSON_EXPECT_KEY,
+    ///
+    /// \brief  Behind '{', a Key or '}'.
+    ///
+    AHR_JSON_EXPECT_FIRST_KEY,
+    AHR_JSON_EXPECT_COLON,
+    ///
+    /// \brief  Behind a Value in a Container, ',' or the closing Bracket.
+    ///
+    AHR_JSON_EXPECT_NEXT,
+    ///
+    /// \brief  Behind the Root Value.
+    ///
+    AHR_JSON_EXPECT_END
+} AHR_JsonExpect_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Grow "array" to hold at least "wanted" Elements of "size" Bytes.
+/// \returns    The Array, NULL if out of Memory. "array" and "capacity" are unchanged then.
+///
+static void* AHR_JsonGrow(void *array, size_t *capacity, size_t wanted, size_t size);
+///
+/// \brief  Stage 1 for the Blocks between "indexer->scanned" and "end".
+///
+static void AHR_JsonIndexerScan(AHR_JsonIndexer_t *indexer, const char *body, size_t end);
+static void AHR_JsonClassifyScalar(const char *block, AHR_JsonMasks_t *masks);
+#if defined(AHR_JSON_INDEX_SSE2)
+static void AHR_JsonScanSse2(AHR_JsonIndexer_t *indexer, const char *body, size_t end);
+#endif
+#if defined(AHR_JSON_INDEX_AVX2)
+static void AHR_JsonScanAvx2(AHR_JsonIndexer_t *indexer, const char *body, size_t end)
+    __attribute__((target("avx2")));
+#endif
+///
+/// \brief  Mask out String Contents and record the structural Offsets of one Block.
+///
+static void AHR_JsonIndexerBlock(AHR_JsonIndexer_t *indexer, const AHR_JsonMasks_t *masks, size_t base);
+///
+/// \brief  Characters preceded by an odd Number of Backslashes. "carry" tells if the first Character
+///         of the Block is escaped by the last one of the previous Block.
+///
+static uint64_t AHR_JsonEscaped(uint64_t backslash, uint64_t *carry);
+///
+/// \brief  Bit i is the XOR of Bit 0 to Bit i, it is set between an opening and a closing Quote.
+///
+static uint64_t AHR_JsonPrefixXor(uint64_t bits);
+///
+/// \brief  Stage 2, see the Module Description.
+///
+static bool AHR_JsonIndexerBuild(AHR_JsonIndexer_t *indexer, const char *body, size_t nbytes);
+///
+/// \brief  End of the Value starting at Position "i", without trailing Whitespace.
+///
+static size_t AHR_JsonValueEnd(const uint32_t *positions, size_t npositions, const char *body, size_t nbytes, size_t i);
+static bool AHR_JsonValidString(const char *body, size_t begin, size_t end);
+static bool AHR_JsonValidNumber(const char *body, size_t begin, size_t end);
+///
+/// \brief  Length of the UTF-8 Sequence at "data", 0 if it is not valid or longer than "nbytes".
+///
+static size_t AHR_JsonUtf8Length(const unsigned char *data, size_t nbytes);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_JsonIndexer_t AHR_CreateJsonIndexer(void)
+{
+    AHR_JsonIndexer_t indexer;
+    memset(&indexer, 0, sizeof(indexer));
+    return indexer;
+}
+
+void AHR_DestroyJsonIndexer(AHR_JsonIndexer_t *indexer)
+{
+    free(indexer->positions);
+    free(indexer->tokens);
+    free(indexer->stack);
+    *indexer = AHR_CreateJsonIndexer();
+}
+
+void AHR_JsonIndexerReset(AHR_JsonIndexer_t *indexer)
+{
+    indexer->npositions = 0;
+    indexer->ntokens = 0;
+    indexer->scanned = 0;
+    indexer->escaped = 0;
+    indexer->in_string = 0;
+    indexer->scalar = 0;
+    indexer->control = false;
+    indexer->failed = false;
+    indexer->finished = false;
+    indexer->valid = false;
+    indexer->error_offset = 0;
+}
+
+size_t AHR_JsonIndexerCapacityBytes(const AHR_JsonIndexer_t *indexer)
+{
+    return indexer->positions_capacity * sizeof(uint32_t)
+        + indexer->tokens_capacity * sizeof(AHR_JsonToken_t)
+        + indexer->stack_capacity * sizeof(uint32_t);
+}
+
+void AHR_JsonIndexerFeed(AHR_JsonIndexer_t *indexer, const char *body, size_t nbytes)
+{
+    if(indexer->failed || indexer->finished)
+    {
+        return;
+    }
+    if(nbytes > AHR_JSON_MAX_BYTES)
+    {
+        indexer->failed = true;
+        return;
+    }
+    const size_t end = nbytes - (nbytes % AHR_JSON_BLOCK_BYTES);
+    if(end > indexer->scanned)
+    {
+        AHR_JsonIndexerScan(indexer, body, end);
+    }
+}
+
+bool AHR_JsonIndexerFinish(AHR_JsonIndexer_t *indexer, const char *body, size_t nbytes)
+{
+    if(indexer->finished)
+    {
+        return indexer->valid;
+    }
+    AHR_JsonIndexerFeed(indexer, body, nbytes);
+    indexer->finished = true;
+    indexer->valid = false;
+    if(indexer->failed)
+    {
+        indexer->error_offset = nbytes;
+        return false;
+    }
+    if(indexer->scanned < nbytes)
+    {
+        //
+        // The Tail is padded with Whitespace, which neither starts a Value nor ends a String.
+        //
+        char tail[AHR_JSON_BLOCK_BYTES]; // flawfinder: ignore
+        memset(tail, ' ', sizeof(tail));
+        memcpy(tail, &body[indexer->scanned], nbytes - indexer->scanned); // flawfinder: ignore
+        AHR_JsonMasks_t masks;
+        AHR_JsonClassifyScalar(tail, &masks);
+        AHR_JsonIndexerBlock(indexer, &masks, indexer->scanned);
+        indexer->scanned = nbytes;
+    }
+    if(indexer->failed)
+    {
+        indexer->error_offset = nbytes;
+        return false;
+    }
+    if(indexer->control)
+    {
+        return false;
+    }
+    if(indexer->in_string)
+    {
+        //
+        // Unterminated String.
+        //
+        indexer->error_offset = nbytes;
+        return false;
+    }
+    indexer->valid = AHR_JsonIndexerBuild(indexer, body, nbytes);
+    return indexer->valid;
+}
+
+bool AHR_JsonIndexerView(const AHR_JsonIndexer_t *indexer, const char *body, size_t nbytes, AHR_JsonIndex_t *index)
+{
+    assert(NULL != index);
+    const bool valid = indexer->finished && indexer->valid;
+    index->body = body;
+    index->nbytes = nbytes;
+    index->tokens = valid ? indexer->tokens : NULL;
+    index->ntokens = valid ? indexer->ntokens : 0U;
+    index->error_offset = valid ? 0U : indexer->error_offset;
+    return valid;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void* AHR_JsonGrow(void *array, size_t *capacity, size_t wanted, size_t size)
+{
+    if(wanted <= *capacity)
+    {
+        return array;
+    }
+    size_t grown = *capacity > 0 ? *capacity : AHR_JSON_MIN_CAPACITY;
+    while(grown < wanted)
+    {
+        grown *= 2U;
+    }
+    void *data = realloc(array, grown * size);
+    if(data)
+    {
+        *capacity = grown;
+    }
+    return data;
+}
+
+static void AHR_JsonIndexerScan(AHR_JsonIndexer_t *indexer, const char *body, size_t end)
+{
+#if defined(AHR_JSON_INDEX_AVX2)
+    if(__builtin_cpu_supports("avx2"))
+    {
+        AHR_JsonScanAvx2(indexer, body, end);
+    }
+    else
+    {
+        AHR_JsonScanSse2(indexer, body, end);
+    }
+#elif defined(AHR_JSON_INDEX_SSE2)
+    AHR_JsonScanSse2(indexer, body, end);
+#else
+    AHR_JsonMasks_t masks;
+    for(;indexer->scanned < end && !indexer->failed;indexer->scanned+=AHR_JSON_BLOCK_BYTES)
+    {
+        AHR_JsonClassifyScalar(&body[indexer->scanned], &masks);
+        AHR_JsonIndexerBlock(indexer, &masks, indexer->scanned);
+    }
+#endif
+}
+
+static void AHR_JsonClassifyScalar(const char *block, AHR_JsonMasks_t *masks)
+{
+    memset(masks, 0, sizeof(*masks));
+    for(unsigned int i=0;i<AHR_JSON_BLOCK_BYTES;++i)
+    {
+        const unsigned char c = (unsigned char)block[i];
+        const uint64_t bit = 1ULL << i;
+        switch(c)
+        {
+            case '\\':
+                masks->backslash |= bit;
+                break;
+            case '"':
+                masks->quote |= bit;
+                break;
+            case ' ':
+                masks->whitespace |= bit;
+                break;
+            case '\t':
+            case '\n':
+            case '\r':
+                masks->whitespace |= bit;
+                masks->control |= bit;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                masks->op |= bit;
+                break;
+            default:
+                if(c < 0x20U)
+                {
+                    masks->control |= bit;
+                }
+                break;
+        }
+    }
+}
+
+#if defined(AHR_JSON_INDEX_SSE2)
+static void AHR_JsonScanSse2(AHR_JsonIndexer_t *indexer, const char *body, size_t end)
+{
+    const __m128i backslashes = _mm_set1_epi8('\\');
+    const __m128i quotes = _mm_set1_epi8('"');
+    const __m128i spaces = _mm_set1_epi8(' ');
+    const __m128i tabs = _mm_set1_epi8('\t');
+    const __m128i lfs = _mm_set1_epi8('\n');
+    const __m128i crs = _mm_set1_epi8('\r');
+    //
+    // '{' | 0x20 == '{' and '[' | 0x20 == '{', the same holds for '}' and ']'.
+    //
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i opening = _mm_set1_epi8('{');
+    const __m128i closing = _mm_set1_epi8('}');
+    const __m128i colons = _mm_set1_epi8(':');
+    const __m128i commas = _mm_set1_epi8(',');
+    const __m128i controls = _mm_set1_epi8(0x1F);
+    AHR_JsonMasks_t masks;
+    for(;indexer->scanned < end && !indexer->failed;indexer->scanned+=AHR_JSON_BLOCK_BYTES)
+    {
+        memset(&masks, 0, sizeof(masks));
+        for(unsigned int i=0;i<AHR_JSON_BLOCK_BYTES;i+=16U)
+        {
+            const __m128i block = _mm_loadu_si128((const __m128i*)&body[indexer->scanned + i]);
+            const __m128i folded = _mm_or_si128(block, case_bit);
+            masks.backslash |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, backslashes)) << i;
+            masks.quote |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, quotes)) << i;
+            masks.whitespace |= (uint64_t)(uint32_t)_mm_movemask_epi8(
+                _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(block, spaces), _mm_cmpeq_epi8(block, tabs)),
+                    _mm_or_si128(_mm_cmpeq_epi8(block, lfs), _mm_cmpeq_epi8(block, crs))
+                )
+            ) << i;
+            masks.op |= (uint64_t)(uint32_t)_mm_movemask_epi8(
+                _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(folded, opening), _mm_cmpeq_epi8(folded, closing)),
+                    _mm_or_si128(_mm_cmpeq_epi8(block, colons), _mm_cmpeq_epi8(block, commas))
+                )
+            ) << i;
+            masks.control |= (uint64_t)(uint32_t)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_min_epu8(block, controls), block)
+            ) << i;
+        }
+        AHR_JsonIndexerBlock(indexer, &masks, indexer->scanned);
+    }
+}
+#endif
+
+#if defined(AHR_JSON_INDEX_AVX2)
+static void AHR_JsonScanAvx2(AHR_JsonIndexer_t *indexer, const char *body, size_t end)
+{
+    const __m256i backslashes = _mm256_set1_epi8('\\');
+    const __m256i quotes = _mm256_set1_epi8('"');
+    const __m256i spaces = _mm256_set1_epi8(' ');
+    const __m256i tabs = _mm256_set1_epi8('\t');
+    const __m256i lfs = _mm256_set1_epi8('\n');
+    const __m256i crs = _mm256_set1_epi8('\r');
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i opening = _mm256_set1_epi8('{');
+    const __m256i closing = _mm256_set1_epi8('}');
+    const __m256i colons = _mm256_set1_epi8(':');
+    const __m256i commas = _mm256_set1_epi8(',');
+    const __m256i controls = _mm256_set1_epi8(0x1F);
+    AHR_JsonMasks_t masks;
+    for(;indexer->scanned < end && !indexer->failed;indexer->scanned+=AHR_JSON_BLOCK_BYTES)
+    {
+        memset(&masks, 0, sizeof(masks));
+        for(unsigned int i=0;i<AHR_JSON_BLOCK_BYTES;i+=32U)
+        {
+            const __m256i block = _mm256_loadu_si256((const __m256i*)&body[indexer->scanned + i]);
+            const __m256i folded = _mm256_or_si256(block, case_bit);
+            masks.backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, backslashes)) << i;
+            masks.quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, quotes)) << i;
+            masks.whitespace |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(block, spaces), _mm256_cmpeq_epi8(block, tabs)),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(block, lfs), _mm256_cmpeq_epi8(block, crs))
+                )
+            ) << i;
+            masks.op |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(folded, opening), _mm256_cmpeq_epi8(folded, closing)),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(block, colons), _mm256_cmpeq_epi8(block, commas))
+                )
+            ) << i;
+            masks.control |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(_mm256_min_epu8(block, controls), block)
+            ) << i;
+        }
+        AHR_JsonIndexerBlock(indexer, &masks, indexer->scanned);
+    }
+}
+#endif
+
+static void AHR_JsonIndexerBlock(AHR_JsonIndexer_t *indexer, const AHR_JsonMasks_t *masks, size_t base)
+{
+    const uint64_t escaped = AHR_JsonEscaped(masks->backslash, &indexer->escaped);
+    const uint64_t quote = masks->quote & ~escaped;
+    //
+    // Set from an opening Quote up to (not including) its closing Quote.
+    //
+    const uint64_t in_string = AHR_JsonPrefixXor(quote) ^ indexer->in_string;
+    indexer->in_string = 0ULL - (in_string >> 63);
+    //
+    // String Contents and closing Quotes, neither starts a Value.
+    //
+    const uint64_t string_tail = in_string ^ quote;
+    const uint64_t control = masks->control & in_string;
+    if(control && !indexer->control)
+    {
+        indexer->control = true;
+        indexer->error_offset = base + (size_t)__builtin_ctzll(control);
+    }
+    //
+    // A Scalar starts at every Byte which is neither an Operator nor Whitespace and does not follow
+    // another such Byte. Quotes do not continue a Scalar, so a String directly behind a Value starts a new one.
+    //
+    const uint64_t scalar = ~(masks->op | masks->whitespace);
+    const uint64_t nonquote_scalar = scalar & ~quote;
+    const uint64_t follows_scalar = (nonquote_scalar << 1) | indexer->scalar;
+    indexer->scalar = nonquote_scalar >> 63;
+    uint64_t structurals = (masks->op | (scalar & ~follows_scalar)) & ~string_tail;
+    if(!structurals)
+    {
+        return;
+    }
+
+    uint32_t *positions = AHR_JsonGrow(
+        indexer->positions,
+        &indexer->positions_capacity,
+        indexer->npositions + (size_t)__builtin_popcountll(structurals),
+        sizeof(uint32_t)
+    );
+    if(!positions)
+    {
+        indexer->failed = true;
+        return;
+    }
+    indexer->positions = positions;
+    size_t n = indexer->npositions;
+    while(structurals)
+    {
+        positions[n++] = (uint32_t)(base + (size_t)__builtin_ctzll(structurals));
+        structurals &= structurals - 1U;
+    }
+    indexer->npositions = n;
+}
+
+static uint64_t AHR_JsonEscaped(uint64_t backslash, uint64_t *carry)
+{
+    const uint64_t even_bits = 0x5555555555555555ULL;
+    //
+    // A Backslash escaped by the previous Block does not escape anything itself.
+    //
+    backslash &= ~*carry;
+    const uint64_t follows_escape = (backslash << 1) | *carry;
+    //
+    // Adding the Starts of the Runs which begin on odd Bits to the Backslashes carries through each Run,
+    // which flips the Parity of those Runs.
+    //
+    const uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+    const uint64_t even_starts = odd_starts + backslash;
+    *carry = even_starts < odd_starts ? 1U : 0U;
+    return (even_bits ^ (even_starts << 1)) & follows_escape;
+}
+
+static uint64_t AHR_JsonPrefixXor(uint64_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+static bool AHR_JsonIndexerBuild(AHR_JsonIndexer_t *indexer, const char *body, size_t nbytes)
+{
+    //
+    // Every Token starts at a recorded Position, so there can not be more Tokens than Positions.
+    //
+    AHR_JsonToken_t *tokens = AHR_JsonGrow(
+        indexer->tokens,
+        &indexer->tokens_capacity,
+        indexer->npositions,
+        sizeof(AHR_JsonToken_t)
+    );
+    if(!tokens)
+    {
+        indexer->error_offset = nbytes;
+        return false;
+    }
+    indexer->tokens = tokens;
+
+    const uint32_t *positions = indexer->positions;
+    const size_t npositions = indexer->npositions;
+    size_t ntokens = 0;
+    size_t depth = 0;
+    //
+    // The innermost open Container.
+    //
+    AHR_JsonToken_t *parent = NULL;
+    bool object = false;
+    AHR_JsonExpect_t expect = AHR_JSON_EXPECT_VALUE;
+    size_t i = 0;
+    for(;i<npositions;++i)
+    {
+        const size_t offset = positions[i];
+        const char c = body[offset];
+        if(
+            (']' == c || '}' == c) 
+            && (
+                AHR_JSON_EXPECT_NEXT == expect 
+                || (AHR_JSON_EXPECT_FIRST_VALUE == expect && ']' == c) 
+                || (AHR_JSON_EXPECT_FIRST_KEY == expect && '}' == c)
+            )
+        )
+        {
+            if((object ? '}' : ']') != c)
+            {
+                goto on_error;
+            }
+            parent->length = (uint32_t)(offset - parent->offset + 1U);
+            parent->next = (uint32_t)ntokens;
+            --depth;
+            parent = depth > 0 ? &tokens[indexer->stack[depth - 1U]] : NULL;
+            object = parent && '{' == body[parent->offset];
+            expect = parent ? AHR_JSON_EXPECT_NEXT : AHR_JSON_EXPECT_END;
+            continue;
+        }
+        switch(expect)
+        {
+            case AHR_JSON_EXPECT_VALUE:
+            case AHR_JSON_EXPECT_FIRST_VALUE:
+            {
+                //
+                // Elements are counted by their Value, Members by their Key.
+                //
+                if(parent && !object)
+                {
+                    ++parent->count;
+                }
+                if('{' == c || '[' == c)
+                {
+                    if(depth == indexer->stack_capacity)
+                    {
+                        uint32_t *stack = AHR_JsonGrow(indexer->stack, &indexer->stack_capacity, depth + 1U, sizeof(uint32_t));
+                        if(!stack)
+                        {
+                            goto on_error;
+                        }
+                        indexer->stack = stack;
+                    }
+                    indexer->stack[depth++] = (uint32_t)ntokens;
+                    parent = &tokens[ntokens];
+                    *parent = (AHR_JsonToken_t){.offset = (uint32_t)offset, .length = 0, .next = 0, .count = 0};
+                    ++ntokens;
+                    object = '{' == c;
+                    expect = object ? AHR_JSON_EXPECT_FIRST_KEY : AHR_JSON_EXPECT_FIRST_VALUE;
+                    break;
+                }
+                const size_t end = AHR_JsonValueEnd(positions, npositions, body, nbytes, i);
+                bool valid = false;
+                switch(c)
+                {
+                    case '"':
+                        valid = AHR_JsonValidString(body, offset, end);
+                        break;
+                    case 't':
+                        valid = 4U == end - offset && 0 == memcmp(&body[offset], "true", 4);
+                        break;
+                    case 'f':
+                        valid = 5U == end - offset && 0 == memcmp(&body[offset], "false", 5);
+                        break;
+                    case 'n':
+                        valid = 4U == end - offset && 0 == memcmp(&body[offset], "null", 4);
+                        break;
+                    default:
+                        valid = AHR_JsonValidNumber(body, offset, end);
+                        break;
+                }
+                if(!valid)
+                {
+                    goto on_error;
+                }
+                tokens[ntokens] = (AHR_JsonToken_t){
+                    .offset = (uint32_t)offset, 
+                    .length = (uint32_t)(end - offset), 
+                    .next = (uint32_t)(ntokens + 1U), 
+                    .count = 0
+                };
+                ++ntokens;
+                expect = parent ? AHR_JSON_EXPECT_NEXT : AHR_JSON_EXPECT_END;
+                break;
+            }
+            case AHR_JSON_EXPECT_KEY:
+            case AHR_JSON_EXPECT_FIRST_KEY:
+            {
+                const size_t end = AHR_JsonValueEnd(positions, npositions, body, nbytes, i);
+                if('"' != c || !AHR_JsonValidString(body, offset, end))
+                {
+                    goto on_error;
+                }
+                tokens[ntokens] = (AHR_JsonToken_t){
+                    .offset = (uint32_t)offset, 
+                    .length = (uint32_t)(end - offset), 
+                    .next = (uint32_t)(ntokens + 1U), 
+                    .count = 0
+                };
+                ++ntokens;
+                ++parent->count;
+                expect = AHR_JSON_EXPECT_COLON;
+                break;
+            }
+            case AHR_JSON_EXPECT_COLON:
+                if(':' != c)
+                {
+                    goto on_error;
+                }
+                expect = AHR_JSON_EXPECT_VALUE;
+                break;
+            case AHR_JSON_EXPECT_NEXT:
+                if(',' != c)
+                {
+                    goto on_error;
+                }
+                expect = object ? AHR_JSON_EXPECT_KEY : AHR_JSON_EXPECT_VALUE;
+                break;
+            case AHR_JSON_EXPECT_END:
+            default:
+                goto on_error;
+        }
+    }
+    indexer->ntokens = ntokens;
+    indexer->error_offset = nbytes;
+    return AHR_JSON_EXPECT_END == expect;
+
+    on_error:
+    indexer->ntokens = ntokens;
+    indexer->error_offset = positions[i];
+    return false;
+}
+
+static size_t AHR_JsonValueEnd(const uint32_t *positions, size_t npositions, const char *body, size_t nbytes, size_t i)
+{
+    size_t end = (i + 1U) < npositions ? positions[i + 1U] : nbytes;
+    while(end > positions[i])
+    {
+        const char c = body[end - 1U];
+        if(' ' != c && '\t' != c && '\n' != c && '\r' != c)
+        {
+            break;
+        }
+        --end;
+    }
+    return end;
+}
+
+static bool AHR_JsonValidString(const char *body, size_t begin, size_t end)
+{
+    //
+    // Stage 1 guarantees that the Value ends at its closing Quote if it has one, and that the String
+    // holds no unescaped Quotes or Control Characters. Only Escapes and UTF-8 are left.
+    //
+    if(end - begin < 2U || '"' != body[end - 1U])
+    {
+        return false;
+    }
+    const unsigned char *data = (const unsigned char*)body;
+    const size_t close = end - 1U;
+    size_t i = begin + 1U;
+    while(i < close)
+    {
+        if(i + 8U <= close)
+        {
+            uint64_t word;
+            memcpy(&word, &data[i], sizeof(word)); // flawfinder: ignore
+            const uint64_t backslashes = word ^ 0x5C5C5C5C5C5C5C5CULL;
+            const uint64_t has_backslash = (backslashes - 0x0101010101010101ULL) & ~backslashes & 0x8080808080808080ULL;
+            if(!has_backslash && !(word & 0x8080808080808080ULL))
+            {
+                i += 8U;
+                continue;
+            }
+        }
+        const unsigned char c = data[i];
+        if(c < 0x80U && '\\' != c)
+        {
+            ++i;
+        }
+        else if('\\' == c)
+        {
+            if(i + 1U >= close)
+            {
+                return false;
+            }
+            switch(data[i + 1U])
+            {
+                case '"':
+                case '\\':
+                case '/':
+                case 'b':
+                case 'f':
+                case 'n':
+                case 'r':
+                case 't':
+                    i += 2U;
+                    break;
+                case 'u':
+                    if(i + 6U > close)
+                    {
+                        return false;
+                    }
+                    for(size_t k=i+2U;k<i+6U;++k)
+                    {
+                        const unsigned char h = data[k];
+                        if(!((h >= '0' && h <= '9') || (h >= 'a' && h <= 'f') || (h >= 'A' && h <= 'F')))
+                        {
+                            return false;
+                        }
+                    }
+                    i += 6U;
+                    break;
+                default:
+                    return false;
+            }
+        }
+        else
+        {
+            const size_t n = AHR_JsonUtf8Length(&data[i], close - i);
+            if(0 == n)
+            {
+                return false;
+            }
+            i += n;
+        }
+    }
+    return true;
+}
+
+static bool AHR_JsonValidNumber(const char *body, size_t begin, size_t end)
+{
+    size_t i = begin;
+    if(i < end && '-' == body[i])
+    {
+        ++i;
+    }
+    if(i >= end)
+    {
+        return false;
+    }
+    if('0' == body[i])
+    {
+        ++i;
+    }
+    else if(body[i] >= '1' && body[i] <= '9')
+    {
+        while(i < end && body[i] >= '0' && body[i] <= '9')
+        {
+            ++i;
+        }
+    }
+    else
+    {
+        return false;
+    }
+    if(i < end && '.' == body[i])
+    {
+        const size_t digits = ++i;
+        while(i < end && body[i] >= '0' && body[i] <= '9')
+        {
+            ++i;
+        }
+        if(i == digits)
+        {
+            return false;
+        }
+    }
+    if(i < end && ('e' == body[i] || 'E' == body[i]))
+    {
+        ++i;
+        if(i < end && ('+' == body[i] || '-' == body[i]))
+        {
+            ++i;
+        }
+        const size_t digits = i;
+        while(i < end && body[i] >= '0' && body[i] <= '9')
+        {
+            ++i;
+        }
+        if(i == digits)
+        {
+            return false;
+        }
+    }
+    return i == end;
+}
+
+static size_t AHR_JsonUtf8Length(const unsigned char *data, size_t nbytes)
+{
+    const unsigned char c = data[0];
+    size_t n = 0;
+    unsigned char low = 0x80U;
+    unsigned char high = 0xBFU;
+    if(c >= 0xC2U && c <= 0xDFU)
+    {
+        n = 2;
+    }
+    else if(c >= 0xE0U && c <= 0xEFU)
+    {
+        n = 3;
+        //
+        // No overlong Encodings and no Surrogates.
+        //
+        low = 0xE0U == c ? 0xA0U : 0x80U;
+        high = 0xEDU == c ? 0x9FU : 0xBFU;
+    }
+    else if(c >= 0xF0U && c <= 0xF4U)
+    {
+        n = 4;
+        low = 0xF0U == c ? 0x90U : 0x80U;
+        high = 0xF4U == c ? 0x8FU : 0xBFU;
+    }
+    if(0 == n || n > nbytes || data[1] < low || data[1] > high)
+    {
+        return 0;
+    }
+    for(size_t i=2;i<n;++i)
+    {
+        if(data[i] < 0x80U || data[i] > 0xBFU)
+        {
+            return 0;
+        }
+    }
+    return n;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
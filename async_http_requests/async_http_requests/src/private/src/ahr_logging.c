@@ -4,17 +4,100 @@
 //
 
 #include <async_http_requests/private/ahr_logging.h>
+#include <external/async_http_requests/ahr_thread.h>
 
 #include <stdlib.h>
 #include <assert.h>
 #include <pthread.h>
 #include <stdarg.h>
-#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
 
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
 
+///
+/// \brief  Arguments and Bytes of copied Strings one Record holds.
+///
+#define AHR_LOG_MAX_ARGS 12U
+#define AHR_LOG_STRING_BYTES 160U
+///
+/// \brief  Longest formatted Message, longer Messages are truncated.
+///
+#define AHR_LOG_MESSAGE_LEN 512U
+///
+/// \brief  Longest single Conversion Specification, f.e. "%-+#012.6llx".
+///
+#define AHR_LOG_SPEC_LEN 32U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+typedef enum
+{
+    AHR_LOG_LENGTH_NONE,
+    AHR_LOG_LENGTH_HH,
+    AHR_LOG_LENGTH_H,
+    AHR_LOG_LENGTH_L,
+    AHR_LOG_LENGTH_LL,
+    AHR_LOG_LENGTH_J,
+    AHR_LOG_LENGTH_Z,
+    AHR_LOG_LENGTH_T,
+    AHR_LOG_LENGTH_LONG_DOUBLE
+} AHR_LogLength_t;
+
+typedef union
+{
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void *p;
+} AHR_LogArg_t;
+
+typedef struct
+{
+    const char *format;
+    size_t loglevel;
+    size_t nargs;
+    AHR_LogArg_t args[AHR_LOG_MAX_ARGS];
+    ///
+    /// \brief  Copies of "%s" Arguments, "args" hold their Offsets.
+    ///
+    char strings[AHR_LOG_STRING_BYTES]; // flawfinder: ignore
+} AHR_LogRecord_t;
+
+///
+/// \brief  A Thread which logged. It is referenced by the Thread until it exits and by every Ring it owns.
+///
+typedef struct
+{
+    atomic_bool alive;
+    atomic_size_t refs;
+} AHR_LogThread_t;
+
+///
+/// \brief  Single Producer, single Consumer Ring. The Producer is the owning Thread,
+///         the Consumer whoever drains while holding the Mutex of the Logger.
+///         Once its Thread exited, the Ring is taken over by the next Thread which logs for the first Time.
+///
+typedef struct AHR_LogRing
+{
+    _Alignas(64) atomic_size_t head;
+    _Alignas(64) atomic_size_t tail;
+    ///
+    /// \brief  The owning Thread. Only changed while holding "rings_mutex" of the Logger.
+    ///
+    _Atomic(AHR_LogThread_t*) owner;
+    struct AHR_LogRing *next;
+    size_t mask;
+    AHR_LogRecord_t records[];
+} AHR_LogRing_t;
+
 struct AHR_Logger
 {
     pthread_mutex_t mutex;
@@ -22,13 +105,86 @@ struct AHR_Logger
     AHR_LogInfo_t info;
     AHR_LogWarning_t warning;
     AHR_LogError_t error;
-    size_t loglevel;
+    atomic_size_t loglevel;
+    ///
+    /// \brief  Unique over all Loggers of the Process, a Logger may be created at the Address of a destroyed one.
+    ///
+    uint64_t id;
+    ///
+    /// \brief  Rings of all Threads which logged, Rings are only added until the Logger is destroyed.
+    ///         Their Number is bounded by the most Threads which logged at the same Time.
+    ///
+    _Atomic(AHR_LogRing_t*) rings;
+    ///
+    /// \brief  Serializes Threads which take over the Ring of an exited Thread.
+    ///
+    pthread_mutex_t rings_mutex;
+    size_t ring_capacity;
+    atomic_size_t dropped;
+    ///
+    /// \brief  Reported dropped Messages, only accessed while holding "mutex".
+    ///
+    size_t dropped_reported;
+
+    AHR_Thread_t drain_thread;
+    pthread_mutex_t drain_mutex;
+    pthread_cond_t drain_cond;
+    size_t drain_interval_ms;
+    bool stop;
 };
 
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
 
+static atomic_uint_fast64_t ahr_log_next_id = 1U;
+///
+/// \brief  Its Destructor marks the AHR_LogThread_t of an exiting Thread as gone.
+///
+static pthread_once_t ahr_log_thread_once = PTHREAD_ONCE_INIT;
+static pthread_key_t ahr_log_thread_key;
+static _Thread_local AHR_LogThread_t *ahr_log_thread = NULL;
+///
+/// \brief  Ring of the Thread for the Logger it used last.
+///
+static _Thread_local uint64_t ahr_log_thread_logger = 0U;
+static _Thread_local AHR_LogRing_t *ahr_log_thread_ring = NULL;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Ring of the calling Thread, taken over from an exited Thread or created on first Use.
+/// \returns    NULL if no Memory is available.
+///
+static AHR_LogRing_t* AHR_LoggerRing(AHR_Logger_t logger);
+///
+/// \brief  AHR_LogThread_t of the calling Thread, created on first Use.
+/// \returns    NULL if no Memory is available.
+///
+static AHR_LogThread_t* AHR_LogThreadSelf(void);
+static void AHR_LogThreadCreateKey(void);
+///
+/// \brief  Destructor of ahr_log_thread_key, runs when a Thread which logged exits.
+///
+static void AHR_LogThreadExit(void *arg);
+static void AHR_LogThreadRelease(AHR_LogThread_t *thread);
+///
+/// \brief  Copy the Arguments "format" refers to into "record".
+///
+static void AHR_LogCapture(AHR_LogRecord_t *record, const char *format, va_list args);
+///
+/// \brief  Format "record" into "message".
+///
+static void AHR_LogRender(const AHR_LogRecord_t *record, char *message, size_t nbytes);
+static void AHR_LoggerDeliver(AHR_Logger_t logger, size_t loglevel, const char *message);
+static void* AHR_LoggerDrainMain(void *arg);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
 AHR_Logger_t AHR_CreateLogger(
     void *arg,
     AHR_LogInfo_t info,
@@ -36,65 +192,696 @@ AHR_Logger_t AHR_CreateLogger(
     AHR_LogError_t error
 )
 {
-    assert(info != NULL);
-    assert(warning != NULL);
-    assert(error != NULL);
+    const AHR_LoggerOptions_t options = {
+        .arg = arg,
+        .info = info,
+        .warning = warning,
+        .error = error,
+        .ring_capacity = 0,
+        .drain_interval_ms = 0,
+        .manual_flush = false
+    };
+    return AHR_CreateLoggerWithOptions(&options);
+}
+
+AHR_Logger_t AHR_CreateLoggerWithOptions(const AHR_LoggerOptions_t *options)
+{
+    assert(NULL != options);
+    assert(options->info != NULL);
+    assert(options->warning != NULL);
+    assert(options->error != NULL);
 
-    struct AHR_Logger *logger = malloc(sizeof(struct AHR_Logger));    
+    struct AHR_Logger *logger = malloc(sizeof(struct AHR_Logger));
     if(!logger)
     {
         return NULL;
     }
 
     pthread_mutex_init(&logger->mutex, NULL);
+    pthread_mutex_init(&logger->rings_mutex, NULL);
+    pthread_mutex_init(&logger->drain_mutex, NULL);
+    pthread_cond_init(&logger->drain_cond, NULL);
 
-    logger->arg = arg;
-    logger->info = info;
-    logger->warning = warning;
-    logger->error = error;
+    logger->arg = options->arg;
+    logger->info = options->info;
+    logger->warning = options->warning;
+    logger->error = options->error;
 
-    logger->loglevel = AHR_LOGLEVEL_INFO;
+    atomic_init(&logger->loglevel, AHR_LOGLEVEL_INFO);
+    logger->id = atomic_fetch_add(&ahr_log_next_id, 1U);
+    atomic_init(&logger->rings, NULL);
+    logger->ring_capacity = 1U;
+    const size_t capacity = options->ring_capacity > 0 ? options->ring_capacity : AHR_LOG_DEFAULT_RING_CAPACITY;
+    while(logger->ring_capacity < capacity)
+    {
+        logger->ring_capacity <<= 1U;
+    }
+    atomic_init(&logger->dropped, 0U);
+    logger->dropped_reported = 0;
+
+    logger->drain_interval_ms = options->drain_interval_ms > 0
+        ? options->drain_interval_ms
+        : AHR_LOG_DEFAULT_DRAIN_INTERVAL_MS;
+    logger->stop = false;
+    logger->drain_thread = options->manual_flush ? NULL : AHR_CreateThread(AHR_LoggerDrainMain, logger);
 
     return logger;
 }
 
 void AHR_DestroyLogger(AHR_Logger_t *logger)
 {
+    if(!*logger)
+    {
+        return;
+    }
+    if((*logger)->drain_thread)
+    {
+        pthread_mutex_lock(&(*logger)->drain_mutex);
+        (*logger)->stop = true;
+        pthread_cond_signal(&(*logger)->drain_cond);
+        pthread_mutex_unlock(&(*logger)->drain_mutex);
+        AHR_JoinThread((*logger)->drain_thread, NULL);
+        AHR_DestroyThread(&(*logger)->drain_thread);
+    }
+    AHR_LoggerFlush(*logger);
+
+    AHR_LogRing_t *ring = atomic_load(&(*logger)->rings);
+    while(ring)
+    {
+        AHR_LogRing_t *next = ring->next;
+        AHR_LogThreadRelease(atomic_load(&ring->owner));
+        free(ring);
+        ring = next;
+    }
+    pthread_cond_destroy(&(*logger)->drain_cond);
+    pthread_mutex_destroy(&(*logger)->drain_mutex);
+    pthread_mutex_destroy(&(*logger)->rings_mutex);
+    pthread_mutex_destroy(&(*logger)->mutex);
     free(*logger);
     *logger = NULL;
 }
 
+void AHR_LoggerFlush(AHR_Logger_t logger)
+{
+    assert(NULL != logger);
+    char message[AHR_LOG_MESSAGE_LEN]; // flawfinder: ignore
+
+    pthread_mutex_lock(&logger->mutex);
+    const size_t dropped = atomic_load_explicit(&logger->dropped, memory_order_relaxed);
+    if(dropped != logger->dropped_reported)
+    {
+        snprintf(message, sizeof(message), "%zu Log Messages dropped, the Ring was full.", dropped - logger->dropped_reported);
+        logger->dropped_reported = dropped;
+        AHR_LoggerDeliver(logger, AHR_LOGLEVEL_WARNING, message);
+    }
+    for(AHR_LogRing_t *ring = atomic_load_explicit(&logger->rings, memory_order_acquire);ring;ring = ring->next)
+    {
+        const size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        for(;tail != head;++tail)
+        {
+            const AHR_LogRecord_t *record = &ring->records[tail & ring->mask];
+            AHR_LogRender(record, message, sizeof(message));
+            AHR_LoggerDeliver(logger, record->loglevel, message);
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+    pthread_mutex_unlock(&logger->mutex);
+}
+
+size_t AHR_LoggerDropped(AHR_Logger_t logger)
+{
+    assert(NULL != logger);
+    return atomic_load_explicit(&logger->dropped, memory_order_relaxed);
+}
+
 void AHR_LoggerSetLoglevel(AHR_Logger_t logger, size_t loglevel)
 {
     assert(NULL != logger);
-    if(loglevel >= AHR_LOGLEVEL_ERROR && loglevel < AHR_LOGLEVEL_INFO) // cppcheck-suppress unsignedPositive
+    if(loglevel <= AHR_LOGLEVEL_INFO)
     {
-        logger->loglevel = loglevel;
+        atomic_store_explicit(&logger->loglevel, loglevel, memory_order_relaxed);
     }
 }
 
-void AHR_LogInfo(AHR_Logger_t logger, const char *msg)
+void AHR_LogFormat(size_t loglevel, AHR_Logger_t logger, const char *format, ...)
 {
     assert(NULL != logger);
-    if(logger && (logger->loglevel >= AHR_LOGLEVEL_INFO)) // cppcheck-suppress unsignedPositive
+    assert(NULL != format);
+    if(!logger || loglevel > atomic_load_explicit(&logger->loglevel, memory_order_relaxed))
+    {
+        return;
+    }
+    AHR_LogRing_t *ring = AHR_LoggerRing(logger);
+    if(!ring)
+    {
+        atomic_fetch_add_explicit(&logger->dropped, 1U, memory_order_relaxed);
+        return;
+    }
+    const size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if(head - atomic_load_explicit(&ring->tail, memory_order_acquire) > ring->mask)
+    {
+        atomic_fetch_add_explicit(&logger->dropped, 1U, memory_order_relaxed);
+        return;
+    }
+    AHR_LogRecord_t *record = &ring->records[head & ring->mask];
+    record->format = format;
+    record->loglevel = loglevel;
+    va_list args;
+    va_start(args, format);
+    AHR_LogCapture(record, format, args);
+    va_end(args);
+    atomic_store_explicit(&ring->head, head + 1U, memory_order_release);
+
+    if(AHR_LOGLEVEL_ERROR == loglevel && logger->drain_thread)
     {
-        logger->info(logger->arg, msg);
+        pthread_cond_signal(&logger->drain_cond);
     }
 }
 
+void AHR_LogInfo(AHR_Logger_t logger, const char *msg)
+{
+    AHR_LogFormat(AHR_LOGLEVEL_INFO, logger, "%s", msg);
+}
+
 void AHR_LogWarning(AHR_Logger_t logger, const char *msg)
 {
-    assert(NULL != logger);
-    if(logger && (logger->loglevel >= AHR_LOGLEVEL_WARNING)) // cppcheck-suppress unsignedPositive
-        logger->warning(logger->arg, msg);
+    AHR_LogFormat(AHR_LOGLEVEL_WARNING, logger, "%s", msg);
 }
 
 void AHR_LogError(AHR_Logger_t logger, const char *msg)
 {
-    assert(NULL != logger);
-    if(logger && (logger->loglevel >= AHR_LOGLEVEL_ERROR)) // cppcheck-suppress unsignedPositive
-        logger->error(logger->arg, msg);
+    AHR_LogFormat(AHR_LOGLEVEL_ERROR, logger, "%s", msg);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static AHR_LogRing_t* AHR_LoggerRing(AHR_Logger_t logger)
+{
+    if(ahr_log_thread_logger == logger->id)
+    {
+        return ahr_log_thread_ring;
+    }
+    AHR_LogThread_t *self = AHR_LogThreadSelf();
+    if(!self)
+    {
+        return NULL;
+    }
+    AHR_LogRing_t *ring = atomic_load_explicit(&logger->rings, memory_order_acquire);
+    while(ring && atomic_load_explicit(&ring->owner, memory_order_relaxed) != self)
+    {
+        ring = ring->next;
+    }
+    if(!ring)
+    {
+        //
+        // The Ring of an exited Thread is taken over as is. Its Records are still drained in Order, the
+        // Thread does not produce anymore, so there is again a single Producer. Only Threads taking over
+        // Rings change an Owner, while they hold "rings_mutex" the Owners stay referenced.
+        //
+        pthread_mutex_lock(&logger->rings_mutex);
+        for(ring = atomic_load_explicit(&logger->rings, memory_order_acquire);ring;ring = ring->next)
+        {
+            AHR_LogThread_t *owner = atomic_load_explicit(&ring->owner, memory_order_relaxed);
+            if(!atomic_load_explicit(&owner->alive, memory_order_acquire))
+            {
+                atomic_fetch_add_explicit(&self->refs, 1U, memory_order_relaxed);
+                atomic_store_explicit(&ring->owner, self, memory_order_relaxed);
+                AHR_LogThreadRelease(owner);
+                break;
+            }
+        }
+        pthread_mutex_unlock(&logger->rings_mutex);
+    }
+    if(!ring)
+    {
+        //
+        // aligned_alloc() wants a Multiple of the Alignment.
+        //
+        const size_t nbytes = (sizeof(AHR_LogRing_t) + logger->ring_capacity * sizeof(AHR_LogRecord_t) + 63U) & ~(size_t)63U;
+        ring = aligned_alloc(64U, nbytes);
+        if(!ring)
+        {
+            return NULL;
+        }
+        atomic_init(&ring->head, 0U);
+        atomic_init(&ring->tail, 0U);
+        atomic_fetch_add_explicit(&self->refs, 1U, memory_order_relaxed);
+        atomic_init(&ring->owner, self);
+        ring->mask = logger->ring_capacity - 1U;
+        ring->next = atomic_load_explicit(&logger->rings, memory_order_relaxed);
+        while(!atomic_compare_exchange_weak_explicit(
+            &logger->rings,
+            &ring->next,
+            ring,
+            memory_order_release,
+            memory_order_relaxed
+        ));
+    }
+    ahr_log_thread_logger = logger->id;
+    ahr_log_thread_ring = ring;
+    return ring;
+}
+
+static AHR_LogThread_t* AHR_LogThreadSelf(void)
+{
+    if(ahr_log_thread)
+    {
+        return ahr_log_thread;
+    }
+    pthread_once(&ahr_log_thread_once, AHR_LogThreadCreateKey);
+    AHR_LogThread_t *thread = malloc(sizeof(AHR_LogThread_t));
+    if(!thread)
+    {
+        return NULL;
+    }
+    atomic_init(&thread->alive, true);
+    atomic_init(&thread->refs, 1U);
+    if(0 != pthread_setspecific(ahr_log_thread_key, thread))
+    {
+        free(thread);
+        return NULL;
+    }
+    ahr_log_thread = thread;
+    return thread;
 }
+
+static void AHR_LogThreadCreateKey(void)
+{
+    pthread_key_create(&ahr_log_thread_key, AHR_LogThreadExit);
+}
+
+static void AHR_LogThreadExit(void *arg)
+{
+    //
+    // Loggers may be gone already, only the Thread Object is touched. A Message logged by a later
+    // Destructor of this Thread creates a new one, which is released the same Way.
+    //
+    AHR_LogThread_t *thread = arg;
+    ahr_log_thread = NULL;
+    ahr_log_thread_logger = 0U;
+    ahr_log_thread_ring = NULL;
+    atomic_store_explicit(&thread->alive, false, memory_order_release);
+    AHR_LogThreadRelease(thread);
+}
+
+static void AHR_LogThreadRelease(AHR_LogThread_t *thread)
+{
+    if(1U == atomic_fetch_sub_explicit(&thread->refs, 1U, memory_order_acq_rel))
+    {
+        free(thread);
+    }
+}
+
+static AHR_LogLength_t AHR_LogParseLength(const char **c)
+{
+    switch(**c)
+    {
+        case 'h':
+            ++*c;
+            if('h' == **c)
+            {
+                ++*c;
+                return AHR_LOG_LENGTH_HH;
+            }
+            return AHR_LOG_LENGTH_H;
+        case 'l':
+            ++*c;
+            if('l' == **c)
+            {
+                ++*c;
+                return AHR_LOG_LENGTH_LL;
+            }
+            return AHR_LOG_LENGTH_L;
+        case 'j':
+            ++*c;
+            return AHR_LOG_LENGTH_J;
+        case 'z':
+            ++*c;
+            return AHR_LOG_LENGTH_Z;
+        case 't':
+            ++*c;
+            return AHR_LOG_LENGTH_T;
+        case 'L':
+            ++*c;
+            return AHR_LOG_LENGTH_LONG_DOUBLE;
+        default:
+            return AHR_LOG_LENGTH_NONE;
+    }
+}
+
+static bool AHR_LogIsFlag(char c)
+{
+    return '-' == c || '+' == c || ' ' == c || '#' == c || '0' == c;
+}
+
+static bool AHR_LogIsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static void AHR_LogCapture(AHR_LogRecord_t *record, const char *format, va_list args)
+{
+    size_t nargs = 0;
+    size_t nstrings = 0;
+    for(const char *c = format;*c;++c)
+    {
+        if('%' != *c)
+        {
+            continue;
+        }
+        ++c;
+        if('%' == *c)
+        {
+            continue;
+        }
+        while(AHR_LogIsFlag(*c))
+        {
+            ++c;
+        }
+        if('*' == *c)
+        {
+            if(nargs == AHR_LOG_MAX_ARGS)
+            {
+                break;
+            }
+            record->args[nargs++].i = va_arg(args, int);
+            ++c;
+        }
+        while(AHR_LogIsDigit(*c))
+        {
+            ++c;
+        }
+        int precision = -1;
+        if('.' == *c)
+        {
+            ++c;
+            if('*' == *c)
+            {
+                if(nargs == AHR_LOG_MAX_ARGS)
+                {
+                    break;
+                }
+                precision = va_arg(args, int);
+                record->args[nargs++].i = precision;
+                ++c;
+            }
+            else
+            {
+                precision = 0;
+                while(AHR_LogIsDigit(*c))
+                {
+                    precision = precision * 10 + (*c - '0');
+                    ++c;
+                }
+            }
+        }
+        const AHR_LogLength_t length = AHR_LogParseLength(&c);
+        if('\0' == *c || nargs == AHR_LOG_MAX_ARGS)
+        {
+            break;
+        }
+        AHR_LogArg_t *arg = &record->args[nargs];
+        switch(*c)
+        {
+            case 'd':
+            case 'i':
+                switch(length)
+                {
+                    case AHR_LOG_LENGTH_HH:
+                        arg->i = (signed char)va_arg(args, int);
+                        break;
+                    case AHR_LOG_LENGTH_H:
+                        arg->i = (short)va_arg(args, int);
+                        break;
+                    case AHR_LOG_LENGTH_L:
+                        arg->i = va_arg(args, long);
+                        break;
+                    case AHR_LOG_LENGTH_LL:
+                        arg->i = va_arg(args, long long);
+                        break;
+                    case AHR_LOG_LENGTH_J:
+                        arg->i = va_arg(args, intmax_t);
+                        break;
+                    case AHR_LOG_LENGTH_Z:
+                        arg->i = (int64_t)va_arg(args, size_t);
+                        break;
+                    case AHR_LOG_LENGTH_T:
+                        arg->i = va_arg(args, ptrdiff_t);
+                        break;
+                    default:
+                        arg->i = va_arg(args, int);
+                        break;
+                }
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                switch(length)
+                {
+                    case AHR_LOG_LENGTH_HH:
+                        arg->u = (unsigned char)va_arg(args, unsigned int);
+                        break;
+                    case AHR_LOG_LENGTH_H:
+                        arg->u = (unsigned short)va_arg(args, unsigned int);
+                        break;
+                    case AHR_LOG_LENGTH_L:
+                        arg->u = va_arg(args, unsigned long);
+                        break;
+                    case AHR_LOG_LENGTH_LL:
+                        arg->u = va_arg(args, unsigned long long);
+                        break;
+                    case AHR_LOG_LENGTH_J:
+                        arg->u = va_arg(args, uintmax_t);
+                        break;
+                    case AHR_LOG_LENGTH_Z:
+                        arg->u = va_arg(args, size_t);
+                        break;
+                    case AHR_LOG_LENGTH_T:
+                        arg->u = (uint64_t)va_arg(args, ptrdiff_t);
+                        break;
+                    default:
+                        arg->u = va_arg(args, unsigned int);
+                        break;
+                }
+                break;
+            case 'c':
+                arg->i = va_arg(args, int);
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                arg->d = AHR_LOG_LENGTH_LONG_DOUBLE == length ? (double)va_arg(args, long double) : va_arg(args, double);
+                break;
+            case 'p':
+                arg->p = va_arg(args, void*);
+                break;
+            case 's':
+            {
+                const char *s = va_arg(args, const char*);
+                if(!s)
+                {
+                    s = "(null)";
+                }
+                //
+                // Copy no more than the Precision allows, the String may not be terminated.
+                //
+                const size_t room = AHR_LOG_STRING_BYTES - nstrings - 1U;
+                const size_t limit = precision >= 0 && (size_t)precision < room ? (size_t)precision : room;
+                const size_t len = strnlen(s, limit);
+                memcpy(&record->strings[nstrings], s, len); // flawfinder: ignore
+                record->strings[nstrings + len] = '\0';
+                arg->u = nstrings;
+                nstrings += len + (nstrings + len + 1U < AHR_LOG_STRING_BYTES ? 1U : 0U);
+                break;
+            }
+            default:
+                //
+                // "%n" or no Conversion at all, the Rest of the Format is passed on verbatim.
+                //
+                record->nargs = nargs;
+                return;
+        }
+        ++nargs;
+    }
+    record->nargs = nargs;
+}
+
+static void AHR_LogRender(const AHR_LogRecord_t *record, char *message, size_t nbytes)
+{
+    size_t n = 0;
+    size_t arg = 0;
+    const char *c = record->format;
+    while(*c && n + 1U < nbytes)
+    {
+        if('%' != *c)
+        {
+            message[n++] = *c++;
+            continue;
+        }
+        const char *begin = c;
+        ++c;
+        if('%' == *c)
+        {
+            message[n++] = '%';
+            ++c;
+            continue;
+        }
+        //
+        // Rebuild the Specification with "*" replaced by the captured Values and the Length Modifier
+        // matching the captured Type.
+        //
+        char spec[AHR_LOG_SPEC_LEN]; // flawfinder: ignore
+        size_t nspec = 0;
+        spec[nspec++] = '%';
+        while(AHR_LogIsFlag(*c) && nspec < 8U)
+        {
+            spec[nspec++] = *c++;
+        }
+        if('*' == *c)
+        {
+            if(arg >= record->nargs)
+            {
+                goto verbatim;
+            }
+            nspec += (size_t)snprintf(&spec[nspec], AHR_LOG_SPEC_LEN - nspec, "%d", (int)record->args[arg++].i);
+            ++c;
+        }
+        while(AHR_LogIsDigit(*c) && nspec < 16U)
+        {
+            spec[nspec++] = *c++;
+        }
+        if('.' == *c)
+        {
+            spec[nspec++] = *c++;
+            if('*' == *c)
+            {
+                if(arg >= record->nargs)
+                {
+                    goto verbatim;
+                }
+                nspec += (size_t)snprintf(&spec[nspec], AHR_LOG_SPEC_LEN - nspec, "%d", (int)record->args[arg++].i);
+                ++c;
+            }
+            while(AHR_LogIsDigit(*c) && nspec < 26U)
+            {
+                spec[nspec++] = *c++;
+            }
+        }
+        (void)AHR_LogParseLength(&c);
+        const char conversion = *c;
+        if('\0' == conversion || arg >= record->nargs || nspec + 4U > AHR_LOG_SPEC_LEN)
+        {
+            goto verbatim;
+        }
+        ++c;
+        const AHR_LogArg_t *value = &record->args[arg++];
+        int written = 0;
+        switch(conversion)
+        {
+            case 'd':
+            case 'i':
+                memcpy(&spec[nspec], "ll", 2U); // flawfinder: ignore
+                spec[nspec + 2U] = conversion;
+                spec[nspec + 3U] = '\0';
+                written = snprintf(&message[n], nbytes - n, spec, (long long)value->i);
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                memcpy(&spec[nspec], "ll", 2U); // flawfinder: ignore
+                spec[nspec + 2U] = conversion;
+                spec[nspec + 3U] = '\0';
+                written = snprintf(&message[n], nbytes - n, spec, (unsigned long long)value->u);
+                break;
+            case 'c':
+                spec[nspec] = conversion;
+                spec[nspec + 1U] = '\0';
+                written = snprintf(&message[n], nbytes - n, spec, (int)value->i);
+                break;
+            case 's':
+                spec[nspec] = conversion;
+                spec[nspec + 1U] = '\0';
+                written = snprintf(&message[n], nbytes - n, spec, &record->strings[value->u]);
+                break;
+            case 'p':
+                spec[nspec] = conversion;
+                spec[nspec + 1U] = '\0';
+                written = snprintf(&message[n], nbytes - n, spec, value->p);
+                break;
+            default:
+                spec[nspec] = conversion;
+                spec[nspec + 1U] = '\0';
+                written = snprintf(&message[n], nbytes - n, spec, value->d);
+                break;
+        }
+        if(written < 0)
+        {
+            break;
+        }
+        n = n + (size_t)written < nbytes ? n + (size_t)written : nbytes - 1U;
+        continue;
+
+        verbatim:
+        c = begin;
+        while(*c && n + 1U < nbytes)
+        {
+            message[n++] = *c++;
+        }
+        break;
+    }
+    message[n] = '\0';
+}
+
+static void AHR_LoggerDeliver(AHR_Logger_t logger, size_t loglevel, const char *message)
+{
+    switch(loglevel)
+    {
+        case AHR_LOGLEVEL_ERROR:
+            logger->error(logger->arg, message);
+            break;
+        case AHR_LOGLEVEL_WARNING:
+            logger->warning(logger->arg, message);
+            break;
+        default:
+            logger->info(logger->arg, message);
+            break;
+    }
+}
+
+static void* AHR_LoggerDrainMain(void *arg)
+{
+    AHR_Logger_t logger = (AHR_Logger_t)arg;
+    pthread_mutex_lock(&logger->drain_mutex);
+    while(!logger->stop)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += (time_t)(logger->drain_interval_ms / 1000U);
+        deadline.tv_nsec += (long)(logger->drain_interval_ms % 1000U) * 1000000L;
+        if(deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&logger->drain_cond, &logger->drain_mutex, &deadline);
+        pthread_mutex_unlock(&logger->drain_mutex);
+        AHR_LoggerFlush(logger);
+        pthread_mutex_lock(&logger->drain_mutex);
+    }
+    pthread_mutex_unlock(&logger->drain_mutex);
+    return NULL;
+}
+
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
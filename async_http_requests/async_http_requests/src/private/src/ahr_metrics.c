@@ -0,0 +1,519 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/private/ahr_metrics.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Text written by AHR_MetricsPrometheus(), "overflow" is set once something did not fit.
+///
+typedef struct
+{
+    char *buffer;
+    size_t nbytes;
+    size_t len;
+    bool overflow;
+} AHR_MetricsText_t;
+
+///
+/// \brief  Upper Bounds of the Prometheus Histogram in Microseconds, +Inf is implied.
+///
+static const uint64_t AHR_METRICS_LE_US[] = {
+    500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000
+};
+
+static const char * const AHR_METRICS_STATUS_LABEL[AHR_METRICS_STATUS_CLASSES] = {
+    "other", "1xx", "2xx", "3xx", "4xx", "5xx"
+};
+
+static const char * const AHR_METRICS_FAILURE_LABEL[AHR_FAILURE_CLASSES] = {
+    "timeout", "connect", "aborted", "other"
+};
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Single Writer Increment, a plain Load and Store instead of a locked Read-Modify-Write.
+///
+static void AHR_MetricsAdd(atomic_ullong *counter, uint64_t value);
+static size_t AHR_MetricsBucket(uint64_t value);
+///
+/// \brief  Smallest and largest Value counted in a Bucket.
+///
+static uint64_t AHR_MetricsBucketLow(size_t bucket);
+static uint64_t AHR_MetricsBucketHigh(size_t bucket);
+///
+/// \brief  Copy "scheme://host:port" of "url" into "origin", the Port defaults by Scheme.
+///
+static void AHR_MetricsOriginOf(const char *url, char *origin, size_t size);
+///
+/// \brief  Find or claim the Slot of "url", the last Slot if all others are taken.
+///
+static AHR_MetricsOrigin_t* AHR_MetricsOriginSlot(AHR_Metrics_t *metrics, const char *url);
+///
+/// \brief  A Transfer without a Response may not have had a Connection at all, only "responded" ones count as reused.
+///
+static void AHR_MetricsCountTransfer(AHR_Metrics_t *metrics, const AHR_MetricsTransfer_t *transfer, bool responded);
+static void AHR_MetricsAppend(AHR_MetricsText_t *text, const char *format, ...) __attribute__((format(printf, 2, 3)));
+///
+/// \brief  Append "value" as a Label Value, escaping Backslash, Quote and Newline.
+///
+static void AHR_MetricsAppendLabel(AHR_MetricsText_t *text, const char *value);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_Metrics_t* AHR_CreateMetrics(void)
+{
+    //
+    // aligned_alloc() wants a Multiple of the Alignment, which sizeof() of an aligned Structure is.
+    //
+    AHR_Metrics_t *metrics = aligned_alloc(64U, sizeof(AHR_Metrics_t));
+    if(!metrics)
+    {
+        return NULL;
+    }
+    memset(metrics, 0, sizeof(AHR_Metrics_t));
+    return metrics;
+}
+
+void AHR_DestroyMetrics(AHR_Metrics_t **metrics)
+{
+    free(*metrics);
+    *metrics = NULL;
+}
+
+void AHR_MetricsSubmitted(AHR_Metrics_t *metrics)
+{
+    AHR_MetricsAdd(&metrics->submitted, 1U);
+}
+
+void AHR_MetricsDequeued(AHR_Metrics_t *metrics)
+{
+    AHR_MetricsAdd(&metrics->dequeued, 1U);
+}
+
+void AHR_MetricsCompleted(AHR_Metrics_t *metrics, size_t status_code, const AHR_MetricsTransfer_t *transfer)
+{
+    const size_t status_class = (status_code >= 100U && status_code < 600U) ? status_code / 100U : 0U;
+    AHR_MetricsAdd(&metrics->completed[status_class], 1U);
+    AHR_MetricsCountTransfer(metrics, transfer, true);
+
+    AHR_MetricsOrigin_t *origin = AHR_MetricsOriginSlot(metrics, transfer->url);
+    const uint64_t latency_us = transfer->latency_us < AHR_METRICS_MAX_VALUE_US
+        ? transfer->latency_us
+        : AHR_METRICS_MAX_VALUE_US;
+    AHR_MetricsAdd(&origin->buckets[AHR_MetricsBucket(latency_us)], 1U);
+    AHR_MetricsAdd(&origin->sum_us, latency_us);
+    if(latency_us > atomic_load_explicit(&origin->max_us, memory_order_relaxed))
+    {
+        atomic_store_explicit(&origin->max_us, latency_us, memory_order_relaxed);
+    }
+}
+
+void AHR_MetricsFailed(AHR_Metrics_t *metrics, AHR_FailureClass_t failure, const AHR_MetricsTransfer_t *transfer)
+{
+    assert(failure < AHR_FAILURE_CLASSES);
+    AHR_MetricsAdd(&metrics->failed[failure], 1U);
+    if(transfer)
+    {
+        AHR_MetricsCountTransfer(metrics, transfer, false);
+    }
+}
+
+void AHR_MetricsTakeSnapshot(const AHR_Metrics_t *metrics, AHR_MetricsSnapshot_t *snapshot)
+{
+    assert(NULL != metrics);
+    assert(NULL != snapshot);
+    //
+    // Counters only grow, reading the finished Transfers before the dequeued and those before the submitted
+    // Requests keeps the Gauges from going negative.
+    //
+    uint64_t finished = 0;
+    for(size_t i=0;i<AHR_METRICS_STATUS_CLASSES;++i)
+    {
+        snapshot->completed[i] = atomic_load_explicit(&metrics->completed[i], memory_order_relaxed);
+        finished += snapshot->completed[i];
+    }
+    for(size_t i=0;i<AHR_FAILURE_CLASSES;++i)
+    {
+        snapshot->failed[i] = atomic_load_explicit(&metrics->failed[i], memory_order_relaxed);
+        finished += snapshot->failed[i];
+    }
+    const uint64_t dequeued = atomic_load_explicit(&metrics->dequeued, memory_order_relaxed);
+    snapshot->submitted = atomic_load_explicit(&metrics->submitted, memory_order_relaxed);
+    snapshot->queue_depth = snapshot->submitted > dequeued ? snapshot->submitted - dequeued : 0U;
+    snapshot->in_flight = dequeued > finished ? dequeued - finished : 0U;
+    snapshot->bytes_in = atomic_load_explicit(&metrics->bytes_in, memory_order_relaxed);
+    snapshot->bytes_out = atomic_load_explicit(&metrics->bytes_out, memory_order_relaxed);
+    snapshot->connections_opened = atomic_load_explicit(&metrics->connections_opened, memory_order_relaxed);
+    snapshot->connections_reused = atomic_load_explicit(&metrics->connections_reused, memory_order_relaxed);
+
+    snapshot->norigins = 0;
+    for(size_t i=0;i<AHR_METRICS_MAX_ORIGINS;++i)
+    {
+        const AHR_MetricsOrigin_t *origin = &metrics->origins[i];
+        if(0 == atomic_load_explicit(&origin->key, memory_order_acquire))
+        {
+            continue;
+        }
+        AHR_OriginLatency_t *latency = &snapshot->origins[snapshot->norigins++];
+        memcpy(latency->origin, origin->origin, sizeof(latency->origin)); // flawfinder: ignore
+        latency->sum_us = atomic_load_explicit(&origin->sum_us, memory_order_relaxed);
+        latency->max_us = atomic_load_explicit(&origin->max_us, memory_order_relaxed);
+
+        uint64_t counts[AHR_METRICS_HISTOGRAM_BUCKETS];
+        latency->count = 0;
+        for(size_t j=0;j<AHR_METRICS_HISTOGRAM_BUCKETS;++j)
+        {
+            counts[j] = atomic_load_explicit(&origin->buckets[j], memory_order_relaxed);
+            latency->count += counts[j];
+        }
+        //
+        // Each Quantile is the upper Bound of the Bucket which holds it, but never above the Maximum.
+        //
+        const struct
+        {
+            uint64_t per_mille;
+            uint64_t *value;
+        } quantiles[] = {
+            {500, &latency->p50_us},
+            {900, &latency->p90_us},
+            {990, &latency->p99_us},
+            {999, &latency->p999_us}
+        };
+        size_t bucket = 0;
+        uint64_t seen = 0;
+        for(size_t q=0;q<sizeof(quantiles) / sizeof(quantiles[0]);++q)
+        {
+            if(0 == latency->count)
+            {
+                *quantiles[q].value = 0;
+                continue;
+            }
+            uint64_t rank = (latency->count * quantiles[q].per_mille + 999U) / 1000U;
+            rank = 0 != rank ? rank : 1U;
+            while(bucket < AHR_METRICS_HISTOGRAM_BUCKETS - 1U && seen + counts[bucket] < rank)
+            {
+                seen += counts[bucket++];
+            }
+            const uint64_t high = AHR_MetricsBucketHigh(bucket);
+            *quantiles[q].value = high < latency->max_us ? high : latency->max_us;
+        }
+    }
+}
+
+int64_t AHR_MetricsPrometheus(const AHR_Metrics_t *metrics, char *buffer, size_t nbytes)
+{
+    assert(NULL != metrics);
+    AHR_MetricsText_t text = {.buffer = buffer, .nbytes = nbytes, .len = 0, .overflow = false};
+    AHR_MetricsSnapshot_t snapshot;
+    AHR_MetricsTakeSnapshot(metrics, &snapshot);
+
+    AHR_MetricsAppend(&text, "# HELP ahr_requests_submitted_total Requests passed to AHR_ProcessorMakeRequest().\n");
+    AHR_MetricsAppend(&text, "# TYPE ahr_requests_submitted_total counter\n");
+    AHR_MetricsAppend(&text, "ahr_requests_submitted_total %llu\n", (unsigned long long)snapshot.submitted);
+
+    AHR_MetricsAppend(&text, "# HELP ahr_requests_completed_total Transfers which ended with a Response.\n");
+    AHR_MetricsAppend(&text, "# TYPE ahr_requests_completed_total counter\n");
+    for(size_t i=0;i<AHR_METRICS_STATUS_CLASSES;++i)
+    {
+        AHR_MetricsAppend(
+            &text,
+            "ahr_requests_completed_total{class=\"%s\"} %llu\n",
+            AHR_METRICS_STATUS_LABEL[i],
+            (unsigned long long)snapshot.completed[i]
+        );
+    }
+    AHR_MetricsAppend(&text, "# HELP ahr_requests_failed_total Transfers which ended without a Response.\n");
+    AHR_MetricsAppend(&text, "# TYPE ahr_requests_failed_total counter\n");
+    for(size_t i=0;i<AHR_FAILURE_CLASSES;++i)
+    {
+        AHR_MetricsAppend(
+            &text,
+            "ahr_requests_failed_total{reason=\"%s\"} %llu\n",
+            AHR_METRICS_FAILURE_LABEL[i],
+            (unsigned long long)snapshot.failed[i]
+        );
+    }
+
+    const struct
+    {
+        const char *name;
+        const char *type;
+        const char *help;
+        uint64_t value;
+    } scalars[] = {
+        {"ahr_bytes_received_total", "counter", "Header and Body Bytes received.", snapshot.bytes_in},
+        {"ahr_bytes_sent_total", "counter", "Header and Body Bytes sent.", snapshot.bytes_out},
+        {"ahr_connections_opened_total", "counter", "Connections opened.", snapshot.connections_opened},
+        {"ahr_connections_reused_total", "counter", "Transfers with a Response which reused a Connection.", snapshot.connections_reused},
+        {"ahr_queue_depth", "gauge", "Requests waiting for the Processors Thread.", snapshot.queue_depth},
+        {"ahr_in_flight", "gauge", "Requests handed to curl and not finished yet.", snapshot.in_flight}
+    };
+    for(size_t i=0;i<sizeof(scalars) / sizeof(scalars[0]);++i)
+    {
+        AHR_MetricsAppend(&text, "# HELP %s %s\n", scalars[i].name, scalars[i].help);
+        AHR_MetricsAppend(&text, "# TYPE %s %s\n", scalars[i].name, scalars[i].type);
+        AHR_MetricsAppend(&text, "%s %llu\n", scalars[i].name, (unsigned long long)scalars[i].value);
+    }
+
+    AHR_MetricsAppend(
+        &text,
+        "# HELP ahr_request_duration_seconds Time from AHR_ProcessorMakeRequest() until the Response completed.\n"
+    );
+    AHR_MetricsAppend(&text, "# TYPE ahr_request_duration_seconds histogram\n");
+    for(size_t i=0;i<AHR_METRICS_MAX_ORIGINS;++i)
+    {
+        const AHR_MetricsOrigin_t *origin = &metrics->origins[i];
+        if(0 == atomic_load_explicit(&origin->key, memory_order_acquire))
+        {
+            continue;
+        }
+        //
+        // A Bucket of the HDR Histogram is counted below a Bound if its smallest Value is.
+        //
+        size_t bucket = 0;
+        uint64_t cumulative = 0;
+        for(size_t le=0;le<sizeof(AHR_METRICS_LE_US) / sizeof(AHR_METRICS_LE_US[0]);++le)
+        {
+            while(bucket < AHR_METRICS_HISTOGRAM_BUCKETS && AHR_MetricsBucketLow(bucket) <= AHR_METRICS_LE_US[le])
+            {
+                cumulative += atomic_load_explicit(&origin->buckets[bucket++], memory_order_relaxed);
+            }
+            AHR_MetricsAppend(&text, "ahr_request_duration_seconds_bucket{origin=\"");
+            AHR_MetricsAppendLabel(&text, origin->origin);
+            AHR_MetricsAppend(
+                &text,
+                "\",le=\"%g\"} %llu\n",
+                (double)AHR_METRICS_LE_US[le] / 1e6,
+                (unsigned long long)cumulative
+            );
+        }
+        while(bucket < AHR_METRICS_HISTOGRAM_BUCKETS)
+        {
+            cumulative += atomic_load_explicit(&origin->buckets[bucket++], memory_order_relaxed);
+        }
+        AHR_MetricsAppend(&text, "ahr_request_duration_seconds_bucket{origin=\"");
+        AHR_MetricsAppendLabel(&text, origin->origin);
+        AHR_MetricsAppend(&text, "\",le=\"+Inf\"} %llu\n", (unsigned long long)cumulative);
+        AHR_MetricsAppend(&text, "ahr_request_duration_seconds_sum{origin=\"");
+        AHR_MetricsAppendLabel(&text, origin->origin);
+        AHR_MetricsAppend(
+            &text,
+            "\"} %.6f\n",
+            (double)atomic_load_explicit(&origin->sum_us, memory_order_relaxed) / 1e6
+        );
+        AHR_MetricsAppend(&text, "ahr_request_duration_seconds_count{origin=\"");
+        AHR_MetricsAppendLabel(&text, origin->origin);
+        AHR_MetricsAppend(&text, "\"} %llu\n", (unsigned long long)cumulative);
+    }
+
+    if(text.overflow)
+    {
+        return -1;
+    }
+    return (int64_t)text.len;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_MetricsAdd(atomic_ullong *counter, uint64_t value)
+{
+    atomic_store_explicit(
+        counter,
+        atomic_load_explicit(counter, memory_order_relaxed) + value,
+        memory_order_relaxed
+    );
+}
+
+static size_t AHR_MetricsBucket(uint64_t value)
+{
+    if(value < AHR_METRICS_SUB_BUCKETS)
+    {
+        return (size_t)value;
+    }
+    const unsigned int msb = 63U - (unsigned int)__builtin_clzll(value);
+    const unsigned int shift = msb - 4U;
+    return AHR_METRICS_SUB_BUCKETS
+        + (shift - 1U) * AHR_METRICS_HALF_BUCKETS
+        + (size_t)((value >> shift) - AHR_METRICS_HALF_BUCKETS);
+}
+
+static uint64_t AHR_MetricsBucketLow(size_t bucket)
+{
+    if(bucket < AHR_METRICS_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    const size_t offset = bucket - AHR_METRICS_SUB_BUCKETS;
+    const unsigned int shift = (unsigned int)(offset / AHR_METRICS_HALF_BUCKETS) + 1U;
+    return (uint64_t)(offset % AHR_METRICS_HALF_BUCKETS + AHR_METRICS_HALF_BUCKETS) << shift;
+}
+
+static uint64_t AHR_MetricsBucketHigh(size_t bucket)
+{
+    if(bucket >= AHR_METRICS_HISTOGRAM_BUCKETS)
+    {
+        return AHR_METRICS_MAX_VALUE_US;
+    }
+    if(bucket < AHR_METRICS_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    const size_t offset = bucket - AHR_METRICS_SUB_BUCKETS;
+    const unsigned int shift = (unsigned int)(offset / AHR_METRICS_HALF_BUCKETS) + 1U;
+    return AHR_MetricsBucketLow(bucket) + (UINT64_C(1) << shift) - 1U;
+}
+
+static void AHR_MetricsOriginOf(const char *url, char *origin, size_t size)
+{
+    size_t len = 0;
+    if(url)
+    {
+        const char *authority = strstr(url, "://");
+        const size_t scheme_len = authority ? (size_t)(authority - url) : 0U;
+        const char *end = authority ? authority + 3 : url;
+        bool has_port = false;
+        bool in_brackets = false;
+        while('\0' != *end && '/' != *end && '?' != *end && '#' != *end)
+        {
+            if('[' == *end) in_brackets = true;
+            else if(']' == *end) in_brackets = false;
+            else if(':' == *end && !in_brackets) has_port = true;
+            ++end;
+        }
+        len = (size_t)(end - url);
+        if(len > size - 1U)
+        {
+            len = size - 1U;
+        }
+        memcpy(origin, url, len); // flawfinder: ignore
+        if(!has_port && authority)
+        {
+            const char *port = (5U == scheme_len && 0 == strncmp(url, "https", 5)) ? ":443" : ":80";
+            const size_t port_len = strlen(port); // flawfinder: ignore
+            if(len + port_len < size)
+            {
+                memcpy(origin + len, port, port_len); // flawfinder: ignore
+                len += port_len;
+            }
+        }
+    }
+    origin[len] = '\0';
+}
+
+static AHR_MetricsOrigin_t* AHR_MetricsOriginSlot(AHR_Metrics_t *metrics, const char *url)
+{
+    char origin[AHR_METRICS_ORIGIN_LEN]; // flawfinder: ignore
+    AHR_MetricsOriginOf(url, origin, sizeof(origin));
+    //
+    // FNV-1a, 0 marks a free Slot and is never a Key.
+    //
+    uint64_t key = UINT64_C(14695981039346656037);
+    for(const char *c = origin; '\0' != *c; ++c)
+    {
+        key = (key ^ (unsigned char)*c) * UINT64_C(1099511628211);
+    }
+    key = 0 != key ? key : 1U;
+
+    const size_t nslots = AHR_METRICS_MAX_ORIGINS - 1U;
+    AHR_MetricsOrigin_t *overflow = &metrics->origins[nslots];
+    for(size_t i=0;i<nslots;++i)
+    {
+        AHR_MetricsOrigin_t *slot = &metrics->origins[(key + i) % nslots];
+        const uint64_t current = atomic_load_explicit(&slot->key, memory_order_relaxed);
+        if(key == current)
+        {
+            return slot;
+        }
+        if(0 == current)
+        {
+            memcpy(slot->origin, origin, sizeof(slot->origin)); // flawfinder: ignore
+            atomic_store_explicit(&slot->key, key, memory_order_release);
+            return slot;
+        }
+    }
+    if(0 == atomic_load_explicit(&overflow->key, memory_order_relaxed))
+    {
+        overflow->origin[0] = '*';
+        overflow->origin[1] = '\0';
+        atomic_store_explicit(&overflow->key, 1, memory_order_release);
+    }
+    return overflow;
+}
+
+static void AHR_MetricsCountTransfer(AHR_Metrics_t *metrics, const AHR_MetricsTransfer_t *transfer, bool responded)
+{
+    AHR_MetricsAdd(&metrics->bytes_in, transfer->bytes_in);
+    AHR_MetricsAdd(&metrics->bytes_out, transfer->bytes_out);
+    if(0 == transfer->new_connections && responded)
+    {
+        AHR_MetricsAdd(&metrics->connections_reused, 1U);
+    }
+    else
+    {
+        AHR_MetricsAdd(&metrics->connections_opened, transfer->new_connections);
+    }
+}
+
+static void AHR_MetricsAppend(AHR_MetricsText_t *text, const char *format, ...)
+{
+    if(text->overflow)
+    {
+        return;
+    }
+    const size_t available = text->nbytes > text->len ? text->nbytes - text->len : 0U;
+    va_list args;
+    va_start(args, format);
+    const int n = vsnprintf(available > 0 ? text->buffer + text->len : NULL, available, format, args); // flawfinder: ignore
+    va_end(args);
+    if(n < 0 || (size_t)n >= available)
+    {
+        text->overflow = true;
+        return;
+    }
+    text->len += (size_t)n;
+}
+
+static void AHR_MetricsAppendLabel(AHR_MetricsText_t *text, const char *value)
+{
+    for(const char *c = value; '\0' != *c; ++c)
+    {
+        switch(*c)
+        {
+            case '\\':
+                AHR_MetricsAppend(text, "\\\\");
+                break;
+            case '"':
+                AHR_MetricsAppend(text, "\\\"");
+                break;
+            case '\n':
+                AHR_MetricsAppend(text, "\\n");
+                break;
+            default:
+                AHR_MetricsAppend(text, "%c", *c);
+                break;
+        }
+    }
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
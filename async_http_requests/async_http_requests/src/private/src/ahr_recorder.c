@@ -0,0 +1,266 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/private/ahr_recorder.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Records are buffered up to this Size before they are written.
+///
+#define AHR_RECORDER_BUFFER_BYTES 65536U
+///
+/// \brief  Longest encoded Record: Template Reference, Definition, Method and 11 Integers.
+///
+#define AHR_RECORDER_MAX_RECORD_BYTES (10U + 10U + AHR_RECORD_TEMPLATE_LEN + 1U + 11U * 10U)
+///
+/// \brief  Buffered Records are written at least this often, a crashed Process loses at most this much.
+///
+#define AHR_RECORDER_FLUSH_US 1000000U
+///
+/// \brief  Templates which get a Number. Further Templates are defined again with every Record.
+///
+#define AHR_RECORDER_MAX_TEMPLATES 4096U
+#define AHR_RECORDER_TEMPLATE_SLOTS (2U * AHR_RECORDER_MAX_TEMPLATES)
+
+typedef struct
+{
+    ///
+    /// \brief  0 marks a free Slot.
+    ///
+    uint64_t hash;
+    uint32_t number;
+} AHR_RecorderTemplate_t;
+
+struct AHR_Recorder
+{
+    int fd;
+    bool failed;
+    uint64_t start_ns;
+    uint64_t submit_us;
+    ///
+    /// \brief  Completion Time of the last Record when the Buffer was written last.
+    ///
+    uint64_t flushed_us;
+    uint32_t ntemplates;
+    AHR_RecorderTemplate_t templates[AHR_RECORDER_TEMPLATE_SLOTS];
+    size_t nbuffer;
+    unsigned char buffer[AHR_RECORDER_BUFFER_BYTES]; // flawfinder: ignore
+};
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_RecorderPutVarint(AHR_Recorder_t *recorder, uint64_t value);
+///
+/// \brief  Number of the Template, 0 if it has to be defined. Assigns the next Number to a new Template.
+///
+static uint32_t AHR_RecorderTemplateNumber(AHR_Recorder_t *recorder, const char *template, size_t len);
+static bool AHR_RecorderWrite(int fd, const unsigned char *data, size_t nbytes);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_Recorder_t* AHR_CreateRecorder(const char *path)
+{
+    if(!path)
+    {
+        return NULL;
+    }
+    AHR_Recorder_t *recorder = calloc(1, sizeof(AHR_Recorder_t));
+    if(!recorder)
+    {
+        return NULL;
+    }
+    recorder->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644); // flawfinder: ignore
+    if(recorder->fd < 0)
+    {
+        free(recorder);
+        return NULL;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    recorder->start_ns = (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+    clock_gettime(CLOCK_REALTIME, &now);
+    const uint64_t wall_ns = (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+    unsigned char header[16] = {'A', 'H', 'R', 'R', AHR_RECORD_VERSION, 0, 0, 0}; // flawfinder: ignore
+    for(size_t i=0;i<8U;++i)
+    {
+        header[8U + i] = (unsigned char)(wall_ns >> (8U * i));
+    }
+    if(!AHR_RecorderWrite(recorder->fd, header, sizeof(header)))
+    {
+        close(recorder->fd);
+        free(recorder);
+        return NULL;
+    }
+    return recorder;
+}
+
+void AHR_DestroyRecorder(AHR_Recorder_t **recorder)
+{
+    if(!recorder || !*recorder)
+    {
+        return;
+    }
+    AHR_RecorderFlush(*recorder);
+    close((*recorder)->fd);
+    free(*recorder);
+    *recorder = NULL;
+}
+
+uint64_t AHR_RecorderStartNs(const AHR_Recorder_t *recorder)
+{
+    assert(NULL != recorder);
+    return recorder->start_ns;
+}
+
+bool AHR_RecorderAdd(AHR_Recorder_t *recorder, const AHR_Record_t *record)
+{
+    assert(NULL != recorder);
+    assert(NULL != record);
+
+    if(recorder->failed)
+    {
+        return true;
+    }
+    if(recorder->nbuffer + AHR_RECORDER_MAX_RECORD_BYTES > sizeof(recorder->buffer) && !AHR_RecorderFlush(recorder))
+    {
+        return false;
+    }
+    const size_t len = strnlen(record->url_template, AHR_RECORD_TEMPLATE_LEN - 1U);
+    const uint32_t number = AHR_RecorderTemplateNumber(recorder, record->url_template, len);
+    AHR_RecorderPutVarint(recorder, number);
+    if(0 == number)
+    {
+        AHR_RecorderPutVarint(recorder, len);
+        memcpy(&recorder->buffer[recorder->nbuffer], record->url_template, len); // flawfinder: ignore
+        recorder->nbuffer += len;
+    }
+    recorder->buffer[recorder->nbuffer++] = (unsigned char)record->method;
+    //
+    // Records come in Completion Order, a Request may have been submitted before the previous one.
+    //
+    const uint64_t zigzag = record->submit_us >= recorder->submit_us
+        ? (record->submit_us - recorder->submit_us) << 1U
+        : ((recorder->submit_us - record->submit_us - 1U) << 1U) | 1U;
+    recorder->submit_us = record->submit_us;
+    const uint64_t fields[] = {
+        zigzag,
+        record->latency_us,
+        record->server_us,
+        record->nheaders,
+        record->header_bytes,
+        record->body_bytes,
+        record->status,
+        record->error,
+        record->response_header_bytes,
+        record->response_bytes,
+        record->decoded_bytes
+    };
+    for(size_t i=0;i<sizeof(fields) / sizeof(fields[0]);++i)
+    {
+        AHR_RecorderPutVarint(recorder, fields[i]);
+    }
+    const uint64_t completed_us = record->submit_us + record->latency_us;
+    if(completed_us >= recorder->flushed_us + AHR_RECORDER_FLUSH_US)
+    {
+        recorder->flushed_us = completed_us;
+        return AHR_RecorderFlush(recorder);
+    }
+    return true;
+}
+
+bool AHR_RecorderFlush(AHR_Recorder_t *recorder)
+{
+    assert(NULL != recorder);
+    if(!recorder->failed && recorder->nbuffer > 0)
+    {
+        recorder->failed = !AHR_RecorderWrite(recorder->fd, recorder->buffer, recorder->nbuffer);
+        recorder->nbuffer = 0;
+    }
+    return !recorder->failed;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_RecorderPutVarint(AHR_Recorder_t *recorder, uint64_t value)
+{
+    while(value >= 0x80U)
+    {
+        recorder->buffer[recorder->nbuffer++] = (unsigned char)(value | 0x80U);
+        value >>= 7U;
+    }
+    recorder->buffer[recorder->nbuffer++] = (unsigned char)value;
+}
+
+static uint32_t AHR_RecorderTemplateNumber(AHR_Recorder_t *recorder, const char *template, size_t len)
+{
+    //
+    // FNV-1a, 0 is reserved for free Slots.
+    //
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for(size_t i=0;i<len;++i)
+    {
+        hash ^= (unsigned char)template[i];
+        hash *= 0x100000001b3ULL;
+    }
+    hash = 0 != hash ? hash : 1U;
+    for(size_t i=0;i<AHR_RECORDER_TEMPLATE_SLOTS;++i)
+    {
+        AHR_RecorderTemplate_t *slot = &recorder->templates[(hash + i) % AHR_RECORDER_TEMPLATE_SLOTS];
+        if(hash == slot->hash)
+        {
+            return slot->number;
+        }
+        if(0 == slot->hash)
+        {
+            if(recorder->ntemplates < AHR_RECORDER_MAX_TEMPLATES)
+            {
+                slot->hash = hash;
+                slot->number = ++recorder->ntemplates;
+            }
+            return 0;
+        }
+    }
+    return 0;
+}
+
+static bool AHR_RecorderWrite(int fd, const unsigned char *data, size_t nbytes)
+{
+    while(nbytes > 0)
+    {
+        const ssize_t n = write(fd, data, nbytes);
+        if(n < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if(n <= 0)
+        {
+            return false;
+        }
+        data += n;
+        nbytes -= (size_t)n;
+    }
+    return true;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -13,26 +13,49 @@
 // --------------------------------------------------------------------------------------------------------------------
 //
 
+static void AHR_ResultReleaseBodyDescriptor(AHR_Result_t *result);
+static void AHR_ResultStoreInit(AHR_ResultStore_t *store);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
 AHR_ResultStore_t AHR_CreateResultStore(size_t max_size)
 {
     AHR_ResultStore_t store = {
         .results = malloc(max_size * sizeof(AHR_Result_t)),
-        .nresults = max_size
+        .nresults = max_size,
+        .owns_results = true
     };
-    
-    for(size_t i=0;i<max_size;++i)
-    {
-        atomic_store(&store.results[i].busy, 0);
-    }
+    AHR_ResultStoreInit(&store);
     return store;
 }
 
+AHR_ResultStore_t AHR_CreateResultStoreInArena(AHR_Arena_t *arena, size_t max_size)
+{
+    AHR_ResultStore_t store = {
+        .results = AHR_ArenaAlloc(arena, max_size * sizeof(AHR_Result_t)),
+        .nresults = max_size,
+        .owns_results = false
+    };
+    AHR_ResultStoreInit(&store);
+    return store;
+}
+
+size_t AHR_ResultStoreArenaBytes(size_t max_size)
+{
+    return AHR_ArenaAlignedSize(max_size * sizeof(AHR_Result_t));
+}
+
 void AHR_DestroyResultStore(AHR_ResultStore_t *store)
 {
     assert(NULL != store);
     assert(NULL != store->results);
 
-    free((*store).results);
+    if(store->owns_results)
+    {
+        free((*store).results);
+    }
     (*store).nresults = 0;
     (*store).results = NULL;
 }
@@ -62,6 +85,78 @@ size_t AHR_ResultStoreObjectIndex(const AHR_ResultStore_t *store, const AHR_Resu
     return (result - store->results);
 }
 
+void AHR_ResultSetBody(AHR_Result_t *result, const AHR_BodyDescriptor_t *body)
+{
+    assert(NULL != result);
+    assert(NULL != body);
+
+    AHR_ResultReleaseBodyDescriptor(result);
+    result->body = *body;
+}
+
+void AHR_ResultReleaseBody(AHR_Result_t *result)
+{
+    assert(NULL != result);
+
+    AHR_ResultReleaseBodyDescriptor(result);
+    AHR_FileReaderClose(&result->file_source);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_ResultStoreInit(AHR_ResultStore_t *store)
+{
+    if(!store->results)
+    {
+        return;
+    }
+    for(size_t i=0;i<store->nresults;++i)
+    {
+        atomic_store(&store->results[i].busy, 0);
+        atomic_store(&store->results[i].resume, 0);
+        store->results[i].object = i;
+        store->results[i].request = NULL;
+        store->results[i].response = NULL;
+        store->results[i].paused = false;
+        store->results[i].timings = (AHR_RequestTimings_t){0};
+        store->results[i].tracer = NULL;
+        store->results[i].trace_id = 0;
+        store->results[i].provider = (AHR_BodyProvider_t){
+            .read = NULL,
+            .rewind = NULL,
+            .user = NULL,
+            .content_length = 0
+        };
+        store->results[i].file_source = AHR_CreateFileReader();
+        store->results[i].compressor = AHR_CreateCompressor();
+        store->results[i].body_encoding = 0;
+        store->results[i].body_uncompressed = 0;
+        store->results[i].body_compressed = 0;
+        store->results[i].body_offset = 0;
+        store->results[i].body = (AHR_BodyDescriptor_t){
+            .data = NULL,
+            .nbytes = 0,
+            .release = NULL,
+            .user = NULL
+        };
+    }
+}
+
+static void AHR_ResultReleaseBodyDescriptor(AHR_Result_t *result)
+{
+    const AHR_BodyDescriptor_t body = result->body;
+    result->body.data = NULL;
+    result->body.nbytes = 0;
+    result->body.release = NULL;
+    result->body.user = NULL;
+    if(body.release)
+    {
+        body.release(body.user, body.data, body.nbytes);
+    }
+}
+
 //
 // --------------------------------------------------------------------------------------------------------------------
 //
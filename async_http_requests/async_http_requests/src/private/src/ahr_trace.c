@@ -0,0 +1,489 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <async_http_requests/private/ahr_trace.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Duration of the TSC Calibration.
+///
+#define AHR_TRACE_CALIBRATION_NS 2000000U
+///
+/// \brief  Bytes AHR_TraceDump() buffers before it writes.
+///
+#define AHR_TRACE_WRITE_BUFFER 16384U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+typedef struct
+{
+    uint64_t ticks;
+    ///
+    /// \brief  String Literal of the Recorder.
+    ///
+    const char *name;
+    ///
+    /// \brief  Id of asynchronous Slices, unused otherwise.
+    ///
+    uint64_t id;
+    uint32_t object;
+    ///
+    /// \brief  Chrome Trace Phase: 'B', 'E', 'b' or 'e'.
+    ///
+    char phase;
+} AHR_TraceEvent_t;
+
+///
+/// \brief  Single Producer, single Consumer Ring. The Producer is the owning Thread,
+///         the Consumer AHR_TraceDump() while it holds the Mutex of the Tracer.
+///
+typedef struct AHR_TraceRing
+{
+    _Alignas(64) atomic_size_t head;
+    _Alignas(64) atomic_size_t tail;
+    ///
+    /// \brief  Identifies the owning Thread, see ahr_trace_thread_token.
+    ///
+    const void *owner;
+    struct AHR_TraceRing *next;
+    _Atomic(const char*) name;
+    ///
+    /// \brief  "tid" in the Trace.
+    ///
+    size_t index;
+    size_t mask;
+    AHR_TraceEvent_t events[];
+} AHR_TraceRing_t;
+
+struct AHR_Tracer
+{
+    pthread_mutex_t mutex;
+    ///
+    /// \brief  Unique over all Tracers of the Process, a Tracer may be created at the Address of a destroyed one.
+    ///
+    uint64_t id;
+    _Atomic(AHR_TraceRing_t*) rings;
+    atomic_size_t nrings;
+    size_t capacity;
+    atomic_size_t dropped;
+    atomic_uint_fast64_t next_id;
+    ///
+    /// \brief  Timestamps are written relative to "base_ticks".
+    ///
+    uint64_t base_ticks;
+    double ticks_per_us;
+};
+
+///
+/// \brief  Output of AHR_TraceDump().
+///
+typedef struct
+{
+    int fd;
+    size_t len;
+    bool failed;
+    char buffer[AHR_TRACE_WRITE_BUFFER]; // flawfinder: ignore
+} AHR_TraceWriter_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static atomic_uint_fast64_t ahr_trace_next_id = 1U;
+///
+/// \brief  The Address of this Variable identifies a Thread, see ahr_log_thread_token.
+///
+static _Thread_local char ahr_trace_thread_token;
+///
+/// \brief  Ring of the Thread for the Tracer it used last.
+///
+static _Thread_local uint64_t ahr_trace_thread_tracer = 0U;
+static _Thread_local AHR_TraceRing_t *ahr_trace_thread_ring = NULL;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static uint64_t AHR_TraceNowNs(void);
+///
+/// \brief  Ring of the calling Thread, created on first Use.
+/// \returns    NULL if no Memory is available.
+///
+static AHR_TraceRing_t* AHR_TracerRing(AHR_Tracer_t *tracer);
+static void AHR_TraceRecord(
+    AHR_Tracer_t *tracer,
+    char phase,
+    const char *name,
+    uint64_t id,
+    uint32_t object,
+    uint64_t ticks
+);
+static void AHR_TraceWrite(AHR_TraceWriter_t *writer, const char *format, ...) __attribute__((format(printf, 2, 3)));
+static void AHR_TraceFlush(AHR_TraceWriter_t *writer);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_Tracer_t* AHR_CreateTracer(size_t capacity)
+{
+    if(0 == capacity)
+    {
+        return NULL;
+    }
+    AHR_Tracer_t *tracer = malloc(sizeof(AHR_Tracer_t));
+    if(!tracer)
+    {
+        return NULL;
+    }
+    pthread_mutex_init(&tracer->mutex, NULL);
+    tracer->id = atomic_fetch_add(&ahr_trace_next_id, 1U);
+    atomic_init(&tracer->rings, NULL);
+    atomic_init(&tracer->nrings, 0U);
+    tracer->capacity = 1U;
+    while(tracer->capacity < capacity)
+    {
+        tracer->capacity <<= 1U;
+    }
+    atomic_init(&tracer->dropped, 0U);
+    atomic_init(&tracer->next_id, 1U);
+    //
+    // Count Ticks over a few Milliseconds of the monotonic Clock. Without a TSC both are the same.
+    //
+    const uint64_t start_ns = AHR_TraceNowNs();
+    const uint64_t start_ticks = AHR_TraceNow();
+    uint64_t now_ns = start_ns;
+    while(now_ns - start_ns < AHR_TRACE_CALIBRATION_NS)
+    {
+        now_ns = AHR_TraceNowNs();
+    }
+    const uint64_t ticks = AHR_TraceNow() - start_ticks;
+    tracer->ticks_per_us = ticks > 0 ? (double)ticks * 1000.0 / (double)(now_ns - start_ns) : 1000.0;
+    tracer->base_ticks = start_ticks;
+    return tracer;
+}
+
+void AHR_DestroyTracer(AHR_Tracer_t **tracer)
+{
+    if(!*tracer)
+    {
+        return;
+    }
+    AHR_TraceRing_t *ring = atomic_load(&(*tracer)->rings);
+    while(ring)
+    {
+        AHR_TraceRing_t *next = ring->next;
+        free(ring);
+        ring = next;
+    }
+    pthread_mutex_destroy(&(*tracer)->mutex);
+    free(*tracer);
+    *tracer = NULL;
+}
+
+uint64_t AHR_TraceNow(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return AHR_TraceNowNs();
+#endif
+}
+
+uint64_t AHR_TraceTicksFromUs(const AHR_Tracer_t *tracer, uint64_t us)
+{
+    if(!tracer)
+    {
+        return 0;
+    }
+    return (uint64_t)((double)us * tracer->ticks_per_us);
+}
+
+void AHR_TraceNameThread(AHR_Tracer_t *tracer, const char *name)
+{
+    if(!tracer)
+    {
+        return;
+    }
+    AHR_TraceRing_t *ring = AHR_TracerRing(tracer);
+    if(ring)
+    {
+        atomic_store_explicit(&ring->name, name, memory_order_release);
+    }
+}
+
+void AHR_TraceBegin(AHR_Tracer_t *tracer, const char *name, uint32_t object)
+{
+    if(tracer)
+    {
+        AHR_TraceRecord(tracer, 'B', name, 0, object, AHR_TraceNow());
+    }
+}
+
+void AHR_TraceEnd(AHR_Tracer_t *tracer, const char *name, uint32_t object)
+{
+    if(tracer)
+    {
+        AHR_TraceRecord(tracer, 'E', name, 0, object, AHR_TraceNow());
+    }
+}
+
+void AHR_TraceAsyncBegin(AHR_Tracer_t *tracer, const char *name, uint64_t id, uint32_t object, uint64_t ticks)
+{
+    if(tracer)
+    {
+        AHR_TraceRecord(tracer, 'b', name, id, object, ticks);
+    }
+}
+
+void AHR_TraceAsyncEnd(AHR_Tracer_t *tracer, const char *name, uint64_t id, uint32_t object, uint64_t ticks)
+{
+    if(tracer)
+    {
+        AHR_TraceRecord(tracer, 'e', name, id, object, ticks);
+    }
+}
+
+uint64_t AHR_TraceNextId(AHR_Tracer_t *tracer)
+{
+    if(!tracer)
+    {
+        return 0;
+    }
+    return atomic_fetch_add_explicit(&tracer->next_id, 1U, memory_order_relaxed);
+}
+
+size_t AHR_TraceDropped(const AHR_Tracer_t *tracer)
+{
+    if(!tracer)
+    {
+        return 0;
+    }
+    return atomic_load_explicit(&tracer->dropped, memory_order_relaxed);
+}
+
+bool AHR_TraceDump(AHR_Tracer_t *tracer, int fd)
+{
+    if(!tracer)
+    {
+        return false;
+    }
+    AHR_TraceWriter_t *writer = malloc(sizeof(AHR_TraceWriter_t));
+    if(!writer)
+    {
+        return false;
+    }
+    writer->fd = fd;
+    writer->len = 0;
+    writer->failed = false;
+
+    pthread_mutex_lock(&tracer->mutex);
+    AHR_TraceWrite(writer, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    AHR_TraceWrite(writer, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"libahr\"}}");
+    for(AHR_TraceRing_t *ring = atomic_load_explicit(&tracer->rings, memory_order_acquire); ring; ring = ring->next)
+    {
+        const char *name = atomic_load_explicit(&ring->name, memory_order_acquire);
+        if(name)
+        {
+            AHR_TraceWrite(
+                writer,
+                ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"%s\"}}",
+                ring->index,
+                name
+            );
+        }
+        const size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        for(;tail != head;++tail)
+        {
+            const AHR_TraceEvent_t *event = &ring->events[tail & ring->mask];
+            //
+            // Events recorded before the Calibration finished are placed at 0.
+            //
+            const uint64_t ticks = event->ticks > tracer->base_ticks ? event->ticks - tracer->base_ticks : 0U;
+            AHR_TraceWrite(
+                writer,
+                ",\n{\"name\":\"%s\",\"cat\":\"ahr\",\"ph\":\"%c\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f",
+                event->name,
+                event->phase,
+                ring->index,
+                (double)ticks / tracer->ticks_per_us
+            );
+            if('b' == event->phase || 'e' == event->phase)
+            {
+                AHR_TraceWrite(writer, ",\"id\":\"0x%llx\"", (unsigned long long)event->id);
+            }
+            if(AHR_TRACE_NO_OBJECT != event->object)
+            {
+                AHR_TraceWrite(writer, ",\"args\":{\"object\":%u}", (unsigned int)event->object);
+            }
+            AHR_TraceWrite(writer, "}");
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+    AHR_TraceWrite(
+        writer,
+        "\n],\"otherData\":{\"dropped_events\":\"%zu\"}}\n",
+        atomic_load_explicit(&tracer->dropped, memory_order_relaxed)
+    );
+    AHR_TraceFlush(writer);
+    pthread_mutex_unlock(&tracer->mutex);
+
+    const bool ok = !writer->failed;
+    free(writer);
+    return ok;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static uint64_t AHR_TraceNowNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+static AHR_TraceRing_t* AHR_TracerRing(AHR_Tracer_t *tracer)
+{
+    if(ahr_trace_thread_tracer == tracer->id)
+    {
+        return ahr_trace_thread_ring;
+    }
+    const void *owner = &ahr_trace_thread_token;
+    AHR_TraceRing_t *ring = atomic_load_explicit(&tracer->rings, memory_order_acquire);
+    while(ring && ring->owner != owner)
+    {
+        ring = ring->next;
+    }
+    if(!ring)
+    {
+        //
+        // aligned_alloc() wants a Multiple of the Alignment.
+        //
+        const size_t nbytes = (sizeof(AHR_TraceRing_t) + tracer->capacity * sizeof(AHR_TraceEvent_t) + 63U) & ~(size_t)63U;
+        ring = aligned_alloc(64U, nbytes);
+        if(!ring)
+        {
+            return NULL;
+        }
+        atomic_init(&ring->head, 0U);
+        atomic_init(&ring->tail, 0U);
+        atomic_init(&ring->name, NULL);
+        ring->owner = owner;
+        ring->index = atomic_fetch_add(&tracer->nrings, 1U) + 1U;
+        ring->mask = tracer->capacity - 1U;
+        ring->next = atomic_load_explicit(&tracer->rings, memory_order_relaxed);
+        while(!atomic_compare_exchange_weak_explicit(
+            &tracer->rings,
+            &ring->next,
+            ring,
+            memory_order_release,
+            memory_order_relaxed
+        ));
+    }
+    ahr_trace_thread_tracer = tracer->id;
+    ahr_trace_thread_ring = ring;
+    return ring;
+}
+
+static void AHR_TraceRecord(
+    AHR_Tracer_t *tracer,
+    char phase,
+    const char *name,
+    uint64_t id,
+    uint32_t object,
+    uint64_t ticks
+)
+{
+    AHR_TraceRing_t *ring = AHR_TracerRing(tracer);
+    if(!ring)
+    {
+        atomic_fetch_add_explicit(&tracer->dropped, 1U, memory_order_relaxed);
+        return;
+    }
+    const size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if(head - atomic_load_explicit(&ring->tail, memory_order_acquire) > ring->mask)
+    {
+        atomic_fetch_add_explicit(&tracer->dropped, 1U, memory_order_relaxed);
+        return;
+    }
+    AHR_TraceEvent_t *event = &ring->events[head & ring->mask];
+    event->ticks = ticks;
+    event->name = name;
+    event->id = id;
+    event->object = object;
+    event->phase = phase;
+    atomic_store_explicit(&ring->head, head + 1U, memory_order_release);
+}
+
+static void AHR_TraceWrite(AHR_TraceWriter_t *writer, const char *format, ...)
+{
+    for(size_t attempt=0;attempt<2 && !writer->failed;++attempt)
+    {
+        const size_t available = sizeof(writer->buffer) - writer->len;
+        va_list args;
+        va_start(args, format);
+        const int n = vsnprintf(writer->buffer + writer->len, available, format, args); // flawfinder: ignore
+        va_end(args);
+        if(n < 0)
+        {
+            writer->failed = true;
+        }
+        else if((size_t)n < available)
+        {
+            writer->len += (size_t)n;
+            return;
+        }
+        else
+        {
+            //
+            // One Event always fits into an empty Buffer, write what is there and format again.
+            //
+            AHR_TraceFlush(writer);
+        }
+    }
+}
+
+static void AHR_TraceFlush(AHR_TraceWriter_t *writer)
+{
+    size_t offset = 0;
+    while(!writer->failed && offset < writer->len)
+    {
+        const ssize_t n = write(writer->fd, writer->buffer + offset, writer->len - offset);
+        if(n < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if(n <= 0)
+        {
+            writer->failed = true;
+            break;
+        }
+        offset += (size_t)n;
+    }
+    writer->len = 0;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,76 @@
+///
+/// \brief  HDR Histogram of Latencies for the Load Tools.
+///         The Bucket Layout is the one of HdrHistogram (https://hdrhistogram.github.io/HdrHistogram/) with a
+///         lowest discernible Value of 1, so Intervals can be written as HdrHistogram Log (Format 1.3) and
+///         read by its Tools, f.e. HistogramLogProcessor or the HdrHistogram Plotter.
+///
+///         Values are recorded with "digits" significant Decimal Digits, Values above the highest trackable
+///         Value are recorded as that Value. A Histogram is not thread-safe.
+///
+/// \example    AHR_BenchHistogram_t h = AHR_BenchHistogramCreate(60000000000LL, 3);
+///             AHR_BenchHistogramRecord(h, latency_ns);
+///             AHR_BenchHistogramLogHeader(log, start);
+///             AHR_BenchHistogramLogInterval(log, NULL, 0.0, 1.0, h);
+///             AHR_BenchHistogramReset(h);
+///             ...
+///             AHR_BenchHistogramDestroy(&h);
+///
+#ifndef __AHR_BENCH_HISTOGRAM_H__
+#define __AHR_BENCH_HISTOGRAM_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+struct AHR_BenchHistogram;
+typedef struct AHR_BenchHistogram* AHR_BenchHistogram_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \param[in] highest - Highest trackable Value, 2 <= highest.
+/// \param[in] digits - Significant Decimal Digits, 1 <= digits <= 5.
+/// \returns    NULL for invalid Arguments or if there is not enough Memory.
+///
+AHR_BenchHistogram_t AHR_BenchHistogramCreate(int64_t highest, int digits);
+void AHR_BenchHistogramDestroy(AHR_BenchHistogram_t *histogram);
+void AHR_BenchHistogramRecord(AHR_BenchHistogram_t histogram, int64_t value);
+///
+/// \brief  Add all Counts of "source" to "destination". Both must have been created with the same Arguments.
+///
+void AHR_BenchHistogramAdd(AHR_BenchHistogram_t destination, const AHR_BenchHistogram_t source);
+void AHR_BenchHistogramReset(AHR_BenchHistogram_t histogram);
+int64_t AHR_BenchHistogramCount(const AHR_BenchHistogram_t histogram);
+int64_t AHR_BenchHistogramMax(const AHR_BenchHistogram_t histogram);
+///
+/// \brief  Highest Value equivalent to the recorded Value at "percentile" (0.0 - 100.0), 0 if empty.
+///
+int64_t AHR_BenchHistogramPercentile(const AHR_BenchHistogram_t histogram, double percentile);
+///
+/// \brief  Write the Header of a HdrHistogram Log.
+/// \param[in] start - Seconds since the Epoch, the Timestamps of the Intervals are relative to it.
+///
+bool AHR_BenchHistogramLogHeader(FILE *log, double start);
+///
+/// \brief  Append the Histogram as one Interval, compressed and Base64 encoded like HdrHistogram does.
+///         The Interval Max is written divided by 10^6, in Milliseconds if the Values are Nanoseconds.
+/// \param[in] tag - Optional Tag of the Interval, NULL for none.
+/// \param[in] start - Begin of the Interval in Seconds since the Start of the Log.
+/// \param[in] length - Length of the Interval in Seconds.
+///
+bool AHR_BenchHistogramLogInterval(FILE *log, const char *tag, double start, double length, const AHR_BenchHistogram_t histogram);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
@@ -0,0 +1,79 @@
+///
+/// \brief  Loopback HTTP/1.1 Server for Benchmarks.
+///         One Thread serves all Connections through epoll. Every Request is answered with the same
+///         Content, either as is or gzip-compressed if the Client offers gzip. Request Bodies are read
+///         and discarded, Connections are kept alive unless the Content asks to close them.
+///
+///         The Server can pace its Sends to emulate a Link of limited Bandwidth, so the Effect of 
+///         smaller Bodies shows up like it would on a real Network.
+///
+/// \example    AHR_BenchContent_t content = {.body = json, .nbytes = n, .gzip_body = gz, .gzip_nbytes = ngz};
+///             AHR_BenchServer_t server = AHR_BenchServerStart(0, &content);
+///             printf("http://127.0.0.1:%u/\n", AHR_BenchServerPort(server));
+///             ...
+///             AHR_BenchServerStop(&server);
+///
+#ifndef __AHR_BENCH_SERVER_H__
+#define __AHR_BENCH_SERVER_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+typedef struct
+{
+    const char *body;
+    size_t nbytes;
+    ///
+    /// \brief  Optional gzip-compressed Body, sent with "Content-Encoding: gzip" if the Client accepts it.
+    ///
+    const char *gzip_body;
+    size_t gzip_nbytes;
+    const char *content_type;
+    ///
+    /// \brief  Emulated Link Bandwidth in Megabit per Second, 0 for none.
+    ///
+    double link_mbps;
+    ///
+    /// \brief  Answer with "Connection: close" and close each Connection after its Response.
+    ///
+    bool close_connections;
+} AHR_BenchContent_t;
+
+struct AHR_BenchServer;
+typedef struct AHR_BenchServer* AHR_BenchServer_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \brief  Listen on 127.0.0.1:"port" and serve "content" from a new Thread.
+///         "content" is referenced and must outlive the Server.
+/// \param[in] port - 0 picks a free Port, see AHR_BenchServerPort().
+/// \returns    NULL if the Socket or the Thread can not be created.
+///
+AHR_BenchServer_t AHR_BenchServerStart(uint16_t port, const AHR_BenchContent_t *content);
+uint16_t AHR_BenchServerPort(const AHR_BenchServer_t server);
+///
+/// \brief  Number of Responses sent so far.
+///
+uint64_t AHR_BenchServerResponses(const AHR_BenchServer_t server);
+///
+/// \brief  CPU Time in Seconds the Server Thread used so far, so a Benchmark can leave it out of its own.
+///
+double AHR_BenchServerCpuSeconds(const AHR_BenchServer_t server);
+void AHR_BenchServerStop(AHR_BenchServer_t *server);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
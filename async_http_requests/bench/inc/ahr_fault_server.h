@@ -0,0 +1,164 @@
+///
+/// \brief  Fault injecting HTTP/1.1 Server for Tests and Benchmarks on the Loopback.
+///         One Thread serves all Connections through epoll. Each Request is matched against the Routes by the
+///         Prefix of its Path, the first matching Route decides how it is answered:
+///
+///             - a Delay before the first Byte, drawn from a Latency Distribution,
+///             - a Bandwidth Cap which trickles Head and Body,
+///             - a Rate of injected Errors (5xx), of dropped Connections (closed without a Response),
+///               of Resets (RST halfway through the Body) and of Stalls (Sending stops halfway and the
+///               Connection stays open until the Client gives up),
+///             - oversized Bodies, generated while they are sent so they take no Memory, and huge Headers.
+///
+///         Faults are drawn from a seeded Generator, a Run with the same Seed and Requests injects the same.
+///         Requests which match no Route are answered with 404.
+///
+///         Routes are written as one Line each, see AHR_FaultRouteParse():
+///
+///             /slow     latency=lognormal:20:0.5 body=4096
+///             /flaky    error_rate=0.05 error_status=503 drop_rate=0.01
+///             /big      body=300000000 rate=10000000
+///             /trickle  latency=fixed:500 rate=64
+///             /reset    reset_rate=0.5 body=65536
+///             /stall    stall_rate=1 body=65536
+///             /headers  headers=65536
+///             /replay   shape=1
+///             *         body=64
+///
+///         A Route with "shape=1" lets each Request shape its own Response through a Header, f.e.
+///         "X-Fault-Shape: status=404 body=1234 headers=512 latency_us=2500". Given Keys replace those of the
+///         Route, the Fault Rates of the Route still apply. This is how ahr_replay reproduces recorded Responses.
+///
+/// \example    AHR_FaultRoute_t route;
+///             AHR_FaultRouteParse("/flaky error_rate=0.1", &route);
+///             AHR_FaultServer_t server = AHR_FaultServerStart(0, &route, 1, 42);
+///             printf("http://127.0.0.1:%u/flaky\n", AHR_FaultServerPort(server));
+///             ...
+///             AHR_FaultServerStop(&server);
+///
+#ifndef __AHR_FAULT_SERVER_H__
+#define __AHR_FAULT_SERVER_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_FAULT_PATH_BYTES 128U
+
+typedef enum
+{
+    AHR_FAULT_LATENCY_NONE = 0,
+    ///
+    /// \brief  Always "a" Milliseconds.
+    ///
+    AHR_FAULT_LATENCY_FIXED = 1,
+    ///
+    /// \brief  Uniform between "a" and "b" Milliseconds.
+    ///
+    AHR_FAULT_LATENCY_UNIFORM = 2,
+    ///
+    /// \brief  Exponential with a Mean of "a" Milliseconds.
+    ///
+    AHR_FAULT_LATENCY_EXPONENTIAL = 3,
+    ///
+    /// \brief  Log-normal with a Median of "a" Milliseconds and a Shape "b", 1.0 gives a long Tail.
+    ///
+    AHR_FAULT_LATENCY_LOGNORMAL = 4
+} AHR_FaultLatencyKind_t;
+
+typedef struct
+{
+    AHR_FaultLatencyKind_t kind;
+    double a;
+    double b;
+} AHR_FaultLatency_t;
+
+typedef struct
+{
+    ///
+    /// \brief  Prefix of the Request Path, "*" matches every Path.
+    ///
+    char path[AHR_FAULT_PATH_BYTES]; // flawfinder: ignore
+    unsigned int status;
+    ///
+    /// \brief  Delay between the complete Request and the first Byte of the Response.
+    ///
+    AHR_FaultLatency_t latency;
+    size_t body_bytes;
+    ///
+    /// \brief  Padding Headers of about this many Bytes are added to the Head.
+    ///
+    size_t header_bytes;
+    ///
+    /// \brief  Bytes per Second the Response is sent with, 0 for no Cap.
+    ///
+    double rate;
+    ///
+    /// \brief  Probabilities (0.0 - 1.0) per Request. At most one Fault is injected, in this Order.
+    ///
+    double drop_rate;
+    double error_rate;
+    double reset_rate;
+    double stall_rate;
+    unsigned int error_status;
+    ///
+    /// \brief  Answer with "Connection: close" and close each Connection after its Response.
+    ///
+    bool close_connections;
+    ///
+    /// \brief  Take Status, Body and Header Size and Latency from the "X-Fault-Shape" Header of the Request.
+    ///
+    bool request_shape;
+} AHR_FaultRoute_t;
+
+typedef struct
+{
+    uint64_t requests;
+    uint64_t drops;
+    uint64_t errors;
+    uint64_t resets;
+    uint64_t stalls;
+} AHR_FaultStats_t;
+
+struct AHR_FaultServer;
+typedef struct AHR_FaultServer* AHR_FaultServer_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \brief  Parse a Route from "PATH [KEY=VALUE ...]". Keys are status, body, headers, rate, drop_rate,
+///         error_rate, error_status, reset_rate, stall_rate, close (0 or 1), shape (0 or 1) and latency, which is one of
+///         "fixed:MS", "uniform:MIN:MAX", "exp:MEAN" or "lognormal:MEDIAN:SHAPE".
+///         Unset Keys answer 200 with an empty Body, without Delay and Faults.
+/// \returns    false if the Line is malformed.
+///
+bool AHR_FaultRouteParse(const char *line, AHR_FaultRoute_t *route);
+///
+/// \brief  Listen on 127.0.0.1:"port" and serve the Routes from a new Thread. The Routes are copied.
+/// \param[in] port - 0 picks a free Port, see AHR_FaultServerPort().
+/// \param[in] seed - Seed of the Generator which draws Latencies and Faults.
+/// \returns    NULL if the Socket or the Thread can not be created.
+///
+AHR_FaultServer_t AHR_FaultServerStart(uint16_t port, const AHR_FaultRoute_t *routes, size_t nroutes, uint64_t seed);
+uint16_t AHR_FaultServerPort(const AHR_FaultServer_t server);
+///
+/// \brief  What was injected so far on Route "route".
+/// \returns    false if there is no such Route.
+///
+bool AHR_FaultServerStats(const AHR_FaultServer_t server, size_t route, AHR_FaultStats_t *stats);
+void AHR_FaultServerStop(AHR_FaultServer_t *server);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
@@ -0,0 +1,712 @@
+///
+/// \brief  Loopback Throughput and Latency Benchmark of the Processor against a raw libcurl multi Loop.
+///         Every Combination of Concurrency, Body Size, Keep-Alive and Number of Processors is run closed-loop:
+///         "concurrency" Requests are in Flight at all Times, each finished Request is replaced by a new one
+///         until "--requests" Requests are done. The Baseline ("curl_multi") drives the same Number of Easy
+///         Handles from a single Thread and copies each Body like the Processor does.
+///
+///         Reports Requests per Second, p50 / p99 / p99.9 Latency from Submission to the Callback and the
+///         CPU Time per Request of the Client. The CPU Time of the embedded Server Thread is left out.
+///         Results are written to stdout as JSON, Progress to stderr.
+///
+///         Bodies are buffered, so "--sizes" has to stay below the largest Buffer Pool Class (256 KiB).
+///
+/// \example    ahr_bench --requests 5000 --concurrency 1,16,64 --sizes 64,16384 --processors 1,4 --keep-alive on > out.json
+///
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <ahr_bench_server.h>
+#include <async_http_requests/ahr_http_request_processor.h>
+#include <async_http_requests/private/ahr_logging.h>
+
+#include <curl/curl.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_BENCH_MAX_VALUES 16U
+///
+/// \brief  Most Objects AHR_CreateProcessorWithOptions() accepts, higher Concurrency needs more Processors.
+///
+#define AHR_BENCH_MAX_OBJECTS 25U
+
+typedef struct
+{
+    size_t values[AHR_BENCH_MAX_VALUES];
+    size_t count;
+} AHR_BenchList_t;
+
+typedef struct
+{
+    size_t requests;
+    AHR_BenchList_t concurrency;
+    AHR_BenchList_t sizes;
+    AHR_BenchList_t processors;
+    ///
+    /// \brief  Bit 0 runs with Keep-Alive, Bit 1 without.
+    ///
+    unsigned int keep_alive;
+    bool baseline;
+} AHR_BenchArgs_t;
+
+///
+/// \brief  One Combination to run.
+///
+typedef struct
+{
+    const char *client;
+    size_t processors;
+    size_t concurrency;
+    size_t body_bytes;
+    bool keep_alive;
+    uint16_t port;
+    size_t requests;
+} AHR_BenchCase_t;
+
+///
+/// \brief  What a Run measured, Latencies in Seconds.
+///
+typedef struct
+{
+    double *latencies;
+    size_t nlatencies;
+    size_t errors;
+    double seconds;
+    double cpu_seconds;
+} AHR_BenchResult_t;
+
+struct AHR_BenchLoad;
+
+///
+/// \brief  A Request in Flight of the Processor Run, the User Data of its Callbacks.
+///
+typedef struct
+{
+    struct AHR_BenchLoad *load;
+    size_t index;
+    AHR_Processor_t processor;
+    size_t object;
+    double submitted;
+} AHR_BenchSlot_t;
+
+///
+/// \brief  Shared by the Processors Threads, which finish Slots, and the Thread which submits them again.
+///
+typedef struct AHR_BenchLoad
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    AHR_BenchResult_t *result;
+    size_t *finished;
+    size_t nfinished;
+    size_t done;
+} AHR_BenchLoad_t;
+
+///
+/// \brief  A Request in Flight of the Baseline.
+///
+typedef struct
+{
+    CURL *easy;
+    char *body;
+    size_t capacity;
+    size_t nbody;
+    double submitted;
+} AHR_BenchEasy_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_BenchParseArgs(int argc, char **argv, AHR_BenchArgs_t *args);
+///
+/// \brief  Parse a comma separated List of positive Numbers.
+///
+static bool AHR_BenchParseList(const char *value, AHR_BenchList_t *list);
+static bool AHR_BenchRunProcessors(const AHR_BenchCase_t *c, AHR_BenchResult_t *result);
+static bool AHR_BenchRunBaseline(const AHR_BenchCase_t *c, AHR_BenchResult_t *result);
+///
+/// \brief  Configure and submit "slot" again, spins while its Object is still in its Callback.
+///
+static bool AHR_BenchSubmit(AHR_BenchSlot_t *slot, char *url);
+static void AHR_BenchReport(const AHR_BenchCase_t *c, AHR_BenchResult_t *result, bool first);
+
+static void AHR_BenchOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes);
+static void AHR_BenchOnError(void *user_data, size_t object, size_t error_code);
+static void AHR_BenchFinish(AHR_BenchSlot_t *slot, bool failed);
+static size_t AHR_BenchWrite(char *data, size_t size, size_t nmemb, void *user_data);
+
+static void AHR_BenchLogNothing(void *arg, const char *str);
+static void AHR_BenchLogError(void *arg, const char *str);
+static int AHR_BenchCompare(const void *a, const void *b);
+static double AHR_BenchNow(void);
+static double AHR_BenchCpuNow(void);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+int main(int argc, char **argv)
+{
+    AHR_BenchArgs_t args = {
+        .requests = 2000U,
+        .concurrency = {.values = {1U, 8U, 64U}, .count = 3U},
+        .sizes = {.values = {64U, 4096U, 65536U}, .count = 3U},
+        .processors = {.values = {1U, 4U}, .count = 2U},
+        .keep_alive = 3U,
+        .baseline = true
+    };
+    if(!AHR_BenchParseArgs(argc, argv, &args))
+    {
+        fprintf(
+            stderr,
+            "usage: %s [--requests N] [--concurrency N,...] [--sizes BYTES,...] [--processors N,...]\n"
+            "          [--keep-alive on|off|both] [--no-baseline]\n",
+            argv[0]
+        );
+        return 2;
+    }
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    bool ok = true;
+    bool first = true;
+    printf("{\n  \"benchmark\": \"ahr_bench\",\n  \"curl\": \"%s\",\n  \"results\": [", curl_version_info(CURLVERSION_NOW)->version);
+    for(size_t s=0;ok && s<args.sizes.count;++s)
+    {
+        const size_t size = args.sizes.values[s];
+        char *body = malloc(size);
+        if(!body)
+        {
+            ok = false;
+            break;
+        }
+        memset(body, 'x', size);
+        for(unsigned int k=0;ok && k<2U;++k)
+        {
+            if(0U == (args.keep_alive & (1U << k)))
+            {
+                continue;
+            }
+            const AHR_BenchContent_t content = {
+                .body = body,
+                .nbytes = size,
+                .gzip_body = NULL,
+                .gzip_nbytes = 0,
+                .content_type = "application/octet-stream",
+                .link_mbps = 0.0,
+                .close_connections = 1U == k
+            };
+            AHR_BenchServer_t server = AHR_BenchServerStart(0, &content);
+            if(!server)
+            {
+                perror("unable to start the server");
+                ok = false;
+                break;
+            }
+            for(size_t c=0;ok && c<args.concurrency.count;++c)
+            {
+                AHR_BenchCase_t bench = {
+                    .client = "curl_multi",
+                    .processors = 0,
+                    .concurrency = args.concurrency.values[c],
+                    .body_bytes = size,
+                    .keep_alive = 0U == k,
+                    .port = AHR_BenchServerPort(server),
+                    .requests = args.requests
+                };
+                //
+                // Index 0 is the Baseline, the others the Processor Counts.
+                //
+                for(size_t p=args.baseline ? 0U : 1U;ok && p<=args.processors.count;++p)
+                {
+                    bench.client = 0U == p ? "curl_multi" : "ahr";
+                    bench.processors = 0U == p ? 0U : args.processors.values[p - 1U];
+                    if(bench.processors > bench.concurrency)
+                    {
+                        continue;
+                    }
+                    if(bench.processors > 0U && (bench.concurrency + bench.processors - 1U) / bench.processors > AHR_BENCH_MAX_OBJECTS)
+                    {
+                        fprintf(
+                            stderr,
+                            "%-10s processors %zu concurrency %3zu skipped, more than %u objects per processor\n",
+                            bench.client,
+                            bench.processors,
+                            bench.concurrency,
+                            AHR_BENCH_MAX_OBJECTS
+                        );
+                        continue;
+                    }
+                    AHR_BenchResult_t result;
+                    memset(&result, 0, sizeof(result));
+                    result.latencies = calloc(bench.requests, sizeof(double));
+                    if(!result.latencies)
+                    {
+                        ok = false;
+                        break;
+                    }
+                    fprintf(
+                        stderr,
+                        "%-10s processors %zu concurrency %3zu body %7zu keep-alive %-3s ... ",
+                        bench.client,
+                        bench.processors,
+                        bench.concurrency,
+                        bench.body_bytes,
+                        bench.keep_alive ? "on" : "off"
+                    );
+                    const double server_cpu = AHR_BenchServerCpuSeconds(server);
+                    ok = 0U == p ? AHR_BenchRunBaseline(&bench, &result) : AHR_BenchRunProcessors(&bench, &result);
+                    result.cpu_seconds -= AHR_BenchServerCpuSeconds(server) - server_cpu;
+                    fprintf(stderr, "%s %.0f req/s\n", ok ? "ok" : "failed", (double)result.nlatencies / result.seconds);
+                    if(ok)
+                    {
+                        AHR_BenchReport(&bench, &result, first);
+                        first = false;
+                    }
+                    free(result.latencies);
+                }
+            }
+            AHR_BenchServerStop(&server);
+        }
+        free(body);
+    }
+    printf("\n  ]\n}\n");
+    curl_global_cleanup();
+    return ok ? 0 : 1;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_BenchParseArgs(int argc, char **argv, AHR_BenchArgs_t *args)
+{
+    for(int i=1;i<argc;++i)
+    {
+        if(0 == strcmp(argv[i], "--no-baseline"))
+        {
+            args->baseline = false;
+            continue;
+        }
+        if(i + 1 >= argc)
+        {
+            return false;
+        }
+        const char *value = argv[++i];
+        if(0 == strcmp(argv[i - 1], "--requests"))
+        {
+            args->requests = strtoull(value, NULL, 10);
+        }
+        else if(0 == strcmp(argv[i - 1], "--concurrency"))
+        {
+            if(!AHR_BenchParseList(value, &args->concurrency))
+            {
+                return false;
+            }
+        }
+        else if(0 == strcmp(argv[i - 1], "--sizes"))
+        {
+            if(!AHR_BenchParseList(value, &args->sizes))
+            {
+                return false;
+            }
+        }
+        else if(0 == strcmp(argv[i - 1], "--processors"))
+        {
+            if(!AHR_BenchParseList(value, &args->processors))
+            {
+                return false;
+            }
+        }
+        else if(0 == strcmp(argv[i - 1], "--keep-alive"))
+        {
+            args->keep_alive = 0 == strcmp(value, "on") ? 1U : 0 == strcmp(value, "off") ? 2U : 0 == strcmp(value, "both") ? 3U : 0U;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return args->requests > 0 && args->keep_alive > 0;
+}
+
+static bool AHR_BenchParseList(const char *value, AHR_BenchList_t *list)
+{
+    list->count = 0;
+    while(*value)
+    {
+        char *end = NULL;
+        const size_t n = strtoull(value, &end, 10);
+        if(end == value || 0 == n || list->count == AHR_BENCH_MAX_VALUES || (*end != ',' && *end != '\0'))
+        {
+            return false;
+        }
+        list->values[list->count++] = n;
+        value = *end ? end + 1 : end;
+    }
+    return list->count > 0;
+}
+
+static bool AHR_BenchRunProcessors(const AHR_BenchCase_t *c, AHR_BenchResult_t *result)
+{
+    const size_t per_processor = (c->concurrency + c->processors - 1U) / c->processors;
+    AHR_Logger_t logger = AHR_CreateLogger(NULL, AHR_BenchLogNothing, AHR_BenchLogNothing, AHR_BenchLogError);
+    AHR_Processor_t *processors = calloc(c->processors, sizeof(AHR_Processor_t));
+    AHR_BenchSlot_t *slots = calloc(c->concurrency, sizeof(AHR_BenchSlot_t));
+    AHR_BenchLoad_t load = {
+        .result = result,
+        .finished = calloc(c->concurrency, sizeof(size_t)),
+        .nfinished = 0,
+        .done = 0
+    };
+    pthread_mutex_init(&load.mutex, NULL);
+    pthread_cond_init(&load.cond, NULL);
+    bool ok = false;
+    if(!logger || !processors || !slots || !load.finished)
+    {
+        goto end;
+    }
+    const AHR_ProcessorOptions_t options = {.max_objects = per_processor};
+    for(size_t i=0;i<c->processors;++i)
+    {
+        processors[i] = AHR_CreateProcessorWithOptions(&options, logger);
+        if(!processors[i] || !AHR_ProcessorStart(processors[i]))
+        {
+            goto end;
+        }
+    }
+
+    char url[64]; // flawfinder: ignore
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/", (unsigned int)c->port);
+    const double begin = AHR_BenchNow();
+    const double cpu_begin = AHR_BenchCpuNow();
+    size_t submitted = 0;
+    for(;submitted<c->concurrency && submitted<c->requests;++submitted)
+    {
+        slots[submitted] = (AHR_BenchSlot_t){
+            .load = &load,
+            .index = submitted,
+            .processor = processors[submitted % c->processors],
+            .object = submitted / c->processors,
+            .submitted = 0.0
+        };
+        if(!AHR_BenchSubmit(&slots[submitted], url))
+        {
+            goto stop;
+        }
+    }
+    size_t finished[AHR_BENCH_MAX_VALUES];
+    pthread_mutex_lock(&load.mutex);
+    while(load.done < c->requests)
+    {
+        while(0 == load.nfinished)
+        {
+            pthread_cond_wait(&load.cond, &load.mutex);
+        }
+        //
+        // Resubmit without holding the Mutex, the Callbacks of the other Slots go on meanwhile.
+        //
+        const size_t n = load.nfinished < AHR_BENCH_MAX_VALUES ? load.nfinished : AHR_BENCH_MAX_VALUES;
+        load.nfinished -= n;
+        memcpy(finished, &load.finished[load.nfinished], n * sizeof(size_t)); // flawfinder: ignore
+        pthread_mutex_unlock(&load.mutex);
+        for(size_t i=0;i<n && submitted<c->requests;++i, ++submitted)
+        {
+            if(!AHR_BenchSubmit(&slots[finished[i]], url))
+            {
+                goto stop;
+            }
+        }
+        pthread_mutex_lock(&load.mutex);
+    }
+    pthread_mutex_unlock(&load.mutex);
+    result->seconds = AHR_BenchNow() - begin;
+    result->cpu_seconds = AHR_BenchCpuNow() - cpu_begin;
+    ok = true;
+
+    stop:
+    for(size_t i=0;i<c->processors;++i)
+    {
+        AHR_ProcessorStop(processors[i]);
+    }
+
+    end:
+    for(size_t i=0;processors && i<c->processors;++i)
+    {
+        if(processors[i])
+        {
+            AHR_DestroyProcessor(&processors[i]);
+        }
+    }
+    if(logger)
+    {
+        AHR_DestroyLogger(&logger);
+    }
+    pthread_cond_destroy(&load.cond);
+    pthread_mutex_destroy(&load.mutex);
+    free(load.finished);
+    free(slots);
+    free(processors);
+    return ok;
+}
+
+static bool AHR_BenchRunBaseline(const AHR_BenchCase_t *c, AHR_BenchResult_t *result)
+{
+    char url[64]; // flawfinder: ignore
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/", (unsigned int)c->port);
+    CURLM *multi = curl_multi_init();
+    AHR_BenchEasy_t *easies = calloc(c->concurrency, sizeof(AHR_BenchEasy_t));
+    bool ok = false;
+    if(!multi || !easies)
+    {
+        goto end;
+    }
+    for(size_t i=0;i<c->concurrency;++i)
+    {
+        easies[i].easy = curl_easy_init();
+        easies[i].capacity = c->body_bytes;
+        easies[i].body = malloc(c->body_bytes);
+        if(!easies[i].easy || !easies[i].body)
+        {
+            goto end;
+        }
+        curl_easy_setopt(easies[i].easy, CURLOPT_URL, url);
+        curl_easy_setopt(easies[i].easy, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(easies[i].easy, CURLOPT_WRITEFUNCTION, AHR_BenchWrite);
+        curl_easy_setopt(easies[i].easy, CURLOPT_WRITEDATA, &easies[i]);
+        curl_easy_setopt(easies[i].easy, CURLOPT_PRIVATE, &easies[i]);
+    }
+
+    const double begin = AHR_BenchNow();
+    const double cpu_begin = AHR_BenchCpuNow();
+    size_t submitted = 0;
+    size_t done = 0;
+    for(;submitted<c->concurrency && submitted<c->requests;++submitted)
+    {
+        easies[submitted].nbody = 0;
+        easies[submitted].submitted = AHR_BenchNow();
+        curl_multi_add_handle(multi, easies[submitted].easy);
+    }
+    while(done < c->requests)
+    {
+        int running = 0;
+        if(CURLM_OK != curl_multi_perform(multi, &running))
+        {
+            goto end;
+        }
+        int queued = 0;
+        CURLMsg *m = NULL;
+        while(NULL != (m = curl_multi_info_read(multi, &queued)))
+        {
+            if(CURLMSG_DONE != m->msg)
+            {
+                continue;
+            }
+            AHR_BenchEasy_t *easy = NULL;
+            curl_easy_getinfo(m->easy_handle, CURLINFO_PRIVATE, (char**)&easy);
+            long status = 0;
+            curl_easy_getinfo(m->easy_handle, CURLINFO_RESPONSE_CODE, &status);
+            if(CURLE_OK == m->data.result && 200 == status)
+            {
+                result->latencies[result->nlatencies++] = AHR_BenchNow() - easy->submitted;
+            }
+            else
+            {
+                ++result->errors;
+            }
+            ++done;
+            curl_multi_remove_handle(multi, easy->easy);
+            if(submitted < c->requests)
+            {
+                easy->nbody = 0;
+                easy->submitted = AHR_BenchNow();
+                curl_multi_add_handle(multi, easy->easy);
+                ++submitted;
+            }
+        }
+        if(done < c->requests && CURLM_OK != curl_multi_poll(multi, NULL, 0, 100, NULL))
+        {
+            goto end;
+        }
+    }
+    result->seconds = AHR_BenchNow() - begin;
+    result->cpu_seconds = AHR_BenchCpuNow() - cpu_begin;
+    ok = true;
+
+    end:
+    for(size_t i=0;easies && i<c->concurrency;++i)
+    {
+        if(easies[i].easy)
+        {
+            curl_multi_remove_handle(multi, easies[i].easy);
+            curl_easy_cleanup(easies[i].easy);
+        }
+        free(easies[i].body);
+    }
+    if(multi)
+    {
+        curl_multi_cleanup(multi);
+    }
+    free(easies);
+    return ok;
+}
+
+static bool AHR_BenchSubmit(AHR_BenchSlot_t *slot, char *url)
+{
+    AHR_RequestData_t request_data;
+    memset(&request_data, 0, sizeof(request_data));
+    request_data.url = url;
+    const AHR_UserData_t user_data = {
+        .data = slot,
+        .on_success = AHR_BenchOnSuccess,
+        .on_error = AHR_BenchOnError,
+        .on_data = NULL,
+        .on_complete = NULL
+    };
+    AHR_ProcessorStatus_t status = AHR_PROC_OBJECT_BUSY;
+    while(AHR_PROC_OBJECT_BUSY == status)
+    {
+        status = AHR_ProcessorGet(slot->processor, slot->object, &request_data, user_data);
+        if(AHR_PROC_OBJECT_BUSY == status)
+        {
+            sched_yield();
+        }
+    }
+    slot->submitted = AHR_BenchNow();
+    if(AHR_PROC_OK != status || AHR_PROC_OK != AHR_ProcessorMakeRequest(slot->processor, slot->object))
+    {
+        fprintf(stderr, "unable to make a request with object %zu\n", slot->object);
+        return false;
+    }
+    return true;
+}
+
+static void AHR_BenchReport(const AHR_BenchCase_t *c, AHR_BenchResult_t *result, bool first)
+{
+    const size_t n = result->nlatencies;
+    qsort(result->latencies, n, sizeof(double), AHR_BenchCompare);
+    const double *l = result->latencies;
+    printf(
+        "%s\n    {\"client\": \"%s\", \"processors\": %zu, \"concurrency\": %zu, \"body_bytes\": %zu, "
+        "\"keep_alive\": %s, \"requests\": %zu, \"errors\": %zu, \"seconds\": %.6f, "
+        "\"requests_per_second\": %.1f, "
+        "\"latency_us\": {\"p50\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"max\": %.1f}, "
+        "\"cpu_us_per_request\": %.2f}",
+        first ? "" : ",",
+        c->client,
+        c->processors,
+        c->concurrency,
+        c->body_bytes,
+        c->keep_alive ? "true" : "false",
+        n,
+        result->errors,
+        result->seconds,
+        (double)n / result->seconds,
+        n > 0 ? 1e6 * l[(n * 50U) / 100U] : 0.0,
+        n > 0 ? 1e6 * l[(n * 99U) / 100U] : 0.0,
+        n > 0 ? 1e6 * l[(n * 999U) / 1000U] : 0.0,
+        n > 0 ? 1e6 * l[n - 1U] : 0.0,
+        1e6 * result->cpu_seconds / (double)(n + result->errors)
+    );
+    fflush(stdout);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_BenchOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes)
+{
+    (void)object;
+    (void)buffer;
+    (void)nbytes;
+    AHR_BenchFinish((AHR_BenchSlot_t*)user_data, 200U != status_code);
+}
+
+static void AHR_BenchOnError(void *user_data, size_t object, size_t error_code)
+{
+    (void)object;
+    fprintf(stderr, "transfer error %zu\n", error_code);
+    AHR_BenchFinish((AHR_BenchSlot_t*)user_data, true);
+}
+
+static void AHR_BenchFinish(AHR_BenchSlot_t *slot, bool failed)
+{
+    const double now = AHR_BenchNow();
+    AHR_BenchLoad_t *load = slot->load;
+    pthread_mutex_lock(&load->mutex);
+    AHR_BenchResult_t *result = load->result;
+    if(failed)
+    {
+        ++result->errors;
+    }
+    else
+    {
+        result->latencies[result->nlatencies++] = now - slot->submitted;
+    }
+    ++load->done;
+    load->finished[load->nfinished++] = slot->index;
+    pthread_cond_signal(&load->cond);
+    pthread_mutex_unlock(&load->mutex);
+}
+
+static size_t AHR_BenchWrite(char *data, size_t size, size_t nmemb, void *user_data)
+{
+    AHR_BenchEasy_t *easy = (AHR_BenchEasy_t*)user_data;
+    const size_t n = size * nmemb;
+    if(easy->nbody + n > easy->capacity)
+    {
+        return 0;
+    }
+    memcpy(&easy->body[easy->nbody], data, n); // flawfinder: ignore
+    easy->nbody += n;
+    return n;
+}
+
+static void AHR_BenchLogNothing(void *arg, const char *str)
+{
+    (void)arg;
+    (void)str;
+}
+
+static void AHR_BenchLogError(void *arg, const char *str)
+{
+    (void)arg;
+    fprintf(stderr, "%s\n", str);
+}
+
+static int AHR_BenchCompare(const void *a, const void *b)
+{
+    const double x = *(const double*)a;
+    const double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double AHR_BenchNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+static double AHR_BenchCpuNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
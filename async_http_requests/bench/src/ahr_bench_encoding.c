@@ -0,0 +1,421 @@
+///
+/// \brief  Loopback Benchmark of compressed Responses.
+///         A large JSON Body is fetched repeatedly, once sent as is and once gzip compressed,
+///         from a local Server whose Link can be throttled to a given Bandwidth.
+///         Reports Latency, Throughput and the Bytes on the Wire versus the decoded Bytes.
+///
+/// \example    ahr_bench_encoding --size 4194304 --requests 50 --mbps 100
+///
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <ahr_bench_server.h>
+#include <async_http_requests/ahr_http_request_processor.h>
+#include <async_http_requests/private/ahr_logging.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+typedef struct
+{
+    size_t size;
+    size_t requests;
+    double mbps;
+    uint16_t port;
+} AHR_BenchArgs_t;
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool done;
+    bool failed;
+    size_t received;
+} AHR_BenchWait_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_BenchParseArgs(int argc, char **argv, AHR_BenchArgs_t *args);
+///
+/// \brief  Deterministic JSON Array of Records with at least "size" Bytes.
+///
+static char* AHR_BenchMakeJson(size_t size, size_t *nbytes);
+static char* AHR_BenchGzip(const char *data, size_t nbytes, size_t *compressed);
+static bool AHR_BenchRun(const char *label, unsigned int encodings, const AHR_BenchArgs_t *args, uint16_t port, size_t nbytes);
+
+static AHR_StreamAction_t AHR_BenchOnData(void *user_data, size_t object, const char *data, size_t nbytes);
+static void AHR_BenchOnComplete(void *user_data, size_t object, size_t status_code);
+static void AHR_BenchOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes);
+static void AHR_BenchOnError(void *user_data, size_t object, size_t error_code);
+static void AHR_BenchFinish(AHR_BenchWait_t *wait, bool failed);
+
+static void AHR_BenchLogNothing(void *arg, const char *str);
+static void AHR_BenchLogError(void *arg, const char *str);
+static int AHR_BenchCompare(const void *a, const void *b);
+static double AHR_BenchNow(void);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+int main(int argc, char **argv)
+{
+    AHR_BenchArgs_t args = {.size = 4U * 1024U * 1024U, .requests = 50U, .mbps = 0.0, .port = 0U};
+    if(!AHR_BenchParseArgs(argc, argv, &args))
+    {
+        fprintf(stderr, "usage: %s [--size BYTES] [--requests N] [--mbps MBIT_PER_S] [--port PORT]\n", argv[0]);
+        return 2;
+    }
+
+    size_t nbytes = 0;
+    char *json = AHR_BenchMakeJson(args.size, &nbytes);
+    size_t ncompressed = 0;
+    char *compressed = json ? AHR_BenchGzip(json, nbytes, &ncompressed) : NULL;
+    if(!compressed)
+    {
+        fprintf(stderr, "unable to create the body\n");
+        free(json);
+        return 1;
+    }
+    const AHR_BenchContent_t content = {
+        .body = json,
+        .nbytes = nbytes,
+        .gzip_body = compressed,
+        .gzip_nbytes = ncompressed,
+        .content_type = "application/json",
+        .link_mbps = args.mbps
+    };
+    AHR_BenchServer_t server = AHR_BenchServerStart(args.port, &content);
+    if(!server)
+    {
+        perror("unable to start the server");
+        free(compressed);
+        free(json);
+        return 1;
+    }
+    printf(
+        "body %zu bytes, gzip %zu bytes (ratio %.2f), link %s%.0f Mbit/s, %zu requests\n",
+        nbytes,
+        ncompressed,
+        (double)nbytes / (double)ncompressed,
+        args.mbps > 0.0 ? "" : "unlimited ",
+        args.mbps,
+        args.requests
+    );
+    const bool ok = AHR_BenchRun("identity", AHR_ENCODING_IDENTITY, &args, AHR_BenchServerPort(server), nbytes)
+        && AHR_BenchRun("gzip", AHR_ENCODING_GZIP, &args, AHR_BenchServerPort(server), nbytes);
+    AHR_BenchServerStop(&server);
+    free(compressed);
+    free(json);
+    return ok ? 0 : 1;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_BenchParseArgs(int argc, char **argv, AHR_BenchArgs_t *args)
+{
+    for(int i=1;i<argc;++i)
+    {
+        if(i + 1 >= argc)
+        {
+            return false;
+        }
+        const char *value = argv[++i];
+        if(0 == strcmp(argv[i - 1], "--size"))
+        {
+            args->size = strtoull(value, NULL, 10);
+        }
+        else if(0 == strcmp(argv[i - 1], "--requests"))
+        {
+            args->requests = strtoull(value, NULL, 10);
+        }
+        else if(0 == strcmp(argv[i - 1], "--mbps"))
+        {
+            args->mbps = strtod(value, NULL);
+        }
+        else if(0 == strcmp(argv[i - 1], "--port"))
+        {
+            args->port = (uint16_t)strtoul(value, NULL, 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return args->size > 0 && args->requests > 0;
+}
+
+static char* AHR_BenchMakeJson(size_t size, size_t *nbytes)
+{
+    //
+    // Room for one more Record and the closing Bracket.
+    //
+    const size_t capacity = size + 512U;
+    char *json = malloc(capacity);
+    if(!json)
+    {
+        return NULL;
+    }
+    size_t n = 0;
+    json[n++] = '[';
+    for(size_t i=0;n < size;++i)
+    {
+        const int written = snprintf(
+            &json[n],
+            capacity - n,
+            "%s{\"id\":%zu,\"name\":\"user-%zu\",\"email\":\"user-%zu@example.com\",\"active\":%s,"
+            "\"score\":%zu.%02zu,\"tags\":[\"alpha\",\"beta\",\"group-%zu\"]}",
+            i > 0 ? "," : "",
+            i,
+            i,
+            i,
+            (i % 3U) ? "true" : "false",
+            (i * 7919U) % 1000U,
+            (i * 31U) % 100U,
+            i % 16U
+        );
+        if(written < 0 || (size_t)written >= capacity - n)
+        {
+            break;
+        }
+        n += (size_t)written;
+    }
+    json[n++] = ']';
+    *nbytes = n;
+    return json;
+}
+
+static char* AHR_BenchGzip(const char *data, size_t nbytes, size_t *compressed)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    //
+    // 15 Bits Window + 16 writes a gzip Wrapper instead of a zlib one.
+    //
+    if(Z_OK != deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY))
+    {
+        return NULL;
+    }
+    const size_t capacity = deflateBound(&stream, (uLong)nbytes);
+    char *out = malloc(capacity);
+    if(!out)
+    {
+        deflateEnd(&stream);
+        return NULL;
+    }
+    stream.next_in = (Bytef*)data;
+    stream.avail_in = (uInt)nbytes;
+    stream.next_out = (Bytef*)out;
+    stream.avail_out = (uInt)capacity;
+    const int status = deflate(&stream, Z_FINISH);
+    *compressed = stream.total_out;
+    deflateEnd(&stream);
+    if(Z_STREAM_END != status)
+    {
+        free(out);
+        return NULL;
+    }
+    return out;
+}
+
+static bool AHR_BenchRun(const char *label, unsigned int encodings, const AHR_BenchArgs_t *args, uint16_t port, size_t nbytes)
+{
+    AHR_Logger_t logger = AHR_CreateLogger(NULL, AHR_BenchLogNothing, AHR_BenchLogNothing, AHR_BenchLogError);
+    const AHR_ProcessorOptions_t options = {
+        .max_objects = 1,
+        .accept_encodings = encodings,
+        .max_decoded_bytes = nbytes + 1U
+    };
+    AHR_Processor_t processor = AHR_CreateProcessorWithOptions(&options, logger);
+    double *latencies = calloc(args->requests, sizeof(double));
+    bool ok = false;
+    if(!logger || !processor || !latencies || !AHR_ProcessorStart(processor))
+    {
+        fprintf(stderr, "%s: unable to set up the processor\n", label);
+        goto end;
+    }
+
+    char url[64]; // flawfinder: ignore
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/data.json", (unsigned int)port);
+    AHR_RequestData_t request_data;
+    memset(&request_data, 0, sizeof(request_data));
+    request_data.url = url;
+    AHR_BenchWait_t wait = {.done = false, .failed = false, .received = 0};
+    pthread_mutex_init(&wait.mutex, NULL);
+    pthread_cond_init(&wait.cond, NULL);
+    const AHR_UserData_t user_data = {
+        .data = &wait,
+        .on_success = AHR_BenchOnSuccess,
+        .on_error = AHR_BenchOnError,
+        .on_data = AHR_BenchOnData,
+        .on_complete = AHR_BenchOnComplete
+    };
+
+    size_t completed = 0;
+    const double start = AHR_BenchNow();
+    for(;completed<args->requests;++completed)
+    {
+        wait.done = false;
+        wait.received = 0;
+        const double begin = AHR_BenchNow();
+        //
+        // The Object stays busy until the previous Callback returned.
+        //
+        AHR_ProcessorStatus_t status = AHR_PROC_OBJECT_BUSY;
+        while(AHR_PROC_OBJECT_BUSY == status)
+        {
+            status = AHR_ProcessorGet(processor, 0, &request_data, user_data);
+            if(AHR_PROC_OBJECT_BUSY == status)
+            {
+                sched_yield();
+            }
+        }
+        if(AHR_PROC_OK != status || AHR_PROC_OK != AHR_ProcessorMakeRequest(processor, 0))
+        {
+            fprintf(stderr, "%s: unable to make request %zu\n", label, completed);
+            break;
+        }
+        pthread_mutex_lock(&wait.mutex);
+        while(!wait.done)
+        {
+            pthread_cond_wait(&wait.cond, &wait.mutex);
+        }
+        pthread_mutex_unlock(&wait.mutex);
+        latencies[completed] = AHR_BenchNow() - begin;
+        if(wait.failed || wait.received != nbytes)
+        {
+            fprintf(stderr, "%s: request %zu failed, %zu of %zu bytes\n", label, completed, wait.received, nbytes);
+            break;
+        }
+    }
+    const double elapsed = AHR_BenchNow() - start;
+    ok = completed == args->requests;
+
+    if(completed > 0)
+    {
+        AHR_DecodingStats_t stats;
+        AHR_ProcessorDecodingStats(processor, &stats);
+        qsort(latencies, completed, sizeof(double), AHR_BenchCompare);
+        double sum = 0.0;
+        for(size_t i=0;i<completed;++i)
+        {
+            sum += latencies[i];
+        }
+        printf(
+            "%-8s mean %8.3f ms  p50 %8.3f ms  p99 %8.3f ms  %8.1f MB/s decoded  "
+            "wire %llu B  decoded %llu B  (%llu of %llu responses encoded)\n",
+            label,
+            1e3 * sum / (double)completed,
+            1e3 * latencies[completed / 2U],
+            1e3 * latencies[(completed * 99U) / 100U],
+            ((double)stats.decoded_bytes / elapsed) / 1e6,
+            (unsigned long long)stats.wire_bytes,
+            (unsigned long long)stats.decoded_bytes,
+            (unsigned long long)stats.encoded_responses,
+            (unsigned long long)stats.responses
+        );
+    }
+    AHR_ProcessorStop(processor);
+    pthread_cond_destroy(&wait.cond);
+    pthread_mutex_destroy(&wait.mutex);
+
+    end:
+    if(processor)
+    {
+        AHR_DestroyProcessor(&processor);
+    }
+    if(logger)
+    {
+        AHR_DestroyLogger(&logger);
+    }
+    free(latencies);
+    return ok;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static AHR_StreamAction_t AHR_BenchOnData(void *user_data, size_t object, const char *data, size_t nbytes)
+{
+    (void)object;
+    (void)data;
+    AHR_BenchWait_t *wait = (AHR_BenchWait_t*)user_data;
+    wait->received += nbytes;
+    return AHR_STREAM_CONTINUE;
+}
+
+static void AHR_BenchOnComplete(void *user_data, size_t object, size_t status_code)
+{
+    (void)object;
+    AHR_BenchFinish((AHR_BenchWait_t*)user_data, 200U != status_code);
+}
+
+static void AHR_BenchOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes)
+{
+    (void)object;
+    (void)buffer;
+    (void)nbytes;
+    AHR_BenchFinish((AHR_BenchWait_t*)user_data, 200U != status_code);
+}
+
+static void AHR_BenchOnError(void *user_data, size_t object, size_t error_code)
+{
+    (void)object;
+    fprintf(stderr, "transfer error %zu\n", error_code);
+    AHR_BenchFinish((AHR_BenchWait_t*)user_data, true);
+}
+
+static void AHR_BenchFinish(AHR_BenchWait_t *wait, bool failed)
+{
+    pthread_mutex_lock(&wait->mutex);
+    wait->failed = failed;
+    wait->done = true;
+    pthread_cond_signal(&wait->cond);
+    pthread_mutex_unlock(&wait->mutex);
+}
+
+static void AHR_BenchLogNothing(void *arg, const char *str)
+{
+    (void)arg;
+    (void)str;
+}
+
+static void AHR_BenchLogError(void *arg, const char *str)
+{
+    (void)arg;
+    fprintf(stderr, "%s\n", str);
+}
+
+static int AHR_BenchCompare(const void *a, const void *b)
+{
+    const double x = *(const double*)a;
+    const double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double AHR_BenchNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
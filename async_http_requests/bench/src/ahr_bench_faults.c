@@ -0,0 +1,371 @@
+///
+/// \brief  How the Processor copes with a misbehaving Server: Requests are run closed-loop against the Routes of
+///         the fault injecting Server, one Route after the other, and per Route the Outcomes (Success, HTTP Error,
+///         Transfer Error by curl Code) and the Latency Percentiles are reported as JSON on stdout.
+///
+///         The default Routes cover a long-tailed Latency, trickled Bodies, huge Headers, oversized Bodies,
+///         5xx Responses, dropped Connections and Resets. Stalls are left out, the Processor has no Timeout
+///         and would wait for them forever. Own Routes can be given with "--route".
+///
+/// \example    ahr_bench_faults --requests 500 --concurrency 8 --seed 3 > faults.json
+///
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <ahr_fault_server.h>
+#include <async_http_requests/ahr_http_request_processor.h>
+#include <async_http_requests/private/ahr_logging.h>
+
+#include <curl/curl.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_FAULTS_MAX_ROUTES 32U
+///
+/// \brief  Most Objects AHR_CreateProcessorWithOptions() accepts.
+///
+#define AHR_FAULTS_MAX_OBJECTS 25U
+///
+/// \brief  Transfer Errors are counted per curl Code below this Value, all others together.
+///
+#define AHR_FAULTS_MAX_CODES 100U
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    double *latencies;
+    size_t nlatencies;
+    size_t http_errors;
+    size_t transfer_errors[AHR_FAULTS_MAX_CODES + 1U];
+    size_t done;
+    size_t *finished;
+    size_t nfinished;
+} AHR_FaultsLoad_t;
+
+typedef struct
+{
+    AHR_FaultsLoad_t *load;
+    size_t index;
+    double submitted;
+} AHR_FaultsSlot_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Run "requests" Requests against "url" and report them as one JSON Object.
+///
+static bool AHR_FaultsRun(AHR_Processor_t processor, size_t concurrency, size_t requests, char *url, const char *route, bool first);
+static bool AHR_FaultsSubmit(AHR_Processor_t processor, size_t object, AHR_FaultsSlot_t *slot, char *url);
+static void AHR_FaultsOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes);
+static void AHR_FaultsOnError(void *user_data, size_t object, size_t error_code);
+static void AHR_FaultsFinish(AHR_FaultsSlot_t *slot, size_t status_code, size_t error_code, bool failed);
+static void AHR_FaultsLogNothing(void *arg, const char *str);
+static int AHR_FaultsCompare(const void *a, const void *b);
+static double AHR_FaultsNow(void);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+int main(int argc, char **argv)
+{
+    static const char *defaults[] = {
+        "/fast body=1024",
+        "/lognormal latency=lognormal:5:1 body=1024",
+        "/trickle rate=200000 body=65536",
+        "/headers headers=65536 body=64",
+        "/oversized body=16777216",
+        "/errors error_rate=0.2 body=1024",
+        "/drops drop_rate=0.1 body=1024",
+        "/resets reset_rate=0.1 body=65536"
+    };
+    AHR_FaultRoute_t routes[AHR_FAULTS_MAX_ROUTES];
+    size_t nroutes = 0;
+    size_t requests = 400U;
+    size_t concurrency = 8U;
+    unsigned long long seed = 1U;
+    bool ok = 0 != argc % 2;
+    for(int i=1;ok && i+1<argc;i+=2)
+    {
+        if(0 == strcmp(argv[i], "--requests"))
+        {
+            requests = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if(0 == strcmp(argv[i], "--concurrency"))
+        {
+            concurrency = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if(0 == strcmp(argv[i], "--seed"))
+        {
+            seed = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if(0 == strcmp(argv[i], "--route"))
+        {
+            ok = nroutes < AHR_FAULTS_MAX_ROUTES && AHR_FaultRouteParse(argv[i + 1], &routes[nroutes++]);
+        }
+        else
+        {
+            ok = false;
+        }
+    }
+    for(size_t i=0;ok && 0 == nroutes && i<sizeof(defaults) / sizeof(defaults[0]);++i)
+    {
+        ok = AHR_FaultRouteParse(defaults[i], &routes[i]);
+    }
+    nroutes = 0 == nroutes ? sizeof(defaults) / sizeof(defaults[0]) : nroutes;
+    if(!ok || 0 == requests || 0 == concurrency || concurrency > AHR_FAULTS_MAX_OBJECTS)
+    {
+        fprintf(
+            stderr,
+            "usage: %s [--requests N] [--concurrency 1-%u] [--seed N] [--route 'PATH KEY=VALUE ...'] ...\n",
+            argv[0],
+            AHR_FAULTS_MAX_OBJECTS
+        );
+        return 2;
+    }
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    AHR_FaultServer_t server = AHR_FaultServerStart(0, routes, nroutes, (uint64_t)seed);
+    AHR_Logger_t logger = AHR_CreateLogger(NULL, AHR_FaultsLogNothing, AHR_FaultsLogNothing, AHR_FaultsLogNothing);
+    const AHR_ProcessorOptions_t options = {.max_objects = concurrency};
+    AHR_Processor_t processor = logger ? AHR_CreateProcessorWithOptions(&options, logger) : NULL;
+    ok = server && processor && AHR_ProcessorStart(processor);
+    if(ok)
+    {
+        printf("{\n  \"benchmark\": \"ahr_bench_faults\",\n  \"curl\": \"%s\",\n  \"results\": [", curl_version_info(CURLVERSION_NOW)->version);
+    }
+    for(size_t i=0;ok && i<nroutes;++i)
+    {
+        //
+        // "*" is requested as "/".
+        //
+        char url[AHR_FAULT_PATH_BYTES + 32U]; // flawfinder: ignore
+        snprintf(
+            url,
+            sizeof(url),
+            "http://127.0.0.1:%u%.*s",
+            (unsigned int)AHR_FaultServerPort(server),
+            (int)AHR_FAULT_PATH_BYTES - 1,
+            0 == strcmp(routes[i].path, "*") ? "/" : routes[i].path
+        );
+        fprintf(stderr, "%-24s ... ", routes[i].path);
+        ok = AHR_FaultsRun(processor, concurrency, requests, url, routes[i].path, 0 == i);
+        fprintf(stderr, "%s\n", ok ? "ok" : "failed");
+    }
+    if(ok)
+    {
+        printf("\n  ]\n}\n");
+    }
+    if(processor)
+    {
+        AHR_ProcessorStop(processor);
+        AHR_DestroyProcessor(&processor);
+    }
+    if(logger)
+    {
+        AHR_DestroyLogger(&logger);
+    }
+    if(server)
+    {
+        AHR_FaultServerStop(&server);
+    }
+    curl_global_cleanup();
+    return ok ? 0 : 1;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_FaultsRun(AHR_Processor_t processor, size_t concurrency, size_t requests, char *url, const char *route, bool first)
+{
+    AHR_FaultsLoad_t load;
+    memset(&load, 0, sizeof(load));
+    load.latencies = calloc(requests, sizeof(double));
+    load.finished = calloc(concurrency, sizeof(size_t));
+    AHR_FaultsSlot_t *slots = calloc(concurrency, sizeof(AHR_FaultsSlot_t));
+    pthread_mutex_init(&load.mutex, NULL);
+    pthread_cond_init(&load.cond, NULL);
+    bool ok = false;
+    if(!load.latencies || !load.finished || !slots)
+    {
+        goto end;
+    }
+    const double begin = AHR_FaultsNow();
+    size_t submitted = 0;
+    for(;submitted<concurrency && submitted<requests;++submitted)
+    {
+        slots[submitted] = (AHR_FaultsSlot_t){.load = &load, .index = submitted, .submitted = 0.0};
+        if(!AHR_FaultsSubmit(processor, submitted, &slots[submitted], url))
+        {
+            goto end;
+        }
+    }
+    pthread_mutex_lock(&load.mutex);
+    while(load.done < requests)
+    {
+        while(0 == load.nfinished)
+        {
+            pthread_cond_wait(&load.cond, &load.mutex);
+        }
+        const size_t index = load.finished[--load.nfinished];
+        pthread_mutex_unlock(&load.mutex);
+        if(submitted < requests)
+        {
+            if(!AHR_FaultsSubmit(processor, index, &slots[index], url))
+            {
+                goto end;
+            }
+            ++submitted;
+        }
+        pthread_mutex_lock(&load.mutex);
+    }
+    pthread_mutex_unlock(&load.mutex);
+    const double seconds = AHR_FaultsNow() - begin;
+
+    const size_t n = load.nlatencies;
+    qsort(load.latencies, n, sizeof(double), AHR_FaultsCompare);
+    const double *l = load.latencies;
+    printf(
+        "%s\n    {\"route\": \"%s\", \"requests\": %zu, \"concurrency\": %zu, \"seconds\": %.6f, \"ok\": %zu, "
+        "\"http_errors\": %zu, \"latency_us\": {\"p50\": %.1f, \"p99\": %.1f, \"max\": %.1f}, \"transfer_errors\": {",
+        first ? "" : ",",
+        route,
+        requests,
+        concurrency,
+        seconds,
+        n - load.http_errors,
+        load.http_errors,
+        n > 0 ? 1e6 * l[(n * 50U) / 100U] : 0.0,
+        n > 0 ? 1e6 * l[(n * 99U) / 100U] : 0.0,
+        n > 0 ? 1e6 * l[n - 1U] : 0.0
+    );
+    bool first_code = true;
+    for(size_t code=0;code<=AHR_FAULTS_MAX_CODES;++code)
+    {
+        if(load.transfer_errors[code] > 0)
+        {
+            printf("%s\"%zu\": %zu", first_code ? "" : ", ", code, load.transfer_errors[code]);
+            first_code = false;
+        }
+    }
+    printf("}}");
+    fflush(stdout);
+    ok = true;
+
+    end:
+    if(!ok)
+    {
+        //
+        // Requests may still be in Flight, their Callbacks must not see the Load after it is gone.
+        //
+        AHR_ProcessorStop(processor);
+    }
+    pthread_cond_destroy(&load.cond);
+    pthread_mutex_destroy(&load.mutex);
+    free(slots);
+    free(load.finished);
+    free(load.latencies);
+    return ok;
+}
+
+static bool AHR_FaultsSubmit(AHR_Processor_t processor, size_t object, AHR_FaultsSlot_t *slot, char *url)
+{
+    AHR_RequestData_t request_data;
+    memset(&request_data, 0, sizeof(request_data));
+    request_data.url = url;
+    const AHR_UserData_t user_data = {
+        .data = slot,
+        .on_success = AHR_FaultsOnSuccess,
+        .on_error = AHR_FaultsOnError,
+        .on_data = NULL,
+        .on_complete = NULL
+    };
+    AHR_ProcessorStatus_t status = AHR_PROC_OBJECT_BUSY;
+    while(AHR_PROC_OBJECT_BUSY == status)
+    {
+        status = AHR_ProcessorGet(processor, object, &request_data, user_data);
+        if(AHR_PROC_OBJECT_BUSY == status)
+        {
+            sched_yield();
+        }
+    }
+    slot->submitted = AHR_FaultsNow();
+    if(AHR_PROC_OK != status || AHR_PROC_OK != AHR_ProcessorMakeRequest(processor, object))
+    {
+        fprintf(stderr, "unable to make a request with object %zu\n", object);
+        return false;
+    }
+    return true;
+}
+
+static void AHR_FaultsOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes)
+{
+    (void)object;
+    (void)buffer;
+    (void)nbytes;
+    AHR_FaultsFinish((AHR_FaultsSlot_t*)user_data, status_code, 0, false);
+}
+
+static void AHR_FaultsOnError(void *user_data, size_t object, size_t error_code)
+{
+    (void)object;
+    AHR_FaultsFinish((AHR_FaultsSlot_t*)user_data, 0, error_code, true);
+}
+
+static void AHR_FaultsFinish(AHR_FaultsSlot_t *slot, size_t status_code, size_t error_code, bool failed)
+{
+    const double now = AHR_FaultsNow();
+    AHR_FaultsLoad_t *load = slot->load;
+    pthread_mutex_lock(&load->mutex);
+    if(failed)
+    {
+        ++load->transfer_errors[error_code < AHR_FAULTS_MAX_CODES ? error_code : AHR_FAULTS_MAX_CODES];
+    }
+    else
+    {
+        load->http_errors += status_code < 200U || status_code > 299U ? 1U : 0U;
+        load->latencies[load->nlatencies++] = now - slot->submitted;
+    }
+    ++load->done;
+    load->finished[load->nfinished++] = slot->index;
+    pthread_cond_signal(&load->cond);
+    pthread_mutex_unlock(&load->mutex);
+}
+
+static void AHR_FaultsLogNothing(void *arg, const char *str)
+{
+    (void)arg;
+    (void)str;
+}
+
+static int AHR_FaultsCompare(const void *a, const void *b)
+{
+    const double x = *(const double*)a;
+    const double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double AHR_FaultsNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,347 @@
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <ahr_bench_histogram.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <zlib.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Cookies of HdrHistograms V2 Encoding, the 0x10 marks 8 Byte Words (Counts in ZigZag LEB128).
+///
+#define AHR_HISTOGRAM_ENCODING_COOKIE (0x1c849303 | 0x10)
+#define AHR_HISTOGRAM_COMPRESSION_COOKIE (0x1c849304 | 0x10)
+///
+/// \brief  Bytes of the uncompressed Header: Cookie, Payload Length, normalizing Index Offset, Digits,
+///         lowest and highest Value and the Integer to Double Ratio.
+///
+#define AHR_HISTOGRAM_HEADER_BYTES 40U
+///
+/// \brief  Most Bytes a single Count takes in ZigZag LEB128.
+///
+#define AHR_HISTOGRAM_MAX_VARINT_BYTES 9U
+
+struct AHR_BenchHistogram
+{
+    int64_t highest;
+    int digits;
+    int sub_bucket_half_count_magnitude;
+    int64_t sub_bucket_half_count;
+    int64_t sub_bucket_mask;
+    int64_t total;
+    int64_t max;
+    size_t ncounts;
+    int64_t counts[];
+};
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static size_t AHR_BenchHistogramIndex(const AHR_BenchHistogram_t histogram, int64_t value);
+static int64_t AHR_BenchHistogramValueAt(const AHR_BenchHistogram_t histogram, size_t index);
+///
+/// \brief  Encode "value" ZigZag LEB128 with at most 9 Bytes, the 9th Byte holds 8 Bits.
+///
+static size_t AHR_BenchHistogramVarint(uint8_t *buffer, int64_t value);
+static void AHR_BenchHistogramPut32(uint8_t *buffer, uint32_t value);
+static void AHR_BenchHistogramPut64(uint8_t *buffer, uint64_t value);
+static bool AHR_BenchHistogramBase64(FILE *log, const uint8_t *data, size_t nbytes);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_BenchHistogram_t AHR_BenchHistogramCreate(int64_t highest, int digits)
+{
+    if(highest < 2 || digits < 1 || digits > 5)
+    {
+        return NULL;
+    }
+    int64_t single_unit = 2;
+    for(int i=0;i<digits;++i)
+    {
+        single_unit *= 10;
+    }
+    int sub_bucket_count_magnitude = 0;
+    while(((int64_t)1 << sub_bucket_count_magnitude) < single_unit)
+    {
+        ++sub_bucket_count_magnitude;
+    }
+    const int64_t sub_bucket_count = (int64_t)1 << sub_bucket_count_magnitude;
+    int64_t smallest_untrackable = sub_bucket_count;
+    size_t buckets = 1;
+    while(smallest_untrackable <= highest)
+    {
+        if(smallest_untrackable > INT64_MAX / 2)
+        {
+            ++buckets;
+            break;
+        }
+        smallest_untrackable <<= 1;
+        ++buckets;
+    }
+    const size_t ncounts = (buckets + 1U) * (size_t)(sub_bucket_count / 2);
+    AHR_BenchHistogram_t histogram = calloc(1, sizeof(struct AHR_BenchHistogram) + ncounts * sizeof(int64_t));
+    if(!histogram)
+    {
+        return NULL;
+    }
+    histogram->highest = highest;
+    histogram->digits = digits;
+    histogram->sub_bucket_half_count_magnitude = sub_bucket_count_magnitude - 1;
+    histogram->sub_bucket_half_count = sub_bucket_count / 2;
+    histogram->sub_bucket_mask = sub_bucket_count - 1;
+    histogram->ncounts = ncounts;
+    return histogram;
+}
+
+void AHR_BenchHistogramDestroy(AHR_BenchHistogram_t *histogram)
+{
+    free(*histogram);
+    *histogram = NULL;
+}
+
+void AHR_BenchHistogramRecord(AHR_BenchHistogram_t histogram, int64_t value)
+{
+    value = value < 0 ? 0 : value > histogram->highest ? histogram->highest : value;
+    ++histogram->counts[AHR_BenchHistogramIndex(histogram, value)];
+    ++histogram->total;
+    if(value > histogram->max)
+    {
+        histogram->max = value;
+    }
+}
+
+void AHR_BenchHistogramAdd(AHR_BenchHistogram_t destination, const AHR_BenchHistogram_t source)
+{
+    for(size_t i=0;i<destination->ncounts && i<source->ncounts;++i)
+    {
+        destination->counts[i] += source->counts[i];
+    }
+    destination->total += source->total;
+    if(source->max > destination->max)
+    {
+        destination->max = source->max;
+    }
+}
+
+void AHR_BenchHistogramReset(AHR_BenchHistogram_t histogram)
+{
+    memset(histogram->counts, 0, histogram->ncounts * sizeof(int64_t));
+    histogram->total = 0;
+    histogram->max = 0;
+}
+
+int64_t AHR_BenchHistogramCount(const AHR_BenchHistogram_t histogram)
+{
+    return histogram->total;
+}
+
+int64_t AHR_BenchHistogramMax(const AHR_BenchHistogram_t histogram)
+{
+    return histogram->max;
+}
+
+int64_t AHR_BenchHistogramPercentile(const AHR_BenchHistogram_t histogram, double percentile)
+{
+    if(0 == histogram->total)
+    {
+        return 0;
+    }
+    percentile = percentile < 0.0 ? 0.0 : percentile > 100.0 ? 100.0 : percentile;
+    int64_t rank = (int64_t)(percentile / 100.0 * (double)histogram->total + 0.5);
+    rank = rank < 1 ? 1 : rank;
+    int64_t seen = 0;
+    for(size_t i=0;i<histogram->ncounts;++i)
+    {
+        seen += histogram->counts[i];
+        if(seen >= rank)
+        {
+            //
+            // The highest Value of the Bucket, but never above what was recorded.
+            //
+            const int64_t value = AHR_BenchHistogramValueAt(histogram, i + 1U) - 1;
+            return value < histogram->max ? value : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+bool AHR_BenchHistogramLogHeader(FILE *log, double start)
+{
+    char date[64]; // flawfinder: ignore
+    const time_t seconds = (time_t)start;
+    struct tm utc;
+    gmtime_r(&seconds, &utc);
+    strftime(date, sizeof(date), "%a %b %d %H:%M:%S UTC %Y", &utc);
+    return fprintf(
+        log,
+        "#[Histogram log format version 1.3]\n"
+        "#[StartTime: %.3f (seconds since epoch), %s]\n"
+        "#[BaseTime: %.3f (seconds since epoch)]\n"
+        "\"StartTimestamp\",\"Interval_Length\",\"Interval_Max\",\"Interval_Compressed_Histogram\"\n",
+        start,
+        date,
+        start
+    ) > 0;
+}
+
+bool AHR_BenchHistogramLogInterval(FILE *log, const char *tag, double start, double length, const AHR_BenchHistogram_t histogram)
+{
+    //
+    // Counts up to the highest recorded Value, Runs of empty Buckets are written as their negative Length.
+    //
+    const size_t limit = histogram->total > 0 ? AHR_BenchHistogramIndex(histogram, histogram->max) + 1U : 0U;
+    const size_t nraw = AHR_HISTOGRAM_HEADER_BYTES + limit * AHR_HISTOGRAM_MAX_VARINT_BYTES;
+    uint8_t *raw = malloc(nraw);
+    uLongf ncompressed = compressBound((uLong)nraw);
+    uint8_t *compressed = malloc(8U + ncompressed);
+    bool ok = false;
+    if(!raw || !compressed)
+    {
+        goto end;
+    }
+    size_t n = AHR_HISTOGRAM_HEADER_BYTES;
+    for(size_t i=0;i<limit;)
+    {
+        if(0 != histogram->counts[i])
+        {
+            n += AHR_BenchHistogramVarint(&raw[n], histogram->counts[i++]);
+            continue;
+        }
+        int64_t zeros = 0;
+        for(;i<limit && 0 == histogram->counts[i];++i)
+        {
+            ++zeros;
+        }
+        n += AHR_BenchHistogramVarint(&raw[n], -zeros);
+    }
+    const double ratio = 1.0;
+    uint64_t ratio_bits = 0;
+    memcpy(&ratio_bits, &ratio, sizeof(ratio_bits)); // flawfinder: ignore
+    AHR_BenchHistogramPut32(&raw[0], AHR_HISTOGRAM_ENCODING_COOKIE);
+    AHR_BenchHistogramPut32(&raw[4], (uint32_t)(n - AHR_HISTOGRAM_HEADER_BYTES));
+    AHR_BenchHistogramPut32(&raw[8], 0U);
+    AHR_BenchHistogramPut32(&raw[12], (uint32_t)histogram->digits);
+    AHR_BenchHistogramPut64(&raw[16], 1U);
+    AHR_BenchHistogramPut64(&raw[24], (uint64_t)histogram->highest);
+    AHR_BenchHistogramPut64(&raw[32], ratio_bits);
+
+    if(Z_OK != compress2(&compressed[8], &ncompressed, raw, (uLong)n, 4))
+    {
+        goto end;
+    }
+    AHR_BenchHistogramPut32(&compressed[0], AHR_HISTOGRAM_COMPRESSION_COOKIE);
+    AHR_BenchHistogramPut32(&compressed[4], (uint32_t)ncompressed);
+    ok = fprintf(
+        log,
+        "%s%s%s%.3f,%.3f,%.3f,",
+        tag ? "Tag=" : "",
+        tag ? tag : "",
+        tag ? "," : "",
+        start,
+        length,
+        (double)histogram->max / 1e6
+    ) > 0;
+    ok = ok && AHR_BenchHistogramBase64(log, compressed, 8U + (size_t)ncompressed) && EOF != fputc('\n', log);
+
+    end:
+    free(compressed);
+    free(raw);
+    return ok;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static size_t AHR_BenchHistogramIndex(const AHR_BenchHistogram_t histogram, int64_t value)
+{
+    //
+    // The Bucket is the Power of two above the Value, relative to the Size of the first Bucket.
+    // The lowest discernible Value is 1, so the Unit Magnitude is 0.
+    //
+    const int pow2_ceiling = 64 - __builtin_clzll((unsigned long long)(value | histogram->sub_bucket_mask));
+    const int bucket = pow2_ceiling - (histogram->sub_bucket_half_count_magnitude + 1);
+    const int64_t sub_bucket = value >> bucket;
+    const int64_t base = (int64_t)(bucket + 1) << histogram->sub_bucket_half_count_magnitude;
+    return (size_t)(base + sub_bucket - histogram->sub_bucket_half_count);
+}
+
+static int64_t AHR_BenchHistogramValueAt(const AHR_BenchHistogram_t histogram, size_t index)
+{
+    int bucket = (int)(index >> histogram->sub_bucket_half_count_magnitude) - 1;
+    int64_t sub_bucket = (int64_t)(index & (size_t)(histogram->sub_bucket_half_count - 1)) + histogram->sub_bucket_half_count;
+    if(bucket < 0)
+    {
+        sub_bucket -= histogram->sub_bucket_half_count;
+        bucket = 0;
+    }
+    return sub_bucket << bucket;
+}
+
+static size_t AHR_BenchHistogramVarint(uint8_t *buffer, int64_t value)
+{
+    uint64_t v = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    for(size_t i=0;i<AHR_HISTOGRAM_MAX_VARINT_BYTES - 1U;++i)
+    {
+        if(0U == (v >> 7))
+        {
+            buffer[i] = (uint8_t)v;
+            return i + 1U;
+        }
+        buffer[i] = (uint8_t)((v & 0x7FU) | 0x80U);
+        v >>= 7;
+    }
+    buffer[AHR_HISTOGRAM_MAX_VARINT_BYTES - 1U] = (uint8_t)v;
+    return AHR_HISTOGRAM_MAX_VARINT_BYTES;
+}
+
+static void AHR_BenchHistogramPut32(uint8_t *buffer, uint32_t value)
+{
+    for(size_t i=0;i<4U;++i)
+    {
+        buffer[i] = (uint8_t)(value >> (24U - 8U * i));
+    }
+}
+
+static void AHR_BenchHistogramPut64(uint8_t *buffer, uint64_t value)
+{
+    AHR_BenchHistogramPut32(&buffer[0], (uint32_t)(value >> 32));
+    AHR_BenchHistogramPut32(&buffer[4], (uint32_t)value);
+}
+
+static bool AHR_BenchHistogramBase64(FILE *log, const uint8_t *data, size_t nbytes)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"; // flawfinder: ignore
+    for(size_t i=0;i<nbytes;i+=3U)
+    {
+        const uint32_t b = ((uint32_t)data[i] << 16)
+            | (i + 1U < nbytes ? (uint32_t)data[i + 1U] << 8 : 0U)
+            | (i + 2U < nbytes ? (uint32_t)data[i + 2U] : 0U);
+        const char quad[4] = {
+            alphabet[(b >> 18) & 0x3FU],
+            alphabet[(b >> 12) & 0x3FU],
+            i + 1U < nbytes ? alphabet[(b >> 6) & 0x3FU] : '=',
+            i + 2U < nbytes ? alphabet[b & 0x3FU] : '='
+        };
+        if(4U != fwrite(quad, 1, 4, log))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,456 @@
+///
+/// \brief  Loopback Benchmark of the JSON Index built on the Receive Path.
+///         The same JSON Body is fetched repeatedly and one Field of its last Record is looked up:
+///             none    - the Body is only received, the Baseline.
+///             after   - the Consumer indexes the delivered Body in on_success, like a Parser after Delivery would.
+///             inline  - the Processor indexes the Body while it arrives (AHR_JSON_INDEX_ON),
+///                       on_success only walks the finished Index.
+///         Reports the Latency until the Field is known and the Time spent in on_success.
+///         The Indexer alone is measured in Memory as well.
+///         Buffered Bodies are limited to the largest Buffer Pool Class (256 KiB), "--size" has to stay below it.
+///
+/// \example    ahr_bench_json --size 200000 --requests 200
+///
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <ahr_bench_server.h>
+#include <async_http_requests/ahr_http_request_processor.h>
+#include <async_http_requests/ahr_json.h>
+#include <async_http_requests/private/ahr_json_index.h>
+#include <async_http_requests/private/ahr_logging.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+typedef enum
+{
+    AHR_BENCH_JSON_NONE,
+    AHR_BENCH_JSON_AFTER,
+    AHR_BENCH_JSON_INLINE
+} AHR_BenchJsonMode_t;
+
+typedef struct
+{
+    size_t size;
+    size_t requests;
+    double mbps;
+    uint16_t port;
+} AHR_BenchArgs_t;
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool done;
+    bool failed;
+    AHR_BenchJsonMode_t mode;
+    AHR_Processor_t processor;
+    AHR_JsonIndexer_t indexer;
+    ///
+    /// \brief  Id of the last Record and Time spent in on_success.
+    ///
+    int64_t id;
+    double callback;
+} AHR_BenchWait_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_BenchParseArgs(int argc, char **argv, AHR_BenchArgs_t *args);
+///
+/// \brief  Deterministic JSON Object with an Array of nested Records, at least "size" Bytes.
+///
+static char* AHR_BenchMakeJson(size_t size, size_t *nbytes, size_t *nrecords);
+static void AHR_BenchIndexInMemory(const char *json, size_t nbytes, size_t rounds);
+static bool AHR_BenchRun(const char *label, AHR_BenchJsonMode_t mode, const AHR_BenchArgs_t *args, uint16_t port, size_t nrecords);
+///
+/// \brief  Id of the last Record, -1 if it can not be found.
+///
+static int64_t AHR_BenchLastId(const AHR_JsonIndex_t *index);
+
+static void AHR_BenchOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes);
+static void AHR_BenchOnError(void *user_data, size_t object, size_t error_code);
+static void AHR_BenchFinish(AHR_BenchWait_t *wait, bool failed);
+
+static void AHR_BenchLogNothing(void *arg, const char *str);
+static void AHR_BenchLogError(void *arg, const char *str);
+static int AHR_BenchCompare(const void *a, const void *b);
+static double AHR_BenchNow(void);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+int main(int argc, char **argv)
+{
+    AHR_BenchArgs_t args = {.size = 200000U, .requests = 200U, .mbps = 0.0, .port = 0U};
+    if(!AHR_BenchParseArgs(argc, argv, &args))
+    {
+        fprintf(stderr, "usage: %s [--size BYTES] [--requests N] [--mbps MBIT_PER_S] [--port PORT]\n", argv[0]);
+        return 2;
+    }
+
+    size_t nbytes = 0;
+    size_t nrecords = 0;
+    char *json = AHR_BenchMakeJson(args.size, &nbytes, &nrecords);
+    if(!json)
+    {
+        fprintf(stderr, "unable to create the body\n");
+        return 1;
+    }
+    const AHR_BenchContent_t content = {
+        .body = json,
+        .nbytes = nbytes,
+        .gzip_body = NULL,
+        .gzip_nbytes = 0,
+        .content_type = "application/json",
+        .link_mbps = args.mbps
+    };
+    AHR_BenchServer_t server = AHR_BenchServerStart(args.port, &content);
+    if(!server)
+    {
+        perror("unable to start the server");
+        free(json);
+        return 1;
+    }
+    printf(
+        "body %zu bytes, %zu records, link %s%.0f Mbit/s, %zu requests\n",
+        nbytes,
+        nrecords,
+        args.mbps > 0.0 ? "" : "unlimited ",
+        args.mbps,
+        args.requests
+    );
+    AHR_BenchIndexInMemory(json, nbytes, 20U);
+    const bool ok = AHR_BenchRun("none", AHR_BENCH_JSON_NONE, &args, AHR_BenchServerPort(server), nrecords)
+        && AHR_BenchRun("after", AHR_BENCH_JSON_AFTER, &args, AHR_BenchServerPort(server), nrecords)
+        && AHR_BenchRun("inline", AHR_BENCH_JSON_INLINE, &args, AHR_BenchServerPort(server), nrecords);
+    AHR_BenchServerStop(&server);
+    free(json);
+    return ok ? 0 : 1;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_BenchParseArgs(int argc, char **argv, AHR_BenchArgs_t *args)
+{
+    for(int i=1;i<argc;++i)
+    {
+        if(i + 1 >= argc)
+        {
+            return false;
+        }
+        const char *value = argv[++i];
+        if(0 == strcmp(argv[i - 1], "--size"))
+        {
+            args->size = strtoull(value, NULL, 10);
+        }
+        else if(0 == strcmp(argv[i - 1], "--requests"))
+        {
+            args->requests = strtoull(value, NULL, 10);
+        }
+        else if(0 == strcmp(argv[i - 1], "--mbps"))
+        {
+            args->mbps = strtod(value, NULL);
+        }
+        else if(0 == strcmp(argv[i - 1], "--port"))
+        {
+            args->port = (uint16_t)strtoul(value, NULL, 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return args->size > 0 && args->requests > 0;
+}
+
+static char* AHR_BenchMakeJson(size_t size, size_t *nbytes, size_t *nrecords)
+{
+    const size_t capacity = size + 1024U;
+    char *json = malloc(capacity);
+    if(!json)
+    {
+        return NULL;
+    }
+    size_t n = (size_t)snprintf(json, capacity, "{\"version\":3,\"next\":null,\"items\":[");
+    size_t i = 0;
+    for(;n < size;++i)
+    {
+        const int written = snprintf(
+            &json[n],
+            capacity - n,
+            "%s{\"id\":%zu,\"name\":\"user-%zu\",\"bio\":\"likes \\\"quotes\\\" and \\\\ slashes \\u00e9\","
+            "\"active\":%s,\"score\":%zu.%02zu,\"geo\":{\"lat\":%zu.%04zu,\"lon\":-%zu.%04zu},"
+            "\"tags\":[\"alpha\",\"beta\",\"group-%zu\"]}",
+            i > 0 ? "," : "",
+            i,
+            i,
+            (i % 3U) ? "true" : "false",
+            (i * 7919U) % 1000U,
+            (i * 31U) % 100U,
+            i % 90U,
+            (i * 17U) % 10000U,
+            i % 180U,
+            (i * 13U) % 10000U,
+            i % 16U
+        );
+        if(written < 0 || (size_t)written >= capacity - n - 2U)
+        {
+            break;
+        }
+        n += (size_t)written;
+    }
+    json[n++] = ']';
+    json[n++] = '}';
+    *nbytes = n;
+    *nrecords = i;
+    return json;
+}
+
+static void AHR_BenchIndexInMemory(const char *json, size_t nbytes, size_t rounds)
+{
+    AHR_JsonIndexer_t indexer = AHR_CreateJsonIndexer();
+    double stage1 = 0.0;
+    double total = 0.0;
+    size_t ntokens = 0;
+    for(size_t i=0;i<rounds;++i)
+    {
+        AHR_JsonIndexerReset(&indexer);
+        const double begin = AHR_BenchNow();
+        AHR_JsonIndexerFeed(&indexer, json, nbytes);
+        const double fed = AHR_BenchNow();
+        AHR_JsonIndexerFinish(&indexer, json, nbytes);
+        const double end = AHR_BenchNow();
+        stage1 += fed - begin;
+        total += end - begin;
+        ntokens = indexer.ntokens;
+    }
+    printf(
+        "in memory: stage 1 %8.1f MB/s, stage 1+2 %8.1f MB/s, %zu tokens, valid %d\n",
+        ((double)nbytes * (double)rounds / stage1) / 1e6,
+        ((double)nbytes * (double)rounds / total) / 1e6,
+        ntokens,
+        (int)indexer.valid
+    );
+    AHR_DestroyJsonIndexer(&indexer);
+}
+
+static bool AHR_BenchRun(const char *label, AHR_BenchJsonMode_t mode, const AHR_BenchArgs_t *args, uint16_t port, size_t nrecords)
+{
+    AHR_Logger_t logger = AHR_CreateLogger(NULL, AHR_BenchLogNothing, AHR_BenchLogNothing, AHR_BenchLogError);
+    const AHR_ProcessorOptions_t options = {
+        .max_objects = 1,
+        .json_index = AHR_BENCH_JSON_INLINE == mode ? AHR_JSON_INDEX_ON : AHR_JSON_INDEX_OFF
+    };
+    AHR_Processor_t processor = AHR_CreateProcessorWithOptions(&options, logger);
+    double *latencies = calloc(args->requests, sizeof(double));
+    double *callbacks = calloc(args->requests, sizeof(double));
+    bool ok = false;
+    if(!logger || !processor || !latencies || !callbacks || !AHR_ProcessorStart(processor))
+    {
+        fprintf(stderr, "%s: unable to set up the processor\n", label);
+        goto end;
+    }
+
+    char url[64]; // flawfinder: ignore
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/data.json", (unsigned int)port);
+    AHR_RequestData_t request_data;
+    memset(&request_data, 0, sizeof(request_data));
+    request_data.url = url;
+    AHR_BenchWait_t wait = {
+        .done = false,
+        .failed = false,
+        .mode = mode,
+        .processor = processor,
+        .indexer = AHR_CreateJsonIndexer(),
+        .id = -1,
+        .callback = 0.0
+    };
+    pthread_mutex_init(&wait.mutex, NULL);
+    pthread_cond_init(&wait.cond, NULL);
+    const AHR_UserData_t user_data = {
+        .data = &wait,
+        .on_success = AHR_BenchOnSuccess,
+        .on_error = AHR_BenchOnError,
+        .on_data = NULL,
+        .on_complete = NULL
+    };
+
+    size_t completed = 0;
+    for(;completed<args->requests;++completed)
+    {
+        wait.done = false;
+        wait.id = -1;
+        const double begin = AHR_BenchNow();
+        AHR_ProcessorStatus_t status = AHR_PROC_OBJECT_BUSY;
+        while(AHR_PROC_OBJECT_BUSY == status)
+        {
+            status = AHR_ProcessorGet(processor, 0, &request_data, user_data);
+            if(AHR_PROC_OBJECT_BUSY == status)
+            {
+                sched_yield();
+            }
+        }
+        if(AHR_PROC_OK != status || AHR_PROC_OK != AHR_ProcessorMakeRequest(processor, 0))
+        {
+            fprintf(stderr, "%s: unable to make request %zu\n", label, completed);
+            break;
+        }
+        pthread_mutex_lock(&wait.mutex);
+        while(!wait.done)
+        {
+            pthread_cond_wait(&wait.cond, &wait.mutex);
+        }
+        pthread_mutex_unlock(&wait.mutex);
+        latencies[completed] = AHR_BenchNow() - begin;
+        callbacks[completed] = wait.callback;
+        const int64_t expected = AHR_BENCH_JSON_NONE == mode ? -1 : (int64_t)nrecords - 1;
+        if(wait.failed || wait.id != expected)
+        {
+            fprintf(stderr, "%s: request %zu failed, id %lld\n", label, completed, (long long)wait.id);
+            break;
+        }
+    }
+    ok = completed == args->requests;
+
+    if(completed > 0)
+    {
+        qsort(latencies, completed, sizeof(double), AHR_BenchCompare);
+        qsort(callbacks, completed, sizeof(double), AHR_BenchCompare);
+        printf(
+            "%-8s latency p50 %8.3f ms  p99 %8.3f ms   on_success p50 %8.3f ms  p99 %8.3f ms\n",
+            label,
+            1e3 * latencies[completed / 2U],
+            1e3 * latencies[(completed * 99U) / 100U],
+            1e3 * callbacks[completed / 2U],
+            1e3 * callbacks[(completed * 99U) / 100U]
+        );
+    }
+    AHR_ProcessorStop(processor);
+    AHR_DestroyJsonIndexer(&wait.indexer);
+    pthread_cond_destroy(&wait.cond);
+    pthread_mutex_destroy(&wait.mutex);
+
+    end:
+    if(processor)
+    {
+        AHR_DestroyProcessor(&processor);
+    }
+    if(logger)
+    {
+        AHR_DestroyLogger(&logger);
+    }
+    free(callbacks);
+    free(latencies);
+    return ok;
+}
+
+static int64_t AHR_BenchLastId(const AHR_JsonIndex_t *index)
+{
+    const size_t items = AHR_JsonObjectFind(index, 0, "items");
+    if(AHR_JSON_NPOS == items)
+    {
+        return -1;
+    }
+    const size_t last = AHR_JsonArrayAt(index, items, index->tokens[items].count - 1U);
+    int64_t id = -1;
+    if(!AHR_JsonInt64(index, AHR_JsonObjectFind(index, last, "id"), &id))
+    {
+        return -1;
+    }
+    return id;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_BenchOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes)
+{
+    AHR_BenchWait_t *wait = (AHR_BenchWait_t*)user_data;
+    const double begin = AHR_BenchNow();
+    AHR_JsonIndex_t index;
+    switch(wait->mode)
+    {
+        case AHR_BENCH_JSON_AFTER:
+            AHR_JsonIndexerReset(&wait->indexer);
+            if(AHR_JsonIndexerFinish(&wait->indexer, buffer, nbytes))
+            {
+                AHR_JsonIndexerView(&wait->indexer, buffer, nbytes, &index);
+                wait->id = AHR_BenchLastId(&index);
+            }
+            break;
+        case AHR_BENCH_JSON_INLINE:
+            if(AHR_ProcessorResponseJson(wait->processor, object, &index))
+            {
+                wait->id = AHR_BenchLastId(&index);
+            }
+            break;
+        case AHR_BENCH_JSON_NONE:
+        default:
+            break;
+    }
+    wait->callback = AHR_BenchNow() - begin;
+    AHR_BenchFinish(wait, 200U != status_code);
+}
+
+static void AHR_BenchOnError(void *user_data, size_t object, size_t error_code)
+{
+    (void)object;
+    fprintf(stderr, "transfer error %zu\n", error_code);
+    AHR_BenchFinish((AHR_BenchWait_t*)user_data, true);
+}
+
+static void AHR_BenchFinish(AHR_BenchWait_t *wait, bool failed)
+{
+    pthread_mutex_lock(&wait->mutex);
+    wait->failed = failed;
+    wait->done = true;
+    pthread_cond_signal(&wait->cond);
+    pthread_mutex_unlock(&wait->mutex);
+}
+
+static void AHR_BenchLogNothing(void *arg, const char *str)
+{
+    (void)arg;
+    (void)str;
+}
+
+static void AHR_BenchLogError(void *arg, const char *str)
+{
+    (void)arg;
+    fprintf(stderr, "%s\n", str);
+}
+
+static int AHR_BenchCompare(const void *a, const void *b)
+{
+    const double x = *(const double*)a;
+    const double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double AHR_BenchNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
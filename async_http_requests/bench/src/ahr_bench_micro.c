@@ -0,0 +1,599 @@
+///
+/// \brief  Microbenchmarks of the internal Data Structures and Parsers of libahr.
+///         The Translation Units which keep their Helpers static are included below, so the Helpers are
+///         measured as they are compiled into the Library. The other Sources of libahr are linked in directly.
+///
+///         Each Benchmark runs "--iterations" Operations five Times and reports the fastest Run:
+///             stack_push_pop          - AHR_StackPush() followed by AHR_StackPop().
+///             request_list_find       - AHR_RequestListFind() of every Element in turn, Parameter is the Length.
+///             request_list_remove_add - AHR_RequestListRemove() of an Element and AHR_RequestListAdd() of it.
+///             easy_list_find          - AHR_CurlEasyHandleListFindEasyHandle(), like request_list_find.
+///             easy_list_remove_append - AHR_CurlEasyHandleListRemoveEasyHandle() and ...AppendEasyHandle().
+///             header_callback         - AHR_HeaderCallback() of a Header Block, Parameter is the Number of Lines.
+///             write_callback          - AHR_WriteCallback() Appends, Parameter is the Chunk Size. The Body is
+///                                       reset with AHR_ResponseReset() whenever it is full.
+///             response_reset          - AHR_ResponseReset() of a Response which received a Header Block.
+///             mutex_lock              - AHR_MutexLock() / AHR_MutexUnlock() around an Increment,
+///                                       Parameter is the Number of Threads which contend for the Mutex.
+///
+///         Hardware Counters (Cycles, Instructions, Cache Misses, Branch Misses) are read through
+///         perf_event_open() for User Space only, they are left out if the Kernel does not permit it
+///         (f.e. kernel.perf_event_paranoid > 2 or inside a Container without CAP_PERFMON).
+///
+/// \example    ahr_bench_micro --iterations 200000
+///
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include "../../async_http_requests/src/ahr_http_request_processor.c"
+#include "../../async_http_requests/src/external/src/ahr_curl.c"
+#include "../../async_http_requests/src/private/src/ahr_async_http_requests.c"
+
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_MICRO_COUNTERS 4U
+#define AHR_MICRO_RUNS 5U
+#define AHR_MICRO_MAX_ELEMENTS 64U
+#define AHR_MICRO_MAX_THREADS 8U
+
+typedef struct
+{
+    ///
+    /// \brief  -1 for each Counter which could not be opened.
+    ///
+    int fds[AHR_MICRO_COUNTERS];
+    bool available;
+    ///
+    /// \brief  errno of the first Counter which could not be opened.
+    ///
+    int error;
+} AHR_MicroCounters_t;
+
+typedef struct
+{
+    double ns;
+    uint64_t counts[AHR_MICRO_COUNTERS];
+} AHR_MicroSample_t;
+
+///
+/// \brief  Everything the Benchmarks work on, created once.
+///
+typedef struct
+{
+    AHR_Stack_t stack;
+    AHR_HttpRequest_t requests[AHR_MICRO_MAX_ELEMENTS];
+    AHR_Result_t results[AHR_MICRO_MAX_ELEMENTS];
+    AHR_HttpResponse_t response;
+    char *chunk;
+    AHR_Mutex_t mutex;
+    ///
+    /// \brief  Parameter of the current Run.
+    ///
+    size_t param;
+    ///
+    /// \brief  Incremented under the Mutex.
+    ///
+    uint64_t counter;
+} AHR_MicroState_t;
+
+typedef void (*AHR_MicroFunction_t)(AHR_MicroState_t *state, size_t iterations);
+
+typedef struct
+{
+    AHR_MicroState_t *state;
+    size_t iterations;
+} AHR_MicroThread_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+///
+/// \brief  A realistic Response Header Block, one Line per Entry as curl delivers it.
+///
+static const char * const AHR_MICRO_HEADER_LINES[] = {
+    "HTTP/1.1 200 OK\r\n",
+    "Date: Mon, 19 Oct 2026 10:21:07 GMT\r\n",
+    "Content-Type: application/json; charset=utf-8\r\n",
+    "Content-Length: 18342\r\n",
+    "Connection: keep-alive\r\n",
+    "Cache-Control: private, max-age=0, no-cache\r\n",
+    "ETag: W/\"47a6-nIq0HXLvnqH3gW6kT0Ns2sQ8cEo\"\r\n",
+    "Vary: Accept-Encoding, Origin\r\n",
+    "Server: nginx/1.25.3\r\n",
+    "X-Request-Id: 5f2c6c1e-8a0b-4d7e-9c43-0b8d2a6f1e77\r\n",
+    "Strict-Transport-Security: max-age=63072000; includeSubDomains; preload\r\n",
+    "Set-Cookie: session=9f8e7d6c5b4a; Path=/; HttpOnly; Secure; SameSite=Lax\r\n",
+    "Access-Control-Allow-Origin: *\r\n",
+    "\r\n"
+};
+#define AHR_MICRO_NHEADER_LINES (sizeof(AHR_MICRO_HEADER_LINES) / sizeof(AHR_MICRO_HEADER_LINES[0]))
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_MicroCreateState(AHR_MicroState_t *state);
+static void AHR_MicroDestroyState(AHR_MicroState_t *state);
+///
+/// \brief  Run "function" AHR_MICRO_RUNS Times and print the fastest Run per Operation.
+///
+static void AHR_MicroMeasure(
+    const char *name,
+    AHR_MicroFunction_t function,
+    AHR_MicroState_t *state,
+    size_t param,
+    size_t iterations,
+    AHR_MicroCounters_t *counters
+);
+
+static void AHR_MicroStack(AHR_MicroState_t *state, size_t iterations);
+static void AHR_MicroRequestListFind(AHR_MicroState_t *state, size_t iterations);
+static void AHR_MicroRequestListRemoveAdd(AHR_MicroState_t *state, size_t iterations);
+static void AHR_MicroEasyListFind(AHR_MicroState_t *state, size_t iterations);
+static void AHR_MicroEasyListRemoveAppend(AHR_MicroState_t *state, size_t iterations);
+static void AHR_MicroHeaderCallback(AHR_MicroState_t *state, size_t iterations);
+static void AHR_MicroWriteCallback(AHR_MicroState_t *state, size_t iterations);
+static void AHR_MicroResponseReset(AHR_MicroState_t *state, size_t iterations);
+static void AHR_MicroMutex(AHR_MicroState_t *state, size_t iterations);
+static void* AHR_MicroMutexThread(void *arg);
+///
+/// \brief  List of the first "n" Results / Easy Handles, released with the matching Free.
+///
+static AHR_RequestList AHR_MicroRequestList(AHR_MicroState_t *state, size_t n);
+static void AHR_MicroFreeRequestList(AHR_RequestList *list);
+static struct AHR_CurlEasyHandleList* AHR_MicroEasyList(AHR_MicroState_t *state, size_t n);
+///
+/// \brief  Open the Counters with "inherit", so the Threads of the Mutex Benchmark are counted as well.
+///
+static void AHR_MicroOpenCounters(AHR_MicroCounters_t *counters);
+static void AHR_MicroCloseCounters(AHR_MicroCounters_t *counters);
+///
+/// \brief  Counts of exited Threads are added to the Counter and survive PERF_EVENT_IOC_RESET,
+///         so a Run is the Difference between the Values read when it starts and when it stops.
+///
+static void AHR_MicroReadCounters(const AHR_MicroCounters_t *counters, uint64_t *counts);
+static double AHR_MicroNow(void);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+int main(int argc, char **argv)
+{
+    size_t iterations = 100000U;
+    for(int i=1;i<argc;++i)
+    {
+        if(0 == strcmp(argv[i], "--iterations") && i + 1 < argc)
+        {
+            iterations = strtoull(argv[++i], NULL, 10);
+        }
+        else
+        {
+            iterations = 0;
+            break;
+        }
+    }
+    if(0 == iterations)
+    {
+        fprintf(stderr, "usage: %s [--iterations N]\n", argv[0]);
+        return 2;
+    }
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    AHR_MicroState_t state;
+    if(!AHR_MicroCreateState(&state))
+    {
+        fprintf(stderr, "unable to set up the benchmarks\n");
+        AHR_MicroDestroyState(&state);
+        curl_global_cleanup();
+        return 1;
+    }
+    AHR_MicroCounters_t counters;
+    AHR_MicroOpenCounters(&counters);
+    printf(
+        "hardware counters %s%s%s, %zu iterations, best of %u runs\n",
+        counters.available ? "on" : "off",
+        0 != counters.error ? ", perf_event_open: " : "",
+        0 != counters.error ? strerror(counters.error) : "",
+        iterations,
+        AHR_MICRO_RUNS
+    );
+    printf(
+        "%-24s %6s %10s %10s %10s %10s %10s\n",
+        "benchmark", "param", "ns/op", "cycles/op", "instr/op", "cmiss/op", "bmiss/op"
+    );
+
+    static const size_t lengths[] = {1U, 8U, 25U, 64U};
+    static const size_t chunks[] = {256U, 16384U};
+    static const size_t threads[] = {1U, 2U, 4U, AHR_MICRO_MAX_THREADS};
+    AHR_MicroMeasure("stack_push_pop", AHR_MicroStack, &state, 0, iterations, &counters);
+    for(size_t i=0;i<sizeof(lengths) / sizeof(lengths[0]);++i)
+    {
+        AHR_MicroMeasure("request_list_find", AHR_MicroRequestListFind, &state, lengths[i], iterations, &counters);
+    }
+    for(size_t i=0;i<sizeof(lengths) / sizeof(lengths[0]);++i)
+    {
+        AHR_MicroMeasure("request_list_remove_add", AHR_MicroRequestListRemoveAdd, &state, lengths[i], iterations, &counters);
+    }
+    for(size_t i=0;i<sizeof(lengths) / sizeof(lengths[0]);++i)
+    {
+        AHR_MicroMeasure("easy_list_find", AHR_MicroEasyListFind, &state, lengths[i], iterations, &counters);
+    }
+    for(size_t i=0;i<sizeof(lengths) / sizeof(lengths[0]);++i)
+    {
+        AHR_MicroMeasure("easy_list_remove_append", AHR_MicroEasyListRemoveAppend, &state, lengths[i], iterations, &counters);
+    }
+    AHR_MicroMeasure("header_callback", AHR_MicroHeaderCallback, &state, AHR_MICRO_NHEADER_LINES, iterations, &counters);
+    for(size_t i=0;i<sizeof(chunks) / sizeof(chunks[0]);++i)
+    {
+        AHR_MicroMeasure("write_callback", AHR_MicroWriteCallback, &state, chunks[i], iterations, &counters);
+    }
+    AHR_MicroMeasure("response_reset", AHR_MicroResponseReset, &state, 0, iterations, &counters);
+    for(size_t i=0;i<sizeof(threads) / sizeof(threads[0]);++i)
+    {
+        AHR_MicroMeasure("mutex_lock", AHR_MicroMutex, &state, threads[i], iterations, &counters);
+    }
+
+    AHR_MicroCloseCounters(&counters);
+    AHR_MicroDestroyState(&state);
+    curl_global_cleanup();
+    return 0;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_MicroCreateState(AHR_MicroState_t *state)
+{
+    memset(state, 0, sizeof(*state));
+    state->stack = AHR_CraeteStack(AHR_MICRO_MAX_ELEMENTS);
+    state->response = AHR_CreateResponse();
+    state->chunk = malloc(AHR_RESPONSE_BODY_SIZE);
+    state->mutex = AHR_CreateMutex();
+    if(!state->response || !state->chunk || !state->mutex)
+    {
+        return false;
+    }
+    memset(state->chunk, 'x', AHR_RESPONSE_BODY_SIZE);
+    for(size_t i=0;i<AHR_MICRO_MAX_ELEMENTS;++i)
+    {
+        state->requests[i] = AHR_CreateRequest();
+        if(!state->requests[i])
+        {
+            return false;
+        }
+        state->results[i].request = state->requests[i];
+        state->results[i].object = i;
+    }
+    return true;
+}
+
+static void AHR_MicroDestroyState(AHR_MicroState_t *state)
+{
+    for(size_t i=0;i<AHR_MICRO_MAX_ELEMENTS;++i)
+    {
+        if(state->requests[i])
+        {
+            AHR_DestroyRequest(&state->requests[i]);
+        }
+    }
+    if(state->mutex)
+    {
+        AHR_DestroyMutex(&state->mutex);
+    }
+    if(state->response)
+    {
+        AHR_DestroyResponse(&state->response);
+    }
+    AHR_DestroyStack(&state->stack);
+    free(state->chunk);
+}
+
+static void AHR_MicroMeasure(
+    const char *name,
+    AHR_MicroFunction_t function,
+    AHR_MicroState_t *state,
+    size_t param,
+    size_t iterations,
+    AHR_MicroCounters_t *counters
+)
+{
+    state->param = param;
+    //
+    // Warm up Caches and Branch Predictors.
+    //
+    function(state, iterations / 10U + 1U);
+    AHR_MicroSample_t best = {.ns = 0.0};
+    for(unsigned int run=0;run<AHR_MICRO_RUNS;++run)
+    {
+        AHR_MicroSample_t sample;
+        uint64_t start[AHR_MICRO_COUNTERS];
+        AHR_MicroReadCounters(counters, start);
+        const double begin = AHR_MicroNow();
+        function(state, iterations);
+        sample.ns = (AHR_MicroNow() - begin) / (double)iterations;
+        AHR_MicroReadCounters(counters, sample.counts);
+        for(size_t i=0;i<AHR_MICRO_COUNTERS;++i)
+        {
+            sample.counts[i] -= start[i];
+        }
+        if(0U == run || sample.ns < best.ns)
+        {
+            best = sample;
+        }
+    }
+    printf("%-24s %6zu %10.1f", name, param, best.ns);
+    for(size_t i=0;i<AHR_MICRO_COUNTERS;++i)
+    {
+        if(counters->fds[i] >= 0)
+        {
+            printf(" %10.2f", (double)best.counts[i] / (double)iterations);
+        }
+        else
+        {
+            printf(" %10s", "-");
+        }
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_MicroStack(AHR_MicroState_t *state, size_t iterations)
+{
+    for(size_t i=0;i<iterations;++i)
+    {
+        AHR_StackPush(&state->stack, &state->results[i % AHR_MICRO_MAX_ELEMENTS]);
+        void *top = AHR_StackPop(&state->stack);
+        __asm__ volatile("" : : "r"(top) : "memory");
+    }
+}
+
+static void AHR_MicroRequestListFind(AHR_MicroState_t *state, size_t iterations)
+{
+    const size_t n = state->param;
+    AHR_RequestList list = AHR_MicroRequestList(state, n);
+    for(size_t i=0;i<iterations;++i)
+    {
+        void *handle = AHR_CurlGetHandle(AHR_RequestHandle(state->requests[i % n]));
+        AHR_Result_t *found = AHR_RequestListFind(&list, handle);
+        __asm__ volatile("" : : "r"(found) : "memory");
+    }
+    AHR_MicroFreeRequestList(&list);
+}
+
+static void AHR_MicroRequestListRemoveAdd(AHR_MicroState_t *state, size_t iterations)
+{
+    const size_t n = state->param;
+    AHR_RequestList list = AHR_MicroRequestList(state, n);
+    for(size_t i=0;i<iterations;++i)
+    {
+        AHR_Result_t *result = &state->results[i % n];
+        AHR_RequestListRemove(&list, AHR_CurlGetHandle(AHR_RequestHandle(result->request)));
+        AHR_RequestListAdd(&list, result);
+    }
+    AHR_MicroFreeRequestList(&list);
+}
+
+static void AHR_MicroEasyListFind(AHR_MicroState_t *state, size_t iterations)
+{
+    const size_t n = state->param;
+    struct AHR_CurlEasyHandleList *list = AHR_MicroEasyList(state, n);
+    for(size_t i=0;i<iterations;++i)
+    {
+        AHR_Curl_t found = AHR_CurlEasyHandleListFindEasyHandle(
+            list,
+            AHR_CurlGetHandle(AHR_RequestHandle(state->requests[i % n]))
+        );
+        __asm__ volatile("" : : "r"(found) : "memory");
+    }
+    AHR_CurlEasyHandleListRemoveAll(list);
+}
+
+static void AHR_MicroEasyListRemoveAppend(AHR_MicroState_t *state, size_t iterations)
+{
+    const size_t n = state->param;
+    struct AHR_CurlEasyHandleList *list = AHR_MicroEasyList(state, n);
+    for(size_t i=0;i<iterations;++i)
+    {
+        AHR_Curl_t handle = AHR_RequestHandle(state->requests[i % n]);
+        list = AHR_CurlEasyHandleListRemoveEasyHandle(list, handle);
+        list = AHR_CurlEasyHandleListAppendEasyHandle(list, handle);
+    }
+    AHR_CurlEasyHandleListRemoveAll(list);
+}
+
+static void AHR_MicroHeaderCallback(AHR_MicroState_t *state, size_t iterations)
+{
+    //
+    // curl hands out writable Lines, the Parser works on a Copy like it would on curls Buffer.
+    //
+    char lines[AHR_MICRO_NHEADER_LINES][96]; // flawfinder: ignore
+    size_t lengths[AHR_MICRO_NHEADER_LINES];
+    for(size_t i=0;i<AHR_MICRO_NHEADER_LINES;++i)
+    {
+        lengths[i] = strlen(AHR_MICRO_HEADER_LINES[i]); // flawfinder: ignore
+        memcpy(lines[i], AHR_MICRO_HEADER_LINES[i], lengths[i]); // flawfinder: ignore
+    }
+    for(size_t i=0;i<iterations;++i)
+    {
+        for(size_t j=0;j<AHR_MICRO_NHEADER_LINES;++j)
+        {
+            AHR_HeaderCallback(lines[j], 1, lengths[j], state->response);
+        }
+    }
+}
+
+static void AHR_MicroWriteCallback(AHR_MicroState_t *state, size_t iterations)
+{
+    const size_t chunk = state->param;
+    AHR_ResponseReset(state->response);
+    for(size_t i=0;i<iterations;++i)
+    {
+        if(AHR_ResponseBodyLength(state->response) + chunk >= AHR_RESPONSE_BODY_SIZE)
+        {
+            AHR_ResponseReset(state->response);
+        }
+        AHR_WriteCallback(state->chunk, 1, chunk, state->response);
+    }
+}
+
+static void AHR_MicroResponseReset(AHR_MicroState_t *state, size_t iterations)
+{
+    for(size_t j=0;j<AHR_MICRO_NHEADER_LINES;++j)
+    {
+        char line[96]; // flawfinder: ignore
+        const size_t n = strlen(AHR_MICRO_HEADER_LINES[j]); // flawfinder: ignore
+        memcpy(line, AHR_MICRO_HEADER_LINES[j], n); // flawfinder: ignore
+        AHR_HeaderCallback(line, 1, n, state->response);
+    }
+    for(size_t i=0;i<iterations;++i)
+    {
+        AHR_ResponseReset(state->response);
+    }
+}
+
+static void AHR_MicroMutex(AHR_MicroState_t *state, size_t iterations)
+{
+    const size_t nthreads = state->param;
+    pthread_t threads[AHR_MICRO_MAX_THREADS];
+    AHR_MicroThread_t args[AHR_MICRO_MAX_THREADS];
+    size_t started = 0;
+    for(;started<nthreads;++started)
+    {
+        args[started] = (AHR_MicroThread_t){
+            .state = state,
+            .iterations = iterations / nthreads + (started < iterations % nthreads ? 1U : 0U)
+        };
+        if(0 != pthread_create(&threads[started], NULL, AHR_MicroMutexThread, &args[started]))
+        {
+            break;
+        }
+    }
+    for(size_t i=0;i<started;++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+static void* AHR_MicroMutexThread(void *arg)
+{
+    const AHR_MicroThread_t *thread = (const AHR_MicroThread_t*)arg;
+    AHR_MicroState_t *state = thread->state;
+    for(size_t i=0;i<thread->iterations;++i)
+    {
+        AHR_MutexLock(state->mutex);
+        ++state->counter;
+        AHR_MutexUnlock(state->mutex);
+    }
+    return NULL;
+}
+
+static AHR_RequestList AHR_MicroRequestList(AHR_MicroState_t *state, size_t n)
+{
+    AHR_RequestList list = {.head = NULL};
+    for(size_t i=0;i<n;++i)
+    {
+        AHR_RequestListAdd(&list, &state->results[i]);
+    }
+    return list;
+}
+
+static void AHR_MicroFreeRequestList(AHR_RequestList *list)
+{
+    while(list->head)
+    {
+        struct AHR_RequestListNode *next = list->head->next;
+        free(list->head);
+        list->head = next;
+    }
+}
+
+static struct AHR_CurlEasyHandleList* AHR_MicroEasyList(AHR_MicroState_t *state, size_t n)
+{
+    struct AHR_CurlEasyHandleList *list = NULL;
+    for(size_t i=0;i<n;++i)
+    {
+        list = AHR_CurlEasyHandleListAppendEasyHandle(list, AHR_RequestHandle(state->requests[i]));
+    }
+    return list;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_MicroOpenCounters(AHR_MicroCounters_t *counters)
+{
+    static const uint64_t configs[AHR_MICRO_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+    counters->available = false;
+    counters->error = 0;
+    for(size_t i=0;i<AHR_MICRO_COUNTERS;++i)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        counters->fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0UL);
+        if(counters->fds[i] < 0 && 0 == counters->error)
+        {
+            counters->error = errno;
+        }
+        counters->available = counters->available || counters->fds[i] >= 0;
+    }
+}
+
+static void AHR_MicroCloseCounters(AHR_MicroCounters_t *counters)
+{
+    for(size_t i=0;i<AHR_MICRO_COUNTERS;++i)
+    {
+        if(counters->fds[i] >= 0)
+        {
+            close(counters->fds[i]);
+            counters->fds[i] = -1;
+        }
+    }
+}
+
+static void AHR_MicroReadCounters(const AHR_MicroCounters_t *counters, uint64_t *counts)
+{
+    for(size_t i=0;i<AHR_MICRO_COUNTERS;++i)
+    {
+        counts[i] = 0;
+        if(counters->fds[i] >= 0 && sizeof(counts[i]) != read(counters->fds[i], &counts[i], sizeof(counts[i]))) // flawfinder: ignore
+        {
+            counts[i] = 0;
+        }
+    }
+}
+
+static double AHR_MicroNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return 1e9 * (double)now.tv_sec + (double)now.tv_nsec;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
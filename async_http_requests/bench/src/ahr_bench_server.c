@@ -0,0 +1,537 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define _GNU_SOURCE
+
+#include <ahr_bench_server.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_BENCH_REQUEST_BYTES ((size_t)8192)
+#define AHR_BENCH_HEAD_BYTES ((size_t)256)
+///
+/// \brief  Bytes sent at once while the Link is emulated.
+///
+#define AHR_BENCH_PACE_SLICE ((size_t)16384)
+#define AHR_BENCH_MAX_EVENTS 64
+
+typedef struct AHR_BenchConnection
+{
+    struct AHR_BenchConnection *next;
+    int fd;
+    char request[AHR_BENCH_REQUEST_BYTES]; // flawfinder: ignore
+    size_t nrequest;
+    ///
+    /// \brief  Bytes of a Request Body which still have to be read and dropped.
+    ///
+    size_t discard;
+
+    char head[AHR_BENCH_HEAD_BYTES]; // flawfinder: ignore
+    size_t nhead;
+    const char *body;
+    size_t nbody;
+    size_t sent;
+    bool sending;
+    uint64_t next_send_ns;
+} AHR_BenchConnection_t;
+
+struct AHR_BenchServer
+{
+    const AHR_BenchContent_t *content;
+    int listen_fd;
+    int epoll_fd;
+    int wake_fd;
+    uint16_t port;
+    pthread_t thread;
+    atomic_bool stop;
+    atomic_ullong responses;
+    AHR_BenchConnection_t *connections;
+};
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void* AHR_BenchServerRun(void *arg);
+static void AHR_BenchServerAccept(AHR_BenchServer_t server);
+static void AHR_BenchServerClose(AHR_BenchServer_t server, AHR_BenchConnection_t *connection);
+///
+/// \brief  Read all available Bytes and answer complete Requests.
+/// \returns    false if the Connection was closed.
+///
+static bool AHR_BenchServerRead(AHR_BenchServer_t server, AHR_BenchConnection_t *connection);
+///
+/// \brief  Start the Response to the next complete Request in the Buffer, if there is one.
+///
+static void AHR_BenchServerNextRequest(AHR_BenchServer_t server, AHR_BenchConnection_t *connection);
+///
+/// \brief  Send as much of the current Response as the Socket and the emulated Link allow.
+/// \returns    false if the Connection was closed.
+///
+static bool AHR_BenchServerSend(AHR_BenchServer_t server, AHR_BenchConnection_t *connection);
+///
+/// \brief  Milliseconds until the next paced Send is due, -1 if none.
+///
+static int AHR_BenchServerTimeout(const AHR_BenchServer_t server);
+static uint64_t AHR_BenchNow(void);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+AHR_BenchServer_t AHR_BenchServerStart(uint16_t port, const AHR_BenchContent_t *content)
+{
+    assert(NULL != content);
+    AHR_BenchServer_t server = calloc(1, sizeof(struct AHR_BenchServer));
+    if(!server)
+    {
+        return NULL;
+    }
+    server->content = content;
+    server->epoll_fd = -1;
+    server->wake_fd = -1;
+    atomic_init(&server->stop, false);
+    atomic_init(&server->responses, 0);
+    server->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(server->listen_fd < 0)
+    {
+        goto on_error;
+    }
+    const int one = 1;
+    setsockopt(server->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in address = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr = {.s_addr = htonl(INADDR_LOOPBACK)}
+    };
+    socklen_t length = sizeof(address);
+    if(
+        0 != bind(server->listen_fd, (struct sockaddr*)&address, sizeof(address))
+        || 0 != listen(server->listen_fd, 1024)
+        || 0 != getsockname(server->listen_fd, (struct sockaddr*)&address, &length)
+    )
+    {
+        goto on_error;
+    }
+    server->port = ntohs(address.sin_port);
+
+    server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    server->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(server->epoll_fd < 0 || server->wake_fd < 0)
+    {
+        goto on_error;
+    }
+    //
+    // The Listening Socket is tagged with the Server, the Wake-Up Event with NULL.
+    //
+    struct epoll_event listen_event = {.events = EPOLLIN, .data = {.ptr = server}};
+    struct epoll_event wake_event = {.events = EPOLLIN, .data = {.ptr = NULL}};
+    if(
+        0 != epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_fd, &listen_event)
+        || 0 != epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->wake_fd, &wake_event)
+        || 0 != pthread_create(&server->thread, NULL, AHR_BenchServerRun, server)
+    )
+    {
+        goto on_error;
+    }
+    return server;
+
+    on_error:
+    if(server->listen_fd >= 0)
+    {
+        close(server->listen_fd);
+    }
+    if(server->epoll_fd >= 0)
+    {
+        close(server->epoll_fd);
+    }
+    if(server->wake_fd >= 0)
+    {
+        close(server->wake_fd);
+    }
+    free(server);
+    return NULL;
+}
+
+uint16_t AHR_BenchServerPort(const AHR_BenchServer_t server)
+{
+    return server->port;
+}
+
+uint64_t AHR_BenchServerResponses(const AHR_BenchServer_t server)
+{
+    return atomic_load(&server->responses);
+}
+
+double AHR_BenchServerCpuSeconds(const AHR_BenchServer_t server)
+{
+    clockid_t clock;
+    struct timespec used;
+    if(0 != pthread_getcpuclockid(server->thread, &clock) || 0 != clock_gettime(clock, &used))
+    {
+        return 0.0;
+    }
+    return (double)used.tv_sec + 1e-9 * (double)used.tv_nsec;
+}
+
+void AHR_BenchServerStop(AHR_BenchServer_t *server)
+{
+    assert(NULL != server && NULL != *server);
+    AHR_BenchServer_t s = *server;
+    atomic_store(&s->stop, true);
+    const uint64_t one = 1;
+    if(sizeof(one) != write(s->wake_fd, &one, sizeof(one)))
+    {
+        perror("AHR_BenchServerStop");
+    }
+    pthread_join(s->thread, NULL);
+    while(s->connections)
+    {
+        AHR_BenchServerClose(s, s->connections);
+    }
+    close(s->listen_fd);
+    close(s->epoll_fd);
+    close(s->wake_fd);
+    free(s);
+    *server = NULL;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void* AHR_BenchServerRun(void *arg)
+{
+    AHR_BenchServer_t server = (AHR_BenchServer_t)arg;
+    struct epoll_event events[AHR_BENCH_MAX_EVENTS];
+    while(!atomic_load(&server->stop))
+    {
+        const int n = epoll_wait(server->epoll_fd, events, AHR_BENCH_MAX_EVENTS, AHR_BenchServerTimeout(server));
+        for(int i=0;i<n;++i)
+        {
+            if(NULL == events[i].data.ptr)
+            {
+                continue;
+            }
+            if(server == events[i].data.ptr)
+            {
+                AHR_BenchServerAccept(server);
+                continue;
+            }
+            AHR_BenchConnection_t *connection = events[i].data.ptr;
+            if(events[i].events & (EPOLLHUP | EPOLLERR))
+            {
+                AHR_BenchServerClose(server, connection);
+                continue;
+            }
+            if((events[i].events & EPOLLIN) && !AHR_BenchServerRead(server, connection))
+            {
+                continue;
+            }
+            if((events[i].events & EPOLLOUT) && connection->sending)
+            {
+                AHR_BenchServerSend(server, connection);
+            }
+        }
+        //
+        // Paced Sends whose Time has come.
+        //
+        const uint64_t now = AHR_BenchNow();
+        AHR_BenchConnection_t *connection = server->connections;
+        while(connection)
+        {
+            AHR_BenchConnection_t *next = connection->next;
+            if(connection->sending && connection->next_send_ns <= now)
+            {
+                AHR_BenchServerSend(server, connection);
+            }
+            connection = next;
+        }
+    }
+    return NULL;
+}
+
+static void AHR_BenchServerAccept(AHR_BenchServer_t server)
+{
+    for(;;)
+    {
+        const int fd = accept4(server->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd < 0)
+        {
+            return;
+        }
+        AHR_BenchConnection_t *connection = calloc(1, sizeof(AHR_BenchConnection_t));
+        if(!connection)
+        {
+            close(fd);
+            continue;
+        }
+        const int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        connection->fd = fd;
+        //
+        // Edge triggered, Reads and Sends go on until the Socket would block.
+        //
+        struct epoll_event event = {.events = EPOLLIN | EPOLLOUT | EPOLLET, .data = {.ptr = connection}};
+        if(0 != epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event))
+        {
+            close(fd);
+            free(connection);
+            continue;
+        }
+        connection->next = server->connections;
+        server->connections = connection;
+    }
+}
+
+static void AHR_BenchServerClose(AHR_BenchServer_t server, AHR_BenchConnection_t *connection)
+{
+    AHR_BenchConnection_t **current = &server->connections;
+    while(*current && *current != connection)
+    {
+        current = &(*current)->next;
+    }
+    if(*current)
+    {
+        *current = connection->next;
+    }
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL);
+    close(connection->fd);
+    free(connection);
+}
+
+static bool AHR_BenchServerRead(AHR_BenchServer_t server, AHR_BenchConnection_t *connection)
+{
+    for(;;)
+    {
+        char scratch[AHR_BENCH_REQUEST_BYTES]; // flawfinder: ignore
+        char *target = connection->discard > 0 ? scratch : &connection->request[connection->nrequest];
+        size_t room = connection->discard > 0 ? sizeof(scratch) : sizeof(connection->request) - connection->nrequest;
+        if(connection->discard > 0 && room > connection->discard)
+        {
+            room = connection->discard;
+        }
+        if(0 == room)
+        {
+            //
+            // Request Head larger than the Buffer.
+            //
+            AHR_BenchServerClose(server, connection);
+            return false;
+        }
+        const ssize_t n = read(connection->fd, target, room); // flawfinder: ignore
+        if(n == 0 || (n < 0 && EAGAIN != errno && EWOULDBLOCK != errno))
+        {
+            AHR_BenchServerClose(server, connection);
+            return false;
+        }
+        if(n < 0)
+        {
+            break;
+        }
+        if(connection->discard > 0)
+        {
+            connection->discard -= (size_t)n;
+        }
+        else
+        {
+            connection->nrequest += (size_t)n;
+        }
+    }
+    if(!connection->sending)
+    {
+        AHR_BenchServerNextRequest(server, connection);
+        if(connection->sending)
+        {
+            return AHR_BenchServerSend(server, connection);
+        }
+    }
+    return true;
+}
+
+static void AHR_BenchServerNextRequest(AHR_BenchServer_t server, AHR_BenchConnection_t *connection)
+{
+    if(connection->discard > 0)
+    {
+        return;
+    }
+    const char *end = memmem(connection->request, connection->nrequest, "\r\n\r\n", 4);
+    if(!end)
+    {
+        return;
+    }
+    const size_t head_len = (size_t)(end - connection->request) + 4U;
+    //
+    // Only the Headers needed to frame the Request and to pick the Encoding are looked at.
+    //
+    bool gzip = false;
+    size_t content_length = 0;
+    const char *line = memchr(connection->request, '\n', head_len);
+    while(line && line < end)
+    {
+        ++line;
+        const char *next = memchr(line, '\n', (size_t)(end + 2 - line));
+        const size_t len = next ? (size_t)(next - line) : 0U;
+        if(len > 16 && 0 == strncasecmp(line, "accept-encoding:", 16))
+        {
+            gzip = NULL != memmem(line, len, "gzip", 4);
+        }
+        else if(len > 15 && 0 == strncasecmp(line, "content-length:", 15))
+        {
+            content_length = strtoull(line + 15, NULL, 10);
+        }
+        line = next;
+    }
+    //
+    // Drop the Head and whatever Part of the Body is already buffered.
+    //
+    size_t consumed = head_len;
+    const size_t buffered_body = connection->nrequest - head_len;
+    const size_t body_now = buffered_body < content_length ? buffered_body : content_length;
+    consumed += body_now;
+    connection->discard = content_length - body_now;
+    memmove(connection->request, &connection->request[consumed], connection->nrequest - consumed);
+    connection->nrequest -= consumed;
+
+    const AHR_BenchContent_t *content = server->content;
+    const bool compressed = gzip && content->gzip_body;
+    connection->body = compressed ? content->gzip_body : content->body;
+    connection->nbody = compressed ? content->gzip_nbytes : content->nbytes;
+    const int n = snprintf(
+        connection->head,
+        sizeof(connection->head),
+        "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %zu\r\n%s%s\r\n",
+        content->content_type ? content->content_type : "application/json",
+        connection->nbody,
+        compressed ? "Content-Encoding: gzip\r\nVary: Accept-Encoding\r\n" : "",
+        content->close_connections ? "Connection: close\r\n" : ""
+    );
+    connection->nhead = n > 0 ? (size_t)n : 0U;
+    connection->sent = 0;
+    connection->sending = true;
+    connection->next_send_ns = AHR_BenchNow();
+}
+
+static bool AHR_BenchServerSend(AHR_BenchServer_t server, AHR_BenchConnection_t *connection)
+{
+    const double mbps = server->content->link_mbps;
+    const size_t total = connection->nhead + connection->nbody;
+    while(connection->sending)
+    {
+        if(mbps > 0.0 && AHR_BenchNow() < connection->next_send_ns)
+        {
+            return true;
+        }
+        size_t budget = total - connection->sent;
+        if(mbps > 0.0 && budget > AHR_BENCH_PACE_SLICE)
+        {
+            budget = AHR_BENCH_PACE_SLICE;
+        }
+        struct iovec parts[2];
+        int nparts = 0;
+        size_t offset = connection->sent;
+        size_t left = budget;
+        if(offset < connection->nhead)
+        {
+            const size_t n = connection->nhead - offset < left ? connection->nhead - offset : left;
+            parts[nparts++] = (struct iovec){.iov_base = &connection->head[offset], .iov_len = n};
+            left -= n;
+            offset = 0;
+        }
+        else
+        {
+            offset -= connection->nhead;
+        }
+        if(left > 0)
+        {
+            parts[nparts++] = (struct iovec){.iov_base = (void*)&connection->body[offset], .iov_len = left};
+        }
+        const ssize_t n = writev(connection->fd, parts, nparts);
+        if(n < 0)
+        {
+            if(EAGAIN == errno || EWOULDBLOCK == errno)
+            {
+                return true;
+            }
+            AHR_BenchServerClose(server, connection);
+            return false;
+        }
+        connection->sent += (size_t)n;
+        if(mbps > 0.0)
+        {
+            connection->next_send_ns += (uint64_t)(((double)n * 8.0 * 1000.0) / mbps);
+        }
+        if(connection->sent == total)
+        {
+            connection->sending = false;
+            atomic_fetch_add(&server->responses, 1);
+            if(server->content->close_connections)
+            {
+                AHR_BenchServerClose(server, connection);
+                return false;
+            }
+            //
+            // A pipelined Request may already wait in the Buffer.
+            //
+            AHR_BenchServerNextRequest(server, connection);
+        }
+    }
+    return true;
+}
+
+static int AHR_BenchServerTimeout(const AHR_BenchServer_t server)
+{
+    if(server->content->link_mbps <= 0.0)
+    {
+        return -1;
+    }
+    const uint64_t now = AHR_BenchNow();
+    int64_t timeout = -1;
+    for(const AHR_BenchConnection_t *connection = server->connections;connection;connection = connection->next)
+    {
+        if(!connection->sending)
+        {
+            continue;
+        }
+        const int64_t wait = connection->next_send_ns > now
+            ? (int64_t)((connection->next_send_ns - now + 999999U) / 1000000U)
+            : 0;
+        if(timeout < 0 || wait < timeout)
+        {
+            timeout = wait;
+        }
+    }
+    return (int)timeout;
+}
+
+static uint64_t AHR_BenchNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
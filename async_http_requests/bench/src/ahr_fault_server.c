@@ -0,0 +1,1000 @@
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define _GNU_SOURCE
+
+#include <ahr_fault_server.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_FAULT_REQUEST_BYTES ((size_t)16384)
+///
+/// \brief  Bodies are sent from a Pattern of this Size over and over.
+///
+#define AHR_FAULT_PATTERN_BYTES ((size_t)16384)
+///
+/// \brief  Most Bytes sent at once while the Bandwidth is capped.
+///
+#define AHR_FAULT_PACE_SLICE ((size_t)16384)
+#define AHR_FAULT_PADDING_LINE ((size_t)1024)
+#define AHR_FAULT_HEAD_BYTES ((size_t)256)
+#define AHR_FAULT_MAX_EVENTS 64
+
+typedef enum
+{
+    AHR_FAULT_READING = 0,
+    ///
+    /// \brief  The Request is complete, the Response is delayed until "due_ns".
+    ///
+    AHR_FAULT_WAITING = 1,
+    AHR_FAULT_SENDING = 2,
+    ///
+    /// \brief  Nothing is sent anymore, the Connection stays open until the Client closes it.
+    ///
+    AHR_FAULT_STALLED = 3
+} AHR_FaultState_t;
+
+typedef enum
+{
+    AHR_FAULT_CUT_NONE = 0,
+    AHR_FAULT_CUT_RESET = 1,
+    AHR_FAULT_CUT_STALL = 2
+} AHR_FaultCut_t;
+
+typedef struct AHR_FaultConnection
+{
+    struct AHR_FaultConnection *next;
+    int fd;
+    char request[AHR_FAULT_REQUEST_BYTES]; // flawfinder: ignore
+    size_t nrequest;
+    ///
+    /// \brief  Bytes of a Request Body which still have to be read and dropped.
+    ///
+    size_t discard;
+
+    AHR_FaultState_t state;
+    char *head;
+    size_t nhead;
+    size_t nbody;
+    size_t sent;
+    ///
+    /// \brief  The Response is cut after this many Bytes, if "cut" is set.
+    ///
+    size_t cut_at;
+    AHR_FaultCut_t cut;
+    double rate;
+    bool close_after;
+    ///
+    /// \brief  When the first Byte, respectively the next paced Slice, is due.
+    ///
+    uint64_t due_ns;
+} AHR_FaultConnection_t;
+
+///
+/// \brief  Response asked for by the "X-Fault-Shape" Header of a Request, negative Values are not given.
+///
+typedef struct
+{
+    int64_t status;
+    int64_t body_bytes;
+    int64_t header_bytes;
+    int64_t latency_us;
+} AHR_FaultShape_t;
+
+typedef struct
+{
+    AHR_FaultRoute_t route;
+    atomic_ullong requests;
+    atomic_ullong drops;
+    atomic_ullong errors;
+    atomic_ullong resets;
+    atomic_ullong stalls;
+} AHR_FaultRouteState_t;
+
+struct AHR_FaultServer
+{
+    AHR_FaultRouteState_t *routes;
+    size_t nroutes;
+    int listen_fd;
+    int epoll_fd;
+    int wake_fd;
+    uint16_t port;
+    pthread_t thread;
+    atomic_bool stop;
+    uint64_t random;
+    char pattern[AHR_FAULT_PATTERN_BYTES]; // flawfinder: ignore
+    AHR_FaultConnection_t *connections;
+};
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_FaultParseLatency(const char *value, AHR_FaultLatency_t *latency);
+///
+/// \brief  Parse the Value of an "X-Fault-Shape" Header, "KEY=VALUE" Pairs separated by Spaces.
+///         Unknown Keys are skipped.
+///
+static void AHR_FaultParseShape(const char *value, size_t len, AHR_FaultShape_t *shape);
+static void* AHR_FaultServerRun(void *arg);
+static void AHR_FaultServerAccept(AHR_FaultServer_t server);
+///
+/// \brief  Close the Connection, with a RST instead of a FIN if "reset" is set.
+///
+static void AHR_FaultServerClose(AHR_FaultServer_t server, AHR_FaultConnection_t *connection, bool reset);
+///
+/// \brief  Read all available Bytes and start the Response to a complete Request.
+/// \returns    false if the Connection was closed.
+///
+static bool AHR_FaultServerRead(AHR_FaultServer_t server, AHR_FaultConnection_t *connection);
+///
+/// \brief  Pick the Route of the next complete Request in the Buffer, draw its Faults and prepare the Response.
+/// \returns    false if the Connection was closed.
+///
+static bool AHR_FaultServerNextRequest(AHR_FaultServer_t server, AHR_FaultConnection_t *connection);
+///
+/// \brief  Send as much of the Response as the Socket, the Bandwidth Cap and the Fault allow.
+/// \returns    false if the Connection was closed.
+///
+static bool AHR_FaultServerSend(AHR_FaultServer_t server, AHR_FaultConnection_t *connection);
+///
+/// \brief  Milliseconds until the next delayed or paced Send is due, -1 if none.
+///
+static int AHR_FaultServerTimeout(const AHR_FaultServer_t server);
+///
+/// \brief  Delay in Nanoseconds drawn from "latency".
+///
+static uint64_t AHR_FaultServerDelay(AHR_FaultServer_t server, const AHR_FaultLatency_t *latency);
+///
+/// \brief  Uniform in [0, 1).
+///
+static double AHR_FaultServerUniform(AHR_FaultServer_t server);
+static const char* AHR_FaultReason(unsigned int status);
+static uint64_t AHR_FaultNow(void);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+bool AHR_FaultRouteParse(const char *line, AHR_FaultRoute_t *route)
+{
+    memset(route, 0, sizeof(AHR_FaultRoute_t));
+    route->status = 200U;
+    route->error_status = 503U;
+    while(' ' == *line || '\t' == *line)
+    {
+        ++line;
+    }
+    const size_t path_len = strcspn(line, " \t\r\n");
+    if(0 == path_len || path_len >= sizeof(route->path))
+    {
+        return false;
+    }
+    memcpy(route->path, line, path_len); // flawfinder: ignore
+    route->path[path_len] = '\0';
+    line += path_len;
+    for(;;)
+    {
+        line += strspn(line, " \t\r\n");
+        if('\0' == *line)
+        {
+            break;
+        }
+        char token[AHR_FAULT_PATH_BYTES]; // flawfinder: ignore
+        const size_t len = strcspn(line, " \t\r\n");
+        if(len >= sizeof(token))
+        {
+            return false;
+        }
+        memcpy(token, line, len); // flawfinder: ignore
+        token[len] = '\0';
+        line += len;
+        char *value = strchr(token, '=');
+        if(!value)
+        {
+            return false;
+        }
+        *value++ = '\0';
+        char *end = NULL;
+        if(0 == strcmp(token, "latency"))
+        {
+            if(!AHR_FaultParseLatency(value, &route->latency))
+            {
+                return false;
+            }
+            continue;
+        }
+        const double number = strtod(value, &end);
+        if(end == value || '\0' != *end || number < 0.0)
+        {
+            return false;
+        }
+        if(0 == strcmp(token, "status"))
+        {
+            route->status = (unsigned int)number;
+        }
+        else if(0 == strcmp(token, "body"))
+        {
+            route->body_bytes = (size_t)number;
+        }
+        else if(0 == strcmp(token, "headers"))
+        {
+            route->header_bytes = (size_t)number;
+        }
+        else if(0 == strcmp(token, "rate"))
+        {
+            route->rate = number;
+        }
+        else if(0 == strcmp(token, "drop_rate"))
+        {
+            route->drop_rate = number;
+        }
+        else if(0 == strcmp(token, "error_rate"))
+        {
+            route->error_rate = number;
+        }
+        else if(0 == strcmp(token, "error_status"))
+        {
+            route->error_status = (unsigned int)number;
+        }
+        else if(0 == strcmp(token, "reset_rate"))
+        {
+            route->reset_rate = number;
+        }
+        else if(0 == strcmp(token, "stall_rate"))
+        {
+            route->stall_rate = number;
+        }
+        else if(0 == strcmp(token, "close"))
+        {
+            route->close_connections = number > 0.0;
+        }
+        else if(0 == strcmp(token, "shape"))
+        {
+            route->request_shape = number > 0.0;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return route->status >= 100U && route->status <= 999U && route->error_status >= 100U && route->error_status <= 999U;
+}
+
+AHR_FaultServer_t AHR_FaultServerStart(uint16_t port, const AHR_FaultRoute_t *routes, size_t nroutes, uint64_t seed)
+{
+    assert(NULL != routes || 0 == nroutes);
+    AHR_FaultServer_t server = calloc(1, sizeof(struct AHR_FaultServer));
+    if(!server)
+    {
+        return NULL;
+    }
+    server->epoll_fd = -1;
+    server->wake_fd = -1;
+    server->listen_fd = -1;
+    server->routes = calloc(nroutes > 0 ? nroutes : 1U, sizeof(AHR_FaultRouteState_t));
+    if(!server->routes)
+    {
+        goto on_error;
+    }
+    server->nroutes = nroutes;
+    for(size_t i=0;i<nroutes;++i)
+    {
+        server->routes[i].route = routes[i];
+        atomic_init(&server->routes[i].requests, 0);
+        atomic_init(&server->routes[i].drops, 0);
+        atomic_init(&server->routes[i].errors, 0);
+        atomic_init(&server->routes[i].resets, 0);
+        atomic_init(&server->routes[i].stalls, 0);
+    }
+    server->random = seed * 0x9E3779B97F4A7C15ULL + 1U;
+    for(size_t i=0;i<AHR_FAULT_PATTERN_BYTES;++i)
+    {
+        server->pattern[i] = (char)('a' + (char)(i % 26U));
+    }
+    atomic_init(&server->stop, false);
+    server->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(server->listen_fd < 0)
+    {
+        goto on_error;
+    }
+    const int one = 1;
+    setsockopt(server->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in address = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr = {.s_addr = htonl(INADDR_LOOPBACK)}
+    };
+    socklen_t length = sizeof(address);
+    if(
+        0 != bind(server->listen_fd, (struct sockaddr*)&address, sizeof(address))
+        || 0 != listen(server->listen_fd, 1024)
+        || 0 != getsockname(server->listen_fd, (struct sockaddr*)&address, &length)
+    )
+    {
+        goto on_error;
+    }
+    server->port = ntohs(address.sin_port);
+
+    server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    server->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(server->epoll_fd < 0 || server->wake_fd < 0)
+    {
+        goto on_error;
+    }
+    //
+    // The Listening Socket is tagged with the Server, the Wake-Up Event with NULL.
+    //
+    struct epoll_event listen_event = {.events = EPOLLIN, .data = {.ptr = server}};
+    struct epoll_event wake_event = {.events = EPOLLIN, .data = {.ptr = NULL}};
+    if(
+        0 != epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_fd, &listen_event)
+        || 0 != epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->wake_fd, &wake_event)
+        || 0 != pthread_create(&server->thread, NULL, AHR_FaultServerRun, server)
+    )
+    {
+        goto on_error;
+    }
+    return server;
+
+    on_error:
+    if(server->listen_fd >= 0)
+    {
+        close(server->listen_fd);
+    }
+    if(server->epoll_fd >= 0)
+    {
+        close(server->epoll_fd);
+    }
+    if(server->wake_fd >= 0)
+    {
+        close(server->wake_fd);
+    }
+    free(server->routes);
+    free(server);
+    return NULL;
+}
+
+uint16_t AHR_FaultServerPort(const AHR_FaultServer_t server)
+{
+    return server->port;
+}
+
+bool AHR_FaultServerStats(const AHR_FaultServer_t server, size_t route, AHR_FaultStats_t *stats)
+{
+    if(route >= server->nroutes)
+    {
+        return false;
+    }
+    AHR_FaultRouteState_t *state = &server->routes[route];
+    stats->requests = atomic_load(&state->requests);
+    stats->drops = atomic_load(&state->drops);
+    stats->errors = atomic_load(&state->errors);
+    stats->resets = atomic_load(&state->resets);
+    stats->stalls = atomic_load(&state->stalls);
+    return true;
+}
+
+void AHR_FaultServerStop(AHR_FaultServer_t *server)
+{
+    assert(NULL != server && NULL != *server);
+    AHR_FaultServer_t s = *server;
+    atomic_store(&s->stop, true);
+    const uint64_t one = 1;
+    if(sizeof(one) != write(s->wake_fd, &one, sizeof(one)))
+    {
+        perror("AHR_FaultServerStop");
+    }
+    pthread_join(s->thread, NULL);
+    while(s->connections)
+    {
+        AHR_FaultServerClose(s, s->connections, false);
+    }
+    close(s->listen_fd);
+    close(s->epoll_fd);
+    close(s->wake_fd);
+    free(s->routes);
+    free(s);
+    *server = NULL;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_FaultParseLatency(const char *value, AHR_FaultLatency_t *latency)
+{
+    static const struct
+    {
+        const char *name;
+        AHR_FaultLatencyKind_t kind;
+        size_t nparameters;
+    } kinds[] = {
+        {"fixed", AHR_FAULT_LATENCY_FIXED, 1U},
+        {"uniform", AHR_FAULT_LATENCY_UNIFORM, 2U},
+        {"exp", AHR_FAULT_LATENCY_EXPONENTIAL, 1U},
+        {"lognormal", AHR_FAULT_LATENCY_LOGNORMAL, 2U}
+    };
+    const size_t name_len = strcspn(value, ":");
+    for(size_t i=0;i<sizeof(kinds) / sizeof(kinds[0]);++i)
+    {
+        if(name_len != strlen(kinds[i].name) || 0 != strncmp(value, kinds[i].name, name_len)) // flawfinder: ignore
+        {
+            continue;
+        }
+        double parameters[2] = {0.0, 0.0};
+        const char *p = &value[name_len];
+        for(size_t k=0;k<kinds[i].nparameters;++k)
+        {
+            if(':' != *p)
+            {
+                return false;
+            }
+            char *end = NULL;
+            parameters[k] = strtod(p + 1, &end);
+            if(end == p + 1 || parameters[k] < 0.0)
+            {
+                return false;
+            }
+            p = end;
+        }
+        *latency = (AHR_FaultLatency_t){.kind = kinds[i].kind, .a = parameters[0], .b = parameters[1]};
+        return '\0' == *p && (AHR_FAULT_LATENCY_UNIFORM != latency->kind || latency->a <= latency->b);
+    }
+    return false;
+}
+
+static void AHR_FaultParseShape(const char *value, size_t len, AHR_FaultShape_t *shape)
+{
+    static const struct
+    {
+        const char *key;
+        size_t offset;
+    } keys[] = {
+        {"status=", offsetof(AHR_FaultShape_t, status)},
+        {"body=", offsetof(AHR_FaultShape_t, body_bytes)},
+        {"headers=", offsetof(AHR_FaultShape_t, header_bytes)},
+        {"latency_us=", offsetof(AHR_FaultShape_t, latency_us)}
+    };
+    const char *end = value + len;
+    while(value < end)
+    {
+        while(value < end && (' ' == *value || '\t' == *value || '\r' == *value))
+        {
+            ++value;
+        }
+        size_t token = 0;
+        while(value + token < end && ' ' != value[token] && '\t' != value[token] && '\r' != value[token])
+        {
+            ++token;
+        }
+        for(size_t i=0;i<sizeof(keys) / sizeof(keys[0]);++i)
+        {
+            const size_t key_len = strlen(keys[i].key); // flawfinder: ignore
+            if(token > key_len && 0 == memcmp(value, keys[i].key, key_len))
+            {
+                //
+                // The Digits end at the Space or CR behind them at the latest, both are within the Request.
+                //
+                const long long number = strtoll(value + key_len, NULL, 10);
+                *(int64_t*)((char*)shape + keys[i].offset) = number >= 0 ? (int64_t)number : -1;
+            }
+        }
+        value += token;
+    }
+}
+
+static void* AHR_FaultServerRun(void *arg)
+{
+    AHR_FaultServer_t server = (AHR_FaultServer_t)arg;
+    struct epoll_event events[AHR_FAULT_MAX_EVENTS];
+    while(!atomic_load(&server->stop))
+    {
+        const int n = epoll_wait(server->epoll_fd, events, AHR_FAULT_MAX_EVENTS, AHR_FaultServerTimeout(server));
+        for(int i=0;i<n;++i)
+        {
+            if(NULL == events[i].data.ptr)
+            {
+                continue;
+            }
+            if(server == events[i].data.ptr)
+            {
+                AHR_FaultServerAccept(server);
+                continue;
+            }
+            AHR_FaultConnection_t *connection = events[i].data.ptr;
+            if(events[i].events & (EPOLLHUP | EPOLLERR))
+            {
+                AHR_FaultServerClose(server, connection, false);
+                continue;
+            }
+            if((events[i].events & EPOLLIN) && !AHR_FaultServerRead(server, connection))
+            {
+                continue;
+            }
+            if((events[i].events & EPOLLOUT) && AHR_FAULT_SENDING == connection->state)
+            {
+                AHR_FaultServerSend(server, connection);
+            }
+        }
+        //
+        // Delayed Responses and paced Sends whose Time has come.
+        //
+        const uint64_t now = AHR_FaultNow();
+        AHR_FaultConnection_t *connection = server->connections;
+        while(connection)
+        {
+            AHR_FaultConnection_t *next = connection->next;
+            if(AHR_FAULT_WAITING == connection->state && connection->due_ns <= now)
+            {
+                connection->state = AHR_FAULT_SENDING;
+            }
+            if(AHR_FAULT_SENDING == connection->state && connection->due_ns <= now)
+            {
+                AHR_FaultServerSend(server, connection);
+            }
+            connection = next;
+        }
+    }
+    return NULL;
+}
+
+static void AHR_FaultServerAccept(AHR_FaultServer_t server)
+{
+    for(;;)
+    {
+        const int fd = accept4(server->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd < 0)
+        {
+            return;
+        }
+        AHR_FaultConnection_t *connection = calloc(1, sizeof(AHR_FaultConnection_t));
+        if(!connection)
+        {
+            close(fd);
+            continue;
+        }
+        const int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        connection->fd = fd;
+        //
+        // Edge triggered, Reads and Sends go on until the Socket would block.
+        //
+        struct epoll_event event = {.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, .data = {.ptr = connection}};
+        if(0 != epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event))
+        {
+            close(fd);
+            free(connection);
+            continue;
+        }
+        connection->next = server->connections;
+        server->connections = connection;
+    }
+}
+
+static void AHR_FaultServerClose(AHR_FaultServer_t server, AHR_FaultConnection_t *connection, bool reset)
+{
+    AHR_FaultConnection_t **current = &server->connections;
+    while(*current && *current != connection)
+    {
+        current = &(*current)->next;
+    }
+    if(*current)
+    {
+        *current = connection->next;
+    }
+    if(reset)
+    {
+        const struct linger linger = {.l_onoff = 1, .l_linger = 0};
+        setsockopt(connection->fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+    }
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL);
+    close(connection->fd);
+    free(connection->head);
+    free(connection);
+}
+
+static bool AHR_FaultServerRead(AHR_FaultServer_t server, AHR_FaultConnection_t *connection)
+{
+    for(;;)
+    {
+        //
+        // A stalled Connection only waits for the Client to give up, whatever it sends is dropped.
+        //
+        char scratch[AHR_FAULT_REQUEST_BYTES]; // flawfinder: ignore
+        const bool drop = connection->discard > 0 || AHR_FAULT_STALLED == connection->state;
+        char *target = drop ? scratch : &connection->request[connection->nrequest];
+        size_t room = drop ? sizeof(scratch) : sizeof(connection->request) - connection->nrequest;
+        if(connection->discard > 0 && room > connection->discard)
+        {
+            room = connection->discard;
+        }
+        if(0 == room)
+        {
+            //
+            // Request Head larger than the Buffer.
+            //
+            AHR_FaultServerClose(server, connection, false);
+            return false;
+        }
+        const ssize_t n = read(connection->fd, target, room); // flawfinder: ignore
+        if(n == 0 || (n < 0 && EAGAIN != errno && EWOULDBLOCK != errno))
+        {
+            AHR_FaultServerClose(server, connection, false);
+            return false;
+        }
+        if(n < 0)
+        {
+            break;
+        }
+        if(connection->discard > 0)
+        {
+            connection->discard -= (size_t)n;
+        }
+        else if(!drop)
+        {
+            connection->nrequest += (size_t)n;
+        }
+    }
+    if(AHR_FAULT_READING == connection->state)
+    {
+        return AHR_FaultServerNextRequest(server, connection);
+    }
+    return true;
+}
+
+static bool AHR_FaultServerNextRequest(AHR_FaultServer_t server, AHR_FaultConnection_t *connection)
+{
+    if(connection->discard > 0)
+    {
+        return true;
+    }
+    const char *end = memmem(connection->request, connection->nrequest, "\r\n\r\n", 4);
+    if(!end)
+    {
+        return true;
+    }
+    const size_t head_len = (size_t)(end - connection->request) + 4U;
+    //
+    // The Path is the second Word of the Request Line.
+    //
+    const char *path = memchr(connection->request, ' ', head_len);
+    path = path ? path + 1 : connection->request;
+    const char *path_end = memchr(path, ' ', (size_t)(end - path));
+    const size_t path_len = path_end ? (size_t)(path_end - path) : 0U;
+    size_t content_length = 0;
+    AHR_FaultShape_t shape = {.status = -1, .body_bytes = -1, .header_bytes = -1, .latency_us = -1};
+    const char *line = memchr(connection->request, '\n', head_len);
+    while(line && line < end)
+    {
+        ++line;
+        const char *next = memchr(line, '\n', (size_t)(end + 2 - line));
+        const size_t len = next ? (size_t)(next - line) : 0U;
+        if(len > 15 && 0 == strncasecmp(line, "content-length:", 15))
+        {
+            content_length = strtoull(line + 15, NULL, 10);
+        }
+        else if(len > 14 && 0 == strncasecmp(line, "x-fault-shape:", 14))
+        {
+            AHR_FaultParseShape(line + 14, len - 14, &shape);
+        }
+        line = next;
+    }
+    AHR_FaultRouteState_t *state = NULL;
+    for(size_t i=0;i<server->nroutes && !state;++i)
+    {
+        const char *prefix = server->routes[i].route.path;
+        const size_t prefix_len = strlen(prefix); // flawfinder: ignore
+        if(0 == strcmp(prefix, "*") || (prefix_len <= path_len && 0 == memcmp(prefix, path, prefix_len)))
+        {
+            state = &server->routes[i];
+        }
+    }
+    //
+    // Drop the Head and whatever Part of the Body is already buffered.
+    //
+    size_t consumed = head_len;
+    const size_t buffered_body = connection->nrequest - head_len;
+    const size_t body_now = buffered_body < content_length ? buffered_body : content_length;
+    consumed += body_now;
+    connection->discard = content_length - body_now;
+    memmove(connection->request, &connection->request[consumed], connection->nrequest - consumed);
+    connection->nrequest -= consumed;
+
+    const AHR_FaultRoute_t *route = state ? &state->route : NULL;
+    unsigned int status = route ? route->status : 404U;
+    connection->nbody = route ? route->body_bytes : 0U;
+    connection->cut = AHR_FAULT_CUT_NONE;
+    connection->rate = route ? route->rate : 0.0;
+    connection->close_after = route && route->close_connections;
+    uint64_t delay_ns = 0;
+    size_t padding = route ? route->header_bytes : 0U;
+    if(route)
+    {
+        atomic_fetch_add(&state->requests, 1);
+        delay_ns = AHR_FaultServerDelay(server, &route->latency);
+        if(route->request_shape)
+        {
+            status = shape.status >= 100 && shape.status <= 999 ? (unsigned int)shape.status : status;
+            connection->nbody = shape.body_bytes >= 0 ? (size_t)shape.body_bytes : connection->nbody;
+            padding = shape.header_bytes >= 0 ? (size_t)shape.header_bytes : padding;
+            delay_ns = shape.latency_us >= 0 ? (uint64_t)shape.latency_us * 1000U : delay_ns;
+        }
+        //
+        // One Draw decides which Fault, if any, so the Rates add up.
+        //
+        const double u = AHR_FaultServerUniform(server);
+        double bound = route->drop_rate;
+        if(u < bound)
+        {
+            atomic_fetch_add(&state->drops, 1);
+            AHR_FaultServerClose(server, connection, false);
+            return false;
+        }
+        if(u < (bound += route->error_rate))
+        {
+            atomic_fetch_add(&state->errors, 1);
+            status = route->error_status;
+            connection->nbody = 0;
+        }
+        else if(u < (bound += route->reset_rate))
+        {
+            atomic_fetch_add(&state->resets, 1);
+            connection->cut = AHR_FAULT_CUT_RESET;
+        }
+        else if(u < (bound += route->stall_rate))
+        {
+            atomic_fetch_add(&state->stalls, 1);
+            connection->cut = AHR_FAULT_CUT_STALL;
+        }
+    }
+
+    free(connection->head);
+    connection->head = malloc(AHR_FAULT_HEAD_BYTES + padding + AHR_FAULT_PADDING_LINE);
+    if(!connection->head)
+    {
+        AHR_FaultServerClose(server, connection, false);
+        return false;
+    }
+    int n = snprintf(
+        connection->head,
+        AHR_FAULT_HEAD_BYTES,
+        "HTTP/1.1 %u %s\r\nContent-Type: application/octet-stream\r\nContent-Length: %zu\r\n%s",
+        status,
+        AHR_FaultReason(status),
+        connection->nbody,
+        connection->close_after ? "Connection: close\r\n" : ""
+    );
+    connection->nhead = n > 0 ? (size_t)n : 0U;
+    const size_t padded = connection->nhead + padding;
+    for(size_t i=0;padding > 0 && connection->nhead < padded;++i)
+    {
+        n = snprintf(&connection->head[connection->nhead], 48, "X-Fault-Padding-%zu: ", i);
+        connection->nhead += n > 0 ? (size_t)n : 0U;
+        //
+        // The last Line only fills up what is left, so the Head ends up close to the asked Size.
+        //
+        const size_t left = padded > connection->nhead + 2U ? padded - connection->nhead - 2U : 1U;
+        const size_t fill = left < AHR_FAULT_PADDING_LINE - 64U ? left : AHR_FAULT_PADDING_LINE - 64U;
+        memset(&connection->head[connection->nhead], 'p', fill);
+        connection->nhead += fill;
+        memcpy(&connection->head[connection->nhead], "\r\n", 2); // flawfinder: ignore
+        connection->nhead += 2U;
+    }
+    memcpy(&connection->head[connection->nhead], "\r\n", 2); // flawfinder: ignore
+    connection->nhead += 2U;
+    //
+    // Resets and Stalls cut the Body in half, or the Head if there is no Body.
+    //
+    connection->cut_at = connection->nbody > 0 ? connection->nhead + connection->nbody / 2U : connection->nhead / 2U;
+    connection->sent = 0;
+    connection->due_ns = AHR_FaultNow() + delay_ns;
+    connection->state = AHR_FAULT_WAITING;
+    if(0 == delay_ns)
+    {
+        connection->state = AHR_FAULT_SENDING;
+        return AHR_FaultServerSend(server, connection);
+    }
+    return true;
+}
+
+static bool AHR_FaultServerSend(AHR_FaultServer_t server, AHR_FaultConnection_t *connection)
+{
+    const size_t total = connection->nhead + connection->nbody;
+    const size_t limit = AHR_FAULT_CUT_NONE != connection->cut ? connection->cut_at : total;
+    //
+    // Slices of a hundredth of a Second keep a low Rate smooth.
+    //
+    size_t slice = (size_t)(connection->rate / 100.0);
+    slice = slice < 1U ? 1U : slice > AHR_FAULT_PACE_SLICE ? AHR_FAULT_PACE_SLICE : slice;
+    while(AHR_FAULT_SENDING == connection->state)
+    {
+        if(connection->sent == limit)
+        {
+            if(AHR_FAULT_CUT_RESET == connection->cut)
+            {
+                AHR_FaultServerClose(server, connection, true);
+                return false;
+            }
+            if(AHR_FAULT_CUT_STALL == connection->cut)
+            {
+                connection->state = AHR_FAULT_STALLED;
+                return true;
+            }
+            connection->state = AHR_FAULT_READING;
+            if(connection->close_after)
+            {
+                AHR_FaultServerClose(server, connection, false);
+                return false;
+            }
+            //
+            // A pipelined Request may already wait in the Buffer.
+            //
+            return AHR_FaultServerNextRequest(server, connection);
+        }
+        if(connection->rate > 0.0 && AHR_FaultNow() < connection->due_ns)
+        {
+            return true;
+        }
+        size_t budget = limit - connection->sent;
+        if(connection->rate > 0.0 && budget > slice)
+        {
+            budget = slice;
+        }
+        struct iovec parts[2];
+        int nparts = 0;
+        size_t left = budget;
+        if(connection->sent < connection->nhead)
+        {
+            const size_t n = connection->nhead - connection->sent < left ? connection->nhead - connection->sent : left;
+            parts[nparts++] = (struct iovec){.iov_base = &connection->head[connection->sent], .iov_len = n};
+            left -= n;
+        }
+        if(left > 0)
+        {
+            //
+            // The Body repeats the Pattern, one Slice at most reaches to its End.
+            //
+            const size_t offset = (connection->sent + budget - left - connection->nhead) % AHR_FAULT_PATTERN_BYTES;
+            const size_t n = AHR_FAULT_PATTERN_BYTES - offset < left ? AHR_FAULT_PATTERN_BYTES - offset : left;
+            parts[nparts++] = (struct iovec){.iov_base = &server->pattern[offset], .iov_len = n};
+        }
+        //
+        // Clients abort Transfers of oversized Bodies, that must not raise SIGPIPE in the Process.
+        //
+        const struct msghdr message = {.msg_iov = parts, .msg_iovlen = (size_t)nparts};
+        const ssize_t n = sendmsg(connection->fd, &message, MSG_NOSIGNAL);
+        if(n < 0)
+        {
+            if(EAGAIN == errno || EWOULDBLOCK == errno)
+            {
+                return true;
+            }
+            AHR_FaultServerClose(server, connection, false);
+            return false;
+        }
+        connection->sent += (size_t)n;
+        if(connection->rate > 0.0)
+        {
+            connection->due_ns += (uint64_t)(1e9 * (double)n / connection->rate);
+        }
+    }
+    return true;
+}
+
+static int AHR_FaultServerTimeout(const AHR_FaultServer_t server)
+{
+    const uint64_t now = AHR_FaultNow();
+    int64_t timeout = -1;
+    for(const AHR_FaultConnection_t *connection = server->connections;connection;connection = connection->next)
+    {
+        const bool paced = AHR_FAULT_SENDING == connection->state && connection->rate > 0.0;
+        if(AHR_FAULT_WAITING != connection->state && !paced)
+        {
+            continue;
+        }
+        const int64_t wait = connection->due_ns > now
+            ? (int64_t)((connection->due_ns - now + 999999U) / 1000000U)
+            : 0;
+        if(timeout < 0 || wait < timeout)
+        {
+            timeout = wait;
+        }
+    }
+    return (int)timeout;
+}
+
+static uint64_t AHR_FaultServerDelay(AHR_FaultServer_t server, const AHR_FaultLatency_t *latency)
+{
+    double ms = 0.0;
+    switch(latency->kind)
+    {
+        case AHR_FAULT_LATENCY_FIXED:
+            ms = latency->a;
+            break;
+        case AHR_FAULT_LATENCY_UNIFORM:
+            ms = latency->a + (latency->b - latency->a) * AHR_FaultServerUniform(server);
+            break;
+        case AHR_FAULT_LATENCY_EXPONENTIAL:
+            ms = -latency->a * log(1.0 - AHR_FaultServerUniform(server));
+            break;
+        case AHR_FAULT_LATENCY_LOGNORMAL:
+        {
+            //
+            // Box-Muller gives the standard normal Deviate.
+            //
+            const double u1 = 1.0 - AHR_FaultServerUniform(server);
+            const double u2 = AHR_FaultServerUniform(server);
+            const double z = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+            ms = latency->a * exp(latency->b * z);
+            break;
+        }
+        case AHR_FAULT_LATENCY_NONE:
+        default:
+            break;
+    }
+    return (uint64_t)(1e6 * ms);
+}
+
+static double AHR_FaultServerUniform(AHR_FaultServer_t server)
+{
+    server->random ^= server->random >> 12;
+    server->random ^= server->random << 25;
+    server->random ^= server->random >> 27;
+    return (double)((server->random * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+}
+
+static const char* AHR_FaultReason(unsigned int status)
+{
+    switch(status)
+    {
+        case 200U:
+            return "OK";
+        case 404U:
+            return "Not Found";
+        case 429U:
+            return "Too Many Requests";
+        case 500U:
+            return "Internal Server Error";
+        case 502U:
+            return "Bad Gateway";
+        case 503U:
+            return "Service Unavailable";
+        case 504U:
+            return "Gateway Timeout";
+        default:
+            return "Injected";
+    }
+}
+
+static uint64_t AHR_FaultNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,158 @@
+///
+/// \brief  Command Line Front of the fault injecting Server, for Scripts and Tests which run libahr against it.
+///         Routes come from "--routes FILE", one per Line (Lines starting with '#' are skipped), and from
+///         "--route SPEC" Arguments, see AHR_FaultRouteParse(). Routes are matched in the given Order.
+///
+///         Once listening the Base URL is printed to stdout, so a Script can pick up the Port.
+///         SIGINT or SIGTERM stop the Server, what was injected per Route is then printed to stderr.
+///
+/// \example    ahr_fault_server --seed 7 --route '/slow latency=exp:50' --route '* error_rate=0.01' &
+///
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <ahr_fault_server.h>
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_FAULT_MAX_ROUTES 64U
+#define AHR_FAULT_LINE_BYTES 1024U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Append the Routes of a File.
+///
+static bool AHR_FaultReadRoutes(const char *path, AHR_FaultRoute_t *routes, size_t *nroutes);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+int main(int argc, char **argv)
+{
+    static AHR_FaultRoute_t routes[AHR_FAULT_MAX_ROUTES];
+    size_t nroutes = 0;
+    unsigned long port = 0;
+    unsigned long long seed = 1U;
+    bool ok = 0 != argc % 2;
+    for(int i=1;ok && i+1<argc;i+=2)
+    {
+        if(0 == strcmp(argv[i], "--port"))
+        {
+            port = strtoul(argv[i + 1], NULL, 10);
+            ok = port <= 65535UL;
+        }
+        else if(0 == strcmp(argv[i], "--seed"))
+        {
+            seed = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if(0 == strcmp(argv[i], "--routes"))
+        {
+            ok = AHR_FaultReadRoutes(argv[i + 1], routes, &nroutes);
+        }
+        else if(0 == strcmp(argv[i], "--route"))
+        {
+            ok = nroutes < AHR_FAULT_MAX_ROUTES && AHR_FaultRouteParse(argv[i + 1], &routes[nroutes]);
+            if(!ok)
+            {
+                fprintf(stderr, "invalid route \"%s\"\n", argv[i + 1]);
+            }
+            ++nroutes;
+        }
+        else
+        {
+            ok = false;
+        }
+    }
+    if(!ok || 0 == nroutes)
+    {
+        fprintf(stderr, "usage: %s [--port N] [--seed N] [--routes FILE] [--route 'PATH KEY=VALUE ...'] ...\n", argv[0]);
+        return 2;
+    }
+    //
+    // Block the Signals before the Server Thread starts, so it inherits the Mask and only sigwait() sees them.
+    //
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+    AHR_FaultServer_t server = AHR_FaultServerStart((uint16_t)port, routes, nroutes, (uint64_t)seed);
+    if(!server)
+    {
+        perror("unable to start the server");
+        return 1;
+    }
+    printf("http://127.0.0.1:%u/\n", (unsigned int)AHR_FaultServerPort(server));
+    fflush(stdout);
+    int received = 0;
+    sigwait(&signals, &received);
+
+    for(size_t i=0;i<nroutes;++i)
+    {
+        AHR_FaultStats_t stats;
+        AHR_FaultServerStats(server, i, &stats);
+        fprintf(
+            stderr,
+            "%-24s requests %8llu  drops %6llu  errors %6llu  resets %6llu  stalls %6llu\n",
+            routes[i].path,
+            (unsigned long long)stats.requests,
+            (unsigned long long)stats.drops,
+            (unsigned long long)stats.errors,
+            (unsigned long long)stats.resets,
+            (unsigned long long)stats.stalls
+        );
+    }
+    AHR_FaultServerStop(&server);
+    return 0;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_FaultReadRoutes(const char *path, AHR_FaultRoute_t *routes, size_t *nroutes)
+{
+    FILE *file = fopen(path, "r");
+    if(!file)
+    {
+        perror(path);
+        return false;
+    }
+    char line[AHR_FAULT_LINE_BYTES]; // flawfinder: ignore
+    size_t number = 0;
+    bool ok = true;
+    while(ok && fgets(line, sizeof(line), file))
+    {
+        ++number;
+        const char *start = line + strspn(line, " \t");
+        if('#' == *start || '\0' == start[strspn(start, " \t\r\n")])
+        {
+            continue;
+        }
+        ok = *nroutes < AHR_FAULT_MAX_ROUTES && AHR_FaultRouteParse(start, &routes[*nroutes]);
+        if(!ok)
+        {
+            fprintf(stderr, "%s:%zu: invalid route\n", path, number);
+        }
+        ++*nroutes;
+    }
+    fclose(file);
+    return ok;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,1051 @@
+///
+/// \brief  Open-loop Load Generator on top of the Processor.
+///         Requests are sent on a fixed Arrival Schedule, independent of how fast Responses come back:
+///
+///             constant    - evenly spaced Arrivals at "--rate" Requests per Second.
+///             poisson     - exponentially distributed Gaps with a Mean of 1 / "--rate".
+///             step        - evenly spaced Arrivals, the Rate changes as given by "--steps RATE:SECONDS,...".
+///
+///         Each Sender Thread owns some of the Processors and sends its Share of the Schedule through their
+///         Requestobjects. If no Object is free the Request waits until one is, it is sent late.
+///         Latency is measured from the intended Send Time, so Waiting for an Object or for the Sender counts
+///         (Correction of Coordinated Omission). The Service Time, measured from the actual Send, is reported
+///         next to it. The Difference between both shows where the Target or libahr saturates.
+///
+///         Targets are read from a File, one per Line: "METHOD URL [BODY]", METHOD is GET, POST, PUT or DELETE.
+///         The Body is the Rest of the Line. Empty Lines and Lines starting with '#' are skipped.
+///         The Targets are used round-robin.
+///
+///         With "--hdr-log" each Interval is appended to a HdrHistogram Log in Nanoseconds, tagged "intended"
+///         and "service". A Summary is written to stdout as JSON, Progress per Interval to stderr.
+///
+/// \example    printf 'GET http://127.0.0.1:8080/items\n' > targets.txt
+///             ahr_load --targets targets.txt --schedule poisson --rate 20000 --duration 30 --processors 8 --threads 2 --hdr-log load.hlog
+///
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define _GNU_SOURCE
+
+#include <ahr_bench_histogram.h>
+#include <async_http_requests/ahr_http_request_processor.h>
+#include <async_http_requests/private/ahr_logging.h>
+
+#include <curl/curl.h>
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define AHR_LOAD_MAX_STEPS 32U
+#define AHR_LOAD_MAX_HEADERS 16U
+#define AHR_LOAD_LINE_BYTES 8192U
+///
+/// \brief  Most Objects AHR_CreateProcessorWithOptions() accepts.
+///
+#define AHR_LOAD_MAX_OBJECTS 25U
+///
+/// \brief  Latencies above one Hour are recorded as one Hour.
+///
+#define AHR_LOAD_HIGHEST_NS 3600000000000LL
+#define AHR_LOAD_DIGITS 3
+
+typedef AHR_ProcessorStatus_t (*AHR_LoadConfigure_t)(AHR_Processor_t, size_t, const AHR_RequestData_t*, AHR_UserData_t);
+
+typedef struct
+{
+    AHR_LoadConfigure_t configure;
+    char *url;
+    ///
+    /// \brief  NULL-terminated Body, NULL for none.
+    ///
+    char *body;
+} AHR_LoadTarget_t;
+
+typedef struct
+{
+    double rate;
+    double seconds;
+} AHR_LoadStep_t;
+
+typedef struct
+{
+    const char *targets;
+    const char *schedule;
+    bool poisson;
+    AHR_LoadStep_t steps[AHR_LOAD_MAX_STEPS];
+    size_t nsteps;
+    double rate;
+    double duration;
+    size_t processors;
+    size_t objects;
+    size_t threads;
+    AHR_HeaderView_t header[AHR_LOAD_MAX_HEADERS];
+    size_t nheaders;
+    const char *hdr_log;
+    double interval;
+    double drain;
+    uint64_t seed;
+} AHR_LoadArgs_t;
+
+struct AHR_LoadWorker;
+
+///
+/// \brief  A Requestobject of a Processor, the User Data of its Callbacks.
+///
+typedef struct
+{
+    struct AHR_LoadWorker *worker;
+    AHR_Processor_t processor;
+    size_t object;
+    int64_t intended_ns;
+    int64_t sent_ns;
+} AHR_LoadSlot_t;
+
+///
+/// \brief  A Sender Thread, its Processors and what their Callbacks recorded.
+///         The Mutex guards the free Slots, the Histograms and the Counters.
+///
+typedef struct AHR_LoadWorker
+{
+    const AHR_LoadArgs_t *args;
+    const AHR_LoadTarget_t *targets;
+    size_t ntargets;
+    size_t index;
+    int64_t start_ns;
+    int64_t end_ns;
+
+    AHR_Processor_t *processors;
+    size_t nprocessors;
+    AHR_LoadSlot_t *slots;
+    size_t nslots;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    AHR_LoadSlot_t **free;
+    size_t nfree;
+    AHR_BenchHistogram_t intended;
+    AHR_BenchHistogram_t service;
+    uint64_t scheduled;
+    uint64_t sent;
+    uint64_t completed;
+    uint64_t errors;
+    uint64_t non_2xx;
+    uint64_t unsent;
+    uint64_t unfinished;
+    uint64_t bytes;
+    int64_t max_lag_ns;
+} AHR_LoadWorker_t;
+
+///
+/// \brief  Arrival Times of one Sender, its Share is every "nthreads"-th Arrival of the Schedule.
+///
+typedef struct
+{
+    const AHR_LoadArgs_t *args;
+    size_t thread;
+    size_t step;
+    int64_t step_start_ns;
+    uint64_t k;
+    double next_ns;
+    uint64_t random;
+} AHR_LoadArrivals_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_LoadParseArgs(int argc, char **argv, AHR_LoadArgs_t *args);
+static bool AHR_LoadParseSteps(const char *value, AHR_LoadArgs_t *args);
+///
+/// \brief  Read the Targets File.
+/// \returns    Number of Targets, 0 on Error.
+///
+static size_t AHR_LoadReadTargets(const char *path, AHR_LoadTarget_t **targets);
+static void AHR_LoadFreeTargets(AHR_LoadTarget_t *targets, size_t ntargets);
+
+static bool AHR_LoadWorkerCreate(AHR_LoadWorker_t *worker, AHR_Logger_t logger);
+static void AHR_LoadWorkerDestroy(AHR_LoadWorker_t *worker);
+static void* AHR_LoadWorkerRun(void *arg);
+///
+/// \brief  Configure and make the Request of "slot", spins while its Object is still in its Callback.
+///
+static bool AHR_LoadSubmit(AHR_LoadSlot_t *slot, const AHR_LoadTarget_t *target);
+///
+/// \brief  Move the Histograms of all Workers into "intended" and "service" and reset them.
+///
+static void AHR_LoadCollect(AHR_LoadWorker_t *workers, size_t nworkers, AHR_BenchHistogram_t intended, AHR_BenchHistogram_t service);
+
+static void AHR_LoadArrivalsInit(AHR_LoadArrivals_t *arrivals, const AHR_LoadArgs_t *args, size_t thread, int64_t start_ns);
+///
+/// \brief  Intended Send Time of the next Arrival.
+/// \returns    false after the last Step.
+///
+static bool AHR_LoadArrivalsNext(AHR_LoadArrivals_t *arrivals, int64_t *intended_ns);
+
+static void AHR_LoadOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes);
+static void AHR_LoadOnError(void *user_data, size_t object, size_t error_code);
+static AHR_StreamAction_t AHR_LoadOnData(void *user_data, size_t object, const char *data, size_t nbytes);
+static void AHR_LoadOnComplete(void *user_data, size_t object, size_t status_code);
+static void AHR_LoadFinish(AHR_LoadSlot_t *slot, size_t status_code, bool failed);
+
+static void AHR_LoadReportLatency(const char *name, const AHR_BenchHistogram_t histogram);
+static void AHR_LoadLogNothing(void *arg, const char *str);
+static void AHR_LoadLogError(void *arg, const char *str);
+static int64_t AHR_LoadNow(void);
+static void AHR_LoadSleepUntil(int64_t ns);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+int main(int argc, char **argv)
+{
+    AHR_LoadArgs_t args = {
+        .targets = NULL,
+        .schedule = "constant",
+        .poisson = false,
+        .nsteps = 0,
+        .rate = 1000.0,
+        .duration = 10.0,
+        .processors = 1U,
+        .objects = AHR_LOAD_MAX_OBJECTS,
+        .threads = 1U,
+        .nheaders = 0,
+        .hdr_log = NULL,
+        .interval = 1.0,
+        .drain = 5.0,
+        .seed = 1U
+    };
+    if(!AHR_LoadParseArgs(argc, argv, &args))
+    {
+        fprintf(
+            stderr,
+            "usage: %s --targets FILE [--schedule constant|poisson|step] [--rate N] [--duration SECONDS]\n"
+            "          [--steps RATE:SECONDS,...] [--processors N] [--objects N] [--threads N]\n"
+            "          [--header 'Name: Value'] [--hdr-log FILE] [--interval SECONDS] [--drain SECONDS] [--seed N]\n",
+            argv[0]
+        );
+        return 2;
+    }
+    AHR_LoadTarget_t *targets = NULL;
+    const size_t ntargets = AHR_LoadReadTargets(args.targets, &targets);
+    if(0 == ntargets)
+    {
+        return 2;
+    }
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    int rc = 1;
+    FILE *log = NULL;
+    AHR_Logger_t logger = AHR_CreateLogger(NULL, AHR_LoadLogNothing, AHR_LoadLogNothing, AHR_LoadLogError);
+    AHR_LoadWorker_t *workers = calloc(args.threads, sizeof(AHR_LoadWorker_t));
+    AHR_BenchHistogram_t interval_intended = AHR_BenchHistogramCreate(AHR_LOAD_HIGHEST_NS, AHR_LOAD_DIGITS);
+    AHR_BenchHistogram_t interval_service = AHR_BenchHistogramCreate(AHR_LOAD_HIGHEST_NS, AHR_LOAD_DIGITS);
+    AHR_BenchHistogram_t intended = AHR_BenchHistogramCreate(AHR_LOAD_HIGHEST_NS, AHR_LOAD_DIGITS);
+    AHR_BenchHistogram_t service = AHR_BenchHistogramCreate(AHR_LOAD_HIGHEST_NS, AHR_LOAD_DIGITS);
+    size_t nworkers = 0;
+    size_t nstarted = 0;
+    if(!logger || !workers || !interval_intended || !interval_service || !intended || !service)
+    {
+        goto end;
+    }
+    if(args.hdr_log)
+    {
+        log = fopen(args.hdr_log, "w");
+        if(!log)
+        {
+            perror(args.hdr_log);
+            goto end;
+        }
+    }
+
+    double seconds = 0.0;
+    for(size_t i=0;i<args.nsteps;++i)
+    {
+        seconds += args.steps[i].seconds;
+    }
+    //
+    // Give all Senders Time to start before the first Arrival.
+    //
+    const int64_t start_ns = AHR_LoadNow() + 100000000LL;
+    const int64_t end_ns = start_ns + (int64_t)(1e9 * seconds);
+    for(;nworkers<args.threads;++nworkers)
+    {
+        AHR_LoadWorker_t *worker = &workers[nworkers];
+        worker->args = &args;
+        worker->targets = targets;
+        worker->ntargets = ntargets;
+        worker->index = nworkers;
+        worker->start_ns = start_ns;
+        worker->end_ns = end_ns;
+        if(!AHR_LoadWorkerCreate(worker, logger))
+        {
+            fprintf(stderr, "unable to create the processors of thread %zu\n", nworkers);
+            AHR_LoadWorkerDestroy(worker);
+            goto stop;
+        }
+    }
+    for(;nstarted<nworkers;++nstarted)
+    {
+        if(0 != pthread_create(&workers[nstarted].thread, NULL, AHR_LoadWorkerRun, &workers[nstarted]))
+        {
+            goto stop;
+        }
+    }
+
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    const double wall_start = (double)wall.tv_sec + 1e-9 * (double)wall.tv_nsec + 1e-9 * (double)(start_ns - AHR_LoadNow());
+    if(log)
+    {
+        AHR_BenchHistogramLogHeader(log, wall_start);
+    }
+    //
+    // Every Interval, until the Senders are done: collect, log and report.
+    //
+    const int64_t interval_ns = (int64_t)(1e9 * args.interval);
+    const int64_t deadline_ns = end_ns + (int64_t)(1e9 * args.drain) + interval_ns;
+    for(int64_t at=start_ns;at<deadline_ns;)
+    {
+        at += interval_ns;
+        AHR_LoadSleepUntil(at);
+        AHR_LoadCollect(workers, nworkers, interval_intended, interval_service);
+        if(log)
+        {
+            const double offset = 1e-9 * (double)(at - interval_ns - start_ns);
+            AHR_BenchHistogramLogInterval(log, "intended", offset, args.interval, interval_intended);
+            AHR_BenchHistogramLogInterval(log, "service", offset, args.interval, interval_service);
+            fflush(log);
+        }
+        fprintf(
+            stderr,
+            "%8.1fs %9.0f req/s  p50 %10.1f us  p99 %10.1f us  max %10.1f us  (service p99 %10.1f us)\n",
+            1e-9 * (double)(at - start_ns),
+            (double)AHR_BenchHistogramCount(interval_intended) / args.interval,
+            1e-3 * (double)AHR_BenchHistogramPercentile(interval_intended, 50.0),
+            1e-3 * (double)AHR_BenchHistogramPercentile(interval_intended, 99.0),
+            1e-3 * (double)AHR_BenchHistogramMax(interval_intended),
+            1e-3 * (double)AHR_BenchHistogramPercentile(interval_service, 99.0)
+        );
+        AHR_BenchHistogramAdd(intended, interval_intended);
+        AHR_BenchHistogramAdd(service, interval_service);
+        AHR_BenchHistogramReset(interval_intended);
+        AHR_BenchHistogramReset(interval_service);
+        //
+        // Done once every Sender drained its Requests.
+        //
+        bool done = at >= end_ns;
+        for(size_t i=0;done && i<nworkers;++i)
+        {
+            pthread_mutex_lock(&workers[i].mutex);
+            done = workers[i].nfree == workers[i].nslots && workers[i].scheduled == workers[i].sent + workers[i].unsent;
+            pthread_mutex_unlock(&workers[i].mutex);
+        }
+        if(done)
+        {
+            break;
+        }
+    }
+    rc = 0;
+
+    stop:
+    for(size_t i=0;i<nstarted;++i)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+    for(size_t i=0;i<nworkers;++i)
+    {
+        for(size_t p=0;p<workers[i].nprocessors;++p)
+        {
+            AHR_ProcessorStop(workers[i].processors[p]);
+        }
+    }
+    AHR_LoadCollect(workers, nworkers, interval_intended, interval_service);
+    AHR_BenchHistogramAdd(intended, interval_intended);
+    AHR_BenchHistogramAdd(service, interval_service);
+    if(0 == rc)
+    {
+        AHR_LoadWorker_t total;
+        memset(&total, 0, sizeof(total));
+        for(size_t i=0;i<nworkers;++i)
+        {
+            total.scheduled += workers[i].scheduled;
+            total.sent += workers[i].sent;
+            total.completed += workers[i].completed;
+            total.errors += workers[i].errors;
+            total.non_2xx += workers[i].non_2xx;
+            total.unsent += workers[i].unsent;
+            total.unfinished += workers[i].unfinished;
+            total.bytes += workers[i].bytes;
+            total.max_lag_ns = workers[i].max_lag_ns > total.max_lag_ns ? workers[i].max_lag_ns : total.max_lag_ns;
+        }
+        printf(
+            "{\n  \"tool\": \"ahr_load\",\n  \"curl\": \"%s\",\n  \"schedule\": \"%s\",\n  \"targets\": %zu,\n"
+            "  \"processors\": %zu,\n  \"objects\": %zu,\n  \"threads\": %zu,\n  \"seconds\": %.3f,\n"
+            "  \"scheduled\": %llu,\n  \"sent\": %llu,\n  \"completed\": %llu,\n  \"errors\": %llu,\n"
+            "  \"non_2xx\": %llu,\n  \"unsent\": %llu,\n  \"unfinished\": %llu,\n  \"response_bytes\": %llu,\n"
+            "  \"offered_per_second\": %.1f,\n  \"completed_per_second\": %.1f,\n  \"max_send_lag_us\": %.1f,\n",
+            curl_version_info(CURLVERSION_NOW)->version,
+            args.schedule,
+            ntargets,
+            args.processors,
+            args.objects,
+            args.threads,
+            seconds,
+            (unsigned long long)total.scheduled,
+            (unsigned long long)total.sent,
+            (unsigned long long)total.completed,
+            (unsigned long long)total.errors,
+            (unsigned long long)total.non_2xx,
+            (unsigned long long)total.unsent,
+            (unsigned long long)total.unfinished,
+            (unsigned long long)total.bytes,
+            (double)total.scheduled / seconds,
+            (double)total.completed / seconds,
+            1e-3 * (double)total.max_lag_ns
+        );
+        AHR_LoadReportLatency("latency_us", intended);
+        printf(",\n");
+        AHR_LoadReportLatency("service_time_us", service);
+        printf("\n}\n");
+    }
+
+    end:
+    for(size_t i=0;i<nworkers;++i)
+    {
+        AHR_LoadWorkerDestroy(&workers[i]);
+    }
+    if(log)
+    {
+        fclose(log);
+    }
+    AHR_BenchHistogramDestroy(&service);
+    AHR_BenchHistogramDestroy(&intended);
+    AHR_BenchHistogramDestroy(&interval_service);
+    AHR_BenchHistogramDestroy(&interval_intended);
+    free(workers);
+    if(logger)
+    {
+        AHR_DestroyLogger(&logger);
+    }
+    AHR_LoadFreeTargets(targets, ntargets);
+    curl_global_cleanup();
+    return rc;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_LoadParseArgs(int argc, char **argv, AHR_LoadArgs_t *args)
+{
+    for(int i=1;i+1<argc;i+=2)
+    {
+        const char *name = argv[i];
+        char *value = argv[i + 1];
+        if(0 == strcmp(name, "--targets"))
+        {
+            args->targets = value;
+        }
+        else if(0 == strcmp(name, "--schedule"))
+        {
+            args->schedule = value;
+        }
+        else if(0 == strcmp(name, "--rate"))
+        {
+            args->rate = strtod(value, NULL);
+        }
+        else if(0 == strcmp(name, "--duration"))
+        {
+            args->duration = strtod(value, NULL);
+        }
+        else if(0 == strcmp(name, "--steps"))
+        {
+            if(!AHR_LoadParseSteps(value, args))
+            {
+                return false;
+            }
+        }
+        else if(0 == strcmp(name, "--processors"))
+        {
+            args->processors = strtoull(value, NULL, 10);
+        }
+        else if(0 == strcmp(name, "--objects"))
+        {
+            args->objects = strtoull(value, NULL, 10);
+        }
+        else if(0 == strcmp(name, "--threads"))
+        {
+            args->threads = strtoull(value, NULL, 10);
+        }
+        else if(0 == strcmp(name, "--header"))
+        {
+            //
+            // The View points into argv, which lives as long as the Process.
+            //
+            const char *colon = strchr(value, ':');
+            if(!colon || AHR_LOAD_MAX_HEADERS == args->nheaders)
+            {
+                return false;
+            }
+            const char *v = colon + 1;
+            while(' ' == *v)
+            {
+                ++v;
+            }
+            args->header[args->nheaders++] = (AHR_HeaderView_t){
+                .name = value,
+                .name_len = (size_t)(colon - value),
+                .value = v,
+                .value_len = strlen(v) // flawfinder: ignore
+            };
+        }
+        else if(0 == strcmp(name, "--hdr-log"))
+        {
+            args->hdr_log = value;
+        }
+        else if(0 == strcmp(name, "--interval"))
+        {
+            args->interval = strtod(value, NULL);
+        }
+        else if(0 == strcmp(name, "--drain"))
+        {
+            args->drain = strtod(value, NULL);
+        }
+        else if(0 == strcmp(name, "--seed"))
+        {
+            args->seed = strtoull(value, NULL, 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if(0 == argc % 2)
+    {
+        return false;
+    }
+    if(0 == strcmp(args->schedule, "step"))
+    {
+        if(0 == args->nsteps)
+        {
+            return false;
+        }
+    }
+    else if(0 == strcmp(args->schedule, "constant") || 0 == strcmp(args->schedule, "poisson"))
+    {
+        args->poisson = 0 == strcmp(args->schedule, "poisson");
+        args->steps[0] = (AHR_LoadStep_t){.rate = args->rate, .seconds = args->duration};
+        args->nsteps = 1;
+    }
+    else
+    {
+        return false;
+    }
+    return NULL != args->targets
+        && args->rate > 0.0
+        && args->duration > 0.0
+        && args->threads > 0
+        && args->processors >= args->threads
+        && args->objects > 0 && args->objects <= AHR_LOAD_MAX_OBJECTS
+        && args->interval > 0.0
+        && args->drain >= 0.0;
+}
+
+static bool AHR_LoadParseSteps(const char *value, AHR_LoadArgs_t *args)
+{
+    args->nsteps = 0;
+    while(*value)
+    {
+        char *end = NULL;
+        const double rate = strtod(value, &end);
+        if(end == value || ':' != *end || rate < 0.0 || AHR_LOAD_MAX_STEPS == args->nsteps)
+        {
+            return false;
+        }
+        value = end + 1;
+        const double seconds = strtod(value, &end);
+        if(end == value || seconds <= 0.0 || (',' != *end && '\0' != *end))
+        {
+            return false;
+        }
+        args->steps[args->nsteps++] = (AHR_LoadStep_t){.rate = rate, .seconds = seconds};
+        value = *end ? end + 1 : end;
+    }
+    return args->nsteps > 0;
+}
+
+static size_t AHR_LoadReadTargets(const char *path, AHR_LoadTarget_t **targets)
+{
+    FILE *file = fopen(path, "r");
+    if(!file)
+    {
+        perror(path);
+        return 0;
+    }
+    char line[AHR_LOAD_LINE_BYTES]; // flawfinder: ignore
+    size_t n = 0;
+    size_t capacity = 0;
+    size_t number = 0;
+    bool ok = true;
+    while(ok && fgets(line, sizeof(line), file))
+    {
+        ++number;
+        line[strcspn(line, "\r\n")] = '\0';
+        if('\0' == line[0] || '#' == line[0])
+        {
+            continue;
+        }
+        char *url = strchr(line, ' ');
+        if(!url)
+        {
+            fprintf(stderr, "%s:%zu: expected \"METHOD URL [BODY]\"\n", path, number);
+            ok = false;
+            break;
+        }
+        *url++ = '\0';
+        char *body = strchr(url, ' ');
+        if(body)
+        {
+            *body++ = '\0';
+        }
+        const AHR_LoadConfigure_t configure = 0 == strcmp(line, "GET") ? AHR_ProcessorGet
+            : 0 == strcmp(line, "POST") ? AHR_ProcessorPost
+            : 0 == strcmp(line, "PUT") ? AHR_ProcessorPut
+            : 0 == strcmp(line, "DELETE") ? AHR_ProcessorDelete
+            : NULL;
+        if(!configure)
+        {
+            fprintf(stderr, "%s:%zu: unknown method \"%s\"\n", path, number, line);
+            ok = false;
+            break;
+        }
+        if(n == capacity)
+        {
+            capacity = 0 == capacity ? 16U : 2U * capacity;
+            AHR_LoadTarget_t *grown = realloc(*targets, capacity * sizeof(AHR_LoadTarget_t));
+            if(!grown)
+            {
+                ok = false;
+                break;
+            }
+            *targets = grown;
+        }
+        (*targets)[n] = (AHR_LoadTarget_t){
+            .configure = configure,
+            .url = strdup(url),
+            .body = body ? strdup(body) : NULL
+        };
+        ++n;
+        ok = NULL != (*targets)[n - 1U].url && (!body || NULL != (*targets)[n - 1U].body);
+    }
+    fclose(file);
+    if(ok && 0 == n)
+    {
+        fprintf(stderr, "%s: no targets\n", path);
+    }
+    if(!ok || 0 == n)
+    {
+        AHR_LoadFreeTargets(*targets, n);
+        *targets = NULL;
+        return 0;
+    }
+    return n;
+}
+
+static void AHR_LoadFreeTargets(AHR_LoadTarget_t *targets, size_t ntargets)
+{
+    for(size_t i=0;targets && i<ntargets;++i)
+    {
+        free(targets[i].url);
+        free(targets[i].body);
+    }
+    free(targets);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_LoadWorkerCreate(AHR_LoadWorker_t *worker, AHR_Logger_t logger)
+{
+    const AHR_LoadArgs_t *args = worker->args;
+    //
+    // Processor i belongs to Thread i % threads.
+    //
+    worker->nprocessors = args->processors / args->threads + (worker->index < args->processors % args->threads ? 1U : 0U);
+    worker->nslots = worker->nprocessors * args->objects;
+    worker->processors = calloc(worker->nprocessors, sizeof(AHR_Processor_t));
+    worker->slots = calloc(worker->nslots, sizeof(AHR_LoadSlot_t));
+    worker->free = calloc(worker->nslots, sizeof(AHR_LoadSlot_t*));
+    worker->intended = AHR_BenchHistogramCreate(AHR_LOAD_HIGHEST_NS, AHR_LOAD_DIGITS);
+    worker->service = AHR_BenchHistogramCreate(AHR_LOAD_HIGHEST_NS, AHR_LOAD_DIGITS);
+    //
+    // Deadlines are taken from the monotonic Clock like the Schedule.
+    //
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&worker->mutex, NULL);
+    pthread_cond_init(&worker->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    if(!worker->processors || !worker->slots || !worker->free || !worker->intended || !worker->service)
+    {
+        return false;
+    }
+    const AHR_ProcessorOptions_t options = {.max_objects = args->objects};
+    for(size_t p=0;p<worker->nprocessors;++p)
+    {
+        worker->processors[p] = AHR_CreateProcessorWithOptions(&options, logger);
+        if(!worker->processors[p] || !AHR_ProcessorStart(worker->processors[p]))
+        {
+            return false;
+        }
+        for(size_t o=0;o<args->objects;++o)
+        {
+            AHR_LoadSlot_t *slot = &worker->slots[p * args->objects + o];
+            *slot = (AHR_LoadSlot_t){.worker = worker, .processor = worker->processors[p], .object = o};
+        }
+    }
+    //
+    // Hand out the Objects of all Processors in Turn, so the Load spreads over them.
+    //
+    for(size_t o=0;o<args->objects;++o)
+    {
+        for(size_t p=0;p<worker->nprocessors;++p)
+        {
+            worker->free[worker->nslots - 1U - worker->nfree++] = &worker->slots[p * args->objects + o];
+        }
+    }
+    return true;
+}
+
+static void AHR_LoadWorkerDestroy(AHR_LoadWorker_t *worker)
+{
+    for(size_t p=0;worker->processors && p<worker->nprocessors;++p)
+    {
+        if(worker->processors[p])
+        {
+            AHR_ProcessorStop(worker->processors[p]);
+            AHR_DestroyProcessor(&worker->processors[p]);
+        }
+    }
+    if(worker->service)
+    {
+        AHR_BenchHistogramDestroy(&worker->service);
+    }
+    if(worker->intended)
+    {
+        AHR_BenchHistogramDestroy(&worker->intended);
+    }
+    pthread_cond_destroy(&worker->cond);
+    pthread_mutex_destroy(&worker->mutex);
+    free(worker->free);
+    free(worker->slots);
+    free(worker->processors);
+    worker->free = NULL;
+    worker->slots = NULL;
+    worker->processors = NULL;
+}
+
+static void* AHR_LoadWorkerRun(void *arg)
+{
+    AHR_LoadWorker_t *worker = (AHR_LoadWorker_t*)arg;
+    const AHR_LoadArgs_t *args = worker->args;
+    //
+    // Past this Point nothing is sent anymore, Requests still waiting for an Object count as unsent.
+    //
+    const int64_t stop_ns = worker->end_ns + (int64_t)(1e9 * args->drain);
+    AHR_LoadArrivals_t arrivals;
+    AHR_LoadArrivalsInit(&arrivals, args, worker->index, worker->start_ns);
+    size_t next_target = worker->index;
+    int64_t intended_ns = 0;
+    while(AHR_LoadArrivalsNext(&arrivals, &intended_ns))
+    {
+        AHR_LoadSleepUntil(intended_ns);
+        pthread_mutex_lock(&worker->mutex);
+        ++worker->scheduled;
+        bool expired = false;
+        while(0 == worker->nfree && !expired)
+        {
+            const struct timespec until = {.tv_sec = (time_t)(stop_ns / 1000000000LL), .tv_nsec = (long)(stop_ns % 1000000000LL)};
+            expired = ETIMEDOUT == pthread_cond_timedwait(&worker->cond, &worker->mutex, &until);
+        }
+        if(expired || AHR_LoadNow() >= stop_ns)
+        {
+            ++worker->unsent;
+            pthread_mutex_unlock(&worker->mutex);
+            continue;
+        }
+        AHR_LoadSlot_t *slot = worker->free[--worker->nfree];
+        const int64_t lag_ns = AHR_LoadNow() - intended_ns;
+        worker->max_lag_ns = lag_ns > worker->max_lag_ns ? lag_ns : worker->max_lag_ns;
+        ++worker->sent;
+        pthread_mutex_unlock(&worker->mutex);
+
+        slot->intended_ns = intended_ns;
+        const AHR_LoadTarget_t *target = &worker->targets[next_target % worker->ntargets];
+        next_target += args->threads;
+        if(!AHR_LoadSubmit(slot, target))
+        {
+            pthread_mutex_lock(&worker->mutex);
+            ++worker->errors;
+            worker->free[worker->nfree++] = slot;
+            pthread_mutex_unlock(&worker->mutex);
+        }
+    }
+    //
+    // Wait for the Requests in Flight, those which do not finish in Time count as unfinished.
+    //
+    pthread_mutex_lock(&worker->mutex);
+    const int64_t drain_ns = (AHR_LoadNow() > worker->end_ns ? AHR_LoadNow() : worker->end_ns) + (int64_t)(1e9 * args->drain);
+    const struct timespec until = {.tv_sec = (time_t)(drain_ns / 1000000000LL), .tv_nsec = (long)(drain_ns % 1000000000LL)};
+    while(worker->nfree < worker->nslots)
+    {
+        if(ETIMEDOUT == pthread_cond_timedwait(&worker->cond, &worker->mutex, &until))
+        {
+            worker->unfinished = worker->nslots - worker->nfree;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&worker->mutex);
+    return NULL;
+}
+
+static bool AHR_LoadSubmit(AHR_LoadSlot_t *slot, const AHR_LoadTarget_t *target)
+{
+    const AHR_LoadArgs_t *args = slot->worker->args;
+    AHR_RequestData_t request_data;
+    memset(&request_data, 0, sizeof(request_data));
+    request_data.url = target->url;
+    request_data.body = target->body;
+    request_data.header = args->header;
+    request_data.nheaders = args->nheaders;
+    //
+    // Bodies are only counted, streaming them avoids the Buffer Limits of the Processor.
+    //
+    const AHR_UserData_t user_data = {
+        .data = slot,
+        .on_success = AHR_LoadOnSuccess,
+        .on_error = AHR_LoadOnError,
+        .on_data = AHR_LoadOnData,
+        .on_complete = AHR_LoadOnComplete
+    };
+    AHR_ProcessorStatus_t status = AHR_PROC_OBJECT_BUSY;
+    while(AHR_PROC_OBJECT_BUSY == status)
+    {
+        status = target->configure(slot->processor, slot->object, &request_data, user_data);
+        if(AHR_PROC_OBJECT_BUSY == status)
+        {
+            sched_yield();
+        }
+    }
+    slot->sent_ns = AHR_LoadNow();
+    if(AHR_PROC_OK != status || AHR_PROC_OK != AHR_ProcessorMakeRequest(slot->processor, slot->object))
+    {
+        fprintf(stderr, "unable to request %s with object %zu\n", target->url, slot->object);
+        return false;
+    }
+    return true;
+}
+
+static void AHR_LoadCollect(AHR_LoadWorker_t *workers, size_t nworkers, AHR_BenchHistogram_t intended, AHR_BenchHistogram_t service)
+{
+    for(size_t i=0;i<nworkers;++i)
+    {
+        pthread_mutex_lock(&workers[i].mutex);
+        AHR_BenchHistogramAdd(intended, workers[i].intended);
+        AHR_BenchHistogramAdd(service, workers[i].service);
+        AHR_BenchHistogramReset(workers[i].intended);
+        AHR_BenchHistogramReset(workers[i].service);
+        pthread_mutex_unlock(&workers[i].mutex);
+    }
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_LoadArrivalsInit(AHR_LoadArrivals_t *arrivals, const AHR_LoadArgs_t *args, size_t thread, int64_t start_ns)
+{
+    *arrivals = (AHR_LoadArrivals_t){
+        .args = args,
+        .thread = thread,
+        .step = 0,
+        .step_start_ns = start_ns,
+        .k = 0,
+        .next_ns = (double)start_ns,
+        .random = args->seed * 0x9E3779B97F4A7C15ULL + thread + 1U
+    };
+}
+
+static bool AHR_LoadArrivalsNext(AHR_LoadArrivals_t *arrivals, int64_t *intended_ns)
+{
+    const AHR_LoadArgs_t *args = arrivals->args;
+    const double threads = (double)args->threads;
+    while(arrivals->step < args->nsteps)
+    {
+        const AHR_LoadStep_t *step = &args->steps[arrivals->step];
+        const double step_end_ns = (double)arrivals->step_start_ns + 1e9 * step->seconds;
+        double next_ns = step_end_ns;
+        if(step->rate > 0.0 && args->poisson)
+        {
+            //
+            // The Senders are independent Poisson Processes of rate / threads, together one of "rate".
+            //
+            arrivals->random ^= arrivals->random << 13;
+            arrivals->random ^= arrivals->random >> 7;
+            arrivals->random ^= arrivals->random << 17;
+            const double u = ((double)(arrivals->random >> 11) + 1.0) / 9007199254740993.0;
+            next_ns = arrivals->next_ns - log(u) * 1e9 * threads / step->rate;
+            arrivals->next_ns = next_ns;
+        }
+        else if(step->rate > 0.0)
+        {
+            //
+            // Sender t takes the Arrivals t, t + threads, t + 2 * threads, ... of the Step.
+            //
+            next_ns = (double)arrivals->step_start_ns
+                + 1e9 * ((double)arrivals->k * threads + (double)arrivals->thread) / step->rate;
+            ++arrivals->k;
+        }
+        if(next_ns < step_end_ns)
+        {
+            *intended_ns = (int64_t)next_ns;
+            return true;
+        }
+        //
+        // Exponential Gaps are memoryless, the next Step starts its own from its Begin.
+        //
+        ++arrivals->step;
+        arrivals->step_start_ns = (int64_t)step_end_ns;
+        arrivals->next_ns = step_end_ns;
+        arrivals->k = 0;
+    }
+    return false;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_LoadOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes)
+{
+    (void)object;
+    (void)buffer;
+    AHR_LoadSlot_t *slot = (AHR_LoadSlot_t*)user_data;
+    pthread_mutex_lock(&slot->worker->mutex);
+    slot->worker->bytes += nbytes;
+    pthread_mutex_unlock(&slot->worker->mutex);
+    AHR_LoadFinish(slot, status_code, false);
+}
+
+static void AHR_LoadOnError(void *user_data, size_t object, size_t error_code)
+{
+    (void)object;
+    (void)error_code;
+    AHR_LoadFinish((AHR_LoadSlot_t*)user_data, 0, true);
+}
+
+static AHR_StreamAction_t AHR_LoadOnData(void *user_data, size_t object, const char *data, size_t nbytes)
+{
+    (void)object;
+    (void)data;
+    AHR_LoadSlot_t *slot = (AHR_LoadSlot_t*)user_data;
+    pthread_mutex_lock(&slot->worker->mutex);
+    slot->worker->bytes += nbytes;
+    pthread_mutex_unlock(&slot->worker->mutex);
+    return AHR_STREAM_CONTINUE;
+}
+
+static void AHR_LoadOnComplete(void *user_data, size_t object, size_t status_code)
+{
+    (void)object;
+    AHR_LoadFinish((AHR_LoadSlot_t*)user_data, status_code, false);
+}
+
+static void AHR_LoadFinish(AHR_LoadSlot_t *slot, size_t status_code, bool failed)
+{
+    const int64_t now = AHR_LoadNow();
+    AHR_LoadWorker_t *worker = slot->worker;
+    pthread_mutex_lock(&worker->mutex);
+    if(failed)
+    {
+        ++worker->errors;
+    }
+    else
+    {
+        //
+        // Late Requests and Failures are recorded alike, a Failure is no faster Response.
+        //
+        ++worker->completed;
+        worker->non_2xx += status_code < 200U || status_code > 299U ? 1U : 0U;
+    }
+    AHR_BenchHistogramRecord(worker->intended, now - slot->intended_ns);
+    AHR_BenchHistogramRecord(worker->service, now - slot->sent_ns);
+    worker->free[worker->nfree++] = slot;
+    pthread_cond_signal(&worker->cond);
+    pthread_mutex_unlock(&worker->mutex);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_LoadReportLatency(const char *name, const AHR_BenchHistogram_t histogram)
+{
+    printf(
+        "  \"%s\": {\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"p9999\": %.1f, \"max\": %.1f}",
+        name,
+        1e-3 * (double)AHR_BenchHistogramPercentile(histogram, 50.0),
+        1e-3 * (double)AHR_BenchHistogramPercentile(histogram, 90.0),
+        1e-3 * (double)AHR_BenchHistogramPercentile(histogram, 99.0),
+        1e-3 * (double)AHR_BenchHistogramPercentile(histogram, 99.9),
+        1e-3 * (double)AHR_BenchHistogramPercentile(histogram, 99.99),
+        1e-3 * (double)AHR_BenchHistogramMax(histogram)
+    );
+}
+
+static void AHR_LoadLogNothing(void *arg, const char *str)
+{
+    (void)arg;
+    (void)str;
+}
+
+static void AHR_LoadLogError(void *arg, const char *str)
+{
+    (void)arg;
+    fprintf(stderr, "%s\n", str);
+}
+
+static int64_t AHR_LoadNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000LL + (int64_t)now.tv_nsec;
+}
+
+static void AHR_LoadSleepUntil(int64_t ns)
+{
+    const struct timespec until = {.tv_sec = (time_t)(ns / 1000000000LL), .tv_nsec = (long)(ns % 1000000000LL)};
+    while(EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL))
+    {
+    }
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
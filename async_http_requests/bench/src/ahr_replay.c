@@ -0,0 +1,851 @@
+///
+/// \brief  Replay a Traffic Recording (AHR_ProcessorOptions_t::record_path) through the Processor.
+///         Every Record is sent again at its recorded Offset, divided by "--speed": 1 replays in Real Time,
+///         10 ten Times faster. The Request gets its recorded Method, URL Template ("{id}" becomes a Number),
+///         Header Count and Size and Body Size, the Contents are Filler.
+///
+///         By Default the Target is an in-process Stub (ahr_fault_server.h, Route "* shape=1") which answers
+///         each Request with the recorded Status, Header and Body Size after the recorded Server Time, so the
+///         Concurrency of the Recording builds up again. "--target URL" replays against another Stub instead,
+///         f.e. "ahr_fault_server --route '* shape=1'", "--server-time none" leaves the Server Time out.
+///
+///         Latency is measured from the intended Send Time like in ahr_load, next to the recorded Latency.
+///         A Summary is written to stdout as JSON. "--dump 1" prints the Records as Text instead.
+///
+/// \example    ahr_replay --trace capture.rec --speed 4 --processors 4
+///
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define _GNU_SOURCE
+
+#include <ahr_bench_histogram.h>
+#include <ahr_fault_server.h>
+#include <async_http_requests/ahr_http_request_processor.h>
+#include <async_http_requests/ahr_record.h>
+#include <async_http_requests/private/ahr_logging.h>
+
+#include <curl/curl.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Most Objects AHR_CreateProcessorWithOptions() accepts.
+///
+#define AHR_REPLAY_MAX_OBJECTS 25U
+#define AHR_REPLAY_URL_BYTES 4096U
+///
+/// \brief  Recorded Request Headers are replayed up to this Count and Size.
+///
+#define AHR_REPLAY_MAX_HEADERS 32U
+#define AHR_REPLAY_MAX_HEADER_BYTES 8192U
+#define AHR_REPLAY_SHAPE_BYTES 128U
+///
+/// \brief  Head of a Stub Response without Padding, subtracted from the recorded Response Header Bytes.
+///
+#define AHR_REPLAY_STUB_HEAD_BYTES 96U
+#define AHR_REPLAY_FILL_BYTES 16384U
+///
+/// \brief  Latencies above one Hour are recorded as one Hour.
+///
+#define AHR_REPLAY_HIGHEST_NS 3600000000000LL
+#define AHR_REPLAY_DIGITS 3
+
+typedef AHR_ProcessorStatus_t (*AHR_ReplayConfigure_t)(AHR_Processor_t, size_t, const AHR_RequestData_t*, AHR_UserData_t);
+
+typedef struct
+{
+    const char *trace;
+    const char *target;
+    double speed;
+    bool server_time;
+    size_t processors;
+    size_t objects;
+    double drain;
+    bool dump;
+} AHR_ReplayArgs_t;
+
+struct AHR_Replay;
+
+///
+/// \brief  A Requestobject of a Processor, the User Data of its Callbacks and the User of its Body Provider.
+///
+typedef struct
+{
+    struct AHR_Replay *replay;
+    AHR_Processor_t processor;
+    size_t object;
+    const AHR_Record_t *record;
+    int64_t intended_ns;
+    int64_t sent_ns;
+    uint64_t body_sent;
+    char url[AHR_REPLAY_URL_BYTES]; // flawfinder: ignore
+} AHR_ReplaySlot_t;
+
+///
+/// \brief  The Processors and what their Callbacks recorded. The Mutex guards the free Slots,
+///         the Histograms and the Counters.
+///
+typedef struct AHR_Replay
+{
+    const AHR_ReplayArgs_t *args;
+    const char *base_url;
+    AHR_Processor_t *processors;
+    size_t nprocessors;
+    AHR_ReplaySlot_t *slots;
+    size_t nslots;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    AHR_ReplaySlot_t **free;
+    size_t nfree;
+    AHR_BenchHistogram_t intended;
+    AHR_BenchHistogram_t service;
+    uint64_t sent;
+    uint64_t completed;
+    uint64_t errors;
+    uint64_t status_mismatches;
+    uint64_t unsent;
+    uint64_t unfinished;
+    uint64_t request_bytes;
+    uint64_t response_bytes;
+    int64_t max_lag_ns;
+} AHR_Replay_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_ReplayParseArgs(int argc, char **argv, AHR_ReplayArgs_t *args);
+///
+/// \brief  Read all Records, sorted by their Submit Time. The Templates stay with "reader".
+/// \returns    Number of Records, 0 on Error.
+///
+static size_t AHR_ReplayReadTrace(AHR_RecordReader_t reader, AHR_Record_t **records);
+static int AHR_ReplayCompareSubmit(const void *a, const void *b);
+///
+/// \brief  One tab separated Line per Record in Submit Order.
+///
+static void AHR_ReplayDump(const AHR_Record_t *records, size_t nrecords);
+
+static bool AHR_ReplayCreate(AHR_Replay_t *replay, AHR_Logger_t logger);
+static void AHR_ReplayDestroy(AHR_Replay_t *replay);
+///
+/// \brief  Configure and make the Request of "slot", spins while its Object is still in its Callback.
+///
+static bool AHR_ReplaySubmit(AHR_ReplaySlot_t *slot, uint64_t sequence);
+///
+/// \brief  Base URL followed by the Template, "{id}" is replaced by "sequence".
+///
+static void AHR_ReplayExpandUrl(AHR_ReplaySlot_t *slot, uint64_t sequence);
+
+static size_t AHR_ReplayBodyRead(void *user, char *buffer, size_t nbytes);
+static bool AHR_ReplayBodyRewind(void *user);
+static void AHR_ReplayOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes);
+static void AHR_ReplayOnError(void *user_data, size_t object, size_t error_code);
+static AHR_StreamAction_t AHR_ReplayOnData(void *user_data, size_t object, const char *data, size_t nbytes);
+static void AHR_ReplayOnComplete(void *user_data, size_t object, size_t status_code);
+static void AHR_ReplayFinish(AHR_ReplaySlot_t *slot, size_t status_code, bool failed);
+
+static void AHR_ReplayReportLatency(const char *name, const AHR_BenchHistogram_t histogram);
+static void AHR_ReplayLogNothing(void *arg, const char *str);
+static void AHR_ReplayLogError(void *arg, const char *str);
+static int64_t AHR_ReplayNow(void);
+static void AHR_ReplaySleepUntil(int64_t ns);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Header Values and Bodies are cut from this Filler.
+///
+static char ahr_replay_fill[AHR_REPLAY_FILL_BYTES]; // flawfinder: ignore
+static char ahr_replay_header_names[AHR_REPLAY_MAX_HEADERS][16]; // flawfinder: ignore
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+int main(int argc, char **argv)
+{
+    AHR_ReplayArgs_t args = {
+        .trace = NULL,
+        .target = NULL,
+        .speed = 1.0,
+        .server_time = true,
+        .processors = 1U,
+        .objects = AHR_REPLAY_MAX_OBJECTS,
+        .drain = 5.0,
+        .dump = false
+    };
+    if(!AHR_ReplayParseArgs(argc, argv, &args))
+    {
+        fprintf(
+            stderr,
+            "usage: %s --trace FILE [--speed FACTOR] [--target URL] [--server-time recorded|none]\n"
+            "          [--processors N] [--objects N] [--drain SECONDS] [--dump 0|1]\n",
+            argv[0]
+        );
+        return 2;
+    }
+    AHR_RecordReader_t reader = AHR_RecordReaderOpen(args.trace);
+    if(!reader)
+    {
+        fprintf(stderr, "%s: not a recording\n", args.trace);
+        return 2;
+    }
+    AHR_Record_t *records = NULL;
+    const size_t nrecords = AHR_ReplayReadTrace(reader, &records);
+    if(0 == nrecords)
+    {
+        AHR_RecordReaderClose(&reader);
+        return 2;
+    }
+    if(args.dump)
+    {
+        AHR_ReplayDump(records, nrecords);
+        free(records);
+        AHR_RecordReaderClose(&reader);
+        return 0;
+    }
+    memset(ahr_replay_fill, 'r', sizeof(ahr_replay_fill));
+    for(size_t i=0;i<AHR_REPLAY_MAX_HEADERS;++i)
+    {
+        snprintf(ahr_replay_header_names[i], sizeof(ahr_replay_header_names[i]), "X-Replay-%02zu", i);
+    }
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    int rc = 1;
+    AHR_FaultServer_t stub = NULL;
+    char stub_url[64]; // flawfinder: ignore
+    AHR_Logger_t logger = AHR_CreateLogger(NULL, AHR_ReplayLogNothing, AHR_ReplayLogNothing, AHR_ReplayLogError);
+    AHR_BenchHistogram_t recorded = AHR_BenchHistogramCreate(AHR_REPLAY_HIGHEST_NS, AHR_REPLAY_DIGITS);
+    AHR_Replay_t replay;
+    memset(&replay, 0, sizeof(replay));
+    replay.args = &args;
+    replay.base_url = args.target;
+    if(!logger || !recorded)
+    {
+        goto end;
+    }
+    if(!replay.base_url)
+    {
+        AHR_FaultRoute_t route;
+        AHR_FaultRouteParse("* shape=1", &route);
+        stub = AHR_FaultServerStart(0, &route, 1, 1U);
+        if(!stub)
+        {
+            perror("unable to start the stub");
+            goto end;
+        }
+        snprintf(stub_url, sizeof(stub_url), "http://127.0.0.1:%u", (unsigned int)AHR_FaultServerPort(stub));
+        replay.base_url = stub_url;
+    }
+    if(!AHR_ReplayCreate(&replay, logger))
+    {
+        fprintf(stderr, "unable to create the processors\n");
+        goto stop;
+    }
+
+    //
+    // Give the Processors Time to start before the first Request.
+    //
+    const uint64_t first_us = records[0].submit_us;
+    const int64_t start_ns = AHR_ReplayNow() + 100000000LL;
+    int64_t stop_ns = start_ns;
+    for(size_t i=0;i<nrecords;++i)
+    {
+        const AHR_Record_t *record = &records[i];
+        AHR_BenchHistogramRecord(recorded, (int64_t)record->latency_us * 1000LL);
+        const int64_t intended_ns = start_ns + (int64_t)(1e3 * (double)(record->submit_us - first_us) / args.speed);
+        stop_ns = intended_ns + (int64_t)(1e9 * args.drain);
+        AHR_ReplaySleepUntil(intended_ns);
+
+        pthread_mutex_lock(&replay.mutex);
+        bool expired = false;
+        while(0 == replay.nfree && !expired)
+        {
+            const struct timespec until = {.tv_sec = (time_t)(stop_ns / 1000000000LL), .tv_nsec = (long)(stop_ns % 1000000000LL)};
+            expired = ETIMEDOUT == pthread_cond_timedwait(&replay.cond, &replay.mutex, &until);
+        }
+        if(expired)
+        {
+            ++replay.unsent;
+            pthread_mutex_unlock(&replay.mutex);
+            continue;
+        }
+        AHR_ReplaySlot_t *slot = replay.free[--replay.nfree];
+        const int64_t lag_ns = AHR_ReplayNow() - intended_ns;
+        replay.max_lag_ns = lag_ns > replay.max_lag_ns ? lag_ns : replay.max_lag_ns;
+        ++replay.sent;
+        pthread_mutex_unlock(&replay.mutex);
+
+        slot->record = record;
+        slot->intended_ns = intended_ns;
+        if(!AHR_ReplaySubmit(slot, (uint64_t)i + 1U))
+        {
+            pthread_mutex_lock(&replay.mutex);
+            ++replay.errors;
+            replay.free[replay.nfree++] = slot;
+            pthread_mutex_unlock(&replay.mutex);
+        }
+    }
+    const double replay_seconds = 1e-9 * (double)(AHR_ReplayNow() - start_ns);
+    //
+    // Wait for the Requests in Flight, those which do not finish in Time count as unfinished.
+    //
+    pthread_mutex_lock(&replay.mutex);
+    const struct timespec until = {.tv_sec = (time_t)(stop_ns / 1000000000LL), .tv_nsec = (long)(stop_ns % 1000000000LL)};
+    while(replay.nfree < replay.nslots)
+    {
+        if(ETIMEDOUT == pthread_cond_timedwait(&replay.cond, &replay.mutex, &until))
+        {
+            replay.unfinished = replay.nslots - replay.nfree;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&replay.mutex);
+    for(size_t p=0;p<replay.nprocessors;++p)
+    {
+        AHR_ProcessorStop(replay.processors[p]);
+    }
+
+    const double recorded_seconds = 1e-6 * (double)(records[nrecords - 1U].submit_us - first_us);
+    printf(
+        "{\n  \"tool\": \"ahr_replay\",\n  \"curl\": \"%s\",\n  \"trace\": \"%s\",\n  \"target\": \"%s\",\n"
+        "  \"speed\": %.3f,\n  \"server_time\": %s,\n  \"processors\": %zu,\n  \"objects\": %zu,\n"
+        "  \"records\": %zu,\n  \"recorded_seconds\": %.3f,\n  \"replay_seconds\": %.3f,\n"
+        "  \"sent\": %llu,\n  \"completed\": %llu,\n  \"errors\": %llu,\n  \"status_mismatches\": %llu,\n"
+        "  \"unsent\": %llu,\n  \"unfinished\": %llu,\n  \"request_body_bytes\": %llu,\n  \"response_bytes\": %llu,\n"
+        "  \"max_send_lag_us\": %.1f,\n",
+        curl_version_info(CURLVERSION_NOW)->version,
+        args.trace,
+        args.target ? args.target : "stub",
+        args.speed,
+        args.server_time ? "true" : "false",
+        args.processors,
+        args.objects,
+        nrecords,
+        recorded_seconds,
+        replay_seconds,
+        (unsigned long long)replay.sent,
+        (unsigned long long)replay.completed,
+        (unsigned long long)replay.errors,
+        (unsigned long long)replay.status_mismatches,
+        (unsigned long long)replay.unsent,
+        (unsigned long long)replay.unfinished,
+        (unsigned long long)replay.request_bytes,
+        (unsigned long long)replay.response_bytes,
+        1e-3 * (double)replay.max_lag_ns
+    );
+    AHR_ReplayReportLatency("recorded_latency_us", recorded);
+    printf(",\n");
+    AHR_ReplayReportLatency("latency_us", replay.intended);
+    printf(",\n");
+    AHR_ReplayReportLatency("service_time_us", replay.service);
+    printf("\n}\n");
+    rc = 0;
+
+    stop:
+    AHR_ReplayDestroy(&replay);
+    if(stub)
+    {
+        AHR_FaultServerStop(&stub);
+    }
+
+    end:
+    if(recorded)
+    {
+        AHR_BenchHistogramDestroy(&recorded);
+    }
+    if(logger)
+    {
+        AHR_DestroyLogger(&logger);
+    }
+    free(records);
+    AHR_RecordReaderClose(&reader);
+    curl_global_cleanup();
+    return rc;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_ReplayParseArgs(int argc, char **argv, AHR_ReplayArgs_t *args)
+{
+    for(int i=1;i+1<argc;i+=2)
+    {
+        const char *name = argv[i];
+        const char *value = argv[i + 1];
+        if(0 == strcmp(name, "--trace"))
+        {
+            args->trace = value;
+        }
+        else if(0 == strcmp(name, "--target"))
+        {
+            args->target = value;
+        }
+        else if(0 == strcmp(name, "--speed"))
+        {
+            args->speed = strtod(value, NULL);
+        }
+        else if(0 == strcmp(name, "--server-time"))
+        {
+            if(0 != strcmp(value, "recorded") && 0 != strcmp(value, "none"))
+            {
+                return false;
+            }
+            args->server_time = 0 == strcmp(value, "recorded");
+        }
+        else if(0 == strcmp(name, "--processors"))
+        {
+            args->processors = strtoull(value, NULL, 10);
+        }
+        else if(0 == strcmp(name, "--objects"))
+        {
+            args->objects = strtoull(value, NULL, 10);
+        }
+        else if(0 == strcmp(name, "--drain"))
+        {
+            args->drain = strtod(value, NULL);
+        }
+        else if(0 == strcmp(name, "--dump"))
+        {
+            args->dump = 0 != strtoul(value, NULL, 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return 0 != argc % 2
+        && NULL != args->trace
+        && args->speed > 0.0
+        && args->processors > 0
+        && args->objects > 0 && args->objects <= AHR_REPLAY_MAX_OBJECTS
+        && args->drain >= 0.0;
+}
+
+static size_t AHR_ReplayReadTrace(AHR_RecordReader_t reader, AHR_Record_t **records)
+{
+    size_t n = 0;
+    size_t capacity = 0;
+    AHR_RecordStatus_t status = AHR_RECORD_OK;
+    while(AHR_RECORD_OK == status)
+    {
+        if(n == capacity)
+        {
+            capacity = 0 == capacity ? 1024U : 2U * capacity;
+            AHR_Record_t *grown = realloc(*records, capacity * sizeof(AHR_Record_t));
+            if(!grown)
+            {
+                free(*records);
+                *records = NULL;
+                return 0;
+            }
+            *records = grown;
+        }
+        status = AHR_RecordReaderNext(reader, &(*records)[n]);
+        n += AHR_RECORD_OK == status ? 1U : 0U;
+    }
+    //
+    // A Capture which was cut off still replays up to its last complete Record.
+    //
+    if(AHR_RECORD_CORRUPT == status)
+    {
+        fprintf(stderr, "warning: the recording is truncated after %zu records\n", n);
+    }
+    if(0 == n)
+    {
+        fprintf(stderr, "no records\n");
+        free(*records);
+        *records = NULL;
+        return 0;
+    }
+    //
+    // Records are written in Completion Order.
+    //
+    qsort(*records, n, sizeof(AHR_Record_t), AHR_ReplayCompareSubmit);
+    return n;
+}
+
+static int AHR_ReplayCompareSubmit(const void *a, const void *b)
+{
+    const uint64_t x = ((const AHR_Record_t*)a)->submit_us;
+    const uint64_t y = ((const AHR_Record_t*)b)->submit_us;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static void AHR_ReplayDump(const AHR_Record_t *records, size_t nrecords)
+{
+    printf("submit_us\tlatency_us\tserver_us\tmethod\ttemplate\theaders\theader_bytes\tbody_bytes\tstatus\terror\t"
+           "response_header_bytes\tresponse_bytes\tdecoded_bytes\n");
+    for(size_t i=0;i<nrecords;++i)
+    {
+        const AHR_Record_t *r = &records[i];
+        printf(
+            "%llu\t%llu\t%llu\t%s\t%s\t%u\t%llu\t%llu\t%u\t%u\t%llu\t%llu\t%llu\n",
+            (unsigned long long)r->submit_us,
+            (unsigned long long)r->latency_us,
+            (unsigned long long)r->server_us,
+            AHR_RecordMethodName(r->method),
+            r->url_template,
+            r->nheaders,
+            (unsigned long long)r->header_bytes,
+            (unsigned long long)r->body_bytes,
+            r->status,
+            r->error,
+            (unsigned long long)r->response_header_bytes,
+            (unsigned long long)r->response_bytes,
+            (unsigned long long)r->decoded_bytes
+        );
+    }
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static bool AHR_ReplayCreate(AHR_Replay_t *replay, AHR_Logger_t logger)
+{
+    const AHR_ReplayArgs_t *args = replay->args;
+    replay->nprocessors = args->processors;
+    replay->nslots = args->processors * args->objects;
+    replay->processors = calloc(replay->nprocessors, sizeof(AHR_Processor_t));
+    replay->slots = calloc(replay->nslots, sizeof(AHR_ReplaySlot_t));
+    replay->free = calloc(replay->nslots, sizeof(AHR_ReplaySlot_t*));
+    replay->intended = AHR_BenchHistogramCreate(AHR_REPLAY_HIGHEST_NS, AHR_REPLAY_DIGITS);
+    replay->service = AHR_BenchHistogramCreate(AHR_REPLAY_HIGHEST_NS, AHR_REPLAY_DIGITS);
+    //
+    // Deadlines are taken from the monotonic Clock like the Schedule.
+    //
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&replay->mutex, NULL);
+    pthread_cond_init(&replay->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    if(!replay->processors || !replay->slots || !replay->free || !replay->intended || !replay->service)
+    {
+        return false;
+    }
+    const AHR_ProcessorOptions_t options = {.max_objects = args->objects};
+    for(size_t p=0;p<replay->nprocessors;++p)
+    {
+        replay->processors[p] = AHR_CreateProcessorWithOptions(&options, logger);
+        if(!replay->processors[p] || !AHR_ProcessorStart(replay->processors[p]))
+        {
+            return false;
+        }
+        for(size_t o=0;o<args->objects;++o)
+        {
+            AHR_ReplaySlot_t *slot = &replay->slots[p * args->objects + o];
+            slot->replay = replay;
+            slot->processor = replay->processors[p];
+            slot->object = o;
+        }
+    }
+    //
+    // Hand out the Objects of all Processors in Turn, so the Load spreads over them.
+    //
+    for(size_t o=0;o<args->objects;++o)
+    {
+        for(size_t p=0;p<replay->nprocessors;++p)
+        {
+            replay->free[replay->nslots - 1U - replay->nfree++] = &replay->slots[p * args->objects + o];
+        }
+    }
+    return true;
+}
+
+static void AHR_ReplayDestroy(AHR_Replay_t *replay)
+{
+    for(size_t p=0;replay->processors && p<replay->nprocessors;++p)
+    {
+        if(replay->processors[p])
+        {
+            AHR_ProcessorStop(replay->processors[p]);
+            AHR_DestroyProcessor(&replay->processors[p]);
+        }
+    }
+    if(replay->service)
+    {
+        AHR_BenchHistogramDestroy(&replay->service);
+    }
+    if(replay->intended)
+    {
+        AHR_BenchHistogramDestroy(&replay->intended);
+    }
+    if(replay->slots)
+    {
+        pthread_cond_destroy(&replay->cond);
+        pthread_mutex_destroy(&replay->mutex);
+    }
+    free(replay->free);
+    free(replay->slots);
+    free(replay->processors);
+    replay->free = NULL;
+    replay->slots = NULL;
+    replay->processors = NULL;
+}
+
+static bool AHR_ReplaySubmit(AHR_ReplaySlot_t *slot, uint64_t sequence)
+{
+    const AHR_Record_t *record = slot->record;
+    AHR_ReplayExpandUrl(slot, sequence);
+    //
+    // The Stub answers with the recorded Shape, its own Head is subtracted from the recorded Header Bytes.
+    //
+    char shape[AHR_REPLAY_SHAPE_BYTES]; // flawfinder: ignore
+    const int nshape = snprintf(
+        shape,
+        sizeof(shape),
+        "status=%u body=%llu headers=%llu latency_us=%llu",
+        0 != record->status ? record->status : 200U,
+        (unsigned long long)record->response_bytes,
+        (unsigned long long)(
+            record->response_header_bytes > AHR_REPLAY_STUB_HEAD_BYTES
+                ? record->response_header_bytes - AHR_REPLAY_STUB_HEAD_BYTES
+                : 0U
+        ),
+        (unsigned long long)(slot->replay->args->server_time ? record->server_us : 0U)
+    );
+    AHR_HeaderView_t header[AHR_REPLAY_MAX_HEADERS + 1U];
+    header[0] = (AHR_HeaderView_t){.name = "X-Fault-Shape", .name_len = 13, .value = shape, .value_len = (size_t)nshape};
+    //
+    // Spread the recorded Header Bytes evenly over the recorded Number of Headers.
+    //
+    const size_t nheaders = record->nheaders < AHR_REPLAY_MAX_HEADERS ? record->nheaders : AHR_REPLAY_MAX_HEADERS;
+    const size_t header_bytes = record->header_bytes < AHR_REPLAY_MAX_HEADER_BYTES
+        ? (size_t)record->header_bytes
+        : AHR_REPLAY_MAX_HEADER_BYTES;
+    const size_t overhead = nheaders * (strlen(ahr_replay_header_names[0]) + 4U); // flawfinder: ignore
+    const size_t value_len = nheaders > 0 && header_bytes > overhead + nheaders ? (header_bytes - overhead) / nheaders : 1U;
+    for(size_t i=0;i<nheaders;++i)
+    {
+        header[1U + i] = (AHR_HeaderView_t){
+            .name = ahr_replay_header_names[i],
+            .name_len = strlen(ahr_replay_header_names[i]), // flawfinder: ignore
+            .value = ahr_replay_fill,
+            .value_len = value_len
+        };
+    }
+
+    AHR_RequestData_t request_data;
+    memset(&request_data, 0, sizeof(request_data));
+    request_data.url = slot->url;
+    request_data.header = header;
+    request_data.nheaders = 1U + nheaders;
+    AHR_BodyProvider_t provider = {
+        .read = AHR_ReplayBodyRead,
+        .rewind = AHR_ReplayBodyRewind,
+        .user = slot,
+        .content_length = (int64_t)record->body_bytes
+    };
+    AHR_ReplayConfigure_t configure = AHR_ProcessorGet;
+    if(AHR_RECORD_POST == record->method || AHR_RECORD_PUT == record->method)
+    {
+        configure = AHR_RECORD_POST == record->method ? AHR_ProcessorPost : AHR_ProcessorPut;
+        request_data.body_provider = &provider;
+    }
+    else if(AHR_RECORD_DELETE == record->method)
+    {
+        configure = AHR_ProcessorDelete;
+    }
+    slot->body_sent = 0;
+    //
+    // Bodies are only counted, streaming them avoids the Buffer Limits of the Processor.
+    //
+    const AHR_UserData_t user_data = {
+        .data = slot,
+        .on_success = AHR_ReplayOnSuccess,
+        .on_error = AHR_ReplayOnError,
+        .on_data = AHR_ReplayOnData,
+        .on_complete = AHR_ReplayOnComplete
+    };
+    AHR_ProcessorStatus_t status = AHR_PROC_OBJECT_BUSY;
+    while(AHR_PROC_OBJECT_BUSY == status)
+    {
+        status = configure(slot->processor, slot->object, &request_data, user_data);
+        if(AHR_PROC_OBJECT_BUSY == status)
+        {
+            sched_yield();
+        }
+    }
+    slot->sent_ns = AHR_ReplayNow();
+    if(AHR_PROC_OK != status || AHR_PROC_OK != AHR_ProcessorMakeRequest(slot->processor, slot->object))
+    {
+        fprintf(stderr, "unable to request %s with object %zu\n", slot->url, slot->object);
+        return false;
+    }
+    return true;
+}
+
+static void AHR_ReplayExpandUrl(AHR_ReplaySlot_t *slot, uint64_t sequence)
+{
+    const char *base = slot->replay->base_url;
+    size_t base_len = strlen(base); // flawfinder: ignore
+    while(base_len > 0 && '/' == base[base_len - 1U])
+    {
+        --base_len;
+    }
+    char id[24]; // flawfinder: ignore
+    const int nid = snprintf(id, sizeof(id), "%llu", (unsigned long long)sequence);
+    size_t len = base_len < sizeof(slot->url) - 1U ? base_len : sizeof(slot->url) - 1U;
+    memcpy(slot->url, base, len); // flawfinder: ignore
+    for(const char *t=slot->record->url_template;'\0' != *t && len + (size_t)nid < sizeof(slot->url) - 1U;)
+    {
+        if(0 == strncmp(t, "{id}", 4))
+        {
+            memcpy(&slot->url[len], id, (size_t)nid); // flawfinder: ignore
+            len += (size_t)nid;
+            t += 4;
+        }
+        else
+        {
+            slot->url[len++] = *t++;
+        }
+    }
+    slot->url[len] = '\0';
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static size_t AHR_ReplayBodyRead(void *user, char *buffer, size_t nbytes)
+{
+    AHR_ReplaySlot_t *slot = (AHR_ReplaySlot_t*)user;
+    const uint64_t left = slot->record->body_bytes - slot->body_sent;
+    size_t n = nbytes < left ? nbytes : (size_t)left;
+    n = n < sizeof(ahr_replay_fill) ? n : sizeof(ahr_replay_fill);
+    memcpy(buffer, ahr_replay_fill, n); // flawfinder: ignore
+    slot->body_sent += n;
+    return n;
+}
+
+static bool AHR_ReplayBodyRewind(void *user)
+{
+    ((AHR_ReplaySlot_t*)user)->body_sent = 0;
+    return true;
+}
+
+static void AHR_ReplayOnSuccess(void *user_data, size_t object, size_t status_code, const char *buffer, size_t nbytes)
+{
+    (void)object;
+    (void)buffer;
+    AHR_ReplaySlot_t *slot = (AHR_ReplaySlot_t*)user_data;
+    pthread_mutex_lock(&slot->replay->mutex);
+    slot->replay->response_bytes += nbytes;
+    pthread_mutex_unlock(&slot->replay->mutex);
+    AHR_ReplayFinish(slot, status_code, false);
+}
+
+static void AHR_ReplayOnError(void *user_data, size_t object, size_t error_code)
+{
+    (void)object;
+    (void)error_code;
+    AHR_ReplayFinish((AHR_ReplaySlot_t*)user_data, 0, true);
+}
+
+static AHR_StreamAction_t AHR_ReplayOnData(void *user_data, size_t object, const char *data, size_t nbytes)
+{
+    (void)object;
+    (void)data;
+    AHR_ReplaySlot_t *slot = (AHR_ReplaySlot_t*)user_data;
+    pthread_mutex_lock(&slot->replay->mutex);
+    slot->replay->response_bytes += nbytes;
+    pthread_mutex_unlock(&slot->replay->mutex);
+    return AHR_STREAM_CONTINUE;
+}
+
+static void AHR_ReplayOnComplete(void *user_data, size_t object, size_t status_code)
+{
+    (void)object;
+    AHR_ReplayFinish((AHR_ReplaySlot_t*)user_data, status_code, false);
+}
+
+static void AHR_ReplayFinish(AHR_ReplaySlot_t *slot, size_t status_code, bool failed)
+{
+    const int64_t now = AHR_ReplayNow();
+    AHR_Replay_t *replay = slot->replay;
+    const uint32_t expected = 0 != slot->record->status ? slot->record->status : 200U;
+    pthread_mutex_lock(&replay->mutex);
+    if(failed)
+    {
+        ++replay->errors;
+    }
+    else
+    {
+        ++replay->completed;
+        replay->status_mismatches += expected != status_code ? 1U : 0U;
+    }
+    replay->request_bytes += slot->body_sent;
+    AHR_BenchHistogramRecord(replay->intended, now - slot->intended_ns);
+    AHR_BenchHistogramRecord(replay->service, now - slot->sent_ns);
+    replay->free[replay->nfree++] = slot;
+    pthread_cond_signal(&replay->cond);
+    pthread_mutex_unlock(&replay->mutex);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void AHR_ReplayReportLatency(const char *name, const AHR_BenchHistogram_t histogram)
+{
+    printf(
+        "  \"%s\": {\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"max\": %.1f}",
+        name,
+        1e-3 * (double)AHR_BenchHistogramPercentile(histogram, 50.0),
+        1e-3 * (double)AHR_BenchHistogramPercentile(histogram, 90.0),
+        1e-3 * (double)AHR_BenchHistogramPercentile(histogram, 99.0),
+        1e-3 * (double)AHR_BenchHistogramPercentile(histogram, 99.9),
+        1e-3 * (double)AHR_BenchHistogramMax(histogram)
+    );
+}
+
+static void AHR_ReplayLogNothing(void *arg, const char *str)
+{
+    (void)arg;
+    (void)str;
+}
+
+static void AHR_ReplayLogError(void *arg, const char *str)
+{
+    (void)arg;
+    fprintf(stderr, "%s\n", str);
+}
+
+static int64_t AHR_ReplayNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000LL + (int64_t)now.tv_nsec;
+}
+
+static void AHR_ReplaySleepUntil(int64_t ns)
+{
+    const struct timespec until = {.tv_sec = (time_t)(ns / 1000000000LL), .tv_nsec = (long)(ns % 1000000000LL)};
+    while(EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL))
+    {
+    }
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
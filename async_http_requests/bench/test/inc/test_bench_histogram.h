@@ -0,0 +1,48 @@
+#ifndef __AHR_TEST_BENCH_HISTOGRAM_H__
+#define __AHR_TEST_BENCH_HISTOGRAM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+///
+/// \brief  Interval of a HdrHistogram Log, decoded like HdrHistogram reads it.
+///
+typedef struct
+{
+    uint32_t digits;
+    int64_t lowest;
+    int64_t highest;
+    double ratio;
+    ///
+    /// \brief  Counts per Index of the Bucket Layout, up to the Index of the highest recorded Value.
+    ///
+    int64_t *counts;
+    size_t ncounts;
+    int64_t total;
+} TEST_HdrInterval_t;
+
+///
+/// \brief  Decode the Base64 Histogram at the End of a Log Line, it may be followed by a Newline.
+/// \returns    false if Cookies, Lengths or the zlib Stream are wrong. Free "interval->counts" after true.
+///
+bool TEST_HdrIntervalDecode(const char *base64, TEST_HdrInterval_t *interval);
+
+///
+/// \brief  Invalid Arguments are rejected, an empty Histogram reports 0.
+///
+void test_AHR_BenchHistogramCreate(void);
+///
+/// \brief  Percentiles are within the Precision of the Digits, small Values exact, out of Range Values clamped.
+///
+void test_AHR_BenchHistogramPercentile(void);
+///
+/// \brief  Adding Histograms equals recording into one, Reset empties it.
+///
+void test_AHR_BenchHistogramAdd(void);
+///
+/// \brief  Header and Intervals of the Log decode to the recorded Counts.
+///
+void test_AHR_BenchHistogramLog(void);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef __AHR_TEST_FAULT_SERVER_H__
+#define __AHR_TEST_FAULT_SERVER_H__
+
+///
+/// \brief  Every Key of a Route Line is parsed, malformed Lines are rejected.
+///
+void test_AHR_FaultRouteParse(void);
+///
+/// \brief  Each Fault and Shape of a Route shows up in the Response and in the Stats of the Route.
+///
+void test_AHR_FaultServerRoutes(void);
+///
+/// \brief  The same Seed injects the same Faults.
+///
+void test_AHR_FaultServerSeed(void);
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef __AHR_TEST_LOAD_H__
+#define __AHR_TEST_LOAD_H__
+
+///
+/// \brief  ahr_load sends its whole Schedule to a loopback Server and logs every Request in the HdrHistogram Log.
+///
+void test_AHR_LoadConstant(void);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef __AHR_TEST_REPLAY_H__
+#define __AHR_TEST_REPLAY_H__
+
+///
+/// \brief  ahr_replay sends every Record of a Recording to its Stub, which answers with the recorded Shape.
+///
+void test_AHR_ReplayStub(void);
+///
+/// \brief  ahr_replay dumps a Recording as Text and replays a cut off Recording up to its last complete Record.
+///
+void test_AHR_ReplayDump(void);
+
+#endif
@@ -0,0 +1,372 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+
+#include <test_bench_histogram.h>
+#include <ahr_bench_histogram.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Latencies in Nanoseconds up to one Hour with 3 Digits, like ahr_load records them.
+///
+#define TEST_HDR_HIGHEST 3600000000000LL
+#define TEST_HDR_DIGITS 3
+#define TEST_HDR_ENCODING_COOKIE 0x1c849313U
+#define TEST_HDR_COMPRESSION_COOKIE 0x1c849314U
+#define TEST_HDR_HEADER_BYTES 40U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static uint32_t TEST_Get32(const uint8_t *buffer)
+{
+    return ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) | ((uint32_t)buffer[2] << 8) | buffer[3];
+}
+
+static uint64_t TEST_Get64(const uint8_t *buffer)
+{
+    return ((uint64_t)TEST_Get32(buffer) << 32) | TEST_Get32(&buffer[4]);
+}
+
+static size_t TEST_Base64Decode(const char *in, uint8_t *out)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint32_t bits = 0;
+    unsigned int nbits = 0;
+    size_t n = 0;
+    for(;'\0' != *in && '=' != *in && '\n' != *in;++in)
+    {
+        const char *c = strchr(alphabet, *in);
+        if(!c)
+        {
+            return 0;
+        }
+        bits = (bits << 6) | (uint32_t)(c - alphabet);
+        nbits += 6U;
+        if(nbits >= 8U)
+        {
+            nbits -= 8U;
+            out[n++] = (uint8_t)(bits >> nbits);
+        }
+    }
+    return n;
+}
+
+///
+/// \brief  ZigZag LEB128 with at most 9 Bytes, the 9th Byte holds 8 Bits.
+///
+static size_t TEST_Varint(const uint8_t *buffer, size_t nbytes, int64_t *value)
+{
+    uint64_t v = 0;
+    for(size_t i=0;i<9U && i<nbytes;++i)
+    {
+        if(8U == i)
+        {
+            v |= (uint64_t)buffer[i] << 56;
+            *value = (int64_t)(v >> 1) ^ -(int64_t)(v & 1U);
+            return 9U;
+        }
+        v |= (uint64_t)(buffer[i] & 0x7FU) << (7U * i);
+        if(0U == (buffer[i] & 0x80U))
+        {
+            *value = (int64_t)(v >> 1) ^ -(int64_t)(v & 1U);
+            return i + 1U;
+        }
+    }
+    return 0;
+}
+
+bool TEST_HdrIntervalDecode(const char *base64, TEST_HdrInterval_t *interval)
+{
+    memset(interval, 0, sizeof(*interval));
+    const size_t nbase64 = strlen(base64);
+    uint8_t *compressed = malloc(nbase64);
+    uLongf nraw = 1U << 20;
+    uint8_t *raw = malloc(nraw);
+    bool ok = false;
+    if(!compressed || !raw)
+    {
+        goto end;
+    }
+    const size_t ncompressed = TEST_Base64Decode(base64, compressed);
+    if(ncompressed < 8U
+        || TEST_HDR_COMPRESSION_COOKIE != TEST_Get32(compressed)
+        || ncompressed - 8U != TEST_Get32(&compressed[4])
+        || Z_OK != uncompress(raw, &nraw, &compressed[8], (uLong)(ncompressed - 8U))
+        || nraw < TEST_HDR_HEADER_BYTES
+        || TEST_HDR_ENCODING_COOKIE != TEST_Get32(raw)
+        || nraw - TEST_HDR_HEADER_BYTES != TEST_Get32(&raw[4])
+        || 0U != TEST_Get32(&raw[8]))
+    {
+        goto end;
+    }
+    interval->digits = TEST_Get32(&raw[12]);
+    interval->lowest = (int64_t)TEST_Get64(&raw[16]);
+    interval->highest = (int64_t)TEST_Get64(&raw[24]);
+    const uint64_t ratio_bits = TEST_Get64(&raw[32]);
+    memcpy(&interval->ratio, &ratio_bits, sizeof(ratio_bits));
+    //
+    // Count the Positions first, Runs of empty Buckets are written as their negative Length.
+    //
+    for(size_t pass=0;pass<2U;++pass)
+    {
+        size_t index = 0;
+        for(size_t at=TEST_HDR_HEADER_BYTES;at<nraw;)
+        {
+            int64_t value = 0;
+            const size_t n = TEST_Varint(&raw[at], nraw - at, &value);
+            if(0U == n)
+            {
+                goto end;
+            }
+            at += n;
+            if(value < 0)
+            {
+                index += (size_t)-value;
+                continue;
+            }
+            if(1U == pass)
+            {
+                interval->counts[index] = value;
+                interval->total += value;
+            }
+            ++index;
+        }
+        if(0U == pass)
+        {
+            interval->ncounts = index;
+            interval->counts = calloc(index + 1U, sizeof(int64_t));
+            if(!interval->counts)
+            {
+                goto end;
+            }
+        }
+    }
+    ok = true;
+
+    end:
+    if(!ok)
+    {
+        free(interval->counts);
+        interval->counts = NULL;
+    }
+    free(raw);
+    free(compressed);
+    return ok;
+}
+
+///
+/// \brief  Assert that "actual" is the upper Bound of the Bucket of "expected", 3 Digits keep it within 1/1000.
+///
+static void TEST_HdrAssertPercentile(int64_t expected, int64_t actual)
+{
+    TEST_ASSERT_GREATER_OR_EQUAL_INT64(expected, actual);
+    TEST_ASSERT_LESS_OR_EQUAL_INT64(expected + expected / 1000, actual);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_BenchHistogramCreate(void)
+{
+    TEST_ASSERT_NULL(AHR_BenchHistogramCreate(1, 3));
+    TEST_ASSERT_NULL(AHR_BenchHistogramCreate(TEST_HDR_HIGHEST, 0));
+    TEST_ASSERT_NULL(AHR_BenchHistogramCreate(TEST_HDR_HIGHEST, 6));
+
+    AHR_BenchHistogram_t smallest = AHR_BenchHistogramCreate(2, 1);
+    TEST_ASSERT_NOT_NULL(smallest);
+    AHR_BenchHistogramRecord(smallest, 2);
+    TEST_ASSERT_EQUAL_INT64(2, AHR_BenchHistogramPercentile(smallest, 100.0));
+    AHR_BenchHistogramDestroy(&smallest);
+    TEST_ASSERT_NULL(smallest);
+
+    AHR_BenchHistogram_t precise = AHR_BenchHistogramCreate(1000000, 5);
+    TEST_ASSERT_NOT_NULL(precise);
+    AHR_BenchHistogramRecord(precise, 123456);
+    TEST_ASSERT_EQUAL_INT64(123456, AHR_BenchHistogramPercentile(precise, 100.0));
+    AHR_BenchHistogramDestroy(&precise);
+
+    AHR_BenchHistogram_t h = AHR_BenchHistogramCreate(TEST_HDR_HIGHEST, TEST_HDR_DIGITS);
+    TEST_ASSERT_NOT_NULL(h);
+    TEST_ASSERT_EQUAL_INT64(0, AHR_BenchHistogramCount(h));
+    TEST_ASSERT_EQUAL_INT64(0, AHR_BenchHistogramMax(h));
+    TEST_ASSERT_EQUAL_INT64(0, AHR_BenchHistogramPercentile(h, 50.0));
+    TEST_ASSERT_EQUAL_INT64(0, AHR_BenchHistogramPercentile(h, 100.0));
+    AHR_BenchHistogramDestroy(&h);
+}
+
+void test_AHR_BenchHistogramPercentile(void)
+{
+    AHR_BenchHistogram_t h = AHR_BenchHistogramCreate(TEST_HDR_HIGHEST, TEST_HDR_DIGITS);
+    TEST_ASSERT_NOT_NULL(h);
+    for(int64_t v=1;v<=100000;++v)
+    {
+        AHR_BenchHistogramRecord(h, v);
+    }
+    TEST_ASSERT_EQUAL_INT64(100000, AHR_BenchHistogramCount(h));
+    TEST_ASSERT_EQUAL_INT64(100000, AHR_BenchHistogramMax(h));
+    TEST_HdrAssertPercentile(50000, AHR_BenchHistogramPercentile(h, 50.0));
+    TEST_HdrAssertPercentile(90000, AHR_BenchHistogramPercentile(h, 90.0));
+    TEST_HdrAssertPercentile(99000, AHR_BenchHistogramPercentile(h, 99.0));
+    TEST_HdrAssertPercentile(99900, AHR_BenchHistogramPercentile(h, 99.9));
+    TEST_ASSERT_EQUAL_INT64(100000, AHR_BenchHistogramPercentile(h, 100.0));
+    TEST_ASSERT_EQUAL_INT64(1, AHR_BenchHistogramPercentile(h, 0.0));
+    //
+    // Out of Range Percentiles are clamped.
+    //
+    TEST_ASSERT_EQUAL_INT64(100000, AHR_BenchHistogramPercentile(h, 250.0));
+    TEST_ASSERT_EQUAL_INT64(1, AHR_BenchHistogramPercentile(h, -1.0));
+    AHR_BenchHistogramDestroy(&h);
+
+    //
+    // Values below 2 * 10^digits have Buckets of their own.
+    //
+    h = AHR_BenchHistogramCreate(TEST_HDR_HIGHEST, TEST_HDR_DIGITS);
+    TEST_ASSERT_NOT_NULL(h);
+    for(size_t i=0;i<3;++i)
+    {
+        AHR_BenchHistogramRecord(h, 5);
+    }
+    AHR_BenchHistogramRecord(h, 1999);
+    TEST_ASSERT_EQUAL_INT64(5, AHR_BenchHistogramPercentile(h, 50.0));
+    TEST_ASSERT_EQUAL_INT64(5, AHR_BenchHistogramPercentile(h, 75.0));
+    TEST_ASSERT_EQUAL_INT64(1999, AHR_BenchHistogramPercentile(h, 100.0));
+    AHR_BenchHistogramDestroy(&h);
+
+    //
+    // Negative Values count as 0, Values above the highest trackable one as that one.
+    //
+    h = AHR_BenchHistogramCreate(TEST_HDR_HIGHEST, TEST_HDR_DIGITS);
+    TEST_ASSERT_NOT_NULL(h);
+    AHR_BenchHistogramRecord(h, -5);
+    AHR_BenchHistogramRecord(h, 2 * TEST_HDR_HIGHEST);
+    TEST_ASSERT_EQUAL_INT64(2, AHR_BenchHistogramCount(h));
+    TEST_ASSERT_EQUAL_INT64(TEST_HDR_HIGHEST, AHR_BenchHistogramMax(h));
+    TEST_ASSERT_EQUAL_INT64(0, AHR_BenchHistogramPercentile(h, 50.0));
+    TEST_ASSERT_EQUAL_INT64(TEST_HDR_HIGHEST, AHR_BenchHistogramPercentile(h, 100.0));
+    AHR_BenchHistogramDestroy(&h);
+}
+
+void test_AHR_BenchHistogramAdd(void)
+{
+    AHR_BenchHistogram_t a = AHR_BenchHistogramCreate(TEST_HDR_HIGHEST, TEST_HDR_DIGITS);
+    AHR_BenchHistogram_t b = AHR_BenchHistogramCreate(TEST_HDR_HIGHEST, TEST_HDR_DIGITS);
+    AHR_BenchHistogram_t all = AHR_BenchHistogramCreate(TEST_HDR_HIGHEST, TEST_HDR_DIGITS);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_NOT_NULL(all);
+    for(int64_t v=1;v<20000;++v)
+    {
+        AHR_BenchHistogramRecord(v % 2 ? a : b, v * 37);
+        AHR_BenchHistogramRecord(all, v * 37);
+    }
+    AHR_BenchHistogramRecord(b, 5000000);
+    AHR_BenchHistogramRecord(all, 5000000);
+
+    AHR_BenchHistogramAdd(a, b);
+    TEST_ASSERT_EQUAL_INT64(AHR_BenchHistogramCount(all), AHR_BenchHistogramCount(a));
+    TEST_ASSERT_EQUAL_INT64(5000000, AHR_BenchHistogramMax(a));
+    for(double p=0.0;p<=100.0;p+=12.5)
+    {
+        TEST_ASSERT_EQUAL_INT64(AHR_BenchHistogramPercentile(all, p), AHR_BenchHistogramPercentile(a, p));
+    }
+    TEST_ASSERT_EQUAL_INT64(10000, AHR_BenchHistogramCount(b));
+
+    AHR_BenchHistogramReset(a);
+    TEST_ASSERT_EQUAL_INT64(0, AHR_BenchHistogramCount(a));
+    TEST_ASSERT_EQUAL_INT64(0, AHR_BenchHistogramMax(a));
+    TEST_ASSERT_EQUAL_INT64(0, AHR_BenchHistogramPercentile(a, 100.0));
+    AHR_BenchHistogramRecord(a, 7);
+    TEST_ASSERT_EQUAL_INT64(1, AHR_BenchHistogramCount(a));
+    TEST_ASSERT_EQUAL_INT64(7, AHR_BenchHistogramPercentile(a, 100.0));
+
+    AHR_BenchHistogramDestroy(&all);
+    AHR_BenchHistogramDestroy(&b);
+    AHR_BenchHistogramDestroy(&a);
+}
+
+void test_AHR_BenchHistogramLog(void)
+{
+    AHR_BenchHistogram_t h = AHR_BenchHistogramCreate(TEST_HDR_HIGHEST, TEST_HDR_DIGITS);
+    TEST_ASSERT_NOT_NULL(h);
+    for(size_t i=0;i<3;++i)
+    {
+        AHR_BenchHistogramRecord(h, 1);
+    }
+    AHR_BenchHistogramRecord(h, 1000);
+    AHR_BenchHistogramRecord(h, 1000);
+    AHR_BenchHistogramRecord(h, 100000);
+
+    FILE *log = tmpfile();
+    TEST_ASSERT_NOT_NULL(log);
+    TEST_ASSERT_TRUE(AHR_BenchHistogramLogHeader(log, 1700000000.0));
+    TEST_ASSERT_TRUE(AHR_BenchHistogramLogInterval(log, "load", 1.5, 2.0, h));
+    AHR_BenchHistogramReset(h);
+    TEST_ASSERT_TRUE(AHR_BenchHistogramLogInterval(log, NULL, 3.5, 2.0, h));
+
+    char content[4096];
+    rewind(log);
+    const size_t ncontent = fread(content, 1, sizeof(content) - 1U, log);
+    content[ncontent] = '\0';
+    fclose(log);
+
+    const char *header =
+        "#[Histogram log format version 1.3]\n"
+        "#[StartTime: 1700000000.000 (seconds since epoch), Tue Nov 14 22:13:20 UTC 2023]\n"
+        "#[BaseTime: 1700000000.000 (seconds since epoch)]\n"
+        "\"StartTimestamp\",\"Interval_Length\",\"Interval_Max\",\"Interval_Compressed_Histogram\"\n";
+    TEST_ASSERT_EQUAL_INT(0, strncmp(header, content, strlen(header)));
+
+    //
+    // The Interval Max is in Milliseconds of the Nanoseconds recorded.
+    //
+    const char *line = &content[strlen(header)];
+    const char *prefix = "Tag=load,1.500,2.000,0.100,";
+    TEST_ASSERT_EQUAL_INT(0, strncmp(prefix, line, strlen(prefix)));
+    TEST_HdrInterval_t interval;
+    TEST_ASSERT_TRUE(TEST_HdrIntervalDecode(&line[strlen(prefix)], &interval));
+    TEST_ASSERT_EQUAL_UINT32(TEST_HDR_DIGITS, interval.digits);
+    TEST_ASSERT_EQUAL_INT64(1, interval.lowest);
+    TEST_ASSERT_EQUAL_INT64(TEST_HDR_HIGHEST, interval.highest);
+    TEST_ASSERT_TRUE(1.0 == interval.ratio);
+    TEST_ASSERT_EQUAL_INT64(6, interval.total);
+    //
+    // Below 2048 the Index is the Value, 100000 is Sub Bucket 1562 of Bucket 6: (6 + 1) * 1024 + 1562 - 1024.
+    //
+    TEST_ASSERT_EQUAL_size_t(7707, interval.ncounts);
+    TEST_ASSERT_EQUAL_INT64(0, interval.counts[0]);
+    TEST_ASSERT_EQUAL_INT64(3, interval.counts[1]);
+    TEST_ASSERT_EQUAL_INT64(2, interval.counts[1000]);
+    TEST_ASSERT_EQUAL_INT64(1, interval.counts[7706]);
+    free(interval.counts);
+
+    line = strchr(line, '\n');
+    TEST_ASSERT_NOT_NULL(line);
+    ++line;
+    prefix = "3.500,2.000,0.000,";
+    TEST_ASSERT_EQUAL_INT(0, strncmp(prefix, line, strlen(prefix)));
+    TEST_ASSERT_TRUE(TEST_HdrIntervalDecode(&line[strlen(prefix)], &interval));
+    TEST_ASSERT_EQUAL_INT64(TEST_HDR_HIGHEST, interval.highest);
+    TEST_ASSERT_EQUAL_size_t(0, interval.ncounts);
+    TEST_ASSERT_EQUAL_INT64(0, interval.total);
+    free(interval.counts);
+    line = strchr(line, '\n');
+    TEST_ASSERT_NOT_NULL(line);
+    TEST_ASSERT_EQUAL_CHAR('\0', line[1]);
+
+    AHR_BenchHistogramDestroy(&h);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,350 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <curl/curl.h>
+
+#include <test_fault_server.h>
+#include <ahr_fault_server.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define TEST_FAULT_SEED_REQUESTS 40U
+
+typedef struct
+{
+    CURLcode code;
+    long status;
+    size_t nbody;
+    size_t nheader;
+    ///
+    /// \brief  The Body is the Pattern of the Server, the Letters of the Alphabet repeated.
+    ///
+    bool pattern;
+    bool connection_close;
+    long nconnects;
+    double seconds;
+} TEST_FaultResponse_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static size_t TEST_FaultOnBody(char *data, size_t size, size_t nmemb, void *user_data)
+{
+    TEST_FaultResponse_t *response = (TEST_FaultResponse_t*)user_data;
+    for(size_t i=0;i<size * nmemb;++i)
+    {
+        const size_t offset = (response->nbody + i) % 16384U;
+        response->pattern = response->pattern && (char)('a' + (char)(offset % 26U)) == data[i];
+    }
+    response->nbody += size * nmemb;
+    return size * nmemb;
+}
+
+static size_t TEST_FaultOnHeader(char *data, size_t size, size_t nmemb, void *user_data)
+{
+    TEST_FaultResponse_t *response = (TEST_FaultResponse_t*)user_data;
+    static const char connection_close[] = "Connection: close";
+    const size_t nclose = sizeof(connection_close) - 1U;
+    if(size * nmemb >= nclose && 0 == strncasecmp(connection_close, data, nclose))
+    {
+        response->connection_close = true;
+    }
+    response->nheader += size * nmemb;
+    return size * nmemb;
+}
+
+///
+/// \brief  GET "path" with the Connection Cache of "easy", optionally with an "X-Fault-Shape" Header.
+///
+static TEST_FaultResponse_t TEST_FaultGet(
+    CURL *easy, uint16_t port, const char *path, const char *shape, long timeout_ms
+)
+{
+    TEST_FaultResponse_t response = {.pattern = true};
+    char url[256];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u%s", (unsigned int)port, path);
+    char header[256];
+    snprintf(header, sizeof(header), "X-Fault-Shape: %s", shape ? shape : "");
+    struct curl_slist *headers = shape ? curl_slist_append(NULL, header) : NULL;
+    curl_easy_setopt(easy, CURLOPT_URL, url);
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, TEST_FaultOnBody);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, TEST_FaultOnHeader);
+    curl_easy_setopt(easy, CURLOPT_HEADERDATA, &response);
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, timeout_ms);
+    response.code = curl_easy_perform(easy);
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &response.status);
+    curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &response.nconnects);
+    curl_easy_getinfo(easy, CURLINFO_TOTAL_TIME, &response.seconds);
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, NULL);
+    curl_slist_free_all(headers);
+    return response;
+}
+
+static AHR_FaultStats_t TEST_FaultStats(const AHR_FaultServer_t server, size_t route)
+{
+    AHR_FaultStats_t stats;
+    memset(&stats, 0xff, sizeof(stats));
+    TEST_ASSERT_TRUE(AHR_FaultServerStats(server, route, &stats));
+    return stats;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_FaultRouteParse(void)
+{
+    AHR_FaultRoute_t route;
+    TEST_ASSERT_TRUE(AHR_FaultRouteParse("  /plain", &route));
+    TEST_ASSERT_EQUAL_STRING("/plain", route.path);
+    TEST_ASSERT_EQUAL_UINT(200, route.status);
+    TEST_ASSERT_EQUAL_UINT(503, route.error_status);
+    TEST_ASSERT_EQUAL_INT(AHR_FAULT_LATENCY_NONE, route.latency.kind);
+    TEST_ASSERT_EQUAL_size_t(0, route.body_bytes);
+    TEST_ASSERT_EQUAL_size_t(0, route.header_bytes);
+    TEST_ASSERT_TRUE(0.0 == route.rate);
+    TEST_ASSERT_TRUE(0.0 == route.drop_rate + route.error_rate + route.reset_rate + route.stall_rate);
+    TEST_ASSERT_FALSE(route.close_connections);
+    TEST_ASSERT_FALSE(route.request_shape);
+
+    TEST_ASSERT_TRUE(
+        AHR_FaultRouteParse(
+            "/all\tstatus=201 body=4096 headers=512 rate=64 drop_rate=0.01 error_rate=0.05 error_status=502 "
+            "reset_rate=0.1 stall_rate=0.2 close=1 shape=1 latency=lognormal:20:0.5\r\n",
+            &route
+        )
+    );
+    TEST_ASSERT_EQUAL_STRING("/all", route.path);
+    TEST_ASSERT_EQUAL_UINT(201, route.status);
+    TEST_ASSERT_EQUAL_size_t(4096, route.body_bytes);
+    TEST_ASSERT_EQUAL_size_t(512, route.header_bytes);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 64.0, route.rate);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.01, route.drop_rate);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.05, route.error_rate);
+    TEST_ASSERT_EQUAL_UINT(502, route.error_status);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.1, route.reset_rate);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.2, route.stall_rate);
+    TEST_ASSERT_TRUE(route.close_connections);
+    TEST_ASSERT_TRUE(route.request_shape);
+    TEST_ASSERT_EQUAL_INT(AHR_FAULT_LATENCY_LOGNORMAL, route.latency.kind);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 20.0, route.latency.a);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.5, route.latency.b);
+
+    TEST_ASSERT_TRUE(AHR_FaultRouteParse("* latency=fixed:500", &route));
+    TEST_ASSERT_EQUAL_STRING("*", route.path);
+    TEST_ASSERT_EQUAL_INT(AHR_FAULT_LATENCY_FIXED, route.latency.kind);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 500.0, route.latency.a);
+    TEST_ASSERT_TRUE(AHR_FaultRouteParse("/u latency=uniform:2:2", &route));
+    TEST_ASSERT_EQUAL_INT(AHR_FAULT_LATENCY_UNIFORM, route.latency.kind);
+    TEST_ASSERT_TRUE(AHR_FaultRouteParse("/e latency=exp:3.5", &route));
+    TEST_ASSERT_EQUAL_INT(AHR_FAULT_LATENCY_EXPONENTIAL, route.latency.kind);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 3.5, route.latency.a);
+
+    static const char *malformed[] = {
+        "",
+        "   ",
+        "/a body",
+        "/a body=",
+        "/a body=12x",
+        "/a body=-1",
+        "/a unknown=1",
+        "/a status=99",
+        "/a status=1000",
+        "/a error_status=42",
+        "/a latency=fixed",
+        "/a latency=fixed:",
+        "/a latency=fixed:1:2",
+        "/a latency=uniform:5:2",
+        "/a latency=uniform:5",
+        "/a latency=gauss:1",
+        "/a latency=exp:-1"
+    };
+    for(size_t i=0;i<sizeof(malformed) / sizeof(malformed[0]);++i)
+    {
+        TEST_ASSERT_FALSE_MESSAGE(AHR_FaultRouteParse(malformed[i], &route), malformed[i]);
+    }
+    char path[AHR_FAULT_PATH_BYTES + 1U];
+    memset(path, 'p', sizeof(path) - 1U);
+    path[0] = '/';
+    path[sizeof(path) - 1U] = '\0';
+    TEST_ASSERT_FALSE(AHR_FaultRouteParse(path, &route));
+    path[AHR_FAULT_PATH_BYTES - 1U] = '\0';
+    TEST_ASSERT_TRUE(AHR_FaultRouteParse(path, &route));
+}
+
+void test_AHR_FaultServerRoutes(void)
+{
+    static const char *lines[] = {
+        "/ok status=201 body=40000 headers=2048",
+        "/error error_rate=1 error_status=502 body=100",
+        "/drop drop_rate=1 body=100",
+        "/reset reset_rate=1 body=65536",
+        "/stall stall_rate=1 body=65536",
+        "/shape shape=1 body=10",
+        "/slow latency=fixed:50",
+        "/trickle body=2000 rate=20000",
+        "/close close=1 body=5"
+    };
+    const size_t nroutes = sizeof(lines) / sizeof(lines[0]);
+    AHR_FaultRoute_t routes[sizeof(lines) / sizeof(lines[0])];
+    for(size_t i=0;i<nroutes;++i)
+    {
+        TEST_ASSERT_TRUE(AHR_FaultRouteParse(lines[i], &routes[i]));
+    }
+    AHR_FaultServer_t server = AHR_FaultServerStart(0, routes, nroutes, 1);
+    TEST_ASSERT_NOT_NULL(server);
+    const uint16_t port = AHR_FaultServerPort(server);
+    CURL *easy = curl_easy_init();
+    TEST_ASSERT_NOT_NULL(easy);
+
+    //
+    // Routes match by Prefix, the Body is generated and the Head padded.
+    //
+    TEST_FaultResponse_t response = TEST_FaultGet(easy, port, "/ok/items?id=1", NULL, 5000);
+    TEST_ASSERT_EQUAL_INT(CURLE_OK, response.code);
+    TEST_ASSERT_EQUAL_INT(201, response.status);
+    TEST_ASSERT_EQUAL_size_t(40000, response.nbody);
+    TEST_ASSERT_TRUE(response.pattern);
+    TEST_ASSERT_GREATER_OR_EQUAL_size_t(2048, response.nheader);
+    TEST_ASSERT_LESS_THAN_size_t(2048 + 1024, response.nheader);
+    TEST_ASSERT_FALSE(response.connection_close);
+    TEST_ASSERT_EQUAL_INT(1, response.nconnects);
+
+    response = TEST_FaultGet(easy, port, "/error", NULL, 5000);
+    TEST_ASSERT_EQUAL_INT(CURLE_OK, response.code);
+    TEST_ASSERT_EQUAL_INT(502, response.status);
+    TEST_ASSERT_EQUAL_size_t(0, response.nbody);
+    //
+    // Both were served over the same Connection.
+    //
+    TEST_ASSERT_EQUAL_INT(0, response.nconnects);
+
+    //
+    // curl sends a Request again if a reused Connection closes without a Response, a new Handle has none to reuse.
+    //
+    CURL *fresh = curl_easy_init();
+    TEST_ASSERT_NOT_NULL(fresh);
+    response = TEST_FaultGet(fresh, port, "/drop", NULL, 5000);
+    curl_easy_cleanup(fresh);
+    TEST_ASSERT_EQUAL_INT(CURLE_GOT_NOTHING, response.code);
+
+    response = TEST_FaultGet(easy, port, "/reset", NULL, 5000);
+    TEST_ASSERT_NOT_EQUAL(CURLE_OK, response.code);
+    TEST_ASSERT_NOT_EQUAL(CURLE_OPERATION_TIMEDOUT, response.code);
+    TEST_ASSERT_LESS_OR_EQUAL_size_t(65536 / 2, response.nbody);
+
+    response = TEST_FaultGet(easy, port, "/stall", NULL, 300);
+    TEST_ASSERT_EQUAL_INT(CURLE_OPERATION_TIMEDOUT, response.code);
+    TEST_ASSERT_EQUAL_INT(200, response.status);
+    TEST_ASSERT_EQUAL_size_t(65536 / 2, response.nbody);
+    TEST_ASSERT_TRUE(response.pattern);
+
+    //
+    // The Shape Header replaces Status, Body and Latency of the Route, missing Keys keep the Route's.
+    //
+    response = TEST_FaultGet(easy, port, "/shape", "status=404 body=1234 latency_us=20000", 5000);
+    TEST_ASSERT_EQUAL_INT(CURLE_OK, response.code);
+    TEST_ASSERT_EQUAL_INT(404, response.status);
+    TEST_ASSERT_EQUAL_size_t(1234, response.nbody);
+    TEST_ASSERT_TRUE(response.seconds >= 0.02);
+    response = TEST_FaultGet(easy, port, "/shape", "headers=4096", 5000);
+    TEST_ASSERT_EQUAL_INT(200, response.status);
+    TEST_ASSERT_EQUAL_size_t(10, response.nbody);
+    TEST_ASSERT_GREATER_OR_EQUAL_size_t(4096, response.nheader);
+
+    response = TEST_FaultGet(easy, port, "/slow", NULL, 5000);
+    TEST_ASSERT_EQUAL_INT(200, response.status);
+    TEST_ASSERT_EQUAL_size_t(0, response.nbody);
+    TEST_ASSERT_TRUE(response.seconds >= 0.05);
+
+    //
+    // 2000 Bytes of Body and the Head at 20000 Bytes per Second.
+    //
+    response = TEST_FaultGet(easy, port, "/trickle", NULL, 5000);
+    TEST_ASSERT_EQUAL_INT(200, response.status);
+    TEST_ASSERT_EQUAL_size_t(2000, response.nbody);
+    TEST_ASSERT_TRUE(response.pattern);
+    TEST_ASSERT_TRUE(response.seconds >= 0.09);
+
+    response = TEST_FaultGet(easy, port, "/close", NULL, 5000);
+    TEST_ASSERT_EQUAL_INT(200, response.status);
+    TEST_ASSERT_TRUE(response.connection_close);
+    response = TEST_FaultGet(easy, port, "/close", NULL, 5000);
+    TEST_ASSERT_EQUAL_INT(200, response.status);
+    TEST_ASSERT_EQUAL_INT(1, response.nconnects);
+
+    response = TEST_FaultGet(easy, port, "/missing", NULL, 5000);
+    TEST_ASSERT_EQUAL_INT(CURLE_OK, response.code);
+    TEST_ASSERT_EQUAL_INT(404, response.status);
+
+    AHR_FaultStats_t stats = TEST_FaultStats(server, 0);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.requests);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.drops + stats.errors + stats.resets + stats.stalls);
+    stats = TEST_FaultStats(server, 1);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.requests);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.errors);
+    stats = TEST_FaultStats(server, 2);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.requests);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.drops);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.errors);
+    stats = TEST_FaultStats(server, 3);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.resets);
+    stats = TEST_FaultStats(server, 4);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.stalls);
+    stats = TEST_FaultStats(server, 5);
+    TEST_ASSERT_EQUAL_UINT64(2, stats.requests);
+    stats = TEST_FaultStats(server, 8);
+    TEST_ASSERT_EQUAL_UINT64(2, stats.requests);
+    AHR_FaultStats_t none;
+    TEST_ASSERT_FALSE(AHR_FaultServerStats(server, nroutes, &none));
+
+    curl_easy_cleanup(easy);
+    AHR_FaultServerStop(&server);
+    TEST_ASSERT_NULL(server);
+}
+
+void test_AHR_FaultServerSeed(void)
+{
+    AHR_FaultRoute_t route;
+    TEST_ASSERT_TRUE(AHR_FaultRouteParse("* error_rate=0.5 error_status=500", &route));
+    long statuses[2][TEST_FAULT_SEED_REQUESTS];
+    for(size_t run=0;run<2;++run)
+    {
+        AHR_FaultServer_t server = AHR_FaultServerStart(0, &route, 1, 42);
+        TEST_ASSERT_NOT_NULL(server);
+        CURL *easy = curl_easy_init();
+        TEST_ASSERT_NOT_NULL(easy);
+        size_t errors = 0;
+        for(size_t i=0;i<TEST_FAULT_SEED_REQUESTS;++i)
+        {
+            const TEST_FaultResponse_t response = TEST_FaultGet(easy, AHR_FaultServerPort(server), "/", NULL, 5000);
+            TEST_ASSERT_EQUAL_INT(CURLE_OK, response.code);
+            statuses[run][i] = response.status;
+            errors += 500 == response.status ? 1U : 0U;
+        }
+        TEST_ASSERT_EQUAL_UINT64(errors, TEST_FaultStats(server, 0).errors);
+        //
+        // Both Outcomes happen at a Rate of one half.
+        //
+        TEST_ASSERT_GREATER_THAN_size_t(5, errors);
+        TEST_ASSERT_LESS_THAN_size_t(TEST_FAULT_SEED_REQUESTS - 5U, errors);
+        curl_easy_cleanup(easy);
+        AHR_FaultServerStop(&server);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(statuses[0], statuses[1], sizeof(statuses[0]));
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
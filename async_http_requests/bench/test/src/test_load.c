@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <test_load.h>
+#include <test_bench_histogram.h>
+#include <ahr_bench_server.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define TEST_LOAD_REQUESTS 400U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Sum of the Counts of all Intervals with "tag" in the Log at "path", -1 if an Interval does not decode.
+///
+static int64_t TEST_LoadLogTotal(const char *path, const char *tag, size_t *nintervals)
+{
+    FILE *log = fopen(path, "r");
+    if(!log)
+    {
+        return -1;
+    }
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "Tag=%s,", tag);
+    static char line[1U << 16];
+    int64_t total = 0;
+    *nintervals = 0;
+    while(total >= 0 && fgets(line, sizeof(line), log))
+    {
+        if(0 != strncmp(prefix, line, strlen(prefix)))
+        {
+            continue;
+        }
+        //
+        // Tag, Start, Length and Max precede the Histogram.
+        //
+        const char *histogram = line;
+        for(size_t i=0;histogram && i<4;++i)
+        {
+            histogram = strchr(histogram, ',');
+            histogram = histogram ? histogram + 1 : NULL;
+        }
+        TEST_HdrInterval_t interval;
+        if(!histogram || !TEST_HdrIntervalDecode(histogram, &interval))
+        {
+            total = -1;
+            break;
+        }
+        total += interval.total;
+        ++*nintervals;
+        free(interval.counts);
+    }
+    fclose(log);
+    return total;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_LoadConstant(void)
+{
+    static const char body[] = "{\"id\": 1, \"name\": \"ahr\"}";
+    const AHR_BenchContent_t content = {
+        .body = body,
+        .nbytes = sizeof(body) - 1U,
+        .content_type = "application/json"
+    };
+    AHR_BenchServer_t server = AHR_BenchServerStart(0, &content);
+    TEST_ASSERT_NOT_NULL(server);
+
+    char targets[] = "/tmp/ahr_test_load_targetsXXXXXX";
+    const int fd = mkstemp(targets);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT(0, fd);
+    char lines[512];
+    const int nlines = snprintf(
+        lines,
+        sizeof(lines),
+        "# Comments and empty Lines are skipped.\n"
+        "\n"
+        "GET http://127.0.0.1:%u/items\n"
+        "POST http://127.0.0.1:%u/items {\"id\": 2}\n",
+        (unsigned int)AHR_BenchServerPort(server),
+        (unsigned int)AHR_BenchServerPort(server)
+    );
+    TEST_ASSERT_EQUAL_INT(nlines, (int)write(fd, lines, (size_t)nlines));
+    close(fd);
+    char hdr_log[] = "/tmp/ahr_test_load_hlogXXXXXX";
+    close(mkstemp(hdr_log));
+
+    //
+    // 400 Requests at 800 per Second over two Processors, logged every 0.25 Seconds.
+    //
+    char command[1024];
+    snprintf(
+        command,
+        sizeof(command),
+        "%s --targets %s --schedule constant --rate 800 --duration 0.5 --processors 2 --threads 2 "
+        "--hdr-log %s --interval 0.25 --drain 5",
+        AHR_LOAD_PATH,
+        targets,
+        hdr_log
+    );
+    FILE *out = popen(command, "r");
+    TEST_ASSERT_NOT_NULL(out);
+    static char summary[8192];
+    const size_t nsummary = fread(summary, 1, sizeof(summary) - 1U, out);
+    summary[nsummary] = '\0';
+    TEST_ASSERT_EQUAL_INT(0, pclose(out));
+
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"tool\": \"ahr_load\""), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"targets\": 2,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"scheduled\": 400,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"sent\": 400,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"completed\": 400,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"errors\": 0,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"non_2xx\": 0,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"unsent\": 0,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"unfinished\": 0,"), summary);
+    TEST_ASSERT_EQUAL_UINT64(TEST_LOAD_REQUESTS, AHR_BenchServerResponses(server));
+
+    //
+    // Each Request is in exactly one Interval, once from its intended and once from its actual Send Time.
+    //
+    size_t nintended = 0;
+    size_t nservice = 0;
+    TEST_ASSERT_EQUAL_INT64(TEST_LOAD_REQUESTS, TEST_LoadLogTotal(hdr_log, "intended", &nintended));
+    TEST_ASSERT_EQUAL_INT64(TEST_LOAD_REQUESTS, TEST_LoadLogTotal(hdr_log, "service", &nservice));
+    TEST_ASSERT_GREATER_OR_EQUAL_size_t(2, nintended);
+    TEST_ASSERT_EQUAL_size_t(nintended, nservice);
+
+    unlink(hdr_log);
+    unlink(targets);
+    AHR_BenchServerStop(&server);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <test_replay.h>
+#include <async_http_requests/ahr_record.h>
+#include <async_http_requests/private/ahr_recorder.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define TEST_REPLAY_RECORDS 60U
+#define TEST_REPLAY_BODY_BYTES 300U
+#define TEST_REPLAY_RESPONSE_BYTES 1024U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Record 60 Requests over 0.3 Seconds into a new File at "path", a mkstemp() Template.
+///         Every third Request is a GET of 1 KiB, a POST of 300 Bytes answered with 201 or a DELETE answered with 404.
+///
+static void TEST_ReplayRecording(char *path)
+{
+    const int fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+    AHR_Recorder_t *recorder = AHR_CreateRecorder(path);
+    TEST_ASSERT_NOT_NULL(recorder);
+    for(size_t i=0;i<TEST_REPLAY_RECORDS;++i)
+    {
+        AHR_Record_t record = {
+            .submit_us = 5000U * i, .latency_us = 3000, .server_us = 2000, .method = AHR_RECORD_GET,
+            .url_template = "/users/{id}", .nheaders = 2, .header_bytes = 64, .status = 200,
+            .response_header_bytes = 200, .response_bytes = TEST_REPLAY_RESPONSE_BYTES,
+            .decoded_bytes = TEST_REPLAY_RESPONSE_BYTES
+        };
+        if(1U == i % 3U)
+        {
+            record.method = AHR_RECORD_POST;
+            record.url_template = "/items";
+            record.body_bytes = TEST_REPLAY_BODY_BYTES;
+            record.status = 201;
+            record.response_bytes = 0;
+            record.decoded_bytes = 0;
+        }
+        else if(2U == i % 3U)
+        {
+            record.method = AHR_RECORD_DELETE;
+            record.url_template = "/users/{id}?force=";
+            record.nheaders = 0;
+            record.header_bytes = 0;
+            record.status = 404;
+            record.response_bytes = 0;
+            record.decoded_bytes = 0;
+        }
+        TEST_ASSERT_TRUE(AHR_RecorderAdd(recorder, &record));
+    }
+    AHR_DestroyRecorder(&recorder);
+}
+
+///
+/// \brief  Run ahr_replay with "args".
+/// \returns    Its Output on stdout, to be freed by the Caller.
+///
+static char* TEST_ReplayRun(const char *args)
+{
+    char command[1024]; // flawfinder: ignore
+    snprintf(command, sizeof(command), "%s %s", AHR_REPLAY_PATH, args);
+    FILE *out = popen(command, "r");
+    TEST_ASSERT_NOT_NULL(out);
+    const size_t capacity = 1U << 16;
+    char *output = malloc(capacity);
+    TEST_ASSERT_NOT_NULL(output);
+    const size_t n = fread(output, 1, capacity - 1U, out);
+    output[n] = '\0';
+    TEST_ASSERT_EQUAL_INT(0, pclose(out));
+    return output;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_ReplayStub(void)
+{
+    char path[] = "/tmp/ahr_test_replay_XXXXXX"; // flawfinder: ignore
+    TEST_ReplayRecording(path);
+
+    char args[256]; // flawfinder: ignore
+    snprintf(args, sizeof(args), "--trace %s --speed 2 --processors 2 --drain 5", path);
+    char *summary = TEST_ReplayRun(args);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"tool\": \"ahr_replay\""), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"target\": \"stub\""), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"records\": 60,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"recorded_seconds\": 0.295,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"sent\": 60,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"completed\": 60,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"errors\": 0,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"status_mismatches\": 0,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"unsent\": 0,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"unfinished\": 0,"), summary);
+    //
+    // The Stub sends the recorded Response Sizes, the Requests carry the recorded Body Sizes.
+    //
+    char expected[64]; // flawfinder: ignore
+    const unsigned int nrequests = TEST_REPLAY_RECORDS / 3U;
+    snprintf(expected, sizeof(expected), "\"request_body_bytes\": %u,", nrequests * TEST_REPLAY_BODY_BYTES);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, expected), summary);
+    snprintf(expected, sizeof(expected), "\"response_bytes\": %u,", nrequests * TEST_REPLAY_RESPONSE_BYTES);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, expected), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"recorded_latency_us\": {\"p50\": 3000.0,"), summary);
+    free(summary);
+    unlink(path);
+}
+
+void test_AHR_ReplayDump(void)
+{
+    char path[] = "/tmp/ahr_test_replay_XXXXXX"; // flawfinder: ignore
+    TEST_ReplayRecording(path);
+
+    char args[256]; // flawfinder: ignore
+    snprintf(args, sizeof(args), "--trace %s --dump 1", path);
+    char *dump = TEST_ReplayRun(args);
+    size_t nlines = 0;
+    for(const char *c=dump;'\0' != *c;++c)
+    {
+        nlines += '\n' == *c ? 1U : 0U;
+    }
+    TEST_ASSERT_EQUAL_size_t(1U + TEST_REPLAY_RECORDS, nlines);
+    TEST_ASSERT_EQUAL_INT(0, strncmp(dump, "submit_us\tlatency_us\tserver_us\tmethod\ttemplate\t", 47));
+    static const char *const lines[] = {
+        "\n0\t3000\t2000\tGET\t/users/{id}\t2\t64\t0\t200\t0\t200\t1024\t1024\n",
+        "\n5000\t3000\t2000\tPOST\t/items\t2\t64\t300\t201\t0\t200\t0\t0\n",
+        "\n295000\t3000\t2000\tDELETE\t/users/{id}?force=\t0\t0\t0\t404\t0\t200\t0\t0\n"
+    };
+    for(size_t i=0;i<sizeof(lines) / sizeof(lines[0]);++i)
+    {
+        TEST_ASSERT_NOT_NULL_MESSAGE(strstr(dump, lines[i]), dump);
+    }
+    free(dump);
+    //
+    // Without its last Byte the last Record is lost, the Records before it still replay.
+    //
+    struct stat info;
+    TEST_ASSERT_EQUAL_INT(0, stat(path, &info));
+    TEST_ASSERT_EQUAL_INT(0, truncate(path, info.st_size - 1));
+    snprintf(args, sizeof(args), "--trace %s --speed 4 2>&1", path);
+    char *summary = TEST_ReplayRun(args);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "warning: the recording is truncated after 59 records"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"records\": 59,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"completed\": 59,"), summary);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(summary, "\"status_mismatches\": 0,"), summary);
+    free(summary);
+    unlink(path);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
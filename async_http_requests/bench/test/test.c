@@ -0,0 +1,27 @@
+#include <unity.h>
+#include <test_bench_histogram.h>
+#include <test_load.h>
+#include <test_fault_server.h>
+#include <test_replay.h>
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_AHR_BenchHistogramCreate);
+    RUN_TEST(test_AHR_BenchHistogramPercentile);
+    RUN_TEST(test_AHR_BenchHistogramAdd);
+    RUN_TEST(test_AHR_BenchHistogramLog);
+    RUN_TEST(test_AHR_LoadConstant);
+    RUN_TEST(test_AHR_FaultRouteParse);
+    RUN_TEST(test_AHR_FaultServerRoutes);
+    RUN_TEST(test_AHR_FaultServerSeed);
+    RUN_TEST(test_AHR_ReplayStub);
+    RUN_TEST(test_AHR_ReplayDump);
+    return UNITY_END();
+}
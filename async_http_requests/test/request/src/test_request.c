@@ -28,39 +28,27 @@ void test_AHR_RequestSetHeader(void)
     // Set up Mocks.
     AHR_CurlEasyInit_IgnoreAndReturn((void*)42);
     AHR_CurlEasyCleanUp_Ignore();
+    AHR_CurlSetHeader_Ignore();
 
     // Start Test...
     AHR_HttpRequest_t request = AHR_CreateRequest();
 
-    AHR_Header_t header;
-    memset(&header, '\0', sizeof(header));
-    header.nheaders = 2;
-    strcat(header.header[0].name, "First");
-    strcat(header.header[0].value, "v0");
-    strcat(header.header[1].name, "Second");
-    strcat(header.header[1].value, "v1");
-    strcat(header.header[2].name, "Third");
-    strcat(header.header[2].value, "v2");
+    const AHR_HeaderView_t header[] = {
+        {.name="First", .name_len=5, .value="v0", .value_len=2},
+        {.name="Second", .name_len=6, .value="v1", .value_len=2},
+    };
 
-    AHR_RequestSetHeader(request, &header);
+    TEST_ASSERT_TRUE(AHR_RequestSetHeader(request, header, 2));
 
     // Assert Result.
-    AHR_Header_t return_value;
-    AHR_RequestGetHeader(request, &return_value);
-    
-    TEST_ASSERT_EQUAL_INT(return_value.nheaders, 2);
-    TEST_ASSERT_EQUAL_STRING(
-        "First", header.header[0].name
-    );
-    TEST_ASSERT_EQUAL_STRING(
-        "v0", header.header[0].value
-    );
-    TEST_ASSERT_EQUAL_STRING(
-        "Second", header.header[1].name
-    );
-    TEST_ASSERT_EQUAL_STRING(
-        "v1", header.header[1].value
-    );
+    TEST_ASSERT_EQUAL_INT(2, AHR_RequestHeaderCount(request));
+    AHR_HeaderView_t view;
+    TEST_ASSERT_TRUE(AHR_RequestHeaderAt(request, 0, &view));
+    TEST_ASSERT_EQUAL_MEMORY("First", view.name, view.name_len);
+    TEST_ASSERT_EQUAL_MEMORY("v0", view.value, view.value_len);
+    TEST_ASSERT_TRUE(AHR_RequestHeaderAt(request, 1, &view));
+    TEST_ASSERT_EQUAL_MEMORY("Second", view.name, view.name_len);
+    TEST_ASSERT_EQUAL_MEMORY("v1", view.value, view.value_len);
     
     // Clean Up.
     AHR_DestroyRequest(&request);
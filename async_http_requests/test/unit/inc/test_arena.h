@@ -0,0 +1,17 @@
+#ifndef __AHR_TEST_ARENA_H__
+#define __AHR_TEST_ARENA_H__
+
+///
+/// \brief  Allocations are zeroed, aligned to a Cache Line and fail once the Arena is exhausted.
+///
+void test_AHR_ArenaAlloc(void);
+///
+/// \brief  Huge Pages fall back to regular Pages, the Arena stays usable.
+///
+void test_AHR_ArenaFlags(void);
+///
+/// \brief  The Processor reports the Arena which holds its fixed size Storage.
+///
+void test_AHR_ProcessorFootprint(void);
+
+#endif
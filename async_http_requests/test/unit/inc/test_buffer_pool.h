@@ -0,0 +1,17 @@
+#ifndef __AHR_TEST_BUFFER_POOL_H__
+#define __AHR_TEST_BUFFER_POOL_H__
+
+///
+/// \brief  A Request is served from the smallest Class which holds it, larger Requests fail.
+///
+void test_AHR_BufferPoolSizeClasses(void);
+///
+/// \brief  Released Buffers are reused through the Cache and the Depot, the Statistics follow.
+///
+void test_AHR_BufferPoolReuse(void);
+///
+/// \brief  The Pool learns the Response Size of an Endpoint and decays slowly to smaller ones.
+///
+void test_AHR_BufferPoolLearn(void);
+
+#endif
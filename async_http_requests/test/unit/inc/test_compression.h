@@ -0,0 +1,17 @@
+#ifndef __AHR_TEST_COMPRESSION_H__
+#define __AHR_TEST_COMPRESSION_H__
+
+///
+/// \brief  A Body in Memory compressed with each supported Encoding decompresses to the Original.
+///
+void test_AHR_CompressRoundTrip(void);
+///
+/// \brief  A Body streamed through the Compressor decompresses to the Original, also after a Rewind.
+///
+void test_AHR_CompressorStream(void);
+///
+/// \brief  zstd with a trained Dictionary, needs AHR_WITH_ZSTD.
+///
+void test_AHR_CompressDictionary(void);
+
+#endif
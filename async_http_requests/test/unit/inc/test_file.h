@@ -0,0 +1,17 @@
+#ifndef __AHR_TEST_FILE_H__
+#define __AHR_TEST_FILE_H__
+
+///
+/// \brief  The Writer puts Chunks one after another at the Offset of the Sink.
+///
+void test_AHR_FileWriterWrite(void);
+///
+/// \brief  The Reader provides a Range of a Descriptor through pread() and through a Mapping.
+///
+void test_AHR_FileReaderRange(void);
+///
+/// \brief  The Reader opens a File by its Path.
+///
+void test_AHR_FileReaderPath(void);
+
+#endif
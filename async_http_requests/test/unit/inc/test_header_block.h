@@ -0,0 +1,25 @@
+#ifndef __AHR_TEST_HEADER_BLOCK_H__
+#define __AHR_TEST_HEADER_BLOCK_H__
+
+///
+/// \brief  Append Headers and read them back through Views.
+///
+void test_AHR_HeaderBlockAppend(void);
+///
+/// \brief  Reset keeps the Capacity but removes all Headers.
+///
+void test_AHR_HeaderBlockReset(void);
+///
+/// \brief  Headers exceeding the Limits are rejected and leave the Block unchanged.
+///
+void test_AHR_HeaderBlockLimits(void);
+///
+/// \brief  Assign replaces the Contents with the given Views.
+///
+void test_AHR_HeaderBlockAssign(void);
+///
+/// \brief  Find goes through the Hash Index, ignores Case and returns the first of equal Names.
+///
+void test_AHR_HeaderBlockFind(void);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef __AHR_TEST_HEADER_LIST_H__
+#define __AHR_TEST_HEADER_LIST_H__
+
+///
+/// \brief  The same Key yields the same shared List, a different Key another one.
+///
+void test_AHR_HeaderListIntern(void);
+///
+/// \brief  Unreferenced Lists are kept for Reuse up to a Limit, Lists without Cache are not shared.
+///
+void test_AHR_HeaderListIdle(void);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef __AHR_TEST_HEADER_PARSER_H__
+#define __AHR_TEST_HEADER_PARSER_H__
+
+///
+/// \brief  Header Lines are classified and split into trimmed Name and Value.
+///
+void test_AHR_HeaderParseLine(void);
+///
+/// \brief  The vectorized Scan finds the same Delimiters as a Byte by Byte Search, at every Position.
+///
+void test_AHR_HeaderScan(void);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef __AHR_TEST_JSON_H__
+#define __AHR_TEST_JSON_H__
+
+///
+/// \brief  Types, Lookups and Values of an indexed Document.
+///
+void test_AHR_JsonIndexNavigate(void);
+///
+/// \brief  A Document fed in Pieces of any Size gives the same Tape as one fed at once.
+///
+void test_AHR_JsonIndexChunked(void);
+///
+/// \brief  Invalid Documents are rejected with the Offset where they stopped being valid.
+///
+void test_AHR_JsonIndexInvalid(void);
+
+#endif
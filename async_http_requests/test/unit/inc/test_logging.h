@@ -0,0 +1,21 @@
+#ifndef __AHR_TEST_LOGGING_H__
+#define __AHR_TEST_LOGGING_H__
+
+///
+/// \brief  Messages are formatted like snprintf() formats them, at the Level they were logged with.
+///
+void test_AHR_LoggerFormat(void);
+///
+/// \brief  A full Ring drops Messages, the next Flush reports how many.
+///
+void test_AHR_LoggerDropped(void);
+///
+/// \brief  Messages of many Threads keep their Order per Thread, also in Rings handed on by exited Threads.
+///
+void test_AHR_LoggerThreads(void);
+///
+/// \brief  The Drain Thread delivers without a Flush, destroying the Logger delivers the Rest.
+///
+void test_AHR_LoggerDrain(void);
+
+#endif
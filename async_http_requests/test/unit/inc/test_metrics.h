@@ -0,0 +1,17 @@
+#ifndef __AHR_TEST_METRICS_H__
+#define __AHR_TEST_METRICS_H__
+
+///
+/// \brief  Counters, Gauges and Origins of a Snapshot.
+///
+void test_AHR_MetricsSnapshot(void);
+///
+/// \brief  Latency Quantiles are within the Precision of the HDR Histogram.
+///
+void test_AHR_MetricsQuantiles(void);
+///
+/// \brief  The Prometheus Text has cumulative Buckets, escaped Labels and does not overflow the Buffer.
+///
+void test_AHR_MetricsPrometheus(void);
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef __AHR_TEST_PROCESSOR_H__
+#define __AHR_TEST_PROCESSOR_H__
+
+///
+/// \brief  The Response Header Accessors reject Objects the Processor does not manage.
+///
+void test_AHR_ProcessorResponseHeaderUnknownObject(void);
+///
+/// \brief  A borrowed Body is sent as is and released once, right before the Callback.
+///
+void test_AHR_ProcessorBorrowedBody(void);
+///
+/// \brief  Configuring an Object again releases the Body it borrowed before.
+///
+void test_AHR_ProcessorBorrowedBodyReconfigured(void);
+///
+/// \brief  on_success configures its Object again and makes the next Request, the Response it got stays intact.
+///
+void test_AHR_ProcessorCallbackResubmit(void);
+///
+/// \brief  A streamed Response reaches on_data Chunk by Chunk and ends in on_complete,
+///         it can be paused, resumed and aborted from on_data.
+///
+void test_AHR_ProcessorStreamedResponse(void);
+///
+/// \brief  A Body Provider is pulled piecewise, with a Content-Length and chunked.
+///
+void test_AHR_ProcessorBodyProvider(void);
+///
+/// \brief  A Response Body goes into the File of the Sink instead of on_success.
+///
+void test_AHR_ProcessorFileSink(void);
+///
+/// \brief  A Request Body is sent from a Range of a File, read piecewise and mapped.
+///
+void test_AHR_ProcessorFileSource(void);
+///
+/// \brief  Each Request sends the Headers of the latest Configuration of its Object, too many Headers are refused.
+///
+void test_AHR_ProcessorRequestHeaders(void);
+///
+/// \brief  Requests with a Path go to the Base URL of their Object.
+///
+void test_AHR_ProcessorBaseUrl(void);
+///
+/// \brief  Only whitelisted Response Headers are stored, they are found ignoring Case.
+///
+void test_AHR_ProcessorResponseHeaderWhitelist(void);
+///
+/// \brief  A gzip Response is decoded while it arrives, its decoded Size can be limited.
+///
+void test_AHR_ProcessorContentDecoding(void);
+///
+/// \brief  Request Bodies are compressed at once or while they are sent, small ones are sent as is.
+///
+void test_AHR_ProcessorContentEncoding(void);
+///
+/// \brief  A JSON Response is indexed while it arrives, the Index can be read within on_success only.
+///
+void test_AHR_ProcessorJsonIndex(void);
+///
+/// \brief  The Timestamps of a Request are in Order and span the Time the Test waited for it.
+///
+void test_AHR_ProcessorRequestTimings(void);
+///
+/// \brief  The Metrics count Responses, Failures and reused Connections of the Processor.
+///
+void test_AHR_ProcessorMetrics(void);
+///
+/// \brief  A traced Processor dumps the Track of a Request as valid Chrome Trace JSON.
+///
+void test_AHR_ProcessorDumpTrace(void);
+///
+/// \brief  A recording Processor records Method, Template, Sizes, Status and Error of each finished Transfer.
+///
+void test_AHR_ProcessorRecord(void);
+///
+/// \brief  A Request Timeout overrides the one of the Processor, streamed Transfers are only aborted once they stall.
+///
+void test_AHR_ProcessorTimeouts(void);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef __AHR_TEST_RECORD_H__
+#define __AHR_TEST_RECORD_H__
+
+///
+/// \brief  Scheme, Host, Fragment, Ids and Query Values are dropped from a URL Template, which is truncated to fit.
+///
+void test_AHR_RecordUrlTemplate(void);
+///
+/// \brief  The Reader returns every Field of the Records the Recorder wrote, in the Order they were added.
+///
+void test_AHR_RecorderRoundTrip(void);
+///
+/// \brief  Many distinct Templates and Records which do not fit the Buffer are read back completely.
+///
+void test_AHR_RecorderTemplates(void);
+///
+/// \brief  Files which are no Recording are not opened, a cut off or damaged Recording reads as corrupt.
+///
+void test_AHR_RecordReaderCorrupt(void);
+
+#endif
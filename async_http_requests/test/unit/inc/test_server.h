@@ -0,0 +1,66 @@
+///
+/// \brief  Loopback HTTP/1.1 Echo Server for the Unit Tests.
+///         Each Connection is served by its own Thread and kept alive until the Client closes it.
+///         The Response Body is the Request Body as received, after removing a chunked Transfer-Encoding
+///         but without decoding a Content-Encoding. The Response Headers describe the Request:
+///
+///             X-Method: POST
+///             X-Path: /echo?id=1
+///             X-Request-Encoding: gzip        ("-" without Content-Encoding)
+///             X-Request-Chunked: 1
+///             X-Echo: ...                     (only if the Request had one)
+///             ETag: "abc"
+///
+///         A Path starting with "/gzip" answers with the gzip-compressed Body and "Content-Encoding: gzip"
+///         if the Client offers gzip.
+///
+/// \example    TEST_Server_t server = TEST_ServerStart();
+///             printf("http://127.0.0.1:%u/echo\n", TEST_ServerPort(server));
+///             ...
+///             TEST_ServerStop(&server);
+///
+#ifndef __AHR_TEST_SERVER_H__
+#define __AHR_TEST_SERVER_H__
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+struct TEST_Server;
+typedef struct TEST_Server* TEST_Server_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Listen on a free Port of 127.0.0.1 and serve from new Threads.
+/// \returns    NULL if the Socket or the Thread can not be created.
+///
+TEST_Server_t TEST_ServerStart(void);
+uint16_t TEST_ServerPort(const TEST_Server_t server);
+///
+/// \brief  Number of Requests answered so far.
+///
+uint64_t TEST_ServerRequests(const TEST_Server_t server);
+///
+/// \brief  Number of Connections accepted so far.
+///
+uint64_t TEST_ServerConnections(const TEST_Server_t server);
+///
+/// \brief  Close all Connections and wait for their Threads.
+///
+void TEST_ServerStop(TEST_Server_t *server);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef __AHR_TEST_TRACE_H__
+#define __AHR_TEST_TRACE_H__
+
+///
+/// \brief  A Dump is valid Chrome Trace JSON with the recorded Slices in Order, and consumes them.
+///
+void test_AHR_TraceDump(void);
+///
+/// \brief  A full Ring drops Events, a NULL Tracer records nothing.
+///
+void test_AHR_TraceDropped(void);
+
+#endif
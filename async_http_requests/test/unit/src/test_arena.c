@@ -0,0 +1,113 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <test_arena.h>
+#include <external/async_http_requests/ahr_arena.h>
+#include <async_http_requests/ahr_http_request_processor.h>
+#include <async_http_requests/private/ahr_logging.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void TEST_LogDiscard(void *arg, const char *msg)
+{
+    (void)arg;
+    (void)msg;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_ArenaAlloc(void)
+{
+    AHR_Arena_t arena = AHR_CreateArena(4096, 0);
+    TEST_ASSERT_TRUE(AHR_ArenaIsValid(&arena));
+    TEST_ASSERT_GREATER_OR_EQUAL_size_t(4096, AHR_ArenaCapacity(&arena));
+    TEST_ASSERT_EQUAL_size_t(0, AHR_ArenaUsed(&arena));
+
+    TEST_ASSERT_EQUAL_size_t(AHR_ARENA_ALIGNMENT, AHR_ArenaAlignedSize(1));
+    TEST_ASSERT_EQUAL_size_t(AHR_ARENA_ALIGNMENT, AHR_ArenaAlignedSize(AHR_ARENA_ALIGNMENT));
+    TEST_ASSERT_EQUAL_size_t(2U * AHR_ARENA_ALIGNMENT, AHR_ArenaAlignedSize(AHR_ARENA_ALIGNMENT + 1U));
+
+    unsigned char *first = AHR_ArenaAlloc(&arena, 10);
+    unsigned char *second = AHR_ArenaAlloc(&arena, 100);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_EQUAL_size_t(0, (uintptr_t)first % AHR_ARENA_ALIGNMENT);
+    TEST_ASSERT_EQUAL_size_t(0, (uintptr_t)second % AHR_ARENA_ALIGNMENT);
+    TEST_ASSERT_EQUAL_PTR(first + AHR_ArenaAlignedSize(10), second);
+    TEST_ASSERT_EQUAL_size_t(AHR_ArenaAlignedSize(10) + AHR_ArenaAlignedSize(100), AHR_ArenaUsed(&arena));
+    for(size_t i=0;i<100;++i)
+    {
+        TEST_ASSERT_EQUAL_UINT8(0, second[i]);
+    }
+    //
+    // Exhausted: the failed Allocation does not consume anything.
+    //
+    const size_t rest = AHR_ArenaCapacity(&arena) - AHR_ArenaUsed(&arena);
+    TEST_ASSERT_NULL(AHR_ArenaAlloc(&arena, rest + 1U));
+    TEST_ASSERT_NOT_NULL(AHR_ArenaAlloc(&arena, rest));
+    TEST_ASSERT_EQUAL_size_t(AHR_ArenaCapacity(&arena), AHR_ArenaUsed(&arena));
+    TEST_ASSERT_NULL(AHR_ArenaAlloc(&arena, 1));
+
+    AHR_DestroyArena(&arena);
+    TEST_ASSERT_FALSE(AHR_ArenaIsValid(&arena));
+}
+
+void test_AHR_ArenaFlags(void)
+{
+    AHR_Arena_t arena = AHR_CreateArena(
+        1U << 20U,
+        AHR_ARENA_HUGE_PAGES | AHR_ARENA_TRANSPARENT_HUGE_PAGES | AHR_ARENA_PREFAULT
+    );
+    TEST_ASSERT_TRUE(AHR_ArenaIsValid(&arena));
+    TEST_ASSERT_GREATER_OR_EQUAL_size_t(1U << 20U, AHR_ArenaCapacity(&arena));
+    TEST_ASSERT_EQUAL_UINT(0, AHR_ArenaFlags(&arena) & ~(unsigned int)(
+        AHR_ARENA_HUGE_PAGES | AHR_ARENA_TRANSPARENT_HUGE_PAGES | AHR_ARENA_PREFAULT
+    ));
+    char *data = AHR_ArenaAlloc(&arena, 1U << 19U);
+    TEST_ASSERT_NOT_NULL(data);
+    memset(data, 0xA5, 1U << 19U);
+    AHR_DestroyArena(&arena);
+}
+
+void test_AHR_ProcessorFootprint(void)
+{
+    const AHR_LoggerOptions_t log_options = {
+        .arg = NULL,
+        .info = TEST_LogDiscard,
+        .warning = TEST_LogDiscard,
+        .error = TEST_LogDiscard,
+        .ring_capacity = 0,
+        .drain_interval_ms = 0,
+        .manual_flush = true
+    };
+    AHR_Logger_t logger = AHR_CreateLoggerWithOptions(&log_options);
+    const AHR_ProcessorOptions_t options = {.max_objects = 8, .memory_flags = AHR_PROCESSOR_PREFAULT};
+    AHR_Processor_t processor = AHR_CreateProcessorWithOptions(&options, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+
+    AHR_ProcessorFootprint_t footprint;
+    AHR_ProcessorFootprint(processor, &footprint);
+    TEST_ASSERT_GREATER_THAN_size_t(0, footprint.arena_used);
+    TEST_ASSERT_LESS_OR_EQUAL_size_t(footprint.arena_bytes, footprint.arena_used);
+    TEST_ASSERT_FALSE(footprint.huge_pages);
+    //
+    // The Arena grows with the Number of Objects.
+    //
+    const AHR_ProcessorOptions_t more = {.max_objects = 16, .memory_flags = 0};
+    AHR_Processor_t larger = AHR_CreateProcessorWithOptions(&more, logger);
+    TEST_ASSERT_NOT_NULL(larger);
+    AHR_ProcessorFootprint_t larger_footprint;
+    AHR_ProcessorFootprint(larger, &larger_footprint);
+    TEST_ASSERT_GREATER_THAN_size_t(footprint.arena_used, larger_footprint.arena_used);
+
+    AHR_DestroyProcessor(&larger);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+}
@@ -0,0 +1,129 @@
+#include <string.h>
+
+#include <test_buffer_pool.h>
+#include <async_http_requests/private/ahr_buffer_pool.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_BufferPoolSizeClasses(void)
+{
+    AHR_BufferPool_t pool = AHR_CreateBufferPool();
+    TEST_ASSERT_TRUE(AHR_BufferPoolIsValid(&pool));
+
+    const size_t requests[] = {1, 4096, 4097, 16384, 16385, 65536, 65537, 262144};
+    const size_t capacities[] = {4096, 4096, 16384, 16384, 65536, 65536, 262144, 262144};
+    char *buffers[sizeof(requests) / sizeof(requests[0])];
+    for(size_t i=0;i<sizeof(requests) / sizeof(requests[0]);++i)
+    {
+        buffers[i] = AHR_BufferPoolAcquire(&pool, NULL, requests[i]);
+        TEST_ASSERT_NOT_NULL(buffers[i]);
+        TEST_ASSERT_EQUAL_size_t(capacities[i], AHR_BufferCapacity(buffers[i]));
+        memset(buffers[i], 0x5A, AHR_BufferCapacity(buffers[i]));
+    }
+    TEST_ASSERT_EQUAL_size_t(262144, AHR_BufferPoolMaxSize());
+    TEST_ASSERT_NULL(AHR_BufferPoolAcquire(&pool, NULL, AHR_BufferPoolMaxSize() + 1U));
+
+    AHR_BufferPoolStats_t stats;
+    AHR_BufferPoolStats(&pool, &stats);
+    for(size_t i=0;i<AHR_BUFFER_POOL_CLASSES;++i)
+    {
+        TEST_ASSERT_EQUAL_size_t(capacities[2U * i], stats.classes[i].buffer_size);
+        TEST_ASSERT_EQUAL_UINT64(2, stats.classes[i].acquired);
+        TEST_ASSERT_EQUAL_size_t(2, stats.classes[i].in_use);
+    }
+    TEST_ASSERT_EQUAL_size_t(2U * (4096U + 16384U + 65536U + 262144U), stats.bytes_in_use);
+
+    for(size_t i=0;i<sizeof(buffers) / sizeof(buffers[0]);++i)
+    {
+        AHR_BufferPoolRelease(&pool, NULL, buffers[i]);
+    }
+    AHR_BufferPoolStats(&pool, &stats);
+    TEST_ASSERT_EQUAL_size_t(0, stats.bytes_in_use);
+    TEST_ASSERT_EQUAL_size_t(2U * (4096U + 16384U + 65536U + 262144U), stats.bytes_high_water);
+    AHR_DestroyBufferPool(&pool);
+}
+
+void test_AHR_BufferPoolReuse(void)
+{
+    AHR_BufferPool_t pool = AHR_CreateBufferPool();
+    AHR_BufferCache_t cache = AHR_CreateBufferCache(&pool);
+    //
+    // Through the Cache: the second Acquire gets the released Buffer back without an Allocation.
+    //
+    char *first = AHR_BufferPoolAcquire(&pool, &cache, 100);
+    TEST_ASSERT_NOT_NULL(first);
+    AHR_BufferPoolRelease(&pool, &cache, first);
+    char *second = AHR_BufferPoolAcquire(&pool, &cache, 200);
+    TEST_ASSERT_EQUAL_PTR(first, second);
+
+    AHR_BufferPoolStats_t stats;
+    AHR_BufferPoolStats(&pool, &stats);
+    TEST_ASSERT_EQUAL_UINT64(2, stats.classes[0].acquired);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.classes[0].allocated);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.classes[0].cache_hits);
+    //
+    // A full Cache gives half of its Buffers to the Depot, another Thread finds them there.
+    //
+    char *buffers[AHR_BUFFER_CACHE_SIZE + 1U];
+    buffers[0] = second;
+    for(size_t i=1;i<AHR_BUFFER_CACHE_SIZE + 1U;++i)
+    {
+        buffers[i] = AHR_BufferPoolAcquire(&pool, &cache, 100);
+        TEST_ASSERT_NOT_NULL(buffers[i]);
+    }
+    for(size_t i=0;i<AHR_BUFFER_CACHE_SIZE + 1U;++i)
+    {
+        AHR_BufferPoolRelease(&pool, &cache, buffers[i]);
+    }
+    AHR_BufferPoolStats(&pool, &stats);
+    TEST_ASSERT_EQUAL_size_t(0, stats.classes[0].in_use);
+    TEST_ASSERT_EQUAL_size_t(AHR_BUFFER_CACHE_SIZE + 1U, stats.classes[0].idle);
+    TEST_ASSERT_EQUAL_size_t(AHR_BUFFER_CACHE_SIZE + 1U, stats.classes[0].high_water);
+
+    AHR_BufferCache_t other = AHR_CreateBufferCache(&pool);
+    char *borrowed = AHR_BufferPoolAcquire(&pool, &other, 100);
+    TEST_ASSERT_NOT_NULL(borrowed);
+    AHR_BufferPoolStats(&pool, &stats);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.classes[0].depot_hits);
+    TEST_ASSERT_EQUAL_UINT64(AHR_BUFFER_CACHE_SIZE + 1U, stats.classes[0].allocated);
+    AHR_BufferPoolRelease(&pool, &other, borrowed);
+
+    AHR_DestroyBufferCache(&other);
+    AHR_DestroyBufferCache(&cache);
+    TEST_ASSERT_EQUAL_size_t((AHR_BUFFER_CACHE_SIZE + 1U) * (64U + 4096U), AHR_BufferPoolBytes(&pool));
+    AHR_DestroyBufferPool(&pool);
+}
+
+void test_AHR_BufferPoolLearn(void)
+{
+    AHR_BufferPool_t pool = AHR_CreateBufferPool();
+    //
+    // Query and Fragment do not belong to the Endpoint, a Key can be continued.
+    //
+    const uint64_t key = AHR_BufferPoolEndpointKey("http://example.com/items?id=1");
+    TEST_ASSERT_EQUAL_UINT64(key, AHR_BufferPoolEndpointKey("http://example.com/items#top"));
+    const uint64_t origin = AHR_BufferPoolEndpointKey("http://example.com");
+    TEST_ASSERT_EQUAL_UINT64(key, AHR_BufferPoolEndpointKeyFrom(origin, "/items"));
+    TEST_ASSERT_NOT_EQUAL(key, AHR_BufferPoolEndpointKey("http://example.com/other"));
+
+    TEST_ASSERT_EQUAL_size_t(0, AHR_BufferPoolExpected(&pool, key));
+    AHR_BufferPoolLearn(&pool, key, 1000);
+    TEST_ASSERT_EQUAL_size_t(1000, AHR_BufferPoolExpected(&pool, key));
+    AHR_BufferPoolLearn(&pool, key, 5000);
+    TEST_ASSERT_EQUAL_size_t(5000, AHR_BufferPoolExpected(&pool, key));
+    AHR_BufferPoolLearn(&pool, key, 1000);
+    TEST_ASSERT_EQUAL_size_t(4000, AHR_BufferPoolExpected(&pool, key));
+    //
+    // A colliding Endpoint replaces the learned Size.
+    //
+    const uint64_t collision = key + AHR_BUFFER_POOL_ENDPOINTS;
+    AHR_BufferPoolLearn(&pool, collision, 10);
+    TEST_ASSERT_EQUAL_size_t(10, AHR_BufferPoolExpected(&pool, collision));
+    TEST_ASSERT_EQUAL_size_t(0, AHR_BufferPoolExpected(&pool, key));
+    AHR_DestroyBufferPool(&pool);
+}
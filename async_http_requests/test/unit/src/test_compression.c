@@ -0,0 +1,303 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+#ifdef AHR_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include <test_compression.h>
+#include <external/async_http_requests/ahr_compression.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define TEST_COMPRESSION_BODY (100U * 1024U)
+
+///
+/// \brief  Source Provider over a Buffer, see AHR_BodyProvider_t.
+///
+typedef struct
+{
+    const char *data;
+    size_t nbytes;
+    size_t offset;
+} TEST_Source_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static size_t TEST_SourceRead(void *user, char *buffer, size_t nbytes)
+{
+    TEST_Source_t *source = user;
+    const size_t n = source->nbytes - source->offset < nbytes ? source->nbytes - source->offset : nbytes;
+    memcpy(buffer, source->data + source->offset, n); // flawfinder: ignore
+    source->offset += n;
+    return n;
+}
+
+static bool TEST_SourceRewind(void *user)
+{
+    ((TEST_Source_t*)user)->offset = 0;
+    return true;
+}
+
+///
+/// \brief  A Body which compresses, but not to Nothing: Words picked by a fixed Generator.
+///
+static char* TEST_Body(size_t nbytes)
+{
+    static const char *const words[] = {"alpha ", "beta ", "gamma ", "delta ", "\"id\": ", "1234, ", "\n"};
+    char *body = malloc(nbytes);
+    uint32_t state = 12345U;
+    for(size_t i=0;body && i<nbytes;)
+    {
+        state = state * 1103515245U + 12345U;
+        const char *word = words[(state >> 16U) % (sizeof(words) / sizeof(words[0]))];
+        for(size_t j=0;word[j] && i<nbytes;++j)
+        {
+            body[i++] = word[j];
+        }
+    }
+    return body;
+}
+
+///
+/// \brief  Decompress a gzip, zlib or zstd Body into "out".
+/// \returns    Decompressed Size, -1 on Error.
+///
+static int64_t TEST_Decompress(
+    unsigned int encoding,
+    const void *dictionary,
+    size_t dictionary_bytes,
+    const char *data,
+    size_t nbytes,
+    char *out,
+    size_t capacity
+)
+{
+    if(AHR_ENCODING_ZSTD == encoding)
+    {
+#ifdef AHR_WITH_ZSTD
+        ZSTD_DCtx *context = ZSTD_createDCtx();
+        const size_t n = dictionary
+            ? ZSTD_decompress_usingDict(context, out, capacity, data, nbytes, dictionary, dictionary_bytes)
+            : ZSTD_decompressDCtx(context, out, capacity, data, nbytes);
+        ZSTD_freeDCtx(context);
+        return ZSTD_isError(n) ? -1 : (int64_t)n;
+#else
+        (void)dictionary;
+        (void)dictionary_bytes;
+        return -1;
+#endif
+    }
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    //
+    // 32 detects the gzip and the zlib Header.
+    //
+    if(Z_OK != inflateInit2(&stream, 15 + 32))
+    {
+        return -1;
+    }
+    stream.next_in = (Bytef*)(uintptr_t)data;
+    stream.avail_in = (uInt)nbytes;
+    stream.next_out = (Bytef*)out;
+    stream.avail_out = (uInt)capacity;
+    const int status = inflate(&stream, Z_FINISH);
+    const int64_t n = (int64_t)stream.total_out;
+    inflateEnd(&stream);
+    return Z_STREAM_END == status ? n : -1;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_CompressRoundTrip(void)
+{
+    TEST_ASSERT_EQUAL_STRING("gzip", AHR_CompressionToken(AHR_ENCODING_GZIP));
+    TEST_ASSERT_EQUAL_STRING("deflate", AHR_CompressionToken(AHR_ENCODING_DEFLATE));
+    TEST_ASSERT_EQUAL_STRING("zstd", AHR_CompressionToken(AHR_ENCODING_ZSTD));
+    TEST_ASSERT_NULL(AHR_CompressionToken(AHR_ENCODING_GZIP | AHR_ENCODING_ZSTD));
+    TEST_ASSERT_EQUAL_UINT(0, AHR_CompressionSupported(AHR_ENCODING_BROTLI | AHR_ENCODING_IDENTITY));
+#ifdef AHR_WITH_ZSTD
+    TEST_ASSERT_EQUAL_UINT(AHR_ENCODING_ZSTD, AHR_CompressionSupported(AHR_ENCODING_ZSTD));
+#else
+    TEST_ASSERT_EQUAL_UINT(0, AHR_CompressionSupported(AHR_ENCODING_ZSTD));
+#endif
+
+    char *body = TEST_Body(TEST_COMPRESSION_BODY);
+    char *decoded = malloc(TEST_COMPRESSION_BODY);
+    TEST_ASSERT_NOT_NULL(body);
+    TEST_ASSERT_NOT_NULL(decoded);
+    AHR_Compressor_t compressor = AHR_CreateCompressor();
+    const unsigned int encodings[] = {AHR_ENCODING_GZIP, AHR_ENCODING_DEFLATE, AHR_ENCODING_ZSTD};
+    const int levels[] = {0, 1, 9};
+    for(size_t i=0;i<sizeof(encodings) / sizeof(encodings[0]);++i)
+    {
+        if(!AHR_CompressionSupported(encodings[i]))
+        {
+            continue;
+        }
+        const size_t bound = AHR_CompressBound(encodings[i], TEST_COMPRESSION_BODY);
+        TEST_ASSERT_GREATER_THAN_size_t(TEST_COMPRESSION_BODY, bound);
+        char *compressed = malloc(bound);
+        TEST_ASSERT_NOT_NULL(compressed);
+        //
+        // Each Level reuses the Context of the previous Body.
+        //
+        for(size_t j=0;j<sizeof(levels) / sizeof(levels[0]);++j)
+        {
+            const int64_t n = AHR_Compress(
+                &compressor, encodings[i], levels[j], NULL, body, TEST_COMPRESSION_BODY, compressed, bound
+            );
+            TEST_ASSERT_GREATER_THAN_INT64(0, n);
+            TEST_ASSERT_LESS_THAN_INT64((int64_t)TEST_COMPRESSION_BODY / 2, n);
+            TEST_ASSERT_EQUAL_INT64(
+                (int64_t)TEST_COMPRESSION_BODY,
+                TEST_Decompress(encodings[i], NULL, 0, compressed, (size_t)n, decoded, TEST_COMPRESSION_BODY)
+            );
+            TEST_ASSERT_EQUAL_MEMORY(body, decoded, TEST_COMPRESSION_BODY);
+        }
+        //
+        // Too small a Buffer fails instead of truncating.
+        //
+        TEST_ASSERT_EQUAL_INT64(
+            -1,
+            AHR_Compress(&compressor, encodings[i], 0, NULL, body, TEST_COMPRESSION_BODY, compressed, 16)
+        );
+        free(compressed);
+    }
+    AHR_DestroyCompressor(&compressor);
+    free(decoded);
+    free(body);
+}
+
+void test_AHR_CompressorStream(void)
+{
+    char *body = TEST_Body(TEST_COMPRESSION_BODY);
+    char *compressed = malloc(2U * TEST_COMPRESSION_BODY);
+    char *decoded = malloc(TEST_COMPRESSION_BODY);
+    TEST_ASSERT_NOT_NULL(body);
+    TEST_ASSERT_NOT_NULL(compressed);
+    TEST_ASSERT_NOT_NULL(decoded);
+
+    AHR_Compressor_t compressor = AHR_CreateCompressor();
+    const unsigned int encodings[] = {AHR_ENCODING_GZIP, AHR_ENCODING_DEFLATE, AHR_ENCODING_ZSTD};
+    for(size_t i=0;i<sizeof(encodings) / sizeof(encodings[0]);++i)
+    {
+        if(!AHR_CompressionSupported(encodings[i]))
+        {
+            continue;
+        }
+        TEST_Source_t source = {.data = body, .nbytes = TEST_COMPRESSION_BODY, .offset = 0};
+        const AHR_BodyProvider_t provider = {
+            .read = TEST_SourceRead,
+            .rewind = TEST_SourceRewind,
+            .user = &source,
+            .content_length = (int64_t)TEST_COMPRESSION_BODY
+        };
+        TEST_ASSERT_TRUE(AHR_CompressorBeginStream(&compressor, encodings[i], 0, NULL, &provider));
+        const AHR_BodyProvider_t stream = AHR_CompressorProvider(&compressor);
+        TEST_ASSERT_EQUAL_INT64(AHR_BODY_PROVIDER_CHUNKED, stream.content_length);
+        //
+        // Read twice, the second Time after a Rewind, in Pieces of odd Sizes like curls Upload Buffer.
+        //
+        for(size_t pass=0;pass<2;++pass)
+        {
+            if(pass > 0)
+            {
+                TEST_ASSERT_NOT_NULL(stream.rewind);
+                TEST_ASSERT_TRUE(stream.rewind(stream.user));
+            }
+            size_t nbytes = 0;
+            for(;;)
+            {
+                const size_t step = 1000U + nbytes % 777U;
+                TEST_ASSERT_TRUE(nbytes + step <= 2U * TEST_COMPRESSION_BODY);
+                const size_t n = stream.read(stream.user, compressed + nbytes, step);
+                TEST_ASSERT_TRUE(AHR_BODY_PROVIDER_ABORT != n);
+                if(0 == n)
+                {
+                    break;
+                }
+                nbytes += n;
+            }
+            TEST_ASSERT_EQUAL_UINT64(TEST_COMPRESSION_BODY, compressor.consumed);
+            TEST_ASSERT_EQUAL_UINT64(nbytes, compressor.produced);
+            TEST_ASSERT_EQUAL_INT64(
+                (int64_t)TEST_COMPRESSION_BODY,
+                TEST_Decompress(encodings[i], NULL, 0, compressed, nbytes, decoded, TEST_COMPRESSION_BODY)
+            );
+            TEST_ASSERT_EQUAL_MEMORY(body, decoded, TEST_COMPRESSION_BODY);
+        }
+    }
+    AHR_DestroyCompressor(&compressor);
+    free(decoded);
+    free(compressed);
+    free(body);
+}
+
+void test_AHR_CompressDictionary(void)
+{
+#ifdef AHR_WITH_ZSTD
+    //
+    // Many small JSON Documents with the same Structure, the Case Dictionaries are made for.
+    //
+    char samples[400][96]; // flawfinder: ignore
+    const char *pointers[400];
+    size_t sizes[400];
+    for(size_t i=0;i<400;++i)
+    {
+        const int n = snprintf(
+            samples[i], sizeof(samples[i]), "{\"id\": %zu, \"name\": \"user-%zu\", \"active\": %s, \"tags\": [\"a\"]}",
+            i * 7919U, i, (i % 3U) ? "true" : "false"
+        );
+        pointers[i] = samples[i];
+        sizes[i] = (size_t)n;
+    }
+    char dictionary[16384]; // flawfinder: ignore
+    const size_t dictionary_bytes = AHR_CompressionTrainDictionary(
+        pointers, sizes, 400, dictionary, sizeof(dictionary)
+    );
+    TEST_ASSERT_GREATER_THAN_size_t(0, dictionary_bytes);
+    AHR_CompressionDictionary_t digested = AHR_CreateCompressionDictionary(dictionary, dictionary_bytes, 3);
+    TEST_ASSERT_TRUE(AHR_CompressionDictionaryIsValid(&digested));
+    TEST_ASSERT_NOT_EQUAL(0, digested.id);
+
+    AHR_Compressor_t compressor = AHR_CreateCompressor();
+    char compressed[256]; // flawfinder: ignore
+    char decoded[96]; // flawfinder: ignore
+    const int64_t with = AHR_Compress(
+        &compressor, AHR_ENCODING_ZSTD, 0, &digested, samples[7], sizes[7], compressed, sizeof(compressed)
+    );
+    TEST_ASSERT_GREATER_THAN_INT64(0, with);
+    TEST_ASSERT_EQUAL_INT64(
+        (int64_t)sizes[7],
+        TEST_Decompress(
+            AHR_ENCODING_ZSTD, dictionary, dictionary_bytes, compressed, (size_t)with, decoded, sizeof(decoded)
+        )
+    );
+    TEST_ASSERT_EQUAL_MEMORY(samples[7], decoded, sizes[7]);
+    const int64_t without = AHR_Compress(
+        &compressor, AHR_ENCODING_ZSTD, 0, NULL, samples[7], sizes[7], compressed, sizeof(compressed)
+    );
+    TEST_ASSERT_LESS_THAN_INT64(without, with);
+
+    AHR_DestroyCompressor(&compressor);
+    AHR_DestroyCompressionDictionary(&digested);
+    TEST_ASSERT_FALSE(AHR_CompressionDictionaryIsValid(&digested));
+#else
+    const char dictionary[] = "not a dictionary";
+    AHR_CompressionDictionary_t digested = AHR_CreateCompressionDictionary(dictionary, sizeof(dictionary), 0);
+    TEST_ASSERT_FALSE(AHR_CompressionDictionaryIsValid(&digested));
+#endif
+}
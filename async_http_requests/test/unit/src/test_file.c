@@ -0,0 +1,145 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <test_file.h>
+#include <external/async_http_requests/ahr_file.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Create an unlinked temporary File.
+///
+static int TEST_TempFile(void)
+{
+    char path[] = "/tmp/ahr_test_file_XXXXXX"; // flawfinder: ignore
+    const int fd = mkstemp(path);
+    if(fd >= 0)
+    {
+        unlink(path);
+    }
+    return fd;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_FileWriterWrite(void)
+{
+    const int fd = TEST_TempFile();
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(4, pwrite(fd, "head", 4, 0));
+
+    const AHR_FileSink_t sink = {
+        .fd = fd,
+        .offset = 4,
+        .flags = AHR_FILE_SINK_PREALLOCATE | AHR_FILE_SINK_SEQUENTIAL | AHR_FILE_SINK_DONTNEED
+    };
+    AHR_FileWriter_t writer = AHR_CreateFileWriter();
+    AHR_FileWriterReset(&writer, &sink);
+    TEST_ASSERT_TRUE(AHR_FileWriterWrite(&writer, fd, "first ", 6, 17));
+    TEST_ASSERT_TRUE(AHR_FileWriterWrite(&writer, fd, "second ", 7, 17));
+    TEST_ASSERT_TRUE(AHR_FileWriterWrite(&writer, fd, "last", 4, 17));
+    AHR_FileWriterEnd(&writer, fd);
+    TEST_ASSERT_EQUAL_UINT64(17, writer.written);
+
+    char contents[32]; // flawfinder: ignore
+    TEST_ASSERT_EQUAL_INT(21, pread(fd, contents, sizeof(contents), 0));
+    TEST_ASSERT_EQUAL_MEMORY("headfirst second last", contents, 21);
+    //
+    // A new Download starts over at the Offset of its Sink.
+    //
+    AHR_FileWriterReset(&writer, &sink);
+    TEST_ASSERT_TRUE(AHR_FileWriterWrite(&writer, fd, "FIRST", 5, -1));
+    AHR_FileWriterEnd(&writer, fd);
+    TEST_ASSERT_EQUAL_UINT64(5, writer.written);
+    TEST_ASSERT_EQUAL_INT(21, pread(fd, contents, sizeof(contents), 0));
+    TEST_ASSERT_EQUAL_MEMORY("headFIRST second last", contents, 21);
+    //
+    // A closed Descriptor fails the Write.
+    //
+    close(fd);
+    AHR_FileWriterReset(&writer, &sink);
+    TEST_ASSERT_FALSE(AHR_FileWriterWrite(&writer, fd, "lost", 4, -1));
+}
+
+void test_AHR_FileReaderRange(void)
+{
+    const int fd = TEST_TempFile();
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(16, pwrite(fd, "0123456789abcdef", 16, 0));
+    //
+    // The same Range through pread() and through a Mapping.
+    //
+    const unsigned int flags[] = {0U, AHR_FILE_SOURCE_MMAP};
+    for(size_t i=0;i<sizeof(flags) / sizeof(flags[0]);++i)
+    {
+        const AHR_FileSource_t source = {.path = NULL, .fd = fd, .offset = 4, .length = 8, .flags = flags[i]};
+        AHR_FileReader_t reader = AHR_CreateFileReader();
+        TEST_ASSERT_TRUE(AHR_FileReaderOpen(&reader, &source));
+        TEST_ASSERT_EQUAL_INT64(8, AHR_FileReaderLength(&reader));
+        if(AHR_FILE_SOURCE_MMAP == flags[i])
+        {
+            TEST_ASSERT_NOT_NULL(AHR_FileReaderData(&reader));
+            TEST_ASSERT_EQUAL_MEMORY("456789ab", AHR_FileReaderData(&reader), 8);
+        }
+        else
+        {
+            TEST_ASSERT_NULL(AHR_FileReaderData(&reader));
+        }
+
+        char buffer[8]; // flawfinder: ignore
+        TEST_ASSERT_EQUAL_size_t(5, AHR_FileReaderRead(&reader, buffer, 5));
+        TEST_ASSERT_EQUAL_MEMORY("45678", buffer, 5);
+        TEST_ASSERT_EQUAL_size_t(3, AHR_FileReaderRead(&reader, buffer, sizeof(buffer)));
+        TEST_ASSERT_EQUAL_MEMORY("9ab", buffer, 3);
+        TEST_ASSERT_EQUAL_size_t(0, AHR_FileReaderRead(&reader, buffer, sizeof(buffer)));
+        TEST_ASSERT_TRUE(AHR_FileReaderRewind(&reader));
+        TEST_ASSERT_EQUAL_size_t(2, AHR_FileReaderRead(&reader, buffer, 2));
+        TEST_ASSERT_EQUAL_MEMORY("45", buffer, 2);
+        AHR_FileReaderClose(&reader);
+    }
+    //
+    // A negative Length reaches to the End of the File, a Range beyond it is rejected.
+    //
+    AHR_FileReader_t reader = AHR_CreateFileReader();
+    const AHR_FileSource_t rest = {.path = NULL, .fd = fd, .offset = 10, .length = -1, .flags = 0};
+    TEST_ASSERT_TRUE(AHR_FileReaderOpen(&reader, &rest));
+    TEST_ASSERT_EQUAL_INT64(6, AHR_FileReaderLength(&reader));
+    AHR_FileReaderClose(&reader);
+    const AHR_FileSource_t beyond = {.path = NULL, .fd = fd, .offset = 10, .length = 7, .flags = 0};
+    TEST_ASSERT_FALSE(AHR_FileReaderOpen(&reader, &beyond));
+    //
+    // The Callers Descriptor stays open.
+    //
+    char probe; // flawfinder: ignore
+    TEST_ASSERT_EQUAL_INT(1, pread(fd, &probe, 1, 0));
+    close(fd);
+}
+
+void test_AHR_FileReaderPath(void)
+{
+    AHR_FileReader_t reader = AHR_CreateFileReader();
+    const AHR_FileSource_t missing = {.path = "/nonexistent/ahr_test", .fd = -1, .offset = 0, .length = -1, .flags = 0};
+    TEST_ASSERT_FALSE(AHR_FileReaderOpen(&reader, &missing));
+
+    char path[] = "/tmp/ahr_test_file_XXXXXX"; // flawfinder: ignore
+    const int fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(5, pwrite(fd, "hello", 5, 0));
+    close(fd);
+
+    const AHR_FileSource_t source = {.path = path, .fd = -1, .offset = 0, .length = -1, .flags = AHR_FILE_SOURCE_MMAP};
+    TEST_ASSERT_TRUE(AHR_FileReaderOpen(&reader, &source));
+    TEST_ASSERT_TRUE(reader.owns_fd);
+    TEST_ASSERT_EQUAL_MEMORY("hello", AHR_FileReaderData(&reader), 5);
+    AHR_FileReaderClose(&reader);
+    unlink(path);
+}
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <test_header_block.h>
+#include <async_http_requests/private/ahr_header_block.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+void test_AHR_HeaderBlockAppend(void)
+{
+    AHR_HeaderBlock_t block = AHR_CreateHeaderBlock();
+    TEST_ASSERT_EQUAL_INT(0, AHR_HeaderBlockSize(&block));
+
+    TEST_ASSERT_TRUE(AHR_HeaderBlockAppend(&block, "ETag", 4, "\"abc\"", 5));
+    TEST_ASSERT_TRUE(AHR_HeaderBlockAppend(&block, "Content-Length", 14, "42", 2));
+    TEST_ASSERT_EQUAL_INT(2, AHR_HeaderBlockSize(&block));
+
+    AHR_HeaderView_t view;
+    TEST_ASSERT_TRUE(AHR_HeaderBlockAt(&block, 1, &view));
+    TEST_ASSERT_EQUAL_INT(14, view.name_len);
+    TEST_ASSERT_EQUAL_MEMORY("Content-Length", view.name, view.name_len);
+    TEST_ASSERT_EQUAL_INT(2, view.value_len);
+    TEST_ASSERT_EQUAL_MEMORY("42", view.value, view.value_len);
+
+    TEST_ASSERT_FALSE(AHR_HeaderBlockAt(&block, 2, &view));
+
+    AHR_DestroyHeaderBlock(&block);
+    TEST_ASSERT_NULL(block.arena);
+    TEST_ASSERT_NULL(block.fields);
+}
+
+void test_AHR_HeaderBlockReset(void)
+{
+    AHR_HeaderBlock_t block = AHR_CreateHeaderBlock();
+    AHR_HeaderBlockAppend(&block, "Server", 6, "test", 4);
+    const size_t capacity = AHR_HeaderBlockCapacityBytes(&block);
+
+    AHR_HeaderBlockReset(&block);
+    TEST_ASSERT_EQUAL_INT(0, AHR_HeaderBlockSize(&block));
+    TEST_ASSERT_EQUAL_INT(capacity, AHR_HeaderBlockCapacityBytes(&block));
+
+    AHR_DestroyHeaderBlock(&block);
+}
+
+void test_AHR_HeaderBlockLimits(void)
+{
+    static char value[AHR_HEADERENTRY_VALUE_LEN];
+    memset(value, 'x', sizeof(value));
+
+    AHR_HeaderBlock_t block = AHR_CreateHeaderBlock();
+    TEST_ASSERT_FALSE(AHR_HeaderBlockAppend(&block, "Big", 3, value, sizeof(value)));
+    TEST_ASSERT_EQUAL_INT(0, AHR_HeaderBlockSize(&block));
+
+    for(size_t i=0;i<AHR_HEADER_NMAX;++i)
+    {
+        TEST_ASSERT_TRUE(AHR_HeaderBlockAppend(&block, "A", 1, "b", 1));
+    }
+    TEST_ASSERT_FALSE(AHR_HeaderBlockAppend(&block, "A", 1, "b", 1));
+    TEST_ASSERT_EQUAL_INT(AHR_HEADER_NMAX, AHR_HeaderBlockSize(&block));
+
+    AHR_DestroyHeaderBlock(&block);
+}
+
+void test_AHR_HeaderBlockAssign(void)
+{
+    const AHR_HeaderView_t header[] = {
+        {.name="First", .name_len=5, .value="v0", .value_len=2},
+        {.name="Second", .name_len=6, .value="v1", .value_len=2},
+    };
+    AHR_HeaderBlock_t block = AHR_CreateHeaderBlock();
+    AHR_HeaderBlockAppend(&block, "Old", 3, "x", 1);
+
+    TEST_ASSERT_TRUE(AHR_HeaderBlockAssign(&block, header, 2));
+    TEST_ASSERT_EQUAL_INT(2, AHR_HeaderBlockSize(&block));
+
+    AHR_HeaderView_t view;
+    AHR_HeaderBlockAt(&block, 0, &view);
+    TEST_ASSERT_EQUAL_MEMORY("First", view.name, view.name_len);
+    TEST_ASSERT_EQUAL_MEMORY("v0", view.value, view.value_len);
+
+    AHR_DestroyHeaderBlock(&block);
+}
+
+void test_AHR_HeaderBlockFind(void)
+{
+    AHR_HeaderBlock_t block = AHR_CreateHeaderBlock();
+    AHR_HeaderBlockAppend(&block, "Set-Cookie", 10, "a=1", 3);
+    AHR_HeaderBlockAppend(&block, "ETag", 4, "\"abc\"", 5);
+    AHR_HeaderBlockAppend(&block, "set-cookie", 10, "b=2", 3);
+
+    AHR_HeaderView_t view;
+    TEST_ASSERT_TRUE(AHR_HeaderBlockFind(&block, "etag", 4, &view));
+    TEST_ASSERT_EQUAL_MEMORY("\"abc\"", view.value, view.value_len);
+    TEST_ASSERT_TRUE(AHR_HeaderBlockFind(&block, "SET-COOKIE", 10, &view));
+    TEST_ASSERT_EQUAL_INT(3, view.value_len);
+    TEST_ASSERT_EQUAL_MEMORY("a=1", view.value, view.value_len);
+    TEST_ASSERT_FALSE(AHR_HeaderBlockFind(&block, "ETa", 3, &view));
+    TEST_ASSERT_FALSE(AHR_HeaderBlockFind(&block, "Server", 6, &view));
+    //
+    // The Index follows a Reset and many Headers.
+    //
+    AHR_HeaderBlockReset(&block);
+    TEST_ASSERT_FALSE(AHR_HeaderBlockFind(&block, "ETag", 4, &view));
+    char name[16]; // flawfinder: ignore
+    for(size_t i=0;i<200;++i)
+    {
+        const int n = snprintf(name, sizeof(name), "X-H%zu", i);
+        TEST_ASSERT_TRUE(AHR_HeaderBlockAppend(&block, name, (size_t)n, name, (size_t)n));
+    }
+    for(size_t i=0;i<200;++i)
+    {
+        const int n = snprintf(name, sizeof(name), "x-h%zu", i);
+        TEST_ASSERT_TRUE(AHR_HeaderBlockFind(&block, name, (size_t)n, &view));
+        TEST_ASSERT_EQUAL_INT(n, view.value_len);
+        TEST_ASSERT_EQUAL_MEMORY("X-H", view.value, 3);
+        TEST_ASSERT_EQUAL_MEMORY(name + 3, view.value + 3, (size_t)n - 3U);
+    }
+
+    AHR_DestroyHeaderBlock(&block);
+}
@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <curl/curl.h>
+
+#include <test_header_list.h>
+#include <external/async_http_requests/ahr_header_list.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_HeaderListIntern(void)
+{
+    AHR_HeaderListCache_t cache = AHR_CreateHeaderListCache();
+    TEST_ASSERT_TRUE(AHR_HeaderListCacheIsValid(&cache));
+
+    static const char json[] = "Accept: application/json\0X-Id: 1\0";
+    static const char text[] = "Accept: text/plain\0X-Id: 1\0";
+    AHR_HeaderList_t *first = AHR_HeaderListAcquire(&cache, json, sizeof(json) - 1U);
+    AHR_HeaderList_t *second = AHR_HeaderListAcquire(&cache, json, sizeof(json) - 1U);
+    AHR_HeaderList_t *other = AHR_HeaderListAcquire(&cache, text, sizeof(text) - 1U);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_EQUAL_PTR(first, second);
+    TEST_ASSERT_TRUE(first != other);
+    TEST_ASSERT_TRUE(AHR_HeaderListMatches(first, json, sizeof(json) - 1U));
+    TEST_ASSERT_FALSE(AHR_HeaderListMatches(first, text, sizeof(text) - 1U));
+    TEST_ASSERT_EQUAL_UINT64(1, cache.hits);
+    TEST_ASSERT_EQUAL_UINT64(2, cache.misses);
+    TEST_ASSERT_EQUAL_size_t(2, cache.nlists);
+    TEST_ASSERT_EQUAL_size_t(0, cache.nidle);
+    //
+    // The curl List holds one Entry per Header Line, in Order.
+    //
+    const struct curl_slist *lines = AHR_HeaderListCurl(first);
+    TEST_ASSERT_NOT_NULL(lines);
+    TEST_ASSERT_EQUAL_STRING("Accept: application/json", lines->data);
+    TEST_ASSERT_NOT_NULL(lines->next);
+    TEST_ASSERT_EQUAL_STRING("X-Id: 1", lines->next->data);
+    TEST_ASSERT_NULL(lines->next->next);
+
+    AHR_HeaderListRelease(&cache, first);
+    TEST_ASSERT_EQUAL_size_t(0, cache.nidle);
+    AHR_HeaderListRelease(&cache, second);
+    AHR_HeaderListRelease(&cache, other);
+    TEST_ASSERT_EQUAL_size_t(2, cache.nidle);
+    //
+    // An idle List is found again.
+    //
+    AHR_HeaderList_t *again = AHR_HeaderListAcquire(&cache, json, sizeof(json) - 1U);
+    TEST_ASSERT_EQUAL_PTR(first, again);
+    TEST_ASSERT_EQUAL_UINT64(2, cache.hits);
+    TEST_ASSERT_EQUAL_size_t(1, cache.nidle);
+    AHR_HeaderListRelease(&cache, again);
+    AHR_DestroyHeaderListCache(&cache);
+}
+
+void test_AHR_HeaderListIdle(void)
+{
+    AHR_HeaderListCache_t cache = AHR_CreateHeaderListCache();
+    //
+    // Many distinct Sets: the Cache does not keep all of them once they are released.
+    //
+    AHR_HeaderList_t *lists[100];
+    char keys[100][32]; // flawfinder: ignore
+    size_t lengths[100];
+    for(size_t i=0;i<100;++i)
+    {
+        const int n = snprintf(keys[i], sizeof(keys[i]), "X-Id: %zu", i);
+        lengths[i] = (size_t)n + 1U;
+        lists[i] = AHR_HeaderListAcquire(&cache, keys[i], lengths[i]);
+        TEST_ASSERT_NOT_NULL(lists[i]);
+    }
+    TEST_ASSERT_EQUAL_size_t(100, cache.nlists);
+    for(size_t i=0;i<100;++i)
+    {
+        AHR_HeaderListRelease(&cache, lists[i]);
+    }
+    TEST_ASSERT_LESS_THAN_size_t(100, cache.nlists);
+    TEST_ASSERT_EQUAL_size_t(cache.nlists, cache.nidle);
+    TEST_ASSERT_GREATER_THAN_size_t(0, cache.nidle);
+    //
+    // Without a Cache every Acquisition builds its own List.
+    //
+    AHR_HeaderList_t *first = AHR_HeaderListAcquire(NULL, keys[0], lengths[0]);
+    AHR_HeaderList_t *second = AHR_HeaderListAcquire(NULL, keys[0], lengths[0]);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_TRUE(first != second);
+    TEST_ASSERT_EQUAL_STRING("X-Id: 0", ((const struct curl_slist*)AHR_HeaderListCurl(first))->data);
+    AHR_HeaderListRelease(NULL, first);
+    AHR_HeaderListRelease(NULL, second);
+    AHR_DestroyHeaderListCache(&cache);
+}
@@ -0,0 +1,107 @@
+#include <string.h>
+
+#include <test_header_parser.h>
+#include <async_http_requests/private/ahr_header_parser.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define TEST_SCAN_LEN 100U
+
+///
+/// \brief  Byte by Byte Search with the Semantics of AHR_HeaderScan().
+///
+static void TEST_HeaderScanReference(const char *data, size_t nbytes, size_t *colon, size_t *eol)
+{
+    *eol = nbytes;
+    *colon = nbytes;
+    for(size_t i=0;i<nbytes && nbytes == *eol;++i)
+    {
+        if('\r' == data[i] || '\n' == data[i])
+        {
+            *eol = i;
+        }
+        else if(':' == data[i] && nbytes == *colon)
+        {
+            *colon = i;
+        }
+    }
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_HeaderParseLine(void)
+{
+    AHR_HeaderLine_t line;
+    static const char field[] = "Content-Type: \t text/html; charset=utf-8  \r\n";
+    TEST_ASSERT_EQUAL_INT(AHR_HEADER_LINE_FIELD, AHR_HeaderParseLine(field, sizeof(field) - 1U, &line));
+    TEST_ASSERT_EQUAL_size_t(12, line.name_len);
+    TEST_ASSERT_EQUAL_STRING_LEN("text/html; charset=utf-8", &field[line.value_offset], line.value_len);
+    TEST_ASSERT_EQUAL_size_t(24, line.value_len);
+    //
+    // Not NULL-terminated, no Line End and an empty Value.
+    //
+    static const char bare[] = {'X', '-', 'A', ':'};
+    TEST_ASSERT_EQUAL_INT(AHR_HEADER_LINE_FIELD, AHR_HeaderParseLine(bare, sizeof(bare), &line));
+    TEST_ASSERT_EQUAL_size_t(3, line.name_len);
+    TEST_ASSERT_EQUAL_size_t(0, line.value_len);
+    //
+    // A ':' within the Value belongs to it.
+    //
+    static const char location[] = "Location: http://example.com:8080/\r\n";
+    TEST_ASSERT_EQUAL_INT(AHR_HEADER_LINE_FIELD, AHR_HeaderParseLine(location, sizeof(location) - 1U, &line));
+    TEST_ASSERT_EQUAL_size_t(8, line.name_len);
+    TEST_ASSERT_EQUAL_STRING_LEN("http://example.com:8080/", &location[line.value_offset], line.value_len);
+
+    TEST_ASSERT_EQUAL_INT(AHR_HEADER_LINE_STATUS, AHR_HeaderParseLine("HTTP/1.1 200 OK\r\n", 17, &line));
+    TEST_ASSERT_EQUAL_INT(AHR_HEADER_LINE_STATUS, AHR_HeaderParseLine("HTTP/2 404\r\n", 12, &line));
+    TEST_ASSERT_EQUAL_INT(AHR_HEADER_LINE_END, AHR_HeaderParseLine("\r\n", 2, &line));
+    TEST_ASSERT_EQUAL_INT(AHR_HEADER_LINE_END, AHR_HeaderParseLine("\n", 1, &line));
+    TEST_ASSERT_EQUAL_INT(AHR_HEADER_LINE_INVALID, AHR_HeaderParseLine("no delimiter\r\n", 14, &line));
+    TEST_ASSERT_EQUAL_INT(AHR_HEADER_LINE_INVALID, AHR_HeaderParseLine(": empty name\r\n", 14, &line));
+}
+
+void test_AHR_HeaderScan(void)
+{
+    //
+    // Move the Delimiters through a Line longer than three AVX2 Blocks,
+    // so the vectorized Loop, its Tail and the scalar Loop all have to find them.
+    //
+    char data[TEST_SCAN_LEN]; // flawfinder: ignore
+    for(size_t colon=0;colon<=TEST_SCAN_LEN;++colon)
+    {
+        for(size_t end=0;end<=TEST_SCAN_LEN;end+=7U)
+        {
+            memset(data, 'a', sizeof(data));
+            if(colon < TEST_SCAN_LEN)
+            {
+                data[colon] = ':';
+            }
+            if(end < TEST_SCAN_LEN)
+            {
+                data[end] = (end % 2U) ? '\r' : '\n';
+            }
+            size_t eol = 0;
+            const size_t found = AHR_HeaderScan(data, sizeof(data), &eol);
+            size_t expected_colon = 0;
+            size_t expected_eol = 0;
+            TEST_HeaderScanReference(data, sizeof(data), &expected_colon, &expected_eol);
+            TEST_ASSERT_EQUAL_size_t(expected_eol, eol);
+            TEST_ASSERT_EQUAL_size_t(expected_colon, found);
+        }
+    }
+    //
+    // Short Inputs only take the scalar Path.
+    //
+    size_t eol = 0;
+    TEST_ASSERT_EQUAL_size_t(1, AHR_HeaderScan("a:b", 3, &eol));
+    TEST_ASSERT_EQUAL_size_t(3, eol);
+    TEST_ASSERT_EQUAL_size_t(0, AHR_HeaderScan("", 0, &eol));
+    TEST_ASSERT_EQUAL_size_t(0, eol);
+}
@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <test_json.h>
+#include <async_http_requests/ahr_json.h>
+#include <async_http_requests/private/ahr_json_index.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define TEST_JSON_ITEMS 200U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Feed "body" in Pieces of "step" Bytes like the Processor does while a Body arrives, then finish it.
+///
+static bool TEST_JsonIndex(
+    AHR_JsonIndexer_t *indexer,
+    const char *body,
+    size_t nbytes,
+    size_t step,
+    AHR_JsonIndex_t *index
+)
+{
+    AHR_JsonIndexerReset(indexer);
+    for(size_t n=step;step > 0 && n<nbytes;n+=step)
+    {
+        AHR_JsonIndexerFeed(indexer, body, n);
+    }
+    const bool valid = AHR_JsonIndexerFinish(indexer, body, nbytes);
+    TEST_ASSERT_EQUAL(valid, AHR_JsonIndexerView(indexer, body, nbytes, index));
+    return valid;
+}
+
+static bool TEST_JsonStringEquals(const AHR_JsonIndex_t *index, size_t token, const char *expected)
+{
+    const char *data = NULL;
+    size_t nbytes = 0;
+    return AHR_JsonString(index, token, &data, &nbytes)
+        && strlen(expected) == nbytes
+        && 0 == memcmp(expected, data, nbytes);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_JsonIndexNavigate(void)
+{
+    static const char body[] =
+        " {\"name\": \"a \\\"quoted\\\" {not: [structural]}\", \"empty\": {}, \"list\": [1, -2, 3.5e2, [], \"x\"],"
+        " \"nested\": {\"deep\": {\"id\": 9223372036854775807}}, \"yes\": true, \"no\": false, \"none\": null,"
+        " \"esc\\\"key\": 0, \"big\": 92233720368547758070, \"frac\": -0.25} ";
+    AHR_JsonIndexer_t indexer = AHR_CreateJsonIndexer();
+    AHR_JsonIndex_t index;
+    TEST_ASSERT_TRUE(TEST_JsonIndex(&indexer, body, sizeof(body) - 1U, 0, &index));
+    TEST_ASSERT_EQUAL_PTR(body, index.body);
+    TEST_ASSERT_EQUAL_size_t(0, index.error_offset);
+
+    TEST_ASSERT_EQUAL(AHR_JSON_OBJECT, AHR_JsonTokenType(&index, 0));
+    TEST_ASSERT_EQUAL_UINT32(10, index.tokens[0].count);
+    TEST_ASSERT_EQUAL_UINT32(index.ntokens, index.tokens[0].next);
+    TEST_ASSERT_EQUAL_CHAR('{', body[index.tokens[0].offset]);
+    TEST_ASSERT_EQUAL_CHAR('}', body[index.tokens[0].offset + index.tokens[0].length - 1U]);
+    TEST_ASSERT_EQUAL(AHR_JSON_INVALID, AHR_JsonTokenType(&index, index.ntokens));
+    TEST_ASSERT_EQUAL(AHR_JSON_INVALID, AHR_JsonTokenType(&index, AHR_JSON_NPOS));
+
+    TEST_ASSERT_TRUE(TEST_JsonStringEquals(&index, AHR_JsonObjectFind(&index, 0, "name"),
+        "a \\\"quoted\\\" {not: [structural]}"));
+    const size_t empty = AHR_JsonObjectFind(&index, 0, "empty");
+    TEST_ASSERT_EQUAL(AHR_JSON_OBJECT, AHR_JsonTokenType(&index, empty));
+    TEST_ASSERT_EQUAL_UINT32(0, index.tokens[empty].count);
+    TEST_ASSERT_EQUAL_UINT32(empty + 1U, index.tokens[empty].next);
+
+    const size_t list = AHR_JsonObjectFind(&index, 0, "list");
+    TEST_ASSERT_EQUAL(AHR_JSON_ARRAY, AHR_JsonTokenType(&index, list));
+    TEST_ASSERT_EQUAL_UINT32(5, index.tokens[list].count);
+    int64_t integer = 0;
+    double real = 0.0;
+    TEST_ASSERT_TRUE(AHR_JsonInt64(&index, AHR_JsonArrayAt(&index, list, 0), &integer));
+    TEST_ASSERT_EQUAL_INT64(1, integer);
+    TEST_ASSERT_TRUE(AHR_JsonInt64(&index, AHR_JsonArrayAt(&index, list, 1), &integer));
+    TEST_ASSERT_EQUAL_INT64(-2, integer);
+    TEST_ASSERT_FALSE(AHR_JsonInt64(&index, AHR_JsonArrayAt(&index, list, 2), &integer));
+    TEST_ASSERT_TRUE(AHR_JsonDouble(&index, AHR_JsonArrayAt(&index, list, 2), &real));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 350.0, real);
+    TEST_ASSERT_EQUAL(AHR_JSON_ARRAY, AHR_JsonTokenType(&index, AHR_JsonArrayAt(&index, list, 3)));
+    TEST_ASSERT_TRUE(TEST_JsonStringEquals(&index, AHR_JsonArrayAt(&index, list, 4), "x"));
+    TEST_ASSERT_EQUAL_size_t(AHR_JSON_NPOS, AHR_JsonArrayAt(&index, list, 5));
+    TEST_ASSERT_EQUAL_size_t(AHR_JSON_NPOS, AHR_JsonArrayAt(&index, 0, 0));
+    //
+    // The Key of the next Member directly follows the Value of the previous one.
+    //
+    TEST_ASSERT_TRUE(TEST_JsonStringEquals(&index, index.tokens[list].next, "nested"));
+
+    const size_t id = AHR_JsonObjectFind(
+        &index, AHR_JsonObjectFind(&index, AHR_JsonObjectFind(&index, 0, "nested"), "deep"), "id"
+    );
+    TEST_ASSERT_TRUE(AHR_JsonInt64(&index, id, &integer));
+    TEST_ASSERT_EQUAL_INT64(INT64_MAX, integer);
+    TEST_ASSERT_FALSE(AHR_JsonInt64(&index, AHR_JsonObjectFind(&index, 0, "big"), &integer));
+    TEST_ASSERT_TRUE(AHR_JsonDouble(&index, AHR_JsonObjectFind(&index, 0, "frac"), &real));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, -0.25, real);
+    TEST_ASSERT_EQUAL(AHR_JSON_TRUE, AHR_JsonTokenType(&index, AHR_JsonObjectFind(&index, 0, "yes")));
+    TEST_ASSERT_EQUAL(AHR_JSON_FALSE, AHR_JsonTokenType(&index, AHR_JsonObjectFind(&index, 0, "no")));
+    TEST_ASSERT_EQUAL(AHR_JSON_NULL, AHR_JsonTokenType(&index, AHR_JsonObjectFind(&index, 0, "none")));
+    TEST_ASSERT_NOT_EQUAL(AHR_JSON_NPOS, AHR_JsonObjectFind(&index, 0, "esc\\\"key"));
+    //
+    // Only Members of the Object itself are found, Lookups on NPOS fail.
+    //
+    TEST_ASSERT_EQUAL_size_t(AHR_JSON_NPOS, AHR_JsonObjectFind(&index, 0, "id"));
+    TEST_ASSERT_EQUAL_size_t(AHR_JSON_NPOS, AHR_JsonObjectFind(&index, 0, "nam"));
+    TEST_ASSERT_EQUAL_size_t(AHR_JSON_NPOS, AHR_JsonObjectFind(&index, list, "name"));
+    TEST_ASSERT_EQUAL_size_t(AHR_JSON_NPOS, AHR_JsonObjectFind(&index, AHR_JSON_NPOS, "name"));
+    TEST_ASSERT_FALSE(TEST_JsonStringEquals(&index, AHR_JSON_NPOS, ""));
+    TEST_ASSERT_FALSE(AHR_JsonDouble(&index, AHR_JsonObjectFind(&index, 0, "yes"), &real));
+
+    AHR_DestroyJsonIndexer(&indexer);
+}
+
+void test_AHR_JsonIndexChunked(void)
+{
+    //
+    // Strings, Escapes and Numbers of many Lengths, so every Kind of Token crosses a 64 Byte Block.
+    //
+    char *body = malloc(TEST_JSON_ITEMS * 128U);
+    TEST_ASSERT_NOT_NULL(body);
+    size_t nbytes = (size_t)sprintf(body, "{\"items\": [");
+    for(size_t i=0;i<TEST_JSON_ITEMS;++i)
+    {
+        char padding[32]; // flawfinder: ignore
+        memset(padding, '\\' == "ab\\"[i % 3U] ? 'c' : "ab\\"[i % 3U], sizeof(padding));
+        padding[i % sizeof(padding)] = '\0';
+        nbytes += (size_t)sprintf(
+            body + nbytes, "%s{\"id\": %zu, \"s\": \"%s\\\\\\\"\\u00e9\", \"ok\": %s}",
+            i > 0 ? ", " : "", i * 37U, padding, (i % 2U) ? "true" : "null"
+        );
+    }
+    nbytes += (size_t)sprintf(body + nbytes, "]}");
+
+    AHR_JsonIndexer_t reference = AHR_CreateJsonIndexer();
+    AHR_JsonIndex_t expected;
+    TEST_ASSERT_TRUE(TEST_JsonIndex(&reference, body, nbytes, 0, &expected));
+    TEST_ASSERT_EQUAL_UINT32(TEST_JSON_ITEMS, expected.tokens[AHR_JsonObjectFind(&expected, 0, "items")].count);
+
+    AHR_JsonIndexer_t indexer = AHR_CreateJsonIndexer();
+    const size_t steps[] = {1, 7, 63, 64, 65, 1000, nbytes};
+    for(size_t i=0;i<sizeof(steps) / sizeof(steps[0]);++i)
+    {
+        AHR_JsonIndex_t index;
+        TEST_ASSERT_TRUE(TEST_JsonIndex(&indexer, body, nbytes, steps[i], &index));
+        TEST_ASSERT_EQUAL_size_t(expected.ntokens, index.ntokens);
+        TEST_ASSERT_EQUAL_MEMORY(expected.tokens, index.tokens, expected.ntokens * sizeof(AHR_JsonToken_t));
+    }
+    //
+    // The Indexer keeps its Capacity for the next Body.
+    //
+    const size_t capacity = AHR_JsonIndexerCapacityBytes(&indexer);
+    TEST_ASSERT_GREATER_THAN_size_t(0, capacity);
+    AHR_JsonIndex_t small;
+    TEST_ASSERT_TRUE(TEST_JsonIndex(&indexer, "[1]", 3, 0, &small));
+    TEST_ASSERT_EQUAL_size_t(2, small.ntokens);
+    TEST_ASSERT_EQUAL_size_t(capacity, AHR_JsonIndexerCapacityBytes(&indexer));
+
+    const size_t item = AHR_JsonArrayAt(&expected, AHR_JsonObjectFind(&expected, 0, "items"), TEST_JSON_ITEMS - 1U);
+    int64_t id = 0;
+    TEST_ASSERT_TRUE(AHR_JsonInt64(&expected, AHR_JsonObjectFind(&expected, item, "id"), &id));
+    TEST_ASSERT_EQUAL_INT64((TEST_JSON_ITEMS - 1U) * 37U, id);
+
+    AHR_DestroyJsonIndexer(&indexer);
+    AHR_DestroyJsonIndexer(&reference);
+    free(body);
+}
+
+void test_AHR_JsonIndexInvalid(void)
+{
+    static const struct
+    {
+        const char *body;
+        size_t error_offset;
+    } cases[] = {
+        {"", 0},
+        {"{\"a\": 1,}", 8},
+        {"{\"a\" 1}", 5},
+        {"[1 2]", 3},
+        {"[tru]", 1},
+        {"[01]", 1},
+        {"[1.]", 1},
+        {"\"a\x01\"", 2},
+        {"\"\\x\"", 0},
+        {"\"\xc3\x28\"", 0},
+        {"[1]]", 3},
+        {"{\"a\": [1}", 8},
+        {"\"open", 5}
+    };
+    AHR_JsonIndexer_t indexer = AHR_CreateJsonIndexer();
+    for(size_t i=0;i<sizeof(cases) / sizeof(cases[0]);++i)
+    {
+        AHR_JsonIndex_t index;
+        char message[32]; // flawfinder: ignore
+        snprintf(message, sizeof(message), "case %zu", i);
+        TEST_ASSERT_FALSE_MESSAGE(TEST_JsonIndex(&indexer, cases[i].body, strlen(cases[i].body), 0, &index), message);
+        TEST_ASSERT_EQUAL_size_t_MESSAGE(cases[i].error_offset, index.error_offset, message);
+    }
+    AHR_DestroyJsonIndexer(&indexer);
+}
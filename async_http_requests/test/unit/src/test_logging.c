@@ -0,0 +1,311 @@
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <test_logging.h>
+#include <async_http_requests/private/ahr_logging.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define TEST_LOG_MESSAGES 2200U
+#define TEST_LOG_THREADS 4U
+#define TEST_LOG_PER_THREAD 250U
+
+///
+/// \brief  Collects the delivered Messages, Callbacks may run on the Drain Thread.
+///
+typedef struct
+{
+    pthread_mutex_t mutex;
+    size_t nmessages;
+    size_t levels[TEST_LOG_MESSAGES];
+    char messages[TEST_LOG_MESSAGES][128]; // flawfinder: ignore
+    size_t longest;
+} TEST_LogSink_t;
+
+typedef struct
+{
+    AHR_Logger_t logger;
+    size_t thread;
+} TEST_LogThread_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void TEST_LogStore(TEST_LogSink_t *sink, size_t loglevel, const char *message)
+{
+    pthread_mutex_lock(&sink->mutex);
+    if(sink->nmessages < TEST_LOG_MESSAGES)
+    {
+        snprintf(sink->messages[sink->nmessages], sizeof(sink->messages[0]), "%s", message);
+        sink->levels[sink->nmessages++] = loglevel;
+    }
+    if(strlen(message) > sink->longest)
+    {
+        sink->longest = strlen(message);
+    }
+    pthread_mutex_unlock(&sink->mutex);
+}
+
+static void TEST_LogInfo(void *arg, const char *message)
+{
+    TEST_LogStore(arg, AHR_LOGLEVEL_INFO, message);
+}
+
+static void TEST_LogWarning(void *arg, const char *message)
+{
+    TEST_LogStore(arg, AHR_LOGLEVEL_WARNING, message);
+}
+
+static void TEST_LogError(void *arg, const char *message)
+{
+    TEST_LogStore(arg, AHR_LOGLEVEL_ERROR, message);
+}
+
+static size_t TEST_LogCount(TEST_LogSink_t *sink)
+{
+    pthread_mutex_lock(&sink->mutex);
+    const size_t nmessages = sink->nmessages;
+    pthread_mutex_unlock(&sink->mutex);
+    return nmessages;
+}
+
+static TEST_LogSink_t* TEST_CreateSink(void)
+{
+    TEST_LogSink_t *sink = calloc(1, sizeof(TEST_LogSink_t));
+    TEST_ASSERT_NOT_NULL(sink);
+    pthread_mutex_init(&sink->mutex, NULL);
+    return sink;
+}
+
+static void TEST_DestroySink(TEST_LogSink_t *sink)
+{
+    pthread_mutex_destroy(&sink->mutex);
+    free(sink);
+}
+
+static AHR_Logger_t TEST_CreateManualLogger(TEST_LogSink_t *sink, size_t ring_capacity)
+{
+    const AHR_LoggerOptions_t options = {
+        .arg = sink,
+        .info = TEST_LogInfo,
+        .warning = TEST_LogWarning,
+        .error = TEST_LogError,
+        .ring_capacity = ring_capacity,
+        .manual_flush = true
+    };
+    AHR_Logger_t logger = AHR_CreateLoggerWithOptions(&options);
+    TEST_ASSERT_NOT_NULL(logger);
+    return logger;
+}
+
+static void* TEST_LogThreadMain(void *arg)
+{
+    const TEST_LogThread_t *thread = arg;
+    for(size_t i=0;i<TEST_LOG_PER_THREAD;++i)
+    {
+        AHR_LOG_INFO(thread->logger, "thread %zu message %zu", thread->thread, i);
+    }
+    return NULL;
+}
+
+///
+/// \brief  Log one Message, flush it and compare it with what snprintf() makes of the same Arguments.
+///
+#define TEST_LOG_EXPECT(logger, sink, ...) \
+    do \
+    { \
+        char expected[128]; /* flawfinder: ignore */ \
+        snprintf(expected, sizeof(expected), __VA_ARGS__); \
+        const size_t before = (sink)->nmessages; \
+        AHR_LogFormat(AHR_LOGLEVEL_ERROR, (logger), __VA_ARGS__); \
+        AHR_LoggerFlush(logger); \
+        TEST_ASSERT_EQUAL_size_t(before + 1U, (sink)->nmessages); \
+        TEST_ASSERT_EQUAL_STRING(expected, (sink)->messages[before]); \
+    } while(0)
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_LoggerFormat(void)
+{
+    TEST_LogSink_t *sink = TEST_CreateSink();
+    AHR_Logger_t logger = TEST_CreateManualLogger(sink, 0);
+    const char *volatile missing = NULL;
+    const long double quarter = 0.25L;
+
+    TEST_LOG_EXPECT(logger, sink, "%d %i %d|%5d|%-5d|%+d|%05d", INT_MIN, INT_MAX, 0, 42, 42, 7, -7);
+    TEST_LOG_EXPECT(logger, sink, "%u %lu %llu %zu %zd", UINT_MAX, ULONG_MAX, ULLONG_MAX, SIZE_MAX, (ssize_t)-1);
+    TEST_LOG_EXPECT(logger, sink, "%hhd %hd %hhu %hu", (signed char)-5, (short)-300, (unsigned char)200, 60000);
+    TEST_LOG_EXPECT(logger, sink, "%x %#X %#o %llx %c%c", 255U, 255U, 8U, 0xdeadbeefcafeULL, 'o', 'k');
+    TEST_LOG_EXPECT(logger, sink, "%f %8.3f %e %g %G %a %Lf", 1.5, -3.14159, 12345.678, 1e-10, 1e20, 1.0, quarter);
+    TEST_LOG_EXPECT(logger, sink, "%s|%.3s|%10s|%-10s|%s", "text", "truncated", "right", "left", missing);
+    TEST_LOG_EXPECT(logger, sink, "%*d|%-*d|%.*f|%.*s", 6, 1, 4, 2, 2, 3.14159, 2, "abc");
+    TEST_LOG_EXPECT(logger, sink, "%p %p 100%%", (void*)&logger, NULL);
+    TEST_LOG_EXPECT(logger, sink, "no conversion");
+    //
+    // Strings are copied when the Message is logged, not when it is formatted.
+    //
+    char name[] = "before"; // flawfinder: ignore
+    AHR_LOG_WARNING(logger, "name %s", name);
+    memcpy(name, "after!", sizeof(name)); // flawfinder: ignore
+    const size_t before = sink->nmessages;
+    AHR_LoggerFlush(logger);
+    TEST_ASSERT_EQUAL_STRING("name before", sink->messages[before]);
+    TEST_ASSERT_EQUAL_size_t(AHR_LOGLEVEL_WARNING, sink->levels[before]);
+    //
+    // Only 12 Arguments are captured, the Rest of the Format is passed on verbatim.
+    //
+    AHR_LOG_ERROR(logger, "%d %d %d %d %d %d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14);
+    AHR_LoggerFlush(logger);
+    TEST_ASSERT_EQUAL_STRING("1 2 3 4 5 6 7 8 9 10 11 12 %d %d", sink->messages[before + 1U]);
+    TEST_ASSERT_EQUAL_size_t(AHR_LOGLEVEL_ERROR, sink->levels[before + 1U]);
+    //
+    // A '%' in a Message passed as is stays a '%'. Messages above the Loglevel are not queued.
+    //
+    AHR_LogInfo(logger, "50% %s");
+    AHR_LoggerSetLoglevel(logger, AHR_LOGLEVEL_WARNING);
+    AHR_LogInfo(logger, "filtered");
+    AHR_LOG_INFO(logger, "filtered %d", 1);
+    AHR_LogWarning(logger, "kept");
+    AHR_LoggerFlush(logger);
+    TEST_ASSERT_EQUAL_size_t(before + 4U, sink->nmessages);
+    TEST_ASSERT_EQUAL_STRING("50% %s", sink->messages[before + 2U]);
+    TEST_ASSERT_EQUAL_size_t(AHR_LOGLEVEL_INFO, sink->levels[before + 2U]);
+    TEST_ASSERT_EQUAL_STRING("kept", sink->messages[before + 3U]);
+    TEST_ASSERT_EQUAL_size_t(0, AHR_LoggerDropped(logger));
+    //
+    // Long Messages are truncated to 511 Characters, not dropped.
+    //
+    char wide[2048]; // flawfinder: ignore
+    memset(wide, 'w', sizeof(wide) - 1U);
+    wide[sizeof(wide) - 1U] = '\0';
+    AHR_LOG_ERROR(logger, "%1000d%s", 1, wide);
+    AHR_LoggerFlush(logger);
+    TEST_ASSERT_EQUAL_size_t(before + 5U, sink->nmessages);
+    TEST_ASSERT_EQUAL_size_t(511U, sink->longest);
+
+    AHR_DestroyLogger(&logger);
+    TEST_ASSERT_NULL(logger);
+    TEST_DestroySink(sink);
+}
+
+void test_AHR_LoggerDropped(void)
+{
+    TEST_LogSink_t *sink = TEST_CreateSink();
+    //
+    // Rounded up to 4 Records.
+    //
+    AHR_Logger_t logger = TEST_CreateManualLogger(sink, 3);
+    for(size_t i=0;i<10;++i)
+    {
+        AHR_LOG_INFO(logger, "message %zu", i);
+    }
+    TEST_ASSERT_EQUAL_size_t(6, AHR_LoggerDropped(logger));
+    AHR_LoggerFlush(logger);
+    TEST_ASSERT_EQUAL_size_t(5, sink->nmessages);
+    TEST_ASSERT_EQUAL_STRING("6 Log Messages dropped, the Ring was full.", sink->messages[0]);
+    TEST_ASSERT_EQUAL_size_t(AHR_LOGLEVEL_WARNING, sink->levels[0]);
+    for(size_t i=0;i<4;++i)
+    {
+        char expected[32]; // flawfinder: ignore
+        snprintf(expected, sizeof(expected), "message %zu", i);
+        TEST_ASSERT_EQUAL_STRING(expected, sink->messages[1U + i]);
+    }
+    //
+    // The Ring has Room again, the Drops are reported once.
+    //
+    AHR_LOG_INFO(logger, "again");
+    AHR_LoggerFlush(logger);
+    TEST_ASSERT_EQUAL_size_t(6, sink->nmessages);
+    TEST_ASSERT_EQUAL_STRING("again", sink->messages[5]);
+    TEST_ASSERT_EQUAL_size_t(6, AHR_LoggerDropped(logger));
+
+    AHR_DestroyLogger(&logger);
+    TEST_DestroySink(sink);
+}
+
+void test_AHR_LoggerThreads(void)
+{
+    TEST_LogSink_t *sink = TEST_CreateSink();
+    //
+    // Threads which run one after the other share a Ring, so it has Room for all Messages.
+    // The second Round logs into the Rings the first Round left behind, before they were flushed.
+    //
+    AHR_Logger_t logger = TEST_CreateManualLogger(sink, 2U * TEST_LOG_THREADS * TEST_LOG_PER_THREAD);
+    TEST_LogThread_t threads[2U * TEST_LOG_THREADS];
+    for(size_t round=0;round<2;++round)
+    {
+        pthread_t handles[TEST_LOG_THREADS];
+        for(size_t i=0;i<TEST_LOG_THREADS;++i)
+        {
+            threads[round * TEST_LOG_THREADS + i] = (TEST_LogThread_t){
+                .logger = logger, .thread = round * TEST_LOG_THREADS + i
+            };
+            TEST_ASSERT_EQUAL_INT(
+                0, pthread_create(&handles[i], NULL, TEST_LogThreadMain, &threads[round * TEST_LOG_THREADS + i])
+            );
+        }
+        for(size_t i=0;i<TEST_LOG_THREADS;++i)
+        {
+            pthread_join(handles[i], NULL);
+        }
+    }
+    AHR_LoggerFlush(logger);
+    TEST_ASSERT_EQUAL_size_t(0, AHR_LoggerDropped(logger));
+    TEST_ASSERT_EQUAL_size_t(2U * TEST_LOG_THREADS * TEST_LOG_PER_THREAD, sink->nmessages);
+
+    size_t next[2U * TEST_LOG_THREADS] = {0};
+    for(size_t i=0;i<sink->nmessages;++i)
+    {
+        size_t thread = 0;
+        size_t message = 0;
+        TEST_ASSERT_EQUAL_INT(2, sscanf(sink->messages[i], "thread %zu message %zu", &thread, &message));
+        TEST_ASSERT_LESS_THAN_size_t(2U * TEST_LOG_THREADS, thread);
+        TEST_ASSERT_EQUAL_size_t(next[thread], message);
+        ++next[thread];
+    }
+
+    AHR_DestroyLogger(&logger);
+    TEST_DestroySink(sink);
+}
+
+void test_AHR_LoggerDrain(void)
+{
+    TEST_LogSink_t *sink = TEST_CreateSink();
+    const AHR_LoggerOptions_t options = {
+        .arg = sink, .info = TEST_LogInfo, .warning = TEST_LogWarning, .error = TEST_LogError, .drain_interval_ms = 1
+    };
+    AHR_Logger_t logger = AHR_CreateLoggerWithOptions(&options);
+    TEST_ASSERT_NOT_NULL(logger);
+
+    AHR_LOG_INFO(logger, "drained %d", 1);
+    const struct timespec pause = {.tv_sec = 0, .tv_nsec = 1000000};
+    for(size_t i=0;i<5000 && 0 == TEST_LogCount(sink);++i)
+    {
+        nanosleep(&pause, NULL);
+    }
+    TEST_ASSERT_EQUAL_size_t(1, TEST_LogCount(sink));
+    TEST_ASSERT_EQUAL_STRING("drained 1", sink->messages[0]);
+    //
+    // Queued Messages are not lost when the Logger goes away.
+    //
+    for(size_t i=0;i<100;++i)
+    {
+        AHR_LOG_INFO(logger, "queued %zu", i);
+    }
+    AHR_DestroyLogger(&logger);
+    TEST_ASSERT_EQUAL_size_t(101, sink->nmessages);
+    TEST_ASSERT_EQUAL_STRING("queued 99", sink->messages[100]);
+    TEST_DestroySink(sink);
+}
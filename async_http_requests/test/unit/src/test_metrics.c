@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <test_metrics.h>
+#include <async_http_requests/private/ahr_metrics.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define TEST_METRICS_SAMPLES 10000U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static const AHR_OriginLatency_t* TEST_MetricsOrigin(const AHR_MetricsSnapshot_t *snapshot, const char *origin)
+{
+    for(size_t i=0;i<snapshot->norigins;++i)
+    {
+        if(0 == strcmp(origin, snapshot->origins[i].origin))
+        {
+            return &snapshot->origins[i];
+        }
+    }
+    return NULL;
+}
+
+///
+/// \brief  Assert that "actual" is within the relative Error of 1/16 above "expected", Quantiles are
+///         reported as the upper Bound of their Bucket.
+///
+static void TEST_MetricsAssertQuantile(uint64_t expected, uint64_t actual)
+{
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT64(expected, actual);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT64(expected + expected / 16U + 1U, actual);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_MetricsSnapshot(void)
+{
+    AHR_Metrics_t *metrics = AHR_CreateMetrics();
+    TEST_ASSERT_NOT_NULL(metrics);
+    AHR_MetricsSnapshot_t snapshot;
+    AHR_MetricsTakeSnapshot(metrics, &snapshot);
+    TEST_ASSERT_EQUAL_UINT64(0, snapshot.submitted);
+    TEST_ASSERT_EQUAL_size_t(0, snapshot.norigins);
+
+    for(size_t i=0;i<10;++i)
+    {
+        AHR_MetricsSubmitted(metrics);
+    }
+    for(size_t i=0;i<9;++i)
+    {
+        AHR_MetricsDequeued(metrics);
+    }
+    //
+    // Origins get the Default Port of their Scheme, Path, Query and Fragment are dropped.
+    //
+    const AHR_MetricsTransfer_t fresh = {
+        .url = "http://a.example/path?q=1", .latency_us = 100, .bytes_in = 1000, .bytes_out = 10, .new_connections = 1
+    };
+    const AHR_MetricsTransfer_t reused = {
+        .url = "https://b.example#top", .latency_us = 200, .bytes_in = 2000, .bytes_out = 20, .new_connections = 0
+    };
+    const AHR_MetricsTransfer_t ipv6 = {
+        .url = "http://[::1]:8080/x", .latency_us = 300, .bytes_in = 3000, .bytes_out = 30, .new_connections = 0
+    };
+    const AHR_MetricsTransfer_t refused = {
+        .url = "http://a.example/", .latency_us = 0, .bytes_in = 0, .bytes_out = 0, .new_connections = 1
+    };
+    AHR_MetricsCompleted(metrics, 200, &fresh);
+    AHR_MetricsCompleted(metrics, 204, &reused);
+    AHR_MetricsCompleted(metrics, 404, &ipv6);
+    AHR_MetricsCompleted(metrics, 503, &fresh);
+    AHR_MetricsCompleted(metrics, 42, &fresh);
+    AHR_MetricsFailed(metrics, AHR_FAILURE_CONNECT, &refused);
+    AHR_MetricsFailed(metrics, AHR_FAILURE_TIMEOUT, NULL);
+
+    AHR_MetricsTakeSnapshot(metrics, &snapshot);
+    TEST_ASSERT_EQUAL_UINT64(10, snapshot.submitted);
+    TEST_ASSERT_EQUAL_UINT64(1, snapshot.queue_depth);
+    TEST_ASSERT_EQUAL_UINT64(2, snapshot.in_flight);
+    const uint64_t completed[AHR_METRICS_STATUS_CLASSES] = {1, 0, 2, 0, 1, 1};
+    TEST_ASSERT_EQUAL_MEMORY(completed, snapshot.completed, sizeof(completed));
+    const uint64_t failed[AHR_FAILURE_CLASSES] = {1, 1, 0, 0};
+    TEST_ASSERT_EQUAL_MEMORY(failed, snapshot.failed, sizeof(failed));
+    TEST_ASSERT_EQUAL_UINT64(3U * 1000U + 2000U + 3000U, snapshot.bytes_in);
+    TEST_ASSERT_EQUAL_UINT64(3U * 10U + 20U + 30U, snapshot.bytes_out);
+    TEST_ASSERT_EQUAL_UINT64(4, snapshot.connections_opened);
+    TEST_ASSERT_EQUAL_UINT64(2, snapshot.connections_reused);
+
+    TEST_ASSERT_EQUAL_size_t(3, snapshot.norigins);
+    const AHR_OriginLatency_t *a = TEST_MetricsOrigin(&snapshot, "http://a.example:80");
+    const AHR_OriginLatency_t *b = TEST_MetricsOrigin(&snapshot, "https://b.example:443");
+    const AHR_OriginLatency_t *v6 = TEST_MetricsOrigin(&snapshot, "http://[::1]:8080");
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_NOT_NULL(v6);
+    TEST_ASSERT_EQUAL_UINT64(3, a->count);
+    TEST_ASSERT_EQUAL_UINT64(300, a->sum_us);
+    TEST_ASSERT_EQUAL_UINT64(100, a->max_us);
+    TEST_ASSERT_EQUAL_UINT64(1, v6->count);
+    TEST_ASSERT_EQUAL_UINT64(300, v6->p50_us);
+    //
+    // Origins beyond the last free Slot are collected under "*".
+    //
+    for(size_t i=0;i<2U * AHR_METRICS_MAX_ORIGINS;++i)
+    {
+        char url[64]; // flawfinder: ignore
+        snprintf(url, sizeof(url), "http://host%zu.example/", i);
+        const AHR_MetricsTransfer_t transfer = {.url = url, .latency_us = 1};
+        AHR_MetricsCompleted(metrics, 200, &transfer);
+    }
+    AHR_MetricsTakeSnapshot(metrics, &snapshot);
+    TEST_ASSERT_EQUAL_size_t(AHR_METRICS_MAX_ORIGINS, snapshot.norigins);
+    const AHR_OriginLatency_t *rest = TEST_MetricsOrigin(&snapshot, "*");
+    TEST_ASSERT_NOT_NULL(rest);
+    uint64_t total = 0;
+    for(size_t i=0;i<snapshot.norigins;++i)
+    {
+        total += snapshot.origins[i].count;
+    }
+    TEST_ASSERT_EQUAL_UINT64(5U + 2U * AHR_METRICS_MAX_ORIGINS, total);
+
+    AHR_DestroyMetrics(&metrics);
+    TEST_ASSERT_NULL(metrics);
+}
+
+void test_AHR_MetricsQuantiles(void)
+{
+    AHR_Metrics_t *metrics = AHR_CreateMetrics();
+    TEST_ASSERT_NOT_NULL(metrics);
+    //
+    // 1 to 10000 us once each, in the linear and in the logarithmic Range of the Histogram.
+    //
+    AHR_MetricsTransfer_t transfer = {.url = "http://quantiles.example:81/"};
+    for(uint64_t i=1;i<=TEST_METRICS_SAMPLES;++i)
+    {
+        transfer.latency_us = i;
+        AHR_MetricsCompleted(metrics, 200, &transfer);
+    }
+    AHR_MetricsSnapshot_t snapshot;
+    AHR_MetricsTakeSnapshot(metrics, &snapshot);
+    TEST_ASSERT_EQUAL_size_t(1, snapshot.norigins);
+    const AHR_OriginLatency_t *latency = &snapshot.origins[0];
+    TEST_ASSERT_EQUAL_STRING("http://quantiles.example:81", latency->origin);
+    TEST_ASSERT_EQUAL_UINT64(TEST_METRICS_SAMPLES, latency->count);
+    TEST_ASSERT_EQUAL_UINT64(TEST_METRICS_SAMPLES * (TEST_METRICS_SAMPLES + 1U) / 2U, latency->sum_us);
+    TEST_ASSERT_EQUAL_UINT64(TEST_METRICS_SAMPLES, latency->max_us);
+    TEST_MetricsAssertQuantile(5000, latency->p50_us);
+    TEST_MetricsAssertQuantile(9000, latency->p90_us);
+    TEST_MetricsAssertQuantile(9900, latency->p99_us);
+    //
+    // Quantiles never exceed the Maximum.
+    //
+    TEST_ASSERT_EQUAL_UINT64(TEST_METRICS_SAMPLES, latency->p999_us);
+    //
+    // Values below 32 us are exact, Latencies beyond the Range are clamped.
+    //
+    transfer.url = "http://small.example/";
+    for(uint64_t i=0;i<100;++i)
+    {
+        transfer.latency_us = 17;
+        AHR_MetricsCompleted(metrics, 200, &transfer);
+    }
+    transfer.url = "http://huge.example/";
+    transfer.latency_us = UINT64_MAX;
+    AHR_MetricsCompleted(metrics, 200, &transfer);
+    AHR_MetricsTakeSnapshot(metrics, &snapshot);
+    const AHR_OriginLatency_t *small = TEST_MetricsOrigin(&snapshot, "http://small.example:80");
+    const AHR_OriginLatency_t *huge = TEST_MetricsOrigin(&snapshot, "http://huge.example:80");
+    TEST_ASSERT_NOT_NULL(small);
+    TEST_ASSERT_NOT_NULL(huge);
+    TEST_ASSERT_EQUAL_UINT64(17, small->p50_us);
+    TEST_ASSERT_EQUAL_UINT64(17, small->p999_us);
+    TEST_ASSERT_EQUAL_UINT64(AHR_METRICS_MAX_VALUE_US, huge->max_us);
+    TEST_ASSERT_EQUAL_UINT64(AHR_METRICS_MAX_VALUE_US, huge->p50_us);
+
+    AHR_DestroyMetrics(&metrics);
+}
+
+void test_AHR_MetricsPrometheus(void)
+{
+    AHR_Metrics_t *metrics = AHR_CreateMetrics();
+    TEST_ASSERT_NOT_NULL(metrics);
+    AHR_MetricsSubmitted(metrics);
+    AHR_MetricsDequeued(metrics);
+    AHR_MetricsTransfer_t transfer = {.url = "http://x\"y\\z:8000/", .bytes_in = 77, .new_connections = 1};
+    const uint64_t latencies[] = {400, 700, 3000, 20000000};
+    for(size_t i=0;i<sizeof(latencies) / sizeof(latencies[0]);++i)
+    {
+        transfer.latency_us = latencies[i];
+        AHR_MetricsCompleted(metrics, 200, &transfer);
+    }
+    AHR_MetricsFailed(metrics, AHR_FAILURE_ABORTED, NULL);
+
+    char *text = malloc(64U * 1024U);
+    TEST_ASSERT_NOT_NULL(text);
+    const int64_t n = AHR_MetricsPrometheus(metrics, text, 64U * 1024U);
+    TEST_ASSERT_GREATER_THAN_INT64(0, n);
+    TEST_ASSERT_EQUAL_size_t((size_t)n, strlen(text));
+    static const char *const lines[] = {
+        "# TYPE ahr_requests_submitted_total counter\nahr_requests_submitted_total 1\n",
+        "ahr_requests_completed_total{class=\"2xx\"} 4\n",
+        "ahr_requests_completed_total{class=\"other\"} 0\n",
+        "ahr_requests_failed_total{reason=\"aborted\"} 1\n",
+        "ahr_bytes_received_total 308\n",
+        "ahr_connections_opened_total 4\n",
+        "# TYPE ahr_in_flight gauge\nahr_in_flight 0\n",
+        "# TYPE ahr_request_duration_seconds histogram\n",
+        //
+        // Cumulative Buckets, the 20 s Latency only counts towards +Inf.
+        //
+        "ahr_request_duration_seconds_bucket{origin=\"http://x\\\"y\\\\z:8000\",le=\"0.0005\"} 1\n",
+        "ahr_request_duration_seconds_bucket{origin=\"http://x\\\"y\\\\z:8000\",le=\"0.001\"} 2\n",
+        "ahr_request_duration_seconds_bucket{origin=\"http://x\\\"y\\\\z:8000\",le=\"0.005\"} 3\n",
+        "ahr_request_duration_seconds_bucket{origin=\"http://x\\\"y\\\\z:8000\",le=\"10\"} 3\n",
+        "ahr_request_duration_seconds_bucket{origin=\"http://x\\\"y\\\\z:8000\",le=\"+Inf\"} 4\n",
+        "ahr_request_duration_seconds_sum{origin=\"http://x\\\"y\\\\z:8000\"} 20.004100\n",
+        "ahr_request_duration_seconds_count{origin=\"http://x\\\"y\\\\z:8000\"} 4\n"
+    };
+    for(size_t i=0;i<sizeof(lines) / sizeof(lines[0]);++i)
+    {
+        TEST_ASSERT_NOT_NULL(strstr(text, lines[i]));
+    }
+    //
+    // Too small a Buffer fails as a whole.
+    //
+    TEST_ASSERT_EQUAL_INT64(-1, AHR_MetricsPrometheus(metrics, text, (size_t)n));
+    TEST_ASSERT_EQUAL_INT64(n, AHR_MetricsPrometheus(metrics, text, (size_t)n + 1U));
+    TEST_ASSERT_EQUAL_INT64(-1, AHR_MetricsPrometheus(metrics, NULL, 0));
+
+    free(text);
+    AHR_DestroyMetrics(&metrics);
+}
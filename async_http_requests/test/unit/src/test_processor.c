@@ -0,0 +1,1486 @@
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <zlib.h>
+
+#include <test_processor.h>
+#include <test_server.h>
+#include <async_http_requests/ahr_http_request_processor.h>
+#include <async_http_requests/ahr_json.h>
+#include <async_http_requests/ahr_record.h>
+#include <async_http_requests/private/ahr_json_index.h>
+#include <async_http_requests/private/ahr_logging.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define TEST_PROCESSOR_OBJECTS 4U
+#define TEST_PROCESSOR_TIMEOUT_MS 10000U
+///
+/// \brief  Larger than the Body Buffer of an Object, smaller than the largest pooled Response Buffer.
+///
+#define TEST_PROCESSOR_LARGE_BODY (200U * 1024U)
+
+///
+/// \brief  What the Callbacks of one Request saw, shared between the Test and the Processors Thread.
+///
+typedef struct
+{
+    atomic_int callbacks;
+    atomic_int releases;
+    ///
+    /// \brief  Callbacks which had already run when the borrowed Body was released.
+    ///
+    atomic_int callbacks_at_release;
+    ///
+    /// \brief  Chunks passed to on_data, the first one is answered with "first_action".
+    ///
+    atomic_int chunks;
+    AHR_StreamAction_t first_action;
+    size_t status;
+    size_t error;
+    char *body;
+    size_t nbytes;
+} TEST_Context_t;
+
+static void TEST_LogDiscard(void *arg, const char *msg)
+{
+    (void)arg;
+    (void)msg;
+}
+
+static AHR_Logger_t TEST_CreateLogger(void)
+{
+    const AHR_LoggerOptions_t options = {
+        .arg = NULL,
+        .info = TEST_LogDiscard,
+        .warning = TEST_LogDiscard,
+        .error = TEST_LogDiscard,
+        .ring_capacity = 0,
+        .drain_interval_ms = 0,
+        .manual_flush = true
+    };
+    return AHR_CreateLoggerWithOptions(&options);
+}
+
+static void TEST_OnSuccess(void *user, size_t object, size_t status, const char *body, size_t nbytes)
+{
+    (void)object;
+    TEST_Context_t *context = user;
+    context->status = status;
+    context->body = malloc(nbytes + 1U);
+    if(context->body)
+    {
+        memcpy(context->body, body, nbytes); // flawfinder: ignore
+        context->body[nbytes] = '\0';
+        context->nbytes = nbytes;
+    }
+    atomic_fetch_add(&context->callbacks, 1);
+}
+
+///
+/// \brief  What on_success found in the JSON Index of its Response.
+///
+typedef struct
+{
+    TEST_Context_t context;
+    AHR_Processor_t processor;
+    bool indexed;
+    size_t error_offset;
+    int64_t id;
+} TEST_JsonContext_t;
+
+static void TEST_OnJson(void *user, size_t object, size_t status, const char *body, size_t nbytes)
+{
+    TEST_JsonContext_t *json = user;
+    AHR_JsonIndex_t index;
+    json->indexed = AHR_ProcessorResponseJson(json->processor, object, &index);
+    json->error_offset = index.error_offset;
+    json->id = -1;
+    if(json->indexed && index.body == body && index.nbytes == nbytes)
+    {
+        const size_t items = AHR_JsonObjectFind(&index, 0, "items");
+        AHR_JsonInt64(&index, AHR_JsonObjectFind(&index, AHR_JsonArrayAt(&index, items, 1), "id"), &json->id);
+    }
+    TEST_OnSuccess(&json->context, object, status, body, nbytes);
+}
+
+static void TEST_OnError(void *user, size_t object, size_t error)
+{
+    (void)object;
+    TEST_Context_t *context = user;
+    context->error = error;
+    atomic_fetch_add(&context->callbacks, 1);
+}
+
+static AHR_StreamAction_t TEST_OnData(void *user, size_t object, const char *data, size_t nbytes)
+{
+    (void)object;
+    TEST_Context_t *context = user;
+    if(1 == atomic_fetch_add(&context->chunks, 1) + 1 && AHR_STREAM_CONTINUE != context->first_action)
+    {
+        return context->first_action;
+    }
+    char *body = realloc(context->body, context->nbytes + nbytes + 1U);
+    if(!body)
+    {
+        return AHR_STREAM_ABORT;
+    }
+    memcpy(body + context->nbytes, data, nbytes); // flawfinder: ignore
+    context->body = body;
+    context->nbytes += nbytes;
+    context->body[context->nbytes] = '\0';
+    return AHR_STREAM_CONTINUE;
+}
+
+static void TEST_OnComplete(void *user, size_t object, size_t status)
+{
+    (void)object;
+    TEST_Context_t *context = user;
+    context->status = status;
+    atomic_fetch_add(&context->callbacks, 1);
+}
+
+static void TEST_Release(void *user, const char *data, size_t nbytes)
+{
+    (void)data;
+    (void)nbytes;
+    TEST_Context_t *context = user;
+    atomic_store(&context->callbacks_at_release, atomic_load(&context->callbacks));
+    atomic_fetch_add(&context->releases, 1);
+}
+
+///
+/// \brief  Body Provider over a Buffer which hands out at most "step" Bytes per Read.
+///
+typedef struct
+{
+    const char *data;
+    size_t nbytes;
+    size_t offset;
+    size_t step;
+    size_t reads;
+} TEST_Provider_t;
+
+static size_t TEST_ProviderRead(void *user, char *buffer, size_t nbytes)
+{
+    TEST_Provider_t *provider = user;
+    size_t n = provider->nbytes - provider->offset;
+    n = n < nbytes ? n : nbytes;
+    n = n < provider->step ? n : provider->step;
+    memcpy(buffer, provider->data + provider->offset, n); // flawfinder: ignore
+    provider->offset += n;
+    provider->reads += 1U;
+    return n;
+}
+
+static bool TEST_ProviderRewind(void *user)
+{
+    TEST_Provider_t *provider = user;
+    provider->offset = 0;
+    return true;
+}
+
+///
+/// \brief  Compare the Response Header "name" of "object" with "value".
+///
+static bool TEST_HeaderEquals(AHR_Processor_t processor, size_t object, const char *name, const char *value)
+{
+    AHR_HeaderView_t view;
+    return AHR_ProcessorResponseHeaderFind(processor, object, name, &view)
+        && view.value_len == strlen(value)
+        && 0 == memcmp(view.value, value, view.value_len);
+}
+
+static AHR_UserData_t TEST_UserData(TEST_Context_t *context)
+{
+    return (AHR_UserData_t){
+        .data = context,
+        .on_success = TEST_OnSuccess,
+        .on_error = TEST_OnError,
+        .on_data = NULL,
+        .on_complete = NULL
+    };
+}
+
+static AHR_UserData_t TEST_StreamUserData(TEST_Context_t *context)
+{
+    return (AHR_UserData_t){
+        .data = context,
+        .on_success = TEST_OnSuccess,
+        .on_error = TEST_OnError,
+        .on_data = TEST_OnData,
+        .on_complete = TEST_OnComplete
+    };
+}
+
+static void TEST_ContextInit(TEST_Context_t *context)
+{
+    memset(context, 0, sizeof(*context));
+    atomic_init(&context->callbacks, 0);
+    atomic_init(&context->chunks, 0);
+    context->first_action = AHR_STREAM_CONTINUE;
+    atomic_init(&context->releases, 0);
+    atomic_init(&context->callbacks_at_release, -1);
+}
+
+static void TEST_ContextRelease(TEST_Context_t *context)
+{
+    free(context->body);
+    context->body = NULL;
+}
+
+///
+/// \brief  Wait until "counter" reached "expected".
+/// \returns    false after TEST_PROCESSOR_TIMEOUT_MS.
+///
+static bool TEST_Await(atomic_int *counter, int expected)
+{
+    const struct timespec pause = {.tv_sec = 0, .tv_nsec = 1000000};
+    for(size_t i=0;i<TEST_PROCESSOR_TIMEOUT_MS;++i)
+    {
+        if(atomic_load(counter) >= expected)
+        {
+            return true;
+        }
+        nanosleep(&pause, NULL);
+    }
+    return atomic_load(counter) >= expected;
+}
+
+static int TEST_TempFile(void)
+{
+    char path[] = "/tmp/ahr_test_processor_XXXXXX"; // flawfinder: ignore
+    const int fd = mkstemp(path);
+    if(fd >= 0)
+    {
+        unlink(path);
+    }
+    return fd;
+}
+
+typedef AHR_ProcessorStatus_t (*TEST_Method_t)(AHR_Processor_t, size_t, const AHR_RequestData_t*, AHR_UserData_t);
+
+static void TEST_Url(char *url, size_t nbytes, TEST_Server_t server, const char *path)
+{
+    snprintf(url, nbytes, "http://127.0.0.1:%u%s", (unsigned int)TEST_ServerPort(server), path);
+}
+
+///
+/// \brief  A Chain of Requests, each on_success configures its Object again and makes the next Request.
+///
+typedef struct
+{
+    TEST_Context_t context;
+    AHR_Processor_t processor;
+    TEST_Server_t server;
+    ///
+    /// \brief  Results of configuring and submitting from within on_success.
+    ///
+    AHR_ProcessorStatus_t configured;
+    AHR_ProcessorStatus_t submitted;
+    ///
+    /// \brief  Body and Headers of the finished Transfer were still intact after the next Request was made.
+    ///
+    bool intact;
+} TEST_ChainContext_t;
+
+#define TEST_CHAIN_REQUESTS 3
+
+static void TEST_OnChain(void *user, size_t object, size_t status, const char *body, size_t nbytes);
+
+///
+/// \brief  POST the Chain Link "link" to "/chain/<link>", the Server echoes it.
+///
+static AHR_ProcessorStatus_t TEST_ChainPost(TEST_ChainContext_t *chain, size_t object, int link)
+{
+    char url[128]; // flawfinder: ignore
+    char path[32]; // flawfinder: ignore
+    char body[32]; // flawfinder: ignore
+    snprintf(path, sizeof(path), "/chain/%d", link);
+    snprintf(body, sizeof(body), "link %d", link);
+    TEST_Url(url, sizeof(url), chain->server, path);
+    const AHR_RequestData_t request = {.url = url, .body = body};
+    const AHR_UserData_t user = {.data = chain, .on_success = TEST_OnChain, .on_error = TEST_OnError};
+    return AHR_ProcessorPost(chain->processor, object, &request, user);
+}
+
+static void TEST_OnChain(void *user, size_t object, size_t status, const char *body, size_t nbytes)
+{
+    TEST_ChainContext_t *chain = user;
+    const int link = atomic_load(&chain->context.callbacks);
+    char path[32]; // flawfinder: ignore
+    char expected[32]; // flawfinder: ignore
+    snprintf(path, sizeof(path), "/chain/%d", link);
+    snprintf(expected, sizeof(expected), "link %d", link);
+    if(link + 1 < TEST_CHAIN_REQUESTS)
+    {
+        chain->configured = TEST_ChainPost(chain, object, link + 1);
+        chain->submitted = AHR_ProcessorMakeRequest(chain->processor, object);
+    }
+    chain->intact = chain->intact
+        && nbytes == strlen(expected)
+        && 0 == memcmp(body, expected, nbytes)
+        && TEST_HeaderEquals(chain->processor, object, "X-Path", path);
+    TEST_ContextRelease(&chain->context);
+    TEST_OnSuccess(&chain->context, object, status, body, nbytes);
+}
+
+static char* TEST_Pattern(size_t nbytes)
+{
+    char *data = malloc(nbytes);
+    for(size_t i=0;data && i<nbytes;++i)
+    {
+        data[i] = (char)('a' + (i * 7U + i / 251U) % 26U);
+    }
+    return data;
+}
+
+///
+/// \brief  Decompress the gzip Body "data" into "out".
+/// \returns    Decompressed Size, -1 on Error.
+///
+static int64_t TEST_Gunzip(const char *data, size_t nbytes, char *out, size_t capacity)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if(Z_OK != inflateInit2(&stream, 15 + 16))
+    {
+        return -1;
+    }
+    stream.next_in = (Bytef*)(uintptr_t)data;
+    stream.avail_in = (uInt)nbytes;
+    stream.next_out = (Bytef*)out;
+    stream.avail_out = (uInt)capacity;
+    const int status = inflate(&stream, Z_FINISH);
+    const int64_t n = (int64_t)stream.total_out;
+    inflateEnd(&stream);
+    return Z_STREAM_END == status ? n : -1;
+}
+
+static uint64_t TEST_NowNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_ProcessorResponseHeaderUnknownObject(void)
+{
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+
+    AHR_HeaderView_t view;
+    TEST_ASSERT_EQUAL_INT(0, AHR_ProcessorResponseHeaderCount(processor, 0));
+    TEST_ASSERT_FALSE(AHR_ProcessorResponseHeaderAt(processor, 0, 0, &view));
+    TEST_ASSERT_EQUAL_INT(0, AHR_ProcessorResponseHeaderCount(processor, TEST_PROCESSOR_OBJECTS));
+    TEST_ASSERT_FALSE(AHR_ProcessorResponseHeaderAt(processor, TEST_PROCESSOR_OBJECTS, 0, &view));
+    TEST_ASSERT_FALSE(AHR_ProcessorResponseHeaderAt(processor, (size_t)-1, 0, &view));
+
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+}
+
+void test_AHR_ProcessorBorrowedBody(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char url[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/echo");
+    char *data = TEST_Pattern(TEST_PROCESSOR_LARGE_BODY);
+    TEST_ASSERT_NOT_NULL(data);
+
+    TEST_Context_t context;
+    TEST_ContextInit(&context);
+    const AHR_BodyDescriptor_t body = {
+        .data = data, .nbytes = TEST_PROCESSOR_LARGE_BODY, .release = TEST_Release, .user = &context
+    };
+    const AHR_RequestData_t request = {.url = url, .borrowed_body = &body};
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorPost(processor, 0, &request, TEST_UserData(&context)));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&context.releases));
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 0));
+    TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&context.releases));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&context.callbacks_at_release));
+    TEST_ASSERT_EQUAL_INT(200, context.status);
+    TEST_ASSERT_EQUAL_size_t(TEST_PROCESSOR_LARGE_BODY, context.nbytes);
+    TEST_ASSERT_EQUAL_MEMORY(data, context.body, TEST_PROCESSOR_LARGE_BODY);
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&context.releases));
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+    TEST_ContextRelease(&context);
+    free(data);
+}
+
+void test_AHR_ProcessorBorrowedBodyReconfigured(void)
+{
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+
+    char url[] = "http://127.0.0.1:1/echo"; // flawfinder: ignore
+    TEST_Context_t first;
+    TEST_Context_t second;
+    TEST_ContextInit(&first);
+    TEST_ContextInit(&second);
+    const AHR_BodyDescriptor_t first_body = {.data = "first", .nbytes = 5U, .release = TEST_Release, .user = &first};
+    const AHR_BodyDescriptor_t second_body = {.data = "second", .nbytes = 6U, .release = TEST_Release, .user = &second};
+
+    AHR_RequestData_t request = {.url = url, .borrowed_body = &first_body};
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorPost(processor, 1, &request, TEST_UserData(&first)));
+    request.borrowed_body = &second_body;
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorPut(processor, 1, &request, TEST_UserData(&second)));
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&first.releases));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&second.releases));
+    //
+    // Without a Body the Object lets go of the second one too, destroying the Processor releases nothing twice.
+    //
+    request.borrowed_body = NULL;
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorGet(processor, 1, &request, TEST_UserData(&second)));
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&second.releases));
+
+    AHR_DestroyProcessor(&processor);
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&first.releases));
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&second.releases));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&first.callbacks));
+    AHR_DestroyLogger(&logger);
+}
+
+void test_AHR_ProcessorCallbackResubmit(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    TEST_ChainContext_t chain = {.processor = processor, .server = server, .intact = true};
+    TEST_ContextInit(&chain.context);
+    chain.configured = AHR_PROC_OK;
+    chain.submitted = AHR_PROC_OK;
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, TEST_ChainPost(&chain, 3, 0));
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 3));
+    TEST_ASSERT_TRUE(TEST_Await(&chain.context.callbacks, TEST_CHAIN_REQUESTS));
+
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, chain.configured);
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, chain.submitted);
+    TEST_ASSERT_TRUE(chain.intact);
+    TEST_ASSERT_EQUAL_INT(200, chain.context.status);
+    TEST_ASSERT_EQUAL_STRING("link 2", chain.context.body);
+    TEST_ASSERT_EQUAL_UINT64(TEST_CHAIN_REQUESTS, TEST_ServerRequests(server));
+    //
+    // The Object is free again right after its Callback ran, no Retry required.
+    //
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, TEST_ChainPost(&chain, 3, TEST_CHAIN_REQUESTS));
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+    TEST_ContextRelease(&chain.context);
+}
+
+void test_AHR_ProcessorStreamedResponse(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char url[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/echo");
+    char *data = TEST_Pattern(TEST_PROCESSOR_LARGE_BODY);
+    TEST_ASSERT_NOT_NULL(data);
+    const AHR_BodyDescriptor_t body = {
+        .data = data, .nbytes = TEST_PROCESSOR_LARGE_BODY, .release = NULL, .user = NULL
+    };
+    const AHR_RequestData_t request = {.url = url, .borrowed_body = &body};
+    //
+    // The first Chunk pauses the Transfer, it is delivered again after the Transfer was resumed.
+    //
+    TEST_Context_t context;
+    TEST_ContextInit(&context);
+    context.first_action = AHR_STREAM_PAUSE;
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorPost(processor, 2, &request, TEST_StreamUserData(&context)));
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 2));
+    TEST_ASSERT_TRUE(TEST_Await(&context.chunks, 1));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&context.callbacks));
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorResumeResponse(processor, 2));
+    TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+
+    TEST_ASSERT_GREATER_THAN_INT(1, atomic_load(&context.chunks));
+    TEST_ASSERT_EQUAL_INT(200, context.status);
+    TEST_ASSERT_EQUAL_size_t(TEST_PROCESSOR_LARGE_BODY, context.nbytes);
+    TEST_ASSERT_EQUAL_MEMORY(data, context.body, TEST_PROCESSOR_LARGE_BODY);
+    TEST_ContextRelease(&context);
+    //
+    // Aborting from on_data ends in on_error.
+    //
+    TEST_ContextInit(&context);
+    context.first_action = AHR_STREAM_ABORT;
+    TEST_ASSERT_EQUAL_INT(
+        AHR_PROC_OK,
+        AHR_ProcessorPost(processor, 2, &request, TEST_StreamUserData(&context))
+    );
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 2));
+    TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&context.chunks));
+    TEST_ASSERT_EQUAL_INT(0, context.status);
+    TEST_ASSERT_NOT_EQUAL(0, context.error);
+    TEST_ContextRelease(&context);
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+    free(data);
+}
+
+void test_AHR_ProcessorBodyProvider(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char url[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/upload");
+    char *data = TEST_Pattern(TEST_PROCESSOR_LARGE_BODY);
+    TEST_ASSERT_NOT_NULL(data);
+    //
+    // Once with a Content-Length, once chunked.
+    //
+    const int64_t lengths[] = {(int64_t)TEST_PROCESSOR_LARGE_BODY, AHR_BODY_PROVIDER_CHUNKED};
+    const char *const chunked[] = {"0", "1"};
+    for(size_t i=0;i<sizeof(lengths) / sizeof(lengths[0]);++i)
+    {
+        TEST_Provider_t source = {
+            .data = data, .nbytes = TEST_PROCESSOR_LARGE_BODY, .offset = 0, .step = 1000U, .reads = 0
+        };
+        const AHR_BodyProvider_t provider = {
+            .read = TEST_ProviderRead, .rewind = TEST_ProviderRewind, .user = &source, .content_length = lengths[i]
+        };
+        const AHR_RequestData_t request = {.url = url, .body_provider = &provider};
+        TEST_Context_t context;
+        TEST_ContextInit(&context);
+        TEST_ASSERT_EQUAL_INT(
+            AHR_PROC_OK,
+            AHR_ProcessorPut(processor, 3, &request, TEST_UserData(&context))
+        );
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 3));
+        TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+
+        TEST_ASSERT_EQUAL_INT(200, context.status);
+        TEST_ASSERT_GREATER_THAN_size_t(TEST_PROCESSOR_LARGE_BODY / 1000U, source.reads);
+        TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 3, "X-Method", "PUT"));
+        TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 3, "X-Request-Chunked", chunked[i]));
+        TEST_ASSERT_EQUAL_size_t(TEST_PROCESSOR_LARGE_BODY, context.nbytes);
+        TEST_ASSERT_EQUAL_MEMORY(data, context.body, TEST_PROCESSOR_LARGE_BODY);
+        TEST_ContextRelease(&context);
+    }
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+    free(data);
+}
+
+void test_AHR_ProcessorFileSink(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char url[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/download");
+    char *data = TEST_Pattern(TEST_PROCESSOR_LARGE_BODY);
+    TEST_ASSERT_NOT_NULL(data);
+    const int fd = TEST_TempFile();
+    TEST_ASSERT_TRUE(fd >= 0);
+
+    const AHR_BodyDescriptor_t body = {
+        .data = data, .nbytes = TEST_PROCESSOR_LARGE_BODY, .release = NULL, .user = NULL
+    };
+    const AHR_FileSink_t sink = {.fd = fd, .offset = 100, .flags = AHR_FILE_SINK_PREALLOCATE};
+    const AHR_RequestData_t request = {.url = url, .borrowed_body = &body, .file_sink = &sink};
+    TEST_Context_t context;
+    TEST_ContextInit(&context);
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorPost(processor, 0, &request, TEST_UserData(&context)));
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 0));
+    TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+    //
+    // on_success reports an empty Body, the Body is in the File.
+    //
+    TEST_ASSERT_EQUAL_INT(200, context.status);
+    TEST_ASSERT_EQUAL_size_t(0, context.nbytes);
+    char *contents = malloc(TEST_PROCESSOR_LARGE_BODY + 100U);
+    TEST_ASSERT_NOT_NULL(contents);
+    TEST_ASSERT_EQUAL_INT(
+        (int)(TEST_PROCESSOR_LARGE_BODY + 100U),
+        (int)pread(fd, contents, TEST_PROCESSOR_LARGE_BODY + 100U, 0)
+    );
+    TEST_ASSERT_EQUAL_MEMORY(data, contents + 100, TEST_PROCESSOR_LARGE_BODY);
+    free(contents);
+    TEST_ContextRelease(&context);
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+    close(fd);
+    free(data);
+}
+
+void test_AHR_ProcessorFileSource(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char url[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/upload");
+    char *data = TEST_Pattern(TEST_PROCESSOR_LARGE_BODY);
+    TEST_ASSERT_NOT_NULL(data);
+    const int fd = TEST_TempFile();
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT((int)TEST_PROCESSOR_LARGE_BODY, (int)pwrite(fd, data, TEST_PROCESSOR_LARGE_BODY, 0));
+    //
+    // Read piecewise and mapped, both skip the first 1000 Bytes of the File.
+    //
+    const unsigned int flags[] = {0U, AHR_FILE_SOURCE_MMAP};
+    for(size_t i=0;i<sizeof(flags) / sizeof(flags[0]);++i)
+    {
+        const AHR_FileSource_t source = {.path = NULL, .fd = fd, .offset = 1000, .length = -1, .flags = flags[i]};
+        const AHR_RequestData_t request = {.url = url, .file_source = &source};
+        TEST_Context_t context;
+        TEST_ContextInit(&context);
+        TEST_ASSERT_EQUAL_INT(
+            AHR_PROC_OK,
+            AHR_ProcessorPost(processor, 1, &request, TEST_UserData(&context))
+        );
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 1));
+        TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+        TEST_ASSERT_EQUAL_INT(200, context.status);
+        TEST_ASSERT_EQUAL_size_t(TEST_PROCESSOR_LARGE_BODY - 1000U, context.nbytes);
+        TEST_ASSERT_EQUAL_MEMORY(data + 1000, context.body, TEST_PROCESSOR_LARGE_BODY - 1000U);
+        TEST_ContextRelease(&context);
+    }
+    //
+    // A File which can not be opened fails the Configuration.
+    //
+    const AHR_FileSource_t missing = {.path = "/nonexistent/ahr_test", .fd = -1, .offset = 0, .length = -1, .flags = 0};
+    const AHR_RequestData_t request = {.url = url, .file_source = &missing};
+    TEST_Context_t context;
+    TEST_ContextInit(&context);
+    TEST_ASSERT_EQUAL_INT(
+        AHR_PROC_IO_ERROR,
+        AHR_ProcessorPost(processor, 1, &request, TEST_UserData(&context))
+    );
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+    close(fd);
+    free(data);
+}
+
+void test_AHR_ProcessorRequestHeaders(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char url[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/headers");
+    //
+    // The same Object sends the Headers of its latest Configuration, and none once it has none.
+    //
+    const AHR_HeaderView_t one = {.name = "X-Echo", .name_len = 6, .value = "one", .value_len = 3};
+    const AHR_HeaderView_t two = {.name = "X-Echo", .name_len = 6, .value = "two", .value_len = 3};
+    const AHR_RequestData_t requests[] = {
+        {.url = url, .header = &one, .nheaders = 1},
+        {.url = url, .header = &two, .nheaders = 1},
+        {.url = url, .header = &one, .nheaders = 1},
+        {.url = url, .header = NULL, .nheaders = 0}
+    };
+    const char *const expected[] = {"one", "two", "one", NULL};
+    for(size_t i=0;i<sizeof(requests) / sizeof(requests[0]);++i)
+    {
+        TEST_Context_t context;
+        TEST_ContextInit(&context);
+        TEST_ASSERT_EQUAL_INT(
+            AHR_PROC_OK,
+            AHR_ProcessorGet(processor, 0, &requests[i], TEST_UserData(&context))
+        );
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 0));
+        TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+        TEST_ASSERT_EQUAL_INT(200, context.status);
+        TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 0, "X-Method", "GET"));
+        if(expected[i])
+        {
+            TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 0, "X-Echo", expected[i]));
+        }
+        else
+        {
+            AHR_HeaderView_t view;
+            TEST_ASSERT_FALSE(AHR_ProcessorResponseHeaderFind(processor, 0, "X-Echo", &view));
+        }
+        TEST_ContextRelease(&context);
+    }
+    //
+    // More Headers than fit are refused, the Body the Object borrowed before is let go, the new one is not taken.
+    //
+    TEST_Context_t before;
+    TEST_Context_t refused;
+    TEST_ContextInit(&before);
+    TEST_ContextInit(&refused);
+    const AHR_BodyDescriptor_t before_body = {.data = "before", .nbytes = 6U, .release = TEST_Release, .user = &before};
+    const AHR_BodyDescriptor_t refused_body = {
+        .data = "refused", .nbytes = 7U, .release = TEST_Release, .user = &refused
+    };
+    AHR_HeaderView_t *many = calloc(AHR_HEADER_NMAX + 1U, sizeof(AHR_HeaderView_t));
+    TEST_ASSERT_NOT_NULL(many);
+    for(size_t i=0;i<AHR_HEADER_NMAX + 1U;++i)
+    {
+        many[i] = one;
+    }
+    AHR_RequestData_t request = {.url = url, .borrowed_body = &before_body};
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorPost(processor, 1, &request, TEST_UserData(&before)));
+    request = (AHR_RequestData_t){.url = url, .header = many, .nheaders = AHR_HEADER_NMAX + 1U};
+    request.borrowed_body = &refused_body;
+    TEST_ASSERT_EQUAL_INT(
+        AHR_PROC_NOT_ENOUGH_MEMORY, 
+        AHR_ProcessorPost(processor, 1, &request, TEST_UserData(&refused))
+    );
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&before.releases));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&refused.releases));
+    request.nheaders = AHR_HEADER_NMAX;
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorPost(processor, 1, &request, TEST_UserData(&refused)));
+    free(many);
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&before.releases));
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&refused.releases));
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+}
+
+void test_AHR_ProcessorBaseUrl(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    TEST_Context_t context;
+    TEST_ContextInit(&context);
+    const AHR_RequestData_t request = {.path = "/items?id=1"};
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_INVALID_URL, AHR_ProcessorGet(processor, 0, &request, TEST_UserData(&context)));
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_INVALID_URL, AHR_ProcessorSetBaseUrl(processor, "not a url"));
+
+    char base[128]; // flawfinder: ignore
+    TEST_Url(base, sizeof(base), server, "/api");
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorSetBaseUrl(processor, base));
+    TEST_Url(base, sizeof(base), server, "/other/");
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorSetObjectBaseUrl(processor, 1, base));
+    TEST_ASSERT_EQUAL_INT(
+        AHR_PROC_UNKNOWN_OBJECT,
+        AHR_ProcessorSetObjectBaseUrl(processor, TEST_PROCESSOR_OBJECTS, base)
+    );
+    //
+    // The Path is appended to the Path of the Base URL of each Object, with exactly one Slash in between.
+    //
+    const AHR_RequestData_t requests[] = {{.path = "/items?id=1"}, {.path = "items?id=2"}};
+    const char *const paths[] = {"/api/items?id=1", "/other/items?id=2"};
+    for(size_t i=0;i<sizeof(paths) / sizeof(paths[0]);++i)
+    {
+        TEST_ContextInit(&context);
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorGet(processor, i, &requests[i], TEST_UserData(&context)));
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, i));
+        TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+        TEST_ASSERT_EQUAL_INT(200, context.status);
+        TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, i, "X-Path", paths[i]));
+        TEST_ContextRelease(&context);
+    }
+    //
+    // Unbound Objects need a full URL again.
+    //
+    const struct timespec pause = {.tv_sec = 0, .tv_nsec = 1000000};
+    AHR_ProcessorStatus_t status = AHR_ProcessorSetBaseUrl(processor, NULL);
+    for(size_t i=0;i<TEST_PROCESSOR_TIMEOUT_MS && AHR_PROC_OBJECT_BUSY == status;++i)
+    {
+        nanosleep(&pause, NULL);
+        status = AHR_ProcessorSetBaseUrl(processor, NULL);
+    }
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, status);
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_INVALID_URL, AHR_ProcessorGet(processor, 1, &request, TEST_UserData(&context)));
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+}
+
+void test_AHR_ProcessorResponseHeaderWhitelist(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char url[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/headers");
+    static const char *const names[] = {"etag", "X-METHOD"};
+    const AHR_RequestData_t requests[] = {
+        {.url = url},
+        {.url = url, .response_headers = names, .nresponse_headers = 2}
+    };
+    for(size_t i=0;i<sizeof(requests) / sizeof(requests[0]);++i)
+    {
+        TEST_Context_t context;
+        TEST_ContextInit(&context);
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorGet(processor, i, &requests[i], TEST_UserData(&context)));
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, i));
+        TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+        TEST_ASSERT_EQUAL_INT(200, context.status);
+        TEST_ContextRelease(&context);
+    }
+    //
+    // All Headers without a Whitelist, only the listed ones with it. Lookups ignore Case.
+    //
+    AHR_HeaderView_t view;
+    TEST_ASSERT_GREATER_THAN_size_t(6, AHR_ProcessorResponseHeaderCount(processor, 0));
+    TEST_ASSERT_TRUE(AHR_ProcessorResponseHeaderFind(processor, 0, "content-length", &view));
+    TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 0, "ETAG", "\"abc\""));
+
+    TEST_ASSERT_EQUAL_size_t(2, AHR_ProcessorResponseHeaderCount(processor, 1));
+    TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 1, "ETag", "\"abc\""));
+    TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 1, "x-method", "GET"));
+    TEST_ASSERT_FALSE(AHR_ProcessorResponseHeaderFind(processor, 1, "Content-Length", &view));
+    TEST_ASSERT_TRUE(AHR_ProcessorResponseHeaderAt(processor, 1, 1, &view));
+    TEST_ASSERT_FALSE(AHR_ProcessorResponseHeaderAt(processor, 1, 2, &view));
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+}
+
+void test_AHR_ProcessorContentDecoding(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    const AHR_ProcessorOptions_t options = {
+        .max_objects = TEST_PROCESSOR_OBJECTS, .accept_encodings = AHR_ENCODING_GZIP
+    };
+    AHR_Processor_t processor = AHR_CreateProcessorWithOptions(&options, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char url[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/gzip");
+    char *data = TEST_Pattern(TEST_PROCESSOR_LARGE_BODY);
+    TEST_ASSERT_NOT_NULL(data);
+    const AHR_BodyDescriptor_t body = {
+        .data = data, .nbytes = TEST_PROCESSOR_LARGE_BODY, .release = NULL, .user = NULL
+    };
+    //
+    // Decoded with the Processors Setting, not negotiated with AHR_ENCODING_IDENTITY, 
+    // aborted once the decoded Body exceeds its Limit.
+    //
+    const AHR_RequestData_t requests[] = {
+        {.url = url, .borrowed_body = &body},
+        {.url = url, .borrowed_body = &body, .accept_encodings = AHR_ENCODING_IDENTITY},
+        {.url = url, .borrowed_body = &body, .max_decoded_bytes = TEST_PROCESSOR_LARGE_BODY / 2U}
+    };
+    TEST_Context_t contexts[3];
+    for(size_t i=0;i<sizeof(requests) / sizeof(requests[0]);++i)
+    {
+        TEST_ContextInit(&contexts[i]);
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorPost(processor, i, &requests[i], TEST_UserData(&contexts[i])));
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, i));
+        TEST_ASSERT_TRUE(TEST_Await(&contexts[i].callbacks, 1));
+    }
+    for(size_t i=0;i<2;++i)
+    {
+        TEST_ASSERT_EQUAL_INT(200, contexts[i].status);
+        TEST_ASSERT_EQUAL_size_t(TEST_PROCESSOR_LARGE_BODY, contexts[i].nbytes);
+        TEST_ASSERT_EQUAL_MEMORY(data, contexts[i].body, TEST_PROCESSOR_LARGE_BODY);
+    }
+    TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 0, "Content-Encoding", "gzip"));
+    AHR_HeaderView_t view;
+    TEST_ASSERT_FALSE(AHR_ProcessorResponseHeaderFind(processor, 1, "Content-Encoding", &view));
+    TEST_ASSERT_EQUAL_INT(0, contexts[2].status);
+    TEST_ASSERT_NOT_EQUAL(0, contexts[2].error);
+
+    AHR_DecodingStats_t stats;
+    AHR_ProcessorDecodingStats(processor, &stats);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.limit_exceeded);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT64(2, stats.responses);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT64(1, stats.encoded_responses);
+    TEST_ASSERT_LESS_THAN_UINT64(stats.decoded_bytes, stats.wire_bytes);
+    for(size_t i=0;i<sizeof(contexts) / sizeof(contexts[0]);++i)
+    {
+        TEST_ContextRelease(&contexts[i]);
+    }
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+    free(data);
+}
+
+void test_AHR_ProcessorContentEncoding(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    const AHR_ProcessorOptions_t options = {
+        .max_objects = TEST_PROCESSOR_OBJECTS, .content_encoding = AHR_ENCODING_GZIP, .min_compress_bytes = 1024U
+    };
+    AHR_Processor_t processor = AHR_CreateProcessorWithOptions(&options, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char url[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/echo");
+    const size_t sizes[] = {TEST_PROCESSOR_LARGE_BODY / 2U, TEST_PROCESSOR_LARGE_BODY * 3U / 2U, 100U};
+    char *data = TEST_Pattern(sizes[1]);
+    char *decoded = malloc(sizes[1]);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_NOT_NULL(decoded);
+    //
+    // Compressed at once, compressed while it is sent because it may not fit into a pooled Buffer, 
+    // and sent as is because it is below "min_compress_bytes".
+    //
+    TEST_Context_t contexts[3];
+    for(size_t i=0;i<sizeof(sizes) / sizeof(sizes[0]);++i)
+    {
+        TEST_ContextInit(&contexts[i]);
+        const AHR_BodyDescriptor_t body = {.data = data, .nbytes = sizes[i], .release = NULL, .user = NULL};
+        const AHR_RequestData_t request = {.url = url, .borrowed_body = &body};
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorPost(processor, i, &request, TEST_UserData(&contexts[i])));
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, i));
+        TEST_ASSERT_TRUE(TEST_Await(&contexts[i].callbacks, 1));
+        TEST_ASSERT_EQUAL_INT(200, contexts[i].status);
+    }
+    for(size_t i=0;i<2;++i)
+    {
+        TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, i, "X-Request-Encoding", "gzip"));
+        TEST_ASSERT_LESS_THAN_size_t(sizes[i] / 4U, contexts[i].nbytes);
+        TEST_ASSERT_EQUAL_INT64(
+            (int64_t)sizes[i], TEST_Gunzip(contexts[i].body, contexts[i].nbytes, decoded, sizes[1])
+        );
+        TEST_ASSERT_EQUAL_MEMORY(data, decoded, sizes[i]);
+    }
+    TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 0, "X-Request-Chunked", "0"));
+    TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 1, "X-Request-Chunked", "1"));
+    TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 2, "X-Request-Encoding", "-"));
+    TEST_ASSERT_EQUAL_size_t(sizes[2], contexts[2].nbytes);
+    TEST_ASSERT_EQUAL_MEMORY(data, contexts[2].body, sizes[2]);
+
+    AHR_CompressionStats_t stats[2];
+    TEST_ASSERT_EQUAL_size_t(1, AHR_ProcessorCompressionStats(processor, stats, 2));
+    TEST_ASSERT_EQUAL_STRING(url, stats[0].endpoint);
+    TEST_ASSERT_EQUAL_UINT64(2, stats[0].requests);
+    TEST_ASSERT_EQUAL_UINT64(sizes[0] + sizes[1], stats[0].uncompressed_bytes);
+    TEST_ASSERT_EQUAL_UINT64(contexts[0].nbytes + contexts[1].nbytes, stats[0].compressed_bytes);
+    for(size_t i=0;i<sizeof(contexts) / sizeof(contexts[0]);++i)
+    {
+        TEST_ContextRelease(&contexts[i]);
+    }
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+    free(decoded);
+    free(data);
+}
+
+void test_AHR_ProcessorJsonIndex(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    const AHR_ProcessorOptions_t options = {
+        .max_objects = TEST_PROCESSOR_OBJECTS, .accept_encodings = AHR_ENCODING_GZIP, .json_index = AHR_JSON_INDEX_ON
+    };
+    AHR_Processor_t processor = AHR_CreateProcessorWithOptions(&options, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char echo[128]; // flawfinder: ignore
+    char gzip[128]; // flawfinder: ignore
+    TEST_Url(echo, sizeof(echo), server, "/echo");
+    TEST_Url(gzip, sizeof(gzip), server, "/gzip");
+    static const char document[] = "{\"items\": [{\"id\": 1}, {\"id\": 42, \"name\": \"b\"}], \"more\": false}";
+    static const char broken[] = "{\"items\": [{\"id\": 1}, {\"id\": 42,}]}";
+    const AHR_BodyDescriptor_t document_body = {.data = document, .nbytes = sizeof(document) - 1U};
+    const AHR_BodyDescriptor_t broken_body = {.data = broken, .nbytes = sizeof(broken) - 1U};
+    //
+    // Indexed with the Processors Setting, also after gzip Decoding, not indexed if the Request turns
+    // it off, and rejected at the offending Byte.
+    //
+    const AHR_RequestData_t requests[] = {
+        {.url = echo, .borrowed_body = &document_body},
+        {.url = gzip, .borrowed_body = &document_body},
+        {.url = echo, .borrowed_body = &document_body, .json_index = AHR_JSON_INDEX_OFF},
+        {.url = echo, .borrowed_body = &broken_body}
+    };
+    TEST_JsonContext_t contexts[4];
+    for(size_t i=0;i<sizeof(requests) / sizeof(requests[0]);++i)
+    {
+        TEST_ContextInit(&contexts[i].context);
+        contexts[i].processor = processor;
+        AHR_UserData_t user = TEST_UserData(&contexts[i].context);
+        user.data = &contexts[i];
+        user.on_success = TEST_OnJson;
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorPost(processor, i, &requests[i], user));
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, i));
+        TEST_ASSERT_TRUE(TEST_Await(&contexts[i].context.callbacks, 1));
+        TEST_ASSERT_EQUAL_INT(200, contexts[i].context.status);
+    }
+    for(size_t i=0;i<2;++i)
+    {
+        TEST_ASSERT_TRUE(contexts[i].indexed);
+        TEST_ASSERT_EQUAL_INT64(42, contexts[i].id);
+    }
+    TEST_ASSERT_TRUE(TEST_HeaderEquals(processor, 1, "Content-Encoding", "gzip"));
+    TEST_ASSERT_FALSE(contexts[2].indexed);
+    TEST_ASSERT_FALSE(contexts[3].indexed);
+    TEST_ASSERT_EQUAL_size_t((size_t)(strstr(broken, ",}") - broken) + 1U, contexts[3].error_offset);
+    //
+    // Outside of on_success there is no Index.
+    //
+    AHR_JsonIndex_t index;
+    TEST_ASSERT_FALSE(AHR_ProcessorResponseJson(processor, TEST_PROCESSOR_OBJECTS, &index));
+    TEST_ASSERT_EQUAL_size_t(0, index.ntokens);
+    for(size_t i=0;i<sizeof(contexts) / sizeof(contexts[0]);++i)
+    {
+        TEST_ContextRelease(&contexts[i].context);
+    }
+
+    AHR_ProcessorStop(processor);
+    //
+    // Once on_success returned the Body is gone, and so is the Index of a valid Body.
+    //
+    TEST_ASSERT_FALSE(AHR_ProcessorResponseJson(processor, 0, &index));
+    TEST_ASSERT_NULL(index.body);
+    TEST_ASSERT_EQUAL_size_t(0, index.ntokens);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+}
+
+void test_AHR_ProcessorRequestTimings(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    AHR_RequestTimings_t timings;
+    TEST_ASSERT_FALSE(AHR_ProcessorRequestTimings(processor, TEST_PROCESSOR_OBJECTS, &timings));
+    TEST_ASSERT_TRUE(AHR_ProcessorRequestTimings(processor, 0, &timings));
+    TEST_ASSERT_EQUAL_UINT64(0, timings.submit_ns);
+    TEST_ASSERT_EQUAL_UINT64(0, timings.callback_ns);
+
+    char url[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/echo");
+    const AHR_RequestData_t request = {.url = url};
+    //
+    // The second Request of the Object reuses the Connection of the first one.
+    //
+    for(size_t i=0;i<2;++i)
+    {
+        TEST_Context_t context;
+        TEST_ContextInit(&context);
+        TEST_ASSERT_EQUAL_INT(
+            AHR_PROC_OK, AHR_ProcessorGet(processor, 0, &request, TEST_UserData(&context))
+        );
+        const uint64_t before_ns = TEST_NowNs();
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 0));
+        TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+        const uint64_t after_ns = TEST_NowNs();
+        TEST_ASSERT_EQUAL_INT(200, context.status);
+
+        TEST_ASSERT_TRUE(AHR_ProcessorRequestTimings(processor, 0, &timings));
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64(timings.submit_ns, before_ns);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64(timings.dequeue_ns, timings.submit_ns);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64(timings.multi_add_ns, timings.dequeue_ns);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64(timings.complete_ns, timings.multi_add_ns);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64(timings.callback_ns, timings.complete_ns);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64(after_ns, timings.callback_ns);
+        //
+        // curls Phases count from the Start of the Transfer, plain HTTP has no TLS Handshake.
+        //
+        TEST_ASSERT_EQUAL_UINT64(0, timings.app_connect_us);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64(timings.pretransfer_us, timings.connect_us);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64(timings.first_byte_us, timings.pretransfer_us);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64(timings.total_us, timings.first_byte_us);
+        TEST_ASSERT_GREATER_THAN_UINT64(0, timings.total_us);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64((after_ns - before_ns) / 1000U, timings.total_us);
+        TEST_ContextRelease(&context);
+    }
+    TEST_ASSERT_EQUAL_UINT64(0, timings.connect_us);
+    TEST_ASSERT_EQUAL_UINT64(1, TEST_ServerConnections(server));
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+}
+
+void test_AHR_ProcessorMetrics(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_Server_t closed = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    TEST_ASSERT_NOT_NULL(closed);
+    char url[128]; // flawfinder: ignore
+    char refused[128]; // flawfinder: ignore
+    char origin[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/echo");
+    TEST_Url(origin, sizeof(origin), server, "");
+    TEST_Url(refused, sizeof(refused), closed, "/echo");
+    TEST_ServerStop(&closed);
+
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t processor = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+    //
+    // Three Requests on one Connection, then one to a Port nobody listens on.
+    //
+    for(size_t i=0;i<4;++i)
+    {
+        TEST_Context_t context;
+        TEST_ContextInit(&context);
+        const AHR_RequestData_t request = {.url = i < 3 ? url : refused};
+        TEST_ASSERT_EQUAL_INT(
+            AHR_PROC_OK, AHR_ProcessorGet(processor, 0, &request, TEST_UserData(&context))
+        );
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 0));
+        TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+        TEST_ASSERT_EQUAL_INT(i < 3 ? 200 : 0, context.status);
+        TEST_ContextRelease(&context);
+    }
+
+    AHR_MetricsSnapshot_t snapshot;
+    AHR_ProcessorMetricsSnapshot(processor, &snapshot);
+    TEST_ASSERT_EQUAL_UINT64(4, snapshot.submitted);
+    TEST_ASSERT_EQUAL_UINT64(3, snapshot.completed[2]);
+    TEST_ASSERT_EQUAL_UINT64(1, snapshot.failed[AHR_FAILURE_CONNECT]);
+    TEST_ASSERT_EQUAL_UINT64(0, snapshot.queue_depth);
+    TEST_ASSERT_EQUAL_UINT64(0, snapshot.in_flight);
+    TEST_ASSERT_EQUAL_UINT64(2, snapshot.connections_reused);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT64(1, snapshot.connections_opened);
+    TEST_ASSERT_GREATER_THAN_UINT64(0, snapshot.bytes_in);
+    TEST_ASSERT_GREATER_THAN_UINT64(0, snapshot.bytes_out);
+    TEST_ASSERT_EQUAL_size_t(1, snapshot.norigins);
+    TEST_ASSERT_EQUAL_STRING(origin, snapshot.origins[0].origin);
+    TEST_ASSERT_EQUAL_UINT64(3, snapshot.origins[0].count);
+    TEST_ASSERT_GREATER_THAN_UINT64(0, snapshot.origins[0].max_us);
+
+    char text[8192]; // flawfinder: ignore
+    const int64_t n = AHR_ProcessorMetricsPrometheus(processor, text, sizeof(text));
+    TEST_ASSERT_GREATER_THAN_INT64(0, n);
+    TEST_ASSERT_NOT_NULL(strstr(text, "ahr_requests_completed_total{class=\"2xx\"} 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "ahr_requests_failed_total{reason=\"connect\"} 1\n"));
+    TEST_ASSERT_EQUAL_INT64(-1, AHR_ProcessorMetricsPrometheus(processor, text, 16));
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+}
+
+void test_AHR_ProcessorDumpTrace(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    AHR_Processor_t untraced = AHR_CreateProcessor(TEST_PROCESSOR_OBJECTS, logger);
+    TEST_ASSERT_NOT_NULL(untraced);
+    const AHR_ProcessorOptions_t options = {.max_objects = TEST_PROCESSOR_OBJECTS, .trace_events = 4096U};
+    AHR_Processor_t processor = AHR_CreateProcessorWithOptions(&options, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char url[128]; // flawfinder: ignore
+    TEST_Url(url, sizeof(url), server, "/echo");
+    TEST_Context_t context;
+    TEST_ContextInit(&context);
+    const AHR_RequestData_t request = {.url = url};
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorGet(processor, 1, &request, TEST_UserData(&context)));
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 1));
+    TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+    TEST_ASSERT_EQUAL_INT(200, context.status);
+    TEST_ContextRelease(&context);
+    AHR_ProcessorStop(processor);
+
+    const int fd = TEST_TempFile();
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_FALSE(AHR_ProcessorDumpTrace(untraced, fd));
+    TEST_ASSERT_TRUE(AHR_ProcessorDumpTrace(processor, fd));
+    const off_t size = lseek(fd, 0, SEEK_END);
+    TEST_ASSERT_TRUE(size > 0);
+    char *dump = malloc((size_t)size + 1U);
+    TEST_ASSERT_NOT_NULL(dump);
+    TEST_ASSERT_EQUAL_INT64(size, pread(fd, dump, (size_t)size, 0));
+    dump[size] = '\0';
+    close(fd);
+    //
+    // Valid JSON with the Request Track of Object 1 and the Slices of the I/O Thread.
+    //
+    AHR_JsonIndexer_t indexer = AHR_CreateJsonIndexer();
+    TEST_ASSERT_TRUE(AHR_JsonIndexerFinish(&indexer, dump, (size_t)size));
+    AHR_JsonIndex_t index;
+    TEST_ASSERT_TRUE(AHR_JsonIndexerView(&indexer, dump, (size_t)size, &index));
+    static const char *const slices[] = {
+        "\"name\":\"queued\",\"cat\":\"ahr\",\"ph\":\"b\"",
+        "\"name\":\"transfer\",\"cat\":\"ahr\",\"ph\":\"e\"",
+        "\"name\":\"callback\",\"cat\":\"ahr\",\"ph\":\"b\"",
+        "\"name\":\"on_success\",\"cat\":\"ahr\",\"ph\":\"B\"",
+        "\"name\":\"AHR_ProcessorMakeRequest\",\"cat\":\"ahr\",\"ph\":\"E\"",
+        "\"args\":{\"object\":1}"
+    };
+    for(size_t i=0;i<sizeof(slices) / sizeof(slices[0]);++i)
+    {
+        TEST_ASSERT_NOT_NULL(strstr(dump, slices[i]));
+    }
+    AHR_DestroyJsonIndexer(&indexer);
+    free(dump);
+
+    AHR_DestroyProcessor(&untraced);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+}
+
+void test_AHR_ProcessorRecord(void)
+{
+    TEST_Server_t server = TEST_ServerStart();
+    TEST_Server_t closed = TEST_ServerStart();
+    TEST_ASSERT_NOT_NULL(server);
+    TEST_ASSERT_NOT_NULL(closed);
+    char get[128]; // flawfinder: ignore
+    char post[128]; // flawfinder: ignore
+    char refused[128]; // flawfinder: ignore
+    TEST_Url(get, sizeof(get), server, "/echo/42?id=1");
+    TEST_Url(post, sizeof(post), server, "/echo");
+    TEST_Url(refused, sizeof(refused), closed, "/echo");
+    TEST_ServerStop(&closed);
+
+    AHR_Logger_t logger = TEST_CreateLogger();
+    const AHR_ProcessorOptions_t unwritable = {
+        .max_objects = TEST_PROCESSOR_OBJECTS, .record_path = "/nonexistent/ahr_test_processor.rec"
+    };
+    TEST_ASSERT_NULL(AHR_CreateProcessorWithOptions(&unwritable, logger));
+    char path[] = "/tmp/ahr_test_processor_XXXXXX"; // flawfinder: ignore
+    close(mkstemp(path));
+    const AHR_ProcessorOptions_t options = {.max_objects = TEST_PROCESSOR_OBJECTS, .record_path = path};
+    AHR_Processor_t processor = AHR_CreateProcessorWithOptions(&options, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+    //
+    // A GET with a Header, a POST with a Body, and a GET to a Port nobody listens on.
+    //
+    const AHR_HeaderView_t header = {.name = "X-Echo", .name_len = 6, .value = "one", .value_len = 3};
+    char body[] = "hello"; // flawfinder: ignore
+    const AHR_RequestData_t requests[] = {
+        {.url = get, .header = &header, .nheaders = 1},
+        {.url = post, .body = body},
+        {.url = refused}
+    };
+    const TEST_Method_t methods[] = {AHR_ProcessorGet, AHR_ProcessorPost, AHR_ProcessorGet};
+    for(size_t i=0;i<sizeof(requests) / sizeof(requests[0]);++i)
+    {
+        TEST_Context_t context;
+        TEST_ContextInit(&context);
+        TEST_ASSERT_EQUAL_INT(
+            AHR_PROC_OK, methods[i](processor, 0, &requests[i], TEST_UserData(&context))
+        );
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, 0));
+        TEST_ASSERT_TRUE(TEST_Await(&context.callbacks, 1));
+        TEST_ContextRelease(&context);
+    }
+    //
+    // The Recording is complete once the Processor stopped.
+    //
+    AHR_ProcessorStop(processor);
+
+    AHR_RecordReader_t reader = AHR_RecordReaderOpen(path);
+    TEST_ASSERT_NOT_NULL(reader);
+    AHR_Record_t records[3];
+    for(size_t i=0;i<sizeof(records) / sizeof(records[0]);++i)
+    {
+        TEST_ASSERT_EQUAL_INT(AHR_RECORD_OK, AHR_RecordReaderNext(reader, &records[i]));
+        TEST_ASSERT_TRUE(records[i].latency_us > 0);
+        TEST_ASSERT_TRUE(records[i].server_us <= records[i].latency_us);
+        TEST_ASSERT_TRUE(0 == i || records[i].submit_us >= records[i - 1U].submit_us + records[i - 1U].latency_us);
+    }
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_GET, records[0].method);
+    TEST_ASSERT_EQUAL_STRING("/echo/{id}?id=", records[0].url_template);
+    TEST_ASSERT_EQUAL_UINT32(1, records[0].nheaders);
+    TEST_ASSERT_EQUAL_UINT64(strlen("X-Echo: one\r\n"), records[0].header_bytes);
+    TEST_ASSERT_EQUAL_UINT64(0, records[0].body_bytes);
+    TEST_ASSERT_EQUAL_UINT32(200, records[0].status);
+    TEST_ASSERT_EQUAL_UINT32(0, records[0].error);
+    TEST_ASSERT_TRUE(records[0].server_us > 0);
+    TEST_ASSERT_TRUE(records[0].response_header_bytes > 0);
+    TEST_ASSERT_EQUAL_UINT64(0, records[0].response_bytes);
+
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_POST, records[1].method);
+    TEST_ASSERT_EQUAL_STRING("/echo", records[1].url_template);
+    TEST_ASSERT_EQUAL_UINT32(0, records[1].nheaders);
+    TEST_ASSERT_EQUAL_UINT64(5, records[1].body_bytes);
+    TEST_ASSERT_EQUAL_UINT32(200, records[1].status);
+    TEST_ASSERT_EQUAL_UINT64(5, records[1].response_bytes);
+    TEST_ASSERT_EQUAL_UINT64(5, records[1].decoded_bytes);
+
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_GET, records[2].method);
+    TEST_ASSERT_EQUAL_STRING("/echo", records[2].url_template);
+    TEST_ASSERT_EQUAL_UINT32(0, records[2].status);
+    TEST_ASSERT_EQUAL_UINT32(7, records[2].error);
+    TEST_ASSERT_EQUAL_UINT64(0, records[2].server_us);
+    TEST_ASSERT_EQUAL_UINT64(0, records[2].response_bytes);
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_END, AHR_RecordReaderNext(reader, &records[0]));
+    AHR_RecordReaderClose(&reader);
+
+    unlink(path);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    TEST_ServerStop(&server);
+}
+
+///
+/// \brief  A Listener which takes Connections into its Backlog but never answers them.
+/// \returns    The Socket, -1 on Error.
+///
+static int TEST_SilentListener(uint16_t *port)
+{
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = 0, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    socklen_t length = sizeof(address);
+    if(
+        fd < 0
+        || 0 != bind(fd, (struct sockaddr*)&address, sizeof(address))
+        || 0 != listen(fd, TEST_PROCESSOR_OBJECTS)
+        || 0 != getsockname(fd, (struct sockaddr*)&address, &length)
+    )
+    {
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+        return -1;
+    }
+    *port = ntohs(address.sin_port);
+    return fd;
+}
+
+void test_AHR_ProcessorTimeouts(void)
+{
+    uint16_t port = 0;
+    const int listener = TEST_SilentListener(&port);
+    TEST_ASSERT_TRUE(listener >= 0);
+    AHR_Logger_t logger = TEST_CreateLogger();
+    const AHR_ProcessorOptions_t options = {
+        .max_objects = TEST_PROCESSOR_OBJECTS, .timeout_ms = 300, .stall_seconds = 1
+    };
+    AHR_Processor_t processor = AHR_CreateProcessorWithOptions(&options, logger);
+    TEST_ASSERT_NOT_NULL(processor);
+    TEST_ASSERT_TRUE(AHR_ProcessorStart(processor));
+
+    char url[128]; // flawfinder: ignore
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/silent", (unsigned int)port);
+    const AHR_RequestData_t request = {.url = url};
+    const AHR_RequestData_t limited = {.url = url, .timeout_ms = 100};
+    TEST_Context_t explicit;
+    TEST_Context_t buffered;
+    TEST_Context_t streamed;
+    TEST_ContextInit(&explicit);
+    TEST_ContextInit(&buffered);
+    TEST_ContextInit(&streamed);
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorGet(processor, 0, &limited, TEST_StreamUserData(&explicit)));
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorGet(processor, 1, &request, TEST_UserData(&buffered)));
+    TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorGet(processor, 2, &request, TEST_StreamUserData(&streamed)));
+    const uint64_t start_ns = TEST_NowNs();
+    for(size_t i=0;i<3;++i)
+    {
+        TEST_ASSERT_EQUAL_INT(AHR_PROC_OK, AHR_ProcessorMakeRequest(processor, i));
+    }
+    //
+    // The own Timeout of a Request wins, a buffered Transfer gets the one of the Processor and a streamed
+    // Transfer has none, it is aborted once it stalled for a Second.
+    //
+    TEST_ASSERT_TRUE(TEST_Await(&explicit.callbacks, 1));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&buffered.callbacks));
+    TEST_ASSERT_TRUE(TEST_Await(&buffered.callbacks, 1));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&streamed.callbacks));
+    TEST_ASSERT_TRUE(TEST_Await(&streamed.callbacks, 1));
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT64(1000000000U, TEST_NowNs() - start_ns);
+    //
+    // CURLE_OPERATION_TIMEDOUT
+    //
+    TEST_ASSERT_EQUAL_size_t(28, explicit.error);
+    TEST_ASSERT_EQUAL_size_t(28, buffered.error);
+    TEST_ASSERT_EQUAL_size_t(28, streamed.error);
+
+    AHR_ProcessorStop(processor);
+    AHR_DestroyProcessor(&processor);
+    AHR_DestroyLogger(&logger);
+    close(listener);
+}
@@ -0,0 +1,397 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <test_record.h>
+#include <async_http_requests/ahr_record.h>
+#include <async_http_requests/private/ahr_recorder.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#define TEST_RECORD_HEADER_BYTES 16U
+#define TEST_RECORD_TEMPLATES 5000U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static uint64_t TEST_RecordNowNs(clockid_t clock)
+{
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+///
+/// \brief  Create an empty File at "path", which is a mkstemp() Template.
+///
+static void TEST_RecordTempPath(char *path)
+{
+    const int fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+}
+
+static uint64_t TEST_RecordFileSize(const char *path)
+{
+    struct stat info;
+    TEST_ASSERT_EQUAL_INT(0, stat(path, &info));
+    return (uint64_t)info.st_size;
+}
+
+static void TEST_RecordWriteFile(const char *path, const unsigned char *data, size_t nbytes)
+{
+    FILE *file = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_size_t(nbytes, fwrite(data, 1, nbytes, file));
+    fclose(file);
+}
+
+///
+/// \brief  Read the whole File at "path".
+/// \returns    The Contents, to be freed by the Caller.
+///
+static unsigned char* TEST_RecordReadFile(const char *path, size_t *nbytes)
+{
+    *nbytes = (size_t)TEST_RecordFileSize(path);
+    unsigned char *data = malloc(*nbytes);
+    TEST_ASSERT_NOT_NULL(data);
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_size_t(*nbytes, fread(data, 1, *nbytes, file));
+    fclose(file);
+    return data;
+}
+
+///
+/// \brief  Write a valid Header followed by "nbytes" of "data" to "path" and read the first Record.
+///
+static AHR_RecordStatus_t TEST_RecordReadFirst(const char *path, const unsigned char *data, size_t nbytes)
+{
+    unsigned char file[64] = {'A', 'H', 'R', 'R', AHR_RECORD_VERSION}; // flawfinder: ignore
+    TEST_ASSERT_TRUE(TEST_RECORD_HEADER_BYTES + nbytes <= sizeof(file));
+    if(nbytes > 0)
+    {
+        memcpy(&file[TEST_RECORD_HEADER_BYTES], data, nbytes); // flawfinder: ignore
+    }
+    TEST_RecordWriteFile(path, file, TEST_RECORD_HEADER_BYTES + nbytes);
+    AHR_RecordReader_t reader = AHR_RecordReaderOpen(path);
+    TEST_ASSERT_NOT_NULL(reader);
+    AHR_Record_t record;
+    const AHR_RecordStatus_t status = AHR_RecordReaderNext(reader, &record);
+    AHR_RecordReaderClose(&reader);
+    return status;
+}
+
+static void TEST_RecordAssertEqual(const AHR_Record_t *expected, const AHR_Record_t *actual, const char *template)
+{
+    TEST_ASSERT_EQUAL_UINT64(expected->submit_us, actual->submit_us);
+    TEST_ASSERT_EQUAL_UINT64(expected->latency_us, actual->latency_us);
+    TEST_ASSERT_EQUAL_UINT64(expected->server_us, actual->server_us);
+    TEST_ASSERT_EQUAL_INT(expected->method, actual->method);
+    TEST_ASSERT_EQUAL_STRING(template, actual->url_template);
+    TEST_ASSERT_EQUAL_UINT32(expected->nheaders, actual->nheaders);
+    TEST_ASSERT_EQUAL_UINT64(expected->header_bytes, actual->header_bytes);
+    TEST_ASSERT_EQUAL_UINT64(expected->body_bytes, actual->body_bytes);
+    TEST_ASSERT_EQUAL_UINT32(expected->status, actual->status);
+    TEST_ASSERT_EQUAL_UINT32(expected->error, actual->error);
+    TEST_ASSERT_EQUAL_UINT64(expected->response_header_bytes, actual->response_header_bytes);
+    TEST_ASSERT_EQUAL_UINT64(expected->response_bytes, actual->response_bytes);
+    TEST_ASSERT_EQUAL_UINT64(expected->decoded_bytes, actual->decoded_bytes);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_RecordUrlTemplate(void)
+{
+    static const char *const cases[][2] = {
+        {
+            "https://api.example.com/users/42/orders/9f1c0b7e-55aa-4d1e-9c3b-12f0e1d2c3b4?page=2&sort=asc",
+            "/users/{id}/orders/{id}?page=&sort="
+        },
+        {"http://127.0.0.1:8080", "/"},
+        {"http://127.0.0.1:8080?q=1", "/?q="},
+        {"http://127.0.0.1:8080/a#fragment/1", "/a"},
+        {"/items?flag&id=7#top", "/items?flag&id="},
+        {"/items?&&id=7&", "/items?id="},
+        {"items/7", "/items/{id}"},
+        {"/a//b/", "/a//b/"},
+        //
+        // Short Hex Words and Hex Words without a Digit are Names, long Hex Ids with a Digit are Ids.
+        //
+        {"/v1/cafe/0123456789abcdef", "/v1/cafe/{id}"},
+        {"/v1/0123456789abcde", "/v1/0123456789abcde"},
+        {"/deadbeefdeadbeefdeadbeef", "/deadbeefdeadbeefdeadbeef"},
+        {"/DEADBEEF-0000-1111-2222-333344445555", "/{id}"}
+    };
+    char buffer[AHR_RECORD_TEMPLATE_LEN]; // flawfinder: ignore
+    for(size_t i=0;i<sizeof(cases) / sizeof(cases[0]);++i)
+    {
+        const size_t len = AHR_RecordUrlTemplate(cases[i][0], buffer, sizeof(buffer));
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(cases[i][1], buffer, cases[i][0]);
+        TEST_ASSERT_EQUAL_size_t(strlen(cases[i][1]), len);
+    }
+    //
+    // Truncated Templates stay NULL-terminated.
+    //
+    char small[8]; // flawfinder: ignore
+    TEST_ASSERT_EQUAL_size_t(7, AHR_RecordUrlTemplate("http://host/users/42/orders", small, sizeof(small)));
+    TEST_ASSERT_EQUAL_STRING("/users/", small);
+    TEST_ASSERT_EQUAL_size_t(0, AHR_RecordUrlTemplate("/users", small, 1));
+    TEST_ASSERT_EQUAL_STRING("", small);
+
+    TEST_ASSERT_EQUAL_STRING("GET", AHR_RecordMethodName(AHR_RECORD_GET));
+    TEST_ASSERT_EQUAL_STRING("POST", AHR_RecordMethodName(AHR_RECORD_POST));
+    TEST_ASSERT_EQUAL_STRING("PUT", AHR_RecordMethodName(AHR_RECORD_PUT));
+    TEST_ASSERT_EQUAL_STRING("DELETE", AHR_RecordMethodName(AHR_RECORD_DELETE));
+    TEST_ASSERT_EQUAL_STRING("OTHER", AHR_RecordMethodName(AHR_RECORD_OTHER));
+    TEST_ASSERT_EQUAL_STRING("OTHER", AHR_RecordMethodName((AHR_RecordMethod_t)9));
+}
+
+void test_AHR_RecorderRoundTrip(void)
+{
+    TEST_ASSERT_NULL(AHR_CreateRecorder(NULL));
+    TEST_ASSERT_NULL(AHR_CreateRecorder("/nonexistent/ahr_test_record"));
+
+    char long_template[301]; // flawfinder: ignore
+    memset(long_template, 'a', sizeof(long_template) - 1U);
+    long_template[0] = '/';
+    long_template[sizeof(long_template) - 1U] = '\0';
+    //
+    // Submit Times go back and forth because Records are added in Completion Order.
+    //
+    const AHR_Record_t records[] = {
+        {
+            .submit_us = 1000, .latency_us = 1500, .server_us = 1200, .method = AHR_RECORD_GET,
+            .url_template = "/users/{id}", .nheaders = 2, .header_bytes = 60, .body_bytes = 0, .status = 200,
+            .error = 0, .response_header_bytes = 150, .response_bytes = 2048, .decoded_bytes = 4096
+        },
+        {
+            .submit_us = 900, .latency_us = 3000, .server_us = 2500, .method = AHR_RECORD_POST,
+            .url_template = "/items", .nheaders = 0, .header_bytes = 0, .body_bytes = 123456, .status = 201,
+            .error = 0, .response_header_bytes = 90, .response_bytes = 0, .decoded_bytes = 0
+        },
+        {
+            .submit_us = 3000, .latency_us = 100, .server_us = 0, .method = AHR_RECORD_GET,
+            .url_template = "/users/{id}", .nheaders = UINT32_MAX, .header_bytes = UINT64_MAX, .body_bytes = 0,
+            .status = 404, .error = 0, .response_header_bytes = 1, .response_bytes = UINT64_MAX - 1U,
+            .decoded_bytes = 1ULL << 63U
+        },
+        {
+            .submit_us = 3000, .latency_us = 30000, .server_us = 0, .method = AHR_RECORD_DELETE,
+            .url_template = "/users/{id}/orders?page=", .status = 0, .error = 28
+        },
+        {
+            .submit_us = 0, .latency_us = 5, .method = AHR_RECORD_OTHER, .url_template = long_template,
+            .status = 204
+        }
+    };
+    const size_t nrecords = sizeof(records) / sizeof(records[0]);
+    char expected_long[AHR_RECORD_TEMPLATE_LEN]; // flawfinder: ignore
+    memcpy(expected_long, long_template, sizeof(expected_long) - 1U); // flawfinder: ignore
+    expected_long[sizeof(expected_long) - 1U] = '\0';
+    const char *const templates[] = {
+        "/users/{id}", "/items", "/users/{id}", "/users/{id}/orders?page=", expected_long
+    };
+
+    char path[] = "/tmp/ahr_test_record_XXXXXX"; // flawfinder: ignore
+    TEST_RecordTempPath(path);
+    const uint64_t realtime_before = TEST_RecordNowNs(CLOCK_REALTIME);
+    const uint64_t monotonic_before = TEST_RecordNowNs(CLOCK_MONOTONIC);
+    AHR_Recorder_t *recorder = AHR_CreateRecorder(path);
+    TEST_ASSERT_NOT_NULL(recorder);
+    TEST_ASSERT_TRUE(AHR_RecorderStartNs(recorder) >= monotonic_before);
+    TEST_ASSERT_TRUE(AHR_RecorderStartNs(recorder) <= TEST_RecordNowNs(CLOCK_MONOTONIC));
+    const uint64_t realtime_after = TEST_RecordNowNs(CLOCK_REALTIME);
+    for(size_t i=0;i<nrecords;++i)
+    {
+        TEST_ASSERT_TRUE(AHR_RecorderAdd(recorder, &records[i]));
+    }
+    //
+    // Records are buffered until one completes a Second after the last Write.
+    //
+    TEST_ASSERT_EQUAL_UINT64(TEST_RECORD_HEADER_BYTES, TEST_RecordFileSize(path));
+    const AHR_Record_t late = {
+        .submit_us = 1500000, .latency_us = 2000, .server_us = 1800, .method = AHR_RECORD_PUT,
+        .url_template = "/items", .nheaders = 1, .header_bytes = 30, .body_bytes = 512, .status = 200,
+        .response_header_bytes = 120, .response_bytes = 64, .decoded_bytes = 64
+    };
+    TEST_ASSERT_TRUE(AHR_RecorderAdd(recorder, &late));
+    const uint64_t flushed = TEST_RecordFileSize(path);
+    TEST_ASSERT_TRUE(flushed > TEST_RECORD_HEADER_BYTES);
+    //
+    // A typical Request with a defined Template takes 15 to 25 Bytes.
+    //
+    const AHR_Record_t typical = {
+        .submit_us = 1502000, .latency_us = 1500, .server_us = 1200, .method = AHR_RECORD_GET,
+        .url_template = "/users/{id}", .nheaders = 2, .header_bytes = 60, .status = 200,
+        .response_header_bytes = 150, .response_bytes = 2048, .decoded_bytes = 2048
+    };
+    TEST_ASSERT_TRUE(AHR_RecorderAdd(recorder, &typical));
+    TEST_ASSERT_TRUE(AHR_RecorderFlush(recorder));
+    const uint64_t typical_bytes = TEST_RecordFileSize(path) - flushed;
+    TEST_ASSERT_TRUE(typical_bytes >= 15U && typical_bytes <= 25U);
+    AHR_DestroyRecorder(&recorder);
+    TEST_ASSERT_NULL(recorder);
+    AHR_DestroyRecorder(&recorder);
+
+    AHR_RecordReader_t reader = AHR_RecordReaderOpen(path);
+    TEST_ASSERT_NOT_NULL(reader);
+    TEST_ASSERT_TRUE(AHR_RecordReaderStartNs(reader) >= realtime_before);
+    TEST_ASSERT_TRUE(AHR_RecordReaderStartNs(reader) <= realtime_after);
+    AHR_Record_t record;
+    for(size_t i=0;i<nrecords;++i)
+    {
+        TEST_ASSERT_EQUAL_INT(AHR_RECORD_OK, AHR_RecordReaderNext(reader, &record));
+        TEST_RecordAssertEqual(&records[i], &record, templates[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_OK, AHR_RecordReaderNext(reader, &record));
+    TEST_RecordAssertEqual(&late, &record, "/items");
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_OK, AHR_RecordReaderNext(reader, &record));
+    TEST_RecordAssertEqual(&typical, &record, "/users/{id}");
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_END, AHR_RecordReaderNext(reader, &record));
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_END, AHR_RecordReaderNext(reader, &record));
+    AHR_RecordReaderClose(&reader);
+    TEST_ASSERT_NULL(reader);
+    AHR_RecordReaderClose(&reader);
+    unlink(path);
+}
+
+void test_AHR_RecorderTemplates(void)
+{
+    char path[] = "/tmp/ahr_test_record_XXXXXX"; // flawfinder: ignore
+    TEST_RecordTempPath(path);
+    AHR_Recorder_t *recorder = AHR_CreateRecorder(path);
+    TEST_ASSERT_NOT_NULL(recorder);
+    //
+    // More Templates than get a Number, then one which has a Number and one which is defined again.
+    //
+    static const size_t repeated[] = {0, TEST_RECORD_TEMPLATES - 1U};
+    const size_t nrecords = TEST_RECORD_TEMPLATES + sizeof(repeated) / sizeof(repeated[0]);
+    char template[32]; // flawfinder: ignore
+    for(size_t i=0;i<nrecords;++i)
+    {
+        const size_t t = i < TEST_RECORD_TEMPLATES ? i : repeated[i - TEST_RECORD_TEMPLATES];
+        snprintf(template, sizeof(template), "/t%zu", t);
+        const AHR_Record_t record = {
+            .submit_us = 10U * i, .latency_us = 100, .method = (AHR_RecordMethod_t)(i % 5U),
+            .url_template = template, .status = 200U + (uint32_t)(i % 100U), .response_bytes = i
+        };
+        TEST_ASSERT_TRUE(AHR_RecorderAdd(recorder, &record));
+    }
+    AHR_DestroyRecorder(&recorder);
+
+    AHR_RecordReader_t reader = AHR_RecordReaderOpen(path);
+    TEST_ASSERT_NOT_NULL(reader);
+    AHR_Record_t record;
+    for(size_t i=0;i<nrecords;++i)
+    {
+        const size_t t = i < TEST_RECORD_TEMPLATES ? i : repeated[i - TEST_RECORD_TEMPLATES];
+        snprintf(template, sizeof(template), "/t%zu", t);
+        TEST_ASSERT_EQUAL_INT(AHR_RECORD_OK, AHR_RecordReaderNext(reader, &record));
+        TEST_ASSERT_EQUAL_STRING(template, record.url_template);
+        TEST_ASSERT_EQUAL_UINT64(10U * i, record.submit_us);
+        TEST_ASSERT_EQUAL_INT(i % 5U, record.method);
+        TEST_ASSERT_EQUAL_UINT32(200U + (uint32_t)(i % 100U), record.status);
+        TEST_ASSERT_EQUAL_UINT64(i, record.response_bytes);
+    }
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_END, AHR_RecordReaderNext(reader, &record));
+    AHR_RecordReaderClose(&reader);
+    unlink(path);
+}
+
+void test_AHR_RecordReaderCorrupt(void)
+{
+    char path[] = "/tmp/ahr_test_record_XXXXXX"; // flawfinder: ignore
+    TEST_RecordTempPath(path);
+    //
+    // Empty, short, foreign and newer Files.
+    //
+    TEST_ASSERT_NULL(AHR_RecordReaderOpen("/nonexistent/ahr_test_record"));
+    TEST_ASSERT_NULL(AHR_RecordReaderOpen(path));
+    unsigned char header[TEST_RECORD_HEADER_BYTES] = {'A', 'H', 'R', 'R', AHR_RECORD_VERSION}; // flawfinder: ignore
+    TEST_RecordWriteFile(path, header, sizeof(header) - 1U);
+    TEST_ASSERT_NULL(AHR_RecordReaderOpen(path));
+    header[3] = 'X';
+    TEST_RecordWriteFile(path, header, sizeof(header));
+    TEST_ASSERT_NULL(AHR_RecordReaderOpen(path));
+    header[3] = 'R';
+    header[4] = AHR_RECORD_VERSION + 1U;
+    TEST_RecordWriteFile(path, header, sizeof(header));
+    TEST_ASSERT_NULL(AHR_RecordReaderOpen(path));
+    //
+    // A Header alone is an empty Recording.
+    //
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_END, TEST_RecordReadFirst(path, NULL, 0));
+    //
+    // Undefined Template, unknown Method, too long Template, Integer longer than 64 Bits.
+    //
+    static const unsigned char undefined[] = {0x01};
+    static const unsigned char method[] = {0x00, 0x01, '/', 0x05};
+    static const unsigned char length[] = {0x00, 0x80, 0x02};
+    static const unsigned char varint[] = {0x00, 0x01, '/', 0x00, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+                                           0x80, 0x80, 0x01};
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_CORRUPT, TEST_RecordReadFirst(path, undefined, sizeof(undefined)));
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_CORRUPT, TEST_RecordReadFirst(path, method, sizeof(method)));
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_CORRUPT, TEST_RecordReadFirst(path, length, sizeof(length)));
+    TEST_ASSERT_EQUAL_INT(AHR_RECORD_CORRUPT, TEST_RecordReadFirst(path, varint, sizeof(varint)));
+    //
+    // A Recording cut off anywhere reads up to its last complete Record, then ends or is corrupt.
+    //
+    AHR_Recorder_t *recorder = AHR_CreateRecorder(path);
+    TEST_ASSERT_NOT_NULL(recorder);
+    static const char *const templates[] = {"/users/{id}", "/users/{id}", "/items?page="};
+    uint64_t ends[sizeof(templates) / sizeof(templates[0])];
+    for(size_t i=0;i<sizeof(templates) / sizeof(templates[0]);++i)
+    {
+        const AHR_Record_t record = {
+            .submit_us = 1000U * i, .latency_us = 1500, .server_us = 1000, .method = AHR_RECORD_GET,
+            .url_template = templates[i], .nheaders = 1, .header_bytes = 20, .status = 200,
+            .response_header_bytes = 100, .response_bytes = 300, .decoded_bytes = 300
+        };
+        TEST_ASSERT_TRUE(AHR_RecorderAdd(recorder, &record));
+        TEST_ASSERT_TRUE(AHR_RecorderFlush(recorder));
+        ends[i] = TEST_RecordFileSize(path);
+    }
+    AHR_DestroyRecorder(&recorder);
+    size_t nbytes = 0;
+    unsigned char *data = TEST_RecordReadFile(path, &nbytes);
+    TEST_ASSERT_EQUAL_UINT64(ends[2], nbytes);
+    for(size_t cut=TEST_RECORD_HEADER_BYTES;cut<nbytes;++cut)
+    {
+        TEST_RecordWriteFile(path, data, cut);
+        AHR_RecordReader_t reader = AHR_RecordReaderOpen(path);
+        TEST_ASSERT_NOT_NULL(reader);
+        size_t complete = 0;
+        bool boundary = TEST_RECORD_HEADER_BYTES == cut;
+        for(size_t i=0;i<sizeof(ends) / sizeof(ends[0]);++i)
+        {
+            complete += ends[i] <= cut ? 1U : 0U;
+            boundary = boundary || ends[i] == cut;
+        }
+        AHR_Record_t record;
+        for(size_t i=0;i<complete;++i)
+        {
+            TEST_ASSERT_EQUAL_INT(AHR_RECORD_OK, AHR_RecordReaderNext(reader, &record));
+            TEST_ASSERT_EQUAL_STRING(templates[i], record.url_template);
+        }
+        TEST_ASSERT_EQUAL_INT(boundary ? AHR_RECORD_END : AHR_RECORD_CORRUPT, AHR_RecordReaderNext(reader, &record));
+        AHR_RecordReaderClose(&reader);
+    }
+    free(data);
+    unlink(path);
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
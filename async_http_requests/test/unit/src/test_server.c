@@ -0,0 +1,558 @@
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+#include <test_server.h>
+
+#include <zlib.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Connections served at the same Time, further Connections are closed right away.
+///
+#define TEST_SERVER_MAX_CONNECTIONS 32U
+#define TEST_SERVER_MAX_HEAD 65536U
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Received Bytes of one Connection, "pos" is the first unconsumed one.
+///
+typedef struct
+{
+    int fd;
+    char *data;
+    size_t pos;
+    size_t len;
+    size_t capacity;
+} TEST_Reader_t;
+
+typedef struct
+{
+    char *data;
+    size_t nbytes;
+    size_t capacity;
+} TEST_Buffer_t;
+
+typedef struct
+{
+    struct TEST_Server *server;
+    int fd;
+    bool used;
+    bool joinable;
+    pthread_t thread;
+} TEST_Connection_t;
+
+struct TEST_Server
+{
+    int fd;
+    uint16_t port;
+    atomic_bool stop;
+    atomic_uint_fast64_t requests;
+    atomic_uint_fast64_t connections_accepted;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    TEST_Connection_t connections[TEST_SERVER_MAX_CONNECTIONS];
+};
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void* TEST_ServerMain(void *arg);
+static void* TEST_ConnectionMain(void *arg);
+///
+/// \brief  Answer one Request of "reader".
+/// \returns    false if the Connection is closed or broken.
+///
+static bool TEST_ServeRequest(struct TEST_Server *server, TEST_Reader_t *reader);
+///
+/// \brief  Receive until at least "nbytes" unconsumed Bytes are buffered.
+///
+static bool TEST_ReaderEnsure(TEST_Reader_t *reader, size_t nbytes);
+///
+/// \brief  Receive until "pattern" is buffered, "offset" is its Position relative to "pos".
+///
+static bool TEST_ReaderFind(TEST_Reader_t *reader, const char *pattern, size_t *offset);
+static bool TEST_BufferAppend(TEST_Buffer_t *buffer, const char *data, size_t nbytes);
+///
+/// \brief  Value of Header "name" within "head", copied into "value".
+///
+static bool TEST_HeadValue(const char *head, const char *name, char *value, size_t nbytes);
+static bool TEST_SendAll(int fd, const char *data, size_t nbytes);
+///
+/// \brief  gzip "nbytes" Bytes of "data" into a new Buffer.
+///
+static bool TEST_Gzip(const char *data, size_t nbytes, TEST_Buffer_t *out);
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+TEST_Server_t TEST_ServerStart(void)
+{
+    struct TEST_Server *server = calloc(1, sizeof(struct TEST_Server));
+    if(!server)
+    {
+        return NULL;
+    }
+    atomic_init(&server->stop, false);
+    atomic_init(&server->requests, 0U);
+    atomic_init(&server->connections_accepted, 0U);
+    pthread_mutex_init(&server->mutex, NULL);
+
+    server->fd = socket(AF_INET, SOCK_STREAM, 0);
+    if(server->fd < 0)
+    {
+        goto on_error;
+    }
+    const int one = 1;
+    setsockopt(server->fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = 0};
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if(
+        0 != bind(server->fd, (struct sockaddr*)&address, sizeof(address))
+        || 0 != listen(server->fd, 64)
+        || 0 != getsockname(server->fd, (struct sockaddr*)&address, &length)
+    )
+    {
+        goto on_error;
+    }
+    server->port = ntohs(address.sin_port);
+    if(0 != pthread_create(&server->thread, NULL, TEST_ServerMain, server))
+    {
+        goto on_error;
+    }
+    return server;
+
+    on_error:
+    if(server->fd >= 0)
+    {
+        close(server->fd);
+    }
+    pthread_mutex_destroy(&server->mutex);
+    free(server);
+    return NULL;
+}
+
+uint16_t TEST_ServerPort(const TEST_Server_t server)
+{
+    return server->port;
+}
+
+uint64_t TEST_ServerRequests(const TEST_Server_t server)
+{
+    return atomic_load(&server->requests);
+}
+
+uint64_t TEST_ServerConnections(const TEST_Server_t server)
+{
+    return atomic_load(&server->connections_accepted);
+}
+
+void TEST_ServerStop(TEST_Server_t *server)
+{
+    if(!*server)
+    {
+        return;
+    }
+    atomic_store(&(*server)->stop, true);
+    pthread_join((*server)->thread, NULL);
+    close((*server)->fd);
+
+    pthread_mutex_lock(&(*server)->mutex);
+    for(size_t i=0;i<TEST_SERVER_MAX_CONNECTIONS;++i)
+    {
+        if((*server)->connections[i].used)
+        {
+            shutdown((*server)->connections[i].fd, SHUT_RDWR);
+        }
+    }
+    pthread_mutex_unlock(&(*server)->mutex);
+    //
+    // The Accept Thread is gone, no Slot is taken anymore.
+    //
+    for(size_t i=0;i<TEST_SERVER_MAX_CONNECTIONS;++i)
+    {
+        if((*server)->connections[i].joinable)
+        {
+            pthread_join((*server)->connections[i].thread, NULL);
+        }
+    }
+    pthread_mutex_destroy(&(*server)->mutex);
+    free(*server);
+    *server = NULL;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+static void* TEST_ServerMain(void *arg)
+{
+    struct TEST_Server *server = arg;
+    while(!atomic_load(&server->stop))
+    {
+        struct pollfd pfd = {.fd = server->fd, .events = POLLIN, .revents = 0};
+        if(poll(&pfd, 1, 20) <= 0)
+        {
+            continue;
+        }
+        const int fd = accept(server->fd, NULL, NULL);
+        if(fd < 0)
+        {
+            continue;
+        }
+        atomic_fetch_add(&server->connections_accepted, 1U);
+        TEST_Connection_t *connection = NULL;
+        pthread_mutex_lock(&server->mutex);
+        for(size_t i=0;i<TEST_SERVER_MAX_CONNECTIONS && !connection;++i)
+        {
+            if(!server->connections[i].used)
+            {
+                connection = &server->connections[i];
+                if(connection->joinable)
+                {
+                    pthread_join(connection->thread, NULL);
+                    connection->joinable = false;
+                }
+                connection->server = server;
+                connection->fd = fd;
+                connection->used = true;
+            }
+        }
+        pthread_mutex_unlock(&server->mutex);
+        if(!connection)
+        {
+            close(fd);
+            continue;
+        }
+        if(0 != pthread_create(&connection->thread, NULL, TEST_ConnectionMain, connection))
+        {
+            pthread_mutex_lock(&server->mutex);
+            connection->used = false;
+            pthread_mutex_unlock(&server->mutex);
+            close(fd);
+            continue;
+        }
+        connection->joinable = true;
+    }
+    return NULL;
+}
+
+static void* TEST_ConnectionMain(void *arg)
+{
+    TEST_Connection_t *connection = arg;
+    TEST_Reader_t reader = {.fd = connection->fd, .data = NULL, .pos = 0, .len = 0, .capacity = 0};
+    while(TEST_ServeRequest(connection->server, &reader))
+    {
+    }
+    free(reader.data);
+    pthread_mutex_lock(&connection->server->mutex);
+    close(connection->fd);
+    connection->used = false;
+    pthread_mutex_unlock(&connection->server->mutex);
+    return NULL;
+}
+
+static bool TEST_ServeRequest(struct TEST_Server *server, TEST_Reader_t *reader)
+{
+    size_t head_len = 0;
+    if(!TEST_ReaderFind(reader, "\r\n\r\n", &head_len) || head_len >= TEST_SERVER_MAX_HEAD)
+    {
+        return false;
+    }
+    char head[TEST_SERVER_MAX_HEAD]; // flawfinder: ignore
+    memcpy(head, reader->data + reader->pos, head_len + 2U); // flawfinder: ignore
+    head[head_len + 2U] = '\0';
+    reader->pos += head_len + 4U;
+
+    char method[16]; // flawfinder: ignore
+    char path[1024]; // flawfinder: ignore
+    if(2 != sscanf(head, "%15s %1023s", method, path))
+    {
+        return false;
+    }
+    char value[256]; // flawfinder: ignore
+    if(TEST_HeadValue(head, "Expect", value, sizeof(value)) && 0 == strcasecmp(value, "100-continue"))
+    {
+        static const char proceed[] = "HTTP/1.1 100 Continue\r\n\r\n";
+        if(!TEST_SendAll(reader->fd, proceed, sizeof(proceed) - 1U))
+        {
+            return false;
+        }
+    }
+    //
+    // Read the Body, either with a Content-Length or chunked.
+    //
+    TEST_Buffer_t body = {.data = NULL, .nbytes = 0, .capacity = 0};
+    TEST_Buffer_t gzipped = {.data = NULL, .nbytes = 0, .capacity = 0};
+    bool ok = false;
+    const bool chunked = TEST_HeadValue(head, "Transfer-Encoding", value, sizeof(value))
+        && NULL != strstr(value, "chunked");
+    if(chunked)
+    {
+        for(;;)
+        {
+            size_t line = 0;
+            if(!TEST_ReaderFind(reader, "\r\n", &line))
+            {
+                goto end;
+            }
+            const size_t nbytes = strtoul(reader->data + reader->pos, NULL, 16);
+            reader->pos += line + 2U;
+            if(0 == nbytes)
+            {
+                size_t trailer = 0;
+                do
+                {
+                    if(!TEST_ReaderFind(reader, "\r\n", &trailer))
+                    {
+                        goto end;
+                    }
+                    reader->pos += trailer + 2U;
+                } while(trailer > 0);
+                break;
+            }
+            if(!TEST_ReaderEnsure(reader, nbytes + 2U) || !TEST_BufferAppend(&body, reader->data + reader->pos, nbytes))
+            {
+                goto end;
+            }
+            reader->pos += nbytes + 2U;
+        }
+    }
+    else if(TEST_HeadValue(head, "Content-Length", value, sizeof(value)))
+    {
+        const size_t nbytes = strtoul(value, NULL, 10);
+        if(!TEST_ReaderEnsure(reader, nbytes) || !TEST_BufferAppend(&body, reader->data + reader->pos, nbytes))
+        {
+            goto end;
+        }
+        reader->pos += nbytes;
+    }
+    //
+    // Answer with the Body as received.
+    //
+    char encoding[64] = "-"; // flawfinder: ignore
+    TEST_HeadValue(head, "Content-Encoding", encoding, sizeof(encoding));
+    char echo[300] = ""; // flawfinder: ignore
+    if(TEST_HeadValue(head, "X-Echo", value, sizeof(value)))
+    {
+        snprintf(echo, sizeof(echo), "X-Echo: %s\r\n", value);
+    }
+    const char *data = body.data;
+    size_t nbytes = body.nbytes;
+    const bool gzip = 0 == strncmp(path, "/gzip", 5)
+        && TEST_HeadValue(head, "Accept-Encoding", value, sizeof(value))
+        && NULL != strstr(value, "gzip");
+    if(gzip)
+    {
+        if(!TEST_Gzip(body.data ? body.data : "", body.nbytes, &gzipped))
+        {
+            goto end;
+        }
+        data = gzipped.data;
+        nbytes = gzipped.nbytes;
+    }
+    char response[2048]; // flawfinder: ignore
+    const int length = snprintf(
+        response,
+        sizeof(response),
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: %zu\r\n"
+        "Content-Type: application/octet-stream\r\n"
+        "%s"
+        "X-Method: %s\r\n"
+        "X-Path: %s\r\n"
+        "X-Request-Encoding: %s\r\n"
+        "X-Request-Chunked: %d\r\n"
+        "%s"
+        "ETag: \"abc\"\r\n"
+        "\r\n",
+        nbytes,
+        gzip ? "Content-Encoding: gzip\r\n" : "",
+        method,
+        path,
+        encoding,
+        chunked ? 1 : 0,
+        echo
+    );
+    if(length < 0 || (size_t)length >= sizeof(response))
+    {
+        goto end;
+    }
+    atomic_fetch_add(&server->requests, 1U);
+    ok = TEST_SendAll(reader->fd, response, (size_t)length) && (0 == nbytes || TEST_SendAll(reader->fd, data, nbytes));
+
+    end:
+    free(body.data);
+    free(gzipped.data);
+    return ok;
+}
+
+static bool TEST_ReaderEnsure(TEST_Reader_t *reader, size_t nbytes)
+{
+    while(reader->len - reader->pos < nbytes)
+    {
+        if(reader->pos > 0)
+        {
+            memmove(reader->data, reader->data + reader->pos, reader->len - reader->pos);
+            reader->len -= reader->pos;
+            reader->pos = 0;
+        }
+        if(reader->capacity - reader->len < 4096U)
+        {
+            const size_t capacity = reader->capacity > 0 ? reader->capacity * 2U : 16384U;
+            char *data = realloc(reader->data, capacity);
+            if(!data)
+            {
+                return false;
+            }
+            reader->data = data;
+            reader->capacity = capacity;
+        }
+        const ssize_t n = recv(reader->fd, reader->data + reader->len, reader->capacity - reader->len, 0);
+        if(n <= 0)
+        {
+            return false;
+        }
+        reader->len += (size_t)n;
+    }
+    return true;
+}
+
+static bool TEST_ReaderFind(TEST_Reader_t *reader, const char *pattern, size_t *offset)
+{
+    const size_t n = strlen(pattern);
+    size_t searched = 0;
+    for(;;)
+    {
+        const size_t available = reader->len - reader->pos;
+        for(size_t i=searched;i + n <= available;++i)
+        {
+            if(0 == memcmp(reader->data + reader->pos + i, pattern, n))
+            {
+                *offset = i;
+                return true;
+            }
+        }
+        searched = available >= n ? available - n + 1U : 0U;
+        if(available > TEST_SERVER_MAX_HEAD || !TEST_ReaderEnsure(reader, available + 1U))
+        {
+            return false;
+        }
+    }
+}
+
+static bool TEST_BufferAppend(TEST_Buffer_t *buffer, const char *data, size_t nbytes)
+{
+    if(buffer->nbytes + nbytes > buffer->capacity)
+    {
+        size_t capacity = buffer->capacity > 0 ? buffer->capacity : 4096U;
+        while(capacity < buffer->nbytes + nbytes)
+        {
+            capacity *= 2U;
+        }
+        char *grown = realloc(buffer->data, capacity);
+        if(!grown)
+        {
+            return false;
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->nbytes, data, nbytes); // flawfinder: ignore
+    buffer->nbytes += nbytes;
+    return true;
+}
+
+static bool TEST_HeadValue(const char *head, const char *name, char *value, size_t nbytes)
+{
+    const size_t n = strlen(name);
+    for(const char *line = strstr(head, "\r\n");line && line[2];line = strstr(line + 2, "\r\n"))
+    {
+        const char *field = line + 2;
+        if(0 == strncasecmp(field, name, n) && ':' == field[n])
+        {
+            const char *begin = field + n + 1;
+            while(' ' == *begin)
+            {
+                ++begin;
+            }
+            const char *end = strstr(begin, "\r\n");
+            const size_t length = end ? (size_t)(end - begin) : strlen(begin);
+            if(length >= nbytes)
+            {
+                return false;
+            }
+            memcpy(value, begin, length); // flawfinder: ignore
+            value[length] = '\0';
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool TEST_SendAll(int fd, const char *data, size_t nbytes)
+{
+    while(nbytes > 0)
+    {
+        const ssize_t n = send(fd, data, nbytes, MSG_NOSIGNAL);
+        if(n <= 0)
+        {
+            return false;
+        }
+        data += n;
+        nbytes -= (size_t)n;
+    }
+    return true;
+}
+
+static bool TEST_Gzip(const char *data, size_t nbytes, TEST_Buffer_t *out)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if(Z_OK != deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY))
+    {
+        return false;
+    }
+    const size_t capacity = deflateBound(&stream, (uLong)nbytes);
+    out->data = malloc(capacity);
+    out->capacity = capacity;
+    if(!out->data)
+    {
+        deflateEnd(&stream);
+        return false;
+    }
+    stream.next_in = (Bytef*)data;
+    stream.avail_in = (uInt)nbytes;
+    stream.next_out = (Bytef*)out->data;
+    stream.avail_out = (uInt)capacity;
+    const int status = deflate(&stream, Z_FINISH);
+    out->nbytes = capacity - stream.avail_out;
+    deflateEnd(&stream);
+    return Z_STREAM_END == status;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
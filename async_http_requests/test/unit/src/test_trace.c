@@ -0,0 +1,217 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <test_trace.h>
+#include <async_http_requests/ahr_json.h>
+#include <async_http_requests/private/ahr_json_index.h>
+#include <async_http_requests/private/ahr_trace.h>
+
+#include "unity.h"
+#include "unity_internals.h"
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+typedef struct
+{
+    AHR_Tracer_t *tracer;
+    uint64_t id;
+} TEST_TraceThread_t;
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+///
+/// \brief  Dump "tracer" into a temporary File and read it back.
+/// \returns    The Dump, to be freed by the Caller.
+///
+static char* TEST_TraceDump(AHR_Tracer_t *tracer, size_t *nbytes)
+{
+    char path[] = "/tmp/ahr_test_trace_XXXXXX"; // flawfinder: ignore
+    const int fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    unlink(path);
+    TEST_ASSERT_TRUE(AHR_TraceDump(tracer, fd));
+    const off_t size = lseek(fd, 0, SEEK_END);
+    TEST_ASSERT_TRUE(size > 0);
+    char *dump = malloc((size_t)size + 1U);
+    TEST_ASSERT_NOT_NULL(dump);
+    TEST_ASSERT_EQUAL_INT64(size, pread(fd, dump, (size_t)size, 0));
+    dump[size] = '\0';
+    close(fd);
+    *nbytes = (size_t)size;
+    return dump;
+}
+
+static bool TEST_TraceStringEquals(const AHR_JsonIndex_t *index, size_t object, const char *key, const char *value)
+{
+    const char *data = NULL;
+    size_t nbytes = 0;
+    return AHR_JsonString(index, AHR_JsonObjectFind(index, object, key), &data, &nbytes)
+        && strlen(value) == nbytes
+        && 0 == memcmp(value, data, nbytes);
+}
+
+static void* TEST_TraceThreadMain(void *arg)
+{
+    TEST_TraceThread_t *thread = arg;
+    AHR_TraceAsyncEnd(thread->tracer, "async", thread->id, 7, AHR_TraceNow());
+    return NULL;
+}
+
+//
+// --------------------------------------------------------------------------------------------------------------------
+//
+
+void test_AHR_TraceDump(void)
+{
+    AHR_Tracer_t *tracer = AHR_CreateTracer(64);
+    TEST_ASSERT_NOT_NULL(tracer);
+    AHR_TraceNameThread(tracer, "test main");
+    //
+    // Nested Slices on this Thread, an asynchronous Slice which ends on another Thread.
+    //
+    TEST_TraceThread_t thread = {.tracer = tracer, .id = AHR_TraceNextId(tracer)};
+    TEST_ASSERT_NOT_EQUAL(thread.id, AHR_TraceNextId(tracer));
+    AHR_TraceAsyncBegin(tracer, "async", thread.id, 7, AHR_TraceNow());
+    AHR_TraceBegin(tracer, "outer", AHR_TRACE_NO_OBJECT);
+    AHR_TraceBegin(tracer, "inner", 3);
+    AHR_TraceEnd(tracer, "inner", 3);
+    AHR_TraceEnd(tracer, "outer", AHR_TRACE_NO_OBJECT);
+    pthread_t handle;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&handle, NULL, TEST_TraceThreadMain, &thread));
+    pthread_join(handle, NULL);
+
+    size_t nbytes = 0;
+    char *dump = TEST_TraceDump(tracer, &nbytes);
+    AHR_JsonIndexer_t indexer = AHR_CreateJsonIndexer();
+    AHR_JsonIndex_t index;
+    TEST_ASSERT_TRUE(AHR_JsonIndexerFinish(&indexer, dump, nbytes));
+    TEST_ASSERT_TRUE(AHR_JsonIndexerView(&indexer, dump, nbytes, &index));
+    const size_t other = AHR_JsonObjectFind(&index, 0, "otherData");
+    TEST_ASSERT_TRUE(TEST_TraceStringEquals(&index, other, "dropped_events", "0"));
+    //
+    // Process Name, Thread Name, 5 Events of this Thread, 1 of the other one. Threads are written
+    // one after the other, in no particular Order.
+    //
+    const size_t events = AHR_JsonObjectFind(&index, 0, "traceEvents");
+    TEST_ASSERT_EQUAL_UINT32(8, index.tokens[events].count);
+    TEST_ASSERT_TRUE(TEST_TraceStringEquals(&index, AHR_JsonArrayAt(&index, events, 0), "ph", "M"));
+    int64_t main_tid = -1;
+    for(size_t i=1;i<8;++i)
+    {
+        const size_t event = AHR_JsonArrayAt(&index, events, i);
+        if(TEST_TraceStringEquals(&index, event, "name", "thread_name"))
+        {
+            const size_t args = AHR_JsonObjectFind(&index, event, "args");
+            TEST_ASSERT_TRUE(TEST_TraceStringEquals(&index, args, "name", "test main"));
+            TEST_ASSERT_TRUE(AHR_JsonInt64(&index, AHR_JsonObjectFind(&index, event, "tid"), &main_tid));
+        }
+    }
+    TEST_ASSERT_GREATER_THAN_INT64(0, main_tid);
+
+    static const char *const names[] = {"async", "outer", "inner", "inner", "outer", "async"};
+    static const char *const phases[] = {"b", "B", "B", "E", "E", "e"};
+    size_t nmain = 0;
+    double last_ts = 0.0;
+    char id[32]; // flawfinder: ignore
+    snprintf(id, sizeof(id), "0x%llx", (unsigned long long)thread.id);
+    for(size_t i=1;i<8;++i)
+    {
+        const size_t event = AHR_JsonArrayAt(&index, events, i);
+        if(TEST_TraceStringEquals(&index, event, "ph", "M"))
+        {
+            continue;
+        }
+        double ts = 0.0;
+        int64_t tid = 0;
+        TEST_ASSERT_TRUE(AHR_JsonDouble(&index, AHR_JsonObjectFind(&index, event, "ts"), &ts));
+        TEST_ASSERT_TRUE(AHR_JsonInt64(&index, AHR_JsonObjectFind(&index, event, "tid"), &tid));
+        //
+        // The Events of a Thread keep their Order, the other Thread only ended the asynchronous Slice.
+        //
+        const size_t n = main_tid == tid ? nmain++ : 5U;
+        TEST_ASSERT_LESS_THAN_size_t(6U, n);
+        TEST_ASSERT_TRUE(TEST_TraceStringEquals(&index, event, "name", names[n]));
+        TEST_ASSERT_TRUE(TEST_TraceStringEquals(&index, event, "ph", phases[n]));
+        if(main_tid == tid)
+        {
+            TEST_ASSERT_TRUE(ts >= last_ts);
+            last_ts = ts;
+        }
+        const bool async = 'b' == phases[n][0] || 'e' == phases[n][0];
+        TEST_ASSERT_EQUAL(async, TEST_TraceStringEquals(&index, event, "id", id));
+        const size_t args = AHR_JsonObjectFind(&index, event, "args");
+        TEST_ASSERT_EQUAL('o' != names[n][0], AHR_JSON_NPOS != args);
+        int64_t object = 0;
+        const size_t value = AHR_JsonObjectFind(&index, args, "object");
+        TEST_ASSERT_TRUE('o' == names[n][0] || AHR_JsonInt64(&index, value, &object));
+        TEST_ASSERT_EQUAL_INT64('i' == names[n][0] ? 3 : ('a' == names[n][0] ? 7 : 0), object);
+    }
+    TEST_ASSERT_EQUAL_size_t(5, nmain);
+    free(dump);
+    //
+    // The Events were consumed, the Names stay.
+    //
+    dump = TEST_TraceDump(tracer, &nbytes);
+    AHR_JsonIndexerReset(&indexer);
+    TEST_ASSERT_TRUE(AHR_JsonIndexerFinish(&indexer, dump, nbytes));
+    TEST_ASSERT_TRUE(AHR_JsonIndexerView(&indexer, dump, nbytes, &index));
+    TEST_ASSERT_EQUAL_UINT32(2, index.tokens[AHR_JsonObjectFind(&index, 0, "traceEvents")].count);
+    free(dump);
+
+    AHR_DestroyJsonIndexer(&indexer);
+    AHR_DestroyTracer(&tracer);
+    TEST_ASSERT_NULL(tracer);
+}
+
+void test_AHR_TraceDropped(void)
+{
+    TEST_ASSERT_NULL(AHR_CreateTracer(0));
+    //
+    // Rounded up to 4 Events.
+    //
+    AHR_Tracer_t *tracer = AHR_CreateTracer(3);
+    TEST_ASSERT_NOT_NULL(tracer);
+    for(uint32_t i=0;i<10;++i)
+    {
+        AHR_TraceBegin(tracer, "slice", i);
+    }
+    TEST_ASSERT_EQUAL_size_t(6, AHR_TraceDropped(tracer));
+    size_t nbytes = 0;
+    char *dump = TEST_TraceDump(tracer, &nbytes);
+    TEST_ASSERT_NOT_NULL(strstr(dump, "\"dropped_events\":\"6\""));
+    TEST_ASSERT_NOT_NULL(strstr(dump, "\"args\":{\"object\":3}"));
+    TEST_ASSERT_NULL(strstr(dump, "\"args\":{\"object\":4}"));
+    free(dump);
+    //
+    // The Ring has Room again after the Dump.
+    //
+    AHR_TraceEnd(tracer, "slice", 0);
+    TEST_ASSERT_EQUAL_size_t(6, AHR_TraceDropped(tracer));
+    //
+    // Ticks convert from Microseconds at the calibrated Rate.
+    //
+    const struct timespec pause = {.tv_sec = 0, .tv_nsec = 20000000};
+    const uint64_t before = AHR_TraceNow();
+    nanosleep(&pause, NULL);
+    const uint64_t elapsed = AHR_TraceNow() - before;
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT64(AHR_TraceTicksFromUs(tracer, 18000), elapsed);
+    TEST_ASSERT_LESS_THAN_UINT64(AHR_TraceTicksFromUs(tracer, 2000000), elapsed);
+    AHR_DestroyTracer(&tracer);
+    //
+    // Without a Tracer nothing is recorded.
+    //
+    AHR_TraceNameThread(NULL, "none");
+    AHR_TraceBegin(NULL, "none", 0);
+    AHR_TraceAsyncEnd(NULL, "none", 1, 0, AHR_TraceNow());
+    TEST_ASSERT_EQUAL_UINT64(0, AHR_TraceNextId(NULL));
+    TEST_ASSERT_EQUAL_size_t(0, AHR_TraceDropped(NULL));
+    TEST_ASSERT_FALSE(AHR_TraceDump(NULL, STDOUT_FILENO));
+}
@@ -0,0 +1,82 @@
+#include <unity.h>
+#include <test_header_block.h>
+#include <test_processor.h>
+#include <test_file.h>
+#include <test_arena.h>
+#include <test_buffer_pool.h>
+#include <test_header_list.h>
+#include <test_header_parser.h>
+#include <test_compression.h>
+#include <test_json.h>
+#include <test_logging.h>
+#include <test_metrics.h>
+#include <test_trace.h>
+#include <test_record.h>
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_AHR_HeaderBlockAppend);
+    RUN_TEST(test_AHR_HeaderBlockReset);
+    RUN_TEST(test_AHR_HeaderBlockLimits);
+    RUN_TEST(test_AHR_HeaderBlockAssign);
+    RUN_TEST(test_AHR_ProcessorResponseHeaderUnknownObject);
+    RUN_TEST(test_AHR_ProcessorBorrowedBody);
+    RUN_TEST(test_AHR_ProcessorBorrowedBodyReconfigured);
+    RUN_TEST(test_AHR_ProcessorCallbackResubmit);
+    RUN_TEST(test_AHR_ProcessorStreamedResponse);
+    RUN_TEST(test_AHR_ProcessorBodyProvider);
+    RUN_TEST(test_AHR_FileWriterWrite);
+    RUN_TEST(test_AHR_ProcessorFileSink);
+    RUN_TEST(test_AHR_FileReaderRange);
+    RUN_TEST(test_AHR_FileReaderPath);
+    RUN_TEST(test_AHR_ProcessorFileSource);
+    RUN_TEST(test_AHR_ArenaAlloc);
+    RUN_TEST(test_AHR_ArenaFlags);
+    RUN_TEST(test_AHR_ProcessorFootprint);
+    RUN_TEST(test_AHR_BufferPoolSizeClasses);
+    RUN_TEST(test_AHR_BufferPoolReuse);
+    RUN_TEST(test_AHR_BufferPoolLearn);
+    RUN_TEST(test_AHR_HeaderListIntern);
+    RUN_TEST(test_AHR_HeaderListIdle);
+    RUN_TEST(test_AHR_ProcessorRequestHeaders);
+    RUN_TEST(test_AHR_ProcessorBaseUrl);
+    RUN_TEST(test_AHR_HeaderParseLine);
+    RUN_TEST(test_AHR_HeaderScan);
+    RUN_TEST(test_AHR_HeaderBlockFind);
+    RUN_TEST(test_AHR_ProcessorResponseHeaderWhitelist);
+    RUN_TEST(test_AHR_ProcessorContentDecoding);
+    RUN_TEST(test_AHR_CompressRoundTrip);
+    RUN_TEST(test_AHR_CompressorStream);
+    RUN_TEST(test_AHR_CompressDictionary);
+    RUN_TEST(test_AHR_ProcessorContentEncoding);
+    RUN_TEST(test_AHR_JsonIndexNavigate);
+    RUN_TEST(test_AHR_JsonIndexChunked);
+    RUN_TEST(test_AHR_JsonIndexInvalid);
+    RUN_TEST(test_AHR_ProcessorJsonIndex);
+    RUN_TEST(test_AHR_LoggerFormat);
+    RUN_TEST(test_AHR_LoggerDropped);
+    RUN_TEST(test_AHR_LoggerThreads);
+    RUN_TEST(test_AHR_LoggerDrain);
+    RUN_TEST(test_AHR_ProcessorRequestTimings);
+    RUN_TEST(test_AHR_MetricsSnapshot);
+    RUN_TEST(test_AHR_MetricsQuantiles);
+    RUN_TEST(test_AHR_MetricsPrometheus);
+    RUN_TEST(test_AHR_ProcessorMetrics);
+    RUN_TEST(test_AHR_TraceDump);
+    RUN_TEST(test_AHR_TraceDropped);
+    RUN_TEST(test_AHR_ProcessorDumpTrace);
+    RUN_TEST(test_AHR_RecordUrlTemplate);
+    RUN_TEST(test_AHR_RecorderRoundTrip);
+    RUN_TEST(test_AHR_RecorderTemplates);
+    RUN_TEST(test_AHR_RecordReaderCorrupt);
+    RUN_TEST(test_AHR_ProcessorRecord);
+    RUN_TEST(test_AHR_ProcessorTimeouts);
+    return UNITY_END();
+}
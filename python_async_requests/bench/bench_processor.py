@@ -0,0 +1,423 @@
+#!python
+"""Throughput and Latency of the Python Binding against aiohttp and httpx.
+
+A local asyncio HTTP/1.1 Server answers every Request with the same Body. It runs in its own Processes,
+so its CPU Time does not show up in the Client. Each Client is run closed-loop: "concurrency" Requests
+are in Flight at all Times and each finished Request is replaced by a new one.
+
+    pyahr    - AHR_HttpRequestProcessor, one Processor per 25 Requests in Flight. Responses are
+               handed from the Event Handler to the main Thread, which submits the next Request.
+    aiohttp  - aiohttp.ClientSession, one Connection per Request in Flight.
+    httpx    - httpx.AsyncClient, likewise.
+
+aiohttp and httpx are skipped if they are not installed. All Clients decode the Body to str.
+
+Reported per Client and Concurrency: Requests per Second, Latency Percentiles (Submission to Event Handler,
+respectively to the decoded Body) and CPU Time per Request, split into the main Python Thread and all other
+Threads of the Process. For pyahr the other Threads are the libahr Threads, including the Python Callbacks
+they run through ctypes. The Cost of the ctypes Boundary and of AHR_Utf8Decoder is measured on its own.
+
+Results are written to stdout as JSON.
+
+Example:
+    LIB_AHR_PATH=path/to/libahr.so python bench/bench_processor.py --concurrency 1,8,32 --requests 5000
+"""
+
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#
+
+from argparse import ArgumentParser, Namespace
+from asyncio import IncompleteReadError, LimitOverrunError, StreamReader, StreamWriter, gather, run, start_server
+from json import dumps
+from math import ceil
+from multiprocessing import get_context
+from platform import python_version
+from queue import SimpleQueue
+from socket import AF_INET, SO_REUSEADDR, SOCK_STREAM, SOL_SOCKET, socket
+from sys import path as sys_path, stderr
+from time import perf_counter, process_time, sleep, thread_time
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+sys_path.insert(0, f'{__file__.rsplit("/", 2)[0]}/src')
+
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#
+
+AHR_BENCH_MAX_OBJECTS: int = 25
+"""Most Requestobjects a Processor manages, higher Concurrency is spread over several Processors."""
+
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#
+
+
+def make_body(nbytes: int) -> bytes:
+    """JSON-like Body of "nbytes" Bytes with multibyte UTF-8 Characters, so decoding does real Work."""
+    record: bytes = '{"name":"Zoë","bio":"naïve café, größer","tags":["α","β"]},'.encode()
+    body: bytes = (record * (nbytes // len(record) + 1))[0:nbytes]
+    # Do not end inside a multibyte Character.
+    return body.decode('utf-8', 'ignore').encode()
+
+
+async def handle_connection(reader: StreamReader, writer: StreamWriter, response: bytes) -> None:
+    """Answer all Requests of a Connection, Request Bodies are read and dropped."""
+    try:
+        while True:
+            head: bytes = await reader.readuntil(b'\r\n\r\n')
+            for line in head.split(b'\r\n'):
+                if line[0:15].lower() == b'content-length:':
+                    await reader.readexactly(int(line[15:]))
+            writer.write(response)
+            await writer.drain()
+    except (IncompleteReadError, LimitOverrunError, ConnectionError):
+        pass
+    finally:
+        writer.close()
+
+
+def serve(listener: socket, body: bytes) -> None:
+    """Entry of a Server Process, serves "listener" until the Process is terminated."""
+    response: bytes = (
+        b'HTTP/1.1 200 OK\r\nContent-Type: application/json; charset=utf-8\r\n'
+        + f'Content-Length: {len(body)}\r\n\r\n'.encode()  # noqa: W503
+        + body  # noqa: W503
+    )
+
+    async def main() -> None:
+        server = await start_server(
+            lambda reader, writer: handle_connection(reader, writer, response), sock=listener, backlog=1024
+        )
+        async with server:
+            await server.serve_forever()
+
+    run(main())
+
+
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#
+
+
+class CpuClock:
+    """CPU Time of the main Thread and of the whole Process.
+
+    Construct and read it from the main Thread. The other Threads are the Difference to the Process,
+    which still counts Threads that exited in between.
+    """
+
+    def __init__(self):
+        self.__start: Tuple[float, float] = self.__now()
+        pass
+
+    def __now(self) -> Tuple[float, float]:
+        return (thread_time(), process_time())
+
+    def split(self) -> Dict[str, float]:
+        """CPU Seconds since Construction: main Thread, other Threads and Process."""
+        main, total = self.__now()
+        main -= self.__start[0]
+        total -= self.__start[1]
+        return {'main_thread': main, 'other_threads': max(total - main, 0.0), 'process': total}
+
+    pass
+
+
+def summarize(client: str, concurrency: int, latencies: List[float], errors: int, seconds: float,
+              cpu: Dict[str, float]) -> Dict[str, Any]:
+    """One Result Record, Latencies in Seconds."""
+    latencies.sort()
+    n: int = len(latencies)
+
+    def quantile(q: float) -> float:
+        return 1e6 * latencies[min(int(n * q), n - 1)] if n > 0 else 0.0
+
+    total: int = max(n + errors, 1)
+    return {
+        'client': client,
+        'concurrency': concurrency,
+        'requests': n,
+        'errors': errors,
+        'seconds': round(seconds, 6),
+        'requests_per_second': round(n / seconds, 1) if seconds > 0 else 0.0,
+        'latency_us': {
+            'p50': round(quantile(0.5), 1),
+            'p90': round(quantile(0.9), 1),
+            'p99': round(quantile(0.99), 1),
+            'p999': round(quantile(0.999), 1),
+            'max': round(1e6 * latencies[-1], 1) if n > 0 else 0.0,
+        },
+        'cpu_us_per_request': {name: round(1e6 * value / total, 2) for name, value in cpu.items()},
+    }
+
+
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#
+
+
+def bench_pyahr(url: str, concurrency: int, requests: int) -> Dict[str, Any]:
+    """Closed-loop Run of AHR_HttpRequestProcessor."""
+    from pyahr._interfaces.event_handler import AHR_EventHandler
+    from pyahr._transactions.response import AHR_Response
+    from pyahr.async_http_requests import (
+        AHR_HttpProcessorFlowError,
+        AHR_HttpRequestProcessor,
+        AHR_ProcessorStatus,
+    )
+
+    class Handler(AHR_EventHandler):
+        """Hands finished Responses to the main Thread, runs on the libahr Thread of "processor"."""
+
+        def __init__(self, processor: int, finished: SimpleQueue):
+            super().__init__()
+            self.__processor: int = processor
+            self.__finished: SimpleQueue = finished
+            pass
+
+        def handle(self, response: AHR_Response) -> None:
+            self.__finished.put(
+                (perf_counter(), self.__processor, response.request(), 200 == response.status_code())
+            )
+            pass
+
+        pass
+
+    finished: SimpleQueue = SimpleQueue()
+    nprocessors: int = ceil(concurrency / AHR_BENCH_MAX_OBJECTS)
+    per_processor: int = ceil(concurrency / nprocessors)
+    processors: List[AHR_HttpRequestProcessor] = [
+        AHR_HttpRequestProcessor(
+            url=url, event_handler=Handler(i, finished), max_number_of_requestobjects=per_processor
+        )
+        for i in range(0, nprocessors)
+    ]
+    submitted_at: Dict[Tuple[int, int], float] = {}
+
+    def submit(index: int, request) -> None:
+        # The Object stays busy until its Callback returned, which may still run.
+        while True:
+            try:
+                submitted_at[(index, request.handle())] = perf_counter()
+                processors[index].configure_request(request).make_request(request)
+                return
+            except AHR_HttpProcessorFlowError as e:
+                if AHR_ProcessorStatus.AHR_PROC_OBJECT_BUSY != e.status():
+                    raise
+                sleep(0)
+
+    latencies: List[float] = []
+    errors: int = 0
+    cpu: CpuClock = CpuClock()
+    begin: float = perf_counter()
+    submitted: int = 0
+    for i in range(0, min(concurrency, requests)):
+        index: int = i % nprocessors
+        submit(index, processors[index].create_request().set_ressource(''))
+        submitted += 1
+    for _ in range(0, requests):
+        done, index, request, ok = finished.get()
+        if ok:
+            latencies.append(done - submitted_at[(index, request.handle())])
+        else:
+            errors += 1
+        if submitted < requests:
+            submit(index, request)
+            submitted += 1
+    seconds: float = perf_counter() - begin
+    split: Dict[str, float] = cpu.split()
+    del processors
+    return summarize('pyahr', concurrency, latencies, errors, seconds, split)
+
+
+def bench_aiohttp(url: str, concurrency: int, requests: int) -> Optional[Dict[str, Any]]:
+    """Closed-loop Run of aiohttp, None if it is not installed."""
+    try:
+        import aiohttp
+    except ImportError:
+        return None
+
+    latencies: List[float] = []
+    errors: List[int] = [0]
+    remaining: List[int] = [requests]
+
+    async def main() -> None:
+        connector = aiohttp.TCPConnector(limit=concurrency)
+        async with aiohttp.ClientSession(connector=connector) as session:
+
+            async def worker() -> None:
+                while remaining[0] > 0:
+                    remaining[0] -= 1
+                    start: float = perf_counter()
+                    async with session.get(url) as response:
+                        await response.text()
+                        if 200 == response.status:
+                            latencies.append(perf_counter() - start)
+                        else:
+                            errors[0] += 1
+
+            await gather(*[worker() for _ in range(0, concurrency)])
+
+    cpu: CpuClock = CpuClock()
+    begin: float = perf_counter()
+    run(main())
+    return summarize('aiohttp', concurrency, latencies, errors[0], perf_counter() - begin, cpu.split())
+
+
+def bench_httpx(url: str, concurrency: int, requests: int) -> Optional[Dict[str, Any]]:
+    """Closed-loop Run of httpx, None if it is not installed."""
+    try:
+        import httpx
+    except ImportError:
+        return None
+
+    latencies: List[float] = []
+    errors: List[int] = [0]
+    remaining: List[int] = [requests]
+
+    async def main() -> None:
+        limits = httpx.Limits(max_connections=concurrency, max_keepalive_connections=concurrency)
+        async with httpx.AsyncClient(limits=limits) as client:
+
+            async def worker() -> None:
+                while remaining[0] > 0:
+                    remaining[0] -= 1
+                    start: float = perf_counter()
+                    response = await client.get(url)
+                    response.text
+                    if 200 == response.status_code:
+                        latencies.append(perf_counter() - start)
+                    else:
+                        errors[0] += 1
+
+            await gather(*[worker() for _ in range(0, concurrency)])
+
+    cpu: CpuClock = CpuClock()
+    begin: float = perf_counter()
+    run(main())
+    return summarize('httpx', concurrency, latencies, errors[0], perf_counter() - begin, cpu.split())
+
+
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#
+
+
+def time_per_call(function: Callable[[], Any], calls: int) -> float:
+    """Best of five Runs in Nanoseconds per Call."""
+    best: float = float('inf')
+    for _ in range(0, 5):
+        start: float = perf_counter()
+        for _ in range(0, calls):
+            function()
+        best = min(best, (perf_counter() - start) / calls)
+    return round(1e9 * best, 1)
+
+
+def bench_boundary(url: str, body: bytes) -> Dict[str, float]:
+    """Fixed Costs every pyahr Response pays, independent of the Network."""
+    from ctypes import CFUNCTYPE, c_size_t, c_void_p, py_object
+
+    from pyahr._interfaces.event_handler import AHR_EventHandler
+    from pyahr._utils.string_decoder import AHR_Utf8Decoder
+    from pyahr.async_http_requests import AHR_HttpRequestProcessor
+
+    class Nothing(AHR_EventHandler):
+        def handle(self, response) -> None:
+            pass
+
+    processor: AHR_HttpRequestProcessor = AHR_HttpRequestProcessor(url=url, event_handler=Nothing())
+
+    # Same Signature as the on_error Callback of the Binding, called through a C Thunk.
+    @CFUNCTYPE(c_void_p, py_object, c_size_t, c_size_t)
+    def callback(user, robject, error_code) -> None:
+        pass
+
+    decoder: AHR_Utf8Decoder = AHR_Utf8Decoder()
+    target: object = object()
+    result: Dict[str, float] = {
+        'ctypes_call_ns': time_per_call(processor.decoding_stats, 20000),
+        'ctypes_callback_ns': time_per_call(lambda: callback(target, 0, 0), 20000),
+        'utf8_decode_ns': time_per_call(lambda: decoder.decode(body), 2000),
+    }
+    del processor
+    return result
+
+
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#
+
+
+def parse_args() -> Namespace:
+    parser: ArgumentParser = ArgumentParser(description='Benchmark pyahr against aiohttp and httpx.')
+    parser.add_argument('--concurrency', default='1,4,16,64', help='Comma separated Requests in Flight.')
+    parser.add_argument('--requests', type=int, default=4000, help='Requests per Client and Concurrency.')
+    parser.add_argument('--body-bytes', type=int, default=2048, help='Size of the Response Body.')
+    parser.add_argument('--clients', default='pyahr,aiohttp,httpx', help='Comma separated Clients to run.')
+    parser.add_argument('--server-processes', type=int, default=2, help='Processes of the local Server.')
+    parser.add_argument('--url', default=None, help='Use this Server instead of the local one.')
+    return parser.parse_args()
+
+
+if __name__ == '__main__':
+
+    args: Namespace = parse_args()
+    body: bytes = make_body(args.body_bytes)
+    servers: List[Any] = []
+    url: str = args.url
+    if url is None:
+        listener: socket = socket(AF_INET, SOCK_STREAM)
+        listener.setsockopt(SOL_SOCKET, SO_REUSEADDR, 1)
+        listener.bind(('127.0.0.1', 0))
+        listener.listen(1024)
+        url = f'http://127.0.0.1:{listener.getsockname()[1]}/'
+        # Fork before libahr starts any Thread.
+        context = get_context('fork')
+        servers = [context.Process(target=serve, args=(listener, body), daemon=True)
+                   for _ in range(0, args.server_processes)]
+        for server in servers:
+            server.start()
+
+    clients: Dict[str, Callable[[str, int, int], Optional[Dict[str, Any]]]] = {
+        'pyahr': bench_pyahr,
+        'aiohttp': bench_aiohttp,
+        'httpx': bench_httpx,
+    }
+    results: List[Dict[str, Any]] = []
+    try:
+        for concurrency in [int(c) for c in args.concurrency.split(',')]:
+            for name in args.clients.split(','):
+                result: Optional[Dict[str, Any]] = clients[name](url, concurrency, args.requests)
+                if result is None:
+                    print(f'{name} is not installed, skipped', file=stderr)
+                    continue
+                print(
+                    f'{name:8} concurrency {concurrency:4} {result["requests_per_second"]:10.1f} req/s '
+                    f'p99 {result["latency_us"]["p99"]:10.1f} us',
+                    file=stderr,
+                )
+                results.append(result)
+        boundary: Dict[str, float] = bench_boundary(url, body) if 'pyahr' in args.clients.split(',') else {}
+    finally:
+        for server in servers:
+            server.terminate()
+            server.join()
+
+    print(
+        dumps(
+            {
+                'benchmark': 'bench_processor',
+                'python': python_version(),
+                'body_bytes': len(body),
+                'boundary': boundary,
+                'results': results,
+            },
+            indent=2,
+        )
+    )
+
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#
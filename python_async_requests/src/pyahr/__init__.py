@@ -8,7 +8,7 @@ _is_initialized: bool = False
 
 if not _is_initialized:
 
-    from ctypes import cdll, byref, POINTER,pointer, c_void_p, c_char, CFUNCTYPE, c_char_p, c_long, Structure, py_object, c_size_t, c_bool, c_int
+    from ctypes import cdll, byref, POINTER,pointer, c_void_p, c_char, CFUNCTYPE, c_char_p, c_long, Structure, py_object, c_size_t, c_bool, c_int, c_int64, c_uint, c_uint32, c_uint64
     from os import environ, path
 
     # determine if running in a venv
@@ -32,6 +32,170 @@ if not _is_initialized:
     # =====================================================
     #
 
+    class AHR_HeaderView(Structure):
+
+        _fields_ = [
+            ('name', POINTER(c_char)),
+            ('name_len', c_size_t),
+            ('value', POINTER(c_char)),
+            ('value_len', c_size_t),
+        ]
+
+        pass
+
+    class AHR_ProcessorOptions(Structure):
+
+        _fields_ = [
+            ('max_objects', c_size_t),
+            ('memory_flags', c_uint),
+            ('accept_encodings', c_uint),
+            ('max_decoded_bytes', c_size_t),
+            ('content_encoding', c_uint),
+            ('compression_level', c_int),
+            ('min_compress_bytes', c_size_t),
+            ('zstd_dictionary', c_void_p),
+            ('zstd_dictionary_bytes', c_size_t),
+            ('json_index', c_uint),
+            ('trace_events', c_size_t),
+            ('record_path', c_char_p),
+            ('timeout_ms', c_size_t),
+            ('stall_seconds', c_size_t),
+        ]
+
+        pass
+
+    class AHR_ProcessorFootprint(Structure):
+
+        _fields_ = [
+            ('arena_bytes', c_size_t),
+            ('arena_used', c_size_t),
+            ('heap_bytes', c_size_t),
+            ('huge_pages', c_bool),
+            ('transparent_huge_pages', c_bool),
+        ]
+
+        pass
+
+    AHR_ENCODING_DEFAULT = 0
+    AHR_ENCODING_IDENTITY = 1 << 0
+    AHR_ENCODING_GZIP = 1 << 1
+    AHR_ENCODING_DEFLATE = 1 << 2
+    AHR_ENCODING_BROTLI = 1 << 3
+    AHR_ENCODING_ZSTD = 1 << 4
+    AHR_ENCODING_ALL = AHR_ENCODING_GZIP | AHR_ENCODING_DEFLATE | AHR_ENCODING_BROTLI | AHR_ENCODING_ZSTD
+
+    class AHR_DecodingStats(Structure):
+
+        _fields_ = [
+            ('responses', c_uint64),
+            ('encoded_responses', c_uint64),
+            ('wire_bytes', c_uint64),
+            ('decoded_bytes', c_uint64),
+            ('limit_exceeded', c_uint64),
+        ]
+
+        pass
+
+    class AHR_RequestTimings(Structure):
+
+        _fields_ = [
+            ('submit_ns', c_uint64),
+            ('dequeue_ns', c_uint64),
+            ('multi_add_ns', c_uint64),
+            ('name_lookup_us', c_uint64),
+            ('connect_us', c_uint64),
+            ('app_connect_us', c_uint64),
+            ('pretransfer_us', c_uint64),
+            ('first_byte_us', c_uint64),
+            ('total_us', c_uint64),
+            ('complete_ns', c_uint64),
+            ('callback_ns', c_uint64),
+        ]
+
+        pass
+
+    AHR_COMPRESSION_MAX_ENDPOINTS = 32
+    AHR_COMPRESSION_ENDPOINT_LEN = 128
+
+    class AHR_CompressionStats(Structure):
+
+        _fields_ = [
+            ('endpoint', c_char * AHR_COMPRESSION_ENDPOINT_LEN),
+            ('requests', c_uint64),
+            ('uncompressed_bytes', c_uint64),
+            ('compressed_bytes', c_uint64),
+        ]
+
+        pass
+
+    AHR_METRICS_MAX_ORIGINS = 16
+    AHR_METRICS_ORIGIN_LEN = 128
+    AHR_METRICS_STATUS_CLASSES = 6
+    AHR_FAILURE_CLASSES = 4
+
+    class AHR_OriginLatency(Structure):
+
+        _fields_ = [
+            ('origin', c_char * AHR_METRICS_ORIGIN_LEN),
+            ('count', c_uint64),
+            ('sum_us', c_uint64),
+            ('max_us', c_uint64),
+            ('p50_us', c_uint64),
+            ('p90_us', c_uint64),
+            ('p99_us', c_uint64),
+            ('p999_us', c_uint64),
+        ]
+
+        pass
+
+    class AHR_MetricsSnapshot(Structure):
+
+        _fields_ = [
+            ('submitted', c_uint64),
+            ('completed', c_uint64 * AHR_METRICS_STATUS_CLASSES),
+            ('failed', c_uint64 * AHR_FAILURE_CLASSES),
+            ('bytes_in', c_uint64),
+            ('bytes_out', c_uint64),
+            ('connections_opened', c_uint64),
+            ('connections_reused', c_uint64),
+            ('queue_depth', c_uint64),
+            ('in_flight', c_uint64),
+            ('norigins', c_size_t),
+            ('origins', AHR_OriginLatency * AHR_METRICS_MAX_ORIGINS),
+        ]
+
+        pass
+
+    AHR_BUFFER_POOL_CLASSES = 4
+
+    class AHR_BufferClassStats(Structure):
+
+        _fields_ = [
+            ('buffer_size', c_size_t),
+            ('acquired', c_uint64),
+            ('cache_hits', c_uint64),
+            ('depot_hits', c_uint64),
+            ('allocated', c_uint64),
+            ('in_use', c_size_t),
+            ('high_water', c_size_t),
+            ('idle', c_size_t),
+        ]
+
+        pass
+
+    class AHR_BufferPoolStats(Structure):
+
+        _fields_ = [
+            ('classes', AHR_BUFFER_POOL_CLASSES * AHR_BufferClassStats),
+            ('bytes_in_use', c_size_t),
+            ('bytes_high_water', c_size_t),
+            ('presized', c_uint64),
+            ('regrown', c_uint64),
+            ('oversized', c_uint64),
+        ]
+
+        pass
+
     class AHR_HeaderEntry(Structure):
 
         _fields_ = [
@@ -45,7 +209,7 @@ if not _is_initialized:
 
         _fields_ = [
             ('header',  256 * AHR_HeaderEntry),
-            ('nheader', c_size_t),
+            ('nheaders', c_size_t),
         ]
 
 
@@ -62,8 +226,14 @@ if not _is_initialized:
     ]
     _libahr.AHR_CreateLogger.restype = POINTER(c_void_p)
 
-    _libahr.AHR_LoggerSetLoglevel.argtyps = [c_void_p, c_size_t]
-    _libahr.AHR_LoggerSetLoglevel.restype = c_void_p
+    _libahr.AHR_LoggerSetLoglevel.argtypes = [c_void_p, c_size_t]
+    _libahr.AHR_LoggerSetLoglevel.restype = None
+
+    _libahr.AHR_LoggerFlush.argtypes = [c_void_p]
+    _libahr.AHR_LoggerFlush.restype = None
+
+    _libahr.AHR_LoggerDropped.argtypes = [c_void_p]
+    _libahr.AHR_LoggerDropped.restype = c_size_t
     #
     # =====================================================
     #
@@ -90,6 +260,42 @@ if not _is_initialized:
     _libahr.AHR_CreateProcessor.argtypes = [c_size_t, c_void_p]
     _libahr.AHR_CreateProcessor.restype = POINTER(c_void_p)
 
+    _libahr.AHR_CreateProcessorWithOptions.argtypes = [POINTER(AHR_ProcessorOptions), c_void_p]
+    _libahr.AHR_CreateProcessorWithOptions.restype = POINTER(c_void_p)
+
+    _libahr.AHR_ProcessorFootprint.argtypes = [c_void_p, POINTER(AHR_ProcessorFootprint)]
+    _libahr.AHR_ProcessorFootprint.restype = None
+
+    _libahr.AHR_ProcessorBufferPoolStats.argtypes = [c_void_p, POINTER(AHR_BufferPoolStats)]
+    _libahr.AHR_ProcessorBufferPoolStats.restype = None
+
+    _libahr.AHR_ProcessorDecodingStats.argtypes = [c_void_p, POINTER(AHR_DecodingStats)]
+    _libahr.AHR_ProcessorDecodingStats.restype = None
+
+    _libahr.AHR_ProcessorCompressionStats.argtypes = [c_void_p, POINTER(AHR_CompressionStats), c_size_t]
+    _libahr.AHR_ProcessorCompressionStats.restype = c_size_t
+
+    _libahr.AHR_ProcessorMetricsSnapshot.argtypes = [c_void_p, POINTER(AHR_MetricsSnapshot)]
+    _libahr.AHR_ProcessorMetricsSnapshot.restype = None
+
+    _libahr.AHR_ProcessorMetricsPrometheus.argtypes = [c_void_p, c_char_p, c_size_t]
+    _libahr.AHR_ProcessorMetricsPrometheus.restype = c_int64
+
+    _libahr.AHR_ProcessorDumpTrace.argtypes = [c_void_p, c_int]
+    _libahr.AHR_ProcessorDumpTrace.restype = c_bool
+
+    _libahr.AHR_TrainZstdDictionary.argtypes = [POINTER(c_char_p), POINTER(c_size_t), c_size_t, c_void_p, c_size_t]
+    _libahr.AHR_TrainZstdDictionary.restype = c_size_t
+
+    _libahr.AHR_ProcessorSetBaseUrl.argtypes = [c_void_p, c_char_p]
+    _libahr.AHR_ProcessorSetBaseUrl.restype = c_int
+
+    _libahr.AHR_ProcessorSetObjectBaseUrl.argtypes = [c_void_p, c_size_t, c_char_p]
+    _libahr.AHR_ProcessorSetObjectBaseUrl.restype = c_int
+
+    _libahr.AHR_ProcessorSetCurlVerbose.argtypes = [c_void_p, c_bool]
+    _libahr.AHR_ProcessorSetCurlVerbose.restype = None
+
     _libahr.AHR_ProcessorStart.argtypes = [c_void_p]
     _libahr.AHR_ProcessorStart.restype = c_bool 
 
@@ -105,15 +311,74 @@ if not _is_initialized:
             ('data', py_object),
             ('on_success', CFUNCTYPE(c_void_p, py_object, c_size_t, c_size_t, c_char_p, c_size_t)),
             ('on_error', CFUNCTYPE(c_void_p, py_object, c_size_t, c_size_t)),
+            ('on_data', CFUNCTYPE(c_int, py_object, c_size_t, POINTER(c_char), c_size_t)),
+            ('on_complete', CFUNCTYPE(c_void_p, py_object, c_size_t, c_size_t)),
         ]
     
+    class AHR_BodyDescriptor(Structure):
+
+        _fields_ = [
+            ('data', POINTER(c_char)),
+            ('nbytes', c_size_t),
+            ('release', CFUNCTYPE(None, c_void_p, POINTER(c_char), c_size_t)),
+            ('user', c_void_p),
+        ]
+
+        pass
+
+    class AHR_BodyProvider(Structure):
+
+        _fields_ = [
+            ('read', CFUNCTYPE(c_size_t, c_void_p, POINTER(c_char), c_size_t)),
+            ('rewind', CFUNCTYPE(c_bool, c_void_p)),
+            ('user', c_void_p),
+            ('content_length', c_int64),
+        ]
+
+        pass
+
+    class AHR_FileSink(Structure):
+
+        _fields_ = [
+            ('fd', c_int),
+            ('offset', c_int64),
+            ('flags', c_uint),
+        ]
+
+        pass
+
+    class AHR_FileSource(Structure):
+
+        _fields_ = [
+            ('path', c_char_p),
+            ('fd', c_int),
+            ('offset', c_int64),
+            ('length', c_int64),
+            ('flags', c_uint),
+        ]
+
+        pass
+
     class AHR_RequestData(Structure):
 
         _fields_ = [
-            ('header', AHR_Header),
+            ('header', POINTER(AHR_HeaderView)),
+            ('nheaders', c_size_t),
             ('url', c_char_p),
             ('body', c_char_p),
             ('log_level', c_size_t),
+            ('borrowed_body', POINTER(AHR_BodyDescriptor)),
+            ('body_provider', POINTER(AHR_BodyProvider)),
+            ('file_sink', POINTER(AHR_FileSink)),
+            ('file_source', POINTER(AHR_FileSource)),
+            ('path', c_char_p),
+            ('response_headers', POINTER(c_char_p)),
+            ('nresponse_headers', c_size_t),
+            ('accept_encodings', c_uint),
+            ('max_decoded_bytes', c_size_t),
+            ('content_encoding', c_uint),
+            ('json_index', c_uint),
+            ('timeout_ms', c_size_t),
         ]
     #
     # =====================================================
@@ -125,12 +390,53 @@ if not _is_initialized:
     _libahr.AHR_ProcessorNumberOfRequestObjects.argtypes = [c_void_p]
     _libahr.AHR_ProcessorNumberOfRequestObjects.restype = c_size_t
 
+    _libahr.AHR_ProcessorResponseHeaderCount.argtypes = [c_void_p, c_size_t]
+    _libahr.AHR_ProcessorResponseHeaderCount.restype = c_size_t
+
+    _libahr.AHR_ProcessorResponseHeaderAt.argtypes = [c_void_p, c_size_t, c_size_t, POINTER(AHR_HeaderView)]
+    _libahr.AHR_ProcessorResponseHeaderAt.restype = c_bool
+
+    _libahr.AHR_ProcessorResponseHeaderFind.argtypes = [c_void_p, c_size_t, c_char_p, POINTER(AHR_HeaderView)]
+    _libahr.AHR_ProcessorResponseHeaderFind.restype = c_bool
+
+    AHR_JSON_INDEX_DEFAULT = 0
+    AHR_JSON_INDEX_ON = 1
+    AHR_JSON_INDEX_OFF = 2
+
+    class AHR_JsonToken(Structure):
+
+        _fields_ = [
+            ('offset', c_uint32),
+            ('length', c_uint32),
+            ('next', c_uint32),
+            ('count', c_uint32),
+        ]
+
+    class AHR_JsonIndex(Structure):
+
+        _fields_ = [
+            ('body', POINTER(c_char)),
+            ('nbytes', c_size_t),
+            ('tokens', POINTER(AHR_JsonToken)),
+            ('ntokens', c_size_t),
+            ('error_offset', c_size_t),
+        ]
+
+    _libahr.AHR_ProcessorResponseJson.argtypes = [c_void_p, c_size_t, POINTER(AHR_JsonIndex)]
+    _libahr.AHR_ProcessorResponseJson.restype = c_bool
+
+    _libahr.AHR_ProcessorRequestTimings.argtypes = [c_void_p, c_size_t, POINTER(AHR_RequestTimings)]
+    _libahr.AHR_ProcessorRequestTimings.restype = c_bool
+
     #
     # =====================================================
     #
     _libahr.AHR_ProcessorMakeRequest.argtypes = [c_void_p, c_size_t]
     _libahr.AHR_ProcessorMakeRequest.restype = c_int
 
+    _libahr.AHR_ProcessorResumeResponse.argtypes = [c_void_p, c_size_t]
+    _libahr.AHR_ProcessorResumeResponse.restype = c_int
+
     _libahr.AHR_ProcessorGet.argtypes = [
         c_void_p, 
         c_size_t,
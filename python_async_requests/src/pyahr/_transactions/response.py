@@ -38,6 +38,7 @@ class AHR_Response:
         self.__header: Dict[str, str] = {}
         self.__request: AHR_Request = request
         self.__error_code: Optional[AHR_ErrorCode] = None
+        self.__timings: Dict[str, int] = {}
         pass
 
     def set_error_code(self, value: AHR_ErrorCode) -> Self:
@@ -55,6 +56,18 @@ class AHR_Response:
         self.__body = data
         return self
 
+    def set_timings(self, timings: Dict[str, int]) -> Self:
+        self.__timings = timings
+        return self
+
+    def timings(self) -> Dict[str, int]:
+        """Phase Timings of the Request, see AHR_RequestTimings_t in libahr.
+
+        Fields ending in "_ns" are CLOCK_MONOTONIC Timestamps in Nanoseconds (0 if not reached),
+        Fields ending in "_us" are curls Phase Times in Microseconds since the Transfer started.
+        """
+        return self.__timings
+
     def set_status_code(self, code: int) -> Self:
         self.__status_code = code
         return self
@@ -83,6 +96,7 @@ class AHR_Response:
             'header': self.__header,
             'status_code': self.__status_code,
             'error_code': self.__error_code,
+            'timings': self.__timings,
             'body': (self.__body if len(self.__body) <= 32 else f'{self.__body[0:29]}...')
             if self.__body is not None
             else None,
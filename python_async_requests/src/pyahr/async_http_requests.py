@@ -4,13 +4,39 @@
 #
 
 from copy import deepcopy
-from ctypes import CFUNCTYPE, byref, c_char_p, c_size_t, c_void_p, py_object
+from ctypes import (
+    CFUNCTYPE,
+    POINTER,
+    byref,
+    c_char,
+    c_char_p,
+    c_size_t,
+    c_void_p,
+    cast,
+    create_string_buffer,
+    pointer,
+    py_object,
+    string_at,
+)
 from enum import IntEnum
 from json import dumps
 from logging import CRITICAL, DEBUG, ERROR, INFO, NOTSET, WARNING, Logger, getLogger
 from typing import Dict, List, Optional, Tuple
 
-from pyahr import AHR_Header, AHR_RequestData, AHR_UserData, _libahr
+from pyahr import (
+    AHR_ENCODING_DEFAULT,
+    AHR_COMPRESSION_MAX_ENDPOINTS,
+    AHR_BodyDescriptor,
+    AHR_CompressionStats,
+    AHR_DecodingStats,
+    AHR_HeaderView,
+    AHR_MetricsSnapshot,
+    AHR_ProcessorOptions,
+    AHR_RequestData,
+    AHR_RequestTimings,
+    AHR_UserData,
+    _libahr,
+)
 from typing_extensions import Self
 
 from ._interfaces.event_handler import AHR_EventHandler
@@ -30,8 +56,9 @@ class AHR_ProcessorStatus(IntEnum):
     AHR_PROC_OBJECT_BUSY = 1
     AHR_PROC_UNKNOWN_OBJECT = 2
     AHR_PROC_NOT_ENOUGH_MEMORY = 3
-    AHR_PROC_TIMEOUT = 4
-    AHR_PROC_UNKNOWN_ERROR = 5
+    AHR_PROC_UNKNOWN_ERROR = 4
+    AHR_PROC_IO_ERROR = 5
+    AHR_PROC_INVALID_URL = 6
 
     pass
 
@@ -142,18 +169,18 @@ class AHR_HttpRequestProcessor:
         pass
 
     def __map_loglevel(self, loglevel: int) -> int:
-        """Convert the logging Modules Loglevel to a loglevel that libahr can understand."""
+        """Convert the logging Modules Loglevel to a loglevel that libahr can understand (0 Error, 1 Warning, 2 Info)."""
         try:
             return {
-                NOTSET: 0,
-                DEBUG: 0,
-                INFO: 0,
+                NOTSET: 2,
+                DEBUG: 2,
+                INFO: 2,
                 WARNING: 1,
-                ERROR: 2,
-                CRITICAL: 2,
+                ERROR: 0,
+                CRITICAL: 0,
             }[loglevel]
         except KeyError:
-            return 2
+            return 0
 
     def __init__(
         self,
@@ -161,6 +188,15 @@ class AHR_HttpRequestProcessor:
         event_handler: AHR_EventHandler,
         max_number_of_requestobjects: int = 5,
         logger: Optional[Logger] = None,
+        accept_encodings: int = AHR_ENCODING_DEFAULT,
+        max_decoded_bytes: int = 0,
+        content_encoding: int = AHR_ENCODING_DEFAULT,
+        compression_level: int = 0,
+        min_compress_bytes: int = 0,
+        zstd_dictionary: Optional[bytes] = None,
+        trace_events: int = 0,
+        record_path: Optional[str] = None,
+        timeout_ms: int = 0,
     ):
         """Constructor.
 
@@ -169,6 +205,18 @@ class AHR_HttpRequestProcessor:
             event_handler: AHR_EventHandler: A Handler that is called for each received HTTP Response.
             max_number_of_requestobjects: int = 5: Number of available Requestobjects, 1 <= x <= 25.
             logger: Optional[Logger] = None: The Logger to be used.
+            accept_encodings: int = AHR_ENCODING_DEFAULT: Content Encodings to offer (AHR_ENCODING_*),
+                compressed Responses are decoded before they reach the Event Handler.
+            max_decoded_bytes: int = 0: Abort Responses whose decoded Body exceeds this Size, 0 for no Limit.
+            content_encoding: int = AHR_ENCODING_DEFAULT: Compress POST and PUT Bodies with this Encoding
+                (AHR_ENCODING_GZIP, AHR_ENCODING_DEFLATE or AHR_ENCODING_ZSTD).
+            compression_level: int = 0: Compression Level, 0 for the Default of the Encoding.
+            min_compress_bytes: int = 0: Bodies below this Size are sent as is.
+            zstd_dictionary: Optional[bytes] = None: zstd Dictionary, see train_zstd_dictionary().
+            trace_events: int = 0: Trace Events each Thread buffers for dump_trace(), 0 turns Tracing off.
+            record_path: Optional[str] = None: Record the Shape of every finished Request into this File,
+                see ahr_record.h and bench/src/ahr_replay.c.
+            timeout_ms: int = 0: Abort a Request after this many Milliseconds, 0 for the Default of libahr (5 s).
         """
         # Python Logger.
         self.__logger: Logger = logger if logger is not None else getLogger(self.__class__.__name__)
@@ -181,11 +229,26 @@ class AHR_HttpRequestProcessor:
         )
         _libahr.AHR_LoggerSetLoglevel(
             self.__ahr_logger,
-            c_size_t(self.__map_loglevel(self.__logger.level)),
+            c_size_t(self.__map_loglevel(self.__logger.getEffectiveLevel())),
         )
         # HttpProcessor Handle from libahr.
         max_number_of_requestobjects = max(min(max_number_of_requestobjects, 25), 1)
-        self.__ahr_processor: c_void_p = _libahr.AHR_CreateProcessor(max_number_of_requestobjects, self.__ahr_logger)
+        options = AHR_ProcessorOptions(
+            max_objects=max_number_of_requestobjects,
+            memory_flags=0,
+            accept_encodings=accept_encodings,
+            max_decoded_bytes=max_decoded_bytes,
+            content_encoding=content_encoding,
+            compression_level=compression_level,
+            min_compress_bytes=min_compress_bytes,
+            zstd_dictionary=cast(c_char_p(zstd_dictionary), c_void_p) if zstd_dictionary else None,
+            zstd_dictionary_bytes=len(zstd_dictionary) if zstd_dictionary else 0,
+            trace_events=trace_events,
+            record_path=record_path.encode() if record_path else None,
+            timeout_ms=timeout_ms,
+            stall_seconds=0,
+        )
+        self.__ahr_processor: c_void_p = _libahr.AHR_CreateProcessorWithOptions(byref(options), self.__ahr_logger)
         if self.__ahr_processor is None:
             raise AssertionError(
                 'Unable to create Instance with given Arguments - '
@@ -197,6 +260,11 @@ class AHR_HttpRequestProcessor:
 
         # URL this Instance uses.
         self.__url: str = url[0 : len(url) - 1] if url.endswith('/') else url  # noqa: E203
+        # libahr parses the URL once, Requests then only pass their Path.
+        # An URL libahr can not parse is sent in full with every Request, as before.
+        self.__base_url_bound: bool = AHR_ProcessorStatus.AHR_PROC_OK.value == _libahr.AHR_ProcessorSetBaseUrl(
+            self.__ahr_processor, self.__url.encode()
+        )
 
         # Eventhandler wich is called for each Response to a Request.
         self.__event_handler: AHR_EventHandler = event_handler
@@ -204,6 +272,8 @@ class AHR_HttpRequestProcessor:
         # Table for known Request/Response Objects and
         # and for Copies of ongoing requests.
         self.__requests: Dict[int, AHR_Request] = {}
+        # libahr borrows the Request Bodies, keep the configured Structures alive until the Response arrived.
+        self.__request_data: Dict[int, AHR_RequestData] = {}
         self.__request_objects: Dict[int, Tuple[bool, AHR_Request]] = {}
         for i in range(0, _libahr.AHR_ProcessorNumberOfRequestObjects(self.__ahr_processor)):
             self.__request_objects[i] = (False, AHR_Request(i))
@@ -231,6 +301,68 @@ class AHR_HttpRequestProcessor:
         _libahr.AHR_DestroyLogger(byref(self.__ahr_logger))
         pass
 
+    def set_curl_verbose(self, verbose: bool) -> None:
+        """Log curls verbose Output (Info Text and Headers) of all following Requests at Info Level."""
+        _libahr.AHR_ProcessorSetCurlVerbose(self.__ahr_processor, verbose)
+
+    def flush_log(self) -> None:
+        """Deliver queued libahr Log Messages now instead of waiting for the Drain Thread."""
+        _libahr.AHR_LoggerFlush(self.__ahr_logger)
+
+    def decoding_stats(self) -> AHR_DecodingStats:
+        """Body Bytes received from the Network and after decoding, summed over all finished Responses."""
+        stats = AHR_DecodingStats()
+        _libahr.AHR_ProcessorDecodingStats(self.__ahr_processor, byref(stats))
+        return stats
+
+    def compression_stats(self) -> List[AHR_CompressionStats]:
+        """Request Body Bytes before and after Compression, per Endpoint."""
+        stats = (AHR_CompressionStats * AHR_COMPRESSION_MAX_ENDPOINTS)()
+        count = _libahr.AHR_ProcessorCompressionStats(self.__ahr_processor, stats, AHR_COMPRESSION_MAX_ENDPOINTS)
+        return list(stats[0 : min(count, AHR_COMPRESSION_MAX_ENDPOINTS)])  # noqa: E203
+
+    def metrics(self) -> AHR_MetricsSnapshot:
+        """Request Counters, Gauges and Latency Quantiles per Origin. Never blocks the Processor."""
+        snapshot = AHR_MetricsSnapshot()
+        _libahr.AHR_ProcessorMetricsSnapshot(self.__ahr_processor, byref(snapshot))
+        return snapshot
+
+    def metrics_prometheus(self) -> str:
+        """The Metrics in the Prometheus Text Format, e.g. to serve them on /metrics."""
+        capacity = 16 * 1024
+        while True:
+            buffer = create_string_buffer(capacity)
+            nbytes = _libahr.AHR_ProcessorMetricsPrometheus(self.__ahr_processor, buffer, capacity)
+            if nbytes >= 0:
+                return buffer.raw[0:nbytes].decode('utf-8', errors='replace')
+            capacity *= 2
+
+    def dump_trace(self, path: str) -> bool:
+        """Write the Trace Events recorded since the last Dump as Chrome Trace JSON, see ui.perfetto.dev.
+
+        Returns:
+            bool: False if Tracing is off or the File could not be written.
+        """
+        with open(path, 'wb') as file:
+            return bool(_libahr.AHR_ProcessorDumpTrace(self.__ahr_processor, file.fileno()))
+
+    @staticmethod
+    def train_zstd_dictionary(samples: List[bytes], capacity: int = 100 * 1024) -> bytes:
+        """Train a zstd Dictionary from typical Request Bodies.
+
+        Returns:
+            bytes: The Dictionary, empty if the Samples are not suitable or libahr was built without zstd.
+        """
+        dictionary = create_string_buffer(capacity)
+        nbytes = _libahr.AHR_TrainZstdDictionary(
+            (c_char_p * len(samples))(*samples),
+            (c_size_t * len(samples))(*[len(sample) for sample in samples]),
+            len(samples),
+            dictionary,
+            capacity,
+        )
+        return dictionary.raw[0:nbytes]
+
     def set_string_decoder(self, decoder: AHR_IStringDecoder) -> Self:
         """Set the Stringdecode.
 
@@ -251,7 +383,11 @@ class AHR_HttpRequestProcessor:
                 f'An Error occured during handling of Requestobject {robject}, Error Code ist {error_code}.'
             )
             self.__event_handler.handle(
-                AHR_Response(self.__requests[robject]).set_error_code(error_code).set_status_code(500).set_body('')
+                AHR_Response(self.__requests[robject])
+                .set_error_code(error_code)
+                .set_status_code(500)
+                .set_timings(self.__request_timings(robject))
+                .set_body('')
             )
             self.__requests.pop(robject)
         except Exception as e:  # noqa: B902
@@ -260,6 +396,7 @@ class AHR_HttpRequestProcessor:
 
             self.__logger.exception(e)
             self.__event_handler.handle(AHR_Response(self.__requests[robject]).set_status_code(500)).set_body('')
+        self.__request_data.pop(robject, None)
         pass
 
     @CFUNCTYPE(c_void_p, py_object, c_size_t, c_size_t, c_char_p, c_size_t)
@@ -280,6 +417,8 @@ class AHR_HttpRequestProcessor:
             self.__event_handler.handle(
                 AHR_Response(self.__requests[robject])
                 .set_status_code(status_code)
+                .set_header(self.__response_header(robject))
+                .set_timings(self.__request_timings(robject))
                 .set_body(self.__string_decoder.decode(buffer if buffer is not None else ''))
             )
             self.__requests.pop(robject)
@@ -289,24 +428,56 @@ class AHR_HttpRequestProcessor:
 
             self.__logger.exception(e)
             #self.__event_handler.handle(AHR_Response(self.__requests[robject]).set_status_code(-1))
+        self.__request_data.pop(robject, None)
         pass
 
+    def __request_timings(self, robject: int) -> Dict[str, int]:
+        """Phase Timings of the Request of a Requestobject, read from within its Callback."""
+        timings: AHR_RequestTimings = AHR_RequestTimings()
+        if not _libahr.AHR_ProcessorRequestTimings(self.__ahr_processor, robject, byref(timings)):
+            return {}
+        return {name: getattr(timings, name) for name, _ in AHR_RequestTimings._fields_}
+
+    def __response_header(self, robject: int) -> Dict[str, str]:
+        """Read the Response Headers of a Requestobject through Views into libahrs Header Block."""
+        header: Dict[str, str] = {}
+        view: AHR_HeaderView = AHR_HeaderView()
+        for i in range(0, _libahr.AHR_ProcessorResponseHeaderCount(self.__ahr_processor, robject)):
+            if _libahr.AHR_ProcessorResponseHeaderAt(self.__ahr_processor, robject, i, byref(view)):
+                name: str = self.__string_decoder.decode(string_at(view.name, view.name_len))
+                header[name] = self.__string_decoder.decode(string_at(view.value, view.value_len))
+        return header
+
     def __create_request_data(self, request: AHR_Request) -> AHR_RequestData:
-        """Create the AHR_RequestData Structure and fill it with the Requests contents."""
+        """Create the AHR_RequestData Structure and fill it with the Requests contents.
+
+        The Header Views point into the encoded Strings, libahr copies them while the Request is configured.
+        """
         request_data = AHR_RequestData()
-        request_data.header = AHR_Header()
-        request_data.nheader = 0
-
-        url: str = f'{self.__url}/{request.ressource()}\0'
-        request_data.url = url.encode()
-        request_data.body = request.body().encode() if request.body() is not None else None
-
-        i = 0
-        for header in request.header():
-            request_data.header.header[i].name = header.encode()
-            request_data.header.header[i].value = request.header()[header].encode()
-            i = i + 1
-        request_data.nheader = i
+
+        if self.__base_url_bound:
+            request_data.path = f'/{request.ressource()}'.encode()
+        else:
+            url: str = f'{self.__url}/{request.ressource()}\0'
+            request_data.url = url.encode()
+        request_data.body = None
+
+        body: Optional[bytes] = request.body().encode() if request.body() is not None else None
+        if body is not None:
+            request_data.borrowed_body = pointer(AHR_BodyDescriptor(cast(body, POINTER(c_char)), len(body)))
+
+        encoded: List[Tuple[bytes, bytes]] = [
+            (name.encode(), value.encode()) for name, value in request.header().items()
+        ]
+        header = (AHR_HeaderView * len(encoded))()
+        for i, (name, value) in enumerate(encoded):
+            header[i] = AHR_HeaderView(
+                cast(name, POINTER(c_char)), len(name), cast(value, POINTER(c_char)), len(value)
+            )
+        request_data.header = header
+        request_data.nheaders = len(encoded)
+        # The Views do not own the encoded Strings, keep them alive as long as the Structure lives.
+        request_data.keepalive = (encoded, body)
         return request_data
 
     def create_request(self) -> AHR_Request:
@@ -412,6 +583,7 @@ class AHR_HttpRequestProcessor:
 
         if AHR_ProcessorStatus.AHR_PROC_OK != status:
             raise AHR_HttpProcessorFlowError(status=status)
+        self.__request_data[request.handle()] = request_data
         return self
 
     def number_of_pending_requests(self) -> int:
@@ -0,0 +1,103 @@
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#
+
+from importlib.util import module_from_spec, spec_from_file_location
+from json import loads
+from os import path
+from subprocess import run
+from sys import executable
+from unittest import TestCase
+
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#
+
+BENCH_PATH: str = path.join(path.dirname(path.abspath(__file__)), '..', '..', 'bench', 'bench_processor.py')
+
+
+def load_bench():
+    """bench/bench_processor.py is a Script, not Part of the Package."""
+    spec = spec_from_file_location('bench_processor', BENCH_PATH)
+    module = module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#
+
+class MakeBody(TestCase):
+
+    def runTest(self):
+
+        bench = load_bench()
+        for nbytes in [0, 1, 57, 2048, 100000]:
+            body: bytes = bench.make_body(nbytes)
+            # Only a cut multibyte Character is dropped at the End.
+            self.assertLessEqual(len(body), nbytes)
+            self.assertGreaterEqual(len(body), nbytes - 3)
+            body.decode('utf-8')
+
+        pass
+
+    pass
+
+
+class Summarize(TestCase):
+
+    def runTest(self):
+
+        bench = load_bench()
+        latencies = [i / 1e6 for i in range(1000, 0, -1)]
+        result = bench.summarize('pyahr', 8, latencies, 10, 2.0, {'main_thread': 0.0101, 'process': 0.0202})
+
+        self.assertEqual('pyahr', result['client'])
+        self.assertEqual(8, result['concurrency'])
+        self.assertEqual(1000, result['requests'])
+        self.assertEqual(10, result['errors'])
+        self.assertEqual(500.0, result['requests_per_second'])
+        self.assertEqual(
+            {'p50': 501.0, 'p90': 901.0, 'p99': 991.0, 'p999': 1000.0, 'max': 1000.0}, result['latency_us']
+        )
+        # CPU Time is spread over all Requests, including the failed ones.
+        self.assertEqual({'main_thread': 10.0, 'process': 20.0}, result['cpu_us_per_request'])
+
+        empty = bench.summarize('httpx', 1, [], 0, 0.0, {})
+        self.assertEqual(0.0, empty['requests_per_second'])
+        self.assertEqual(0.0, empty['latency_us']['max'])
+
+        pass
+
+    pass
+
+
+class Smoke(TestCase):
+    """Short Run against the local Server, like the Example in the README but with Python's own Clients skipped."""
+
+    def runTest(self):
+
+        completed = run(
+            [executable, BENCH_PATH, '--concurrency', '1,30', '--requests', '150', '--clients', 'pyahr'],
+            capture_output=True,
+            timeout=120,
+        )
+        self.assertEqual(0, completed.returncode, completed.stderr.decode())
+
+        report = loads(completed.stdout)
+        self.assertEqual('bench_processor', report['benchmark'])
+        self.assertEqual(2048, report['body_bytes'])
+        self.assertEqual({'ctypes_call_ns', 'ctypes_callback_ns', 'utf8_decode_ns'}, set(report['boundary']))
+        self.assertEqual([1, 30], [result['concurrency'] for result in report['results']])
+        for result in report['results']:
+            self.assertEqual('pyahr', result['client'])
+            self.assertEqual(150, result['requests'])
+            self.assertEqual(0, result['errors'])
+
+        pass
+
+    pass
+
+#
+# ---------------------------------------------------------------------------------------------------------------------
+#